@@ -277,6 +277,7 @@ gFsciStatus_t FSCI_CallRegisteredFunc (opGroup_t opGroup, void *pData, uint32_t
 
 void FSCI_transmitFormatedPacket( void *pPacket, uint32_t fsciInterface );
 void FSCI_transmitPayload(uint8_t OG, uint8_t OC, void * pMsg, uint16_t msgLen, uint32_t fsciInterface);
+void FSCI_transmitPayloadBuffer(uint8_t OG, uint8_t OC, void * pMsg, uint16_t msgLen, uint32_t fsciInterface);
 void FSCI_Error(uint8_t errorCode, uint32_t fsciInterface);
 
 uint8_t* FSCI_GetFormattedPacket(uint8_t OG, uint8_t OC, void *pMsg, uint16_t msgLen, uint16_t *pOutLen);
@@ -259,6 +259,12 @@ static const gFsciOpCode_t FSCI_ReqOCtable[] =
     {mFsciGetUniqueId_c,                     FSCI_ReadUniqueId},
     {mFsciGetMcuId_c,                        FSCI_ReadMCUId},
     {mFsciGetSwVersions_c,                   FSCI_ReadModVer},
+#ifdef MEM_PROFILING
+    {mFsciGetMemProfile_c,                   FSCI_GetMemProfile},
+#endif
+#ifdef MEM_TRACE
+    {mFsciGetMemTrace_c,                     FSCI_GetMemTrace},
+#endif
 };
 
 /* Used for maintaining backward compatibillity */
@@ -1013,6 +1019,124 @@ bool_t FSCI_ReadModVer(void* pData, uint32_t fsciInterface)
     return FALSE;
 }
 
+/*! *********************************************************************************
+* \brief  This function sends a section of the Memory Manager allocation profiler
+*         (call sites, requested size histogram or pool waste histograms)
+*         over the serial interface
+*
+* \param[in] pData pointer to location of the received data
+* \param[in] fsciInterface the interface on which the packet was received
+*
+* \return  TRUE in order to recycle the received message
+*
+* \remarks Request payload: section (1 byte), index of the first entry (1 byte)
+*
+********************************************************************************** */
+#ifdef MEM_PROFILING
+bool_t FSCI_GetMemProfile(void* pData, uint32_t fsciInterface)
+{
+    clientPacket_t *pPkt;
+    uint8_t section = ((clientPacket_t*)pData)->structured.payload[0];
+    uint8_t startIndex = ((clientPacket_t*)pData)->structured.payload[1];
+    uint16_t size = sizeof(clientPacketHdr_t) + gFsciMaxPayloadLen_c + 2;
+
+    /* Check if the received buffer is large enough to be reused */
+    if( MEM_BufferGetSize(pData) >= size )
+    {
+        pPkt = pData;
+    }
+    else
+    {
+        pPkt = MEM_BufferAlloc( size );
+    }
+
+    if( !pPkt )
+    {
+        FSCI_Error( gFsciOutOfMessages_c, fsciInterface );
+        MEM_BufferFree(pData);
+        return FALSE;
+    }
+
+    pPkt->structured.header.len = MEM_ProfilerDump((memProfSection_t)section, startIndex,
+                                                   pPkt->structured.payload, gFsciMaxPayloadLen_c);
+
+    /* Check if the received buffer was reused. */
+    if( pPkt == pData )
+    {
+        return TRUE;
+    }
+
+    /* A new buffer was allocated. Fill with aditional information */
+    pPkt->structured.header.opGroup = gFSCI_CnfOpcodeGroup_c;
+    pPkt->structured.header.opCode = mFsciGetMemProfile_c;
+    FSCI_transmitFormatedPacket( pPkt, fsciInterface );
+    MEM_BufferFree(pData);
+
+    return FALSE;
+}
+#endif /* MEM_PROFILING */
+
+/*! *********************************************************************************
+* \brief  This function sends the oldest buffered Memory Manager allocation trace
+*         records over the serial interface
+*
+* \param[in] pData pointer to location of the received data
+* \param[in] fsciInterface the interface on which the packet was received
+*
+* \return  TRUE in order to recycle the received message
+*
+* \remarks Response payload: number of dropped records (2 bytes), number of
+*          records (1 byte), followed by the memTraceRecord_t records
+*
+********************************************************************************** */
+#ifdef MEM_TRACE
+bool_t FSCI_GetMemTrace(void* pData, uint32_t fsciInterface)
+{
+    clientPacket_t *pPkt;
+    uint16_t size = sizeof(clientPacketHdr_t) + gFsciMaxPayloadLen_c + 2;
+    uint16_t lost;
+    uint8_t n;
+
+    /* Check if the received buffer is large enough to be reused */
+    if( MEM_BufferGetSize(pData) >= size )
+    {
+        pPkt = pData;
+    }
+    else
+    {
+        pPkt = MEM_BufferAlloc( size );
+    }
+
+    if( !pPkt )
+    {
+        FSCI_Error( gFsciOutOfMessages_c, fsciInterface );
+        MEM_BufferFree(pData);
+        return FALSE;
+    }
+
+    n = (uint8_t)MEM_TraceRead((memTraceRecord_t*)&pPkt->structured.payload[3],
+                               (gFsciMaxPayloadLen_c - 3) / sizeof(memTraceRecord_t));
+    lost = MEM_TraceGetLost();
+    FLib_MemCpy(&pPkt->structured.payload[0], &lost, sizeof(lost));
+    pPkt->structured.payload[2] = n;
+    pPkt->structured.header.len = 3 + n * sizeof(memTraceRecord_t);
+
+    /* Check if the received buffer was reused. */
+    if( pPkt == pData )
+    {
+        return TRUE;
+    }
+
+    /* A new buffer was allocated. Fill with aditional information */
+    pPkt->structured.header.opGroup = gFSCI_CnfOpcodeGroup_c;
+    pPkt->structured.header.opCode = mFsciGetMemTrace_c;
+    FSCI_transmitFormatedPacket( pPkt, fsciInterface );
+    MEM_BufferFree(pData);
+
+    return FALSE;
+}
+#endif /* MEM_TRACE */
+
 /*! *********************************************************************************
 * \brief  This function handles the requests for the OTA OpCodes
 *
@@ -130,6 +130,8 @@ enum {
     mFsciGetUniqueId_c                      = 0xB0,
     mFsciGetMcuId_c                         = 0xB1,
     mFsciGetSwVersions_c                    = 0xB2,
+    mFsciGetMemProfile_c                    = 0xB3, /* Fsci-GetMemProfile.Request           */
+    mFsciGetMemTrace_c                      = 0xB4, /* Fsci-GetMemTrace.Request             */
 
     mFsciMsgAddToAddressMapPermanent_c      = 0xC0,
     mFsciMsgRemoveFromAddressMap_c          = 0xC1,
@@ -220,6 +222,8 @@ bool_t FSCI_MsgGetWakeUpReasonReqFunc         (void* pData, uint32_t fsciInterfa
 bool_t FSCI_ReadUniqueId                      (void* pData, uint32_t fsciInterface);
 bool_t FSCI_ReadMCUId                         (void* pData, uint32_t fsciInterface);
 bool_t FSCI_ReadModVer                        (void* pData, uint32_t fsciInterface);
+bool_t FSCI_GetMemProfile                     (void* pData, uint32_t fsciInterface);
+bool_t FSCI_GetMemTrace                       (void* pData, uint32_t fsciInterface);
 bool_t FSCI_OtaSupportHandlerFunc             (void* pData, uint32_t fsciInterface);
 bool_t FSCI_EnableBootloaderFunc              (void* pData, uint32_t fsciInterface);
 
@@ -59,7 +59,6 @@
 *************************************************************************************
 ************************************************************************************/
 #define gFsciUseBlockingTx_c 1
-#define MIN_VALID_PACKET_LEN (sizeof(clientPacketHdr_t))
 #define FSCI_txCallback MEM_BufferFree
 #define FSCI_rxCallback FSCI_receivePacket
 
@@ -75,12 +74,30 @@
 #define mFsciRxRestartTimeoutMs_c 50 /* milliseconds */
 #endif
 
+#ifndef mFsciRxChunkSize_c
+#define mFsciRxChunkSize_c        32 /* bytes read from the serial interface at once */
+#endif
+
+#ifndef mFsciTxFramesCount_c
+#define mFsciTxFramesCount_c      4  /* frames sent without copying their payload */
+#endif
+
+#define mFsciTxFrameSegments_c    3  /* header, payload, checksum */
+
+/* A Tx which ends before the function sending it returns */
+#if gFsciRxAck_c
+#define mFsciTxIsBlocking_d()     (TRUE)
+#else
+#define mFsciTxIsBlocking_d()     (gFsciTxBlocking)
+#endif
+
 /************************************************************************************
 *************************************************************************************
 * Private prototypes
 *************************************************************************************
 ************************************************************************************/
-fsci_packetStatus_t FSCI_checkPacket( clientPacket_t *pData, uint16_t bytes, uint8_t* pVIntf );
+static uint16_t FSCI_rxBytesNeeded( fsciComm_t *pCommData );
+static fsci_packetStatus_t FSCI_decodeByte( fsciComm_t *pCommData, uint8_t c );
 
 #if gFsciRxAck_c && gFsciRxAckTimeoutUseTmr_c
 static void FSCI_RxAckExpireCb(void *param);
@@ -91,12 +108,31 @@ static void FSCI_RxRxTimeoutCb(void *param);
 #endif
 
 static void FSCI_SendPacketToSerialManager(uint32_t fsciInterface, uint8_t *pPacket, uint16_t packetLen);
+static void FSCI_SendSegmentsToSerialManager(uint32_t fsciInterface, const serialSegment_t *pSegments,
+                                             uint8_t segmentsCount, pSerialCallBack_t txCallback, void *pTxParam);
 
 /************************************************************************************
 *************************************************************************************
 * Private type definitions
 *************************************************************************************
 ************************************************************************************/
+/* A frame sent as a list of segments: the header and the checksum are kept here
+   and the payload is sent from the buffer of the caller */
+typedef struct fsciTxFrame_tag
+{
+    serialSegment_t   segments[mFsciTxFrameSegments_c];
+    clientPacketHdr_t header;
+    uint8_t           checksum[2];  /* the second one is sent on virtual interfaces */
+    void             *pBuffer;      /* the payload buffer, freed once the frame is sent */
+    bool_t            inUse;
+} fsciTxFrame_t;
+
+#if !gFsciUseEscapeSeq_c
+static void FSCI_BuildTxFrame(fsciTxFrame_t *pFrame, uint8_t OG, uint8_t OC, void *pMsg,
+                              uint16_t msgLen, uint32_t fsciInterface);
+static fsciTxFrame_t* FSCI_TxFrameAlloc(void);
+static void FSCI_TxFrameCallback(void *pParam);
+#endif
 
 /************************************************************************************
 *************************************************************************************
@@ -138,6 +174,10 @@ static fsciComm_t mFsciCommData[gFsciMaxInterfaces_c];
 
 static uint8_t mFsciSrcInterface = mFsciInvalidInterface_c;
 
+#if !gFsciUseEscapeSeq_c
+static fsciTxFrame_t mFsciTxFrames[mFsciTxFramesCount_c];
+#endif
+
 /************************************************************************************
 *************************************************************************************
 * Public functions
@@ -289,9 +329,11 @@ void FSCI_receivePacket( void* param )
     uint64_t            currentTs = 0;
 #endif  
     fsciComm_t          *pCommData = &mFsciCommData[(uint32_t)param];
+    uint8_t             aRxChunk[mFsciRxChunkSize_c];
     uint16_t            readBytes;
+    uint16_t            i;
     fsci_packetStatus_t status;
-    uint8_t             virtualInterfaceId;
+    bool_t              rxStop = FALSE;
     uint8_t             c;
     
 #if gFsciRxTimeout_c
@@ -315,7 +357,8 @@ void FSCI_receivePacket( void* param )
         NvClearCriticalSection();
 #endif                                                  
         pCommData->rxOngoing = FALSE;
-        if( pCommData->pPacketFromClient != (clientPacket_t*)&pCommData->pktHeader )
+        if( (NULL != pCommData->pPacketFromClient) &&
+            (pCommData->pPacketFromClient != (clientPacket_t*)&pCommData->pktHeader) )
         {
             MEM_BufferFree(pCommData->pPacketFromClient);
         }
@@ -324,63 +367,45 @@ void FSCI_receivePacket( void* param )
     }
 #endif    
     
-    if( gSerial_Success_c != Serial_GetByteFromRxBuffer( gFsciSerialInterfaces[(uint32_t)param], &c, &readBytes ) )
-    {
-        return;
-    }
-
-    while( readBytes )
+    /* The chunks never extend past the end of the current packet, so no bytes of
+       the next packet are held here while the current one is being processed */
+    while( !rxStop &&
+           (gSerial_Success_c == Serial_Read( gFsciSerialInterfaces[(uint32_t)param], aRxChunk,
+                                              FSCI_rxBytesNeeded(pCommData), &readBytes )) &&
+           readBytes )
     {
 #if gFsciRxTimeout_c
         timerRestartEn = TRUE;
 #endif    
-        if( NULL == pCommData->pPacketFromClient )
-        {
-            pCommData->bytesReceived = 0;
-            if( c == gFSCI_StartMarker_c )
-            {
-                pCommData->pPacketFromClient = (clientPacket_t*)&pCommData->pktHeader;
-                pCommData->bytesReceived++;
-#if gNvStorageIncluded_d
-                NvSetCriticalSection();
-#endif                
-#if gFsciRxTimeout_c
-                pCommData->rxOngoing = TRUE;
-#endif                
-            }
-        }
-        else
+        i = 0;
+        while( i < readBytes )
         {
-            pCommData->pPacketFromClient->raw[pCommData->bytesReceived++] = c;
+            c = aRxChunk[i++];
 
-#if gFsciUseEscapeSeq_c
-            FSCI_decodeEscapeSeq( pCommData->pPacketFromClient->raw, pCommData->bytesReceived );
-#endif
-
-            /* call the check pachet function to see if we have a valid packet */
-            status = FSCI_checkPacket( pCommData->pPacketFromClient, pCommData->bytesReceived, &virtualInterfaceId );
-
-            if( (pCommData->bytesReceived == sizeof(clientPacketHdr_t)) && (status == PACKET_IS_TO_SHORT) )
+            if( NULL == pCommData->pPacketFromClient )
             {
-                pCommData->pPacketFromClient = MEM_BufferAlloc( sizeof(clientPacketHdr_t) + pCommData->pktHeader.len + 2 );
-                if( NULL != pCommData->pPacketFromClient )
-                {
-                    FLib_MemCpy(pCommData->pPacketFromClient, &pCommData->pktHeader, sizeof(clientPacketHdr_t));
-                }
-                else
+                if( c == gFSCI_StartMarker_c )
                 {
+                    pCommData->pktHeader.startMarker = c;
+                    pCommData->pPacketFromClient = (clientPacket_t*)&pCommData->pktHeader;
+                    pCommData->bytesReceived = 1;
+                    pCommData->rxState = FSCI_RX_HEADER;
+                    pCommData->rxChecksum = 0;
+#if gFsciUseEscapeSeq_c
+                    pCommData->rxEscape = FALSE;
+#endif
 #if gNvStorageIncluded_d
-                    NvClearCriticalSection();
-#endif                    
+                    NvSetCriticalSection();
+#endif                
 #if gFsciRxTimeout_c
-#if !mFsciRxTimeoutUsePolling_c
-                    (void)TMR_StopTimer(pCommData->rxRestartTmr);
-#endif
-                    pCommData->rxOngoing = FALSE;
-#endif
+                    pCommData->rxOngoing = TRUE;
+#endif                
                 }
+                continue;
             }
 
+            status = FSCI_decodeByte( pCommData, c );
+
             if( status == PACKET_IS_VALID )
             {
 #if gNvStorageIncluded_d
@@ -401,14 +426,15 @@ void FSCI_receivePacket( void* param )
                     MEM_BufferFree(pCommData->pPacketFromClient);   
                     pCommData->pPacketFromClient = NULL;
                     /* Do not process any other packets for now */
+                    rxStop = TRUE;
                     break;
                 }
                 else
 #endif
                 {     
-                    mFsciSrcInterface = FSCI_GetFsciInterface((uint32_t)param, virtualInterfaceId); 
+                    mFsciSrcInterface = FSCI_GetFsciInterface((uint32_t)param, pCommData->rxVirtualInterface); 
 #if gFsciTxAck_c
-                    FSCI_Ack(c, mFsciSrcInterface);
+                    FSCI_Ack(pCommData->pPacketFromClient->raw[pCommData->bytesReceived - 1], mFsciSrcInterface);
 #endif      
 #if gFsciHostSupport_c
                     if( gFsciHostWaitingSyncRsp &&
@@ -429,86 +455,39 @@ void FSCI_receivePacket( void* param )
                 }
                 pCommData->pPacketFromClient = NULL;
             }
-            else if (status == FRAMING_ERROR)
+            else if( (status == FRAMING_ERROR) || (status == INTERNAL_ERROR) )
             {
-#if 0
-                uint16_t i;
-
-                /* If there appears to be a framing error, search the data received for */
-                /* the next STX and try again. */
-                c = 0;
-                for (i = 0; i < pCommData->bytesReceived; ++i)
+                if( (NULL != pCommData->pPacketFromClient) &&
+                    (pCommData->pPacketFromClient != (clientPacket_t*)&pCommData->pktHeader) )
                 {
-                    if (pCommData->pPacketFromClient->raw[i] == gFSCI_StartMarker_c)
-                    {
-                        c = gFSCI_StartMarker_c;
-                        pCommData->bytesReceived -= i;
-                        FLib_MemCpy( pCommData->pPacketFromClient->raw,
-                                    pCommData->pPacketFromClient->raw + i,
-                                    pCommData->bytesReceived);
-#if 0
-                        /* If a payload buffer was alocated, and the new payload is larger than the buffer's size,
-                        * then a new buffer must be allocated. The received data is copied into the new buffer,
-                        * and the old one is freed.
-                        */
-                        if( (void*)pCommData->pPacketFromClient != (void*)&pCommData->pktHeader &&
-                            pCommData->bytesReceived >= sizeof(clientPacketHdr_t) &&
-                            pCommData->pPacketFromClient->structured.header.len > MEM_BufferGetSize(pCommData->pPacketFromClient) 
-                          )
-                        {
-                            clientPacket_t *p;
-                            p = MEM_BufferAlloc( sizeof(clientPacketHdr_t) + pCommData->pPacketFromClient->structured.header.len + 2 );
-                            
-                            if( NULL != p )
-                            {
-                                FLib_MemCpy(p->raw,
-                                            pCommData->pPacketFromClient->raw,
-                                            pCommData->bytesReceived);
-                            }
-                            
-                            MEM_BufferFree( pCommData->pPacketFromClient );                                
-                            pCommData->pPacketFromClient = p;
-                        }
-#endif
-                        break;
-                    }
+                    MEM_BufferFree(pCommData->pPacketFromClient);
                 }
 
-                if( c != gFSCI_StartMarker_c )
-#endif
-                {
-                    if( pCommData->pPacketFromClient != (clientPacket_t*)&pCommData->pktHeader )
-                    {
-                        MEM_BufferFree(pCommData->pPacketFromClient);
-                    }
-
-                    pCommData->pPacketFromClient = NULL;
-                    
+                pCommData->pPacketFromClient = NULL;
+                
 #if gNvStorageIncluded_d
-                    NvClearCriticalSection();
+                NvClearCriticalSection();
 #endif                    
 #if gFsciRxTimeout_c
 #if !mFsciRxTimeoutUsePolling_c
-                    (void)TMR_StopTimer(pCommData->rxRestartTmr);
+                (void)TMR_StopTimer(pCommData->rxRestartTmr);
 #endif
-                    pCommData->rxOngoing = FALSE;
+                pCommData->rxOngoing = FALSE;
 #endif
+#if gFsciUseEscapeSeq_c
+                /* An unescaped start marker inside a packet starts a new packet */
+                if( c == gFSCI_StartMarker_c )
+                {
+                    i--;
                 }
-                
+#endif
             } /* if (status == FRAMING_ERROR) */
             else
             {
                 /* fix MISRA-C 2004 error */
             }
-            
-        }  /* if (!startOfFrameSeen) */
-
-        if ( gSerial_Success_c != Serial_GetByteFromRxBuffer( gFsciSerialInterfaces[(uint32_t)param], &c, &readBytes ) )
-        {
-            break;
-        }
-
-    } /* while (j < size) */
+        } /* while (i < readBytes) */
+    } /* while (Serial_Read()) */
     
 #if gFsciRxTimeout_c
     if( timerRestartEn && pCommData->rxOngoing )
@@ -579,12 +558,25 @@ void FSCI_transmitPayload( uint8_t OG, uint8_t OC, void *pMsg, uint16_t msgLen,
     uint8_t checksum, checksum2;
     clientPacketHdr_t header;
     uint32_t virtInterface = FSCI_GetVirtualInterface(fsciInterface);
+#if !gFsciUseEscapeSeq_c
+    fsciTxFrame_t frame;
+#endif
 
     if( gFsciTxDisable || (msgLen > gFsciMaxPayloadLen_c) )
     {
         return;
     }
 
+#if !gFsciUseEscapeSeq_c
+    /* A blocking Tx ends before returning: the payload is sent in place */
+    if( mFsciTxIsBlocking_d() )
+    {
+        FSCI_BuildTxFrame(&frame, OG, OC, pMsg, msgLen, fsciInterface);
+        FSCI_SendSegmentsToSerialManager(fsciInterface, frame.segments, mFsciTxFrameSegments_c, NULL, NULL);
+        return;
+    }
+#endif
+
     /* Compute size */
     buffer_size = sizeof(clientPacketHdr_t) + msgLen + 2*sizeof(checksum);
 
@@ -616,7 +608,9 @@ void FSCI_transmitPayload( uint8_t OG, uint8_t OC, void *pMsg, uint16_t msgLen,
 
     index = 0;
 #if gFsciUseEscapeSeq_c
-    index += FSCI_encodeEscapeSeq( (uint8_t*)&header, sizeof(header), &buffer_ptr[index] );
+    /* The start marker is the only unescaped one */
+    buffer_ptr[index++] = gFSCI_StartMarker_c;
+    index += FSCI_encodeEscapeSeq( (uint8_t*)&header + 1, sizeof(header) - 1, &buffer_ptr[index] );
     index += FSCI_encodeEscapeSeq( pMsg, msgLen, &buffer_ptr[index]);
     /* Store the Checksum*/
     index += FSCI_encodeEscapeSeq( (uint8_t*)&checksum, sizeof(checksum), &buffer_ptr[index] );
@@ -644,6 +638,49 @@ void FSCI_transmitPayload( uint8_t OG, uint8_t OC, void *pMsg, uint16_t msgLen,
     FSCI_SendPacketToSerialManager(fsciInterface, buffer_ptr, index);
 }
 
+/*! *********************************************************************************
+* \brief  Encode and send messages over the serial interface, without copying the
+*         payload. The payload buffer is owned by the FSCI from now on, and it is
+*         freed once the message is sent.
+*
+* \param[in] OG operation Group
+* \param[in] OC operation Code
+* \param[in] pMsg pointer to payload, allocated using MEM_BufferAlloc()
+* \param[in] msgLen length of the payload
+* \param[in] fsciInterface the interface on which the packet should be sent
+*
+* \remarks With escape sequences, with a blocking Tx or when all the Tx frames
+*          are in use, the message is sent by FSCI_transmitPayload().
+*
+********************************************************************************** */
+void FSCI_transmitPayloadBuffer( uint8_t OG, uint8_t OC, void *pMsg, uint16_t msgLen, uint32_t fsciInterface )
+{
+#if !gFsciUseEscapeSeq_c
+    fsciTxFrame_t *pFrame = NULL;
+
+    if( !gFsciTxDisable && (msgLen <= gFsciMaxPayloadLen_c) && !mFsciTxIsBlocking_d() )
+    {
+        pFrame = FSCI_TxFrameAlloc();
+    }
+
+    if( pFrame )
+    {
+        FSCI_BuildTxFrame(pFrame, OG, OC, pMsg, msgLen, fsciInterface);
+        pFrame->pBuffer = pMsg;
+        FSCI_SendSegmentsToSerialManager(fsciInterface, pFrame->segments, mFsciTxFrameSegments_c,
+                                         FSCI_TxFrameCallback, pFrame);
+    }
+    else
+#endif
+    {
+        FSCI_transmitPayload(OG, OC, pMsg, msgLen, fsciInterface);
+        if( pMsg )
+        {
+            (void)MEM_BufferFree(pMsg);
+        }
+    }
+}
+
 /*! *********************************************************************************
 * \brief  Get a FSCI formatted packet from a payload message
 *
@@ -744,89 +781,153 @@ uint32_t FSCI_GetFsciInterface(uint32_t hwInterface, uint32_t virtualInterface)
 }
 
 /*! *********************************************************************************
-* \brief  Checks to see if we have a valid packet
+* \brief  Returns the number of bytes to be read from the serial interface in one chunk.
+*         The chunk never extends past the end of the packet being received: a
+*         packet holds at least as many bytes as the ones still expected, escaped
+*         or not.
 *
-* \param[in] pData The message containing the incoming data packet to be handled.
-* \param[in] bytes the number of bytes inside the buffer
-* \param[Out] pVIntf pointer to the location where the virtual interface Id will be stored
+* \param[in] pCommData pointer to the receive state of the fsci interface
 *
-* \return the status of the packet
+* \return the number of bytes to be read
 *
 ********************************************************************************** */
-fsci_packetStatus_t FSCI_checkPacket( clientPacket_t *pData, uint16_t bytes, uint8_t* pVIntf )
+static uint16_t FSCI_rxBytesNeeded( fsciComm_t *pCommData )
 {
-    uint8_t checksum = 0;
-    uint16_t len;
+    uint16_t bytes;
 
-    if ( bytes < MIN_VALID_PACKET_LEN )
+    if( NULL == pCommData->pPacketFromClient )
     {
-        return PACKET_IS_TO_SHORT;            /* Too short to be valid. */
+        /* The start marker and, at most, the rest of the header */
+        bytes = sizeof(clientPacketHdr_t);
     }
-
-    if ( bytes >= sizeof(clientPacket_t) )
+    else if( FSCI_RX_HEADER == pCommData->rxState )
     {
-        return FRAMING_ERROR;
+        bytes = sizeof(clientPacketHdr_t) - pCommData->bytesReceived;
+    }
+    else if( FSCI_RX_PAYLOAD == pCommData->rxState )
+    {
+        bytes = sizeof(clientPacketHdr_t) + pCommData->pktHeader.len - pCommData->bytesReceived;
+    }
+    else
+    {
+        bytes = 1;
     }
 
-    if ( NULL == pData )
+    if( bytes > mFsciRxChunkSize_c )
     {
-        return INTERNAL_ERROR;
+        bytes = mFsciRxChunkSize_c;
     }
 
-    /* The packet's len field does not count the STX, the opcode group, the */
-    /* opcode, the len field, or the checksum. */
-    len = pData->structured.header.len;
-    
-    /* If the length appears to be too long, it might be because the external */
-    /* client is sending a packet that is too long, or it might be that we're */
-    /* out of sync with the external client. Assume we're out of sync. */
-    if ( len > gFsciMaxPayloadLen_c )
+    return bytes;
+}
+
+/*! *********************************************************************************
+* \brief  Decodes one byte of a packet, after its start marker. Every byte is
+*         unescaped and added to the checksum once, as it is received.
+*
+* \param[in] pCommData pointer to the receive state of the fsci interface
+* \param[in] c the received byte
+*
+* \return the status of the packet: PACKET_IS_TO_SHORT while more bytes are
+*         expected, INTERNAL_ERROR if no buffer could be allocated for the packet
+*
+********************************************************************************** */
+static fsci_packetStatus_t FSCI_decodeByte( fsciComm_t *pCommData, uint8_t c )
+{
+    fsci_packetStatus_t status = PACKET_IS_TO_SHORT;
+
+#if gFsciUseEscapeSeq_c
+    /* The markers are always escaped inside a packet */
+    if( (c == gFSCI_StartMarker_c) || (c == gFSCI_EndMarker_c) )
     {
         return FRAMING_ERROR;
-    }    
-    
-    if ( bytes < len + sizeof(clientPacketHdr_t) + sizeof(checksum) )
-    {
-        return PACKET_IS_TO_SHORT;
     }
 
-    /* If the length looks right, make sure that the checksum is correct. */
-    if( bytes >= len + sizeof(clientPacketHdr_t) + sizeof(checksum) )
+    if( pCommData->rxEscape )
     {
-        checksum = FSCI_computeChecksum(pData->raw+1, len + sizeof(clientPacketHdr_t)-1);
-        *pVIntf = pData->structured.payload[len] - checksum;
+        pCommData->rxEscape = FALSE;
+        c ^= gFSCI_EscapeChar_c;
     }
-    
-    if( bytes == len + sizeof(clientPacketHdr_t) + sizeof(checksum) )
+    else if( c == gFSCI_EscapeChar_c )
     {
-        if( 0 == *pVIntf )
+        pCommData->rxEscape = TRUE;
+        return PACKET_IS_TO_SHORT;
+    }
+#endif
+
+    pCommData->pPacketFromClient->raw[pCommData->bytesReceived++] = c;
+
+    switch( pCommData->rxState )
+    {
+    case FSCI_RX_HEADER:
+        pCommData->rxChecksum ^= c;
+        if( pCommData->bytesReceived == sizeof(clientPacketHdr_t) )
+        {
+            /* If the length appears to be too long, it might be because the external */
+            /* client is sending a packet that is too long, or it might be that we're */
+            /* out of sync with the external client. Assume we're out of sync. */
+            if( pCommData->pktHeader.len > gFsciMaxPayloadLen_c )
+            {
+                return FRAMING_ERROR;
+            }
+
+            pCommData->pPacketFromClient = MEM_BufferAlloc( sizeof(clientPacketHdr_t) + pCommData->pktHeader.len + 2 );
+            if( NULL == pCommData->pPacketFromClient )
+            {
+                return INTERNAL_ERROR;
+            }
+
+            FLib_MemCpy(pCommData->pPacketFromClient, &pCommData->pktHeader, sizeof(clientPacketHdr_t));
+            pCommData->rxState = pCommData->pktHeader.len ? FSCI_RX_PAYLOAD : FSCI_RX_CHECKSUM;
+        }
+        break;
+
+    case FSCI_RX_PAYLOAD:
+        pCommData->rxChecksum ^= c;
+        if( pCommData->bytesReceived == sizeof(clientPacketHdr_t) + pCommData->pktHeader.len )
         {
-            return PACKET_IS_VALID;
+            pCommData->rxState = FSCI_RX_CHECKSUM;
+        }
+        break;
+
+    case FSCI_RX_CHECKSUM:
+        /* The checksum is incremented with the virtual interface Id */
+        pCommData->rxVirtualInterface = c - pCommData->rxChecksum;
+        if( 0 == pCommData->rxVirtualInterface )
+        {
+            status = PACKET_IS_VALID;
         }
 #if gFsciMaxVirtualInterfaces_c
-        else 
+        else if( pCommData->rxVirtualInterface < gFsciMaxVirtualInterfaces_c )
         {
-            if( *pVIntf < gFsciMaxVirtualInterfaces_c )
-            {
-                return PACKET_IS_TO_SHORT;
-            }
+            pCommData->rxState = FSCI_RX_VIRTUAL_CHECKSUM;
         }
 #endif
-    }
+        else
+        {
+            status = FRAMING_ERROR;
+        }
+        break;
 
 #if gFsciMaxVirtualInterfaces_c
-    /* Check virtual interface */
-    if( bytes == len + sizeof(clientPacketHdr_t) + 2*sizeof(checksum) )
-    {
-        checksum ^= checksum + *pVIntf;
-        if( pData->structured.payload[len+1] == checksum )
+    case FSCI_RX_VIRTUAL_CHECKSUM:
+        if( c == (uint8_t)(pCommData->rxChecksum ^ (uint8_t)(pCommData->rxChecksum + pCommData->rxVirtualInterface)) )
         {
-            return PACKET_IS_VALID;
+            status = PACKET_IS_VALID;
         }
-    }
+        else
+        {
+            status = FRAMING_ERROR;
+        }
+        break;
 #endif
 
-    return FRAMING_ERROR;
+    default:
+        status = INTERNAL_ERROR;
+        break;
+    }
+
+    return status;
 }
 
 /*! *********************************************************************************
@@ -967,6 +1068,29 @@ static void FSCI_RxRxTimeoutCb(void *param)
 *
 ********************************************************************************** */
 static void FSCI_SendPacketToSerialManager(uint32_t fsciInterface, uint8_t *pPacket, uint16_t packetLen)
+{
+    serialSegment_t segment;
+
+    segment.pData = pPacket;
+    segment.dataSize = packetLen;
+    FSCI_SendSegmentsToSerialManager(fsciInterface, &segment, 1, (pSerialCallBack_t)FSCI_txCallback, pPacket);
+}
+
+/*! *********************************************************************************
+* \brief  This function is used to send a FSCI packet, made of a list of segments,
+*         to the serial manager
+*
+* \param[in]  fsciInterface fsci interface on which the packet is to be sent
+* \param[in]  pSegments the segments of the packet. A single segment is copied, a
+*             list of segments must be kept unchanged until txCallback is run
+* \param[in]  segmentsCount the number of segments
+* \param[in]  txCallback function run once the packet is sent, may be NULL for
+*             a blocking Tx
+* \param[in]  pTxParam the parameter of txCallback
+*
+********************************************************************************** */
+static void FSCI_SendSegmentsToSerialManager(uint32_t fsciInterface, const serialSegment_t *pSegments,
+                                             uint8_t segmentsCount, pSerialCallBack_t txCallback, void *pTxParam)
 {
 #if gFsciRxAck_c
     fsciComm_t     *pCommData = &mFsciCommData[fsciInterface];
@@ -985,7 +1109,7 @@ static void FSCI_SendPacketToSerialManager(uint32_t fsciInterface, uint8_t *pPac
     
     while( pCommData->txRetryCnt )
     {
-        Serial_SyncWrite(gFsciSerialInterfaces[fsciInterface], pPacket, packetLen);
+        Serial_SyncWriteV(gFsciSerialInterfaces[fsciInterface], pSegments, segmentsCount);
         pCommData->ackWaitOngoing = TRUE;
         
         /* Allow the FSCI interface to receive ACK packet, 
@@ -1038,25 +1162,129 @@ static void FSCI_SendPacketToSerialManager(uint32_t fsciInterface, uint8_t *pPac
 #endif
     }
     
-    MEM_BufferFree(pPacket);
+    if( txCallback )
+    {
+        txCallback(pTxParam);
+    }
 
     OSA_MutexUnlock(pCommData->syncTxRxAckMutexId);
 #else /* gFsciRxAck_c */
 #if gFsciUseBlockingTx_c
     if( gFsciTxBlocking )
     {        
-        Serial_SyncWrite(gFsciSerialInterfaces[fsciInterface], pPacket, packetLen);
-        MEM_BufferFree(pPacket);
+        Serial_SyncWriteV(gFsciSerialInterfaces[fsciInterface], pSegments, segmentsCount);
+        if( txCallback )
+        {
+            txCallback(pTxParam);
+        }
     }
     else
 #endif /* gFsciUseBlockingTx_c */
-    {     
-        if(gSerial_Success_c != Serial_AsyncWrite( gFsciSerialInterfaces[fsciInterface], pPacket, packetLen, (pSerialCallBack_t)FSCI_txCallback, pPacket))
+    {
+        serialStatus_t status;
+
+        if( 1 == segmentsCount )
+        {
+            status = Serial_AsyncWrite( gFsciSerialInterfaces[fsciInterface], pSegments->pData, pSegments->dataSize, txCallback, pTxParam);
+        }
+        else
         {
-            MEM_BufferFree(pPacket);
+            status = Serial_AsyncWriteV( gFsciSerialInterfaces[fsciInterface], pSegments, segmentsCount, txCallback, pTxParam);
+        }
+
+        if( (gSerial_Success_c != status) && txCallback )
+        {
+            txCallback(pTxParam);
         }
     }
 #endif /* gFsciRxAck_c */ 
 }
 
+#if !gFsciUseEscapeSeq_c
+/*! *********************************************************************************
+* \brief  Compute the header and the checksum of a frame and set its segments.
+*
+* \param[out] pFrame pointer to the frame
+* \param[in]  OG operation Group
+* \param[in]  OC operation Code
+* \param[in]  pMsg pointer to payload
+* \param[in]  msgLen length of the payload
+* \param[in]  fsciInterface the interface on which the frame will be sent
+*
+********************************************************************************** */
+static void FSCI_BuildTxFrame(fsciTxFrame_t *pFrame, uint8_t OG, uint8_t OC, void *pMsg,
+                              uint16_t msgLen, uint32_t fsciInterface)
+{
+    uint32_t virtInterface = FSCI_GetVirtualInterface(fsciInterface);
+    uint8_t  checksum;
+
+    pFrame->header.startMarker = gFSCI_StartMarker_c;
+    pFrame->header.opGroup = OG;
+    pFrame->header.opCode = OC;
+    pFrame->header.len = msgLen;
+
+    /* Compute CRC for TX packet, on opcode group, opcode, payload length, and payload fields */
+    checksum = FSCI_computeChecksum((uint8_t*)&pFrame->header + 1, sizeof(clientPacketHdr_t) - 1);
+    checksum ^= FSCI_computeChecksum((uint8_t*)pMsg, msgLen);
+    pFrame->checksum[0] = checksum;
+    pFrame->segments[2].dataSize = sizeof(checksum);
+    if( virtInterface )
+    {
+        pFrame->checksum[0] += virtInterface;
+        pFrame->checksum[1] = checksum^(checksum + virtInterface);
+        pFrame->segments[2].dataSize += sizeof(checksum);
+    }
+
+    pFrame->segments[0].pData = (uint8_t*)&pFrame->header;
+    pFrame->segments[0].dataSize = sizeof(clientPacketHdr_t);
+    pFrame->segments[1].pData = (uint8_t*)pMsg;
+    pFrame->segments[1].dataSize = msgLen;
+    pFrame->segments[2].pData = pFrame->checksum;
+    pFrame->pBuffer = NULL;
+}
+
+/*! *********************************************************************************
+* \brief  Get a free Tx frame.
+*
+* \return pointer to the frame, or NULL if all the frames are in use
+*
+********************************************************************************** */
+static fsciTxFrame_t* FSCI_TxFrameAlloc(void)
+{
+    fsciTxFrame_t *pFrame = NULL;
+    uint32_t i;
+
+    OSA_InterruptDisable();
+    for( i = 0; i < mFsciTxFramesCount_c; i++ )
+    {
+        if( !mFsciTxFrames[i].inUse )
+        {
+            mFsciTxFrames[i].inUse = TRUE;
+            pFrame = &mFsciTxFrames[i];
+            break;
+        }
+    }
+    OSA_InterruptEnable();
+
+    return pFrame;
+}
+
+/*! *********************************************************************************
+* \brief  Free a Tx frame, and its payload buffer, once the frame is sent.
+*
+* \param[in]  pParam pointer to the frame
+*
+********************************************************************************** */
+static void FSCI_TxFrameCallback(void *pParam)
+{
+    fsciTxFrame_t *pFrame = (fsciTxFrame_t*)pParam;
+
+    if( pFrame->pBuffer )
+    {
+        (void)MEM_BufferFree(pFrame->pBuffer);
+    }
+    pFrame->inUse = FALSE;
+}
+#endif /* !gFsciUseEscapeSeq_c */
+
 #endif /* gFsciIncluded_c */
@@ -68,10 +68,24 @@ typedef enum {
   INTERNAL_ERROR
 } fsci_packetStatus_t;
 
+/* Receive state of a packet, after its start marker was found */
+typedef enum {
+  FSCI_RX_HEADER,
+  FSCI_RX_PAYLOAD,
+  FSCI_RX_CHECKSUM,
+  FSCI_RX_VIRTUAL_CHECKSUM
+} fsci_rxState_t;
+
 typedef struct fsciComm_tag{
     clientPacket_t    *pPacketFromClient;
     clientPacketHdr_t  pktHeader;
     uint16_t           bytesReceived;
+    fsci_rxState_t     rxState;
+    uint8_t            rxChecksum;       /* XOR of the received header and payload bytes */
+    uint8_t            rxVirtualInterface;
+#if gFsciUseEscapeSeq_c
+    bool_t             rxEscape;         /* the last received byte was an escape character */
+#endif
 #if gFsciHostSupport_c
     osaMutexId_t       syncHostMutexId;
 #endif
@@ -0,0 +1,898 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file FsciRxBench.c
+* Host fuzz test and throughput benchmark of the FSCI receive path.
+*
+* FSCICommunication.c is built against a simulated serial interface: the bytes
+* of a stream "arrive" in the Rx buffer in random amounts and FSCI_receivePacket()
+* reads them the way it does on target, through Serial_Read(). The frames are
+* built by FSCI_transmitPayload() itself. The received packets are logged by
+* FSCI_ProcessRxPkt() and compared with the expected ones.
+*
+* The reference decoder is the FSCI 5.0.5 receive loop: one byte per
+* Serial_GetByteFromRxBuffer() call, FSCI_decodeEscapeSeq() over the whole buffer
+* and FSCI_checkPacket() (checksum of the whole buffer) after every byte.
+*
+* clean: random frames, escape heavy payloads included, fed in random amounts;
+*   every frame must be received once, in order, on its (virtual) interface.
+* corrupt: frames with flipped, dropped and inserted bytes and failed buffer
+*   allocations; no buffer may overflow or leak and the NVM critical section must
+*   be left. After an Rx timeout, the next clean frames must be received.
+* differential: random streams of frames and noise, compared packet by packet
+*   with the reference decoder (builds without escape sequences only: the
+*   reference decoder rescans the bytes it has already unescaped).
+* throughput: MB/s of wire bytes for typical (random payload) and worst case
+*   (every payload byte escaped) frames, of both decoders.
+*
+* Build (on case sensitive file systems, link FsciCommunication.h and
+* FsciCommands.h to ../Source/FSCICommunication.h and ../Source/FSCICommands.h
+* in a directory of the include path first):
+*   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast -I. -I../Source
+*       -I../Interface -I../../Common -I../../FunctionLib -I../../SerialManager/Interface
+*       -I../../TimersManager/Interface -I../../OSAbstraction/Interface
+*       -I../../MemManager/Interface -I../../Panic/Interface -I../../NVM/Interface
+*       -I../../Messaging/Interface -I../../Lists
+*       -o FsciRxBench FsciRxBench.c ../../FunctionLib/FunctionLib.c
+*   add -DgFsciUseEscapeSeq_c=1 for escape sequences, -DgFsciMaxVirtualInterfaces_c=2
+*   for virtual interfaces, -DgFsciMaxPayloadLen_c=<bytes> to change the maximum
+*   payload (1300 bytes by default, for THCI serial tunnel frames)
+* Usage: FsciRxBench [fuzz iterations [seed]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef gFsciIncluded_c
+#define gFsciIncluded_c             1
+#endif
+#ifndef gFsciLenHas2Bytes_c
+#define gFsciLenHas2Bytes_c         1
+#endif
+#ifndef gFsciMaxPayloadLen_c
+#define gFsciMaxPayloadLen_c        1300
+#endif
+#if defined(gFsciMaxVirtualInterfaces_c) && gFsciMaxVirtualInterfaces_c && !defined(gFsciMaxInterfaces_c)
+#define gFsciMaxInterfaces_c        gFsciMaxVirtualInterfaces_c
+#endif
+#ifndef gNvStorageIncluded_d
+#define gNvStorageIncluded_d        1
+#endif
+#ifndef gTMR_Enabled_d
+#define gTMR_Enabled_d              0
+#endif
+
+#include <stdint.h>
+static void* BenchAlloc(uint32_t numBytes);
+#define MEM_BufferAlloc(numBytes)   BenchAlloc(numBytes)
+
+#include "../Source/FSCICommunication.c"
+
+#if gFsciRxAck_c || gFsciTxAck_c || gFsciHostSupport_c
+#error "*** ERROR: the FSCI acknowledgements and host support are not simulated"
+#endif
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultIter_c         (2000)
+#define mBenchStreamSize_c          (1024 * 1024)
+#define mBenchLogSize_c             (4096)
+#define mBenchArrivalMax_c          (96)
+#define mBenchGuardSize_c           (16)
+#define mBenchGuardByte_c           (0xA5)
+#define mBenchThroughputBytes_c     (4 * 1024 * 1024)
+
+#if gFsciMaxVirtualInterfaces_c
+#define mBenchInterfaces_c          gFsciMaxInterfaces_c
+#else
+#define mBenchInterfaces_c          1
+#endif
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* A received or expected packet */
+typedef struct benchPkt_tag
+{
+    uint32_t hash;      /* of the operation group, code and payload */
+    uint16_t len;
+    uint8_t  intf;
+} benchPkt_t;
+
+typedef struct benchLog_tag
+{
+    benchPkt_t pkt[mBenchLogSize_c];
+    uint32_t   count;
+} benchLog_t;
+
+/* The payload kinds */
+typedef enum
+{
+    mBenchRandom_c,     /* uniformly random bytes */
+    mBenchMixed_c,      /* one byte out of four is a marker or an escape character */
+    mBenchEscaped_c     /* every byte must be escaped */
+} benchPayload_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+/* The simulated serial interface: the bytes before mArrived are in the Rx buffer */
+static uint8_t  mStream[mBenchStreamSize_c];
+static uint32_t mStreamLen;
+static uint32_t mStreamPos;
+static uint32_t mArrived;
+static uint32_t mSerialReads;
+
+static benchLog_t mExpected;
+static benchLog_t mReceived;
+static benchLog_t mRefReceived;
+
+static int32_t  mBuffers;
+static uint32_t mAllocFailRate;
+static int32_t  mCriticalSection;
+static uint32_t mFailures;
+
+/* The reference decoder state */
+static uint8_t  mRefBuffer[sizeof(clientPacket_t) + 64];
+static bool_t   mRefStarted;
+static uint16_t mRefBytes;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+
+/*! *********************************************************************************
+* \brief  Returns a pseudo random number (xorshift32).
+********************************************************************************** */
+static uint32_t mRandState = 1;
+static uint32_t BenchRand(void)
+{
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 17;
+    mRandState ^= mRandState << 5;
+    return mRandState;
+}
+
+static double BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t BenchHash(uint8_t og, uint8_t oc, const uint8_t *pData, uint32_t len)
+{
+    uint32_t hash = 2166136261UL;
+    uint32_t i;
+
+    hash = (hash ^ og) * 16777619UL;
+    hash = (hash ^ oc) * 16777619UL;
+    for( i = 0; i < len; i++ )
+    {
+        hash = (hash ^ pData[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+static void BenchLog(benchLog_t *pLog, uint32_t hash, uint16_t len, uint8_t intf)
+{
+    if( pLog->count < mBenchLogSize_c )
+    {
+        pLog->pkt[pLog->count].hash = hash;
+        pLog->pkt[pLog->count].len = len;
+        pLog->pkt[pLog->count].intf = intf;
+        pLog->count++;
+    }
+}
+
+static bool_t BenchLogsEqual(benchLog_t *pA, benchLog_t *pB)
+{
+    return (pA->count == pB->count) &&
+           (0 == memcmp(pA->pkt, pB->pkt, pA->count * sizeof(benchPkt_t)));
+}
+
+/*! *********************************************************************************
+* \brief  Buffers with a guard area, checked when freed. A buffer is allocated
+*         once out of mAllocFailRate, if set.
+********************************************************************************** */
+static void* BenchAlloc(uint32_t numBytes)
+{
+    uint8_t *pBuf;
+
+    if( mAllocFailRate && (0 == BenchRand() % mAllocFailRate) )
+    {
+        return NULL;
+    }
+
+    pBuf = malloc(numBytes + sizeof(uint32_t) + mBenchGuardSize_c);
+    *(uint32_t*)pBuf = numBytes;
+    memset(pBuf + sizeof(uint32_t) + numBytes, mBenchGuardByte_c, mBenchGuardSize_c);
+    mBuffers++;
+    return pBuf + sizeof(uint32_t);
+}
+
+memStatus_t MEM_BufferFree(void* buffer)
+{
+    uint8_t *pBuf = (uint8_t*)buffer - sizeof(uint32_t);
+    uint32_t numBytes = *(uint32_t*)pBuf;
+    uint32_t i;
+
+    for( i = 0; i < mBenchGuardSize_c; i++ )
+    {
+        if( pBuf[sizeof(uint32_t) + numBytes + i] != mBenchGuardByte_c )
+        {
+            printf("FAIL: buffer of %u bytes overflowed\n", numBytes);
+            mFailures++;
+            break;
+        }
+    }
+
+    mBuffers--;
+    free(pBuf);
+    return MEM_SUCCESS_c;
+}
+
+/*! *********************************************************************************
+* \brief  The simulated serial interface.
+********************************************************************************** */
+serialStatus_t Serial_Read(uint8_t InterfaceId, uint8_t *pData, uint16_t dataSize, uint16_t *bytesRead)
+{
+    uint32_t bytes = mArrived - mStreamPos;
+
+    (void)InterfaceId;
+    if( bytes > dataSize )
+    {
+        bytes = dataSize;
+    }
+
+    memcpy(pData, &mStream[mStreamPos], bytes);
+    mStreamPos += bytes;
+    mSerialReads++;
+    *bytesRead = bytes;
+    return gSerial_Success_c;
+}
+
+/* The transmitted frames are appended to the stream */
+serialStatus_t Serial_AsyncWrite(uint8_t InterfaceId, uint8_t *pBuf, uint16_t bufLen,
+                                 pSerialCallBack_t cb, void *pTxParam)
+{
+    (void)InterfaceId;
+    if( mStreamLen + bufLen <= mBenchStreamSize_c )
+    {
+        memcpy(&mStream[mStreamLen], pBuf, bufLen);
+        mStreamLen += bufLen;
+    }
+
+    cb(pTxParam);
+    return gSerial_Success_c;
+}
+
+serialStatus_t Serial_SyncWrite(uint8_t InterfaceId, uint8_t *pBuf, uint16_t bufLen)
+{
+    (void)InterfaceId; (void)pBuf; (void)bufLen;
+    return gSerial_Success_c;
+}
+
+serialStatus_t Serial_AsyncWriteV(uint8_t InterfaceId, const serialSegment_t *pSegments, uint8_t segmentsCount,
+                                  pSerialCallBack_t cb, void *pTxParam)
+{
+    uint32_t i;
+
+    for( i = 0; i < segmentsCount; i++ )
+    {
+        if( mStreamLen + pSegments[i].dataSize <= mBenchStreamSize_c )
+        {
+            memcpy(&mStream[mStreamLen], pSegments[i].pData, pSegments[i].dataSize);
+            mStreamLen += pSegments[i].dataSize;
+        }
+    }
+
+    cb(pTxParam);
+    return gSerial_Success_c;
+}
+
+serialStatus_t Serial_SyncWriteV(uint8_t InterfaceId, const serialSegment_t *pSegments, uint8_t segmentsCount)
+{
+    (void)InterfaceId; (void)pSegments; (void)segmentsCount;
+    return gSerial_Success_c;
+}
+
+serialStatus_t Serial_InitInterface(uint8_t *pInterfaceId, serialInterfaceType_t interfaceType, uint8_t instance)
+{
+    (void)interfaceType; (void)instance;
+    *pInterfaceId = 0;
+    return gSerial_Success_c;
+}
+
+serialStatus_t Serial_SetBaudRate(uint8_t InterfaceId, uint32_t baudRate)
+{
+    (void)InterfaceId; (void)baudRate;
+    return gSerial_Success_c;
+}
+
+serialStatus_t Serial_SetRxCallBack(uint8_t InterfaceId, pSerialCallBack_t cb, void *pRxParam)
+{
+    (void)InterfaceId; (void)cb; (void)pRxParam;
+    return gSerial_Success_c;
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    (void)id; (void)location; (void)extra1; (void)extra2;
+    printf("FAIL: panic\n");
+    exit(1);
+}
+
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+void NvSetCriticalSection(void)
+{
+    mCriticalSection++;
+}
+
+void NvClearCriticalSection(void)
+{
+    mCriticalSection--;
+}
+
+/* The received packets are logged */
+gFsciStatus_t FSCI_ProcessRxPkt(clientPacket_t* pPacket, uint32_t fsciInterface)
+{
+    BenchLog(&mReceived,
+             BenchHash(pPacket->structured.header.opGroup, pPacket->structured.header.opCode,
+                       pPacket->structured.payload, pPacket->structured.header.len),
+             pPacket->structured.header.len, fsciInterface);
+    MEM_BufferFree(pPacket);
+    return gFsciSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  The reference decoder: FSCI_checkPacket() of FSCI 5.0.5.
+********************************************************************************** */
+static fsci_packetStatus_t RefCheckPacket( clientPacket_t *pData, uint16_t bytes, uint8_t* pVIntf )
+{
+    uint8_t checksum = 0;
+    uint16_t len;
+
+    if ( bytes < sizeof(clientPacketHdr_t) )
+    {
+        return PACKET_IS_TO_SHORT;
+    }
+
+    if ( bytes >= sizeof(clientPacket_t) )
+    {
+        return FRAMING_ERROR;
+    }
+
+    len = pData->structured.header.len;
+
+    if ( len > gFsciMaxPayloadLen_c )
+    {
+        return FRAMING_ERROR;
+    }
+
+    if ( bytes < len + sizeof(clientPacketHdr_t) + sizeof(checksum) )
+    {
+        return PACKET_IS_TO_SHORT;
+    }
+
+    checksum = FSCI_computeChecksum(pData->raw+1, len + sizeof(clientPacketHdr_t)-1);
+    *pVIntf = pData->structured.payload[len] - checksum;
+
+    if( bytes == len + sizeof(clientPacketHdr_t) + sizeof(checksum) )
+    {
+        if( 0 == *pVIntf )
+        {
+            return PACKET_IS_VALID;
+        }
+#if gFsciMaxVirtualInterfaces_c
+        else
+        {
+            if( *pVIntf < gFsciMaxVirtualInterfaces_c )
+            {
+                return PACKET_IS_TO_SHORT;
+            }
+        }
+#endif
+    }
+
+#if gFsciMaxVirtualInterfaces_c
+    if( bytes == len + sizeof(clientPacketHdr_t) + 2*sizeof(checksum) )
+    {
+        checksum ^= checksum + *pVIntf;
+        if( pData->structured.payload[len+1] == checksum )
+        {
+            return PACKET_IS_VALID;
+        }
+    }
+#endif
+
+    return FRAMING_ERROR;
+}
+
+/*! *********************************************************************************
+* \brief  The reference decoder: the FSCI_receivePacket() loop of FSCI 5.0.5, for
+*         one received byte.
+********************************************************************************** */
+static void RefReceiveByte(uint8_t c)
+{
+    clientPacket_t *pPacket = (clientPacket_t*)mRefBuffer;
+    fsci_packetStatus_t status;
+    uint8_t vIntf = 0;
+
+    if( !mRefStarted )
+    {
+        mRefBytes = 0;
+        if( c == gFSCI_StartMarker_c )
+        {
+            mRefStarted = TRUE;
+            mRefBytes++;
+        }
+        return;
+    }
+
+    mRefBuffer[mRefBytes++] = c;
+#if gFsciUseEscapeSeq_c
+    FSCI_decodeEscapeSeq(mRefBuffer, mRefBytes);
+#endif
+    status = RefCheckPacket(pPacket, mRefBytes, &vIntf);
+
+    if( status == PACKET_IS_VALID )
+    {
+        BenchLog(&mRefReceived,
+                 BenchHash(pPacket->structured.header.opGroup, pPacket->structured.header.opCode,
+                           pPacket->structured.payload, pPacket->structured.header.len),
+                 pPacket->structured.header.len, FSCI_GetFsciInterface(0, vIntf));
+        mRefStarted = FALSE;
+    }
+    else if( status == FRAMING_ERROR )
+    {
+        mRefStarted = FALSE;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Resets the stream, the logs and both decoders.
+********************************************************************************** */
+static void BenchReset(void)
+{
+    fsciComm_t *pCommData = &mFsciCommData[0];
+
+    if( (NULL != pCommData->pPacketFromClient) &&
+        (pCommData->pPacketFromClient != (clientPacket_t*)&pCommData->pktHeader) )
+    {
+        MEM_BufferFree(pCommData->pPacketFromClient);
+    }
+
+    memset(mFsciCommData, 0, sizeof(mFsciCommData));
+    mStreamLen = 0;
+    mStreamPos = 0;
+    mArrived = 0;
+    mExpected.count = 0;
+    mReceived.count = 0;
+    mRefReceived.count = 0;
+    mRefStarted = FALSE;
+    mCriticalSection = 0;
+}
+
+/*! *********************************************************************************
+* \brief  Appends a frame built by FSCI_transmitPayload() to the stream.
+********************************************************************************** */
+static void BenchAddFrame(benchPayload_t kind, uint16_t len, bool_t expected)
+{
+    static const uint8_t specials[] = {gFSCI_StartMarker_c, gFSCI_EndMarker_c, gFSCI_EscapeChar_c};
+    static uint8_t payload[gFsciMaxPayloadLen_c];
+    uint8_t og = BenchRand();
+    uint8_t oc = BenchRand();
+    uint8_t intf = BenchRand() % mBenchInterfaces_c;
+    uint32_t i;
+
+    for( i = 0; i < len; i++ )
+    {
+        if( (mBenchEscaped_c == kind) || ((mBenchMixed_c == kind) && (0 == BenchRand() % 4)) )
+        {
+            payload[i] = specials[BenchRand() % sizeof(specials)];
+        }
+        else
+        {
+            payload[i] = BenchRand();
+        }
+    }
+
+    FSCI_transmitPayload(og, oc, payload, len, intf);
+
+    if( expected )
+    {
+        BenchLog(&mExpected, BenchHash(og, oc, payload, len), len, intf);
+    }
+}
+
+/* Appends random bytes to the stream */
+static void BenchAddNoise(uint32_t count)
+{
+    while( count-- && (mStreamLen < mBenchStreamSize_c) )
+    {
+        mStream[mStreamLen++] = BenchRand();
+    }
+}
+
+/* Flips, drops or inserts a byte of the stream, after the offset given */
+static void BenchMutate(uint32_t offset)
+{
+    uint32_t pos;
+
+    if( mStreamLen <= offset + 1 )
+    {
+        return;
+    }
+
+    pos = offset + BenchRand() % (mStreamLen - offset);
+    switch( BenchRand() % 3 )
+    {
+    case 0:
+        mStream[pos] ^= 1 << (BenchRand() % 8);
+        break;
+    case 1:
+        memmove(&mStream[pos], &mStream[pos + 1], mStreamLen - pos - 1);
+        mStreamLen--;
+        break;
+    default:
+        if( mStreamLen < mBenchStreamSize_c )
+        {
+            memmove(&mStream[pos + 1], &mStream[pos], mStreamLen - pos);
+            mStream[pos] = BenchRand();
+            mStreamLen++;
+        }
+        break;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Feeds the stream to FSCI_receivePacket(), in random amounts of at most
+*         arrivalMax bytes per call (0 feeds the whole stream at once).
+********************************************************************************** */
+static void BenchFeed(uint32_t arrivalMax)
+{
+    while( mStreamPos < mStreamLen )
+    {
+        mArrived += arrivalMax ? 1 + BenchRand() % arrivalMax : mStreamLen;
+        if( mArrived > mStreamLen )
+        {
+            mArrived = mStreamLen;
+        }
+        FSCI_receivePacket((void*)0);
+    }
+}
+
+/* Feeds the stream to the reference decoder, one Serial_Read() per byte */
+static void BenchFeedReference(void)
+{
+    uint16_t readBytes;
+    uint8_t c;
+
+    mStreamPos = 0;
+    mArrived = mStreamLen;
+    while( (gSerial_Success_c == Serial_GetByteFromRxBuffer(0, &c, &readBytes)) && readBytes )
+    {
+        RefReceiveByte(c);
+    }
+}
+
+/* Expires the Rx timeout, running while a packet is received: the packet is dropped */
+static void BenchRxTimeout(void)
+{
+#if gFsciRxTimeout_c
+    if( mFsciCommData[0].rxOngoing )
+    {
+        mFsciCommData[0].rxTmrExpired = TRUE;
+        FSCI_receivePacket((void*)0);
+    }
+#else
+    BenchReset();
+#endif
+}
+
+static uint16_t BenchRandLen(uint16_t max)
+{
+    /* short frames are the most frequent */
+    return (BenchRand() % 2) ? BenchRand() % 32 : BenchRand() % (max + 1);
+}
+
+/*! *********************************************************************************
+* \brief  Clean streams: every frame must be received.
+********************************************************************************** */
+static void BenchClean(uint32_t iterations)
+{
+    uint32_t it, frames, failed = 0;
+
+    for( it = 0; it < iterations; it++ )
+    {
+        BenchReset();
+        frames = 1 + BenchRand() % 16;
+        while( frames-- )
+        {
+            BenchAddFrame((benchPayload_t)(BenchRand() % 3), BenchRandLen(gFsciMaxPayloadLen_c), TRUE);
+        }
+        /* the largest frame */
+        BenchAddFrame(mBenchMixed_c, gFsciMaxPayloadLen_c, TRUE);
+
+        BenchFeed((it % 4) ? mBenchArrivalMax_c : 0);
+
+        if( !BenchLogsEqual(&mExpected, &mReceived) || mCriticalSection || mBuffers )
+        {
+            if( 0 == failed++ )
+            {
+                printf("FAIL: clean stream %u: %u frames sent, %u received\n",
+                       it, mExpected.count, mReceived.count);
+            }
+        }
+    }
+
+    printf("clean: %u streams, %u failed\n", iterations, failed);
+    mFailures += failed;
+}
+
+/*! *********************************************************************************
+* \brief  Corrupted streams: the decoder must recover after an Rx timeout.
+********************************************************************************** */
+static void BenchCorrupt(uint32_t iterations)
+{
+    uint32_t it, frames, mutations, failed = 0, received = 0;
+
+    for( it = 0; it < iterations; it++ )
+    {
+        BenchReset();
+        mAllocFailRate = 16;
+        frames = 1 + BenchRand() % 8;
+        while( frames-- )
+        {
+            BenchAddFrame((benchPayload_t)(BenchRand() % 3), BenchRandLen(gFsciMaxPayloadLen_c), FALSE);
+            if( 0 == BenchRand() % 4 )
+            {
+                BenchAddNoise(BenchRand() % 64);
+            }
+        }
+        mutations = 1 + BenchRand() % 8;
+        while( mutations-- )
+        {
+            BenchMutate(0);
+        }
+
+        BenchFeed(mBenchArrivalMax_c);
+        BenchRxTimeout();
+        received += mReceived.count;
+        mAllocFailRate = 0;
+
+        if( mCriticalSection || mBuffers )
+        {
+            if( 0 == failed++ )
+            {
+                printf("FAIL: corrupt stream %u: critical section %d, %d buffers left\n",
+                       it, mCriticalSection, mBuffers);
+            }
+            continue;
+        }
+
+        /* The decoder is in sync again */
+        mReceived.count = 0;
+        BenchAddFrame(mBenchMixed_c, BenchRandLen(gFsciMaxPayloadLen_c), TRUE);
+        BenchAddFrame(mBenchRandom_c, BenchRandLen(gFsciMaxPayloadLen_c), TRUE);
+        BenchFeed(mBenchArrivalMax_c);
+
+        if( !BenchLogsEqual(&mExpected, &mReceived) || mCriticalSection || mBuffers )
+        {
+            if( 0 == failed++ )
+            {
+                printf("FAIL: corrupt stream %u: no recovery, %u frames received\n",
+                       it, mReceived.count);
+            }
+        }
+    }
+
+    printf("corrupt: %u streams, %u packets received, %u failed\n",
+           iterations, received, failed);
+    mFailures += failed;
+}
+
+/*! *********************************************************************************
+* \brief  Random streams, compared with the reference decoder.
+********************************************************************************** */
+static void BenchDifferential(uint32_t iterations)
+{
+#if gFsciUseEscapeSeq_c
+    (void)iterations;
+    printf("differential: skipped, the reference decoder does not unescape in place\n");
+#else
+    uint32_t it, items, failed = 0, packets = 0;
+
+    for( it = 0; it < iterations; it++ )
+    {
+        BenchReset();
+        items = 1 + BenchRand() % 16;
+        while( items-- )
+        {
+            if( BenchRand() % 4 )
+            {
+                /* the reference decoder drops the frames of gFsciMaxPayloadLen_c bytes */
+                BenchAddFrame((benchPayload_t)(BenchRand() % 3), BenchRandLen(gFsciMaxPayloadLen_c - 1), FALSE);
+            }
+            else
+            {
+                BenchAddNoise(BenchRand() % 16);
+            }
+            if( 0 == BenchRand() % 4 )
+            {
+                BenchMutate(mStreamLen - mStreamLen / 4);
+            }
+        }
+
+        BenchFeedReference();
+        mStreamPos = 0;
+        mArrived = 0;
+        BenchFeed(mBenchArrivalMax_c);
+        packets += mReceived.count;
+
+        if( !BenchLogsEqual(&mRefReceived, &mReceived) )
+        {
+            if( 0 == failed++ )
+            {
+                printf("FAIL: differential stream %u: %u packets received, %u by the reference\n",
+                       it, mReceived.count, mRefReceived.count);
+            }
+        }
+    }
+
+    printf("differential: %u streams, %u packets, %u failed\n", iterations, packets, failed);
+    mFailures += failed;
+#endif
+}
+
+/*! *********************************************************************************
+* \brief  Throughput of both decoders, in MB/s of wire bytes.
+********************************************************************************** */
+static void BenchThroughput(benchPayload_t kind, uint16_t len)
+{
+    double t, tNew, tRef;
+    uint32_t fedNew = 0, fedRef = 0, reads;
+
+    BenchReset();
+    while( (mExpected.count < mBenchLogSize_c) && (mStreamLen + 2 * (len + 8) < mBenchStreamSize_c) )
+    {
+        BenchAddFrame(kind, len, TRUE);
+    }
+
+    mSerialReads = 0;
+    t = BenchNow();
+    do
+    {
+        mStreamPos = 0;
+        mArrived = 0;
+        mReceived.count = 0;
+        BenchFeed(mBenchArrivalMax_c);
+        fedNew += mStreamLen;
+    } while( fedNew < mBenchThroughputBytes_c );
+    tNew = BenchNow() - t;
+    reads = mSerialReads;
+
+    t = BenchNow();
+    do
+    {
+        mRefReceived.count = 0;
+        BenchFeedReference();
+        fedRef += mStreamLen;
+    } while( fedRef < mBenchThroughputBytes_c / 8 );
+    tRef = BenchNow() - t;
+
+    printf("  %-8s %4u bytes: %5u bytes on the wire, %6.1f MB/s (%4.1f bytes per read), "
+           "reference %6.1f MB/s (%u of %u frames received)\n",
+           (mBenchRandom_c == kind) ? "typical" : "worst", len, mStreamLen / mExpected.count,
+           fedNew / tNew / 1e6, (double)fedNew / reads, fedRef / tRef / 1e6,
+           mRefReceived.count, mExpected.count);
+
+    if( !BenchLogsEqual(&mExpected, &mReceived) )
+    {
+        printf("FAIL: throughput stream: %u frames sent, %u received\n",
+               mExpected.count, mReceived.count);
+        mFailures++;
+    }
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    static const uint16_t sizes[] = {16, 64, 245, 1300};
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : mBenchDefaultIter_c;
+    uint32_t i;
+
+    mRandState = (argc > 2) ? strtoul(argv[2], NULL, 0) | 1 : 1;
+
+    for( i = 0; i < gFsciMaxInterfaces_c; i++ )
+    {
+        gFsciSerialInterfaces[i] = 0;
+#if gFsciMaxVirtualInterfaces_c
+        gFsciVirtualInterfaces[i] = i;
+#endif
+    }
+
+    printf("FSCI Rx: max payload %u bytes, %u byte length, escape sequences %s, "
+           "%u virtual interfaces, %u byte chunks\n",
+           gFsciMaxPayloadLen_c, (uint32_t)sizeof(fsciLen_t),
+           gFsciUseEscapeSeq_c ? "on" : "off", gFsciMaxVirtualInterfaces_c, mFsciRxChunkSize_c);
+
+    BenchClean(iterations);
+    BenchCorrupt(iterations);
+    BenchDifferential(iterations);
+
+    printf("throughput:\n");
+    for( i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++ )
+    {
+        if( sizes[i] <= gFsciMaxPayloadLen_c )
+        {
+            BenchThroughput(mBenchRandom_c, sizes[i]);
+            BenchThroughput(mBenchEscaped_c, sizes[i]);
+        }
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
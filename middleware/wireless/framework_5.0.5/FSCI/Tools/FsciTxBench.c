@@ -0,0 +1,534 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file FsciTxBench.c
+* Host test and benchmark of the FSCI transmit path.
+*
+* FSCICommunication.c and SerialManager.c are built together, for one custom
+* serial interface. The custom driver appends the bytes it is asked to send to
+* the "wire" and reports the end of the transfer at once, or when the bench
+* completes it (the Tx ISR). The buffer allocations and the FLib_MemCpy() bytes
+* are counted.
+*
+* A THCI response is sent the way THCI does it: the reply is built in a buffer
+* allocated by the caller, and then either
+*   5.0.5 copy - FSCI_transmitPayload() and MEM_BufferFree() of the reply: the FSCI
+*                allocates a buffer and copies the header, the payload and the
+*                checksum in it (a blocking Tx of FSCI 5.0.5 did the same)
+*   buffer     - FSCI_transmitPayloadBuffer(): the header, the reply buffer and the
+*                checksum are sent as the segments of one Serial_AsyncWriteV()
+*                message and the reply buffer is freed once sent
+*   in place   - FSCI_transmitPayload() on a blocking Tx: the segments are sent by
+*                Serial_SyncWriteV(), from the stack and the reply buffer
+*
+* check: random replies, sent one at a time and up to the Tx queue size at once;
+*   the wire must hold the expected frames, in order, and every buffer and Tx
+*   frame must be free once the Tx queue is drained.
+* bench: for several reply sizes, the allocations, allocated bytes and copied
+*   bytes per response, on top of the reply buffer, and the driver transfers and
+*   host time per response.
+*
+* Build (on case sensitive file systems, link FsciCommunication.h and
+* FsciCommands.h to ../Source/FSCICommunication.h and ../Source/FSCICommands.h
+* in a directory of the include path first):
+*   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast -I. -I../Source
+*       -I../Interface -I../../Common -I../../FunctionLib -I../../SerialManager/Interface
+*       -I../../SerialManager/Source -I../../GPIO -I../../TimersManager/Interface
+*       -I../../OSAbstraction/Interface -I../../MemManager/Interface
+*       -I../../Panic/Interface -I../../NVM/Interface -I../../Messaging/Interface
+*       -I../../Lists -I../../../../../devices/MKW24D5
+*       -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../boards/frdmkw24/wireless_examples/thread/end_device/freertos
+*       -o FsciTxBench FsciTxBench.c ../../FunctionLib/FunctionLib.c
+*   add -DgFsciUseEscapeSeq_c=1 for escape sequences (the payload is then always
+*   encoded in an allocated buffer; the encoding is not counted as copied bytes)
+* Usage: FsciTxBench [check iterations [seed]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#define gSerialManagerMaxInterfaces_c   1
+#define gSerialMgrUseUart_c             0
+#define gSerialMgrUseCustomInterface_c  1
+#define USE_RTOS                        0
+
+#ifndef gFsciIncluded_c
+#define gFsciIncluded_c                 1
+#endif
+#ifndef gFsciLenHas2Bytes_c
+#define gFsciLenHas2Bytes_c             1
+#endif
+#ifndef gFsciMaxPayloadLen_c
+#define gFsciMaxPayloadLen_c            1300
+#endif
+#ifndef gNvStorageIncluded_d
+#define gNvStorageIncluded_d            0
+#endif
+#ifndef gTMR_Enabled_d
+#define gTMR_Enabled_d                  0
+#endif
+
+/* Skip the device and board headers */
+#define __FSL_DEVICE_REGISTERS_H__
+#define _FSL_COMMON_H_
+#define _PIN_MUX_H_
+#define __FSL_GPIO_PINS_H__
+#define __GPIO_IRQ_ADAPTER_H__
+
+#define __DMB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+static void* BenchAlloc(uint32_t numBytes);
+static void BenchMemCpy(void *pDst, void *pSrc, uint32_t cBytes);
+#define MEM_BufferAlloc(numBytes)       BenchAlloc(numBytes)
+#define FLib_MemCpy(pDst, pSrc, cBytes) BenchMemCpy(pDst, pSrc, cBytes)
+
+#include "../../SerialManager/Source/SerialManager.c"
+#include "../Source/FSCICommunication.c"
+
+#if gFsciRxAck_c || gFsciTxAck_c || gFsciHostSupport_c || gFsciMaxVirtualInterfaces_c
+#error "*** ERROR: the FSCI acknowledgements, host support and virtual interfaces are not simulated"
+#endif
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultIter_c         (20000)
+#define mBenchWireSize_c            (64 * 1024)
+#define mBenchResponses_c           (20000)
+#define mBenchOG_c                  (0xCF)  /* THCI confirm operation group */
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef enum
+{
+    mBenchCopy_c,
+    mBenchBuffer_c,
+    mBenchInPlace_c
+} benchMode_t;
+
+/* The counters of a run */
+typedef struct benchCounters_tag
+{
+    uint64_t allocs;
+    uint64_t allocBytes;
+    uint64_t copyBytes;
+    uint64_t transfers;
+} benchCounters_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static const char *mModeNames[] = {"5.0.5 copy", "buffer", "in place"};
+
+static uint8_t  mInterfaceId;
+static benchCounters_t mCounters;
+static int32_t  mBuffers;
+static uint32_t mFailures;
+static uint32_t mRandState = 1;
+
+/* The wire and the expected frames */
+static uint8_t  mWire[mBenchWireSize_c];
+static uint32_t mWireLen;
+static uint8_t  mExpected[mBenchWireSize_c];
+static uint32_t mExpectedLen;
+
+/* The driver transfer in progress, ended by BenchTxIsr() when deferred */
+static bool_t   mDeferTxEnd;
+static bool_t   mTxPending;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+const uint8_t gUseRtos_c = 0;
+
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+osaEventId_t OSA_EventCreate(bool_t autoClear)
+{
+    (void)autoClear;
+    return (osaEventId_t)1;
+}
+
+osaStatus_t OSA_EventSet(osaEventId_t eventId, osaEventFlags_t flagsToSet)
+{
+    (void)eventId; (void)flagsToSet;
+    return osaStatus_Success;
+}
+
+osaStatus_t OSA_EventWait(osaEventId_t eventId, osaEventFlags_t flagsToWait, bool_t waitAll,
+                          uint32_t millisec, osaEventFlags_t *pSetFlags)
+{
+    (void)eventId; (void)flagsToWait; (void)waitAll; (void)millisec;
+    *pSetFlags = 0;
+    return osaStatus_Timeout;
+}
+
+osaTaskId_t OSA_TaskCreate(osaThreadDef_t *thread_def, osaTaskParam_t task_param)
+{
+    (void)thread_def; (void)task_param;
+    return NULL;
+}
+
+osaTaskId_t OSA_TaskGetId(void)
+{
+    return NULL;
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    (void)id; (void)location; (void)extra1; (void)extra2;
+    printf("FAIL: panic\n");
+    exit(1);
+}
+
+gFsciStatus_t FSCI_ProcessRxPkt(clientPacket_t* pPacket, uint32_t fsciInterface)
+{
+    (void)fsciInterface;
+    MEM_BufferFree(pPacket);
+    return gFsciSuccess_c;
+}
+
+/* The custom driver: the bytes are sent to the wire */
+uint32_t Serial_CustomSendData(uint8_t *pData, uint32_t size)
+{
+    if( mWireLen + size <= mBenchWireSize_c )
+    {
+        memcpy(&mWire[mWireLen], pData, size);
+        mWireLen += size;
+    }
+    mCounters.transfers++;
+
+    if( mDeferTxEnd )
+    {
+        mTxPending = TRUE;
+    }
+    else
+    {
+        Serial_CustomSendCompleted(mInterfaceId);
+    }
+    return 0;
+}
+
+/*! *********************************************************************************
+* \brief  Buffers counted when allocated, and their size kept for the free check.
+********************************************************************************** */
+static void* BenchAlloc(uint32_t numBytes)
+{
+    uint8_t *pBuf = malloc(numBytes + sizeof(uint32_t));
+
+    *(uint32_t*)pBuf = numBytes;
+    mCounters.allocs++;
+    mCounters.allocBytes += numBytes;
+    mBuffers++;
+    return pBuf + sizeof(uint32_t);
+}
+
+memStatus_t MEM_BufferFree(void* buffer)
+{
+    mBuffers--;
+    free((uint8_t*)buffer - sizeof(uint32_t));
+    return MEM_SUCCESS_c;
+}
+
+static void BenchMemCpy(void *pDst, void *pSrc, uint32_t cBytes)
+{
+    memcpy(pDst, pSrc, cBytes);
+    mCounters.copyBytes += cBytes;
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+
+/*! *********************************************************************************
+* \brief  Returns a pseudo random number (xorshift32).
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 17;
+    mRandState ^= mRandState << 5;
+    return mRandState;
+}
+
+static double BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*! *********************************************************************************
+* \brief  Appends the expected frame of a reply, built the 5.0.5 way.
+********************************************************************************** */
+static void BenchExpect(uint8_t oc, const uint8_t *pReply, uint16_t len)
+{
+    clientPacketHdr_t header;
+    uint8_t frame[sizeof(clientPacketHdr_t) + gFsciMaxPayloadLen_c + 1];
+    uint32_t size = 0;
+    uint8_t checksum;
+
+    header.startMarker = gFSCI_StartMarker_c;
+    header.opGroup = mBenchOG_c;
+    header.opCode = oc;
+    header.len = len;
+    memcpy(frame, &header, sizeof(header));
+    memcpy(&frame[sizeof(header)], pReply, len);
+    checksum = FSCI_computeChecksum(&frame[1], sizeof(header) - 1 + len);
+
+#if gFsciUseEscapeSeq_c
+    mExpected[mExpectedLen + size++] = gFSCI_StartMarker_c;
+    size += FSCI_encodeEscapeSeq(&frame[1], sizeof(header) - 1 + len, &mExpected[mExpectedLen + size]);
+    size += FSCI_encodeEscapeSeq(&checksum, sizeof(checksum), &mExpected[mExpectedLen + size]);
+    mExpected[mExpectedLen + size++] = gFSCI_EndMarker_c;
+#else
+    memcpy(&mExpected[mExpectedLen], frame, sizeof(header) + len);
+    size = sizeof(header) + len;
+    mExpected[mExpectedLen + size++] = checksum;
+#endif
+    mExpectedLen += size;
+}
+
+/*! *********************************************************************************
+* \brief  Sends a THCI response of len bytes, the way the mode does it.
+********************************************************************************** */
+static void BenchRespond(benchMode_t mode, uint8_t oc, uint16_t len, bool_t check)
+{
+    uint8_t *pReply = MEM_BufferAlloc(len ? len : 1);
+    uint32_t i;
+
+    for( i = 0; i < len; i++ )
+    {
+        pReply[i] = (uint8_t)BenchRand();
+    }
+
+    if( check )
+    {
+        BenchExpect(oc, pReply, len);
+    }
+
+    gFsciTxBlocking = (mBenchInPlace_c == mode);
+    if( mBenchBuffer_c == mode )
+    {
+        FSCI_transmitPayloadBuffer(mBenchOG_c, oc, pReply, len, 0);
+    }
+    else
+    {
+        FSCI_transmitPayload(mBenchOG_c, oc, pReply, len, 0);
+        MEM_BufferFree(pReply);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Ends the driver transfers until the Tx queue is empty, and runs the Tx
+*         callbacks.
+********************************************************************************** */
+static void BenchTxIsr(void)
+{
+    while( mTxPending )
+    {
+        mTxPending = FALSE;
+        Serial_CustomSendCompleted(mInterfaceId);
+    }
+    Serial_TxQueueMaintenance(&mSerials[mInterfaceId]);
+}
+
+static void BenchCheckIdle(const char *pName)
+{
+    uint32_t i;
+
+    if( mBuffers )
+    {
+        printf("FAIL: %s: %d buffers left\n", pName, mBuffers);
+        mFailures++;
+        mBuffers = 0;
+    }
+
+    for( i = 0; i < mFsciTxFramesCount_c; i++ )
+    {
+#if !gFsciUseEscapeSeq_c
+        if( mFsciTxFrames[i].inUse )
+        {
+            printf("FAIL: %s: Tx frame %u in use\n", pName, i);
+            mFailures++;
+            mFsciTxFrames[i].inUse = FALSE;
+        }
+#endif
+    }
+
+    if( mSerials[mInterfaceId].txNo || mSerials[mInterfaceId].state )
+    {
+        printf("FAIL: %s: Tx queue not empty\n", pName);
+        mFailures++;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Random replies in random modes, up to the Tx queue size in flight.
+********************************************************************************** */
+static void BenchCheck(uint32_t iterations)
+{
+    uint32_t i, inFlight, n;
+    benchMode_t mode;
+    uint16_t len;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        mWireLen = 0;
+        mExpectedLen = 0;
+        mode = (benchMode_t)(BenchRand() % 3);
+        inFlight = (mBenchInPlace_c == mode) ? 1 : 1 + BenchRand() % gSerialMgrTxQueueSize_c;
+        mDeferTxEnd = (mBenchInPlace_c != mode);
+
+        for( n = 0; n < inFlight; n++ )
+        {
+            len = (BenchRand() & 1) ? BenchRand() % 64 : BenchRand() % (gFsciMaxPayloadLen_c + 1);
+            BenchRespond(mode, (uint8_t)i, len, TRUE);
+        }
+        BenchTxIsr();
+
+        if( (mWireLen != mExpectedLen) || memcmp(mWire, mExpected, mWireLen) )
+        {
+            printf("FAIL: check %u (%s, %u in flight): %u bytes on the wire, %u expected\n",
+                   i, mModeNames[mode], inFlight, mWireLen, mExpectedLen);
+            mFailures++;
+        }
+        BenchCheckIdle("check");
+    }
+}
+
+/*! *********************************************************************************
+* \brief  The cost of a response, on top of the reply buffer.
+********************************************************************************** */
+static void BenchResponses(benchMode_t mode, uint16_t len)
+{
+    double t;
+    uint32_t i;
+
+    mDeferTxEnd = (mBenchInPlace_c != mode);
+    memset(&mCounters, 0, sizeof(mCounters));
+    t = BenchNow();
+    for( i = 0; i < mBenchResponses_c; i++ )
+    {
+        mWireLen = 0;
+        BenchRespond(mode, 0, len, FALSE);
+        BenchTxIsr();
+    }
+    t = BenchNow() - t;
+    BenchCheckIdle(mModeNames[mode]);
+
+    /* The reply buffer is the caller's */
+    mCounters.allocs -= mBenchResponses_c;
+    mCounters.allocBytes -= (uint64_t)mBenchResponses_c * (len ? len : 1);
+
+    printf("  %-10s %4u bytes: %4.2f allocations (%5u bytes), %5u bytes copied, "
+           "%4.2f transfers, %6.1f ns per response\n",
+           mModeNames[mode], len,
+           (double)mCounters.allocs / mBenchResponses_c,
+           (uint32_t)(mCounters.allocBytes / mBenchResponses_c),
+           (uint32_t)(mCounters.copyBytes / mBenchResponses_c),
+           (double)mCounters.transfers / mBenchResponses_c,
+           t * 1e9 / mBenchResponses_c);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    static const uint16_t sizes[] = {1, 16, 64, 245, 1300};
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : mBenchDefaultIter_c;
+    uint32_t i;
+
+    mRandState = (argc > 2) ? strtoul(argv[2], NULL, 0) | 1 : 1;
+
+    if( gSerial_Success_c != Serial_InitInterface(&mInterfaceId, gSerialMgrCustom_c, 0) )
+    {
+        printf("FAIL: Serial_InitInterface\n");
+        return 1;
+    }
+    gFsciSerialInterfaces[0] = mInterfaceId;
+
+    printf("FSCI Tx: max payload %u bytes, %u byte length, escape sequences %s, "
+           "%u Tx frames, Tx queue of %u\n",
+           gFsciMaxPayloadLen_c, (uint32_t)sizeof(fsciLen_t),
+           gFsciUseEscapeSeq_c ? "on" : "off", mFsciTxFramesCount_c, gSerialMgrTxQueueSize_c);
+
+    BenchCheck(iterations);
+
+    printf("per THCI response:\n");
+    for( i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++ )
+    {
+        if( sizes[i] <= gFsciMaxPayloadLen_c )
+        {
+            BenchResponses(mBenchCopy_c, sizes[i]);
+            BenchResponses(mBenchBuffer_c, sizes[i]);
+            BenchResponses(mBenchInPlace_c, sizes[i]);
+        }
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
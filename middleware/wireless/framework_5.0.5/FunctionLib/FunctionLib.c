@@ -41,17 +41,34 @@
 #include "MemManager.h"
 #endif
 
+#if gFLib_UseDmaMemCpy_d
+#include "fsl_edma.h"
+#include "fsl_os_abstraction.h"
+#endif
+
 /*! *********************************************************************************
 *************************************************************************************
 * Private macros
 *************************************************************************************
 ********************************************************************************** */
 
+/* Buffers shorter than this are processed byte by byte */
+#define mFLibWordThreshold_c (8)
+
+/* Replicate a byte on all the bytes of a word */
+#define mFLibByteToWord(b) ((uint32_t)(b) * 0x01010101UL)
+
 /*! *********************************************************************************
 *************************************************************************************
 * Private prototypes
 *************************************************************************************
 ********************************************************************************** */
+#if !gUseToolchainMemFunc_d
+static void FLib_MemCpyForward (uint8_t* pDst, const uint8_t* pSrc, uint32_t cBytes);
+#endif
+#if gFLib_UseDmaMemCpy_d
+static bool_t FLib_MemCpyDma (uint32_t* pDst, const uint32_t* pSrc, uint32_t cBytes);
+#endif
 
 /*! *********************************************************************************
 *************************************************************************************
@@ -70,6 +87,10 @@
 * Private memory declarations
 *************************************************************************************
 ********************************************************************************** */
+#if gFLib_UseDmaMemCpy_d
+static bool_t mFLibDmaInitialized;
+static volatile bool_t mFLibDmaBusy;
+#endif
 
 /*! *********************************************************************************
 *************************************************************************************
@@ -103,13 +124,24 @@ void FLib_MemCpy (void* pDst,
 #if gUseToolchainMemFunc_d
     memcpy(pDst, pSrc, cBytes);
 #else
-    while (cBytes)
+#if gFLib_UseDmaMemCpy_d
+    uint32_t head, body;
+
+    /* Source and destination must have the same word alignment */
+    if( (cBytes >= gFLib_DmaMemCpyThreshold_c) && (0 == (((uintptr_t)pDst ^ (uintptr_t)pSrc) & 3)) )
     {
-        *((uint8_t*)pDst) = *((uint8_t*)pSrc);
-        pDst = ((uint8_t*)pDst)+1;
-        pSrc = ((uint8_t*)pSrc)+1;
-        cBytes--;
+        head = (uint32_t)((4 - ((uintptr_t)pDst & 3)) & 3);
+        body = (cBytes - head) & ~3UL;
+
+        if( FLib_MemCpyDma((uint32_t*)((uint8_t*)pDst + head), (uint32_t*)((uint8_t*)pSrc + head), body) )
+        {
+            FLib_MemCpyForward((uint8_t*)pDst, (uint8_t*)pSrc, head);
+            FLib_MemCpyForward((uint8_t*)pDst + head + body, (uint8_t*)pSrc + head + body, cBytes - head - body);
+            return;
+        }
     }
+#endif
+    FLib_MemCpyForward((uint8_t*)pDst, (uint8_t*)pSrc, cBytes);
 #endif
 }
 
@@ -151,7 +183,7 @@ void FLib_MemCpyAligned32bit (void* to_ptr,
     if (number_of_bytes > 3)
     {
         /* Try to align source on word */
-        if ((uint32_t)from_ptr & 1)
+        if ((uintptr_t)from_ptr & 1)
         {
             from8_ptr = (uint8_t*)from_ptr;
             to8_ptr = (uint8_t*)to_ptr;
@@ -164,7 +196,7 @@ void FLib_MemCpyAligned32bit (void* to_ptr,
         }
 
         /* Try to align source on longword */
-        if ((uint32_t)from_ptr & 2)
+        if ((uintptr_t)from_ptr & 2)
         {
             from16_ptr = (uint16_t*)from_ptr;
             to16_ptr = (uint16_t*)to_ptr;
@@ -306,16 +338,67 @@ bool_t FLib_MemCmp (void* pData1,    /* IN: First memory block to compare */
         status = FALSE;
     }
 #else
+    uint8_t *p1 = (uint8_t*)pData1;
+    uint8_t *p2 = (uint8_t*)pData2;
+    uint32_t *p1w;
+    uint32_t *p2w;
+    uint32_t w0, w1, shift;
+
+    if( cBytes >= mFLibWordThreshold_c )
+    {
+        /* Align the first buffer on a word boundary */
+        while( (uintptr_t)p1 & 3 )
+        {
+            if( *p1++ != *p2++ )
+            {
+                return FALSE;
+            }
+            cBytes--;
+        }
+
+        p1w = (uint32_t*)p1;
+        shift = (uint32_t)((uintptr_t)p2 & 3) << 3;
+
+        if( 0 == shift )
+        {
+            p2w = (uint32_t*)p2;
+            while( cBytes >= 4 )
+            {
+                if( *p1w++ != *p2w++ )
+                {
+                    return FALSE;
+                }
+                cBytes -= 4;
+            }
+        }
+        else
+        {
+            /* Build the words of the second buffer from two aligned reads (little endian) */
+            p2w = (uint32_t*)(p2 - (shift >> 3));
+            w0 = *p2w++;
+            while( cBytes >= 8 )
+            {
+                w1 = *p2w++;
+                if( *p1w++ != ((w0 >> shift) | (w1 << (32 - shift))) )
+                {
+                    return FALSE;
+                }
+                w0 = w1;
+                cBytes -= 4;
+            }
+        }
+
+        p2 += (uint8_t*)p1w - p1;
+        p1 = (uint8_t*)p1w;
+    }
+
     while (cBytes)
     {
-        if ( *((uint8_t *)pData1) != *((uint8_t *)pData2))
+        if ( *p1++ != *p2++ )
         {
             status = FALSE;
             break;
         }
-
-        pData2 = (uint8_t* )pData2+1;
-        pData1 = (uint8_t* )pData1+1;
         cBytes--;
     }
 #endif
@@ -347,9 +430,44 @@ void FLib_MemSet (void* pData,
 #if gUseToolchainMemFunc_d
     memset(pData, value, cBytes);
 #else
+    uint8_t *pDst = (uint8_t*)pData;
+    uint32_t *pDstW;
+    uint32_t value32;
+
+    if( cBytes >= mFLibWordThreshold_c )
+    {
+        while( (uintptr_t)pDst & 3 )
+        {
+            *pDst++ = value;
+            cBytes--;
+        }
+
+        pDstW = (uint32_t*)pDst;
+        value32 = mFLibByteToWord(value);
+
+        /* 4 words per iteration, so that the compiler can use STM bursts */
+        while( cBytes >= 16 )
+        {
+            pDstW[0] = value32;
+            pDstW[1] = value32;
+            pDstW[2] = value32;
+            pDstW[3] = value32;
+            pDstW += 4;
+            cBytes -= 16;
+        }
+
+        while( cBytes >= 4 )
+        {
+            *pDstW++ = value32;
+            cBytes -= 4;
+        }
+
+        pDst = (uint8_t*)pDstW;
+    }
+
     while (cBytes)
     {
-        ((uint8_t* )pData)[--cBytes] = value;
+        pDst[--cBytes] = value;
     }
 #endif
 }
@@ -386,13 +504,7 @@ void FLib_MemInPlaceCpy (void* pDst,
 #if gUseToolchainMemFunc_d
             memcpy(pDst, pSrc, cBytes);
 #else
-            while (cBytes)
-            {
-                *((uint8_t*)pDst) = *((uint8_t*)pSrc);
-                pDst = ((uint8_t*)pDst)+1;
-                pSrc = ((uint8_t*)pSrc)+1;
-                cBytes--;
-            }
+            FLib_MemCpyForward((uint8_t*)pDst, (uint8_t*)pSrc, cBytes);
 #endif
         }
         else
@@ -518,3 +630,162 @@ uint32_t FLib_StrLen(char *str)
     return len;
 #endif
 }
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+
+#if !gUseToolchainMemFunc_d
+/*! *********************************************************************************
+* \brief  Copy bytes in ascending address order, one word at a time when possible.
+*
+* \param[in, out]  pDst Pointer to the destination buffer.
+*
+* \param[in]  pSrc Pointer to the source buffer.
+*
+* \param[in]  cBytes Number of bytes to copy.
+*
+* \remarks The destination may overlap the source if it is located before it.
+*          When the buffers are not equally aligned, the source is read one aligned
+*          word at a time, so up to 3 bytes around the source buffer may be read.
+*
+********************************************************************************** */
+static void FLib_MemCpyForward (uint8_t* pDst,
+                                const uint8_t* pSrc,
+                                uint32_t cBytes)
+{
+    uint32_t *pDstW;
+    const uint32_t *pSrcW;
+    uint32_t w0, w1, w2, w3, shift;
+
+    if( cBytes >= mFLibWordThreshold_c )
+    {
+        /* Align the destination on a word boundary */
+        while( (uintptr_t)pDst & 3 )
+        {
+            *pDst++ = *pSrc++;
+            cBytes--;
+        }
+
+        pDstW = (uint32_t*)pDst;
+        shift = (uint32_t)((uintptr_t)pSrc & 3) << 3;
+
+        if( 0 == shift )
+        {
+            pSrcW = (const uint32_t*)pSrc;
+
+            /* 4 words per iteration, so that the compiler can use LDM/STM bursts */
+            while( cBytes >= 16 )
+            {
+                w0 = pSrcW[0];
+                w1 = pSrcW[1];
+                w2 = pSrcW[2];
+                w3 = pSrcW[3];
+                pDstW[0] = w0;
+                pDstW[1] = w1;
+                pDstW[2] = w2;
+                pDstW[3] = w3;
+                pSrcW += 4;
+                pDstW += 4;
+                cBytes -= 16;
+            }
+
+            while( cBytes >= 4 )
+            {
+                *pDstW++ = *pSrcW++;
+                cBytes -= 4;
+            }
+        }
+        else
+        {
+            /* Build the destination words from two aligned source reads (little endian) */
+            pSrcW = (const uint32_t*)(pSrc - (shift >> 3));
+            w0 = *pSrcW++;
+
+            while( cBytes >= 8 )
+            {
+                w1 = *pSrcW++;
+                *pDstW++ = (w0 >> shift) | (w1 << (32 - shift));
+                w0 = w1;
+                cBytes -= 4;
+            }
+        }
+
+        pSrc += (uint8_t*)pDstW - pDst;
+        pDst = (uint8_t*)pDstW;
+    }
+
+    while (cBytes)
+    {
+        *pDst++ = *pSrc++;
+        cBytes--;
+    }
+}
+#endif
+
+#if gFLib_UseDmaMemCpy_d
+/*! *********************************************************************************
+* \brief  Copy word aligned data using the eDMA. The function waits for the
+*         transfer to complete.
+*
+* \param[in, out]  pDst Pointer to the destination buffer (word aligned).
+*
+* \param[in]  pSrc Pointer to the source buffer (word aligned).
+*
+* \param[in]  cBytes Number of bytes to copy (multiple of 4).
+*
+* \return  TRUE if the data was copied, FALSE if the eDMA channel is in use.
+*
+********************************************************************************** */
+static bool_t FLib_MemCpyDma (uint32_t* pDst,
+                              const uint32_t* pSrc,
+                              uint32_t cBytes)
+{
+    edma_config_t dmaConfig;
+    edma_transfer_config_t transferConfig;
+    bool_t status = FALSE;
+
+    /* The whole copy is done in a single minor loop */
+    if( (0 == cBytes) || (cBytes > 0xFFFF) )
+    {
+        return FALSE;
+    }
+
+    /* The channel may be in use by an interrupted copy */
+    OSA_InterruptDisable();
+    if( !mFLibDmaBusy )
+    {
+        mFLibDmaBusy = TRUE;
+        status = TRUE;
+    }
+    OSA_InterruptEnable();
+
+    if( status )
+    {
+        if( !mFLibDmaInitialized )
+        {
+            mFLibDmaInitialized = TRUE;
+            EDMA_GetDefaultConfig(&dmaConfig);
+            EDMA_Init(DMA0, &dmaConfig);
+            EDMA_ResetChannel(DMA0, gFLib_DmaMemCpyChannel_c);
+        }
+
+        EDMA_PrepareTransfer(&transferConfig, (void*)pSrc, sizeof(uint32_t), pDst, sizeof(uint32_t),
+                             cBytes, cBytes, kEDMA_MemoryToMemory);
+        EDMA_SetTransferConfig(DMA0, gFLib_DmaMemCpyChannel_c, &transferConfig, NULL);
+        EDMA_TriggerChannelStart(DMA0, gFLib_DmaMemCpyChannel_c);
+
+        while( !(EDMA_GetChannelStatusFlags(DMA0, gFLib_DmaMemCpyChannel_c) & kEDMA_DoneFlag) )
+        {
+        }
+
+        EDMA_ClearChannelStatusFlags(DMA0, gFLib_DmaMemCpyChannel_c, kEDMA_DoneFlag);
+        mFLibDmaBusy = FALSE;
+    }
+
+    return status;
+}
+#endif
@@ -50,6 +50,24 @@
 #define gFLib_CheckBufferOverflow_d 0
 #endif
 
+/* Use the eDMA for the word aligned part of large FLib_MemCpy() copies.
+   Requires the eDMA driver (fsl_edma.c) to be part of the project. */
+#ifndef gFLib_UseDmaMemCpy_d
+#define gFLib_UseDmaMemCpy_d 0
+#endif
+
+#if gFLib_UseDmaMemCpy_d
+/* eDMA channel reserved for memory copies */
+#ifndef gFLib_DmaMemCpyChannel_c
+#define gFLib_DmaMemCpyChannel_c 15
+#endif
+
+/* Minimum number of bytes copied through the eDMA */
+#ifndef gFLib_DmaMemCpyThreshold_c
+#define gFLib_DmaMemCpyThreshold_c 256
+#endif
+#endif
+
 #define FLib_MemSet16 FLib_MemSet
 
 /*! *********************************************************************************
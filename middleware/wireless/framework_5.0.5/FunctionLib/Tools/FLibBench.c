@@ -0,0 +1,376 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file FLibBench.c
+* Benchmark of the FunctionLib memory routines (FLib_MemCpy, FLib_MemSet,
+* FLib_MemCmp and FLib_MemInPlaceCpy) built with gUseToolchainMemFunc_d = 0,
+* against the plain byte loops they replace.
+*
+* Every routine is first checked against a reference implementation for all the
+* source/destination alignments, then timed for the frame sizes seen by the stack:
+* 16 to 127 bytes for 802.15.4 frames and up to 1280 bytes for reassembled IPv6
+* packets. Results are reported in bytes per cycle.
+*
+* The cycle counter is the TSC on x86 hosts and the DWT cycle counter on Cortex-M
+* targets (printf must be retargeted). Other hosts use a nanosecond clock and
+* report bytes per ns.
+*
+* Build: gcc -O2 -fno-strict-aliasing -I../../Common -o FLibBench FLibBench.c
+* Usage: FLibBench [iterations]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#undef  gUseToolchainMemFunc_d
+#define gUseToolchainMemFunc_d      0
+#undef  gFLib_CheckBufferOverflow_d
+#define gFLib_CheckBufferOverflow_d 0
+#undef  gFLib_UseDmaMemCpy_d
+#define gFLib_UseDmaMemCpy_d        0
+#include "../FunctionLib.c"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif !defined(__ARM_ARCH_7EM__) && !defined(__ARM_ARCH_7M__)
+#include <time.h>
+#endif
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchBufferSize_c   (1280 + 64)
+#define mBenchDefaultIter_c  (20000)
+
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__)
+#define mDWT_CTRL_c    (*(volatile uint32_t*)0xE0001000)
+#define mDWT_CYCCNT_c  (*(volatile uint32_t*)0xE0001004)
+#define mDEMCR_c       (*(volatile uint32_t*)0xE000EDFC)
+#define mBenchUnit_c   "cycle"
+#elif defined(__x86_64__) || defined(__i386__)
+#define mBenchUnit_c   "cycle"
+#else
+#define mBenchUnit_c   "ns"
+#endif
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef enum
+{
+    mBenchCpy_c,
+    mBenchInPlaceCpy_c,
+    mBenchSet_c,
+    mBenchCmp_c,
+    mBenchOps_c
+}benchOp_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static const uint32_t mBenchSizes[] = {16, 32, 64, 100, 127, 256, 512, 1280};
+static const char * const mBenchOpNames[mBenchOps_c] = {"MemCpy", "MemInPlaceCpy", "MemSet", "MemCmp"};
+
+static uint8_t mBufA[mBenchBufferSize_c] __attribute__((aligned(8)));
+static uint8_t mBufB[mBenchBufferSize_c] __attribute__((aligned(8)));
+static uint8_t mBufRef[mBenchBufferSize_c] __attribute__((aligned(8)));
+
+/* Keeps the compiler from removing the compare loops */
+static volatile uint32_t mBenchSink;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+
+/* The byte loops used before the word-at-a-time implementation */
+static void RefMemCpy(void* pDst, void* pSrc, uint32_t cBytes)
+{
+    while (cBytes)
+    {
+        *((volatile uint8_t*)pDst) = *((uint8_t*)pSrc);
+        pDst = ((uint8_t*)pDst)+1;
+        pSrc = ((uint8_t*)pSrc)+1;
+        cBytes--;
+    }
+}
+
+static void RefMemSet(void* pData, uint8_t value, uint32_t cBytes)
+{
+    while (cBytes)
+    {
+        ((volatile uint8_t* )pData)[--cBytes] = value;
+    }
+}
+
+static bool_t RefMemCmp(void* pData1, void* pData2, uint32_t cBytes)
+{
+    while (cBytes)
+    {
+        if ( *((volatile uint8_t *)pData1) != *((uint8_t *)pData2))
+        {
+            return FALSE;
+        }
+        pData2 = (uint8_t* )pData2+1;
+        pData1 = (uint8_t* )pData1+1;
+        cBytes--;
+    }
+    return TRUE;
+}
+
+static void RefMemInPlaceCpy(void* pDst, void* pSrc, uint32_t cBytes)
+{
+    if (pDst < pSrc)
+    {
+        RefMemCpy(pDst, pSrc, cBytes);
+    }
+    else
+    {
+        while(cBytes)
+        {
+            cBytes--;
+            ((volatile uint8_t* )pDst)[cBytes] = ((uint8_t* )pSrc)[cBytes];
+        }
+    }
+}
+
+static void BenchInit(void)
+{
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__)
+    mDEMCR_c |= (1UL << 24);   /* TRCENA */
+    mDWT_CYCCNT_c = 0;
+    mDWT_CTRL_c |= 1;          /* CYCCNTENA */
+#endif
+}
+
+static uint64_t BenchNow(void)
+{
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__)
+    return mDWT_CYCCNT_c;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static void FillPattern(uint8_t *pBuf, uint32_t len, uint32_t seed)
+{
+    uint32_t i;
+
+    for( i = 0; i < len; i++ )
+    {
+        seed = seed * 1103515245UL + 12345UL;
+        pBuf[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+/* Run one operation, with either the FunctionLib or the reference implementation */
+static void RunOp(benchOp_t op, bool_t ref, uint8_t *pDst, uint8_t *pSrc, uint32_t len)
+{
+    switch( op )
+    {
+    case mBenchCpy_c:
+        ref ? RefMemCpy(pDst, pSrc, len) : FLib_MemCpy(pDst, pSrc, len);
+        break;
+    case mBenchInPlaceCpy_c:
+        ref ? RefMemInPlaceCpy(pDst, pSrc, len) : FLib_MemInPlaceCpy(pDst, pSrc, len);
+        break;
+    case mBenchSet_c:
+        ref ? RefMemSet(pDst, (uint8_t)len, len) : FLib_MemSet(pDst, (uint8_t)len, len);
+        break;
+    default:
+        mBenchSink += ref ? RefMemCmp(pDst, pSrc, len) : FLib_MemCmp(pDst, pSrc, len);
+        break;
+    }
+}
+
+/* Compare the FunctionLib routines against the byte loops */
+static uint32_t CheckAll(void)
+{
+    uint32_t errors = 0;
+    uint32_t len, sa, da, diff;
+    uint8_t *pSrc, *pDst;
+
+    for( len = 0; len <= 300; len++ )
+    {
+        for( sa = 0; sa < 4; sa++ )
+        {
+            for( da = 0; da < 4; da++ )
+            {
+                /* Copy */
+                FillPattern(mBufA, sizeof(mBufA), len + 7 * sa);
+                FillPattern(mBufB, sizeof(mBufB), len + 13 * da);
+                memcpy(mBufRef, mBufB, sizeof(mBufRef));
+                FLib_MemCpy(mBufB + 8 + da, mBufA + 8 + sa, len);
+                memcpy(mBufRef + 8 + da, mBufA + 8 + sa, len);
+                errors += (0 != memcmp(mBufB, mBufRef, sizeof(mBufRef)));
+
+                /* Set */
+                memcpy(mBufRef, mBufB, sizeof(mBufRef));
+                FLib_MemSet(mBufB + 8 + da, (uint8_t)(0xA5 + len), len);
+                memset(mBufRef + 8 + da, (uint8_t)(0xA5 + len), len);
+                errors += (0 != memcmp(mBufB, mBufRef, sizeof(mBufRef)));
+
+                /* Compare: equal, and different at the first, middle and last byte */
+                memcpy(mBufB + 8 + da, mBufA + 8 + sa, len);
+                errors += (TRUE != FLib_MemCmp(mBufB + 8 + da, mBufA + 8 + sa, len));
+                if( len )
+                {
+                    uint32_t pos[3] = {0, len / 2, len - 1};
+                    for( diff = 0; diff < 3; diff++ )
+                    {
+                        mBufB[8 + da + pos[diff]] ^= 0x10;
+                        errors += (FALSE != FLib_MemCmp(mBufB + 8 + da, mBufA + 8 + sa, len));
+                        mBufB[8 + da + pos[diff]] ^= 0x10;
+                    }
+                }
+
+                /* Overlapping copy, in both directions */
+                FillPattern(mBufA, sizeof(mBufA), len);
+                memcpy(mBufRef, mBufA, sizeof(mBufRef));
+                pSrc = mBufA + 16 + sa;
+                pDst = mBufA + 16 + da + (len & 7);
+                FLib_MemInPlaceCpy(pDst, pSrc, len);
+                memmove(mBufRef + (pDst - mBufA), mBufRef + (pSrc - mBufA), len);
+                errors += (0 != memcmp(mBufA, mBufRef, sizeof(mBufRef)));
+
+                memcpy(mBufRef, mBufA, sizeof(mBufRef));
+                FLib_MemInPlaceCpy(pSrc, pDst, len);
+                memmove(mBufRef + (pSrc - mBufA), mBufRef + (pDst - mBufA), len);
+                errors += (0 != memcmp(mBufA, mBufRef, sizeof(mBufRef)));
+            }
+        }
+    }
+
+    return errors;
+}
+
+/* Return the best time of a batch of operations */
+static uint64_t TimeOp(benchOp_t op, bool_t ref, uint8_t *pDst, uint8_t *pSrc, uint32_t len, uint32_t iter)
+{
+    uint64_t best = (uint64_t)-1;
+    uint64_t start, t;
+    uint32_t i, rep;
+
+    for( rep = 0; rep < 5; rep++ )
+    {
+        start = BenchNow();
+        for( i = 0; i < iter; i++ )
+        {
+            RunOp(op, ref, pDst, pSrc, len);
+        }
+        t = BenchNow() - start;
+        if( t < best )
+        {
+            best = t;
+        }
+    }
+
+    return best ? best : 1;
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    uint32_t iter = mBenchDefaultIter_c;
+    uint32_t errors, s, op, align;
+    uint64_t tFLib, tRef;
+    double bytes;
+
+    if( argc > 1 )
+    {
+        iter = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    BenchInit();
+
+    errors = CheckAll();
+    printf("Self check: %s (%u errors)\n\n", errors ? "FAILED" : "passed", errors);
+
+    printf("%-14s %-9s %6s %12s %12s %8s\n", "routine", "alignment", "bytes",
+           "FLib B/" mBenchUnit_c, "byte B/" mBenchUnit_c, "speedup");
+
+    for( op = 0; op < mBenchOps_c; op++ )
+    {
+        for( align = 0; align < 2; align++ )
+        {
+            for( s = 0; s < sizeof(mBenchSizes) / sizeof(mBenchSizes[0]); s++ )
+            {
+                uint32_t len = mBenchSizes[s];
+                uint8_t *pSrc = mBufA + 8 + align;
+                uint8_t *pDst = (op == mBenchInPlaceCpy_c) ? (mBufA + 4) : (mBufB + 8);
+
+                FillPattern(mBufA, sizeof(mBufA), len);
+                memcpy(mBufB, mBufA, sizeof(mBufB));
+                if( op == mBenchCmp_c )
+                {
+                    /* Time the worst case: equal buffers */
+                    memcpy(pDst, pSrc, len);
+                }
+
+                tFLib = TimeOp((benchOp_t)op, FALSE, pDst, pSrc, len, iter);
+                tRef = TimeOp((benchOp_t)op, TRUE, pDst, pSrc, len, iter);
+                bytes = (double)len * iter;
+
+                printf("%-14s %-9s %6u %12.3f %12.3f %7.2fx\n", mBenchOpNames[op],
+                       align ? "src+1" : "aligned", len,
+                       bytes / tFLib, bytes / tRef, (double)tRef / tFLib);
+            }
+        }
+    }
+
+    return errors ? 1 : 0;
+}
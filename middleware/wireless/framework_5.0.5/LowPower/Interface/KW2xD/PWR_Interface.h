@@ -145,6 +145,18 @@ typedef enum{
   PWR_LEVEL_CRITICAL // < 1.6 V
 } PWRLib_LVD_VoltageLevel_t;
 
+/* 
+ * Name: PWR_Statistics_t
+ * Description: Low power statistics. TimerExpirations - TimerWakeups is the
+ *              number of wakeups saved by timer coalescing
+ */
+typedef struct{
+  uint32_t DeepSleepCount;                        // Number of deep sleep entries
+  uint32_t SleepCount;                            // Number of sleep entries
+  uint32_t TimerWakeups;                          // Timer thread runs that handled expired timers
+  uint32_t TimerExpirations;                      // Number of timer expirations
+} PWR_Statistics_t;
+
 /*****************************************************************************
  *                        PUBLIC VARIABLES                            *
  *---------------------------------------------------------------------------*
@@ -329,6 +341,17 @@ void PWR_EnterSleep
 void
 );
 
+/*---------------------------------------------------------------------------
+ * Name: PWR_GetStatistics
+ * Description: - Reads the low power statistics
+ * Parameters: pStatistics - location where the statistics are copied
+ * Return: -
+ *---------------------------------------------------------------------------*/
+void PWR_GetStatistics
+(
+  PWR_Statistics_t *pStatistics
+);
+
 /*---------------------------------------------------------------------------
  * Name: PWR_GetDeepSleepMode
  * Description: - 
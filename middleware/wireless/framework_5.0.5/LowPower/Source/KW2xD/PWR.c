@@ -80,6 +80,8 @@
  *****************************************************************************/
 uint8_t mLPMFlag = gAllowDeviceToSleep_c;
 uint8_t mLpmXcvrDisallowCnt = 0;
+static uint32_t mPWR_DeepSleepCount = 0;
+static uint32_t mPWR_SleepCount = 0;
 
 #if (cPWR_UsePowerDownMode)
 static uint32_t mPWR_DeepSleepTime = cPWR_DeepSleepDurationMs;
@@ -1020,10 +1022,17 @@ PWR_CheckForAndEnterNewPowerState_t NewPowerState
 
   else if(( NewPowerState == PWR_DeepSleep) && PWR_DeepSleepAllowed())
   {
+#if (cPWR_DeepSleepMode != 0)
+    /* Only count the requests that really enter low power */
+    mPWR_DeepSleepCount++;
+#endif
     ReturnValue = PWR_HandleDeepSleep();
   }
   else if(( NewPowerState == PWR_Sleep) && PWR_SleepAllowed())
   {
+#if (cPWR_SleepMode != 0)
+    mPWR_SleepCount++;
+#endif
     ReturnValue = PWR_HandleSleep();
   }
   else
@@ -1156,6 +1165,22 @@ void PWR_EnterSleep(void)
     PWRLib_MCU_Enter_Sleep();
 }
 
+/*---------------------------------------------------------------------------
+ * Name: PWR_GetStatistics
+ * Description: - Reads the low power statistics
+ * Parameters: pStatistics - location where the statistics are copied
+ * Return: -
+ *---------------------------------------------------------------------------*/
+void PWR_GetStatistics(PWR_Statistics_t *pStatistics)
+{
+    OSA_DisableIRQGlobal();
+    pStatistics->DeepSleepCount = mPWR_DeepSleepCount;
+    pStatistics->SleepCount = mPWR_SleepCount;
+    pStatistics->TimerWakeups = TMR_GetWakeupCount();
+    pStatistics->TimerExpirations = TMR_GetExpirationCount();
+    OSA_EnableIRQGlobal();
+}
+
 /*---------------------------------------------------------------------------
  * Name: PWR_GetDeepSleepMode
  * Description: - 
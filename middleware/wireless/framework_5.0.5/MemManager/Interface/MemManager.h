@@ -56,6 +56,66 @@
          _block_size_ 256  _number_of_blocks_    6 _pool_id_(0) _eol_
 #endif
 
+/* Enables the size-class index used by MEM_BufferAllocWithId() to find the first
+   suitable pool without walking the whole pool table. */
+#ifndef gMemUseSizeClassIndex_d
+#define gMemUseSizeClassIndex_d      1
+#endif
+
+/* Granularity of the size-class index (log2 of the class width in bytes) */
+#ifndef gMemSizeClassShift_c
+#define gMemSizeClassShift_c         4
+#endif
+
+/* Largest request size covered directly by the size-class index. Bigger requests
+   start from the last class and continue with the next larger pool. */
+#ifndef gMemSizeClassMaxSize_c
+#define gMemSizeClassMaxSize_c       1312
+#endif
+
+/* Number of pool IDs covered by the size-class index (IDs 0..n-1).
+   Allocations with a higher pool ID use a linear search. */
+#ifndef gMemSizeClassPoolIds_c
+#define gMemSizeClassPoolIds_c       2
+#endif
+
+/* Enables lock-free free lists. Each pool keeps its free blocks in a tagged
+   stack updated with LDREX/STREX (compiler atomics on other targets), so
+   MEM_BufferAllocWithId() and MEM_BufferFree() no longer disable interrupts.
+   The MEM_TRACKING bookkeeping still runs inside a critical section. The block
+   sizes must be multiples of the pointer size, MEM_Init() fails otherwise. */
+#ifndef gMemLockFreePools_d
+#define gMemLockFreePools_d          0
+#endif
+
+/* Maximum number of blocks shared with a sub-buffer at the same time
+   (see MEM_BufferCreateSubBuffer()). 0 disables sub-buffers. */
+#ifndef gMemSharedBlocks_c
+#define gMemSharedBlocks_c           4
+#endif
+
+#ifdef MEM_PROFILING
+/* Number of distinct callers tracked by the allocation profiler.
+   The last entry collects the callers that do not fit in the table. */
+#ifndef MEM_PROFILING_CALL_SITES
+#define MEM_PROFILING_CALL_SITES     16
+#endif
+
+/* Requested size buckets: <=16, <=32, <=64, <=128, <=256, <=512, <=1024, >1024 bytes */
+#define MEM_PROFILING_SIZE_BUCKETS   8
+
+/* Fragmentation waste buckets, in eighths of the block size */
+#define MEM_PROFILING_WASTE_BUCKETS  8
+#endif /*MEM_PROFILING*/
+
+#ifdef MEM_TRACE
+/* Number of allocation trace records buffered until they are read with
+   MEM_TraceRead(). Records are dropped (and counted) when the buffer is full. */
+#ifndef MEM_TRACE_RECORDS
+#define MEM_TRACE_RECORDS            64
+#endif
+#endif /*MEM_TRACE*/
+
 /* Defines the timestamp function used by MEM Manager for debug purpose.
    The timestamp must be in milliseconds! */
 #ifndef MEM_GetTimeStamp
@@ -85,6 +145,10 @@
 /* Allocate a block from the memory pools forever.*/
 #define MEM_BufferAllocForever(numBytes,poolId)   MEM_BufferAllocWithId(numBytes, poolId, (void*)((uint32_t)__get_LR() | 0x80000000 ))
 
+/* Bytes of the parent block used in front of a sub-buffer: its header, placed at the
+   previous word boundary */
+#define MEM_SubBufferOverhead_c   (sizeof(listHeader_t) + 3)
+
              
 /*! *********************************************************************************
 *************************************************************************************
@@ -117,6 +181,12 @@ memStatus_t MEM_BufferFree(void* buffer);
 void* MEM_BufferAllocWithId(uint32_t numBytes , uint8_t  poolId, void *pCaller);
 /*Returns the size of a given buffer*/
 uint16_t MEM_BufferGetSize(void* buffer);
+/*Checks that the given pointer is an allocated buffer*/
+bool_t MEM_BufferIsAllocated(void* buffer);
+#if gMemSharedBlocks_c
+/*Returns a buffer located inside the given one, which can be freed independently*/
+void* MEM_BufferCreateSubBuffer(void* buffer, uint32_t offset);
+#endif
 /*Performs a write-read-verify test accross all pools*/
 uint32_t MEM_WriteReadTest(void);
 
@@ -156,6 +226,56 @@ typedef struct poolStat_tag
   } poolStat_t;
 #endif /*MEM_STATISTICS*/
 
+#ifdef MEM_PROFILING
+/*Sections of the allocation profiler dump*/
+typedef enum
+{
+  memProfCallSites_c = 0,
+  memProfSizeHistogram_c,
+  memProfPools_c,
+}memProfSection_t;
+
+/*Allocation statistics of a call site*/
+typedef PACKED_STRUCT memProfCallSite_tag
+{
+  uint32_t pCaller;                 /*Address passed to MEM_BufferAllocWithId(). 0 for the overflow entry*/
+  uint32_t allocCount;              /*Cumulative number of allocations*/
+  uint16_t allocFailures;           /*Cumulative number of failed allocations*/
+  uint16_t liveBlocks;              /*Blocks currently allocated*/
+  uint16_t liveBlocksPeak;          /*Peak of liveBlocks*/
+  uint16_t liveWaste;               /*Bytes lost to fragmentation by the live blocks*/
+}memProfCallSite_t;
+
+/*Fragmentation waste histogram of a pool*/
+typedef PACKED_STRUCT memProfPool_tag
+{
+  uint16_t blockSize;
+  uint8_t  poolId;
+  uint16_t wasteHistogram[MEM_PROFILING_WASTE_BUCKETS];
+}memProfPool_t;
+#endif /*MEM_PROFILING*/
+
+#ifdef MEM_TRACE
+/*Allocation trace events*/
+typedef enum
+{
+  memTraceAlloc_c = 0,
+  memTraceFree_c,
+  memTraceAllocFailed_c,
+}memTraceEvent_t;
+
+/*Allocation trace record*/
+typedef PACKED_STRUCT memTraceRecord_tag
+{
+  uint32_t timeStamp;               /*MEM_GetTimeStamp() of the event*/
+  uint16_t size;                    /*Requested size. Block size for memTraceFree_c*/
+  uint16_t block;                   /*Offset of the block header in memHeap, in 4 byte units.
+                                      0xFFFF for memTraceAllocFailed_c*/
+  uint8_t  poolId;
+  uint8_t  event;                   /*memTraceEvent_t*/
+}memTraceRecord_t;
+#endif /*MEM_TRACE*/
+
 #ifdef MEM_TRACKING
 /*Definition for alloc indicators. Used in buffer tracking.*/
 typedef enum
@@ -201,6 +321,10 @@ typedef struct pools_tag
 #endif /*MEM_STATISTICS*/
   uint8_t numBlocks;
   uint8_t allocatedBlocks;
+#if gMemLockFreePools_d
+  volatile uint32_t freeHead; /* ABA tag (bits 31..16) | index of the first free block */
+  uint8_t *pFirstBlock;       /* Address of the first block header of the pool */
+#endif
 }pools_t;
 
 /*Buffer pool description. Used by MM_Init() for creating the buffer pools. */
@@ -218,6 +342,24 @@ typedef struct poolInfo_tag
 *************************************************************************************
 ********************************************************************************** */
 
+#ifdef MEM_PROFILING
+/*Clears the cumulative profiler counters. Live block counters are kept.*/
+void MEM_ProfilerReset(void);
+/*Returns the number of entries of a profiler section*/
+uint32_t MEM_ProfilerGetCount(memProfSection_t section);
+/*Returns an entry of a profiler section, NULL if the index is out of range*/
+const void* MEM_ProfilerGetEntry(memProfSection_t section, uint32_t index);
+/*Serializes the entries of a profiler section starting with the given index*/
+uint32_t MEM_ProfilerDump(memProfSection_t section, uint32_t startIndex, uint8_t *pBuf, uint32_t bufLen);
+#endif /*MEM_PROFILING*/
+
+#ifdef MEM_TRACE
+/*Moves the oldest buffered trace records to pRecords. Returns the number of records read*/
+uint32_t MEM_TraceRead(memTraceRecord_t *pRecords, uint32_t maxRecords);
+/*Returns and clears the number of trace records dropped since the last call*/
+uint16_t MEM_TraceGetLost(void);
+#endif /*MEM_TRACE*/
+
 #ifdef MEM_TRACKING
 uint8_t MEM_Track(listHeader_t *block, memTrackingStatus_t alloc, uint32_t address, uint16_t requestedSize, void *pCaller);
 uint8_t MEM_BufferCheck(uint8_t *p, uint32_t size);
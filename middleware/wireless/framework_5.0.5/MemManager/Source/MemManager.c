@@ -42,6 +42,110 @@
 #include "Panic.h"
 #include "MemManager.h"
 #include "FunctionLib.h"
+#if gMemLockFreePools_d
+#include "fsl_device_registers.h"
+#endif
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mMemInvalidPoolIdx_c    0xFF
+
+#if gMemUseSizeClassIndex_d
+#define mMemSizeClassCount_c    (((gMemSizeClassMaxSize_c) + (1 << (gMemSizeClassShift_c)) - 1) >> (gMemSizeClassShift_c))
+#define MEM_SizeClass(size)     (((size) - 1) >> (gMemSizeClassShift_c))
+#endif
+
+#if gMemLockFreePools_d
+#define mMemFreeListEmpty_c     0x0000FFFFU
+#define mMemFreeListIdxMask_c   0x0000FFFFU
+#define mMemFreeListTagMask_c   0xFFFF0000U
+#define mMemFreeListTagInc_c    0x00010000U
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define mMemUseExclusiveAccess_d 1
+#else
+#define mMemUseExclusiveAccess_d 0
+#endif
+
+/* Pool bookkeeping is done with atomic operations */
+#define MEM_EnterCritical()
+#define MEM_ExitCritical()
+/* Block tracking still needs exclusive access to memTrack[] */
+#define MEM_TrackEnterCritical()    OSA_InterruptDisable()
+#define MEM_TrackExitCritical()     OSA_InterruptEnable()
+#else
+#define MEM_EnterCritical()         OSA_InterruptDisable()
+#define MEM_ExitCritical()          OSA_InterruptEnable()
+#define MEM_TrackEnterCritical()
+#define MEM_TrackExitCritical()
+#endif
+
+#if gMemSharedBlocks_c
+/* Sub-buffers may start at any address, their header is placed at the previous word boundary */
+#define MEM_BufferHeader(buffer)    ((listHeader_t *)((uint32_t)(buffer) & ~(uint32_t)3U) - 1)
+
+/* The parts of a shared block already freed */
+#define mMemSharedOwnerFreed_c      (0x01U)
+#define mMemSharedSubFreed_c        (0x02U)
+#else
+#define MEM_BufferHeader(buffer)    ((listHeader_t *)(buffer) - 1)
+#endif
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+#if gMemSharedBlocks_c
+/* Block shared by its owner and a sub-buffer. The header of the sub-buffer points
+   here instead of to a pool. The block is released when both are freed. */
+typedef struct memSharedBlock_tag
+{
+    listHeader_t *pHeader;     /* Header of the shared block, NULL if the entry is free */
+    listHeader_t *pSubHeader;  /* Header of the sub-buffer */
+    uint8_t freed;             /* mMemSharedOwnerFreed_c and mMemSharedSubFreed_c flags */
+}memSharedBlock_t;
+#endif
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+********************************************************************************** */
+static void MEM_InitPoolIndex(void);
+static uint8_t MEM_GetFirstPoolIdx(uint32_t numBytes, uint8_t poolId);
+static listHeader_t* MEM_PoolGetBlock(pools_t *pPool);
+static bool_t MEM_PoolClaimBlock(pools_t *pPool, listHeader_t *pHeader);
+static void MEM_PoolPutBlock(pools_t *pPool, listHeader_t *pHeader);
+static uint16_t MEM_StatAdd16(volatile uint16_t *pVal, int32_t delta);
+static uint8_t MEM_StatAdd8(volatile uint8_t *pVal, int32_t delta);
+#ifdef MEM_STATISTICS
+static void MEM_StatMax16(volatile uint16_t *pVal, uint16_t val);
+static void MEM_StatMin16(volatile uint16_t *pVal, uint16_t val);
+#endif
+#ifdef MEM_PROFILING
+static void MEM_ProfilerInit(void);
+static void MEM_ProfilerAlloc(listHeader_t *pHeader, pools_t *pPool, uint32_t numBytes, void *pCaller);
+static void MEM_ProfilerAllocFailed(void *pCaller);
+static void MEM_ProfilerFree(listHeader_t *pHeader, pools_t *pPool);
+#endif
+#ifdef MEM_TRACE
+static void MEM_TraceAdd(memTraceEvent_t event, listHeader_t *pHeader, uint32_t size, uint8_t poolId);
+#endif
+#if gMemLockFreePools_d
+static bool_t MEM_AtomicCas32(volatile uint32_t *pVal, uint32_t expected, uint32_t desired);
+static bool_t MEM_AtomicCasPtr(void * volatile *ppVal, void *expected, void *desired);
+static uint32_t MEM_AtomicLoad32(volatile uint32_t *pVal);
+static void* MEM_AtomicLoadPtr(void * volatile *ppVal);
+static void MEM_AtomicStorePtr(void * volatile *ppVal, void *val);
+#endif
+#if gMemSharedBlocks_c
+static memSharedBlock_t* MEM_GetSharedBlock(listHeader_t *pHeader);
+static memStatus_t MEM_SharedBlockRelease(listHeader_t **ppHeader);
+#endif
 
 /*! *********************************************************************************
 *************************************************************************************
@@ -73,8 +177,15 @@ poolInfo_t poolInfo[] =
 
 #define heapSize_c (PoolsDetails_c 0)
 
-/* Heap */
-uint8_t memHeap[heapSize_c];
+/* Heap. Word aligned for the exclusive accesses of the lock-free pools. */
+#if gMemLockFreePools_d && defined(__IAR_SYSTEMS_ICC__)
+#pragma data_alignment = 4
+#endif
+uint8_t memHeap[heapSize_c]
+#if gMemLockFreePools_d && defined(__GNUC__)
+  __attribute__((aligned(sizeof(void *))))
+#endif
+;
 const uint32_t heapSize = heapSize_c;
 
 #undef _block_size_
@@ -95,12 +206,24 @@ pools_t memPools[poolCount];
 pools_t  memPoolsSnapShot[poolCount];
 #endif
 
+/* Index of the next pool having the same pool ID, in pool table order */
+static uint8_t mMemNextPoolIdx[poolCount];
+
+#ifdef MEM_PROFILING
+/* Fragmentation waste histograms, per pool */
+memProfPool_t memProfPools[poolCount];
+/* First block header and global index of the first block of each pool */
+static uint8_t *mMemProfPoolBase[poolCount];
+static uint16_t mMemProfPoolFirstBlock[poolCount];
+static uint8_t  mMemProfPoolsCount;
+#endif
+
 #undef _block_size_
 #undef _number_of_blocks_
 #undef _eol_
 #undef _pool_id_
 
-#ifdef MEM_TRACKING
+#if defined(MEM_TRACKING) || defined(MEM_PROFILING)
 
 #ifndef NUM_OF_TRACK_PTR
 #define NUM_OF_TRACK_PTR 1
@@ -112,15 +235,48 @@ pools_t  memPoolsSnapShot[poolCount];
 #define _pool_id_(a)
 
 #define mTotalNoOfMsgs_d (PoolsDetails_c 0)
+#ifdef MEM_TRACKING
 static const uint16_t mTotalNoOfMsgs_c = mTotalNoOfMsgs_d;
 blockTracking_t memTrack[mTotalNoOfMsgs_d];
+#endif
+#ifdef MEM_PROFILING
+/* Call site and fragmentation waste of every allocated block */
+static uint8_t  mMemProfBlockSite[mTotalNoOfMsgs_d];
+static uint16_t mMemProfBlockWaste[mTotalNoOfMsgs_d];
+#endif
 
 #undef _block_size_
 #undef _number_of_blocks_
 #undef _eol_
 #undef _pool_id_
 
-#endif /*MEM_TRACKING*/
+#endif /*MEM_TRACKING || MEM_PROFILING*/
+
+#ifdef MEM_PROFILING
+/* Allocations grouped by caller and by requested size */
+memProfCallSite_t memProfCallSites[MEM_PROFILING_CALL_SITES];
+uint32_t memProfSizeHistogram[MEM_PROFILING_SIZE_BUCKETS];
+#endif
+
+#ifdef MEM_TRACE
+/* Allocation trace ring buffer */
+static memTraceRecord_t mMemTraceBuffer[MEM_TRACE_RECORDS];
+static uint16_t mMemTraceHead;
+static uint16_t mMemTraceCount;
+static uint16_t mMemTraceLost;
+#endif
+
+#if gMemUseSizeClassIndex_d
+/* Maps a (pool ID, size class) pair to the first pool able to hold
+   the smallest request size of that class */
+static uint8_t mMemSizeClassIdx[gMemSizeClassPoolIds_c][mMemSizeClassCount_c];
+#endif
+
+#if gMemSharedBlocks_c
+/* Blocks shared with a sub-buffer */
+static memSharedBlock_t mMemSharedBlocks[gMemSharedBlocks_c];
+static volatile uint8_t mMemSharedBlocksCount;
+#endif
 
 /* Free messages counter. Not used by module. */
 uint16_t gFreeMessagesCount;
@@ -142,7 +298,9 @@ uint16_t gMaxTotalFragmentWaste = 0;
 *
 * \param[in] none
 *
-* \return MEM_SUCCESS_c if initialization is successful. (It's always successful).
+* \return MEM_SUCCESS_c if initialization is successful. MEM_INIT_ERROR_c with
+*         gMemLockFreePools_d if a block header is not word aligned: the heap is
+*         misplaced or a block size is not a multiple of the pointer size.
 *
 ********************************************************************************** */
 memStatus_t MEM_Init(void)
@@ -175,11 +333,30 @@ memStatus_t MEM_Init(void)
 #endif /*MEM_TRACKING*/
 #endif /*MEM_STATISTICS*/
 
+    pPools->blockSize = pPoolInfo->blockSize;
+    pPools->poolId = pPoolInfo->poolId;
+#if gMemLockFreePools_d
+    /* The exclusive / atomic accesses to the block headers must be aligned */
+    if( ((uint32_t)pHeap | pPoolInfo->blockSize) & (sizeof(void *) - 1) )
+    {
+      return MEM_INIT_ERROR_c;
+    }
+
+    pPools->freeHead = mMemFreeListEmpty_c;
+    pPools->pFirstBlock = pHeap;
+#endif
+
     while(poolN)
     {
+      ((listHeader_t *)pHeap)->pParentPool = pPools;
       /* Add block to list of free memory. */
+#if gMemLockFreePools_d
+      ((listHeader_t *)pHeap)->link.list = NULL;
+      (void)MEM_PoolClaimBlock(pPools, (listHeader_t *)pHeap);
+      MEM_PoolPutBlock(pPools, (listHeader_t *)pHeap);
+#else
       ListAddTail((listHandle_t)&pPools->anchor, (listElementHandle_t)&((listHeader_t *)pHeap)->link);
-      ((listHeader_t *)pHeap)->pParentPool = pPools;
+#endif
 #ifdef MEM_STATISTICS
       pPools->poolStatistics.numBlocks++;
 #endif /*MEM_STATISTICS*/
@@ -203,8 +380,6 @@ memStatus_t MEM_Init(void)
       poolN--;
     }
 
-    pPools->blockSize = pPoolInfo->blockSize;
-    pPools->poolId = pPoolInfo->poolId;
     pPools->nextBlockSize = (pPoolInfo+1)->blockSize;
     if(pPools->nextBlockSize == 0)
     {
@@ -215,6 +390,11 @@ memStatus_t MEM_Init(void)
     pPoolInfo++;
   }
 
+  MEM_InitPoolIndex();
+#ifdef MEM_PROFILING
+  MEM_ProfilerInit();
+#endif
+
   return MEM_SUCCESS_c;
 }
 
@@ -241,7 +421,11 @@ uint32_t size
     {
         if(size <= pPools->blockSize)
         {
+#if gMemLockFreePools_d
+            pTotalCount += (uint32_t)(pPools->numBlocks - pPools->allocatedBlocks);
+#else
             pTotalCount += ListGetSize((listHandle_t)&pPools->anchor);
+#endif
         }
         
         if(pPools->nextBlockSize == 0)
@@ -294,76 +478,82 @@ void *pCaller
     bool_t allocFailure = FALSE;
 #endif
     
-    pools_t *pPools = memPools;
+    pools_t *pPools;
     listHeader_t *pBlock;
+    uint8_t poolIdx;
+    uint16_t freeCount;
 
-    OSA_InterruptDisable();
-    
-    while(numBytes)
+    MEM_EnterCritical();
+
+    poolIdx = MEM_GetFirstPoolIdx(numBytes, poolId);
+
+    while(poolIdx != mMemInvalidPoolIdx_c)
     {
-        if( (numBytes <= pPools->blockSize) && (poolId == pPools->poolId) )
+        pPools = &memPools[poolIdx];
+
+        if( numBytes <= pPools->blockSize )
         {
-            pBlock = (listHeader_t *)ListRemoveHead((listHandle_t)&pPools->anchor);
+            pBlock = MEM_PoolGetBlock(pPools);
             
             if(NULL != pBlock)
             {
                 pBlock++;
-                gFreeMessagesCount--;
-                pPools->allocatedBlocks++;
+                freeCount = MEM_StatAdd16(&gFreeMessagesCount, -1);
+                (void)MEM_StatAdd8(&pPools->allocatedBlocks, 1);
                 
 #ifdef MEM_STATISTICS
-                if(gFreeMessagesCount < gFreeMessagesCountMin)
-                {
-                    gFreeMessagesCountMin = gFreeMessagesCount;
-                }
+                MEM_StatMin16(&gFreeMessagesCountMin, freeCount);
                 
-                pPools->poolStatistics.allocatedBlocks++;
-                if ( pPools->poolStatistics.allocatedBlocks > pPools->poolStatistics.allocatedBlocksPeak )
-                {
-                    pPools->poolStatistics.allocatedBlocksPeak = pPools->poolStatistics.allocatedBlocks;
-                }
-                MEM_ASSERT(pPools->poolStatistics.allocatedBlocks <= pPools->poolStatistics.numBlocks);
+                freeCount = MEM_StatAdd16(&pPools->poolStatistics.allocatedBlocks, 1);
+                MEM_StatMax16(&pPools->poolStatistics.allocatedBlocksPeak, freeCount);
+                MEM_ASSERT(freeCount <= pPools->poolStatistics.numBlocks);
 #endif /*MEM_STATISTICS*/
+                (void)freeCount;
                 
+#if defined(MEM_TRACKING) || defined(MEM_PROFILING) || defined(MEM_TRACE)
+                MEM_TrackEnterCritical();
 #ifdef MEM_TRACKING
                 MEM_Track(pBlock, MEM_TRACKING_ALLOC_c, savedLR, requestedSize, pCaller);
 #endif /*MEM_TRACKING*/
-                OSA_InterruptEnable();
+#ifdef MEM_PROFILING
+                MEM_ProfilerAlloc(pBlock - 1, pPools, numBytes, pCaller);
+#endif /*MEM_PROFILING*/
+#ifdef MEM_TRACE
+                MEM_TraceAdd(memTraceAlloc_c, pBlock - 1, numBytes, poolId);
+#endif /*MEM_TRACE*/
+                MEM_TrackExitCritical();
+#endif
+                MEM_ExitCritical();
                 return pBlock;
             }
-            else
-            {
 #ifdef MEM_STATISTICS
-                if(!allocFailure)
-                {
-                    pPools->poolStatistics.allocationFailures++;
-                    allocFailure = TRUE;
-                }
-#endif /*MEM_STATISTICS*/
-                if(numBytes > pPools->nextBlockSize) 
-                {
-                    break;
-                }
-                /* No more blocks of that size, try next size. */
-                numBytes = pPools->nextBlockSize;   
+            if(!allocFailure)
+            {
+                (void)MEM_StatAdd16(&pPools->poolStatistics.allocationFailures, 1);
+                allocFailure = TRUE;
             }
+#endif /*MEM_STATISTICS*/
         }
-        /* Try next pool*/
-        if(pPools->nextBlockSize)
-        {
-            pPools++;
-        }
-        else
-        {
-            numBytes = 0;
-        }
+        /* No more blocks of that size, try next pool with the same ID. */
+        poolIdx = mMemNextPoolIdx[poolIdx];
     }
     
+#if defined(MEM_PROFILING) || defined(MEM_TRACE)
+    MEM_TrackEnterCritical();
+#ifdef MEM_PROFILING
+    MEM_ProfilerAllocFailed(pCaller);
+#endif /*MEM_PROFILING*/
+#ifdef MEM_TRACE
+    MEM_TraceAdd(memTraceAllocFailed_c, NULL, numBytes, poolId);
+#endif /*MEM_TRACE*/
+    MEM_TrackExitCritical();
+#endif
+
 #ifdef MEM_DEBUG_OUT_OF_MEMORY
     panic( 0, (uint32_t)MEM_BufferAllocWithId, 0, 0);
 #endif
     
-    OSA_InterruptEnable();
+    MEM_ExitCritical();
     return NULL;
 }
 
@@ -391,14 +581,13 @@ void* buffer /* IN: Block of memory to free*/
 #endif /*MEM_TRACKING*/
     listHeader_t *pHeader;
     pools_t *pParentPool;
-    pools_t *pool;
     
     if( buffer == NULL )
     {
         return MEM_FREE_ERROR_c;
     }
     
-    pHeader = (listHeader_t *)buffer-1;
+    pHeader = MEM_BufferHeader(buffer);
     
     if( ((uint8_t*)pHeader < (uint8_t*)memHeap) || ((uint8_t*)pHeader > ((uint8_t*)memHeap + sizeof(memHeap))) )
     {
@@ -408,61 +597,85 @@ void* buffer /* IN: Block of memory to free*/
         return MEM_FREE_ERROR_c;
     }
 
-    OSA_InterruptDisable();
+    MEM_EnterCritical();
     
-    pParentPool = (pools_t *)pHeader->pParentPool;
-    pool = memPools;
-
-    for(;;)
+#if gMemSharedBlocks_c
+    if( mMemSharedBlocksCount )
     {
-        if (pParentPool == pool)
-        {
-            break;
-        }
-        if(pool->nextBlockSize == 0)
+        if( MEM_SUCCESS_c != MEM_SharedBlockRelease(&pHeader) )
         {
-            /* The parent pool was not found! This means that the memory buffer is corrupt or
-            that the MEM_BufferFree() function was called with an invalid parameter */
-#ifdef MEM_STATISTICS
-            pParentPool->poolStatistics.freeFailures++;
-#endif /*MEM_STATISTICS*/
-            OSA_InterruptEnable();
+            /* The owner or the sub-buffer was already freed */
+            MEM_ExitCritical();
 #ifdef MEM_DEBUG_INVALID_POINTERS
             panic( 0, (uint32_t)MEM_BufferFree, 0, 0);
 #endif
             return MEM_FREE_ERROR_c;
         }
-        pool++;
+        
+        if( NULL == pHeader )
+        {
+            /* The block is still used by its owner or by its sub-buffer */
+            MEM_ExitCritical();
+            return MEM_SUCCESS_c;
+        }
+        
+        buffer = pHeader+1;
+    }
+#endif
+    
+    pParentPool = (pools_t *)pHeader->pParentPool;
+
+    if( (pParentPool < &memPools[0]) || (pParentPool >= &memPools[NumberOfElements(memPools)]) ||
+        (0 != (((uint8_t*)pParentPool - (uint8_t*)memPools) % sizeof(pools_t))) )
+    {
+        /* The parent pool was not found! This means that the memory buffer is corrupt or
+        that the MEM_BufferFree() function was called with an invalid parameter */
+        MEM_ExitCritical();
+#ifdef MEM_DEBUG_INVALID_POINTERS
+        panic( 0, (uint32_t)MEM_BufferFree, 0, 0);
+#endif
+        return MEM_FREE_ERROR_c;
     }
     
-    if( pHeader->link.list != NULL )
+    if( !MEM_PoolClaimBlock(pParentPool, pHeader) )
     {
         /* The memory buffer appears to be enqueued in a linked list.
         This list may be the free memory buffers pool, or another list. */
 #ifdef MEM_STATISTICS
-        pParentPool->poolStatistics.freeFailures++;
+        (void)MEM_StatAdd16(&pParentPool->poolStatistics.freeFailures, 1);
 #endif /*MEM_STATISTICS*/
-        OSA_InterruptEnable();
+        MEM_ExitCritical();
 #ifdef MEM_DEBUG_INVALID_POINTERS
         panic( 0, (uint32_t)MEM_BufferFree, 0, 0);
 #endif
         return MEM_FREE_ERROR_c;
     }
     
-    gFreeMessagesCount++;
+#if defined(MEM_TRACKING) || defined(MEM_PROFILING) || defined(MEM_TRACE)
+    MEM_TrackEnterCritical();
+#ifdef MEM_TRACKING
+    MEM_Track(buffer, MEM_TRACKING_FREE_c, savedLR, 0, NULL);
+#endif /*MEM_TRACKING*/
+#ifdef MEM_PROFILING
+    MEM_ProfilerFree(pHeader, pParentPool);
+#endif /*MEM_PROFILING*/
+#ifdef MEM_TRACE
+    MEM_TraceAdd(memTraceFree_c, pHeader, pParentPool->blockSize, (uint8_t)pParentPool->poolId);
+#endif /*MEM_TRACE*/
+    MEM_TrackExitCritical();
+#endif
     
-    ListAddTail((listHandle_t)&pParentPool->anchor, (listElementHandle_t)&pHeader->link);
-    pParentPool->allocatedBlocks--;
+    (void)MEM_StatAdd16(&gFreeMessagesCount, 1);
+    (void)MEM_StatAdd8(&pParentPool->allocatedBlocks, -1);
     
 #ifdef MEM_STATISTICS
     MEM_ASSERT(pParentPool->poolStatistics.allocatedBlocks > 0);
-    pParentPool->poolStatistics.allocatedBlocks--;
+    (void)MEM_StatAdd16(&pParentPool->poolStatistics.allocatedBlocks, -1);
 #endif /*MEM_STATISTICS*/
     
-#ifdef MEM_TRACKING
-    MEM_Track(buffer, MEM_TRACKING_FREE_c, savedLR, 0, NULL);
-#endif /*MEM_TRACKING*/
-    OSA_InterruptEnable();
+    MEM_PoolPutBlock(pParentPool, pHeader);
+    
+    MEM_ExitCritical();
     return MEM_SUCCESS_c;
 }
 
@@ -483,6 +696,16 @@ void* buffer /* IN: Block of memory to free*/
 {
     if( buffer )
     {
+#if gMemSharedBlocks_c
+        memSharedBlock_t *pShared = (memSharedBlock_t *)MEM_BufferHeader(buffer)->pParentPool;
+        
+        if( (pShared >= &mMemSharedBlocks[0]) && (pShared < &mMemSharedBlocks[gMemSharedBlocks_c]) )
+        {
+            /* A sub-buffer extends up to the end of its parent block */
+            return (uint16_t)(pShared->pHeader->pParentPool->blockSize - 
+                              ((uint8_t*)buffer - (uint8_t*)(pShared->pHeader+1)));
+        }
+#endif
         return ((pools_t *)((listHeader_t *)buffer-1)->pParentPool)->blockSize;
     }
 
@@ -490,10 +713,1020 @@ void* buffer /* IN: Block of memory to free*/
 }
 
 /*! *********************************************************************************
-*************************************************************************************
-* Private functions
-*************************************************************************************
+* \brief     Checks that a pointer is a buffer allocated by the memory manager and
+*            not yet freed: the start of a block of one of the pools. Sub-buffers
+*            are not accepted.
+*
+* \param[in] buffer - Pointer to check.
+*
+* \return TRUE if the pointer is an allocated buffer, FALSE otherwise.
+*
+* \pre Memory manager must be previously initialized.
+*
+********************************************************************************** */
+bool_t MEM_BufferIsAllocated
+(
+void* buffer /* IN: Pointer to check */
+)
+{
+    poolInfo_t *pPoolInfo = poolInfo;
+    pools_t *pPool = memPools;
+    uint8_t *pPoolStart = memHeap;
+    uint8_t *pBlock = (uint8_t *)buffer - sizeof(listHeader_t);
+    uint32_t blockBytes, poolBytes;
+
+    if( ((uint8_t *)buffer < (uint8_t *)memHeap + sizeof(listHeader_t)) ||
+        ((uint8_t *)buffer >= (uint8_t *)memHeap + sizeof(memHeap)) )
+    {
+        return FALSE;
+    }
+
+    while( pPoolInfo->blockSize )
+    {
+        blockBytes = pPoolInfo->blockSize + sizeof(listHeader_t);
+        poolBytes  = blockBytes * pPoolInfo->poolSize;
+
+        if( pBlock < pPoolStart + poolBytes )
+        {
+            /* A free block is enqueued in the anchor of its pool */
+            return (0 == (uint32_t)(pBlock - pPoolStart) % blockBytes) &&
+                   (((listHeader_t *)pBlock)->pParentPool == pPool) &&
+                   (((listHeader_t *)pBlock)->link.list != &pPool->anchor);
+        }
+
+        pPoolStart += poolBytes;
+        pPoolInfo++;
+        pPool++;
+    }
+
+    return FALSE;
+}
+
+#if gMemSharedBlocks_c
+/*! *********************************************************************************
+* \brief     Creates a sub-buffer starting at the given offset inside an allocated
+*            buffer. The sub-buffer header is written in the parent buffer, in the
+*            MEM_SubBufferOverhead_c bytes in front of the sub-buffer.
+*            The sub-buffer and the parent buffer are freed independently with
+*            MEM_BufferFree(), in any order. The block returns to its pool when both
+*            have been freed.
+*
+* \param[in] buffer - Pointer to the parent buffer.
+* \param[in] offset - Offset of the sub-buffer inside the parent buffer.
+*
+* \return Pointer to the sub-buffer, NULL if the offset is not valid or if
+*         gMemSharedBlocks_c blocks are already shared.
+*
+* \pre Memory manager must be previously initialized.
+*
+* \remarks A buffer can have a single sub-buffer. The sub-buffer cannot be split again.
+*
+********************************************************************************** */
+void* MEM_BufferCreateSubBuffer
+(
+void* buffer,   /* IN: Parent buffer */
+uint32_t offset /* IN: Offset of the sub-buffer inside the parent buffer */
+)
+{
+    listHeader_t *pHeader;
+    listHeader_t *pSubHeader;
+    memSharedBlock_t *pShared = NULL;
+    uint8_t *pSubBuffer;
+    uint32_t i;
+    
+    if( buffer == NULL )
+    {
+        return NULL;
+    }
+    
+    pHeader = (listHeader_t *)buffer-1;
+    pSubBuffer = (uint8_t *)buffer + offset;
+    pSubHeader = MEM_BufferHeader(pSubBuffer);
+    
+    if( ((uint8_t *)pSubHeader < (uint8_t *)buffer) || (offset >= pHeader->pParentPool->blockSize) )
+    {
+        return NULL;
+    }
+    
+    OSA_InterruptDisable();
+    
+    for( i = 0; i < gMemSharedBlocks_c; i++ )
+    {
+        if( mMemSharedBlocks[i].pHeader == pHeader )
+        {
+            /* The buffer already has a sub-buffer */
+            pShared = NULL;
+            break;
+        }
+        
+        if( (NULL == pShared) && (NULL == mMemSharedBlocks[i].pHeader) )
+        {
+            pShared = &mMemSharedBlocks[i];
+        }
+    }
+    
+    if( pShared )
+    {
+        pShared->pHeader = pHeader;
+        pShared->pSubHeader = pSubHeader;
+        pShared->freed = 0;
+        mMemSharedBlocksCount++;
+    }
+    
+    OSA_InterruptEnable();
+    
+    if( NULL == pShared )
+    {
+        return NULL;
+    }
+    
+    pSubHeader->link.next = NULL;
+    pSubHeader->link.prev = NULL;
+    pSubHeader->link.list = NULL;
+    pSubHeader->pParentPool = (pools_t *)pShared;
+    
+    return pSubBuffer;
+}
+#endif /* gMemSharedBlocks_c */
+
+#ifdef MEM_PROFILING
+/*! *********************************************************************************
+* \brief     Clears the cumulative counters of the allocation profiler. The live
+*            block counters are kept, so the call sites with no live blocks are
+*            released.
+*
+********************************************************************************** */
+void MEM_ProfilerReset(void)
+{
+    uint32_t i;
+
+    OSA_InterruptDisable();
+
+    for( i = 0; i < MEM_PROFILING_CALL_SITES; i++ )
+    {
+        memProfCallSites[i].allocCount = 0;
+        memProfCallSites[i].allocFailures = 0;
+        memProfCallSites[i].liveBlocksPeak = memProfCallSites[i].liveBlocks;
+
+        if( 0 == memProfCallSites[i].liveBlocks )
+        {
+            memProfCallSites[i].pCaller = 0;
+        }
+    }
+
+    FLib_MemSet(memProfSizeHistogram, 0, sizeof(memProfSizeHistogram));
+
+    for( i = 0; i < mMemProfPoolsCount; i++ )
+    {
+        FLib_MemSet(memProfPools[i].wasteHistogram, 0, sizeof(memProfPools[i].wasteHistogram));
+    }
+
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief     Returns the number of entries of a profiler section.
+*
+* \param[in] section - The profiler section.
+*
+* \return Number of entries.
+*
+********************************************************************************** */
+uint32_t MEM_ProfilerGetCount(memProfSection_t section)
+{
+    switch( section )
+    {
+    case memProfCallSites_c:
+        return MEM_PROFILING_CALL_SITES;
+    case memProfSizeHistogram_c:
+        return MEM_PROFILING_SIZE_BUCKETS;
+    case memProfPools_c:
+        return mMemProfPoolsCount;
+    default:
+        return 0;
+    }
+}
+
+/*! *********************************************************************************
+* \brief     Returns an entry of a profiler section: a memProfCallSite_t, a uint32_t
+*            allocation counter or a memProfPool_t.
+*
+* \param[in] section - The profiler section.
+* \param[in] index - Index of the entry.
+*
+* \return Pointer to the entry, NULL if the index is out of range.
+*
+********************************************************************************** */
+const void* MEM_ProfilerGetEntry(memProfSection_t section, uint32_t index)
+{
+    if( index >= MEM_ProfilerGetCount(section) )
+    {
+        return NULL;
+    }
+
+    switch( section )
+    {
+    case memProfCallSites_c:
+        return &memProfCallSites[index];
+    case memProfSizeHistogram_c:
+        return &memProfSizeHistogram[index];
+    default:
+        return &memProfPools[index];
+    }
+}
+
+/*! *********************************************************************************
+* \brief     Serializes the entries of a profiler section. The output starts with
+*            the section, the start index and the number of entries (one byte each),
+*            followed by the packed entries. Only whole entries are written.
+*
+* \param[in] section - The profiler section.
+* \param[in] startIndex - Index of the first entry to serialize.
+* \param[out] pBuf - Destination buffer.
+* \param[in] bufLen - Size of the destination buffer.
+*
+* \return Number of bytes written.
+*
 ********************************************************************************** */
+uint32_t MEM_ProfilerDump(memProfSection_t section, uint32_t startIndex, uint8_t *pBuf, uint32_t bufLen)
+{
+    uint32_t count = MEM_ProfilerGetCount(section);
+    uint32_t entrySize, len = 3, n = 0;
+
+    if( bufLen < len )
+    {
+        return 0;
+    }
+
+    switch( section )
+    {
+    case memProfCallSites_c:
+        entrySize = sizeof(memProfCallSite_t);
+        break;
+    case memProfSizeHistogram_c:
+        entrySize = sizeof(uint32_t);
+        break;
+    default:
+        entrySize = sizeof(memProfPool_t);
+        break;
+    }
+
+    while( (startIndex + n < count) && (len + entrySize <= bufLen) )
+    {
+        OSA_InterruptDisable();
+        FLib_MemCpy(&pBuf[len], (void*)MEM_ProfilerGetEntry(section, startIndex + n), entrySize);
+        OSA_InterruptEnable();
+        len += entrySize;
+        n++;
+    }
+
+    pBuf[0] = (uint8_t)section;
+    pBuf[1] = (uint8_t)startIndex;
+    pBuf[2] = (uint8_t)n;
+
+    return len;
+}
+#endif /*MEM_PROFILING*/
+
+#ifdef MEM_TRACE
+/*! *********************************************************************************
+* \brief     Moves the oldest buffered allocation trace records to the caller's
+*            buffer, freeing their slots in the trace buffer.
+*
+* \param[out] pRecords - Destination buffer.
+* \param[in] maxRecords - Number of records that fit in the destination buffer.
+*
+* \return Number of records read.
+*
+********************************************************************************** */
+uint32_t MEM_TraceRead(memTraceRecord_t *pRecords, uint32_t maxRecords)
+{
+    uint32_t n = 0;
+
+    OSA_InterruptDisable();
+
+    while( (n < maxRecords) && (mMemTraceCount > 0) )
+    {
+        FLib_MemCpy(&pRecords[n], &mMemTraceBuffer[mMemTraceHead], sizeof(memTraceRecord_t));
+
+        if( ++mMemTraceHead == MEM_TRACE_RECORDS )
+        {
+            mMemTraceHead = 0;
+        }
+        mMemTraceCount--;
+        n++;
+    }
+
+    OSA_InterruptEnable();
+
+    return n;
+}
+
+/*! *********************************************************************************
+* \brief     Returns the number of trace records dropped because the trace buffer
+*            was full, and clears the counter.
+*
+* \return Number of dropped records.
+*
+********************************************************************************** */
+uint16_t MEM_TraceGetLost(void)
+{
+    uint16_t lost;
+
+    OSA_InterruptDisable();
+    lost = mMemTraceLost;
+    mMemTraceLost = 0;
+    OSA_InterruptEnable();
+
+    return lost;
+}
+#endif /*MEM_TRACE*/
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+/*! *********************************************************************************
+* \brief     Builds the lookup tables used by MEM_BufferAllocWithId(): the link to the
+*            next pool having the same ID and, if enabled, the size-class index.
+*
+* \remarks   Called once from MEM_Init(), after the pools were created.
+*
+********************************************************************************** */
+static void MEM_InitPoolIndex(void)
+{
+    uint32_t i, j;
+#if gMemUseSizeClassIndex_d
+    uint32_t id, sizeClass, minSize;
+#endif
+
+    for( i = 0; i < NumberOfElements(mMemNextPoolIdx); i++ )
+    {
+        mMemNextPoolIdx[i] = mMemInvalidPoolIdx_c;
+
+        if( 0 == poolInfo[i].blockSize )
+        {
+            continue;
+        }
+
+        for( j = i + 1; (j < NumberOfElements(mMemNextPoolIdx)) && (0 != poolInfo[j].blockSize); j++ )
+        {
+            if( poolInfo[j].poolId == poolInfo[i].poolId )
+            {
+                mMemNextPoolIdx[i] = (uint8_t)j;
+                break;
+            }
+        }
+    }
+
+#if gMemUseSizeClassIndex_d
+    for( id = 0; id < gMemSizeClassPoolIds_c; id++ )
+    {
+        for( sizeClass = 0; sizeClass < mMemSizeClassCount_c; sizeClass++ )
+        {
+            minSize = (sizeClass << gMemSizeClassShift_c) + 1;
+            mMemSizeClassIdx[id][sizeClass] = mMemInvalidPoolIdx_c;
+
+            for( j = 0; (j < NumberOfElements(mMemNextPoolIdx)) && (0 != poolInfo[j].blockSize); j++ )
+            {
+                if( (poolInfo[j].poolId == id) && (poolInfo[j].blockSize >= minSize) )
+                {
+                    mMemSizeClassIdx[id][sizeClass] = (uint8_t)j;
+                    break;
+                }
+            }
+        }
+    }
+#endif
+}
+
+/*! *********************************************************************************
+* \brief     Returns the index of the first pool with the given ID which can hold
+*            numBytes. The remaining candidates are reached through mMemNextPoolIdx[].
+*
+* \param[in] numBytes - Size of buffer to allocate.
+* \param[in] poolId - The ID of the pool.
+*
+* \return Index in memPools[], mMemInvalidPoolIdx_c if no pool matches.
+*
+********************************************************************************** */
+static uint8_t MEM_GetFirstPoolIdx(uint32_t numBytes, uint8_t poolId)
+{
+    uint32_t idx;
+
+    if( 0 == numBytes )
+    {
+        return mMemInvalidPoolIdx_c;
+    }
+
+#if gMemUseSizeClassIndex_d
+    if( poolId < gMemSizeClassPoolIds_c )
+    {
+        idx = MEM_SizeClass(numBytes);
+
+        if( idx >= mMemSizeClassCount_c )
+        {
+            idx = mMemSizeClassCount_c - 1;
+        }
+
+        idx = mMemSizeClassIdx[poolId][idx];
+
+        /* Several pools may share the same size class */
+        while( (idx != mMemInvalidPoolIdx_c) && (numBytes > memPools[idx].blockSize) )
+        {
+            idx = mMemNextPoolIdx[idx];
+        }
+
+        return (uint8_t)idx;
+    }
+#endif
+
+    for( idx = 0; (idx < NumberOfElements(mMemNextPoolIdx)) && (0 != poolInfo[idx].blockSize); idx++ )
+    {
+        if( (poolId == memPools[idx].poolId) && (numBytes <= memPools[idx].blockSize) )
+        {
+            return (uint8_t)idx;
+        }
+    }
+
+    return mMemInvalidPoolIdx_c;
+}
+
+#if gMemSharedBlocks_c
+/*! *********************************************************************************
+* \brief     Finds the shared block entry of a block or of a sub-buffer.
+*
+* \param[in] pHeader - Pointer to the header of the block or of the sub-buffer.
+*
+* \return Pointer to the shared block entry, NULL if the block is not shared.
+*
+********************************************************************************** */
+static memSharedBlock_t* MEM_GetSharedBlock(listHeader_t *pHeader)
+{
+    memSharedBlock_t *pShared = (memSharedBlock_t *)pHeader->pParentPool;
+    uint32_t i;
+    
+    if( (pShared >= &mMemSharedBlocks[0]) && (pShared < &mMemSharedBlocks[gMemSharedBlocks_c]) )
+    {
+        return pShared;
+    }
+    
+    for( i = 0; i < gMemSharedBlocks_c; i++ )
+    {
+        if( mMemSharedBlocks[i].pHeader == pHeader )
+        {
+            return &mMemSharedBlocks[i];
+        }
+    }
+    
+    return NULL;
+}
+
+/*! *********************************************************************************
+* \brief     Records the free of the owner or of the sub-buffer of a shared block.
+*            Blocks which are not shared are left unchanged.
+*
+* \param[in,out] ppHeader - Pointer to the header of the freed buffer. On return it
+*                          points to the header of the block to put back in its pool,
+*                          or it is NULL if the block is still in use.
+*
+* \return MEM_SUCCESS_c, or MEM_FREE_ERROR_c if this owner or sub-buffer was already
+*         freed.
+*
+********************************************************************************** */
+static memStatus_t MEM_SharedBlockRelease(listHeader_t **ppHeader)
+{
+    memSharedBlock_t *pShared;
+    memStatus_t status = MEM_SUCCESS_c;
+    uint8_t part;
+    
+    OSA_InterruptDisable();
+    
+    pShared = MEM_GetSharedBlock(*ppHeader);
+    
+    if( pShared && pShared->pHeader )
+    {
+        if( *ppHeader == pShared->pHeader )
+        {
+            part = mMemSharedOwnerFreed_c;
+        }
+        else if( *ppHeader == pShared->pSubHeader )
+        {
+            part = mMemSharedSubFreed_c;
+        }
+        else
+        {
+            /* A sub-buffer of a block released earlier, the entry was reused since */
+            part = 0;
+        }
+        
+        if( (0 == part) || (pShared->freed & part) )
+        {
+            status = MEM_FREE_ERROR_c;
+        }
+        else
+        {
+            pShared->freed |= part;
+            
+            if( (mMemSharedOwnerFreed_c | mMemSharedSubFreed_c) == pShared->freed )
+            {
+                *ppHeader = pShared->pHeader;
+                pShared->pHeader = NULL;
+                mMemSharedBlocksCount--;
+            }
+            else
+            {
+                *ppHeader = NULL;
+            }
+        }
+    }
+    
+    OSA_InterruptEnable();
+    
+    return status;
+}
+#endif /* gMemSharedBlocks_c */
+
+/*! *********************************************************************************
+* \brief     Removes the first free block of a pool.
+*
+* \param[in] pPool - Pointer to the pool.
+*
+* \return Pointer to the block header, NULL if the pool is empty.
+*
+********************************************************************************** */
+static listHeader_t* MEM_PoolGetBlock(pools_t *pPool)
+{
+#if gMemLockFreePools_d
+    uint32_t oldHead, newHead, stride;
+    listHeader_t *pHeader;
+    listHeader_t *pNext;
+
+    stride = pPool->blockSize + sizeof(listHeader_t);
+
+    do
+    {
+        oldHead = MEM_AtomicLoad32(&pPool->freeHead);
+
+        if( (oldHead & mMemFreeListIdxMask_c) == mMemFreeListEmpty_c )
+        {
+            return NULL;
+        }
+
+        pHeader = (listHeader_t *)(pPool->pFirstBlock + (oldHead & mMemFreeListIdxMask_c) * stride);
+        /* The link may be stale if the block is taken meanwhile. The tag makes the CAS fail in that case. */
+        pNext = (listHeader_t *)MEM_AtomicLoadPtr((void * volatile *)&pHeader->link.next);
+        newHead = (oldHead + mMemFreeListTagInc_c) & mMemFreeListTagMask_c;
+
+        if( NULL == pNext )
+        {
+            newHead |= mMemFreeListEmpty_c;
+        }
+        else
+        {
+            newHead |= (((uint8_t *)pNext - pPool->pFirstBlock) / stride) & mMemFreeListIdxMask_c;
+        }
+    } while( !MEM_AtomicCas32(&pPool->freeHead, oldHead, newHead) );
+
+    MEM_AtomicStorePtr((void * volatile *)&pHeader->link.next, NULL);
+    pHeader->link.list = NULL;
+
+    return pHeader;
+#else
+    return (listHeader_t *)ListRemoveHead((listHandle_t)&pPool->anchor);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief     Marks a block as being released to its pool. Fails if the block is
+*            already enqueued in a list (the free list or another one).
+*
+* \param[in] pPool - Pointer to the parent pool.
+* \param[in] pHeader - Pointer to the block header.
+*
+* \return TRUE if the block can be put back into the pool, FALSE otherwise.
+*
+********************************************************************************** */
+static bool_t MEM_PoolClaimBlock(pools_t *pPool, listHeader_t *pHeader)
+{
+#if gMemLockFreePools_d
+    return MEM_AtomicCasPtr((void * volatile *)&pHeader->link.list, NULL, &pPool->anchor);
+#else
+    (void)pPool;
+    return (NULL == pHeader->link.list);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief     Adds a block to the free blocks of a pool.
+*
+* \param[in] pPool - Pointer to the parent pool.
+* \param[in] pHeader - Pointer to the block header.
+*
+********************************************************************************** */
+static void MEM_PoolPutBlock(pools_t *pPool, listHeader_t *pHeader)
+{
+#if gMemLockFreePools_d
+    uint32_t oldHead, newHead, idx, stride;
+
+    stride = pPool->blockSize + sizeof(listHeader_t);
+    idx = ((uint8_t *)pHeader - pPool->pFirstBlock) / stride;
+
+    do
+    {
+        oldHead = MEM_AtomicLoad32(&pPool->freeHead);
+
+        if( (oldHead & mMemFreeListIdxMask_c) == mMemFreeListEmpty_c )
+        {
+            MEM_AtomicStorePtr((void * volatile *)&pHeader->link.next, NULL);
+        }
+        else
+        {
+            MEM_AtomicStorePtr((void * volatile *)&pHeader->link.next,
+                               pPool->pFirstBlock + (oldHead & mMemFreeListIdxMask_c) * stride);
+        }
+
+        newHead = ((oldHead + mMemFreeListTagInc_c) & mMemFreeListTagMask_c) | idx;
+    } while( !MEM_AtomicCas32(&pPool->freeHead, oldHead, newHead) );
+#else
+    (void)ListAddTail((listHandle_t)&pPool->anchor, (listElementHandle_t)&pHeader->link);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief     Adds a signed value to a 16/8 bit counter. Atomic in lock-free mode,
+*            otherwise the caller must be in a critical section.
+*
+* \param[in] pVal - Pointer to the counter.
+* \param[in] delta - Value to add.
+*
+* \return The new value of the counter.
+*
+********************************************************************************** */
+static uint16_t MEM_StatAdd16(volatile uint16_t *pVal, int32_t delta)
+{
+#if gMemLockFreePools_d && mMemUseExclusiveAccess_d
+    uint16_t val;
+
+    do
+    {
+        val = (uint16_t)(__LDREXH(pVal) + delta);
+    } while( __STREXH(val, pVal) );
+
+    return val;
+#elif gMemLockFreePools_d
+    return __atomic_add_fetch(pVal, (uint16_t)delta, __ATOMIC_SEQ_CST);
+#else
+    *pVal += delta;
+    return *pVal;
+#endif
+}
+
+static uint8_t MEM_StatAdd8(volatile uint8_t *pVal, int32_t delta)
+{
+#if gMemLockFreePools_d && mMemUseExclusiveAccess_d
+    uint8_t val;
+
+    do
+    {
+        val = (uint8_t)(__LDREXB(pVal) + delta);
+    } while( __STREXB(val, pVal) );
+
+    return val;
+#elif gMemLockFreePools_d
+    return __atomic_add_fetch(pVal, (uint8_t)delta, __ATOMIC_SEQ_CST);
+#else
+    *pVal += delta;
+    return *pVal;
+#endif
+}
+
+#ifdef MEM_STATISTICS
+/*! *********************************************************************************
+* \brief     Updates a peak (max) or minimum statistic.
+*
+* \param[in] pVal - Pointer to the statistic.
+* \param[in] val - New sample.
+*
+********************************************************************************** */
+static void MEM_StatMax16(volatile uint16_t *pVal, uint16_t val)
+{
+#if gMemLockFreePools_d && mMemUseExclusiveAccess_d
+    do
+    {
+        if( __LDREXH(pVal) >= val )
+        {
+            __CLREX();
+            return;
+        }
+    } while( __STREXH(val, pVal) );
+#elif gMemLockFreePools_d
+    uint16_t crt = *pVal;
+
+    while( (crt < val) && !__atomic_compare_exchange_n(pVal, &crt, val, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) )
+    {
+    }
+#else
+    if( val > *pVal )
+    {
+        *pVal = val;
+    }
+#endif
+}
+
+static void MEM_StatMin16(volatile uint16_t *pVal, uint16_t val)
+{
+#if gMemLockFreePools_d && mMemUseExclusiveAccess_d
+    do
+    {
+        if( __LDREXH(pVal) <= val )
+        {
+            __CLREX();
+            return;
+        }
+    } while( __STREXH(val, pVal) );
+#elif gMemLockFreePools_d
+    uint16_t crt = *pVal;
+
+    while( (crt > val) && !__atomic_compare_exchange_n(pVal, &crt, val, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) )
+    {
+    }
+#else
+    if( val < *pVal )
+    {
+        *pVal = val;
+    }
+#endif
+}
+#endif /*MEM_STATISTICS*/
+
+#ifdef MEM_PROFILING
+/*! *********************************************************************************
+* \brief     Initializes the allocation profiler. Called from MEM_Init().
+*
+********************************************************************************** */
+static void MEM_ProfilerInit(void)
+{
+    uint8_t *pBase = memHeap;
+    uint16_t firstBlock = 0;
+    uint32_t i;
+
+    FLib_MemSet(memProfCallSites, 0, sizeof(memProfCallSites));
+    FLib_MemSet(memProfSizeHistogram, 0, sizeof(memProfSizeHistogram));
+    FLib_MemSet(memProfPools, 0, sizeof(memProfPools));
+
+    for( i = 0; (i < NumberOfElements(memProfPools)) && (0 != poolInfo[i].blockSize); i++ )
+    {
+        memProfPools[i].blockSize = poolInfo[i].blockSize;
+        memProfPools[i].poolId = (uint8_t)poolInfo[i].poolId;
+        mMemProfPoolBase[i] = pBase;
+        mMemProfPoolFirstBlock[i] = firstBlock;
+
+        pBase += (poolInfo[i].blockSize + sizeof(listHeader_t)) * poolInfo[i].poolSize;
+        firstBlock += poolInfo[i].poolSize;
+    }
+
+    mMemProfPoolsCount = (uint8_t)i;
+}
+
+/*! *********************************************************************************
+* \brief     Returns the profiler entry of a caller. A new entry is used for unknown
+*            callers. If the table is full, the last (overflow) entry is returned.
+*
+* \param[in] pCaller - The pCaller argument of MEM_BufferAllocWithId().
+*
+* \return Index in memProfCallSites[].
+*
+********************************************************************************** */
+static uint8_t MEM_ProfilerGetSite(void *pCaller)
+{
+    uint32_t caller = (uint32_t)pCaller & 0x7FFFFFFF;
+    uint32_t i, freeIdx = MEM_PROFILING_CALL_SITES - 1;
+
+    if( 0 == caller )
+    {
+        return MEM_PROFILING_CALL_SITES - 1;
+    }
+
+    for( i = 0; i < MEM_PROFILING_CALL_SITES - 1; i++ )
+    {
+        if( caller == memProfCallSites[i].pCaller )
+        {
+            return (uint8_t)i;
+        }
+
+        if( (0 == memProfCallSites[i].pCaller) && (freeIdx == MEM_PROFILING_CALL_SITES - 1) )
+        {
+            freeIdx = i;
+        }
+    }
+
+    if( freeIdx != MEM_PROFILING_CALL_SITES - 1 )
+    {
+        memProfCallSites[freeIdx].pCaller = caller;
+    }
+
+    return (uint8_t)freeIdx;
+}
+
+/*! *********************************************************************************
+* \brief     Returns the global index of a block.
+*
+********************************************************************************** */
+static uint32_t MEM_ProfilerGetBlockIdx(listHeader_t *pHeader, pools_t *pPool)
+{
+    uint32_t poolIdx = pPool - memPools;
+
+    return mMemProfPoolFirstBlock[poolIdx] +
+           ((uint8_t*)pHeader - mMemProfPoolBase[poolIdx]) / (pPool->blockSize + sizeof(listHeader_t));
+}
+
+/*! *********************************************************************************
+* \brief     Updates the profiler after a successful allocation.
+*
+* \param[in] pHeader - Header of the allocated block.
+* \param[in] pPool - Parent pool of the block.
+* \param[in] numBytes - Requested size.
+* \param[in] pCaller - The pCaller argument of MEM_BufferAllocWithId().
+*
+********************************************************************************** */
+static void MEM_ProfilerAlloc(listHeader_t *pHeader, pools_t *pPool, uint32_t numBytes, void *pCaller)
+{
+    uint32_t blockIdx = MEM_ProfilerGetBlockIdx(pHeader, pPool);
+    uint8_t site = MEM_ProfilerGetSite(pCaller);
+    uint16_t waste = pPool->blockSize - numBytes;
+    memProfCallSite_t *pSite = &memProfCallSites[site];
+    uint32_t bucket = 0;
+
+    mMemProfBlockSite[blockIdx] = site;
+    mMemProfBlockWaste[blockIdx] = waste;
+
+    pSite->allocCount++;
+    pSite->liveBlocks++;
+    pSite->liveWaste += waste;
+    if( pSite->liveBlocks > pSite->liveBlocksPeak )
+    {
+        pSite->liveBlocksPeak = pSite->liveBlocks;
+    }
+
+    while( (numBytes > (16U << bucket)) && (bucket < MEM_PROFILING_SIZE_BUCKETS - 1) )
+    {
+        bucket++;
+    }
+    memProfSizeHistogram[bucket]++;
+
+    memProfPools[pPool - memPools].wasteHistogram[(waste * MEM_PROFILING_WASTE_BUCKETS) / pPool->blockSize]++;
+}
+
+/*! *********************************************************************************
+* \brief     Updates the profiler after a failed allocation.
+*
+* \param[in] pCaller - The pCaller argument of MEM_BufferAllocWithId().
+*
+********************************************************************************** */
+static void MEM_ProfilerAllocFailed(void *pCaller)
+{
+    memProfCallSites[MEM_ProfilerGetSite(pCaller)].allocFailures++;
+}
+
+/*! *********************************************************************************
+* \brief     Updates the profiler after a block is freed.
+*
+* \param[in] pHeader - Header of the freed block.
+* \param[in] pPool - Parent pool of the block.
+*
+********************************************************************************** */
+static void MEM_ProfilerFree(listHeader_t *pHeader, pools_t *pPool)
+{
+    uint32_t blockIdx = MEM_ProfilerGetBlockIdx(pHeader, pPool);
+    memProfCallSite_t *pSite = &memProfCallSites[mMemProfBlockSite[blockIdx]];
+
+    if( pSite->liveBlocks )
+    {
+        pSite->liveBlocks--;
+        pSite->liveWaste -= mMemProfBlockWaste[blockIdx];
+    }
+}
+#endif /*MEM_PROFILING*/
+
+#ifdef MEM_TRACE
+/*! *********************************************************************************
+* \brief     Appends a record to the allocation trace buffer.
+*
+* \param[in] event - The traced event.
+* \param[in] pHeader - Header of the block. NULL for failed allocations.
+* \param[in] size - Requested size, or block size for a free.
+* \param[in] poolId - Requested pool ID, or ID of the pool of the freed block.
+*
+********************************************************************************** */
+static void MEM_TraceAdd(memTraceEvent_t event, listHeader_t *pHeader, uint32_t size, uint8_t poolId)
+{
+    memTraceRecord_t *pRecord;
+    uint32_t idx;
+
+    if( mMemTraceCount >= MEM_TRACE_RECORDS )
+    {
+        if( mMemTraceLost < 0xFFFF )
+        {
+            mMemTraceLost++;
+        }
+        return;
+    }
+
+    idx = mMemTraceHead + mMemTraceCount;
+    if( idx >= MEM_TRACE_RECORDS )
+    {
+        idx -= MEM_TRACE_RECORDS;
+    }
+
+    pRecord = &mMemTraceBuffer[idx];
+    pRecord->timeStamp = MEM_GetTimeStamp();
+    pRecord->size = (size > 0xFFFF) ? 0xFFFF : (uint16_t)size;
+    pRecord->block = pHeader ? (uint16_t)(((uint8_t*)pHeader - memHeap) >> 2) : 0xFFFF;
+    pRecord->poolId = poolId;
+    pRecord->event = (uint8_t)event;
+    mMemTraceCount++;
+}
+#endif /*MEM_TRACE*/
+
+#if gMemLockFreePools_d
+/*! *********************************************************************************
+* \brief     Compare-and-swap of a 32 bit word / pointer.
+*
+* \param[in] pVal - Pointer to the value.
+* \param[in] expected - Value expected to be found.
+* \param[in] desired - Value to be written.
+*
+* \return TRUE if the value was written, FALSE otherwise.
+*
+********************************************************************************** */
+static bool_t MEM_AtomicCas32(volatile uint32_t *pVal, uint32_t expected, uint32_t desired)
+{
+#if mMemUseExclusiveAccess_d
+    do
+    {
+        if( __LDREXW(pVal) != expected )
+        {
+            __CLREX();
+            return FALSE;
+        }
+    } while( __STREXW(desired, pVal) );
+
+    return TRUE;
+#else
+    return __atomic_compare_exchange_n(pVal, &expected, desired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static bool_t MEM_AtomicCasPtr(void * volatile *ppVal, void *expected, void *desired)
+{
+#if mMemUseExclusiveAccess_d
+    return MEM_AtomicCas32((volatile uint32_t *)ppVal, (uint32_t)expected, (uint32_t)desired);
+#else
+    return __atomic_compare_exchange_n(ppVal, &expected, desired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief     Load / store of a 32 bit word / pointer that other contexts change
+*            concurrently. Aligned words are single copy atomic on the Cortex-M; the
+*            GCC builtins make the accesses well defined when the pools are shared by
+*            threads running in parallel (host builds).
+*
+* \param[in] pVal - Pointer to the value.
+*
+* \return The value.
+*
+********************************************************************************** */
+static uint32_t MEM_AtomicLoad32(volatile uint32_t *pVal)
+{
+#if mMemUseExclusiveAccess_d
+    return *pVal;
+#else
+    return __atomic_load_n(pVal, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void* MEM_AtomicLoadPtr(void * volatile *ppVal)
+{
+#if mMemUseExclusiveAccess_d
+    return *ppVal;
+#else
+    return __atomic_load_n(ppVal, __ATOMIC_RELAXED);
+#endif
+}
+
+static void MEM_AtomicStorePtr(void * volatile *ppVal, void *val)
+{
+#if mMemUseExclusiveAccess_d
+    *ppVal = val;
+#else
+    __atomic_store_n(ppVal, val, __ATOMIC_RELAXED);
+#endif
+}
+#endif /*gMemLockFreePools_d*/
+
 /*! *********************************************************************************
 * \brief     This function updates the tracking array element corresponding to the given
 *            block.
@@ -0,0 +1,415 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file MemAllocBench.c
+* Host test and benchmark of the Memory Manager pool selection: MEM_GetFirstPoolIdx()
+* and MEM_BufferAllocWithId() / MEM_BufferFree().
+*
+* MemManager.c is built with the pool layout of the Thread end device
+* (app_framework_config.h): the application pools (AppPoolId_d) come first, then
+* the Thread pools (ThrPoolId_d).
+*
+* check: for every request size and pool ID, MEM_GetFirstPoolIdx() returns the
+*   first pool of the table with that ID able to hold the request, and
+*   MEM_BufferAllocWithId() takes the blocks of the smallest suitable pool first,
+*   then of the next larger pools of the same ID as they run out.
+* bench: the ns per MEM_GetFirstPoolIdx() call and per MEM_BufferAllocWithId() +
+*   MEM_BufferFree() pair, for request sizes uniform up to the largest block and
+*   for small requests (up to 68 bytes, most of the Thread traffic), in both pool
+*   IDs.
+*
+* Compare a build with the default gMemUseSizeClassIndex_d (size-class index) to a
+* -DgMemUseSizeClassIndex_d=0 build (linear search of the pool table, as before
+* the index).
+*
+* Build (from this directory; -no-pie keeps the static memory below 4 GB for the
+* 32-bit pointer casts of MemManager.c):
+*   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*       -DCPU_MKW24D512VHA5 -DUSE_RTOS=0
+*       -I../../../../../devices/MKW24D5 -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../CMSIS/Include -I../../Common -I../../FunctionLib
+*       -I../../Lists -I../Interface -I../../OSAbstraction/Interface
+*       -I../../Panic/Interface
+*       -o MemAllocBench MemAllocBench.c ../../FunctionLib/FunctionLib.c
+*       ../../Lists/GenericList.c
+*   add -DgMemUseSizeClassIndex_d=0 for the linear search
+* Usage: MemAllocBench [operations per run [seed]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/* The pools of app_framework_config.h */
+#define AppPoolId_d                     0
+#define ThrPoolId_d                     1
+#define PoolsDetails_c \
+         _block_size_  16      _number_of_blocks_  4   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  68      _number_of_blocks_  4   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  160     _number_of_blocks_  2   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  260     _number_of_blocks_  2   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  16      _number_of_blocks_  34  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  68      _number_of_blocks_  16  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  160     _number_of_blocks_  16  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  260     _number_of_blocks_  8   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  540     _number_of_blocks_  5   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  800     _number_of_blocks_  2   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  1300    _number_of_blocks_  2   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  0       _number_of_blocks_  0   _pool_id_(0xFF)         _eol_
+
+#include "../Source/MemManager.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultOps_c          (10000000)
+#define mBenchSizes_c               (4096)      /* power of 2 */
+#define mBenchSmallMax_c            (68)
+#define mBenchMaxPoolId_c           (2)         /* one ID with no pool */
+#define mBenchMaxBlocks_c           (256)       /* more than the blocks of the layout */
+
+#define mBenchPoolCount_c           (NumberOfElements(memPools))    /* with the termination tag */
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* A request size distribution */
+typedef struct benchMix_tag
+{
+    const char *pName;
+    uint8_t     poolId;
+    uint32_t    maxSize;
+} benchMix_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static uint32_t mSeed = 0x2545F491;
+static uint32_t mFailures;
+
+static uint16_t mSizes[mBenchSizes_c];
+static volatile uint32_t mSink;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    printf("panic at 0x%08x\n", (unsigned)location);
+    exit(1);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    mSeed ^= mSeed << 13;
+    mSeed ^= mSeed >> 17;
+    mSeed ^= mSeed << 5;
+    return mSeed;
+}
+
+static uint64_t BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* The pool selection of the original allocator: the first pool of the table with
+   the ID, able to hold the request and, if onlyFree is set, with a free block */
+static uint8_t BenchRefPoolIdx(uint32_t numBytes, uint8_t poolId, bool_t onlyFree)
+{
+    uint32_t i;
+
+    for( i = 0; (i < mBenchPoolCount_c) && numBytes; i++ )
+    {
+        if( (poolId == memPools[i].poolId) && (numBytes <= memPools[i].blockSize) &&
+            (!onlyFree || (memPools[i].allocatedBlocks < memPools[i].numBlocks)) )
+        {
+            return (uint8_t)i;
+        }
+    }
+
+    return mMemInvalidPoolIdx_c;
+}
+
+static uint32_t BenchMaxBlockSize(void)
+{
+    uint32_t i;
+    uint32_t max = 0;
+
+    for( i = 0; i < mBenchPoolCount_c; i++ )
+    {
+        if( memPools[i].blockSize > max )
+        {
+            max = memPools[i].blockSize;
+        }
+    }
+
+    return max;
+}
+
+static uint8_t BenchPoolOf(void *pBuffer)
+{
+    return (uint8_t)(((listHeader_t *)pBuffer - 1)->pParentPool - memPools);
+}
+
+/* Compares MEM_GetFirstPoolIdx() to the reference for every size */
+static void BenchCheckLookup(void)
+{
+    uint32_t size;
+    uint32_t maxSize = BenchMaxBlockSize() + 64;
+    uint8_t id;
+    uint8_t idx;
+    uint8_t ref;
+
+    for( id = 0; id <= mBenchMaxPoolId_c; id++ )
+    {
+        for( size = 0; size <= maxSize; size++ )
+        {
+            idx = MEM_GetFirstPoolIdx(size, id);
+            ref = BenchRefPoolIdx(size, id, FALSE);
+
+            if( idx != ref )
+            {
+                printf("FAIL: pool of %u bytes, ID %u: %u instead of %u\n", (unsigned)size,
+                       (unsigned)id, (unsigned)idx, (unsigned)ref);
+                mFailures++;
+            }
+        }
+    }
+}
+
+/* Allocates every block that can hold each size and checks the pool order */
+static void BenchCheckAlloc(void)
+{
+    static void *buffers[mBenchMaxBlocks_c];
+    uint32_t maxSize = BenchMaxBlockSize();
+    uint32_t count;
+    uint32_t size;
+    uint8_t id;
+    uint8_t ref;
+    void *pBuffer;
+
+    for( id = 0; id <= mBenchMaxPoolId_c; id++ )
+    {
+        for( size = 1; size <= maxSize + 1; size += 1 + (size >> 3) )
+        {
+            count = 0;
+
+            for( ;; )
+            {
+                ref = BenchRefPoolIdx(size, id, TRUE);
+                pBuffer = MEM_BufferAllocWithId(size, id, NULL);
+
+                if( NULL == pBuffer )
+                {
+                    if( mMemInvalidPoolIdx_c != ref )
+                    {
+                        printf("FAIL: %u bytes, ID %u: no buffer with pool %u free\n",
+                               (unsigned)size, (unsigned)id, (unsigned)ref);
+                        mFailures++;
+                    }
+                    break;
+                }
+
+                buffers[count++] = pBuffer;
+
+                if( BenchPoolOf(pBuffer) != ref )
+                {
+                    printf("FAIL: %u bytes, ID %u: block of pool %u instead of %u\n", (unsigned)size,
+                           (unsigned)id, (unsigned)BenchPoolOf(pBuffer), (unsigned)ref);
+                    mFailures++;
+                }
+            }
+
+            while( count )
+            {
+                if( MEM_SUCCESS_c != MEM_BufferFree(buffers[--count]) )
+                {
+                    printf("FAIL: free of a %u byte buffer\n", (unsigned)size);
+                    mFailures++;
+                }
+            }
+        }
+    }
+
+    for( size = 0; size < mBenchPoolCount_c; size++ )
+    {
+        if( memPools[size].allocatedBlocks )
+        {
+            printf("FAIL: blocks of pool %u still allocated\n", (unsigned)size);
+            mFailures++;
+        }
+    }
+}
+
+static void BenchFillSizes(uint32_t maxSize)
+{
+    uint32_t i;
+
+    for( i = 0; i < mBenchSizes_c; i++ )
+    {
+        mSizes[i] = (uint16_t)(1 + BenchRand() % maxSize);
+    }
+}
+
+/* Returns the ns per MEM_GetFirstPoolIdx() call */
+static double BenchLookup(uint8_t poolId, uint32_t ops)
+{
+    uint64_t start;
+    uint32_t sum = 0;
+    uint32_t i;
+
+    start = BenchNow();
+
+    for( i = 0; i < ops; i++ )
+    {
+        sum += MEM_GetFirstPoolIdx(mSizes[i & (mBenchSizes_c - 1)], poolId);
+    }
+
+    mSink = sum;
+    return (double)(BenchNow() - start) / ops;
+}
+
+/* Returns the ns per MEM_BufferAllocWithId() + MEM_BufferFree() pair */
+static double BenchAllocFree(uint8_t poolId, uint32_t ops)
+{
+    uint64_t start;
+    uint32_t i;
+    void *pBuffer;
+
+    start = BenchNow();
+
+    for( i = 0; i < ops; i++ )
+    {
+        pBuffer = MEM_BufferAllocWithId(mSizes[i & (mBenchSizes_c - 1)], poolId, NULL);
+
+        if( NULL == pBuffer )
+        {
+            printf("FAIL: allocation of %u bytes, ID %u\n", (unsigned)mSizes[i & (mBenchSizes_c - 1)],
+                   (unsigned)poolId);
+            mFailures++;
+            break;
+        }
+
+        (void)MEM_BufferFree(pBuffer);
+    }
+
+    return (double)(BenchNow() - start) / ops;
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    benchMix_t mixes[] =
+    {
+        {"ThrPoolId_d, 1-1300 bytes", ThrPoolId_d, 1300},
+        {"ThrPoolId_d, 1-68 bytes  ", ThrPoolId_d, mBenchSmallMax_c},
+        {"AppPoolId_d, 1-260 bytes ", AppPoolId_d, 260},
+        {"AppPoolId_d, 1-68 bytes  ", AppPoolId_d, mBenchSmallMax_c},
+    };
+    uint32_t ops = mBenchDefaultOps_c;
+    uint32_t i;
+    double lookupNs;
+    double allocNs;
+
+    if( argc > 1 )
+    {
+        ops = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if( argc > 2 )
+    {
+        mSeed = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+
+    if( (0 == ops) || (0 == mSeed) )
+    {
+        printf("Usage: %s [operations per run [seed]]\n", argv[0]);
+        return 1;
+    }
+
+    (void)MEM_Init();
+
+    printf("gMemUseSizeClassIndex_d %u, %u pools, %u operations per run\n",
+           (unsigned)gMemUseSizeClassIndex_d, (unsigned)(mBenchPoolCount_c - 1), (unsigned)ops);
+
+    BenchCheckLookup();
+    BenchCheckAlloc();
+
+    for( i = 0; i < NumberOfElements(mixes); i++ )
+    {
+        BenchFillSizes(mixes[i].maxSize);
+        lookupNs = BenchLookup(mixes[i].poolId, ops);
+        allocNs = BenchAllocFree(mixes[i].poolId, ops);
+        printf("%s: lookup %6.2f ns, alloc + free %6.2f ns\n", mixes[i].pName, lookupNs, allocNs);
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
@@ -0,0 +1,558 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file MemLockFreeStress.c
+* Host stress test of the Memory Manager lock-free free lists (gMemLockFreePools_d):
+* MEM_PoolGetBlock() and MEM_PoolPutBlock() called concurrently through
+* MEM_BufferAllocWithId() and MEM_BufferFree().
+*
+* MemManager.c is built with gMemLockFreePools_d set and a small two-ID pool layout,
+* so the pools run out and the free lists are contended. Each thread allocates
+* random sizes from both IDs, fills every buffer with a pattern of its own, holds up
+* to a given number of buffers and frees them in random order, checking the pattern
+* first: a block handed to two owners at the same time is overwritten and detected.
+* A periodic timer signal stands in for the interrupts of the target: its handler
+* preempts the thread it lands on, possibly inside the allocator, and allocates or
+* frees buffers of its own. The threads stand in for the tasks, and run in parallel
+* on a multi-core host.
+*
+* After the threads are done the integrity of every pool is checked: no block
+* allocated, gFreeMessagesCount back to the number of blocks, and a free list that
+* holds each block of the pool exactly once, with valid headers. Every block must
+* then be allocated once from the empty state.
+*
+* The block sizes are multiples of 8 bytes, as MEM_Init() requires in lock-free
+* mode for 64-bit pointers.
+*
+* Build (from this directory; -no-pie keeps the static memory below 4 GB for the
+* 32-bit pointer casts of MemManager.c):
+*   gcc -O2 -no-pie -pthread -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*       -DCPU_MKW24D512VHA5 -DUSE_RTOS=0
+*       -I../../../../../devices/MKW24D5 -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../CMSIS/Include -I../../Common -I../../FunctionLib
+*       -I../../Lists -I../Interface -I../../OSAbstraction/Interface
+*       -I../../Panic/Interface
+*       -o MemLockFreeStress MemLockFreeStress.c ../../FunctionLib/FunctionLib.c
+*       ../../Lists/GenericList.c
+* Usage: MemLockFreeStress [operations per thread [threads [held buffers
+*                           [interrupt period in us [seed]]]]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+
+#define gMemLockFreePools_d             1
+
+#define PoolsDetails_c \
+         _block_size_  16      _number_of_blocks_  8   _pool_id_(0)  _eol_  \
+         _block_size_  64      _number_of_blocks_  6   _pool_id_(0)  _eol_  \
+         _block_size_  256     _number_of_blocks_  3   _pool_id_(0)  _eol_  \
+         _block_size_  32      _number_of_blocks_  12  _pool_id_(1)  _eol_  \
+         _block_size_  128     _number_of_blocks_  6   _pool_id_(1)  _eol_  \
+         _block_size_  512     _number_of_blocks_  2   _pool_id_(1)  _eol_  \
+         _block_size_  0       _number_of_blocks_  0   _pool_id_(0xFF)  _eol_
+
+#include "../Source/MemManager.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mStressDefaultOps_c         (2000000)
+#define mStressDefaultThreads_c     (4)
+#define mStressDefaultHeld_c        (4)
+#define mStressDefaultPeriod_c      (20)        /* us */
+#define mStressMaxThreads_c         (16)
+#define mStressMaxHeld_c            (16)
+#define mStressIsrHeld_c            (2)
+#define mStressMaxSize_c            (512)
+#define mStressMaxBlocks_c          (64)        /* more than the blocks of the layout */
+
+#define mStressPoolCount_c          (NumberOfElements(memPools) - 1)    /* without the termination tag */
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* A buffer held by a thread */
+typedef struct stressHeld_tag
+{
+    uint8_t  *pBuffer;
+    uint32_t size;
+    uint8_t  pattern;
+} stressHeld_t;
+
+/* Buffers and statistics of a context: a thread or the interrupts landing on it */
+typedef struct stressContext_tag
+{
+    uint32_t     id;
+    uint32_t     seed;
+    uint32_t     maxHeld;
+    uint32_t     allocs;
+    uint32_t     allocFailures;
+    uint32_t     frees;
+    uint32_t     failures;
+    stressHeld_t held[mStressMaxHeld_c];
+    uint32_t     heldCount;
+} stressContext_t;
+
+typedef struct stressThread_tag
+{
+    pthread_t       thread;
+    stressContext_t task;
+    stressContext_t isr;
+} stressThread_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static uint32_t mFailures;
+static uint32_t mOps = mStressDefaultOps_c;
+static uint32_t mHeld = mStressDefaultHeld_c;
+
+static stressThread_t mThreads[mStressMaxThreads_c];
+static pthread_barrier_t mStartBarrier;
+
+/* Thread the interrupt lands on, NULL outside of the test */
+static __thread stressThread_t * volatile mpCurrentThread;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    printf("panic at 0x%08x\n", (unsigned)location);
+    exit(1);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t StressRand(uint32_t *pSeed)
+{
+    *pSeed ^= *pSeed << 13;
+    *pSeed ^= *pSeed >> 17;
+    *pSeed ^= *pSeed << 5;
+    return *pSeed;
+}
+
+static uint64_t StressNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void StressExpect(bool_t condition, const char *pWhat)
+{
+    if( !condition )
+    {
+        printf("FAIL: %s\n", pWhat);
+        mFailures++;
+    }
+}
+
+/* Checks the pattern of a held buffer and frees it. Does not print: it runs in
+   the signal handler too. */
+static void StressFree(stressContext_t *pContext, uint32_t idx)
+{
+    stressHeld_t *pHeld = &pContext->held[idx];
+    uint32_t i;
+
+    for( i = 0; i < pHeld->size; i++ )
+    {
+        if( pHeld->pBuffer[i] != pHeld->pattern )
+        {
+            pContext->failures++;
+            break;
+        }
+    }
+
+    if( MEM_SUCCESS_c != MEM_BufferFree(pHeld->pBuffer) )
+    {
+        pContext->failures++;
+    }
+
+    pContext->frees++;
+    pContext->heldCount--;
+    *pHeld = pContext->held[pContext->heldCount];
+}
+
+/* Allocates or frees a random buffer */
+static void StressStep(stressContext_t *pContext)
+{
+    stressHeld_t *pHeld;
+    uint32_t rnd = StressRand(&pContext->seed);
+    uint32_t size;
+    uint8_t *pBuffer;
+
+    if( (pContext->heldCount < pContext->maxHeld) && ((0 == pContext->heldCount) || (rnd & 1U)) )
+    {
+        size = 1 + (rnd >> 8) % mStressMaxSize_c;
+        pBuffer = MEM_BufferAllocWithId(size, (uint8_t)((rnd >> 1) & 1U), NULL);
+
+        if( NULL == pBuffer )
+        {
+            pContext->allocFailures++;
+            return;
+        }
+
+        pContext->allocs++;
+        pHeld = &pContext->held[pContext->heldCount++];
+        pHeld->pBuffer = pBuffer;
+        pHeld->size = size;
+        pHeld->pattern = (uint8_t)((pContext->id << 3) | ((rnd >> 2) & 0x07U));
+        memset(pBuffer, pHeld->pattern, size);
+    }
+    else
+    {
+        StressFree(pContext, (rnd >> 8) % pContext->heldCount);
+    }
+}
+
+static void StressInterrupt(int signal)
+{
+    (void)signal;
+
+    if( mpCurrentThread )
+    {
+        StressStep(&mpCurrentThread->isr);
+    }
+}
+
+static void* StressThread(void *pParam)
+{
+    stressThread_t *pThread = (stressThread_t *)pParam;
+    sigset_t set;
+    uint32_t op;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGALRM);
+
+    pthread_barrier_wait(&mStartBarrier);
+    mpCurrentThread = pThread;
+    pthread_sigmask(SIG_UNBLOCK, &set, NULL);
+
+    for( op = 0; op < mOps; op++ )
+    {
+        StressStep(&pThread->task);
+    }
+
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+    mpCurrentThread = NULL;
+
+    while( pThread->task.heldCount )
+    {
+        StressFree(&pThread->task, 0);
+    }
+
+    while( pThread->isr.heldCount )
+    {
+        StressFree(&pThread->isr, 0);
+    }
+
+    return NULL;
+}
+
+/* Walks the free list of a pool and checks that it holds every block once */
+static void StressCheckPool(uint32_t poolIdx)
+{
+    pools_t *pPool = &memPools[poolIdx];
+    uint32_t stride = pPool->blockSize + sizeof(listHeader_t);
+    uint8_t seen[mStressMaxBlocks_c];
+    listHeader_t *pHeader;
+    uint32_t count = 0;
+    uint32_t idx;
+    char what[96];
+
+    memset(seen, 0, sizeof(seen));
+
+    snprintf(what, sizeof(what), "pool %u: no block allocated", (unsigned)poolIdx);
+    StressExpect(0 == pPool->allocatedBlocks, what);
+
+    if( (pPool->freeHead & mMemFreeListIdxMask_c) == mMemFreeListEmpty_c )
+    {
+        pHeader = NULL;
+    }
+    else
+    {
+        pHeader = (listHeader_t *)(pPool->pFirstBlock + (pPool->freeHead & mMemFreeListIdxMask_c) * stride);
+    }
+
+    while( pHeader )
+    {
+        idx = (uint32_t)((uint8_t *)pHeader - pPool->pFirstBlock) / stride;
+
+        if( ((uint8_t *)pHeader < pPool->pFirstBlock) || (idx >= poolInfo[poolIdx].poolSize) ||
+            (0 != ((uint8_t *)pHeader - pPool->pFirstBlock) % stride) )
+        {
+            printf("FAIL: pool %u: free list entry outside the pool\n", (unsigned)poolIdx);
+            mFailures++;
+            return;
+        }
+
+        if( seen[idx] )
+        {
+            printf("FAIL: pool %u: block %u twice in the free list\n", (unsigned)poolIdx, (unsigned)idx);
+            mFailures++;
+            return;
+        }
+
+        seen[idx] = 1;
+        count++;
+
+        if( (pHeader->pParentPool != pPool) || (pHeader->link.list != &pPool->anchor) )
+        {
+            printf("FAIL: pool %u: header of free block %u\n", (unsigned)poolIdx, (unsigned)idx);
+            mFailures++;
+        }
+
+        pHeader = (listHeader_t *)pHeader->link.next;
+    }
+
+    snprintf(what, sizeof(what), "pool %u: every block in the free list", (unsigned)poolIdx);
+    StressExpect(count == poolInfo[poolIdx].poolSize, what);
+}
+
+/* Allocates every block of the layout from the empty state and frees them */
+static void StressCheckDrain(void)
+{
+    static void *buffers[mStressMaxBlocks_c * 4];
+    uint32_t expected = 0;
+    uint32_t count = 0;
+    uint32_t i;
+    void *pBuffer;
+
+    for( i = 0; i < mStressPoolCount_c; i++ )
+    {
+        expected += poolInfo[i].poolSize;
+
+        while( NULL != (pBuffer = MEM_BufferAllocWithId(poolInfo[i].blockSize, (uint8_t)poolInfo[i].poolId, NULL)) )
+        {
+            if( count < NumberOfElements(buffers) )
+            {
+                buffers[count] = pBuffer;
+            }
+            count++;
+        }
+    }
+
+    StressExpect(count == expected, "every block allocated once from the empty state");
+
+    while( count )
+    {
+        count--;
+        if( count < NumberOfElements(buffers) )
+        {
+            (void)MEM_BufferFree(buffers[count]);
+        }
+    }
+}
+
+static void StressCheck(void)
+{
+    uint32_t total = 0;
+    uint32_t i;
+
+    for( i = 0; i < mStressPoolCount_c; i++ )
+    {
+        total += poolInfo[i].poolSize;
+        StressCheckPool(i);
+    }
+
+    StressExpect(total == gFreeMessagesCount, "gFreeMessagesCount is the number of blocks");
+    StressCheckDrain();
+
+    for( i = 0; i < mStressPoolCount_c; i++ )
+    {
+        StressCheckPool(i);
+    }
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    uint32_t threads = mStressDefaultThreads_c;
+    uint32_t period = mStressDefaultPeriod_c;
+    uint32_t seed = 0x2545F491;
+    uint32_t allocs = 0;
+    uint32_t allocFailures = 0;
+    uint32_t isrAllocs = 0;
+    struct sigaction action;
+    sigset_t set;
+    struct itimerval timer;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t i;
+
+    if( argc > 1 )
+    {
+        mOps = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if( argc > 2 )
+    {
+        threads = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    if( argc > 3 )
+    {
+        mHeld = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+    if( argc > 4 )
+    {
+        period = (uint32_t)strtoul(argv[4], NULL, 0);
+    }
+    if( argc > 5 )
+    {
+        seed = (uint32_t)strtoul(argv[5], NULL, 0);
+    }
+
+    if( (0 == mOps) || (0 == threads) || (threads > mStressMaxThreads_c) || (0 == mHeld) ||
+        (mHeld > mStressMaxHeld_c) || (0 == seed) )
+    {
+        printf("Usage: %s [operations per thread [threads (1-%u) [held buffers (1-%u)\n"
+               "       [interrupt period in us, 0 for none [seed]]]]]\n", argv[0],
+               (unsigned)mStressMaxThreads_c, (unsigned)mStressMaxHeld_c);
+        return 1;
+    }
+
+    if( MEM_SUCCESS_c != MEM_Init() )
+    {
+        printf("FAIL: MEM_Init\nFAILED\n");
+        return 1;
+    }
+
+    printf("%u threads, %u operations per thread, up to %u buffers held per thread, interrupt every %u us\n",
+           (unsigned)threads, (unsigned)mOps, (unsigned)mHeld, (unsigned)period);
+
+    StressCheck();
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = StressInterrupt;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGALRM, &action, NULL);
+
+    /* The interrupts land on the test threads only; they unblock the signal */
+    sigemptyset(&set);
+    sigaddset(&set, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+    pthread_barrier_init(&mStartBarrier, NULL, threads);
+
+    for( i = 0; i < threads; i++ )
+    {
+        mThreads[i].task.id = 2 * i;
+        mThreads[i].task.seed = (seed + 2 * i * 0x9E3779B9U) | 1U;
+        mThreads[i].task.maxHeld = mHeld;
+        mThreads[i].isr.id = 2 * i + 1;
+        mThreads[i].isr.seed = (seed + (2 * i + 1) * 0x9E3779B9U) | 1U;
+        mThreads[i].isr.maxHeld = mStressIsrHeld_c;
+    }
+
+    memset(&timer, 0, sizeof(timer));
+    timer.it_interval.tv_usec = period;
+    timer.it_value.tv_usec = period;
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    start = StressNow();
+
+    for( i = 0; i < threads; i++ )
+    {
+        pthread_create(&mThreads[i].thread, NULL, StressThread, &mThreads[i]);
+    }
+
+    for( i = 0; i < threads; i++ )
+    {
+        pthread_join(mThreads[i].thread, NULL);
+    }
+
+    elapsed = StressNow() - start;
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_REAL, &timer, NULL);
+    pthread_barrier_destroy(&mStartBarrier);
+
+    for( i = 0; i < threads; i++ )
+    {
+        allocs += mThreads[i].task.allocs + mThreads[i].isr.allocs;
+        allocFailures += mThreads[i].task.allocFailures + mThreads[i].isr.allocFailures;
+        isrAllocs += mThreads[i].isr.allocs;
+        StressExpect(0 == mThreads[i].task.failures, "a thread found its buffers intact");
+        StressExpect(0 == mThreads[i].isr.failures, "an interrupt found its buffers intact");
+        StressExpect(mThreads[i].task.allocs == mThreads[i].task.frees, "a thread freed every buffer it allocated");
+        StressExpect(mThreads[i].isr.allocs == mThreads[i].isr.frees, "every buffer of an interrupt freed");
+    }
+
+    printf("%u allocations (%u from interrupts), %u failed for lack of blocks, %.1f ns per operation\n",
+           (unsigned)allocs, (unsigned)isrAllocs, (unsigned)allocFailures, (double)elapsed / ((double)mOps * threads));
+
+    StressCheck();
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
@@ -0,0 +1,615 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file MemPoolTuner.c
+* Host tool that derives a Memory Manager pool layout from an allocation trace
+* captured with MEM_TRACE (see MEM_TraceRead() and the Fsci-GetMemTrace request).
+*
+* The input file holds the memTraceRecord_t records, as received over FSCI,
+* concatenated in capture order. The trace is replayed against candidate layouts
+* and the layout with the smallest heap size having no failed allocation in the
+* requested percentile of the trace windows is printed as a PoolsDetails macro.
+*
+* Build: gcc -O2 -o MemPoolTuner MemPoolTuner.c
+* Usage: MemPoolTuner [options] trace.bin
+*   -i <id>     pool ID to tune (default 1, ThrPoolId_d)
+*   -n <count>  maximum number of pools (default 7)
+*   -p <pct>    percentile of the trace windows with no failure (default 100)
+*   -w <ms>     trace window length (default 1000 ms, or 1000 records when the
+*               trace has no timestamps)
+*   -a <bytes>  block size alignment (default 4)
+*   -m <name>   name of the generated macro (default ThreadPoolsDetails_c)
+*   -t <token>  pool ID token of the generated macro (default ThrPoolId_d)
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+/* Size of a packed memTraceRecord_t */
+#define mTraceRecordSize_c      10
+/* memTraceEvent_t */
+#define mTraceAlloc_c           0
+#define mTraceFree_c            1
+#define mTraceAllocFailed_c     2
+/* Timestamp reported when MEM_GetTimeStamp() is not defined by the application */
+#define mTraceNoTimeStamp_c     0xFFFFFFFFU
+
+/* sizeof(listHeader_t) on the target: 3 list pointers and the parent pool pointer */
+#define mBlockHeaderSize_c      16
+/* pools_t.numBlocks is a uint8_t */
+#define mMaxBlocksPerPool_c     255
+/* Maximum number of distinct block sizes considered by the tuner */
+#define mMaxSizes_c             128
+#define mMaxPools_c             16
+
+#define mInfinity_c             0xFFFFFFFFFFFFFFFFULL
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* Replayed allocation event */
+typedef struct event_tag
+{
+    uint32_t window;    /* Index of the trace window */
+    uint32_t alloc;     /* For a free, index of the matching allocation event */
+    uint16_t size;      /* Aligned requested size */
+    int8_t   delta;     /* +1 for an allocation, -1 for a free, 0 for a failed allocation */
+    uint8_t  sizeIdx;   /* Index of the size in mSizes[] */
+}event_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static event_t  *mEvents;
+static uint32_t mEventsCount;
+static uint32_t mWindowsCount;
+
+static uint16_t mSizes[mMaxSizes_c];
+static uint32_t mSizesCount;
+
+/* Per window peak of live blocks, reused by every replay */
+static uint32_t *mWindowPeak;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+
+/*! *********************************************************************************
+* \brief  Reads a little endian value from a trace record.
+********************************************************************************** */
+static uint32_t GetLe(const uint8_t *p, uint32_t len)
+{
+    uint32_t val = 0;
+
+    while( len-- )
+    {
+        val = (val << 8) | p[len];
+    }
+
+    return val;
+}
+
+/*! *********************************************************************************
+* \brief  Loads the trace records of a pool ID and converts them to events.
+*         Frees are matched with the allocation of the same block, so their
+*         requested size is known. Failed allocations are kept as demand that
+*         the layout must be able to serve.
+*
+* \return 0 on success.
+********************************************************************************** */
+static int LoadTrace(const char *pFileName, uint8_t poolId, uint32_t windowLen, uint32_t align)
+{
+    /* Event index + 1 of the live allocation of each block */
+    static uint32_t liveAlloc[0x10000];
+    uint8_t rec[mTraceRecordSize_c];
+    uint32_t capacity = 0, records = 0, unmatched = 0;
+    uint32_t firstTs = 0, timed = 0;
+    FILE *pFile = fopen(pFileName, "rb");
+
+    if( NULL == pFile )
+    {
+        perror(pFileName);
+        return -1;
+    }
+
+    while( fread(rec, 1, sizeof(rec), pFile) == sizeof(rec) )
+    {
+        uint32_t ts = GetLe(&rec[0], 4);
+        uint32_t size = GetLe(&rec[4], 2);
+        uint32_t block = GetLe(&rec[6], 2);
+        event_t *pEvent;
+
+        if( (rec[8] != poolId) || (rec[9] > mTraceAllocFailed_c) )
+        {
+            continue;
+        }
+
+        if( mEventsCount == capacity )
+        {
+            capacity = capacity ? 2 * capacity : 4096;
+            mEvents = realloc(mEvents, capacity * sizeof(event_t));
+            if( NULL == mEvents )
+            {
+                fclose(pFile);
+                return -1;
+            }
+        }
+
+        pEvent = &mEvents[mEventsCount];
+        size = (size + align - 1) / align * align;
+
+        switch( rec[9] )
+        {
+        case mTraceAlloc_c:
+            pEvent->delta = 1;
+            break;
+        case mTraceFree_c:
+            if( 0 == liveAlloc[block] )
+            {
+                /* The allocation was captured before the trace started or was dropped */
+                unmatched++;
+                continue;
+            }
+            pEvent->delta = -1;
+            pEvent->alloc = liveAlloc[block] - 1;
+            size = mEvents[pEvent->alloc].size;
+            liveAlloc[block] = 0;
+            break;
+        default:
+            pEvent->delta = 0;
+            break;
+        }
+
+        if( 0 == size )
+        {
+            continue;
+        }
+
+        /* Use the timestamps if MEM_GetTimeStamp() was defined, else the record number */
+        if( ts != mTraceNoTimeStamp_c )
+        {
+            if( !timed )
+            {
+                firstTs = ts;
+                timed = 1;
+            }
+            pEvent->window = (ts - firstTs) / windowLen;
+        }
+        else
+        {
+            pEvent->window = records / windowLen;
+        }
+
+        pEvent->size = (uint16_t)size;
+        if( pEvent->delta > 0 )
+        {
+            liveAlloc[block] = mEventsCount + 1;
+        }
+        mEventsCount++;
+        records++;
+    }
+
+    fclose(pFile);
+
+    if( 0 == mEventsCount )
+    {
+        fprintf(stderr, "No records found for pool ID %u\n", poolId);
+        return -1;
+    }
+
+    if( unmatched )
+    {
+        fprintf(stderr, "Warning: %u frees without a traced allocation were ignored\n", unmatched);
+    }
+
+    mWindowsCount = mEvents[mEventsCount - 1].window + 1;
+    mWindowPeak = calloc(mWindowsCount, sizeof(uint32_t));
+
+    return (NULL == mWindowPeak) ? -1 : 0;
+}
+
+/*! *********************************************************************************
+* \brief  Collects the distinct requested sizes. If there are too many of them, the
+*         sizes are rounded up to a coarser granularity until they fit.
+********************************************************************************** */
+static void CollectSizes(uint32_t align)
+{
+    uint32_t step = align, i, j;
+
+    for( ;; )
+    {
+        mSizesCount = 0;
+
+        for( i = 0; i < mEventsCount; i++ )
+        {
+            uint16_t size = (uint16_t)((mEvents[i].size + step - 1) / step * step);
+
+            for( j = 0; (j < mSizesCount) && (mSizes[j] != size); j++ )
+            {
+            }
+
+            if( j == mSizesCount )
+            {
+                if( mSizesCount == mMaxSizes_c )
+                {
+                    break;
+                }
+                mSizes[mSizesCount++] = size;
+            }
+        }
+
+        if( i == mEventsCount )
+        {
+            break;
+        }
+        step *= 2;
+    }
+
+    /* Sort ascending */
+    for( i = 1; i < mSizesCount; i++ )
+    {
+        uint16_t size = mSizes[i];
+
+        for( j = i; (j > 0) && (mSizes[j - 1] > size); j-- )
+        {
+            mSizes[j] = mSizes[j - 1];
+        }
+        mSizes[j] = size;
+    }
+
+    for( i = 0; i < mEventsCount; i++ )
+    {
+        for( j = 0; mSizes[j] < mEvents[i].size; j++ )
+        {
+        }
+        mEvents[i].sizeIdx = (uint8_t)j;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Returns the given percentile of the per window peaks.
+********************************************************************************** */
+static int CompareU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t WindowPercentile(uint32_t percentile)
+{
+    uint32_t idx;
+
+    qsort(mWindowPeak, mWindowsCount, sizeof(uint32_t), CompareU32);
+    idx = (percentile * mWindowsCount + 99) / 100;
+
+    return mWindowPeak[(idx ? idx : 1) - 1];
+}
+
+/*! *********************************************************************************
+* \brief  Replays the trace for a single pool holding the sizes first..last and
+*         returns the number of blocks that pool needs.
+********************************************************************************** */
+static uint32_t PoolDemand(uint32_t first, uint32_t last, uint32_t percentile)
+{
+    uint32_t i, live = 0;
+
+    memset(mWindowPeak, 0, mWindowsCount * sizeof(uint32_t));
+
+    for( i = 0; i < mEventsCount; i++ )
+    {
+        const event_t *pEvent = &mEvents[i];
+
+        if( (pEvent->sizeIdx < first) || (pEvent->sizeIdx > last) )
+        {
+            continue;
+        }
+
+        if( pEvent->delta < 0 )
+        {
+            live--;
+            continue;
+        }
+
+        /* A failed allocation needs one more block, only for that moment */
+        if( live + 1 > mWindowPeak[pEvent->window] )
+        {
+            mWindowPeak[pEvent->window] = live + 1;
+        }
+        live += pEvent->delta;
+    }
+
+    return WindowPercentile(percentile);
+}
+
+/*! *********************************************************************************
+* \brief  Replays the trace against a layout using the Memory Manager policy: the
+*         smallest fitting pool first, then the larger pools.
+*
+* \return Number of windows having failed allocations. The total number of failed
+*         allocations is returned in pFailures.
+********************************************************************************** */
+static uint32_t ReplayLayout(const uint16_t *pBlockSize, const uint32_t *pBlocks,
+                             uint32_t poolsCount, uint32_t *pFailures)
+{
+    uint32_t live[mMaxPools_c] = {0};
+    uint32_t i, p, failWindows = 0, lastFailWindow = 0xFFFFFFFF;
+    /* Pool index + 1 that served each allocation event */
+    uint8_t *pPoolOf = calloc(mEventsCount, sizeof(uint8_t));
+
+    *pFailures = 0;
+
+    for( i = 0; i < mEventsCount; i++ )
+    {
+        const event_t *pEvent = &mEvents[i];
+
+        if( pEvent->delta < 0 )
+        {
+            if( pPoolOf[pEvent->alloc] )
+            {
+                live[pPoolOf[pEvent->alloc] - 1]--;
+            }
+            continue;
+        }
+
+        for( p = 0; p < poolsCount; p++ )
+        {
+            if( (pEvent->size <= pBlockSize[p]) && (live[p] < pBlocks[p]) )
+            {
+                break;
+            }
+        }
+
+        if( (p == poolsCount) || (0 == pEvent->delta) )
+        {
+            if( p == poolsCount )
+            {
+                (*pFailures)++;
+                if( pEvent->window != lastFailWindow )
+                {
+                    failWindows++;
+                    lastFailWindow = pEvent->window;
+                }
+            }
+            continue;
+        }
+
+        live[p]++;
+        pPoolOf[i] = (uint8_t)(p + 1);
+    }
+
+    free(pPoolOf);
+    return failWindows;
+}
+
+/*! *********************************************************************************
+* \brief  Prints the usage of the tool.
+********************************************************************************** */
+static void Usage(void)
+{
+    fprintf(stderr,
+            "Usage: MemPoolTuner [-i poolId] [-n maxPools] [-p percentile] [-w windowMs]\n"
+            "                    [-a align] [-m macroName] [-t poolIdToken] trace.bin\n");
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char *argv[])
+{
+    static uint64_t cost[mMaxPools_c + 1][mMaxSizes_c];
+    static uint8_t  split[mMaxPools_c + 1][mMaxSizes_c];
+    static uint32_t demand[mMaxSizes_c][mMaxSizes_c];
+    uint32_t poolId = 1, maxPools = 7, percentile = 100, windowLen = 1000, align = 4;
+    const char *pMacro = "ThreadPoolsDetails_c";
+    const char *pToken = "ThrPoolId_d";
+    const char *pFileName = NULL;
+    uint16_t blockSize[mMaxPools_c];
+    uint32_t blocks[mMaxPools_c];
+    uint32_t i, j, k, bestK = 0, poolsCount, failures, failWindows;
+    uint64_t heap;
+
+    for( i = 1; i < (uint32_t)argc; i++ )
+    {
+        if( (argv[i][0] == '-') && (i + 1 < (uint32_t)argc) )
+        {
+            switch( argv[i][1] )
+            {
+            case 'i': poolId = strtoul(argv[++i], NULL, 0); break;
+            case 'n': maxPools = strtoul(argv[++i], NULL, 0); break;
+            case 'p': percentile = strtoul(argv[++i], NULL, 0); break;
+            case 'w': windowLen = strtoul(argv[++i], NULL, 0); break;
+            case 'a': align = strtoul(argv[++i], NULL, 0); break;
+            case 'm': pMacro = argv[++i]; break;
+            case 't': pToken = argv[++i]; break;
+            default: Usage(); return 1;
+            }
+        }
+        else
+        {
+            pFileName = argv[i];
+        }
+    }
+
+    if( (NULL == pFileName) || (0 == maxPools) || (maxPools > mMaxPools_c) ||
+        (0 == percentile) || (percentile > 100) || (0 == windowLen) || (0 == align) )
+    {
+        Usage();
+        return 1;
+    }
+
+    if( LoadTrace(pFileName, (uint8_t)poolId, windowLen, align) )
+    {
+        return 1;
+    }
+
+    CollectSizes(align);
+
+    /* Blocks needed by a pool serving the sizes i..j alone */
+    for( i = 0; i < mSizesCount; i++ )
+    {
+        for( j = i; j < mSizesCount; j++ )
+        {
+            demand[i][j] = PoolDemand(i, j, percentile);
+        }
+    }
+
+    /* cost[k][j]: smallest heap serving the sizes 0..j with k pools, the last one
+       having the block size mSizes[j]. split[k][j] is the first size of that pool. */
+    for( k = 0; k <= maxPools; k++ )
+    {
+        for( j = 0; j < mSizesCount; j++ )
+        {
+            cost[k][j] = mInfinity_c;
+        }
+    }
+
+    for( j = 0; j < mSizesCount; j++ )
+    {
+        cost[1][j] = (uint64_t)(mSizes[j] + mBlockHeaderSize_c) * demand[0][j];
+        split[1][j] = 0;
+    }
+
+    for( k = 2; k <= maxPools; k++ )
+    {
+        for( j = 0; j < mSizesCount; j++ )
+        {
+            for( i = 1; i <= j; i++ )
+            {
+                uint64_t c = cost[k - 1][i - 1];
+
+                if( c == mInfinity_c )
+                {
+                    continue;
+                }
+
+                c += (uint64_t)(mSizes[j] + mBlockHeaderSize_c) * demand[i][j];
+                if( c < cost[k][j] )
+                {
+                    cost[k][j] = c;
+                    split[k][j] = (uint8_t)i;
+                }
+            }
+        }
+    }
+
+    for( k = 1; k <= maxPools; k++ )
+    {
+        if( (cost[k][mSizesCount - 1] != mInfinity_c) &&
+            ((0 == bestK) || (cost[k][mSizesCount - 1] < cost[bestK][mSizesCount - 1])) )
+        {
+            bestK = k;
+        }
+    }
+
+    /* Walk back the chosen splits. Pools with no demand are dropped. */
+    poolsCount = 0;
+    heap = 0;
+    for( k = bestK, j = mSizesCount - 1; k > 0; k-- )
+    {
+        i = split[k][j];
+        if( demand[i][j] )
+        {
+            blockSize[poolsCount] = mSizes[j];
+            blocks[poolsCount] = demand[i][j];
+            poolsCount++;
+        }
+        if( 0 == i )
+        {
+            break;
+        }
+        j = i - 1;
+    }
+
+    /* Pools are listed by increasing block size */
+    for( i = 0; i < poolsCount / 2; i++ )
+    {
+        uint16_t size = blockSize[i];
+        uint32_t n = blocks[i];
+
+        blockSize[i] = blockSize[poolsCount - 1 - i];
+        blocks[i] = blocks[poolsCount - 1 - i];
+        blockSize[poolsCount - 1 - i] = size;
+        blocks[poolsCount - 1 - i] = n;
+    }
+
+    for( i = 0; i < poolsCount; i++ )
+    {
+        if( blocks[i] > mMaxBlocksPerPool_c )
+        {
+            fprintf(stderr, "Warning: pool of %u bytes limited to %u blocks (needs %u)\n",
+                    blockSize[i], mMaxBlocksPerPool_c, blocks[i]);
+            blocks[i] = mMaxBlocksPerPool_c;
+        }
+        heap += (uint64_t)(blockSize[i] + mBlockHeaderSize_c) * blocks[i];
+    }
+
+    failWindows = ReplayLayout(blockSize, blocks, poolsCount, &failures);
+
+    printf("/* %u trace events, %u windows, %u%% of the windows without failures.\n",
+           mEventsCount, mWindowsCount, percentile);
+    printf("   Heap size: %llu bytes. Replay: %u failed allocations in %u windows. */\n",
+           (unsigned long long)heap, failures, failWindows);
+    printf("#define %s\\\n", pMacro);
+    for( i = 0; i < poolsCount; i++ )
+    {
+        printf("          _block_size_  %-6u  _number_of_blocks_  %-3u _pool_id_(%s)  _eol_%s\n",
+               blockSize[i], blocks[i], pToken, (i + 1 < poolsCount) ? "  \\" : "");
+    }
+
+    free(mEvents);
+    free(mWindowPeak);
+    return 0;
+}
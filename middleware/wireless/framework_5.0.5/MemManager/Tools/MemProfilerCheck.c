@@ -0,0 +1,582 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file MemProfilerCheck.c
+* Host test of the Memory Manager allocation profiler (MEM_PROFILING): the counters
+* recorded by MEM_BufferAllocWithId() and MEM_BufferFree(), MEM_ProfilerReset(),
+* MEM_ProfilerGetCount() / MEM_ProfilerGetEntry() and MEM_ProfilerDump().
+*
+* MemManager.c is built with MEM_PROFILING, a call site table of 4 entries (3 call
+* sites and the overflow entry) and a small layout with a pool for requests above
+* 1024 bytes, so every size bucket can be reached.
+*
+* scenario: known allocations and frees, checked against hand computed counters:
+*   per call site allocCount, allocFailures, liveBlocks, liveBlocksPeak and
+*   liveWaste, the requested size histogram and the waste histograms of the pools.
+*   Covers MEM_BufferAllocForever() callers, callers that do not fit in the table,
+*   sub-buffers, the reset and the dump.
+* random: random allocations and frees from several callers and pool IDs, with
+*   resets, compared after every operation to a model of the profiler kept by the
+*   test.
+*
+* Build (from this directory; -no-pie keeps the static memory below 4 GB for the
+* 32-bit pointer casts of MemManager.c):
+*   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*       -DCPU_MKW24D512VHA5 -DUSE_RTOS=0
+*       -I../../../../../devices/MKW24D5 -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../CMSIS/Include -I../../Common -I../../FunctionLib
+*       -I../../Lists -I../Interface -I../../OSAbstraction/Interface
+*       -I../../Panic/Interface
+*       -o MemProfilerCheck MemProfilerCheck.c ../../FunctionLib/FunctionLib.c
+*       ../../Lists/GenericList.c
+* Usage: MemProfilerCheck [random operations [seed]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define MEM_PROFILING
+#define MEM_PROFILING_CALL_SITES        4
+
+#define PoolsDetails_c \
+         _block_size_  16      _number_of_blocks_  4   _pool_id_(0)  _eol_  \
+         _block_size_  64      _number_of_blocks_  4   _pool_id_(0)  _eol_  \
+         _block_size_  256     _number_of_blocks_  2   _pool_id_(0)  _eol_  \
+         _block_size_  1100    _number_of_blocks_  1   _pool_id_(0)  _eol_  \
+         _block_size_  32      _number_of_blocks_  4   _pool_id_(1)  _eol_  \
+         _block_size_  0       _number_of_blocks_  0   _pool_id_(0xFF)  _eol_
+
+#include "../Source/MemManager.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mCheckDefaultOps_c          (200000)
+#define mCheckMaxHeld_c             (12)
+#define mCheckMaxSize_c             (1100)
+#define mCheckCallers_c             (4)         /* the last one is NULL */
+#define mCheckOverflowSite_c        (MEM_PROFILING_CALL_SITES - 1)
+#define mCheckResetPeriod_c         (997)
+
+#define mCheckPoolCount_c           (NumberOfElements(memPools) - 1)    /* without the termination tag */
+
+#define mCheckCallerA_c             ((void *)0x00001000)
+#define mCheckCallerB_c             ((void *)0x00002000)
+#define mCheckCallerC_c             ((void *)0x00003000)
+#define mCheckCallerD_c             ((void *)0x00004000)
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* Expected counters of a caller */
+typedef struct checkSite_tag
+{
+    uint32_t allocCount;
+    uint32_t allocFailures;
+    uint32_t liveBlocks;
+    uint32_t liveBlocksPeak;
+    uint32_t liveWaste;
+} checkSite_t;
+
+/* A buffer held by the random test */
+typedef struct checkHeld_tag
+{
+    void     *pBuffer;
+    uint32_t caller;
+    uint32_t waste;
+} checkHeld_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static uint32_t mSeed = 0x2545F491;
+static uint32_t mFailures;
+
+static void * const mCallers[mCheckCallers_c] =
+{
+    mCheckCallerA_c, mCheckCallerB_c, mCheckCallerC_c, NULL
+};
+
+/* Model of the profiler for the random test */
+static checkSite_t mSites[mCheckCallers_c];
+static uint32_t mSizeHistogram[MEM_PROFILING_SIZE_BUCKETS];
+static uint32_t mWasteHistogram[mCheckPoolCount_c][MEM_PROFILING_WASTE_BUCKETS];
+static checkHeld_t mHeld[mCheckMaxHeld_c];
+static uint32_t mHeldCount;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    printf("panic at 0x%08x\n", (unsigned)location);
+    exit(1);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t CheckRand(void)
+{
+    mSeed ^= mSeed << 13;
+    mSeed ^= mSeed >> 17;
+    mSeed ^= mSeed << 5;
+    return mSeed;
+}
+
+static void CheckExpect(bool_t condition, const char *pWhat)
+{
+    if( !condition )
+    {
+        printf("FAIL: %s\n", pWhat);
+        mFailures++;
+    }
+}
+
+static void CheckEqual(uint32_t value, uint32_t expected, const char *pWhat)
+{
+    if( value != expected )
+    {
+        printf("FAIL: %s: %u, expected %u\n", pWhat, (unsigned)value, (unsigned)expected);
+        mFailures++;
+    }
+}
+
+/* Returns the call site entry of a caller, NULL if it has none */
+static const memProfCallSite_t* CheckGetSite(void *pCaller)
+{
+    uint32_t caller = (uint32_t)pCaller & 0x7FFFFFFF;
+    uint32_t i;
+
+    if( 0 == caller )
+    {
+        return MEM_ProfilerGetEntry(memProfCallSites_c, mCheckOverflowSite_c);
+    }
+
+    for( i = 0; i < mCheckOverflowSite_c; i++ )
+    {
+        if( caller == memProfCallSites[i].pCaller )
+        {
+            return MEM_ProfilerGetEntry(memProfCallSites_c, i);
+        }
+    }
+
+    return NULL;
+}
+
+static void CheckSite(void *pCaller, const checkSite_t *pExpected, const char *pWhat)
+{
+    const memProfCallSite_t *pSite = CheckGetSite(pCaller);
+    char what[96];
+
+    if( NULL == pSite )
+    {
+        snprintf(what, sizeof(what), "%s: call site recorded", pWhat);
+        CheckExpect((0 == pExpected->allocCount) && (0 == pExpected->allocFailures) &&
+                    (0 == pExpected->liveBlocks), what);
+        return;
+    }
+
+    snprintf(what, sizeof(what), "%s: allocCount", pWhat);
+    CheckEqual(pSite->allocCount, pExpected->allocCount, what);
+    snprintf(what, sizeof(what), "%s: allocFailures", pWhat);
+    CheckEqual(pSite->allocFailures, pExpected->allocFailures, what);
+    snprintf(what, sizeof(what), "%s: liveBlocks", pWhat);
+    CheckEqual(pSite->liveBlocks, pExpected->liveBlocks, what);
+    snprintf(what, sizeof(what), "%s: liveBlocksPeak", pWhat);
+    CheckEqual(pSite->liveBlocksPeak, pExpected->liveBlocksPeak, what);
+    snprintf(what, sizeof(what), "%s: liveWaste", pWhat);
+    CheckEqual(pSite->liveWaste, pExpected->liveWaste, what);
+}
+
+static uint32_t CheckSizeBucket(uint32_t numBytes)
+{
+    static const uint16_t limits[MEM_PROFILING_SIZE_BUCKETS - 1] = {16, 32, 64, 128, 256, 512, 1024};
+    uint32_t i;
+
+    for( i = 0; i < NumberOfElements(limits); i++ )
+    {
+        if( numBytes <= limits[i] )
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+static uint32_t CheckSizeHistogram(uint32_t bucket)
+{
+    return *(const uint32_t *)MEM_ProfilerGetEntry(memProfSizeHistogram_c, bucket);
+}
+
+static uint32_t CheckWasteHistogram(uint32_t poolIdx, uint32_t bucket)
+{
+    return ((const memProfPool_t *)MEM_ProfilerGetEntry(memProfPools_c, poolIdx))->wasteHistogram[bucket];
+}
+
+/* Known allocations and frees */
+static void CheckScenario(void)
+{
+    checkSite_t a, b, overflow;
+    const memProfCallSite_t *pSite;
+    const memProfPool_t *pPool;
+    uint8_t buf[128];
+    void *pA1, *pA2, *pA3, *pB1, *pD1, *pSub;
+    uint32_t len, i;
+
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    memset(&overflow, 0, sizeof(overflow));
+
+    /* The initial state */
+    CheckEqual(MEM_ProfilerGetCount(memProfCallSites_c), MEM_PROFILING_CALL_SITES, "call site count");
+    CheckEqual(MEM_ProfilerGetCount(memProfSizeHistogram_c), MEM_PROFILING_SIZE_BUCKETS, "size bucket count");
+    CheckEqual(MEM_ProfilerGetCount(memProfPools_c), mCheckPoolCount_c, "pool count");
+    CheckExpect(NULL == MEM_ProfilerGetEntry(memProfPools_c, mCheckPoolCount_c), "no entry past the pools");
+    CheckExpect(NULL == MEM_ProfilerGetEntry(memProfCallSites_c, MEM_PROFILING_CALL_SITES), "no entry past the call sites");
+
+    for( i = 0; i < mCheckPoolCount_c; i++ )
+    {
+        pPool = MEM_ProfilerGetEntry(memProfPools_c, i);
+        CheckExpect((pPool->blockSize == poolInfo[i].blockSize) && (pPool->poolId == poolInfo[i].poolId),
+                    "pool entry of the layout");
+    }
+
+    /* 10 bytes in the 16 byte pool: waste 6, bucket 6 * 8 / 16 = 3 */
+    pA1 = MEM_BufferAllocWithId(10, 0, mCheckCallerA_c);
+    a.allocCount = 1; a.liveBlocks = 1; a.liveBlocksPeak = 1; a.liveWaste = 6;
+    CheckSite(mCheckCallerA_c, &a, "A after 10 bytes");
+    CheckEqual(CheckSizeHistogram(0), 1, "10 bytes in size bucket 0");
+    CheckEqual(CheckWasteHistogram(0, 3), 1, "waste 6 of 16 in bucket 3");
+
+    /* 17 bytes in the 64 byte pool: waste 47, bucket 47 * 8 / 64 = 5 */
+    pA2 = MEM_BufferAllocWithId(17, 0, mCheckCallerA_c);
+    a.allocCount = 2; a.liveBlocks = 2; a.liveBlocksPeak = 2; a.liveWaste = 6 + 47;
+    CheckSite(mCheckCallerA_c, &a, "A after 17 bytes");
+    CheckEqual(CheckSizeHistogram(1), 1, "17 bytes in size bucket 1");
+    CheckEqual(CheckWasteHistogram(1, 5), 1, "waste 47 of 64 in bucket 5");
+
+    /* A MEM_BufferAllocForever() caller shares the entry of the same address */
+    pA3 = MEM_BufferAllocWithId(1025, 0, (void *)((uint32_t)mCheckCallerA_c | 0x80000000));
+    a.allocCount = 3; a.liveBlocks = 3; a.liveBlocksPeak = 3; a.liveWaste = 6 + 47 + 75;
+    CheckSite(mCheckCallerA_c, &a, "A after forever 1025 bytes");
+    CheckEqual(CheckSizeHistogram(7), 1, "1025 bytes in size bucket 7");
+    CheckEqual(CheckWasteHistogram(3, 0), 1, "waste 75 of 1100 in bucket 0");
+
+    /* A full block: no waste. Pool ID 1. */
+    pB1 = MEM_BufferAllocWithId(32, 1, mCheckCallerB_c);
+    b.allocCount = 1; b.liveBlocks = 1; b.liveBlocksPeak = 1;
+    CheckSite(mCheckCallerB_c, &b, "B after 32 bytes");
+    CheckSite(mCheckCallerA_c, &a, "A after B");
+    CheckEqual(CheckSizeHistogram(1), 2, "32 bytes in size bucket 1");
+    CheckEqual(CheckWasteHistogram(4, 0), 1, "no waste in bucket 0");
+
+    /* The 1100 byte pool is empty, the request fails */
+    CheckExpect(NULL == MEM_BufferAllocWithId(1100, 0, mCheckCallerB_c), "1100 bytes fail");
+    b.allocFailures = 1;
+    CheckSite(mCheckCallerB_c, &b, "B after a failure");
+    CheckEqual(CheckSizeHistogram(7), 1, "failures not in the size histogram");
+
+    /* Caller C takes the last regular entry, D and NULL go to the overflow entry */
+    CheckExpect(NULL != MEM_BufferAllocWithId(1, 1, mCheckCallerC_c), "C allocates");
+    pD1 = MEM_BufferAllocWithId(100, 0, mCheckCallerD_c);
+    CheckExpect(NULL == CheckGetSite(mCheckCallerD_c), "D has no entry");
+    CheckExpect(NULL != MEM_BufferAllocWithId(200, 0, NULL), "NULL caller allocates");
+    overflow.allocCount = 2; overflow.liveBlocks = 2; overflow.liveBlocksPeak = 2;
+    overflow.liveWaste = (256 - 100) + (256 - 200);
+    CheckSite(NULL, &overflow, "overflow entry");
+    pSite = MEM_ProfilerGetEntry(memProfCallSites_c, mCheckOverflowSite_c);
+    CheckEqual(pSite->pCaller, 0, "overflow entry caller");
+    CheckEqual(CheckWasteHistogram(2, (156 * 8) / 256), 1, "waste 156 of 256");
+    CheckEqual(CheckWasteHistogram(2, (56 * 8) / 256), 1, "waste 56 of 256");
+
+    /* Frees lower the live counters and keep the peak */
+    CheckEqual(MEM_BufferFree(pA2), MEM_SUCCESS_c, "free of A2");
+    a.liveBlocks = 2; a.liveWaste = 6 + 75;
+    CheckSite(mCheckCallerA_c, &a, "A after a free");
+    CheckEqual(MEM_BufferFree(pD1), MEM_SUCCESS_c, "free of D1");
+    overflow.liveBlocks = 1; overflow.liveWaste = 256 - 200;
+    CheckSite(NULL, &overflow, "overflow entry after a free");
+
+    /* A failed free changes nothing */
+    CheckEqual(MEM_BufferFree(pA2), MEM_FREE_ERROR_c, "second free of A2");
+    CheckSite(mCheckCallerA_c, &a, "A after a double free");
+
+    CheckEqual(MEM_BufferFree(pA1), MEM_SUCCESS_c, "free of A1");
+    a.liveBlocks = 1; a.liveWaste = 75;
+    CheckSite(mCheckCallerA_c, &a, "A after the free of A1");
+
+    /* The reset keeps the live blocks and releases the entries with none */
+    CheckEqual(MEM_BufferFree(pB1), MEM_SUCCESS_c, "free of B1");
+    MEM_ProfilerReset();
+    a.allocCount = 0; a.allocFailures = 0; a.liveBlocksPeak = a.liveBlocks;
+    CheckSite(mCheckCallerA_c, &a, "A after the reset");
+    CheckExpect(NULL == CheckGetSite(mCheckCallerB_c), "entry of B released");
+    overflow.allocCount = 0; overflow.liveBlocksPeak = overflow.liveBlocks;
+    CheckSite(NULL, &overflow, "overflow entry after the reset");
+
+    for( i = 0; i < MEM_PROFILING_SIZE_BUCKETS; i++ )
+    {
+        CheckEqual(CheckSizeHistogram(i), 0, "size histogram after the reset");
+    }
+
+    for( i = 0; i < mCheckPoolCount_c * MEM_PROFILING_WASTE_BUCKETS; i++ )
+    {
+        CheckEqual(CheckWasteHistogram(i / MEM_PROFILING_WASTE_BUCKETS, i % MEM_PROFILING_WASTE_BUCKETS), 0,
+                   "waste histogram after the reset");
+    }
+
+    /* The released entry is used by the next new caller */
+    pD1 = MEM_BufferAllocWithId(8, 0, mCheckCallerD_c);
+    CheckExpect(NULL != CheckGetSite(mCheckCallerD_c), "D takes the released entry");
+
+    /* Dump: a header and the whole entries that fit */
+    CheckEqual(MEM_ProfilerDump(memProfCallSites_c, 0, buf, 2), 0, "dump in 2 bytes");
+    len = MEM_ProfilerDump(memProfCallSites_c, 1, buf, 3 + 2 * sizeof(memProfCallSite_t) + 1);
+    CheckEqual(len, 3 + 2 * sizeof(memProfCallSite_t), "dump of 2 call sites");
+    CheckExpect((memProfCallSites_c == buf[0]) && (1 == buf[1]) && (2 == buf[2]), "dump header");
+    CheckExpect(0 == memcmp(&buf[3], MEM_ProfilerGetEntry(memProfCallSites_c, 1), 2 * sizeof(memProfCallSite_t)),
+                "dumped call sites");
+    len = MEM_ProfilerDump(memProfSizeHistogram_c, 6, buf, sizeof(buf));
+    CheckEqual(len, 3 + 2 * sizeof(uint32_t), "dump of the last 2 size buckets");
+    len = MEM_ProfilerDump(memProfPools_c, 0, buf, sizeof(buf));
+    CheckEqual(len, 3 + mCheckPoolCount_c * sizeof(memProfPool_t), "dump of the pools");
+    CheckExpect(0 == memcmp(&buf[3], memProfPools, mCheckPoolCount_c * sizeof(memProfPool_t)), "dumped pools");
+    len = MEM_ProfilerDump(memProfPools_c, mCheckPoolCount_c, buf, sizeof(buf));
+    CheckExpect((3 == len) && (0 == buf[2]), "dump past the pools");
+
+#if gMemSharedBlocks_c
+    /* The block of a sub-buffer stays live until the owner and the sub-buffer are freed */
+    pSub = MEM_BufferCreateSubBuffer(pA3, MEM_SubBufferOverhead_c);
+    CheckExpect(NULL != pSub, "sub-buffer created");
+    CheckEqual(MEM_BufferFree(pA3), MEM_SUCCESS_c, "free of the owner of a sub-buffer");
+    CheckSite(mCheckCallerA_c, &a, "A with a sub-buffer");
+    CheckEqual(MEM_BufferFree(pSub), MEM_SUCCESS_c, "free of the sub-buffer");
+#else
+    (void)pSub;
+    CheckEqual(MEM_BufferFree(pA3), MEM_SUCCESS_c, "free of A3");
+#endif
+    a.liveBlocks = 0; a.liveWaste = 0;
+    CheckSite(mCheckCallerA_c, &a, "A after the free of A3");
+
+    /* Back to no live block */
+    (void)MEM_BufferFree(pD1);
+    for( i = 0; i < mCheckPoolCount_c; i++ )
+    {
+        while( memPools[i].allocatedBlocks )
+        {
+            listHeader_t *pHeader = (listHeader_t *)mMemProfPoolBase[i];
+            uint32_t n;
+
+            for( n = 0; n < poolInfo[i].poolSize; n++ )
+            {
+                if( NULL == pHeader->link.list )
+                {
+                    (void)MEM_BufferFree(pHeader + 1);
+                }
+                pHeader = (listHeader_t *)((uint8_t *)pHeader + poolInfo[i].blockSize + sizeof(listHeader_t));
+            }
+        }
+    }
+
+    MEM_ProfilerReset();
+    for( i = 0; i < MEM_PROFILING_CALL_SITES; i++ )
+    {
+        pSite = MEM_ProfilerGetEntry(memProfCallSites_c, i);
+        CheckExpect((0 == pSite->pCaller) && (0 == pSite->liveBlocks) && (0 == pSite->liveWaste),
+                    "no live block at the end of the scenario");
+    }
+}
+
+static void CheckModel(void)
+{
+    char what[32];
+    uint32_t i, j;
+
+    for( i = 0; i < mCheckCallers_c; i++ )
+    {
+        snprintf(what, sizeof(what), "caller %u", (unsigned)i);
+        CheckSite(mCallers[i], &mSites[i], what);
+    }
+
+    for( i = 0; i < MEM_PROFILING_SIZE_BUCKETS; i++ )
+    {
+        CheckEqual(CheckSizeHistogram(i), mSizeHistogram[i], "size histogram");
+    }
+
+    for( i = 0; i < mCheckPoolCount_c; i++ )
+    {
+        for( j = 0; j < MEM_PROFILING_WASTE_BUCKETS; j++ )
+        {
+            CheckEqual(CheckWasteHistogram(i, j), mWasteHistogram[i][j], "waste histogram");
+        }
+    }
+}
+
+/* Random operations compared to the model */
+static void CheckRandom(uint32_t ops)
+{
+    pools_t *pPool;
+    checkHeld_t *pHeld;
+    uint32_t op, rnd, caller, size, i;
+    uint32_t failures = mFailures;
+    void *pBuffer;
+
+    for( op = 0; (op < ops) && (failures == mFailures); op++ )
+    {
+        rnd = CheckRand();
+
+        if( 0 == (rnd % mCheckResetPeriod_c) )
+        {
+            MEM_ProfilerReset();
+
+            for( i = 0; i < mCheckCallers_c; i++ )
+            {
+                mSites[i].allocCount = 0;
+                mSites[i].allocFailures = 0;
+                mSites[i].liveBlocksPeak = mSites[i].liveBlocks;
+            }
+            memset(mSizeHistogram, 0, sizeof(mSizeHistogram));
+            memset(mWasteHistogram, 0, sizeof(mWasteHistogram));
+        }
+        else if( (mHeldCount < mCheckMaxHeld_c) && ((0 == mHeldCount) || (rnd & 1U)) )
+        {
+            caller = (rnd >> 1) % mCheckCallers_c;
+            size = 1 + (rnd >> 8) % mCheckMaxSize_c;
+            pBuffer = MEM_BufferAllocWithId(size, (uint8_t)((rnd >> 3) & 1U), mCallers[caller]);
+
+            if( NULL == pBuffer )
+            {
+                mSites[caller].allocFailures++;
+            }
+            else
+            {
+                pPool = (pools_t *)MEM_BufferHeader(pBuffer)->pParentPool;
+                pHeld = &mHeld[mHeldCount++];
+                pHeld->pBuffer = pBuffer;
+                pHeld->caller = caller;
+                pHeld->waste = pPool->blockSize - size;
+
+                mSites[caller].allocCount++;
+                mSites[caller].liveBlocks++;
+                mSites[caller].liveWaste += pHeld->waste;
+                if( mSites[caller].liveBlocks > mSites[caller].liveBlocksPeak )
+                {
+                    mSites[caller].liveBlocksPeak = mSites[caller].liveBlocks;
+                }
+                mSizeHistogram[CheckSizeBucket(size)]++;
+                mWasteHistogram[pPool - memPools][(pHeld->waste * MEM_PROFILING_WASTE_BUCKETS) / pPool->blockSize]++;
+            }
+        }
+        else
+        {
+            pHeld = &mHeld[(rnd >> 8) % mHeldCount];
+            CheckEqual(MEM_BufferFree(pHeld->pBuffer), MEM_SUCCESS_c, "free of a held buffer");
+            mSites[pHeld->caller].liveBlocks--;
+            mSites[pHeld->caller].liveWaste -= pHeld->waste;
+            *pHeld = mHeld[--mHeldCount];
+        }
+
+        CheckModel();
+    }
+
+    if( failures != mFailures )
+    {
+        printf("FAIL: random operation %u\n", (unsigned)op);
+    }
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    uint32_t ops = mCheckDefaultOps_c;
+
+    if( argc > 1 )
+    {
+        ops = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if( argc > 2 )
+    {
+        mSeed = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+
+    if( 0 == mSeed )
+    {
+        printf("Usage: %s [random operations [seed, not 0]]\n", argv[0]);
+        return 1;
+    }
+
+    (void)MEM_Init();
+
+    printf("scenario\n");
+    CheckScenario();
+
+    printf("random: %u operations\n", (unsigned)ops);
+    CheckRandom(ops);
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
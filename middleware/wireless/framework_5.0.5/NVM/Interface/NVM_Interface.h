@@ -145,6 +145,160 @@
 #define gNvRecordsCopiedBufferSize_c    64
 #endif
 
+/*
+ * Name: gNvMetaIndex_Enabled_d
+ * Description: enables/disables the RAM index of the active page meta
+ *              information. The index keeps, for every table entry, the
+ *              address of the latest full record and of the latest single
+ *              record of each element, so that page copy and restore do not
+ *              have to re-scan the meta information area. Entries which do
+ *              not fit in the index are handled by the regular page scan.
+ */
+#ifndef gNvMetaIndex_Enabled_d
+#define gNvMetaIndex_Enabled_d          TRUE
+#endif
+
+/*
+ * Name: gNvMetaIndexElementsCount_c
+ * Description: the total count of elements (summed over all table entries)
+ *              tracked by the meta information index; each element costs
+ *              two bytes of RAM
+ */
+#ifndef gNvMetaIndexElementsCount_c
+#define gNvMetaIndexElementsCount_c     128
+#endif
+
+/*
+ * Name: gNvCommitEngine_Enabled_d
+ * Description: enables/disables the commit engine. Save-on-idle, save-on-count
+ *              and save-on-interval requests mark the data sets dirty in a
+ *              bitmap instead of being queued one by one, and NvIdle() writes
+ *              all the dirty data sets in one go: the records back to back,
+ *              followed by their meta information tags programmed in a single
+ *              flash operation. A mirrored data set with several dirty elements
+ *              is written as one full record when that takes less space.
+ *              Entries that do not fit in the bitmap use the pending saves queue.
+ */
+#ifndef gNvCommitEngine_Enabled_d
+#define gNvCommitEngine_Enabled_d       TRUE
+#endif
+
+/*
+ * Name: gNvCommitElementsCount_c
+ * Description: the total count of elements (summed over all table entries)
+ *              tracked by the commit engine dirty bitmap
+ */
+#ifndef gNvCommitElementsCount_c
+#define gNvCommitElementsCount_c        128
+#endif
+
+/*
+ * Name: gNvCommitBatchSize_c
+ * Description: the maximum number of records written by the commit engine
+ *              with one meta information program operation; each record costs
+ *              22 bytes of RAM
+ */
+#ifndef gNvCommitBatchSize_c
+#define gNvCommitBatchSize_c            16
+#endif
+
+/*
+ * Name: gNvCommitDeadlineTicks_c
+ * Description: the number of save-on-interval timer ticks (seconds) the commit
+ *              engine waits after the first dirty data set before writing, so
+ *              that later saves are combined with it; 0 writes them on the
+ *              next NvIdle() call
+ */
+#ifndef gNvCommitDeadlineTicks_c
+#define gNvCommitDeadlineTicks_c        0
+#endif
+
+/*
+ * Name: gNvRingPagesCount_d
+ * Description: the number of virtual pages the NV storage sectors are split
+ *              into (NV_STORAGE_MAX_SECTORS must be a multiple of it). With
+ *              2 pages, the pages are used in turn and the old page is erased
+ *              right after a synchronous page copy. With more pages, they form
+ *              a ring: a page copy always moves to the next page, which was
+ *              erased sector by sector in NvIdle() beforehand, so that a save
+ *              never waits for an erase. Changing it changes the storage layout
+ *              and the NV storage gets formatted on the next boot.
+ *              This is a save latency setting, not wear-leveling: a page copy
+ *              still moves all the live records, and smaller pages fill up and
+ *              get copied sooner, so more pages cost flash endurance.
+ *              NvStressBench, 16 x 2 KB sectors, end device workload, per day:
+ *                pages  max NvSyncSave()  page copies  erases per sector
+ *                  2         206 ms            40              21
+ *                  4          46 ms            99              26
+ *                  8          46 ms           371              47
+ *              (bytes programmed per save request: 7.0, 8.6, 16.1).
+ */
+#ifndef gNvRingPagesCount_d
+#define gNvRingPagesCount_d             2
+#endif
+
+/*
+ * Name: gNvCopySliceRecordsCount_c
+ * Description: the maximum number of records written by a page copy in one
+ *              NvIdle() call. The copy goes on with the next calls, the active
+ *              page stays valid until the last call writes the RAM table of
+ *              the new page, and a copy interrupted by a reset is resumed on
+ *              the next boot. 0 copies the whole page in one NvIdle() call.
+ */
+#ifndef gNvCopySliceRecordsCount_c
+#define gNvCopySliceRecordsCount_c      4
+#endif
+
+/*
+ * Name: gNvCopySliceBytesCount_c
+ * Description: the maximum number of record bytes written by a page copy in
+ *              one NvIdle() call, which bounds the flash program time of the
+ *              call; at least one record is written per call
+ */
+#ifndef gNvCopySliceBytesCount_c
+#define gNvCopySliceBytesCount_c        256
+#endif
+
+/*
+ * Name: gNvDeltaRecords_Enabled_d
+ * Description: enables/disables the delta records. A full save of a data set
+ *              mirrored in RAM, selected with NvSetDeltaRecords(), only writes
+ *              the byte ranges that changed since the previous save; the
+ *              ranges cleared to zero take no record space. A full record is
+ *              written instead when it is not larger, and after every
+ *              gNvDeltaCheckpointInterval_c delta records. Page copy merges
+ *              the delta records of a data set in a new full record.
+ */
+#ifndef gNvDeltaRecords_Enabled_d
+#define gNvDeltaRecords_Enabled_d       TRUE
+#endif
+
+/*
+ * Name: gNvDeltaEntriesCount_c
+ * Description: the maximum number of data sets written with delta records
+ */
+#ifndef gNvDeltaEntriesCount_c
+#define gNvDeltaEntriesCount_c          4
+#endif
+
+/*
+ * Name: gNvDeltaRecordMaxSize_c
+ * Description: the size of the RAM buffer a delta record is built in; a save
+ *              whose changes do not fit is written as a full record
+ */
+#ifndef gNvDeltaRecordMaxSize_c
+#define gNvDeltaRecordMaxSize_c         64
+#endif
+
+/*
+ * Name: gNvDeltaCheckpointInterval_c
+ * Description: the maximum number of delta records written after a full
+ *              record of a data set, which bounds the restore time
+ */
+#ifndef gNvDeltaCheckpointInterval_c
+#define gNvDeltaCheckpointInterval_c    8
+#endif
+
 /*
  * Name: gNvCacheBufferSize_c
  * Description: cache buffer size used by internal copy function (no defragmentation);
@@ -702,6 +856,28 @@ extern bool_t NvIsDataSetDirty
     void* ptrData
 );
 
+/******************************************************************************
+ * Name: NvSetDeltaRecords
+ * Description: Selects the record format of the full saves of a data set
+ *              mirrored in RAM, see gNvDeltaRecords_Enabled_d. The selection
+ *              is kept in RAM only; the delta records already in storage are
+ *              restored either way.
+ * Parameters: [IN] ptrData - pointer to the data set
+ *             [IN] enable - TRUE to write delta records, FALSE to write full
+ *                           records
+ * Return: gNVM_OK_c - if the operation completes successfully
+ *         gNVM_NullPointer_c - if a NULL pointer is provided
+ *         gNVM_PointerOutOfRange_c - if the pointer is not in the RAM table
+ *         gNVM_InvalidTableEntry_c - if the data set is not mirrored in RAM
+ *         gNVM_Error_c - if gNvDeltaEntriesCount_c data sets are already
+ *                        selected or the delta records are disabled
+ ******************************************************************************/
+extern NVM_Status_t NvSetDeltaRecords
+(
+    void* ptrData,
+    bool_t enable
+);
+
 
 /******************************************************************************
  * Name: NvGetStatistics
@@ -716,6 +892,20 @@ extern void NvGetPagesStatistics
     NVM_Statistics_t* ptrStat 
 );
 
+/******************************************************************************
+ * Name: NvGetSectorEraseCycles
+ * Description: Returns the erase cycles count of a NV storage sector. The
+ *              count is estimated on boot from the page counter and tracked
+ *              afterwards.
+ * Parameter(s): [IN] sectorIndex - the index of the sector, counted from the
+ *                                  start of the NV storage
+ * Return: the erase cycles count, 0 if the sector is not used by the NVM
+ *****************************************************************************/
+extern uint32_t NvGetSectorEraseCycles
+(
+    uint32_t sectorIndex
+);
+
 
 /******************************************************************************
  * Name: NvFormat
@@ -69,7 +69,11 @@
  * Name: gNvVirtualPagesCount_c
  * Description: the count of virtual pages used
  */
-#define gNvVirtualPagesCount_c         2 /* DO NOT MODIFY */
+#define gNvVirtualPagesCount_c         gNvRingPagesCount_d
+
+ #if (gNvVirtualPagesCount_c < 2) || (gNvVirtualPagesCount_c > 32)
+   #error "*** ERROR: gNvRingPagesCount_d should be between 2 and 32"
+ #endif
 
 /*
  * Name: gNvGuardValue_c
@@ -99,6 +103,59 @@
  */
 #define gNvLegacyOffset_c 4
 
+/*
+ * Name: gNvUseMetaIndex_c
+ * Description: the meta information index is available only for the
+ *              virtual pages based storage (no FlexNVM)
+ */
+#if gNvMetaIndex_Enabled_d && ((gNvUseFlexNVM_d == FALSE) || (DEBLOCK_SIZE == 0))
+#define gNvUseMetaIndex_c 1
+#else
+#define gNvUseMetaIndex_c 0
+#endif
+
+/*
+ * Name: gNvUseCommitEngine_c
+ * Description: the commit engine is available only for the virtual pages
+ *              based storage (no FlexNVM)
+ */
+#if gNvCommitEngine_Enabled_d && ((gNvUseFlexNVM_d == FALSE) || (DEBLOCK_SIZE == 0))
+#define gNvUseCommitEngine_c 1
+#else
+#define gNvUseCommitEngine_c 0
+#endif
+
+/*
+ * Name: gNvUseRing_c
+ * Description: the virtual pages form a ring, see gNvRingPagesCount_d
+ */
+#if (gNvVirtualPagesCount_c > 2) && ((gNvUseFlexNVM_d == FALSE) || (DEBLOCK_SIZE == 0))
+#define gNvUseRing_c 1
+#else
+#define gNvUseRing_c 0
+#endif
+
+/*
+ * Name: gNvUseDeltaRecords_c
+ * Description: the delta records are available only for the virtual pages
+ *              based storage (no FlexNVM)
+ */
+#if gNvDeltaRecords_Enabled_d && ((gNvUseFlexNVM_d == FALSE) || (DEBLOCK_SIZE == 0))
+#define gNvUseDeltaRecords_c 1
+#else
+#define gNvUseDeltaRecords_c 0
+#endif
+
+/*
+ * Name: NvIsPageKnownBlank
+ * Description: TRUE if a ring page is known to be blank, without a blank check
+ */
+#if gNvUseRing_c
+#define NvIsPageKnownBlank(pageID)     (0 != (mNvRingBlankPages & (1UL << (pageID))))
+#else
+#define NvIsPageKnownBlank(pageID)     FALSE
+#endif
+
 #endif /* gNvStorageIncluded_d */
 /*****************************************************************************
  *****************************************************************************
@@ -621,13 +678,15 @@ static NVM_Status_t NvInternalCopy
  *               [IN] dataEntryId - table entry ID
  * Return: the value of the meta address
  *****************************************************************************/
-#if gNvFragmentation_Enabled_d
+#if gNvFragmentation_Enabled_d || gNvUseDeltaRecords_c
 static uint32_t NvGetTblEntryMetaAddrFromId
 (
   uint32_t searchStartAddress,
   uint16_t dataEntryId
 );
+#endif
 
+#if gNvFragmentation_Enabled_d
 
 /******************************************************************************
  * Name: NvInternalDefragmentedCopy
@@ -650,6 +709,412 @@ static NVM_Status_t NvInternalDefragmentedCopy
 );
 #endif /* #if gNvFragmentation_Enabled_d */
 
+#if gNvUseDeltaRecords_c
+/******************************************************************************
+ * Name: NvDeltaIsEnabled
+ * Description: Checks if the full saves of a table entry are written as
+ *              delta records, see NvSetDeltaRecords()
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: TRUE if delta records are written, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvDeltaIsEnabled
+(
+  uint16_t tableEntryIdx
+);
+
+/******************************************************************************
+ * Name: NvDeltaIsUsed
+ * Description: Checks if the records of a table entry must be read through
+ *              its delta chain
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: TRUE if the delta chain must be followed, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvDeltaIsUsed
+(
+  uint16_t tableEntryIdx
+);
+
+/******************************************************************************
+ * Name: NvDeltaGetChain
+ * Description: Gets the latest full record of a table entry and counts the
+ *              delta records written after it
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ *               [OUT] pFullMetaAddress - the full record meta address, 0 if
+ *                                        the entry has no full record
+ *               [OUT] pLastMetaAddress - the newest meta that may belong to
+ *                                        the entry
+ * Return: the count of delta records newer than the full record
+ *****************************************************************************/
+static uint16_t NvDeltaGetChain
+(
+  uint16_t tableEntryIdx,
+  uint32_t* pFullMetaAddress,
+  uint32_t* pLastMetaAddress
+);
+
+/******************************************************************************
+ * Name: NvDeltaReadImage
+ * Description: Reads a window of a table entry image: the latest full record
+ *              with the newer delta and single records applied, in the order
+ *              they were written
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ *               [IN] fullMetaAddress - the full record meta address
+ *               [IN] lastMetaAddress - the newest meta to apply
+ *               [IN] offset - the window offset in the image
+ *               [IN] length - the window length
+ *               [OUT] pDst - the window image
+ * Return: -
+ *****************************************************************************/
+static void NvDeltaReadImage
+(
+  uint16_t tableEntryIdx,
+  uint32_t fullMetaAddress,
+  uint32_t lastMetaAddress,
+  uint32_t offset,
+  uint32_t length,
+  uint8_t* pDst
+);
+
+/******************************************************************************
+ * Name: NvDeltaApply
+ * Description: Applies the part of a delta record that falls in a window of
+ *              the table entry image
+ * Parameter(s): [IN] recordAddress - the delta record address
+ *               [IN] recordSize - the delta record size
+ *               [IN] offset - the window offset in the image
+ *               [IN] length - the window length
+ *               [IN/OUT] pDst - the window image
+ * Return: -
+ *****************************************************************************/
+static void NvDeltaApply
+(
+  uint32_t recordAddress,
+  uint16_t recordSize,
+  uint32_t offset,
+  uint32_t length,
+  uint8_t* pDst
+);
+
+/******************************************************************************
+ * Name: NvDeltaPutRun
+ * Description: Appends a run of changed bytes to the delta record buffer
+ * Parameter(s): [IN/OUT] pRecordSize - the delta record size
+ *               [IN] skip - the count of unchanged bytes before the run
+ *               [IN] pRun - the run bytes
+ *               [IN] runSize - the run size, up to gNvDeltaRunSizeMax_c
+ * Return: FALSE if the delta record buffer is full, TRUE otherwise
+ *****************************************************************************/
+static bool_t NvDeltaPutRun
+(
+  uint16_t* pRecordSize,
+  uint32_t skip,
+  uint8_t* pRun,
+  uint16_t runSize
+);
+
+/******************************************************************************
+ * Name: NvDeltaPrepare
+ * Description: Builds the delta record of a full save in maNvDeltaRecord,
+ *              against the table entry image in storage
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ *               [OUT] pRecordSize - the delta record size, 0 if the image in
+ *                                   storage is up to date
+ * Return: TRUE if the delta record is to be written, FALSE if a full record
+ *         is to be written instead
+ *****************************************************************************/
+static bool_t NvDeltaPrepare
+(
+  uint16_t tableEntryIdx,
+  uint16_t* pRecordSize
+);
+
+/******************************************************************************
+ * Name: NvDeltaCopy
+ * Description: Writes the image of a table entry, see NvDeltaReadImage(), as
+ *              a full record of the destination page
+ * Parameter(s): [IN] srcMetaAddr - the newest source meta of the entry
+ *               [IN] fullMetaAddr - the latest source full record meta
+ *               [IN] srcTblEntryIdx - source page table entry index
+ *               [IN] dstMetaAddr - destination meta address
+ *               [IN] dstRecordAddr - destination record address (to copy to)
+ *               [IN] size - the bytes taken from the source page; the rest
+ *                           of the RAM table entry is taken from RAM
+ * Return: the status of the operation
+ *****************************************************************************/
+static NVM_Status_t NvDeltaCopy
+(
+  uint32_t srcMetaAddr,
+  uint32_t fullMetaAddr,
+  uint16_t srcTblEntryIdx,
+  uint32_t dstMetaAddr,
+  uint32_t dstRecordAddr,
+  uint32_t size
+);
+#endif /* gNvUseDeltaRecords_c */
+
+#if gNvUseMetaIndex_c
+/******************************************************************************
+ * Name: NvMetaIndexReset
+ * Description: Clears the meta information index and assigns the element
+ *              slots to the RAM table entries
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvMetaIndexReset
+(
+  void
+);
+
+/******************************************************************************
+ * Name: NvMetaIndexAdd
+ * Description: Records a valid meta information tag of the active page
+ * Parameter(s): [IN] metaAddress - the meta information address
+ *               [IN] pMetaInfo - a pointer to the meta information
+ * Return: -
+ *****************************************************************************/
+static void NvMetaIndexAdd
+(
+  uint32_t metaAddress,
+  NVM_RecordMetaInfo_t* pMetaInfo
+);
+
+/******************************************************************************
+ * Name: NvMetaIndexGetEntry
+ * Description: Gets the meta information index entry of a table entry
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: a pointer to the index entry or NULL if the entry is not indexed
+ *****************************************************************************/
+static NVM_MetaIndexEntry_t* NvMetaIndexGetEntry
+(
+  uint16_t tableEntryIdx
+);
+
+/******************************************************************************
+ * Name: NvMetaIndexGetLatest
+ * Description: Gets the newest meta holding the value of an element
+ * Parameter(s): [IN] pEntry - the index entry
+ *               [IN] elementIndex - the element index
+ * Return: the meta information address or 0 if none exists
+ *****************************************************************************/
+static uint32_t NvMetaIndexGetLatest
+(
+  NVM_MetaIndexEntry_t* pEntry,
+  uint16_t elementIndex
+);
+
+/******************************************************************************
+ * Name: NvMetaIndexIsRecordCopied
+ * Description: Index based replacement of NvIsRecordCopied()
+ * Parameter(s): [IN] tableEntryIdx - source table entry index
+ *               [IN] pageId - the ID of the destination page
+ *               [IN] metaInf - a pointer to source page meta information tag
+ * Return: TRUE if the element is already copied, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvMetaIndexIsRecordCopied
+(
+  uint16_t tableEntryIdx,
+  NVM_VirtualPageID_t pageId,
+  NVM_RecordMetaInfo_t* metaInf
+);
+
+/******************************************************************************
+ * Name: NvMetaIndexSetCopied
+ * Description: Marks a record as written to the destination page
+ * Parameter(s): [IN] tableEntryIdx - source table entry index
+ *               [IN] elementIndex - the element index or
+ *                                   gNvInvalidElementIndex_c for a full record
+ * Return: -
+ *****************************************************************************/
+static void NvMetaIndexSetCopied
+(
+  uint16_t tableEntryIdx,
+  uint16_t elementIndex
+);
+
+/******************************************************************************
+ * Name: NvMetaIndexClearCopied
+ * Description: Forgets the records written to the destination page
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvMetaIndexClearCopied
+(
+  void
+);
+
+#if gNvFragmentation_Enabled_d
+/******************************************************************************
+ * Name: NvMetaIndexGetRecordsOffsets
+ * Description: Fills maNvRecordsCpyOffsets with the single records newer
+ *              than the owner full record
+ * Parameter(s): [IN] srcTblEntryIdx - source page table entry index
+ *               [IN] ownerMetaAddr - the owner full record meta address
+ *               [IN] srcMetaAddr - source page meta address
+ * Return: TRUE if the offsets were taken from the index, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvMetaIndexGetRecordsOffsets
+(
+  uint16_t srcTblEntryIdx,
+  uint32_t ownerMetaAddr,
+  uint32_t srcMetaAddr
+);
+#endif /* gNvFragmentation_Enabled_d */
+#endif /* gNvUseMetaIndex_c */
+
+#if gNvUseCommitEngine_c
+/******************************************************************************
+ * Name: NvCommitReset
+ * Description: Clears the commit engine state and assigns the dirty bitmap
+ *              element slots to the RAM table entries
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvCommitReset
+(
+  void
+);
+
+/******************************************************************************
+ * Name: NvCommitGetEntry
+ * Description: Gets the commit engine state of a table entry
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: a pointer to the entry state or NULL if the entry is not tracked
+ *****************************************************************************/
+static NVM_CommitEntry_t* NvCommitGetEntry
+(
+  uint16_t tableEntryIdx
+);
+
+/******************************************************************************
+ * Name: NvCommitMarkDirty
+ * Description: Marks the data set of a save request dirty
+ * Parameter(s): [IN] ptrTblIdx - pointer to table index
+ * Return: TRUE if the request was taken, FALSE if it must be queued
+ *****************************************************************************/
+static bool_t NvCommitMarkDirty
+(
+  NVM_TableEntryInfo_t* ptrTblIdx
+);
+
+/******************************************************************************
+ * Name: NvCommitClear
+ * Description: Cancels the pending save of an element or of a table entry
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ *               [IN] elementIndex - the element index or
+ *                                   gNvInvalidElementIndex_c for the entire entry
+ * Return: -
+ *****************************************************************************/
+static void NvCommitClear
+(
+  uint16_t tableEntryIdx,
+  uint16_t elementIndex
+);
+
+/******************************************************************************
+ * Name: NvCommitClearAll
+ * Description: Cancels all the pending saves, except for the unmirrored
+ *              elements erase operations
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvCommitClearAll
+(
+  void
+);
+
+/******************************************************************************
+ * Name: NvCommitIsDirty
+ * Description: Checks if a table entry has pending saves
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: TRUE if the table entry is dirty, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvCommitIsDirty
+(
+  uint16_t tableEntryIdx
+);
+
+/******************************************************************************
+ * Name: NvCommitFlush
+ * Description: Writes all the dirty data sets
+ * Parameter(s): -
+ * Return: gNVM_OK_c - if all the data sets were written
+ *         gNVM_PageCopyPending_c - if a page copy is needed first
+ *         Note: see also return codes of NvWriteRecord() function
+ *****************************************************************************/
+static NVM_Status_t NvCommitFlush
+(
+  void
+);
+
+/******************************************************************************
+ * Name: NvWriteRecords
+ * Description: Writes several records and their meta information tags
+ * Parameter(s): [IN] pBatch - the records table and element indexes
+ *               [IN] count - the number of records
+ *               [OUT] pWritten - the number of records written
+ * Return: gNVM_OK_c - if all the records were written
+ *         gNVM_PageCopyPending_c - if the active page is full
+ *         Note: see also return codes of NvWriteRecord() function
+ *****************************************************************************/
+static NVM_Status_t NvWriteRecords
+(
+  NVM_TableEntryInfo_t* pBatch,
+  uint16_t count,
+  uint16_t* pWritten
+);
+#endif /* gNvUseCommitEngine_c */
+
+/******************************************************************************
+ * Name: NvSchedulePageErase
+ * Description: Requests the erase of a virtual page, to be done sector by
+ *              sector in the idle task
+ * Parameter(s): [IN] pageID - the ID of the page to be erased
+ * Return: -
+ *****************************************************************************/
+static void NvSchedulePageErase
+(
+  NVM_VirtualPageID_t pageID
+);
+
+/******************************************************************************
+ * Name: NvPageErased
+ * Description: Updates the erase cycles and the ring state of a virtual page
+ *              which has been entirely erased
+ * Parameter(s): [IN] pageID - the ID of the erased page
+ * Return: -
+ *****************************************************************************/
+static void NvPageErased
+(
+  NVM_VirtualPageID_t pageID
+);
+
+/******************************************************************************
+ * Name: NvInitEraseCycles
+ * Description: Estimates the erase cycles of the virtual pages from the page
+ *              counter of the active page
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvInitEraseCycles
+(
+  void
+);
+
+#if gNvUseRing_c
+/******************************************************************************
+ * Name: NvRingInit
+ * Description: Finds the ring pages, other than the active one and the one
+ *              holding an interrupted page copy, which are not blank and
+ *              requests their erase
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvRingInit
+(
+  void
+);
+#endif /* gNvUseRing_c */
+
 
 /******************************************************************************
  * Name: NvCopyPage
@@ -659,7 +1124,7 @@ static NVM_Status_t NvInternalDefragmentedCopy
  *              saved priori and newer than the table entry. If one or more
  *              elements were singular saved and the NV page doesn't has a
  *              full table entry saved, then the elements are copied as they
- *              are.
+ *              are. A copy started by the idle task is completed.
  * Parameter(s): [IN] skipEntryId - the entry ID to be skipped when page
  *                                  copy is performed
  * Return: gNVM_InvalidPageID_c - if the source or destination page is not
@@ -675,6 +1140,72 @@ static NVM_Status_t NvCopyPage
   NvTableEntryId_t skipEntryId
 );
 
+/******************************************************************************
+ * Name: NvCopyPageSlice
+ * Description: Starts or continues a page copy, see NvCopyPage(). When
+ *              sliced, at most gNvCopySliceRecordsCount_c records or
+ *              gNvCopySliceBytesCount_c bytes are written per call and the
+ *              last call only commits the copy.
+ * Parameter(s): [IN] skipEntryId - the entry ID to be skipped when page
+ *                                  copy is performed
+ *               [IN] sliced - TRUE to write only a part of the copy
+ * Return: gNVM_PageCopyPending_c - if the copy is not completed yet
+ *         the NvCopyPage() return values otherwise
+ *****************************************************************************/
+static NVM_Status_t NvCopyPageSlice
+(
+  NvTableEntryId_t skipEntryId,
+  bool_t sliced
+);
+
+/******************************************************************************
+ * Name: NvCopyPageStart
+ * Description: Prepares the destination page of a page copy
+ * Parameter(s): [IN] skipEntryId - the entry ID to be skipped when page
+ *                                  copy is performed
+ * Return: gNVM_OK_c or the NvEraseVirtualPage() errors
+ *****************************************************************************/
+static NVM_Status_t NvCopyPageStart
+(
+  NvTableEntryId_t skipEntryId
+);
+
+/******************************************************************************
+ * Name: NvCopyPageRecords
+ * Description: Writes the records of the page copy to the destination page
+ * Parameter(s): [IN] sliced - TRUE to stop after a slice of records
+ * Return: gNVM_PageCopyPending_c - if records are left to be copied
+ *         gNVM_OK_c - if all the records were copied
+ *         the NvCopyPage() errors otherwise
+ *****************************************************************************/
+static NVM_Status_t NvCopyPageRecords
+(
+  bool_t sliced
+);
+
+/******************************************************************************
+ * Name: NvCopyPageCommit
+ * Description: Makes the destination page of the page copy the active one
+ * Parameter(s): -
+ * Return: gNVM_OK_c or gNVM_Error_c if the RAM table couldn't be written
+ *****************************************************************************/
+static NVM_Status_t NvCopyPageCommit
+(
+  void
+);
+
+/******************************************************************************
+ * Name: NvCopyPageFindInterrupted
+ * Description: Looks for a page copy interrupted by a reset, for it to be
+ *              resumed by the idle task
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvCopyPageFindInterrupted
+(
+  void
+);
+
 
 /******************************************************************************
  * Name: NvInternalFormat
@@ -967,10 +1498,60 @@ static bool_t mNvCopyOperationIsPending = FALSE;
 static NVM_ErasePageCmdStatus_t mNvErasePgCmdStatus;
 
 /*
- * Name: mNvFlashConfigInitialised
- * Description: variable that holds the hal driver and active page initialisation status
+ * Name: maNvPageEraseCycles
+ * Description: the erase cycles of each virtual page; all the sectors of a
+ *              page are erased together
  */
-static bool_t mNvFlashConfigInitialised = FALSE;
+static uint32_t maNvPageEraseCycles[gNvVirtualPagesCount_c];
+
+#if gNvUseRing_c
+/*
+ * Name: mNvRingBlankPages
+ * Description: bitmap of the ring pages known to be blank, which can be
+ *              used as page copy destination without a blank check
+ */
+static uint32_t mNvRingBlankPages;
+
+/*
+ * Name: mNvRingStalePages
+ * Description: bitmap of the ring pages waiting for their erase, while
+ *              another page is being erased by the idle task
+ */
+static uint32_t mNvRingStalePages;
+#endif /* gNvUseRing_c */
+
+/*
+ * Name: mNvCopyState
+ * Description: the progress of the page copy, which is done in slices by
+ *              the idle task
+ */
+static NVM_CopyPageState_t mNvCopyState;
+
+#if gNvUseDeltaRecords_c
+/*
+ * Name: maNvDeltaEntryIds
+ * Description: the IDs of the data sets written with delta records
+ */
+static NvTableEntryId_t maNvDeltaEntryIds[gNvDeltaEntriesCount_c];
+
+/*
+ * Name: mNvDeltaEntriesCount
+ * Description: the count of IDs in maNvDeltaEntryIds
+ */
+static uint16_t mNvDeltaEntriesCount;
+
+/*
+ * Name: maNvDeltaRecord
+ * Description: the delta record being written
+ */
+static uint8_t maNvDeltaRecord[gNvDeltaRecordMaxSize_c];
+#endif /* gNvUseDeltaRecords_c */
+
+/*
+ * Name: mNvFlashConfigInitialised
+ * Description: variable that holds the hal driver and active page initialisation status
+ */
+static bool_t mNvFlashConfigInitialised = FALSE;
 
 /*
  * Name: maNvRecordsCpyIdx
@@ -981,6 +1562,82 @@ static bool_t mNvFlashConfigInitialised = FALSE;
 static uint16_t maNvRecordsCpyOffsets[gNvRecordsCopiedBufferSize_c];
 #endif /* gNvFragmentation_Enabled_d */
 
+#if gNvUseMetaIndex_c
+/*
+ * Name: maNvMetaIndex
+ * Description: meta information index of the active page, one entry for
+ *              each RAM table entry
+ */
+static NVM_MetaIndexEntry_t maNvMetaIndex[gNvTableEntriesCountMax_c];
+
+/*
+ * Name: maNvMetaIndexSlots
+ * Description: the offset of the latest single record meta of each indexed
+ *              element; the elements of an entry are stored starting with
+ *              the entry's firstElementSlot
+ */
+static uint16_t maNvMetaIndexSlots[gNvMetaIndexElementsCount_c];
+
+/*
+ * Name: maNvMetaIndexCopied
+ * Description: bitmap of the element slots whose single record was
+ *              written to the destination page during page copy
+ */
+static uint8_t maNvMetaIndexCopied[(gNvMetaIndexElementsCount_c + 7) / 8];
+
+/*
+ * Name: mNvMetaIndexPageId
+ * Description: the ID of the page described by the meta information index
+ */
+static NVM_VirtualPageID_t mNvMetaIndexPageId = gVirtualPageNone_c;
+#endif /* gNvUseMetaIndex_c */
+
+#if gNvUseCommitEngine_c
+/*
+ * Name: maNvCommitEntries
+ * Description: commit engine state, one entry for each RAM table entry
+ */
+static NVM_CommitEntry_t maNvCommitEntries[gNvTableEntriesCountMax_c];
+
+/*
+ * Name: maNvCommitDirty
+ * Description: bitmap of the element slots that have a pending save
+ */
+static uint8_t maNvCommitDirty[(gNvCommitElementsCount_c + 7) / 8];
+
+/*
+ * Name: mNvCommitDirtyCount
+ * Description: the number of dirty table entries
+ */
+static uint16_t mNvCommitDirtyCount;
+
+/*
+ * Name: mNvCommitTicksLeft
+ * Description: save-on-interval timer ticks left until the dirty data sets
+ *              are written
+ */
+static NvSaveInterval_t mNvCommitTicksLeft;
+
+/*
+ * Name: maNvCommitBatch
+ * Description: the records selected for the next write
+ */
+static NVM_TableEntryInfo_t maNvCommitBatch[gNvCommitBatchSize_c];
+
+/*
+ * Name: maNvCommitRecords
+ * Description: the records being written
+ */
+static NVM_CommitRecord_t maNvCommitRecords[gNvCommitBatchSize_c];
+
+/*
+ * Name: maNvCommitMetas
+ * Description: the meta information tags of the records being written,
+ *              programmed with a single flash operation
+ */
+static NVM_RecordMetaInfo_t maNvCommitMetas[gNvCommitBatchSize_c];
+#endif /* gNvUseCommitEngine_c */
+
 #if gNvUseExtendedFeatureSet_d
 /*
  * Name: mNvTableSizeInFlash
@@ -1321,6 +1978,9 @@ static NVM_Status_t __NvEraseEntryFromStorage
             }
         }
     }
+    #if gNvUseCommitEngine_c
+    NvCommitClear(tableEntryIndex, gNvInvalidElementIndex_c);
+    #endif
     maDatasetInfo[tableEntryIndex].countsToNextSave = gNvCountsBetweenSaves;
     maDatasetInfo[tableEntryIndex].saveNextInterval = FALSE;
 
@@ -1624,6 +2284,9 @@ static NVM_Status_t __NvAtomicSave
     }
 #else
     NvInitPendingSavesQueue(&mNvPendingSavesQueue);
+#endif
+#if gNvUseCommitEngine_c
+    NvCommitClearAll();
 #endif
     /* if critical section, add a special entry in the queue */
     if (mNvCriticalSectionFlag)
@@ -1754,15 +2417,24 @@ static NVM_Status_t __NvSyncSave
         }
         mNvCopyOperationIsPending = FALSE;
 
+        #if !gNvUseRing_c
         /* erase old page */
         status = NvEraseVirtualPage(mNvErasePgCmdStatus.NvPageToErase);
         if (gNVM_OK_c != status)
             return status;
         mNvVirtualPageProperty[mNvErasePgCmdStatus.NvPageToErase].NvLastMetaInfoAddress = gEmptyPageMetaAddress_c;
         mNvErasePgCmdStatus.NvErasePending = FALSE;
+        #endif /* the old ring page is erased in the idle task */
         /* write record */
         status = NvWriteRecord(&tblIdx);
     }
+    #if gNvUseCommitEngine_c
+    if(gNVM_OK_c == status)
+    {
+        /* the data set is saved, drop its pending save */
+        NvCommitClear(NvGetTableEntryIndexFromId(tblIdx.entryId), tblIdx.saveRestoreAll ? gNvInvalidElementIndex_c : tblIdx.elementIndex);
+    }
+    #endif
 #else /* FlexNVM */
     /* write record */
     status = NvWriteRecord(&tblIdx);
@@ -1838,6 +2510,9 @@ static NVM_Status_t __NvFormat
     #endif
     /* clear the save queue */
     NvInitPendingSavesQueue(&mNvPendingSavesQueue);
+    #if gNvUseCommitEngine_c
+    NvCommitReset();
+    #endif
     return status;
 
 #else /* FlexNVM */
@@ -1892,18 +2567,33 @@ static void __NvIdle
     }
 
     #if (gNvUseFlexNVM_d == FALSE) || ((gNvUseFlexNVM_d == TRUE) && (DEBLOCK_SIZE == 0)) /* no FlexNVM */
-    if(mNvCopyOperationIsPending)
+    /* a copy to a page being erased waits for the erase, done below */
+    if(mNvCopyOperationIsPending &&
+       !(mNvErasePgCmdStatus.NvErasePending &&
+         (mNvErasePgCmdStatus.NvPageToErase == (mNvActivePageId+1)%gNvVirtualPagesCount_c)))
     {
         #if (gFsciIncluded_c && gNvmEnableFSCIMonitoring_c)
+        if(!mNvCopyState.inProgress)
+        {
             FSCI_MsgNVVirtualPageMonitoring(TRUE,gNVM_OK_c);
-            FSCI_MsgNVVirtualPageMonitoring(FALSE,status = NvCopyPage(gNvCopyAll_c));
+        }
+        status = NvCopyPageSlice(gNvCopyAll_c, (gNvCopySliceRecordsCount_c > 0));
+        if(gNVM_PageCopyPending_c != status)
+        {
+            FSCI_MsgNVVirtualPageMonitoring(FALSE,status);
+        }
         #else
-            status = NvCopyPage(gNvCopyAll_c);
+        status = NvCopyPageSlice(gNvCopyAll_c, (gNvCopySliceRecordsCount_c > 0));
         #endif
         if (gNVM_OK_c == status)
         {
             mNvCopyOperationIsPending = FALSE;
         }
+        if ((gNVM_OK_c == status) || (gNVM_PageCopyPending_c == status))
+        {
+            /* one slice of the copy per call */
+            return;
+        }
     }
 
     if(mNvErasePgCmdStatus.NvErasePending)
@@ -1916,6 +2606,8 @@ static void __NvIdle
             #if (gFsciIncluded_c && gNvmEnableFSCIMonitoring_c)
             FSCI_MsgNVPageEraseMonitoring(mNvVirtualPageProperty[mNvErasePgCmdStatus.NvPageToErase].NvRawSectorStartAddress, gNVM_OK_c);
             #endif
+            /* also starts the erase of the next stale ring page */
+            NvPageErased(mNvErasePgCmdStatus.NvPageToErase);
             return;
         }
 
@@ -1965,6 +2657,14 @@ static void __NvIdle
             #endif
         }
     }
+
+    #if gNvUseCommitEngine_c
+    /* write the dirty data sets, once their deadline has passed */
+    if(mNvCommitDirtyCount && !mNvCommitTicksLeft)
+    {
+        (void)NvCommitFlush();
+    }
+    #endif
 }
 /******************************************************************************
  * Name: __NvIsDataSetDirty
@@ -2027,6 +2727,12 @@ bool_t __NvIsDataSetDirty
                 }
             }
         }
+        #if gNvUseCommitEngine_c
+        if(NvCommitIsDirty(tableEntryIdx))
+        {
+            return TRUE;
+        }
+        #endif
         return maDatasetInfo[tableEntryIdx].saveNextInterval;
     }
 }
@@ -2168,6 +2874,13 @@ static bool_t __NvTimerTick
                     tblIdx.saveRestoreAll = TRUE;
                 }
                 maDatasetInfo[idx].saveNextInterval = FALSE;
+                #if gNvUseCommitEngine_c
+                /* written together with the other dirty data sets on NvIdle() */
+                if (NvAddSaveRequestToQueue(&tblIdx) == gNVM_SaveRequestRejected_c)
+                {
+                    maDatasetInfo[idx].saveNextInterval = TRUE;
+                }
+                #else
                 if(!mNvCriticalSectionFlag)
                 {
                     #if (gNvUseFlexNVM_d == FALSE) || ((gNvUseFlexNVM_d == TRUE) && (DEBLOCK_SIZE == 0)) /* no FlexNVM */
@@ -2191,12 +2904,23 @@ static bool_t __NvTimerTick
                         maDatasetInfo[idx].saveNextInterval = TRUE;
                 }
             }
+                #endif
         }
         }
 
         /* increment the loop counter */
         idx++;
     }
+    #if gNvUseCommitEngine_c && gNvCommitDeadlineTicks_c
+    if(countTick && mNvCommitTicksLeft)
+    {
+        --mNvCommitTicksLeft;
+    }
+    if(mNvCommitTicksLeft)
+    {
+        fTicksLeft = TRUE;
+    }
+    #endif
     if (fTicksLeft && !TMR_IsTimerActive(mNvSaveOnIntervalTimerID))
     {
         timerJitter = GetRandomRange(0,255);
@@ -2457,6 +3181,9 @@ static NVM_Status_t __NvModuleInit
     
     /* Initialize the pending saves queue */
     NvInitPendingSavesQueue(&mNvPendingSavesQueue);
+    #if gNvUseCommitEngine_c
+    NvCommitReset();
+    #endif
     
     /* Initialize the data set info table */
     for(loopCnt = 0; loopCnt < (index_t)gNvTableEntriesCountMax_c; loopCnt++)
@@ -2499,8 +3226,8 @@ static NVM_Status_t __NvModuleInit
     
 #else /* no FlexNVM */
     
-    /* check linker file symbol definition for sector count; it should be multiple of 2 */
-    if (((uint32_t)NV_STORAGE_MAX_SECTORS) & 0x1)
+    /* check linker file symbol definition for sector count; it should be multiple of the virtual pages count */
+    if (((uint32_t)NV_STORAGE_MAX_SECTORS) % gNvVirtualPagesCount_c)
     {
         return gNVM_InvalidSectorsCount_c;
     }
@@ -2568,7 +3295,8 @@ static NVM_Status_t __NvModuleInit
         {
             return status;
         }
-        if(pageFreeSpace < gNvMinimumFreeBytesCountStart_c )
+        /* a page copy interrupted by a reset is resumed by the idle task */
+        if((pageFreeSpace < gNvMinimumFreeBytesCountStart_c) && !mNvCopyOperationIsPending)
         {
 #if (gFsciIncluded_c && gNvmEnableFSCIMonitoring_c)
             FSCI_MsgNVVirtualPageMonitoring(TRUE,gNVM_OK_c);
@@ -2773,6 +3501,9 @@ static NVM_Status_t __NvmMoveToRam
                 }
             }
         }
+        #if gNvUseCommitEngine_c
+        NvCommitClear(tableEntryIndex, tblIdx.elementIndex);
+        #endif
         maDatasetInfo[tableEntryIndex].saveNextInterval = FALSE;
         return gNVM_OK_c;
     }
@@ -2863,6 +3594,9 @@ static NVM_Status_t __NvmErase
             }
         }
     }
+    #if gNvUseCommitEngine_c
+    NvCommitClear(tableEntryIndex, tblIdx.elementIndex);
+    #endif
     OSA_InterruptDisable();
     *ppData = NULL;
     OSA_InterruptEnable();
@@ -3036,6 +3770,8 @@ static void InitNVMConfig
     void
 )
 {
+    uint32_t pageId;
+
     if (mNvFlashConfigInitialised)
         return;
     /* Initialize flash HAL driver */
@@ -3047,21 +3783,24 @@ static void InitNVMConfig
     /* Initialize the active page ID */
     mNvActivePageId = gVirtualPageNone_c;
 
-    /* First virtual page initialisation */
-    mNvVirtualPageProperty[gFirstVirtualPage_c].NvRawSectorStartAddress = (uint32_t)((uint8_t*)NV_STORAGE_END_ADDRESS);
-    mNvVirtualPageProperty[gFirstVirtualPage_c].NvRawSectorsCount = (uint32_t)((uint8_t*) NV_STORAGE_MAX_SECTORS) >> 1;
-    mNvVirtualPageProperty[gFirstVirtualPage_c].NvTotalPageSize = mNvVirtualPageProperty[gFirstVirtualPage_c].NvRawSectorsCount *
-        (uint32_t)((uint8_t*)NV_STORAGE_SECTOR_SIZE);
-    mNvVirtualPageProperty[gFirstVirtualPage_c].NvRawSectorEndAddress = mNvVirtualPageProperty[gFirstVirtualPage_c].NvRawSectorStartAddress +
-        mNvVirtualPageProperty[gFirstVirtualPage_c].NvTotalPageSize - 1;
-
-    /* Second virtual page initialisation */
-    mNvVirtualPageProperty[gSecondVirtualPage_c].NvRawSectorStartAddress = mNvVirtualPageProperty[gFirstVirtualPage_c].NvRawSectorEndAddress + 1;
-    mNvVirtualPageProperty[gSecondVirtualPage_c].NvRawSectorsCount = (uint32_t)((uint8_t*) NV_STORAGE_MAX_SECTORS) >> 1;
-    mNvVirtualPageProperty[gSecondVirtualPage_c].NvTotalPageSize = mNvVirtualPageProperty[gSecondVirtualPage_c].NvRawSectorsCount *
-        (uint32_t)((uint8_t*)NV_STORAGE_SECTOR_SIZE);
-    mNvVirtualPageProperty[gSecondVirtualPage_c].NvRawSectorEndAddress = mNvVirtualPageProperty[gSecondVirtualPage_c].NvRawSectorStartAddress +
-        mNvVirtualPageProperty[gSecondVirtualPage_c].NvTotalPageSize - 1;
+    /* virtual pages initialisation: the storage sectors are split evenly */
+    for(pageId = gFirstVirtualPage_c; pageId < gNvVirtualPagesCount_c; pageId++)
+    {
+        mNvVirtualPageProperty[pageId].NvRawSectorStartAddress = (uint32_t)((uint8_t*)NV_STORAGE_END_ADDRESS);
+        if(pageId != gFirstVirtualPage_c)
+        {
+            mNvVirtualPageProperty[pageId].NvRawSectorStartAddress = mNvVirtualPageProperty[pageId-1].NvRawSectorEndAddress + 1;
+        }
+        mNvVirtualPageProperty[pageId].NvRawSectorsCount = (uint32_t)((uint8_t*) NV_STORAGE_MAX_SECTORS) / gNvVirtualPagesCount_c;
+        mNvVirtualPageProperty[pageId].NvTotalPageSize = mNvVirtualPageProperty[pageId].NvRawSectorsCount *
+            (uint32_t)((uint8_t*)NV_STORAGE_SECTOR_SIZE);
+        mNvVirtualPageProperty[pageId].NvRawSectorEndAddress = mNvVirtualPageProperty[pageId].NvRawSectorStartAddress +
+            mNvVirtualPageProperty[pageId].NvTotalPageSize - 1;
+    }
+    #if gNvUseRing_c
+    mNvRingBlankPages = 0;
+    mNvRingStalePages = 0;
+    #endif
 
     /* Initialize the storage system: get active page and page counter */
     NvInitStorageSystem(FALSE);
@@ -3080,6 +3819,11 @@ static void InitNVMConfig
         mNvTableSizeInFlash = NvGetFlashTableSize();
     }
     #endif
+    NvCopyPageFindInterrupted();
+    #if gNvUseRing_c
+    NvRingInit();
+    #endif
+    NvInitEraseCycles();
     mNvFlashConfigInitialised = TRUE;
 }
 
@@ -3120,7 +3864,7 @@ static NVM_Status_t NvEraseVirtualPage
 {
     uint32_t status;
 
-    if(pageID > gSecondVirtualPage_c)
+    if(pageID >= gNvVirtualPagesCount_c)
         return gNVM_InvalidPageID_c;
 
     /* erase virtual page */
@@ -3141,6 +3885,7 @@ static NVM_Status_t NvEraseVirtualPage
         #endif
         return (NVM_Status_t)status;
     }
+    NvPageErased(pageID);
     #if (gFsciIncluded_c && gNvmEnableFSCIMonitoring_c)
         FSCI_MsgNVPageEraseMonitoring(mNvVirtualPageProperty[pageID].NvRawSectorStartAddress, status);
     #endif
@@ -3160,6 +3905,35 @@ static void NvInitStorageSystem
     bool_t read_legacy_location
 )
 {
+#if gNvUseRing_c
+    uint32_t pageId;
+    uint32_t pageCounterTopValue;
+    uint32_t pageCounterBottomValue;
+
+    mNvActivePageId = gVirtualPageNone_c;
+
+    /* the legacy tables were stored on two virtual pages only */
+    if (read_legacy_location)
+    {
+        return;
+    }
+
+    /* the active page is the valid page with the highest page counter */
+    for(pageId = gFirstVirtualPage_c; pageId < gNvVirtualPagesCount_c; pageId++)
+    {
+        NV_FlashRead(mNvVirtualPageProperty[pageId].NvRawSectorStartAddress, (uint8_t*)&pageCounterTopValue,
+                     sizeof(pageCounterTopValue));
+        NV_FlashRead(mNvVirtualPageProperty[pageId].NvRawSectorEndAddress - sizeof(NVM_TableInfo_t) + 1,
+                    (uint8_t*)&pageCounterBottomValue, sizeof(pageCounterBottomValue));
+
+        if((pageCounterTopValue == pageCounterBottomValue) && (gPageCounterMaxValue_c != pageCounterTopValue) &&
+           ((gVirtualPageNone_c == mNvActivePageId) || (pageCounterTopValue > mNvPageCounter)))
+        {
+            mNvPageCounter = pageCounterTopValue;
+            mNvActivePageId = (NVM_VirtualPageID_t)pageId;
+        }
+    }
+#else
     uint32_t value;
     uint32_t firstPageCounterTopValue;
     uint32_t firstPageCounterBottomValue;
@@ -3273,6 +4047,7 @@ static void NvInitStorageSystem
     }
 
     mNvActivePageId = gVirtualPageNone_c;
+#endif /* gNvUseRing_c */
 }
 
 /******************************************************************************
@@ -3288,7 +4063,7 @@ static NVM_Status_t NvVirtualPageBlankCheck
     NVM_VirtualPageID_t pageID
 )
 {
-    if(pageID > gSecondVirtualPage_c)
+    if(pageID >= gNvVirtualPagesCount_c)
         return gNVM_InvalidPageID_c;
 
 
@@ -3315,15 +4090,26 @@ static NVM_Status_t NvUpdateLastMetaInfoAddress
 )
 {
     NVM_RecordMetaInfo_t metaValue;
-    uint32_t readAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c;
+    uint32_t firstMetaAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c;
+    uint32_t readAddress = firstMetaAddress;
+    uint32_t lastMetaAddress = 0;
+    #if gUnmirroredFeatureSet_d
+    uint32_t unerasedAddress = 0;
+    uint32_t lastUnerasedAddress = 0;
+    #endif
+
+    #if gNvUseMetaIndex_c
+    NvMetaIndexReset();
+    #endif
 
+    /* single forward pass up to the guard; the last valid meta seen is the last meta */
     while(readAddress < mNvVirtualPageProperty[mNvActivePageId].NvRawSectorEndAddress)
     {
         NV_FlashRead(readAddress, (uint8_t*)&metaValue, sizeof(metaValue));
 
         if(gNvGuardValue_c == metaValue.rawValue)
         {
-            if(readAddress == (mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c))
+            if(readAddress == firstMetaAddress)
             {
                 mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress = gEmptyPageMetaAddress_c;
                 #if gUnmirroredFeatureSet_d
@@ -3332,39 +4118,42 @@ static NVM_Status_t NvUpdateLastMetaInfoAddress
                 return gNVM_OK_c;
             }
 
-            readAddress -= sizeof(NVM_RecordMetaInfo_t);
-
-            while(readAddress >= (mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c))
+            if(0 == lastMetaAddress)
             {
-                NV_FlashRead(readAddress, (uint8_t*)&metaValue, sizeof(metaValue));
+                return gNVM_MetaNotFound_c;
+            }
 
-                if((metaValue.fields.NvValidationStartByte == metaValue.fields.NvValidationEndByte) &&
-                   ((gValidationByteSingleRecord_c == metaValue.fields.NvValidationStartByte) ||
-                    (gValidationByteAllRecords_c == metaValue.fields.NvValidationStartByte)))
-                {
-                    mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress = readAddress;
-                    #if gUnmirroredFeatureSet_d
-                    {
-                        while(readAddress >= (mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c))
-                        {
-                            if(metaValue.fields.NvmRecordOffset == 0)
-                            {
-                                readAddress -= sizeof(NVM_RecordMetaInfo_t);
-                                NV_FlashRead(readAddress, (uint8_t*)&metaValue, sizeof(metaValue));
-                            }
-                            else
-                            {
-                                mNvVirtualPageProperty[mNvActivePageId].NvLastMetaUnerasedInfoAddress = readAddress;
-                                break;
-                            }
-                        }
-                    }
-                    #endif
-                    return gNVM_OK_c;
-                }
-                readAddress -= sizeof(NVM_RecordMetaInfo_t);
+            mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress = lastMetaAddress;
+            #if gUnmirroredFeatureSet_d
+            if(0 != lastUnerasedAddress)
+            {
+                mNvVirtualPageProperty[mNvActivePageId].NvLastMetaUnerasedInfoAddress = lastUnerasedAddress;
             }
-            return gNVM_MetaNotFound_c;
+            #endif
+            return gNVM_OK_c;
+        }
+
+        #if gUnmirroredFeatureSet_d
+        if(metaValue.fields.NvmRecordOffset != 0)
+        {
+            unerasedAddress = readAddress;
+        }
+        #endif
+
+        if((metaValue.fields.NvValidationStartByte == metaValue.fields.NvValidationEndByte) &&
+           ((gValidationByteSingleRecord_c == metaValue.fields.NvValidationStartByte) ||
+            #if gNvUseDeltaRecords_c
+            (gValidationByteDeltaRecord_c == metaValue.fields.NvValidationStartByte) ||
+            #endif
+            (gValidationByteAllRecords_c == metaValue.fields.NvValidationStartByte)))
+        {
+            lastMetaAddress = readAddress;
+            #if gUnmirroredFeatureSet_d
+            lastUnerasedAddress = unerasedAddress;
+            #endif
+            #if gNvUseMetaIndex_c
+            NvMetaIndexAdd(readAddress, &metaValue);
+            #endif
         }
         readAddress += sizeof(NVM_RecordMetaInfo_t);
     }
@@ -3577,7 +4366,9 @@ static bool_t NvIsRecordCopied
                 break;
             }
 
-            if(metaInf->fields.NvValidationStartByte == gValidationByteAllRecords_c)
+            /* a delta record is copied as part of a full record */
+            if((metaInf->fields.NvValidationStartByte == gValidationByteAllRecords_c) ||
+               (metaInf->fields.NvValidationStartByte == gValidationByteDeltaRecord_c))
             {
                 if(metaValue.fields.NvValidationStartByte == gValidationByteSingleRecord_c)
                 {
@@ -3602,127 +4393,1197 @@ static bool_t NvIsRecordCopied
 }
 
 
+#if gNvUseMetaIndex_c
 /******************************************************************************
- * Name: NvInternalCopy
- * Description: Performs a copy of an record / entire table entry
- * Parameter(s): [IN] dstAddress - destination record address
- *               [IN] dstMetaAddress - destination meta address
- *               [IN] srcMetaInfo - source meta information
- *               [IN] srcTblEntryIdx - source table entry index
- *               [IN] size - bytes to copy
- * Return: gNVM_InvalidPageID_c - if the source or destination page is not
- *                                valid
- *         gNVM_MetaInfoWriteError_c - if the meta information couldn't be
- *                                     written
- *         gNVM_RecordWriteError_c - if the record couldn't be written
- *         gNVM_Error_c - in case of error(s)
- *         gNVM_OK_c - page copy completed successfully
+ * Name: NvMetaIndexReset
+ * Description: Clears the meta information index and assigns the element
+ *              slots to the RAM table entries. Entries that do not fit in
+ *              the remaining slots are left unindexed.
+ * Parameter(s): -
+ * Return: -
  *****************************************************************************/
-static NVM_Status_t NvInternalCopy
+static void NvMetaIndexReset
 (
-    uint32_t dstAddress,
-    uint32_t dstMetaAddress,
-    NVM_RecordMetaInfo_t* srcMetaInfo,
-    uint16_t srcTblEntryIdx,
-    uint16_t size
+    void
 )
 {
-    uint16_t innerOffset;
-    uint8_t cacheBuffer[gNvCacheBufferSize_c];
-    NVM_RecordMetaInfo_t dstMetaInfo;
-    uint16_t diffSize = 0;
-    uint16_t diffIdx = 0;
-    uint16_t ramSize = 0;
-    uint8_t misalignedBytes;
-    uint8_t loopIdx;
-    uint16_t loopEnd;
-
-    /* Initialize the inner offset*/
-    innerOffset = 0;
-
-    /* prepare destination page meta info tag and write if after the record is entirely written.
-    * the preparation is made here because the 'dstAddress' may change afterwards
-    */
-    dstMetaInfo.fields = srcMetaInfo->fields;
-    dstMetaInfo.fields.NvmRecordOffset = dstAddress - mNvVirtualPageProperty[(mNvActivePageId+1)%2].NvRawSectorStartAddress;
+    uint16_t loopCnt;
+    uint16_t freeSlot = 0;
+    bool_t eot = FALSE;
 
-    if (srcMetaInfo->fields.NvValidationStartByte != gValidationByteSingleRecord_c)
+    for(loopCnt = 0; loopCnt < (uint16_t)gNvTableEntriesCountMax_c; loopCnt++)
     {
-        ramSize = pNVM_DataTable[srcTblEntryIdx].ElementsCount * pNVM_DataTable[srcTblEntryIdx].ElementSize;
-        /* if the bytes to copy are less then RAM table entry space, the supplementary bytes to write on the destination page
-        * will be retrieved from RAM table entry. This is the case when the RAM table has been updated and the new
-        * entry's elements count is greater then the one existing in the previous RAM table, now stored in the FLASH active page
-        * (source page) */
-        if(size < ramSize)
+        if(!eot && (gNvEndOfTableId_c == pNVM_DataTable[loopCnt].DataEntryID))
         {
-            diffSize = ramSize - size;
-            diffIdx = size / pNVM_DataTable[srcTblEntryIdx].ElementSize;
+            eot = TRUE;
         }
-    }
-
-    while(size)
-    {
-        if(size > (uint16_t)gNvCacheBufferSize_c)
-        {
-            /* copy from FLASH to cache buffer */
-            NV_FlashRead(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + srcMetaInfo->fields.NvmRecordOffset + innerOffset,
-                         (uint8_t*)&cacheBuffer[0], (uint16_t)gNvCacheBufferSize_c);
 
-            /* write to destination page */
-            if(kStatus_FLASH_Success == NV_FlashProgramUnaligned(dstAddress, (uint16_t)gNvCacheBufferSize_c, cacheBuffer))
-            {
-                /* update the destination record address copy */
-                dstAddress += (uint16_t)gNvCacheBufferSize_c;
-                /* update the record size */
-                size -= (uint16_t)gNvCacheBufferSize_c;
-                /* update the inner offset value */
-                innerOffset += (uint16_t)gNvCacheBufferSize_c;
+        maNvMetaIndex[loopCnt].fullMetaOffset = 0;
+        maNvMetaIndex[loopCnt].lastMetaOffset = 0;
+        maNvMetaIndex[loopCnt].deltaMetaOffset = 0;
+        maNvMetaIndex[loopCnt].fullCopied = FALSE;
 
-                continue;
-            }
-            return gNVM_RecordWriteError_c;
+        if(!eot && (pNVM_DataTable[loopCnt].ElementsCount <= (uint16_t)gNvMetaIndexElementsCount_c - freeSlot))
+        {
+            maNvMetaIndex[loopCnt].entryId = pNVM_DataTable[loopCnt].DataEntryID;
+            maNvMetaIndex[loopCnt].elementsCount = pNVM_DataTable[loopCnt].ElementsCount;
+            maNvMetaIndex[loopCnt].firstElementSlot = freeSlot;
+            freeSlot += pNVM_DataTable[loopCnt].ElementsCount;
         }
         else
         {
-            /* copy from FLASH to cache buffer */
-            NV_FlashRead(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + srcMetaInfo->fields.NvmRecordOffset + innerOffset,
-                         (uint8_t*)&cacheBuffer[0], size);
-            /* write to destination page */
-            if(kStatus_FLASH_Success == NV_FlashProgramUnaligned(dstAddress, (uint16_t)size, cacheBuffer))
-            {
-                break;
-            }
-            return gNVM_RecordWriteError_c;
+            maNvMetaIndex[loopCnt].entryId = gNvInvalidDataEntry_c;
+            maNvMetaIndex[loopCnt].elementsCount = 0;
+            maNvMetaIndex[loopCnt].firstElementSlot = 0;
         }
     }
 
-    if(diffSize)
-    {
-        /* update the destination record address copy */
-        dstAddress += size;
+    FLib_MemSet(maNvMetaIndexSlots, 0, sizeof(maNvMetaIndexSlots));
+    FLib_MemSet(maNvMetaIndexCopied, 0, sizeof(maNvMetaIndexCopied));
+    mNvMetaIndexPageId = mNvActivePageId;
+}
 
-        /* check alignment and adjust it if necessary */
-        misalignedBytes = dstAddress - (dstAddress & ((uint32_t)~(PGM_SIZE_BYTE-1)));
 
-        /* initialise the inner offset */
-        innerOffset = 0;
+/******************************************************************************
+ * Name: NvMetaIndexAdd
+ * Description: Records a valid meta information tag of the active page. The
+ *              tags must be added in the order they were written.
+ * Parameter(s): [IN] metaAddress - the meta information address
+ *               [IN] pMetaInfo - a pointer to the meta information
+ * Return: -
+ *****************************************************************************/
+static void NvMetaIndexAdd
+(
+    uint32_t metaAddress,
+    NVM_RecordMetaInfo_t* pMetaInfo
+)
+{
+    NVM_MetaIndexEntry_t* pEntry;
+    uint16_t metaOffset;
 
-        /* check if the destination is longword aligned or not */
-        if(misalignedBytes)
-        {
-            /* align to previous 32 bit boundary */
-            dstAddress &= ((uint32_t)~(PGM_SIZE_BYTE-1));
+    pEntry = NvMetaIndexGetEntry(NvGetTableEntryIndexFromId(pMetaInfo->fields.NvmDataEntryID));
 
-            /* compute the loop end */
-            loopEnd = PGM_SIZE_BYTE - misalignedBytes;
+    if(NULL == pEntry)
+    {
+        return;
+    }
 
-            /* read from destination page to cache buffer */
-            NV_FlashRead(dstAddress, (uint8_t*)&cacheBuffer[0], PGM_SIZE_BYTE);
+    metaOffset = (uint16_t)(metaAddress - mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress);
+    pEntry->lastMetaOffset = metaOffset;
 
-            /* update with data from RAM */
-            for(loopIdx = 0; loopIdx < loopEnd; loopIdx++)
-            {
-                cacheBuffer[misalignedBytes] = *((uint8_t*)pNVM_DataTable[srcTblEntryIdx].pData +
+    if(gValidationByteAllRecords_c == pMetaInfo->fields.NvValidationStartByte)
+    {
+        pEntry->fullMetaOffset = metaOffset;
+    }
+    #if gNvUseDeltaRecords_c
+    else if(gValidationByteDeltaRecord_c == pMetaInfo->fields.NvValidationStartByte)
+    {
+        pEntry->deltaMetaOffset = metaOffset;
+    }
+    #endif
+    else if((gValidationByteSingleRecord_c == pMetaInfo->fields.NvValidationStartByte) &&
+            (pMetaInfo->fields.NvmElementIndex < pEntry->elementsCount))
+    {
+        maNvMetaIndexSlots[pEntry->firstElementSlot + pMetaInfo->fields.NvmElementIndex] = metaOffset;
+    }
+}
+
+
+/******************************************************************************
+ * Name: NvMetaIndexGetEntry
+ * Description: Gets the meta information index entry of a table entry. The
+ *              entry is not returned if it was not indexed or if the RAM
+ *              table entry changed since the index was built.
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: a pointer to the index entry or NULL if the entry is not indexed
+ *****************************************************************************/
+static NVM_MetaIndexEntry_t* NvMetaIndexGetEntry
+(
+    uint16_t tableEntryIdx
+)
+{
+    if((tableEntryIdx >= (uint16_t)gNvTableEntriesCountMax_c) ||
+       (mNvMetaIndexPageId != mNvActivePageId) ||
+       (gNvInvalidDataEntry_c == maNvMetaIndex[tableEntryIdx].entryId) ||
+       (maNvMetaIndex[tableEntryIdx].entryId != pNVM_DataTable[tableEntryIdx].DataEntryID) ||
+       (maNvMetaIndex[tableEntryIdx].elementsCount != pNVM_DataTable[tableEntryIdx].ElementsCount))
+    {
+        return NULL;
+    }
+    return &maNvMetaIndex[tableEntryIdx];
+}
+
+
+/******************************************************************************
+ * Name: NvMetaIndexGetLatest
+ * Description: Gets the newest meta holding the value of an element, either
+ *              a single record of the element or a full record
+ * Parameter(s): [IN] pEntry - the index entry
+ *               [IN] elementIndex - the element index
+ * Return: the meta information address or 0 if none exists
+ *****************************************************************************/
+static uint32_t NvMetaIndexGetLatest
+(
+    NVM_MetaIndexEntry_t* pEntry,
+    uint16_t elementIndex
+)
+{
+    uint16_t metaOffset = pEntry->fullMetaOffset;
+
+    if(maNvMetaIndexSlots[pEntry->firstElementSlot + elementIndex] > metaOffset)
+    {
+        metaOffset = maNvMetaIndexSlots[pEntry->firstElementSlot + elementIndex];
+    }
+
+    if(0 == metaOffset)
+    {
+        return 0;
+    }
+    return mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + metaOffset;
+}
+
+
+/******************************************************************************
+ * Name: NvMetaIndexIsRecordCopied
+ * Description: Same as NvIsRecordCopied(), but answered from the records
+ *              marked by NvMetaIndexSetCopied() instead of scanning the
+ *              destination page. Falls back to NvIsRecordCopied() for the
+ *              records that are not indexed.
+ * Parameter(s): [IN] tableEntryIdx - source table entry index
+ *               [IN] pageId - the ID of the destination page
+ *               [IN] metaInf - a pointer to source page meta information tag
+ * Return: TRUE if the element is already copied, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvMetaIndexIsRecordCopied
+(
+    uint16_t tableEntryIdx,
+    NVM_VirtualPageID_t pageId,
+    NVM_RecordMetaInfo_t* metaInf
+)
+{
+    NVM_MetaIndexEntry_t* pEntry;
+    uint16_t slot;
+
+    pEntry = NvMetaIndexGetEntry(tableEntryIdx);
+
+    if((NULL == pEntry) ||
+       ((gValidationByteSingleRecord_c == metaInf->fields.NvValidationStartByte) &&
+        (metaInf->fields.NvmElementIndex >= pEntry->elementsCount)))
+    {
+        return NvIsRecordCopied(pageId, metaInf);
+    }
+
+    if(pEntry->fullCopied)
+    {
+        return TRUE;
+    }
+
+    if(gValidationByteSingleRecord_c == metaInf->fields.NvValidationStartByte)
+    {
+        slot = pEntry->firstElementSlot + metaInf->fields.NvmElementIndex;
+        return (maNvMetaIndexCopied[slot >> 3] & (1 << (slot & 0x07))) ? TRUE : FALSE;
+    }
+    return FALSE;
+}
+
+
+/******************************************************************************
+ * Name: NvMetaIndexSetCopied
+ * Description: Marks a record as written to the destination page
+ * Parameter(s): [IN] tableEntryIdx - source table entry index
+ *               [IN] elementIndex - the element index or
+ *                                   gNvInvalidElementIndex_c for a full record
+ * Return: -
+ *****************************************************************************/
+static void NvMetaIndexSetCopied
+(
+    uint16_t tableEntryIdx,
+    uint16_t elementIndex
+)
+{
+    NVM_MetaIndexEntry_t* pEntry;
+    uint16_t slot;
+
+    pEntry = NvMetaIndexGetEntry(tableEntryIdx);
+
+    if(NULL == pEntry)
+    {
+        return;
+    }
+
+    if(gNvInvalidElementIndex_c == elementIndex)
+    {
+        pEntry->fullCopied = TRUE;
+    }
+    else if(elementIndex < pEntry->elementsCount)
+    {
+        slot = pEntry->firstElementSlot + elementIndex;
+        maNvMetaIndexCopied[slot >> 3] |= (uint8_t)(1 << (slot & 0x07));
+    }
+}
+
+
+/******************************************************************************
+ * Name: NvMetaIndexClearCopied
+ * Description: Forgets the records written to the destination page
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvMetaIndexClearCopied
+(
+    void
+)
+{
+    uint16_t loopCnt;
+
+    for(loopCnt = 0; loopCnt < (uint16_t)gNvTableEntriesCountMax_c; loopCnt++)
+    {
+        maNvMetaIndex[loopCnt].fullCopied = FALSE;
+    }
+    FLib_MemSet(maNvMetaIndexCopied, 0, sizeof(maNvMetaIndexCopied));
+}
+
+
+#if gNvFragmentation_Enabled_d
+/******************************************************************************
+ * Name: NvMetaIndexGetRecordsOffsets
+ * Description: Fills maNvRecordsCpyOffsets with the record offsets of the
+ *              latest single saves newer than the owner full record
+ * Parameter(s): [IN] srcTblEntryIdx - source page table entry index
+ *               [IN] ownerMetaAddr - the owner full record meta address
+ *               [IN] srcMetaAddr - source page meta address
+ * Return: TRUE if the offsets were taken from the index, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvMetaIndexGetRecordsOffsets
+(
+    uint16_t srcTblEntryIdx,
+    uint32_t ownerMetaAddr,
+    uint32_t srcMetaAddr
+)
+{
+    NVM_MetaIndexEntry_t* pEntry;
+    NVM_RecordMetaInfo_t metaInfo;
+    uint16_t ownerOffset;
+    uint16_t srcOffset;
+    uint16_t slotOffset;
+    uint16_t idx;
+
+    pEntry = NvMetaIndexGetEntry(srcTblEntryIdx);
+
+    if(NULL == pEntry)
+    {
+        return FALSE;
+    }
+
+    ownerOffset = (uint16_t)(ownerMetaAddr - mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress);
+    srcOffset = (uint16_t)(srcMetaAddr - mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress);
+
+    for(idx = 0; idx < pEntry->elementsCount; idx++)
+    {
+        slotOffset = maNvMetaIndexSlots[pEntry->firstElementSlot + idx];
+
+        if(slotOffset > srcOffset)
+        {
+            /* a newer single save exists; let the caller scan the page */
+            return FALSE;
+        }
+
+        maNvRecordsCpyOffsets[idx] = 0;
+        if(slotOffset > ownerOffset)
+        {
+            (void)NvGetMetaInfo(mNvActivePageId, mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + slotOffset, &metaInfo);
+            maNvRecordsCpyOffsets[idx] = metaInfo.fields.NvmRecordOffset;
+        }
+    }
+    return TRUE;
+}
+#endif /* gNvFragmentation_Enabled_d */
+#endif /* gNvUseMetaIndex_c */
+
+#if gNvUseCommitEngine_c
+/******************************************************************************
+ * Name: NvCommitReset
+ * Description: Clears the commit engine state and assigns the dirty bitmap
+ *              element slots to the RAM table entries. Entries that do not
+ *              fit in the remaining slots are left to the pending saves queue.
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvCommitReset
+(
+    void
+)
+{
+    uint16_t loopCnt;
+    uint16_t freeSlot = 0;
+    bool_t eot = FALSE;
+
+    for(loopCnt = 0; loopCnt < (uint16_t)gNvTableEntriesCountMax_c; loopCnt++)
+    {
+        if(!eot && (gNvEndOfTableId_c == pNVM_DataTable[loopCnt].DataEntryID))
+        {
+            eot = TRUE;
+        }
+
+        maNvCommitEntries[loopCnt].dirty = FALSE;
+        maNvCommitEntries[loopCnt].saveAll = FALSE;
+
+        if(!eot && (pNVM_DataTable[loopCnt].ElementsCount <= (uint16_t)gNvCommitElementsCount_c - freeSlot))
+        {
+            maNvCommitEntries[loopCnt].entryId = pNVM_DataTable[loopCnt].DataEntryID;
+            maNvCommitEntries[loopCnt].elementsCount = pNVM_DataTable[loopCnt].ElementsCount;
+            maNvCommitEntries[loopCnt].firstElementSlot = freeSlot;
+            freeSlot += pNVM_DataTable[loopCnt].ElementsCount;
+        }
+        else
+        {
+            maNvCommitEntries[loopCnt].entryId = gNvInvalidDataEntry_c;
+            maNvCommitEntries[loopCnt].elementsCount = 0;
+            maNvCommitEntries[loopCnt].firstElementSlot = 0;
+        }
+    }
+
+    FLib_MemSet(maNvCommitDirty, 0, sizeof(maNvCommitDirty));
+    mNvCommitDirtyCount = 0;
+    mNvCommitTicksLeft = 0;
+}
+
+
+/******************************************************************************
+ * Name: NvCommitGetEntry
+ * Description: Gets the commit engine state of a table entry. The entry is
+ *              not returned if it is not tracked or if the RAM table entry
+ *              changed since the element slots were assigned.
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: a pointer to the entry state or NULL if the entry is not tracked
+ *****************************************************************************/
+static NVM_CommitEntry_t* NvCommitGetEntry
+(
+    uint16_t tableEntryIdx
+)
+{
+    if((tableEntryIdx >= (uint16_t)gNvTableEntriesCountMax_c) ||
+       (gNvInvalidDataEntry_c == maNvCommitEntries[tableEntryIdx].entryId) ||
+       (maNvCommitEntries[tableEntryIdx].entryId != pNVM_DataTable[tableEntryIdx].DataEntryID) ||
+       (maNvCommitEntries[tableEntryIdx].elementsCount != pNVM_DataTable[tableEntryIdx].ElementsCount))
+    {
+        return NULL;
+    }
+    return &maNvCommitEntries[tableEntryIdx];
+}
+
+
+/******************************************************************************
+ * Name: NvCommitMarkDirty
+ * Description: Marks the data set of a save request dirty. A request for a
+ *              table entry that is already dirty costs one bit set.
+ * Parameter(s): [IN] ptrTblIdx - pointer to table index
+ * Return: TRUE if the request was taken, FALSE if it must be queued
+ *****************************************************************************/
+static bool_t NvCommitMarkDirty
+(
+    NVM_TableEntryInfo_t* ptrTblIdx
+)
+{
+    NVM_CommitEntry_t* pEntry;
+    uint16_t tableEntryIdx;
+    uint16_t slot;
+
+    if((gNvCopyAll_c == ptrTblIdx->entryId) || (gNvInvalidDataEntry_c == ptrTblIdx->entryId))
+    {
+        return FALSE;
+    }
+
+    tableEntryIdx = NvGetTableEntryIndexFromId(ptrTblIdx->entryId);
+    pEntry = NvCommitGetEntry(tableEntryIdx);
+
+    if((NULL == pEntry) && (0 == mNvCommitDirtyCount))
+    {
+        /* the RAM table changed since the slots were assigned; nothing is
+         * dirty, so they can be assigned again */
+        NvCommitReset();
+        pEntry = NvCommitGetEntry(tableEntryIdx);
+    }
+
+    if((NULL == pEntry) || (ptrTblIdx->elementIndex >= pEntry->elementsCount))
+    {
+        return FALSE;
+    }
+
+    if(!pEntry->dirty)
+    {
+        pEntry->dirty = TRUE;
+        if(0 == mNvCommitDirtyCount++)
+        {
+            #if gNvCommitDeadlineTicks_c
+            if(gTmrInvalidTimerID_c == mNvSaveOnIntervalTimerID)
+            {
+                mNvSaveOnIntervalTimerID = TMR_AllocateTimer();
+            }
+            if(gTmrInvalidTimerID_c != mNvSaveOnIntervalTimerID)
+            {
+                /* +1 because mNvSaveOnIntervalEvent will cause NvIdle
+                 * to decrement the value before the timer ticks */
+                mNvCommitTicksLeft = gNvCommitDeadlineTicks_c + 1;
+                mNvSaveOnIntervalEvent = TRUE;
+            }
+            #endif
+        }
+    }
+
+    #if gUnmirroredFeatureSet_d
+    if(gNVM_MirroredInRam_c != pNVM_DataTable[tableEntryIdx].DataEntryType)
+    {
+        /* the elements of an unmirrored data set are always saved separately */
+        ptrTblIdx->saveRestoreAll = FALSE;
+    }
+    #endif
+
+    if(ptrTblIdx->saveRestoreAll)
+    {
+        pEntry->saveAll = TRUE;
+    }
+    else
+    {
+        slot = pEntry->firstElementSlot + ptrTblIdx->elementIndex;
+        maNvCommitDirty[slot >> 3] |= (uint8_t)(1U << (slot & 7U));
+    }
+    return TRUE;
+}
+
+
+/******************************************************************************
+ * Name: NvCommitClear
+ * Description: Cancels the pending save of an element or of a table entry.
+ *              A pending full save of the entry is kept when a single
+ *              element is cleared.
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ *               [IN] elementIndex - the element index or
+ *                                   gNvInvalidElementIndex_c for the entire entry
+ * Return: -
+ *****************************************************************************/
+static void NvCommitClear
+(
+    uint16_t tableEntryIdx,
+    uint16_t elementIndex
+)
+{
+    NVM_CommitEntry_t* pEntry;
+    uint16_t slot;
+    uint16_t idx;
+
+    pEntry = NvCommitGetEntry(tableEntryIdx);
+
+    if((NULL == pEntry) || !pEntry->dirty)
+    {
+        return;
+    }
+
+    for(idx = 0; idx < pEntry->elementsCount; idx++)
+    {
+        slot = pEntry->firstElementSlot + idx;
+        if((gNvInvalidElementIndex_c == elementIndex) || (idx == elementIndex))
+        {
+            maNvCommitDirty[slot >> 3] &= (uint8_t)~(1U << (slot & 7U));
+        }
+        else if(maNvCommitDirty[slot >> 3] & (1U << (slot & 7U)))
+        {
+            /* other elements are still dirty */
+            return;
+        }
+    }
+
+    if(gNvInvalidElementIndex_c == elementIndex)
+    {
+        pEntry->saveAll = FALSE;
+    }
+
+    if(!pEntry->saveAll)
+    {
+        pEntry->dirty = FALSE;
+        mNvCommitDirtyCount--;
+    }
+}
+
+
+/******************************************************************************
+ * Name: NvCommitClearAll
+ * Description: Cancels all the pending saves, except for the unmirrored
+ *              elements erase operations, which are not part of an atomic save
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvCommitClearAll
+(
+    void
+)
+{
+    uint16_t tableEntryIdx;
+    #if gUnmirroredFeatureSet_d
+    uint16_t idx;
+    uint16_t slot;
+    #endif
+
+    for(tableEntryIdx = 0; tableEntryIdx < (uint16_t)gNvTableEntriesCountMax_c; tableEntryIdx++)
+    {
+        if(!maNvCommitEntries[tableEntryIdx].dirty)
+        {
+            continue;
+        }
+        #if gUnmirroredFeatureSet_d
+        if((NULL != NvCommitGetEntry(tableEntryIdx)) &&
+           (gNVM_MirroredInRam_c != pNVM_DataTable[tableEntryIdx].DataEntryType))
+        {
+            for(idx = 0; idx < maNvCommitEntries[tableEntryIdx].elementsCount; idx++)
+            {
+                slot = maNvCommitEntries[tableEntryIdx].firstElementSlot + idx;
+                if((maNvCommitDirty[slot >> 3] & (1U << (slot & 7U))) &&
+                   (NULL != ((void**)pNVM_DataTable[tableEntryIdx].pData)[idx]))
+                {
+                    NvCommitClear(tableEntryIdx, idx);
+                }
+            }
+            continue;
+        }
+        #endif
+        NvCommitClear(tableEntryIdx, gNvInvalidElementIndex_c);
+    }
+}
+
+
+/******************************************************************************
+ * Name: NvCommitIsDirty
+ * Description: Checks if a table entry has pending saves
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: TRUE if the table entry is dirty, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvCommitIsDirty
+(
+    uint16_t tableEntryIdx
+)
+{
+    NVM_CommitEntry_t* pEntry = NvCommitGetEntry(tableEntryIdx);
+
+    return (NULL != pEntry) && pEntry->dirty;
+}
+
+
+/******************************************************************************
+ * Name: NvCommitFlush
+ * Description: Writes all the dirty data sets, gNvCommitBatchSize_c records
+ *              at a time. The dirty elements of a mirrored data set are
+ *              combined in one full record when it is not larger than the
+ *              single records.
+ * Parameter(s): -
+ * Return: gNVM_OK_c - if all the data sets were written
+ *         gNVM_PageCopyPending_c - if a page copy is needed first
+ *         Note: see also return codes of NvWriteRecord() function
+ *****************************************************************************/
+static NVM_Status_t NvCommitFlush
+(
+    void
+)
+{
+    NVM_Status_t status = gNVM_OK_c;
+    NVM_CommitEntry_t* pEntry;
+    uint16_t tableEntryIdx;
+    uint16_t count;
+    uint16_t written;
+    uint16_t dirtyCount;
+    uint16_t slot;
+    uint16_t idx;
+
+    while(mNvCommitDirtyCount && (gNVM_OK_c == status))
+    {
+        count = 0;
+
+        for(tableEntryIdx = 0; (tableEntryIdx < (uint16_t)gNvTableEntriesCountMax_c) && (count < (uint16_t)gNvCommitBatchSize_c); tableEntryIdx++)
+        {
+            if(!maNvCommitEntries[tableEntryIdx].dirty)
+            {
+                continue;
+            }
+
+            pEntry = NvCommitGetEntry(tableEntryIdx);
+
+            if(NULL == pEntry)
+            {
+                /* the table entry is gone */
+                maNvCommitEntries[tableEntryIdx].dirty = FALSE;
+                mNvCommitDirtyCount--;
+                continue;
+            }
+
+            maNvCommitBatch[count].entryId = pEntry->entryId;
+            maNvCommitBatch[count].elementIndex = 0;
+            maNvCommitBatch[count].saveRestoreAll = pEntry->saveAll;
+
+            if(!pEntry->saveAll && (gNVM_MirroredInRam_c == pNVM_DataTable[tableEntryIdx].DataEntryType))
+            {
+                dirtyCount = 0;
+                for(idx = 0; idx < pEntry->elementsCount; idx++)
+                {
+                    slot = pEntry->firstElementSlot + idx;
+                    if(maNvCommitDirty[slot >> 3] & (1U << (slot & 7U)))
+                    {
+                        dirtyCount++;
+                    }
+                }
+
+                if(dirtyCount * (NvUpdateSize(pNVM_DataTable[tableEntryIdx].ElementSize) + sizeof(NVM_RecordMetaInfo_t)) >=
+                   NvUpdateSize((uint32_t)pNVM_DataTable[tableEntryIdx].ElementSize * pNVM_DataTable[tableEntryIdx].ElementsCount) + sizeof(NVM_RecordMetaInfo_t))
+                {
+                    maNvCommitBatch[count].saveRestoreAll = TRUE;
+                }
+            }
+
+            if(maNvCommitBatch[count].saveRestoreAll)
+            {
+                #if gNvUseDeltaRecords_c
+                if(NvDeltaIsEnabled(tableEntryIdx))
+                {
+                    /* the delta records are built one at a time */
+                    status = NvWriteRecord(&maNvCommitBatch[count]);
+                    if(gNVM_OK_c != status)
+                    {
+                        break;
+                    }
+                    NvCommitClear(tableEntryIdx, gNvInvalidElementIndex_c);
+                    continue;
+                }
+                #endif
+                count++;
+                continue;
+            }
+
+            for(idx = 0; (idx < pEntry->elementsCount) && (count < (uint16_t)gNvCommitBatchSize_c); idx++)
+            {
+                slot = pEntry->firstElementSlot + idx;
+                if(maNvCommitDirty[slot >> 3] & (1U << (slot & 7U)))
+                {
+                    maNvCommitBatch[count].entryId = pEntry->entryId;
+                    maNvCommitBatch[count].elementIndex = idx;
+                    maNvCommitBatch[count].saveRestoreAll = FALSE;
+                    count++;
+                }
+            }
+        }
+
+        if((0 == count) || (gNVM_OK_c != status))
+        {
+            break;
+        }
+
+        status = NvWriteRecords(maNvCommitBatch, count, &written);
+
+        for(idx = 0; idx < written; idx++)
+        {
+            NvCommitClear(NvGetTableEntryIndexFromId(maNvCommitBatch[idx].entryId),
+                          maNvCommitBatch[idx].saveRestoreAll ? gNvInvalidElementIndex_c : maNvCommitBatch[idx].elementIndex);
+        }
+    }
+    return status;
+}
+
+
+/******************************************************************************
+ * Name: NvWriteRecords
+ * Description: Writes several records and their meta information tags. The
+ *              records are programmed back to back, below the last record of
+ *              the active page, and then all the meta information tags are
+ *              programmed with one flash operation. The page layout is the
+ *              one produced by NvWriteRecord(), called for each record when
+ *              the space after the last meta information is not blank.
+ * Parameter(s): [IN] pBatch - the records table and element indexes
+ *               [IN] count - the number of records
+ *               [OUT] pWritten - the number of records written
+ * Return: gNVM_OK_c - if all the records were written
+ *         gNVM_PageCopyPending_c - if the active page is full
+ *         gNVM_MetaInfoWriteError_c - if the meta information couldn't be
+ *                                     written
+ *         gNVM_RecordWriteError_c - if a record couldn't be written
+ *         Note: see also return codes of NvWriteRecord() function
+ *****************************************************************************/
+static NVM_Status_t NvWriteRecords
+(
+    NVM_TableEntryInfo_t* pBatch,
+    uint16_t count,
+    uint16_t* pWritten
+)
+{
+    NVM_Status_t status = gNVM_OK_c;
+    NVM_RecordMetaInfo_t metaInfo;
+    uint32_t pageStartAddress;
+    uint32_t pageFreeSpace;
+    uint32_t usedSpace = 0;
+    uint32_t recordsEndAddress;
+    uint32_t recordAddress;
+    uint32_t firstMetaAddress;
+    uint32_t metaInfoAddress;
+    uint32_t realRecordSize;
+    uint16_t tableEntryIdx;
+    uint16_t processed;
+    uint16_t metasCount = 0;
+    uint16_t idx;
+
+    *pWritten = 0;
+
+    /* make sure i don't process the save if page copy is active */
+    if(mNvCopyOperationIsPending)
+    {
+        return gNVM_PageCopyPending_c;
+    }
+
+    pageStartAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress;
+    NvGetPageFreeSpace(&pageFreeSpace);
+
+    if(gEmptyPageMetaAddress_c == mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress)
+    {
+        recordsEndAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorEndAddress - sizeof(NVM_TableInfo_t) + 1;
+        firstMetaAddress = pageStartAddress + gNvFirstMetaOffset_c;
+    }
+    else
+    {
+        /* get the meta information of the last successfully written record */
+        #if gUnmirroredFeatureSet_d
+        NvGetMetaInfo(mNvActivePageId, mNvVirtualPageProperty[mNvActivePageId].NvLastMetaUnerasedInfoAddress, &metaInfo);
+        #else
+        NvGetMetaInfo(mNvActivePageId, mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress, &metaInfo);
+        #endif
+        recordsEndAddress = pageStartAddress + metaInfo.fields.NvmRecordOffset;
+        firstMetaAddress = mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress + sizeof(NVM_RecordMetaInfo_t);
+    }
+    recordAddress = recordsEndAddress;
+
+    /* place the records and build their meta information */
+    for(processed = 0; processed < count; processed++)
+    {
+        tableEntryIdx = NvGetTableEntryIndexFromId(pBatch[processed].entryId);
+
+        if(gNvInvalidTableEntryIndex_c == tableEntryIdx)
+        {
+            continue;
+        }
+
+        maNvCommitRecords[metasCount].tableEntryIdx = tableEntryIdx;
+
+        #if gUnmirroredFeatureSet_d
+        if(gNVM_MirroredInRam_c != pNVM_DataTable[tableEntryIdx].DataEntryType)
+        {
+            maNvCommitRecords[metasCount].srcAddress = (uint32_t)((void**)pNVM_DataTable[tableEntryIdx].pData)[pBatch[processed].elementIndex];
+            maNvCommitRecords[metasCount].size = pNVM_DataTable[tableEntryIdx].ElementSize;
+
+            if(0 == maNvCommitRecords[metasCount].srcAddress)
+            {
+                /* it's an erased unmirrored dataset */
+                maNvCommitRecords[metasCount].size = 0;
+            }
+            else if(NvIsNVMFlashAddress((void*)maNvCommitRecords[metasCount].srcAddress))
+            {
+                /* the dataset is already in flash */
+                continue;
+            }
+        }
+        else
+        #endif
+        if(pBatch[processed].saveRestoreAll)
+        {
+            maNvCommitRecords[metasCount].srcAddress = (uint32_t)((uint8_t*)pNVM_DataTable[tableEntryIdx].pData);
+            maNvCommitRecords[metasCount].size = pNVM_DataTable[tableEntryIdx].ElementSize * pNVM_DataTable[tableEntryIdx].ElementsCount;
+        }
+        else
+        {
+            maNvCommitRecords[metasCount].srcAddress = (uint32_t)((uint8_t*)pNVM_DataTable[tableEntryIdx].pData +
+                                                                  (pBatch[processed].elementIndex * pNVM_DataTable[tableEntryIdx].ElementSize));
+            maNvCommitRecords[metasCount].size = pNVM_DataTable[tableEntryIdx].ElementSize;
+        }
+
+        realRecordSize = NvUpdateSize(maNvCommitRecords[metasCount].size);
+
+        /* one extra meta info space must be kept always free, to be able to perform the meta info search */
+        if(usedSpace + realRecordSize + 2 * sizeof(NVM_RecordMetaInfo_t) >= pageFreeSpace)
+        {
+            break;
+        }
+        usedSpace += realRecordSize + sizeof(NVM_RecordMetaInfo_t);
+        recordAddress -= realRecordSize;
+
+        if(pBatch[processed].saveRestoreAll)
+        {
+            metaInfo.fields.NvValidationStartByte = gValidationByteAllRecords_c;
+            metaInfo.fields.NvValidationEndByte = gValidationByteAllRecords_c;
+        }
+        else
+        {
+            metaInfo.fields.NvValidationStartByte = gValidationByteSingleRecord_c;
+            metaInfo.fields.NvValidationEndByte = gValidationByteSingleRecord_c;
+        }
+        metaInfo.fields.NvmDataEntryID = pNVM_DataTable[tableEntryIdx].DataEntryID;
+        metaInfo.fields.NvmElementIndex = pBatch[processed].elementIndex;
+        metaInfo.fields.NvmRecordOffset = maNvCommitRecords[metasCount].size ? (uint16_t)(recordAddress - pageStartAddress) : 0;
+        maNvCommitMetas[metasCount++] = metaInfo;
+    }
+
+    if(0 == metasCount)
+    {
+        *pWritten = processed;
+        if(processed < count)
+        {
+            mNvCopyOperationIsPending = TRUE;
+            return gNVM_PageCopyPending_c;
+        }
+        return gNVM_OK_c;
+    }
+
+    /* a record or a meta may have been written before a reset, without the
+     * meta that makes it valid; let NvWriteRecord() step over it */
+    if(!NvIsMemoryAreaAvailable(recordAddress, recordsEndAddress - recordAddress) ||
+       !NvIsMemoryAreaAvailable(firstMetaAddress, metasCount * sizeof(NVM_RecordMetaInfo_t)))
+    {
+        for(idx = 0; idx < count; idx++)
+        {
+            status = NvWriteRecord(&pBatch[idx]);
+            if(gNVM_OK_c != status)
+            {
+                break;
+            }
+        }
+        *pWritten = idx;
+        return status;
+    }
+
+    /* write the records */
+    for(idx = 0; idx < metasCount; idx++)
+    {
+        if(maNvCommitRecords[idx].size &&
+           (kStatus_FLASH_Success != NV_FlashProgramUnaligned(pageStartAddress + maNvCommitMetas[idx].fields.NvmRecordOffset,
+                                                               maNvCommitRecords[idx].size,
+                                                               (uint8_t*)maNvCommitRecords[idx].srcAddress)))
+        {
+            return gNVM_RecordWriteError_c;
+        }
+    }
+
+    /* the records are valid once the associated meta information is written */
+    if(kStatus_FLASH_Success != NV_FlashProgram(firstMetaAddress, metasCount * sizeof(NVM_RecordMetaInfo_t), (uint8_t*)maNvCommitMetas))
+    {
+        return gNVM_MetaInfoWriteError_c;
+    }
+
+    for(idx = 0, metaInfoAddress = firstMetaAddress; idx < metasCount; idx++, metaInfoAddress += sizeof(NVM_RecordMetaInfo_t))
+    {
+        #if gNvUseMetaIndex_c
+        NvMetaIndexAdd(metaInfoAddress, &maNvCommitMetas[idx]);
+        #endif
+        /* Empty macro when nvm monitoring is not enabled */
+        #if (gFsciIncluded_c && gNvmEnableFSCIMonitoring_c)
+        FSCI_MsgNVWriteMonitoring(maNvCommitMetas[idx].fields.NvmDataEntryID, maNvCommitMetas[idx].fields.NvmElementIndex,
+                                  gValidationByteAllRecords_c == maNvCommitMetas[idx].fields.NvValidationStartByte);
+        #endif
+        #if gUnmirroredFeatureSet_d
+        if(0 != maNvCommitMetas[idx].fields.NvmRecordOffset)
+        {
+            /* update the last unerased meta info address */
+            mNvVirtualPageProperty[mNvActivePageId].NvLastMetaUnerasedInfoAddress = metaInfoAddress;
+
+            if(gNVM_MirroredInRam_c != pNVM_DataTable[maNvCommitRecords[idx].tableEntryIdx].DataEntryType)
+            {
+                ((uint8_t**)pNVM_DataTable[maNvCommitRecords[idx].tableEntryIdx].pData)[maNvCommitMetas[idx].fields.NvmElementIndex] =
+                    (uint8_t*)(pageStartAddress + maNvCommitMetas[idx].fields.NvmRecordOffset);
+                MSG_Free((void*)maNvCommitRecords[idx].srcAddress);
+            }
+        }
+        #endif
+    }
+    /* update the last record meta information */
+    mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress = metaInfoAddress - sizeof(NVM_RecordMetaInfo_t);
+
+    *pWritten = processed;
+    if(processed < count)
+    {
+        mNvCopyOperationIsPending = TRUE;
+        return gNVM_PageCopyPending_c;
+    }
+    return gNVM_OK_c;
+}
+#endif /* gNvUseCommitEngine_c */
+
+/******************************************************************************
+ * Name: NvSchedulePageErase
+ * Description: Requests the erase of a virtual page, to be done sector by
+ *              sector in the idle task. A ring page is queued if another page
+ *              is being erased.
+ * Parameter(s): [IN] pageID - the ID of the page to be erased
+ * Return: -
+ *****************************************************************************/
+static void NvSchedulePageErase
+(
+    NVM_VirtualPageID_t pageID
+)
+{
+    #if gNvUseRing_c
+    mNvRingBlankPages &= ~(1UL << pageID);
+    if(mNvErasePgCmdStatus.NvErasePending && (mNvErasePgCmdStatus.NvPageToErase != pageID))
+    {
+        mNvRingStalePages |= (1UL << pageID);
+        return;
+    }
+    #endif
+    mNvErasePgCmdStatus.NvPageToErase = pageID;
+    mNvErasePgCmdStatus.NvSectorAddress = mNvVirtualPageProperty[pageID].NvRawSectorStartAddress;
+    mNvErasePgCmdStatus.NvErasePending = TRUE;
+}
+
+/******************************************************************************
+ * Name: NvPageErased
+ * Description: Updates the erase cycles and the ring state of a virtual page
+ *              which has been entirely erased. A pending erase request of the
+ *              page is dropped and the erase of the next stale ring page, in
+ *              ring order, is started.
+ * Parameter(s): [IN] pageID - the ID of the erased page
+ * Return: -
+ *****************************************************************************/
+static void NvPageErased
+(
+    NVM_VirtualPageID_t pageID
+)
+{
+    #if gNvUseRing_c
+    uint32_t idx;
+    #endif
+
+    maNvPageEraseCycles[pageID]++;
+
+    if(mNvErasePgCmdStatus.NvErasePending && (mNvErasePgCmdStatus.NvPageToErase == pageID))
+    {
+        mNvErasePgCmdStatus.NvErasePending = FALSE;
+    }
+
+    #if gNvUseRing_c
+    mNvRingBlankPages |= (1UL << pageID);
+    mNvRingStalePages &= ~(1UL << pageID);
+
+    if(mNvErasePgCmdStatus.NvErasePending || !mNvRingStalePages || (gVirtualPageNone_c == mNvActivePageId))
+    {
+        return;
+    }
+
+    /* the page following the active one is the next page copy destination */
+    for(idx = 1; idx < gNvVirtualPagesCount_c; idx++)
+    {
+        pageID = (NVM_VirtualPageID_t)((mNvActivePageId + idx) % gNvVirtualPagesCount_c);
+        if(mNvRingStalePages & (1UL << pageID))
+        {
+            mNvRingStalePages &= ~(1UL << pageID);
+            NvSchedulePageErase(pageID);
+            return;
+        }
+    }
+    #endif
+}
+
+/******************************************************************************
+ * Name: NvInitEraseCycles
+ * Description: Estimates the erase cycles of the virtual pages from the page
+ *              counter of the active page. Every page copy increments the page
+ *              counter, moves to the next page and erases the previous one.
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvInitEraseCycles
+(
+    void
+)
+{
+    uint32_t pageId;
+    uint32_t distance;
+
+    for(pageId = gFirstVirtualPage_c; pageId < gNvVirtualPagesCount_c; pageId++)
+    {
+        maNvPageEraseCycles[pageId] = 0;
+        if(gVirtualPageNone_c == mNvActivePageId)
+        {
+            continue;
+        }
+
+        /* the count of page copies since the page was left the last time */
+        distance = (mNvActivePageId + gNvVirtualPagesCount_c - pageId) % gNvVirtualPagesCount_c;
+        if(0 == distance)
+        {
+            distance = gNvVirtualPagesCount_c;
+        }
+        if(mNvPageCounter > distance)
+        {
+            maNvPageEraseCycles[pageId] = (mNvPageCounter - distance - 1) / gNvVirtualPagesCount_c + 1;
+        }
+    }
+}
+
+#if gNvUseRing_c
+/******************************************************************************
+ * Name: NvRingInit
+ * Description: Finds the ring pages, other than the active one and the one
+ *              holding an interrupted page copy, which are not blank and
+ *              requests their erase
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvRingInit
+(
+    void
+)
+{
+    uint32_t idx;
+    NVM_VirtualPageID_t pageId;
+
+    if(gVirtualPageNone_c == mNvActivePageId)
+    {
+        /* the storage is going to be formatted */
+        return;
+    }
+
+    for(idx = 1; idx < gNvVirtualPagesCount_c; idx++)
+    {
+        pageId = (NVM_VirtualPageID_t)((mNvActivePageId + idx) % gNvVirtualPagesCount_c);
+        if((1 == idx) && mNvCopyState.inProgress)
+        {
+            /* holds the interrupted page copy */
+            continue;
+        }
+        if(gNVM_OK_c == NvVirtualPageBlankCheck(pageId))
+        {
+            mNvRingBlankPages |= (1UL << pageId);
+        }
+        else
+        {
+            NvSchedulePageErase(pageId);
+        }
+    }
+}
+#endif /* gNvUseRing_c */
+
+
+/******************************************************************************
+ * Name: NvInternalCopy
+ * Description: Performs a copy of an record / entire table entry
+ * Parameter(s): [IN] dstAddress - destination record address
+ *               [IN] dstMetaAddress - destination meta address
+ *               [IN] srcMetaInfo - source meta information
+ *               [IN] srcTblEntryIdx - source table entry index
+ *               [IN] size - bytes to copy
+ * Return: gNVM_InvalidPageID_c - if the source or destination page is not
+ *                                valid
+ *         gNVM_MetaInfoWriteError_c - if the meta information couldn't be
+ *                                     written
+ *         gNVM_RecordWriteError_c - if the record couldn't be written
+ *         gNVM_Error_c - in case of error(s)
+ *         gNVM_OK_c - page copy completed successfully
+ *****************************************************************************/
+static NVM_Status_t NvInternalCopy
+(
+    uint32_t dstAddress,
+    uint32_t dstMetaAddress,
+    NVM_RecordMetaInfo_t* srcMetaInfo,
+    uint16_t srcTblEntryIdx,
+    uint16_t size
+)
+{
+    uint16_t innerOffset;
+    uint8_t cacheBuffer[gNvCacheBufferSize_c];
+    NVM_RecordMetaInfo_t dstMetaInfo;
+    uint16_t diffSize = 0;
+    uint16_t diffIdx = 0;
+    uint16_t ramSize = 0;
+    uint8_t misalignedBytes;
+    uint8_t loopIdx;
+    uint16_t loopEnd;
+
+    /* Initialize the inner offset*/
+    innerOffset = 0;
+
+    /* prepare destination page meta info tag and write if after the record is entirely written.
+    * the preparation is made here because the 'dstAddress' may change afterwards
+    */
+    dstMetaInfo.fields = srcMetaInfo->fields;
+    dstMetaInfo.fields.NvmRecordOffset = dstAddress - mNvVirtualPageProperty[(mNvActivePageId+1)%gNvVirtualPagesCount_c].NvRawSectorStartAddress;
+
+    if (srcMetaInfo->fields.NvValidationStartByte != gValidationByteSingleRecord_c)
+    {
+        ramSize = pNVM_DataTable[srcTblEntryIdx].ElementsCount * pNVM_DataTable[srcTblEntryIdx].ElementSize;
+        /* if the bytes to copy are less then RAM table entry space, the supplementary bytes to write on the destination page
+        * will be retrieved from RAM table entry. This is the case when the RAM table has been updated and the new
+        * entry's elements count is greater then the one existing in the previous RAM table, now stored in the FLASH active page
+        * (source page) */
+        if(size < ramSize)
+        {
+            diffSize = ramSize - size;
+            diffIdx = size / pNVM_DataTable[srcTblEntryIdx].ElementSize;
+        }
+    }
+
+    while(size)
+    {
+        if(size > (uint16_t)gNvCacheBufferSize_c)
+        {
+            /* copy from FLASH to cache buffer */
+            NV_FlashRead(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + srcMetaInfo->fields.NvmRecordOffset + innerOffset,
+                         (uint8_t*)&cacheBuffer[0], (uint16_t)gNvCacheBufferSize_c);
+
+            /* write to destination page */
+            if(kStatus_FLASH_Success == NV_FlashProgramUnaligned(dstAddress, (uint16_t)gNvCacheBufferSize_c, cacheBuffer))
+            {
+                /* update the destination record address copy */
+                dstAddress += (uint16_t)gNvCacheBufferSize_c;
+                /* update the record size */
+                size -= (uint16_t)gNvCacheBufferSize_c;
+                /* update the inner offset value */
+                innerOffset += (uint16_t)gNvCacheBufferSize_c;
+
+                continue;
+            }
+            return gNVM_RecordWriteError_c;
+        }
+        else
+        {
+            /* copy from FLASH to cache buffer */
+            NV_FlashRead(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + srcMetaInfo->fields.NvmRecordOffset + innerOffset,
+                         (uint8_t*)&cacheBuffer[0], size);
+            /* write to destination page */
+            if(kStatus_FLASH_Success == NV_FlashProgramUnaligned(dstAddress, (uint16_t)size, cacheBuffer))
+            {
+                break;
+            }
+            return gNVM_RecordWriteError_c;
+        }
+    }
+
+    if(diffSize)
+    {
+        /* update the destination record address copy */
+        dstAddress += size;
+
+        /* check alignment and adjust it if necessary */
+        misalignedBytes = dstAddress - (dstAddress & ((uint32_t)~(PGM_SIZE_BYTE-1)));
+
+        /* initialise the inner offset */
+        innerOffset = 0;
+
+        /* check if the destination is longword aligned or not */
+        if(misalignedBytes)
+        {
+            /* align to previous 32 bit boundary */
+            dstAddress &= ((uint32_t)~(PGM_SIZE_BYTE-1));
+
+            /* compute the loop end */
+            loopEnd = PGM_SIZE_BYTE - misalignedBytes;
+
+            /* read from destination page to cache buffer */
+            NV_FlashRead(dstAddress, (uint8_t*)&cacheBuffer[0], PGM_SIZE_BYTE);
+
+            /* update with data from RAM */
+            for(loopIdx = 0; loopIdx < loopEnd; loopIdx++)
+            {
+                cacheBuffer[misalignedBytes] = *((uint8_t*)pNVM_DataTable[srcTblEntryIdx].pData +
                                                  (diffIdx * pNVM_DataTable[srcTblEntryIdx].ElementSize) + innerOffset);
                 innerOffset++;
                 misalignedBytes++;
@@ -3764,7 +5625,7 @@ static NVM_Status_t NvInternalCopy
  *               [IN] dataEntryId - table entry ID
  * Return: the value of the meta address
  *****************************************************************************/
-#if gNvFragmentation_Enabled_d
+#if gNvFragmentation_Enabled_d || gNvUseDeltaRecords_c
 static uint32_t NvGetTblEntryMetaAddrFromId
 (
     uint32_t searchStartAddress,
@@ -3772,6 +5633,23 @@ static uint32_t NvGetTblEntryMetaAddrFromId
 )
 {
     NVM_RecordMetaInfo_t metaInfo;
+    #if gNvUseMetaIndex_c
+    NVM_MetaIndexEntry_t* pEntry;
+
+    /* the latest full record is the answer, unless it is newer than the search start */
+    pEntry = NvMetaIndexGetEntry(NvGetTableEntryIndexFromId(dataEntryId));
+    if(NULL != pEntry)
+    {
+        if(0 == pEntry->fullMetaOffset)
+        {
+            return 0;
+        }
+        if(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + pEntry->fullMetaOffset <= searchStartAddress)
+        {
+            return mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + pEntry->fullMetaOffset;
+        }
+    }
+    #endif
 
     while(searchStartAddress >= (mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c))
     {
@@ -3794,6 +5672,9 @@ static uint32_t NvGetTblEntryMetaAddrFromId
     }
     return 0;
 }
+#endif /* gNvFragmentation_Enabled_d || gNvUseDeltaRecords_c */
+
+#if gNvFragmentation_Enabled_d
 /******************************************************************************
  * Name: NvInternalDefragmentedCopy
  * Description: Performs defragmentation and copy from the source page to
@@ -3844,37 +5725,42 @@ static NVM_Status_t NvInternalDefragmentedCopy
     }
     #endif /* gNvUseExtendedFeatureSet_d */
 
-    /* clear the records offsets buffer */
-    FLib_MemSet(maNvRecordsCpyOffsets, 0, sizeof(uint16_t)*pNVM_DataTable[srcTblEntryIdx].ElementsCount);
-
-    while(metaAddress > (uint32_t)ownerRecordMetaInfo)
+    #if gNvUseMetaIndex_c
+    if(!NvMetaIndexGetRecordsOffsets(srcTblEntryIdx, (uint32_t)ownerRecordMetaInfo, srcMetaAddr))
+    #endif
     {
-        /* get meta information */
-        NvGetMetaInfo(mNvActivePageId, metaAddress, &metaInfo);
+        /* clear the records offsets buffer */
+        FLib_MemSet(maNvRecordsCpyOffsets, 0, sizeof(uint16_t)*pNVM_DataTable[srcTblEntryIdx].ElementsCount);
 
-        /* skip invalid entries and full table records */
-        if((metaInfo.fields.NvValidationStartByte != metaInfo.fields.NvValidationEndByte) ||
-           (metaInfo.fields.NvValidationStartByte != gValidationByteSingleRecord_c))
+        while(metaAddress > (uint32_t)ownerRecordMetaInfo)
         {
-            metaAddress -= sizeof(NVM_RecordMetaInfo_t);
-            continue;
-        }
+            /* get meta information */
+            NvGetMetaInfo(mNvActivePageId, metaAddress, &metaInfo);
 
-        /* check if the element still belongs to an valid RAM table entry */
-        if(metaInfo.fields.NvmElementIndex >= pNVM_DataTable[srcTblEntryIdx].ElementsCount)
-        {
-            /* the FLASH element is no longer a current RAM table entry element */
-            metaAddress -= sizeof(NVM_RecordMetaInfo_t);
-            continue;
-        }
+            /* skip invalid entries and full table records */
+            if((metaInfo.fields.NvValidationStartByte != metaInfo.fields.NvValidationEndByte) ||
+               (metaInfo.fields.NvValidationStartByte != gValidationByteSingleRecord_c))
+            {
+                metaAddress -= sizeof(NVM_RecordMetaInfo_t);
+                continue;
+            }
 
-        /* found a new single record not copied */
-        if ((metaInfo.fields.NvmDataEntryID == ownerRecordMetaInfo->fields.NvmDataEntryID) &&
-             (0 == maNvRecordsCpyOffsets[metaInfo.fields.NvmElementIndex]))
-        {
-            maNvRecordsCpyOffsets[metaInfo.fields.NvmElementIndex] = metaInfo.fields.NvmRecordOffset;
+            /* check if the element still belongs to an valid RAM table entry */
+            if(metaInfo.fields.NvmElementIndex >= pNVM_DataTable[srcTblEntryIdx].ElementsCount)
+            {
+                /* the FLASH element is no longer a current RAM table entry element */
+                metaAddress -= sizeof(NVM_RecordMetaInfo_t);
+                continue;
+            }
+
+            /* found a new single record not copied */
+            if ((metaInfo.fields.NvmDataEntryID == ownerRecordMetaInfo->fields.NvmDataEntryID) &&
+                 (0 == maNvRecordsCpyOffsets[metaInfo.fields.NvmElementIndex]))
+            {
+                maNvRecordsCpyOffsets[metaInfo.fields.NvmElementIndex] = metaInfo.fields.NvmRecordOffset;
+            }
+            metaAddress -= sizeof(NVM_RecordMetaInfo_t);
         }
-        metaAddress -= sizeof(NVM_RecordMetaInfo_t);
     }
     while (size)
     {
@@ -3940,44 +5826,528 @@ static NVM_Status_t NvInternalDefragmentedCopy
                 }
                 else
                 {
-                    FLib_MemCpy(dstBuffer + (PGM_SIZE_BYTE - space_left),
-                                (void*)(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + maNvRecordsCpyOffsets[element_idx] + element_inner_copied),
-                                copy_amount);
+                    FLib_MemCpy(dstBuffer + (PGM_SIZE_BYTE - space_left),
+                                (void*)(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + maNvRecordsCpyOffsets[element_idx] + element_inner_copied),
+                                copy_amount);
+                }
+                element_inner_copied += copy_amount;
+                break;
+            }
+        }
+        /* write the record data */
+        if(kStatus_FLASH_Success != NV_FlashProgram(dstRecordAddr + written_buffers_count * PGM_SIZE_BYTE, PGM_SIZE_BYTE, dstBuffer))
+        {
+            return gNVM_RecordWriteError_c;
+        }
+        written_buffers_count++;
+
+        /* copied all the data, exit */
+        if (size <= PGM_SIZE_BYTE)
+        {
+            break;
+        }
+        size -= PGM_SIZE_BYTE;
+    }
+
+    /* write meta information tag */
+    dstMetaInfo.fields.NvValidationStartByte = gValidationByteAllRecords_c;
+    dstMetaInfo.fields.NvmDataEntryID = ownerRecordMetaInfo->fields.NvmDataEntryID;
+    dstMetaInfo.fields.NvmElementIndex = 0;
+    dstMetaInfo.fields.NvmRecordOffset = dstRecordAddr - mNvVirtualPageProperty[(mNvActivePageId+1)%gNvVirtualPagesCount_c].NvRawSectorStartAddress;
+    dstMetaInfo.fields.NvValidationEndByte = gValidationByteAllRecords_c;
+
+    /* write the associated record meta information */
+    if(kStatus_FLASH_Success != NV_FlashProgram(dstMetaAddr, sizeof(NVM_RecordMetaInfo_t), (uint8_t*)(&dstMetaInfo)))
+    {
+        return gNVM_MetaInfoWriteError_c;
+    }
+    return status;
+}
+#endif /* gNvFragmentation_Enabled_d */
+
+#if gNvUseDeltaRecords_c
+/******************************************************************************
+ * Name: NvDeltaIsEnabled
+ * Description: Checks if the full saves of a table entry are written as
+ *              delta records, see NvSetDeltaRecords()
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: TRUE if delta records are written, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvDeltaIsEnabled
+(
+    uint16_t tableEntryIdx
+)
+{
+    uint16_t idx;
+
+    if(gNVM_MirroredInRam_c != pNVM_DataTable[tableEntryIdx].DataEntryType)
+    {
+        return FALSE;
+    }
+
+    for(idx = 0; idx < mNvDeltaEntriesCount; idx++)
+    {
+        if(maNvDeltaEntryIds[idx] == pNVM_DataTable[tableEntryIdx].DataEntryID)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+
+/******************************************************************************
+ * Name: NvDeltaIsUsed
+ * Description: Checks if the records of a table entry must be read through
+ *              its delta chain: the full saves of the entry are written as
+ *              delta records or the active page holds delta records newer
+ *              than its latest full record. An entry that is not indexed is
+ *              assumed to have delta records.
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ * Return: TRUE if the delta chain must be followed, FALSE otherwise
+ *****************************************************************************/
+static bool_t NvDeltaIsUsed
+(
+    uint16_t tableEntryIdx
+)
+{
+    #if gNvUseMetaIndex_c
+    NVM_MetaIndexEntry_t* pIndexEntry;
+    #endif
+
+    if(gNVM_MirroredInRam_c != pNVM_DataTable[tableEntryIdx].DataEntryType)
+    {
+        return FALSE;
+    }
+
+    if(NvDeltaIsEnabled(tableEntryIdx))
+    {
+        return TRUE;
+    }
+
+    #if gNvUseMetaIndex_c
+    pIndexEntry = NvMetaIndexGetEntry(tableEntryIdx);
+    if(NULL != pIndexEntry)
+    {
+        return (bool_t)(pIndexEntry->deltaMetaOffset > pIndexEntry->fullMetaOffset);
+    }
+    #endif
+    return TRUE;
+}
+
+
+/******************************************************************************
+ * Name: NvDeltaGetChain
+ * Description: Gets the latest full record of a table entry and counts the
+ *              delta records written after it
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ *               [OUT] pFullMetaAddress - the full record meta address, 0 if
+ *                                        the entry has no full record
+ *               [OUT] pLastMetaAddress - the newest meta that may belong to
+ *                                        the entry
+ * Return: the count of delta records newer than the full record
+ *****************************************************************************/
+static uint16_t NvDeltaGetChain
+(
+    uint16_t tableEntryIdx,
+    uint32_t* pFullMetaAddress,
+    uint32_t* pLastMetaAddress
+)
+{
+    NVM_RecordMetaInfo_t metaInfo;
+    uint32_t metaAddress;
+    uint16_t deltasCount = 0;
+    #if gNvUseMetaIndex_c
+    NVM_MetaIndexEntry_t* pEntry;
+    #endif
+
+    *pFullMetaAddress = 0;
+    *pLastMetaAddress = mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress;
+
+    if(gEmptyPageMetaAddress_c == *pLastMetaAddress)
+    {
+        return 0;
+    }
+
+    #if gNvUseMetaIndex_c
+    pEntry = NvMetaIndexGetEntry(tableEntryIdx);
+    if(NULL != pEntry)
+    {
+        if(0 == pEntry->fullMetaOffset)
+        {
+            return 0;
+        }
+        *pLastMetaAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + pEntry->lastMetaOffset;
+    }
+    #endif
+
+    *pFullMetaAddress = NvGetTblEntryMetaAddrFromId(*pLastMetaAddress, pNVM_DataTable[tableEntryIdx].DataEntryID);
+
+    if(0 == *pFullMetaAddress)
+    {
+        return 0;
+    }
+
+    for(metaAddress = *pFullMetaAddress + sizeof(NVM_RecordMetaInfo_t); metaAddress <= *pLastMetaAddress; metaAddress += sizeof(NVM_RecordMetaInfo_t))
+    {
+        NvGetMetaInfo(mNvActivePageId, metaAddress, &metaInfo);
+
+        if((metaInfo.fields.NvValidationStartByte == metaInfo.fields.NvValidationEndByte) &&
+           (gValidationByteDeltaRecord_c == metaInfo.fields.NvValidationStartByte) &&
+           (metaInfo.fields.NvmDataEntryID == pNVM_DataTable[tableEntryIdx].DataEntryID))
+        {
+            deltasCount++;
+        }
+    }
+    return deltasCount;
+}
+
+
+/******************************************************************************
+ * Name: NvDeltaReadImage
+ * Description: Reads a window of a table entry image: the latest full record
+ *              with the newer delta and single records applied, in the order
+ *              they were written
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ *               [IN] fullMetaAddress - the full record meta address
+ *               [IN] lastMetaAddress - the newest meta to apply
+ *               [IN] offset - the window offset in the image
+ *               [IN] length - the window length
+ *               [OUT] pDst - the window image
+ * Return: -
+ *****************************************************************************/
+static void NvDeltaReadImage
+(
+    uint16_t tableEntryIdx,
+    uint32_t fullMetaAddress,
+    uint32_t lastMetaAddress,
+    uint32_t offset,
+    uint32_t length,
+    uint8_t* pDst
+)
+{
+    NVM_RecordMetaInfo_t metaInfo;
+    uint32_t pageAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress;
+    uint32_t metaAddress;
+    uint32_t elementStart;
+    uint32_t from;
+    uint32_t to;
+
+    NvGetMetaInfo(mNvActivePageId, fullMetaAddress, &metaInfo);
+    NV_FlashRead(pageAddress + metaInfo.fields.NvmRecordOffset + offset, pDst, length);
+
+    for(metaAddress = fullMetaAddress + sizeof(NVM_RecordMetaInfo_t); metaAddress <= lastMetaAddress; metaAddress += sizeof(NVM_RecordMetaInfo_t))
+    {
+        NvGetMetaInfo(mNvActivePageId, metaAddress, &metaInfo);
+
+        if((metaInfo.fields.NvValidationStartByte != metaInfo.fields.NvValidationEndByte) ||
+           (metaInfo.fields.NvmDataEntryID != pNVM_DataTable[tableEntryIdx].DataEntryID))
+        {
+            continue;
+        }
+
+        if(gValidationByteDeltaRecord_c == metaInfo.fields.NvValidationStartByte)
+        {
+            NvDeltaApply(pageAddress + metaInfo.fields.NvmRecordOffset, metaInfo.fields.NvmElementIndex, offset, length, pDst);
+        }
+        else if(gValidationByteSingleRecord_c == metaInfo.fields.NvValidationStartByte)
+        {
+            /* the part of the element inside the window */
+            elementStart = (uint32_t)metaInfo.fields.NvmElementIndex * pNVM_DataTable[tableEntryIdx].ElementSize;
+            from = (elementStart > offset) ? elementStart : offset;
+            to = elementStart + pNVM_DataTable[tableEntryIdx].ElementSize;
+            if(to > offset + length)
+            {
+                to = offset + length;
+            }
+            if(from < to)
+            {
+                NV_FlashRead(pageAddress + metaInfo.fields.NvmRecordOffset + (from - elementStart), pDst + (from - offset), to - from);
+            }
+        }
+    }
+}
+
+
+/******************************************************************************
+ * Name: NvDeltaApply
+ * Description: Applies the part of a delta record that falls in a window of
+ *              the table entry image
+ * Parameter(s): [IN] recordAddress - the delta record address
+ *               [IN] recordSize - the delta record size
+ *               [IN] offset - the window offset in the image
+ *               [IN] length - the window length
+ *               [IN/OUT] pDst - the window image
+ * Return: -
+ *****************************************************************************/
+static void NvDeltaApply
+(
+    uint32_t recordAddress,
+    uint16_t recordSize,
+    uint32_t offset,
+    uint32_t length,
+    uint8_t* pDst
+)
+{
+    uint8_t token[2];
+    uint16_t recordIdx = 0;
+    uint32_t position = 0;
+    uint32_t runSize;
+    uint32_t from;
+    uint32_t to;
+
+    while((recordIdx + sizeof(token) <= recordSize) && (position < offset + length))
+    {
+        NV_FlashRead(recordAddress + recordIdx, token, sizeof(token));
+        recordIdx += sizeof(token);
+        position += token[0];
+        runSize = token[1] & gNvDeltaRunSizeMax_c;
+
+        /* the part of the run inside the window */
+        from = (position > offset) ? position : offset;
+        to = ((position + runSize) < (offset + length)) ? (position + runSize) : (offset + length);
+        if(from < to)
+        {
+            if(token[1] & gNvDeltaZeroRun_c)
+            {
+                FLib_MemSet(pDst + (from - offset), 0, to - from);
+            }
+            else
+            {
+                NV_FlashRead(recordAddress + recordIdx + (from - position), pDst + (from - offset), to - from);
+            }
+        }
+
+        if(!(token[1] & gNvDeltaZeroRun_c))
+        {
+            recordIdx += runSize;
+        }
+        position += runSize;
+    }
+}
+
+
+/******************************************************************************
+ * Name: NvDeltaPutRun
+ * Description: Appends a run of changed bytes to the delta record buffer
+ * Parameter(s): [IN/OUT] pRecordSize - the delta record size
+ *               [IN] skip - the count of unchanged bytes before the run
+ *               [IN] pRun - the run bytes
+ *               [IN] runSize - the run size, up to gNvDeltaRunSizeMax_c
+ * Return: FALSE if the delta record buffer is full, TRUE otherwise
+ *****************************************************************************/
+static bool_t NvDeltaPutRun
+(
+    uint16_t* pRecordSize,
+    uint32_t skip,
+    uint8_t* pRun,
+    uint16_t runSize
+)
+{
+    uint16_t idx;
+    bool_t zeroRun = TRUE;
+
+    /* the unchanged bytes that don't fit in the token take empty runs */
+    while(skip > gNvDeltaSkipMax_c)
+    {
+        if(*pRecordSize + 2 > (uint16_t)gNvDeltaRecordMaxSize_c)
+        {
+            return FALSE;
+        }
+        maNvDeltaRecord[(*pRecordSize)++] = gNvDeltaSkipMax_c;
+        maNvDeltaRecord[(*pRecordSize)++] = 0;
+        skip -= gNvDeltaSkipMax_c;
+    }
+
+    for(idx = 0; idx < runSize; idx++)
+    {
+        if(0 != pRun[idx])
+        {
+            zeroRun = FALSE;
+            break;
+        }
+    }
+
+    if(*pRecordSize + 2 + (zeroRun ? 0 : runSize) > (uint16_t)gNvDeltaRecordMaxSize_c)
+    {
+        return FALSE;
+    }
+
+    maNvDeltaRecord[(*pRecordSize)++] = (uint8_t)skip;
+    if(zeroRun)
+    {
+        maNvDeltaRecord[(*pRecordSize)++] = (uint8_t)(gNvDeltaZeroRun_c | runSize);
+    }
+    else
+    {
+        maNvDeltaRecord[(*pRecordSize)++] = (uint8_t)runSize;
+        FLib_MemCpy(&maNvDeltaRecord[*pRecordSize], pRun, runSize);
+        *pRecordSize += runSize;
+    }
+    return TRUE;
+}
+
+
+/******************************************************************************
+ * Name: NvDeltaPrepare
+ * Description: Builds the delta record of a full save in maNvDeltaRecord,
+ *              against the table entry image in storage
+ * Parameter(s): [IN] tableEntryIdx - table entry index
+ *               [OUT] pRecordSize - the delta record size, 0 if the image in
+ *                                   storage is up to date
+ * Return: TRUE if the delta record is to be written, FALSE if a full record
+ *         is to be written instead
+ *****************************************************************************/
+static bool_t NvDeltaPrepare
+(
+    uint16_t tableEntryIdx,
+    uint16_t* pRecordSize
+)
+{
+    uint8_t cacheBuffer[gNvCacheBufferSize_c];
+    uint8_t* pData = (uint8_t*)pNVM_DataTable[tableEntryIdx].pData;
+    uint32_t size = (uint32_t)pNVM_DataTable[tableEntryIdx].ElementsCount * pNVM_DataTable[tableEntryIdx].ElementSize;
+    uint32_t fullMetaAddress;
+    uint32_t lastMetaAddress;
+    uint32_t offset;
+    uint32_t chunk;
+    uint32_t idx;
+    uint32_t skip = 0;
+    uint32_t runStart = 0;
+    uint16_t runSize = 0;
+
+    *pRecordSize = 0;
+
+    if(!NvDeltaIsEnabled(tableEntryIdx) ||
+       (NvDeltaGetChain(tableEntryIdx, &fullMetaAddress, &lastMetaAddress) >= (uint16_t)gNvDeltaCheckpointInterval_c) ||
+       (0 == fullMetaAddress))
+    {
+        return FALSE;
+    }
+
+    for(offset = 0; offset < size; offset += chunk)
+    {
+        chunk = size - offset;
+        if(chunk > (uint32_t)gNvCacheBufferSize_c)
+        {
+            chunk = (uint32_t)gNvCacheBufferSize_c;
+        }
+        NvDeltaReadImage(tableEntryIdx, fullMetaAddress, lastMetaAddress, offset, chunk, cacheBuffer);
+
+        for(idx = 0; idx < chunk; idx++)
+        {
+            if(cacheBuffer[idx] == pData[offset + idx])
+            {
+                if(runSize)
+                {
+                    if(!NvDeltaPutRun(pRecordSize, skip, &pData[runStart], runSize))
+                    {
+                        return FALSE;
+                    }
+                    skip = 0;
+                    runSize = 0;
+                }
+                skip++;
+                continue;
+            }
+
+            if(gNvDeltaRunSizeMax_c == runSize)
+            {
+                if(!NvDeltaPutRun(pRecordSize, skip, &pData[runStart], runSize))
+                {
+                    return FALSE;
                 }
-                element_inner_copied += copy_amount;
-                break;
+                skip = 0;
+                runSize = 0;
+            }
+            if(0 == runSize)
+            {
+                runStart = offset + idx;
             }
+            runSize++;
         }
-        /* write the record data */
-        if(kStatus_FLASH_Success != NV_FlashProgram(dstRecordAddr + written_buffers_count * PGM_SIZE_BYTE, PGM_SIZE_BYTE, dstBuffer))
+    }
+
+    if(runSize && !NvDeltaPutRun(pRecordSize, skip, &pData[runStart], runSize))
+    {
+        return FALSE;
+    }
+
+    /* a full record is written when it is not larger */
+    return (NvUpdateSize(*pRecordSize) < NvUpdateSize(size)) ? TRUE : FALSE;
+}
+
+
+/******************************************************************************
+ * Name: NvDeltaCopy
+ * Description: Writes the image of a table entry, see NvDeltaReadImage(), as
+ *              a full record of the destination page
+ * Parameter(s): [IN] srcMetaAddr - the newest source meta of the entry
+ *               [IN] fullMetaAddr - the latest source full record meta
+ *               [IN] srcTblEntryIdx - source page table entry index
+ *               [IN] dstMetaAddr - destination meta address
+ *               [IN] dstRecordAddr - destination record address (to copy to)
+ *               [IN] size - the bytes taken from the source page; the rest
+ *                           of the RAM table entry is taken from RAM
+ * Return: the status of the operation
+ *****************************************************************************/
+static NVM_Status_t NvDeltaCopy
+(
+    uint32_t srcMetaAddr,
+    uint32_t fullMetaAddr,
+    uint16_t srcTblEntryIdx,
+    uint32_t dstMetaAddr,
+    uint32_t dstRecordAddr,
+    uint32_t size
+)
+{
+    uint8_t cacheBuffer[gNvCacheBufferSize_c];
+    NVM_RecordMetaInfo_t dstMetaInfo;
+    uint32_t ramSize = (uint32_t)pNVM_DataTable[srcTblEntryIdx].ElementsCount * pNVM_DataTable[srcTblEntryIdx].ElementSize;
+    uint32_t offset;
+    uint32_t chunk;
+    uint32_t imageBytes;
+
+    for(offset = 0; offset < ramSize; offset += chunk)
+    {
+        chunk = ramSize - offset;
+        if(chunk > (uint32_t)gNvCacheBufferSize_c)
         {
-            return gNVM_RecordWriteError_c;
+            chunk = (uint32_t)gNvCacheBufferSize_c;
         }
-        written_buffers_count++;
 
-        /* copied all the data, exit */
-        if (size <= PGM_SIZE_BYTE)
+        imageBytes = 0;
+        if(offset < size)
         {
-            break;
+            imageBytes = ((size - offset) < chunk) ? (size - offset) : chunk;
+            NvDeltaReadImage(srcTblEntryIdx, fullMetaAddr, srcMetaAddr, offset, imageBytes, cacheBuffer);
+        }
+        if(imageBytes < chunk)
+        {
+            /* the elements added by a RAM table update */
+            FLib_MemCpy(&cacheBuffer[imageBytes], (uint8_t*)pNVM_DataTable[srcTblEntryIdx].pData + offset + imageBytes, chunk - imageBytes);
+        }
+
+        if(kStatus_FLASH_Success != NV_FlashProgramUnaligned(dstRecordAddr + offset, chunk, cacheBuffer))
+        {
+            return gNVM_RecordWriteError_c;
         }
-        size -= PGM_SIZE_BYTE;
     }
 
     /* write meta information tag */
     dstMetaInfo.fields.NvValidationStartByte = gValidationByteAllRecords_c;
-    dstMetaInfo.fields.NvmDataEntryID = ownerRecordMetaInfo->fields.NvmDataEntryID;
+    dstMetaInfo.fields.NvmDataEntryID = pNVM_DataTable[srcTblEntryIdx].DataEntryID;
     dstMetaInfo.fields.NvmElementIndex = 0;
-    dstMetaInfo.fields.NvmRecordOffset = dstRecordAddr - mNvVirtualPageProperty[(mNvActivePageId+1)%2].NvRawSectorStartAddress;
+    dstMetaInfo.fields.NvmRecordOffset = dstRecordAddr - mNvVirtualPageProperty[(mNvActivePageId+1)%gNvVirtualPagesCount_c].NvRawSectorStartAddress;
     dstMetaInfo.fields.NvValidationEndByte = gValidationByteAllRecords_c;
 
-    /* write the associated record meta information */
-    if(kStatus_FLASH_Success != NV_FlashProgram(dstMetaAddr, sizeof(NVM_RecordMetaInfo_t), (uint8_t*)(&dstMetaInfo)))
+    if(kStatus_FLASH_Success != NV_FlashProgramUnaligned(dstMetaAddr, sizeof(NVM_RecordMetaInfo_t), (uint8_t*)(&dstMetaInfo)))
     {
         return gNVM_MetaInfoWriteError_c;
     }
-    return status;
+    return gNVM_OK_c;
 }
-#endif /* gNvFragmentation_Enabled_d */
+#endif /* gNvUseDeltaRecords_c */
 
 /******************************************************************************
  * Name: NvCopyPage
@@ -3987,7 +6357,7 @@ static NVM_Status_t NvInternalDefragmentedCopy
  *              saved priori and newer than the table entry. If one or more
  *              elements were singular saved and the NV page doesn't has a
  *              full table entry saved, then the elements are copied as they
- *              are.
+ *              are. A copy started by the idle task is completed.
  * Parameter(s): [IN] skipEntryId - the entry ID to be skipped when page
  *                                  copy is performed
  * Return: gNVM_InvalidPageID_c - if the source or destination page is not
@@ -4002,17 +6372,161 @@ static NVM_Status_t NvCopyPage
 (
     NvTableEntryId_t skipEntryId
 )
+{
+    return NvCopyPageSlice(skipEntryId, FALSE);
+}
+
+/******************************************************************************
+ * Name: NvCopyPageSlice
+ * Description: Starts or continues a page copy, see NvCopyPage(). When
+ *              sliced, at most gNvCopySliceRecordsCount_c records or
+ *              gNvCopySliceBytesCount_c bytes are written per call and the
+ *              last call only commits the copy.
+ * Parameter(s): [IN] skipEntryId - the entry ID to be skipped when page
+ *                                  copy is performed
+ *               [IN] sliced - TRUE to write only a part of the copy
+ * Return: gNVM_PageCopyPending_c - if the copy is not completed yet
+ *         the NvCopyPage() return values otherwise
+ *****************************************************************************/
+static NVM_Status_t NvCopyPageSlice
+(
+    NvTableEntryId_t skipEntryId,
+    bool_t sliced
+)
+{
+    NVM_Status_t status = gNVM_OK_c;
+    #if gNvUseMetaIndex_c
+    NVM_RecordMetaInfo_t metaInfo;
+    uint32_t metaAddress;
+    #endif
+
+    /* the destination page holds the records of another copy: start over */
+    #if gNvUseExtendedFeatureSet_d
+    if(mNvCopyState.inProgress && ((mNvCopyState.skipEntryId != skipEntryId) || mNvTableUpdated))
+    #else
+    if(mNvCopyState.inProgress && (mNvCopyState.skipEntryId != skipEntryId))
+    #endif
+    {
+        mNvCopyState.inProgress = FALSE;
+    }
+
+    if(!mNvCopyState.inProgress)
+    {
+        status = NvCopyPageStart(skipEntryId);
+    }
+    else if(mNvCopyState.resumed)
+    {
+        /* the source page didn't change since the copy was interrupted: walk it
+           again, the records found in the destination page are not copied twice */
+        mNvCopyState.srcMetaAddress = mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress;
+        mNvCopyState.resumed = FALSE;
+        #if gNvUseMetaIndex_c
+        NvMetaIndexClearCopied();
+        metaAddress = mNvVirtualPageProperty[(mNvActivePageId + 1) % gNvVirtualPagesCount_c].NvRawSectorStartAddress + gNvFirstMetaOffset_c;
+        while(metaAddress < mNvCopyState.dstMetaAddress)
+        {
+            NV_FlashRead(metaAddress, (uint8_t*)&metaInfo, sizeof(metaInfo));
+            if(metaInfo.fields.NvValidationStartByte == metaInfo.fields.NvValidationEndByte)
+            {
+                if(gValidationByteAllRecords_c == metaInfo.fields.NvValidationStartByte)
+                {
+                    NvMetaIndexSetCopied(NvGetTableEntryIndexFromId(metaInfo.fields.NvmDataEntryID), gNvInvalidElementIndex_c);
+                }
+                else if(gValidationByteSingleRecord_c == metaInfo.fields.NvValidationStartByte)
+                {
+                    NvMetaIndexSetCopied(NvGetTableEntryIndexFromId(metaInfo.fields.NvmDataEntryID), metaInfo.fields.NvmElementIndex);
+                }
+            }
+            metaAddress += sizeof(NVM_RecordMetaInfo_t);
+        }
+        #endif
+    }
+
+    if(gNVM_OK_c == status)
+    {
+        status = NvCopyPageRecords(sliced);
+    }
+
+    if(gNVM_OK_c == status)
+    {
+        status = NvCopyPageCommit();
+    }
+
+    if((gNVM_OK_c != status) && (gNVM_PageCopyPending_c != status))
+    {
+        /* the partial copy is erased on the next attempt */
+        mNvCopyState.inProgress = FALSE;
+    }
+    return status;
+}
+
+/******************************************************************************
+ * Name: NvCopyPageStart
+ * Description: Prepares the destination page of a page copy
+ * Parameter(s): [IN] skipEntryId - the entry ID to be skipped when page
+ *                                  copy is performed
+ * Return: gNVM_OK_c or the NvEraseVirtualPage() errors
+ *****************************************************************************/
+static NVM_Status_t NvCopyPageStart
+(
+    NvTableEntryId_t skipEntryId
+)
+{
+    NVM_VirtualPageID_t dstPageId;
+    NVM_Status_t status;
+
+    dstPageId = (NVM_VirtualPageID_t)((mNvActivePageId+1)%gNvVirtualPagesCount_c);
+
+    /* Check if the destination page is blank. If not, erase it. The next ring
+       page is normally known to be blank, erased by the idle task beforehand. */
+    if(!NvIsPageKnownBlank(dstPageId) && (gNVM_PageIsNotBlank_c == NvVirtualPageBlankCheck(dstPageId)))
+    {
+        status = NvEraseVirtualPage(dstPageId);
+        if(gNVM_OK_c != status)
+        {
+            return status;
+        }
+    }
+    #if gNvUseRing_c
+    mNvRingBlankPages &= ~(1UL << dstPageId);
+    #endif
+    #if gNvUseMetaIndex_c
+    NvMetaIndexClearCopied();
+    #endif
+
+    /* initialise the destination page meta info and record start addresses */
+    mNvCopyState.dstMetaAddress = mNvVirtualPageProperty[dstPageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c;
+    mNvCopyState.dstRecordAddress = mNvVirtualPageProperty[dstPageId].NvRawSectorEndAddress - sizeof(NVM_TableInfo_t) + 1;
+    mNvCopyState.srcMetaAddress = mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress;
+    mNvCopyState.skipEntryId = skipEntryId;
+    mNvCopyState.resumed = FALSE;
+    mNvCopyState.inProgress = TRUE;
+    return gNVM_OK_c;
+}
+
+/******************************************************************************
+ * Name: NvCopyPageRecords
+ * Description: Writes the records of the page copy to the destination page,
+ *              walking the source page from the newest meta to the oldest one
+ * Parameter(s): [IN] sliced - TRUE to stop after a slice of records
+ * Return: gNVM_PageCopyPending_c - if records are left to be copied
+ *         gNVM_OK_c - if all the records were copied
+ *         the NvCopyPage() errors otherwise
+ *****************************************************************************/
+static NVM_Status_t NvCopyPageRecords
+(
+    bool_t sliced
+)
 {
     /* source page related variables */
-    uint32_t srcMetaAddress;
+    uint32_t srcMetaAddress = mNvCopyState.srcMetaAddress;
     NVM_RecordMetaInfo_t srcMetaInfo;
     uint16_t srcTableEntryIdx;
 
     /* destination page related variables */
-    uint32_t dstMetaAddress;
-    uint32_t firstMetaAddress;
+    uint32_t dstMetaAddress = mNvCopyState.dstMetaAddress;
     NVM_VirtualPageID_t dstPageId;
-    uint32_t dstRecordAddress;
+    uint32_t dstRecordAddress = mNvCopyState.dstRecordAddress;
 
     #if gNvUseExtendedFeatureSet_d
     uint16_t idx;
@@ -4020,263 +6534,376 @@ static NVM_Status_t NvCopyPage
     NVM_DataEntry_t flashDataEntry;
     bool_t tableUpgraded = FALSE;
     #endif /* gNvUseExtendedFeatureSet_d */
-    #if gNvFragmentation_Enabled_d
+    #if gNvFragmentation_Enabled_d || gNvUseDeltaRecords_c
     uint32_t tblEntryMetaAddress = 0;
     #endif
     uint32_t bytesToCopy;
+    NvTableEntryId_t skipEntryId = mNvCopyState.skipEntryId;
 
     /* status variable */
-    NVM_Status_t status;
-
-    dstPageId = (NVM_VirtualPageID_t)((mNvActivePageId+1)%2);
+    NVM_Status_t status = gNVM_OK_c;
 
-    /* Check if the destination page is blank. If not, erase it. */
-    if(gNVM_PageIsNotBlank_c == NvVirtualPageBlankCheck(dstPageId))
+    /*if src is an empty page, just copy the table and make the initialisations*/
+    if (srcMetaAddress == gEmptyPageMetaAddress_c)
     {
-        status = NvEraseVirtualPage(dstPageId);
-        if(gNVM_OK_c != status)
-        {
-            return status;
-        }
+        return gNVM_OK_c;
     }
-    /* initialise the destination page meta info start address */
-    dstMetaAddress = mNvVirtualPageProperty[dstPageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c;
+
+    dstPageId = (NVM_VirtualPageID_t)((mNvActivePageId+1)%gNvVirtualPagesCount_c);
     #if gNvUseExtendedFeatureSet_d
     if (mNvTableUpdated)
         tableUpgraded = (GetFlashTableVersion() != mNvFlashTableVersion);
     #endif
 
-    firstMetaAddress = dstMetaAddress;
-    /*if src is an empty page, just copy the table and make the initialisations*/
-    srcMetaAddress = mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress;
-    if (srcMetaAddress != gEmptyPageMetaAddress_c)
+    while(srcMetaAddress >= (mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c))
     {
-        /* initialise the destination page record start address */
-        dstRecordAddress = mNvVirtualPageProperty[dstPageId].NvRawSectorEndAddress - sizeof(NVM_TableInfo_t) + 1;
-
-        while(srcMetaAddress >= (mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c))
+        /* the slice is over, the flash program time of a call is bounded */
+        if(sliced && (((dstMetaAddress - mNvCopyState.dstMetaAddress) >= gNvCopySliceRecordsCount_c * sizeof(NVM_RecordMetaInfo_t)) ||
+                      ((mNvCopyState.dstRecordAddress - dstRecordAddress) >= gNvCopySliceBytesCount_c)))
         {
-            /* get current meta information */
-            (void)NvGetMetaInfo(mNvActivePageId, srcMetaAddress, &srcMetaInfo);
+            status = gNVM_PageCopyPending_c;
+            break;
+        }
 
-            #if gNvUseExtendedFeatureSet_d
-            /* NV RAM table has been updated */
-            if(mNvTableUpdated)
-            {
-                idx = 0;
-                entryFound = FALSE;
+        /* get current meta information */
+        (void)NvGetMetaInfo(mNvActivePageId, srcMetaAddress, &srcMetaInfo);
 
-                /* check if the saved entry is still present in the new RAM table */
-                while(gNvEndOfTableId_c != pNVM_DataTable[idx].DataEntryID)
-                {
-                    if(srcMetaInfo.fields.NvmDataEntryID == pNVM_DataTable[idx].DataEntryID)
-                    {
-                        entryFound = TRUE;
-                        break;
-                    }
-                    idx++;
-                }
+        #if gNvUseExtendedFeatureSet_d
+        /* NV RAM table has been updated */
+        if(mNvTableUpdated)
+        {
+            idx = 0;
+            entryFound = FALSE;
 
-                if(!entryFound)
+            /* check if the saved entry is still present in the new RAM table */
+            while(gNvEndOfTableId_c != pNVM_DataTable[idx].DataEntryID)
+            {
+                if(srcMetaInfo.fields.NvmDataEntryID == pNVM_DataTable[idx].DataEntryID)
                 {
-                    /* move to the next meta info */
-                    srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
-                    continue;
+                    entryFound = TRUE;
+                    break;
                 }
+                idx++;
             }
-            #endif /* gNvUseExtendedFeatureSet_d */
-
-            /* get table entry index */
-            srcTableEntryIdx = NvGetTableEntryIndexFromId(srcMetaInfo.fields.NvmDataEntryID);
 
-            if((srcMetaInfo.fields.NvValidationStartByte != srcMetaInfo.fields.NvValidationEndByte) ||
-               (srcTableEntryIdx == gNvInvalidDataEntry_c) ||
-               (srcMetaInfo.fields.NvmDataEntryID == skipEntryId) ||
-               NvIsRecordCopied(dstPageId, &srcMetaInfo))
+            if(!entryFound)
             {
-                /* go to the next meta information tag */
+                /* move to the next meta info */
                 srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
                 continue;
             }
+        }
+        #endif /* gNvUseExtendedFeatureSet_d */
+
+        /* get table entry index */
+        srcTableEntryIdx = NvGetTableEntryIndexFromId(srcMetaInfo.fields.NvmDataEntryID);
+
+        if((srcMetaInfo.fields.NvValidationStartByte != srcMetaInfo.fields.NvValidationEndByte) ||
+           (srcTableEntryIdx == gNvInvalidDataEntry_c) ||
+           (srcMetaInfo.fields.NvmDataEntryID == skipEntryId) ||
+           #if gNvUseMetaIndex_c
+           NvMetaIndexIsRecordCopied(srcTableEntryIdx, dstPageId, &srcMetaInfo))
+           #else
+           NvIsRecordCopied(dstPageId, &srcMetaInfo))
+           #endif
+        {
+            /* go to the next meta information tag */
+            srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
+            continue;
+        }
+
+        if((srcMetaInfo.fields.NvValidationStartByte != gValidationByteSingleRecord_c) &&
+           #if gNvUseDeltaRecords_c
+           (srcMetaInfo.fields.NvValidationStartByte != gValidationByteDeltaRecord_c) &&
+           #endif
+           (srcMetaInfo.fields.NvValidationStartByte != gValidationByteAllRecords_c))
+        {
+            /* go to the next meta information tag */
+            srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
+            continue;
+        }
 
-            if((srcMetaInfo.fields.NvValidationStartByte != gValidationByteSingleRecord_c) &&
-               (srcMetaInfo.fields.NvValidationStartByte != gValidationByteAllRecords_c))
+        #if gUnmirroredFeatureSet_d
+        if (gNVM_MirroredInRam_c != pNVM_DataTable[srcTableEntryIdx].DataEntryType)
+        {
+            /*check if the data was erased using NvErase or is just uninitialised*/
+            if (NULL == ((void**)pNVM_DataTable[srcTableEntryIdx].pData)[srcMetaInfo.fields.NvmElementIndex] &&
+                NvIsRecordErased(srcTableEntryIdx, srcMetaInfo.fields.NvmElementIndex, srcMetaAddress))
             {
                 /* go to the next meta information tag */
                 srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
                 continue;
             }
+        }
+        #endif
+        /* compute the destination record start address */
+        bytesToCopy = pNVM_DataTable[srcTableEntryIdx].ElementsCount * pNVM_DataTable[srcTableEntryIdx].ElementSize;
 
-            #if gUnmirroredFeatureSet_d
-            if (gNVM_MirroredInRam_c != pNVM_DataTable[srcTableEntryIdx].DataEntryType)
+        #if gNvUseExtendedFeatureSet_d
+        /* NV RAM table has been updated */
+        if(mNvTableUpdated)
+        {
+            if(NvGetTableEntry(pNVM_DataTable[srcTableEntryIdx].DataEntryID, &flashDataEntry))
             {
-                /*check if the data was erased using NvErase or is just uninitialised*/
-                if (NULL == ((void**)pNVM_DataTable[srcTableEntryIdx].pData)[srcMetaInfo.fields.NvmElementIndex] &&
-                    NvIsRecordErased(srcTableEntryIdx, srcMetaInfo.fields.NvmElementIndex, srcMetaAddress))
+                /* entries changed from mirrored/unmirrored and with different entry size cannot be recovered */
+                if (((flashDataEntry.DataEntryType != pNVM_DataTable[srcTableEntryIdx].DataEntryType) &&
+                     ((gNVM_MirroredInRam_c == flashDataEntry.DataEntryType) || (gNVM_MirroredInRam_c == pNVM_DataTable[srcTableEntryIdx].DataEntryType)))
+                    || (flashDataEntry.ElementSize != pNVM_DataTable[srcTableEntryIdx].ElementSize))
                 {
-                    /* go to the next meta information tag */
                     srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
                     continue;
                 }
-            }
-            #endif
-            /* compute the destination record start address */
-            bytesToCopy = pNVM_DataTable[srcTableEntryIdx].ElementsCount * pNVM_DataTable[srcTableEntryIdx].ElementSize;
 
-            #if gNvUseExtendedFeatureSet_d
-            /* NV RAM table has been updated */
-            if(mNvTableUpdated)
-            {
-                if(NvGetTableEntry(pNVM_DataTable[srcTableEntryIdx].DataEntryID, &flashDataEntry))
+                if(flashDataEntry.ElementsCount != pNVM_DataTable[srcTableEntryIdx].ElementsCount)
                 {
-                    /* entries changed from mirrored/unmirrored and with different entry size cannot be recovered */
-                    if (((flashDataEntry.DataEntryType != pNVM_DataTable[srcTableEntryIdx].DataEntryType) &&
-                         ((gNVM_MirroredInRam_c == flashDataEntry.DataEntryType) || (gNVM_MirroredInRam_c == pNVM_DataTable[srcTableEntryIdx].DataEntryType)))
-                        || (flashDataEntry.ElementSize != pNVM_DataTable[srcTableEntryIdx].ElementSize))
-                    {
-                        srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
-                        continue;
-                    }
-
-                    if(flashDataEntry.ElementsCount != pNVM_DataTable[srcTableEntryIdx].ElementsCount)
+                    if (tableUpgraded)
                     {
-                        if (tableUpgraded)
+                        if (flashDataEntry.ElementsCount < pNVM_DataTable[srcTableEntryIdx].ElementsCount)
                         {
-                            if (flashDataEntry.ElementsCount < pNVM_DataTable[srcTableEntryIdx].ElementsCount)
-                            {
-                                /* copy only the bytes that were previously written to FLASH virtual page */
-                                bytesToCopy = flashDataEntry.ElementsCount * flashDataEntry.ElementSize;
-                            }
-                            #if gNvFragmentation_Enabled_d
-                            /*ignore if out of bounds*/
-                            if (srcMetaInfo.fields.NvValidationStartByte == gValidationByteSingleRecord_c &&
-                                srcMetaInfo.fields.NvmElementIndex >= pNVM_DataTable[srcTableEntryIdx].ElementsCount)
-                            {
-                                srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
-                                continue;
-                            }
-                            #endif
+                            /* copy only the bytes that were previously written to FLASH virtual page */
+                            bytesToCopy = flashDataEntry.ElementsCount * flashDataEntry.ElementSize;
                         }
-                        else
+                        #if gNvFragmentation_Enabled_d
+                        /*ignore if out of bounds*/
+                        if (srcMetaInfo.fields.NvValidationStartByte == gValidationByteSingleRecord_c &&
+                            srcMetaInfo.fields.NvmElementIndex >= pNVM_DataTable[srcTableEntryIdx].ElementsCount)
                         {
                             srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
                             continue;
                         }
+                        #endif
+                    }
+                    else
+                    {
+                        srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
+                        continue;
                     }
                 }
             }
-            #endif /* gNvUseExtendedFeatureSet_d */
+        }
+        #endif /* gNvUseExtendedFeatureSet_d */
 
-            #if gNvFragmentation_Enabled_d
-            if (srcMetaInfo.fields.NvValidationStartByte == gValidationByteSingleRecord_c)
-            {                
-                #if gUnmirroredFeatureSet_d
-                if(gNVM_MirroredInRam_c != pNVM_DataTable[srcTableEntryIdx].DataEntryType)
+        #if gNvUseDeltaRecords_c
+        /* the delta and single records newer than the latest full record of a
+           mirrored entry are merged with it in a new full record */
+        if((gNVM_MirroredInRam_c == pNVM_DataTable[srcTableEntryIdx].DataEntryType) &&
+           (srcMetaInfo.fields.NvValidationStartByte != gValidationByteAllRecords_c))
+        {
+            if(NvDeltaIsUsed(srcTableEntryIdx))
+            {
+                tblEntryMetaAddress = NvGetTblEntryMetaAddrFromId(srcMetaAddress, srcMetaInfo.fields.NvmDataEntryID);
+            }
+            else
+            {
+                /* no delta record to apply, the single records are merged below */
+                tblEntryMetaAddress = 0;
+            }
+
+            if(0 != tblEntryMetaAddress)
+            {
+                dstRecordAddress -= NvUpdateSize(pNVM_DataTable[srcTableEntryIdx].ElementsCount * pNVM_DataTable[srcTableEntryIdx].ElementSize);
+
+                if((status = NvDeltaCopy(srcMetaAddress, tblEntryMetaAddress, srcTableEntryIdx, dstMetaAddress, dstRecordAddress, bytesToCopy)) != gNVM_OK_c)
                 {
-                    tblEntryMetaAddress = 0;
+                    return status;
                 }
-                else
+                #if gNvUseMetaIndex_c
+                NvMetaIndexSetCopied(srcTableEntryIdx, gNvInvalidElementIndex_c);
                 #endif
-                {
-                    tblEntryMetaAddress = NvGetTblEntryMetaAddrFromId(srcMetaAddress, srcMetaInfo.fields.NvmDataEntryID);
-                }
-
-                /* if the record has no full entry associated perform simple copy */
-                if (tblEntryMetaAddress == 0)
-                {
-                    /* compute the 'real record size' taking into consideration that the FTFL controller only writes in burst of 4 bytes */
-                    bytesToCopy = pNVM_DataTable[srcTableEntryIdx].ElementSize;
-                    dstRecordAddress -= NvUpdateSize(bytesToCopy);
+                /* update destination meta information address */
+                dstMetaAddress += sizeof(NVM_RecordMetaInfo_t);
 
-                    if((status = NvInternalCopy(dstRecordAddress, dstMetaAddress, &srcMetaInfo, srcTableEntryIdx, bytesToCopy)) != gNVM_OK_c)
-                    {
-                        return status;
-                    }
-                    #if gUnmirroredFeatureSet_d
-                    if(gNVM_MirroredInRam_c != pNVM_DataTable[srcTableEntryIdx].DataEntryType)
-                    {
-                        OSA_InterruptDisable();
-                        /* set the pointer to the flash data */
-                        if (NvIsNVMFlashAddress(((void**)pNVM_DataTable[srcTableEntryIdx].pData)[srcMetaInfo.fields.NvmElementIndex]))
-                        {
-                            ((uint8_t**)pNVM_DataTable[srcTableEntryIdx].pData)[srcMetaInfo.fields.NvmElementIndex] = (uint8_t*)dstRecordAddress;
-                        }
-                        OSA_InterruptEnable();
-                    }
-                    #endif
-                    /* update destination meta information address */
-                    dstMetaAddress += sizeof(NVM_RecordMetaInfo_t);
+                /* move to the next meta info */
+                srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
+                continue;
+            }
 
-                    /* move to the next meta info */
-                    srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
-                    continue;
-                }
+            if(srcMetaInfo.fields.NvValidationStartByte == gValidationByteDeltaRecord_c)
+            {
+                /* no full record to apply the delta record to */
+                srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
+                continue;
             }
-            #endif
-            /* if the copy operation must take elements from ram */
-            #if gNvUseExtendedFeatureSet_d
-            if(mNvTableUpdated && tableUpgraded &&
-               bytesToCopy < pNVM_DataTable[srcTableEntryIdx].ElementsCount * pNVM_DataTable[srcTableEntryIdx].ElementSize)
+        }
+        #endif /* gNvUseDeltaRecords_c */
+
+        #if gNvFragmentation_Enabled_d
+        if (srcMetaInfo.fields.NvValidationStartByte == gValidationByteSingleRecord_c)
+        {                
+            #if gUnmirroredFeatureSet_d
+            if(gNVM_MirroredInRam_c != pNVM_DataTable[srcTableEntryIdx].DataEntryType)
             {
-                /* make sure the adress can hold the entire space (+ what is taken from ram) */
-                dstRecordAddress -= NvUpdateSize(pNVM_DataTable[srcTableEntryIdx].ElementsCount * pNVM_DataTable[srcTableEntryIdx].ElementSize);
+                tblEntryMetaAddress = 0;
             }
             else
             #endif
             {
-                /* compute the destination record start address */
-                dstRecordAddress -= NvUpdateSize(bytesToCopy);
+                tblEntryMetaAddress = NvGetTblEntryMetaAddrFromId(srcMetaAddress, srcMetaInfo.fields.NvmDataEntryID);
             }
 
-            #if gNvFragmentation_Enabled_d
-            /*
-            * single element record
-            */
-            if(srcMetaInfo.fields.NvValidationStartByte == gValidationByteSingleRecord_c)
+            /* if the record has no full entry associated perform simple copy */
+            if (tblEntryMetaAddress == 0)
             {
-                if((status = NvInternalDefragmentedCopy(srcMetaAddress, srcTableEntryIdx, dstMetaAddress, dstRecordAddress, (NVM_RecordMetaInfo_t *)tblEntryMetaAddress)) != gNVM_OK_c)
+                /* compute the 'real record size' taking into consideration that the FTFL controller only writes in burst of 4 bytes */
+                bytesToCopy = pNVM_DataTable[srcTableEntryIdx].ElementSize;
+                dstRecordAddress -= NvUpdateSize(bytesToCopy);
+
+                if((status = NvInternalCopy(dstRecordAddress, dstMetaAddress, &srcMetaInfo, srcTableEntryIdx, bytesToCopy)) != gNVM_OK_c)
                 {
                     return status;
                 }
+                #if gNvUseMetaIndex_c
+                NvMetaIndexSetCopied(srcTableEntryIdx, srcMetaInfo.fields.NvmElementIndex);
+                #endif
+                /* update destination meta information address */
+                dstMetaAddress += sizeof(NVM_RecordMetaInfo_t);
+
+                /* move to the next meta info */
+                srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
+                continue;
             }
-            else
-            #endif /* gNvFragmentation_Enabled_d */
-            /*
-            * full table entry
-            */
-            if((status = NvInternalCopy(dstRecordAddress, dstMetaAddress, &srcMetaInfo, srcTableEntryIdx, bytesToCopy)) != gNVM_OK_c)
+        }
+        #endif
+        /* if the copy operation must take elements from ram */
+        #if gNvUseExtendedFeatureSet_d
+        if(mNvTableUpdated && tableUpgraded &&
+           bytesToCopy < pNVM_DataTable[srcTableEntryIdx].ElementsCount * pNVM_DataTable[srcTableEntryIdx].ElementSize)
+        {
+            /* make sure the adress can hold the entire space (+ what is taken from ram) */
+            dstRecordAddress -= NvUpdateSize(pNVM_DataTable[srcTableEntryIdx].ElementsCount * pNVM_DataTable[srcTableEntryIdx].ElementSize);
+        }
+        else
+        #endif
+        {
+            /* compute the destination record start address */
+            dstRecordAddress -= NvUpdateSize(bytesToCopy);
+        }
+
+        #if gNvFragmentation_Enabled_d
+        /*
+        * single element record
+        */
+        if(srcMetaInfo.fields.NvValidationStartByte == gValidationByteSingleRecord_c)
+        {
+            if((status = NvInternalDefragmentedCopy(srcMetaAddress, srcTableEntryIdx, dstMetaAddress, dstRecordAddress, (NVM_RecordMetaInfo_t *)tblEntryMetaAddress)) != gNVM_OK_c)
             {
                 return status;
             }
+        }
+        else
+        #endif /* gNvFragmentation_Enabled_d */
+        /*
+        * full table entry
+        */
+        if((status = NvInternalCopy(dstRecordAddress, dstMetaAddress, &srcMetaInfo, srcTableEntryIdx, bytesToCopy)) != gNVM_OK_c)
+        {
+            return status;
+        }
+
+        #if gNvUseMetaIndex_c
+        /* either way, the destination page now holds a full record of the entry */
+        NvMetaIndexSetCopied(srcTableEntryIdx, gNvInvalidElementIndex_c);
+        #endif
 
-            /* update destination meta information address */
-            dstMetaAddress += sizeof(NVM_RecordMetaInfo_t);
+        /* update destination meta information address */
+        dstMetaAddress += sizeof(NVM_RecordMetaInfo_t);
 
-            /* move to the next meta info */
-            srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
-        };
+        /* move to the next meta info */
+        srcMetaAddress -= sizeof(NVM_RecordMetaInfo_t);
+    }
+
+    /* the commit gets a slice of its own */
+    if(sliced && (dstMetaAddress != mNvCopyState.dstMetaAddress))
+    {
+        status = gNVM_PageCopyPending_c;
+    }
+
+    mNvCopyState.srcMetaAddress = srcMetaAddress;
+    mNvCopyState.dstMetaAddress = dstMetaAddress;
+    mNvCopyState.dstRecordAddress = dstRecordAddress;
+    return status;
+}
+
+/******************************************************************************
+ * Name: NvCopyPageCommit
+ * Description: Makes the destination page of the page copy the active one.
+ *              Up to this point, the source page is the valid one after a
+ *              reset, with the RAM table written last.
+ * Parameter(s): -
+ * Return: gNVM_OK_c or gNVM_Error_c if the RAM table couldn't be written
+ *****************************************************************************/
+static NVM_Status_t NvCopyPageCommit
+(
+    void
+)
+{
+    NVM_VirtualPageID_t dstPageId;
+    uint32_t firstMetaAddress;
+    #if gUnmirroredFeatureSet_d
+    NVM_RecordMetaInfo_t metaInfo;
+    uint32_t metaAddress;
+    uint16_t tableEntryIdx;
+    void** ppElement;
+    #endif
+
+    dstPageId = (NVM_VirtualPageID_t)((mNvActivePageId+1)%gNvVirtualPagesCount_c);
+    firstMetaAddress = mNvVirtualPageProperty[dstPageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c;
+
+    #if gUnmirroredFeatureSet_d
+    /* the unmirrored elements still in flash now point to the copied records */
+    for(metaAddress = firstMetaAddress; metaAddress < mNvCopyState.dstMetaAddress; metaAddress += sizeof(NVM_RecordMetaInfo_t))
+    {
+        NV_FlashRead(metaAddress, (uint8_t*)&metaInfo, sizeof(metaInfo));
+        if(gValidationByteSingleRecord_c != metaInfo.fields.NvValidationStartByte ||
+           gValidationByteSingleRecord_c != metaInfo.fields.NvValidationEndByte)
+        {
+            continue;
+        }
+        tableEntryIdx = NvGetTableEntryIndexFromId(metaInfo.fields.NvmDataEntryID);
+        if((gNvInvalidTableEntryIndex_c == tableEntryIdx) ||
+           (gNVM_MirroredInRam_c == pNVM_DataTable[tableEntryIdx].DataEntryType) ||
+           (metaInfo.fields.NvmElementIndex >= pNVM_DataTable[tableEntryIdx].ElementsCount))
+        {
+            continue;
+        }
+        ppElement = &((void**)pNVM_DataTable[tableEntryIdx].pData)[metaInfo.fields.NvmElementIndex];
+        OSA_InterruptDisable();
+        /* set the pointer to the flash data */
+        if (NvIsNVMFlashAddress(*ppElement))
+        {
+            *ppElement = (void*)(mNvVirtualPageProperty[dstPageId].NvRawSectorStartAddress + metaInfo.fields.NvmRecordOffset);
+        }
+        OSA_InterruptEnable();
     }
+    #endif
+
+    mNvCopyState.inProgress = FALSE;
+
     /* make a request to erase the old page */
-    mNvErasePgCmdStatus.NvPageToErase = mNvActivePageId;
-    mNvErasePgCmdStatus.NvSectorAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress;
-    mNvErasePgCmdStatus.NvErasePending = TRUE;
+    NvSchedulePageErase(mNvActivePageId);
 
     /* update the the active page ID */
     mNvActivePageId = dstPageId;
 
     /* update the last meta info address */
-    if(dstMetaAddress == firstMetaAddress)
+    #if gNvUseMetaIndex_c
+    /* scan the new active page once; this also rebuilds the meta index */
+    (void)firstMetaAddress;
+    (void)NvUpdateLastMetaInfoAddress();
+    #else
+    if(mNvCopyState.dstMetaAddress == firstMetaAddress)
     {
         mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress = gEmptyPageMetaAddress_c;
     }
     else
     {
-        mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress = dstMetaAddress - sizeof(NVM_RecordMetaInfo_t);
+        mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress = mNvCopyState.dstMetaAddress - sizeof(NVM_RecordMetaInfo_t);
     }
 
     #if gUnmirroredFeatureSet_d
     mNvVirtualPageProperty[mNvActivePageId].NvLastMetaUnerasedInfoAddress = mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress;
     #endif
+    #endif /* gNvUseMetaIndex_c */
 
     mNvPageCounter++;
     /* save the current RAM table */
@@ -4298,6 +6925,90 @@ static NVM_Status_t NvCopyPage
     return gNVM_OK_c;
 }
 
+/******************************************************************************
+ * Name: NvCopyPageFindInterrupted
+ * Description: Looks for a page copy interrupted by a reset, for it to be
+ *              resumed by the idle task. The page following the active one
+ *              holds such a copy if its first meta is valid while its RAM
+ *              table is not written yet; a page left by a previous copy has
+ *              either its first sector erased or its RAM table written.
+ * Parameter(s): -
+ * Return: -
+ *****************************************************************************/
+static void NvCopyPageFindInterrupted
+(
+    void
+)
+{
+    NVM_VirtualPageID_t dstPageId;
+    NVM_RecordMetaInfo_t metaInfo;
+    NVM_TableInfo_t tableInfo;
+    uint32_t metaAddress;
+    uint32_t recordAddress;
+    uint32_t lowestAddress;
+    uint32_t word;
+
+    mNvCopyState.inProgress = FALSE;
+    if(gVirtualPageNone_c == mNvActivePageId)
+    {
+        return;
+    }
+
+    dstPageId = (NVM_VirtualPageID_t)((mNvActivePageId+1)%gNvVirtualPagesCount_c);
+    NV_FlashRead(mNvVirtualPageProperty[dstPageId].NvRawSectorStartAddress, (uint8_t*)&tableInfo, sizeof(tableInfo));
+    metaAddress = mNvVirtualPageProperty[dstPageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c;
+    NV_FlashRead(metaAddress, (uint8_t*)&metaInfo, sizeof(metaInfo));
+
+    if((gNvGuardValue_c != tableInfo.rawValue) ||
+       (metaInfo.fields.NvValidationStartByte != metaInfo.fields.NvValidationEndByte) ||
+       ((gValidationByteSingleRecord_c != metaInfo.fields.NvValidationStartByte) &&
+        (gValidationByteAllRecords_c != metaInfo.fields.NvValidationStartByte)))
+    {
+        return;
+    }
+
+    /* the metas up to the first blank one; the lowest record is below the others */
+    lowestAddress = mNvVirtualPageProperty[dstPageId].NvRawSectorEndAddress - sizeof(NVM_TableInfo_t) + 1;
+    while(metaAddress < lowestAddress)
+    {
+        NV_FlashRead(metaAddress, (uint8_t*)&metaInfo, sizeof(metaInfo));
+        if(gNvGuardValue_c == metaInfo.rawValue)
+        {
+            break;
+        }
+        if((metaInfo.fields.NvValidationStartByte == metaInfo.fields.NvValidationEndByte) &&
+           (0 != metaInfo.fields.NvmRecordOffset) &&
+           (mNvVirtualPageProperty[dstPageId].NvRawSectorStartAddress + metaInfo.fields.NvmRecordOffset < lowestAddress))
+        {
+            lowestAddress = mNvVirtualPageProperty[dstPageId].NvRawSectorStartAddress + metaInfo.fields.NvmRecordOffset;
+        }
+        metaAddress += sizeof(NVM_RecordMetaInfo_t);
+    }
+
+    /* a record written without its meta is left where it is */
+    for(recordAddress = metaAddress; recordAddress < lowestAddress; recordAddress += sizeof(word))
+    {
+        NV_FlashRead(recordAddress, (uint8_t*)&word, sizeof(word));
+        if(0xFFFFFFFFUL != word)
+        {
+            break;
+        }
+    }
+    recordAddress &= ~((uint32_t)PGM_SIZE_BYTE - 1);
+    if(recordAddress < metaAddress + sizeof(NVM_RecordMetaInfo_t))
+    {
+        /* no room left, the copy is started over */
+        return;
+    }
+
+    mNvCopyState.dstMetaAddress = metaAddress;
+    mNvCopyState.dstRecordAddress = recordAddress;
+    mNvCopyState.skipEntryId = gNvCopyAll_c;
+    mNvCopyState.resumed = TRUE;
+    mNvCopyState.inProgress = TRUE;
+    mNvCopyOperationIsPending = TRUE;
+}
+
 /******************************************************************************
  * Name: NvInternalFormat
  * Description: Format the NV storage system. The function erases in place both
@@ -4316,6 +7027,9 @@ static NVM_Status_t NvInternalFormat
 )
 {
     uint8_t retryCount = gNvFormatRetryCount_c;
+    #if gNvUseRing_c
+    uint32_t pageId;
+    #endif
 
     /* increment the page counter value */
     if(pageCounterValue == (uint32_t)gPageCounterMaxValue_c - 1)
@@ -4330,10 +7044,21 @@ static NVM_Status_t NvInternalFormat
 
     while(retryCount--)
     {
+        #if gNvUseRing_c
+        /* erase all ring pages */
+        for(pageId = gFirstVirtualPage_c; pageId < gNvVirtualPagesCount_c; pageId++)
+        {
+            if (gNVM_OK_c != NvEraseVirtualPage((NVM_VirtualPageID_t)pageId))
+                break;
+        }
+        if (pageId == gNvVirtualPagesCount_c)
+            break;
+        #else
         /* erase first page */
         if (gNVM_OK_c == NvEraseVirtualPage(gFirstVirtualPage_c) &&
             gNVM_OK_c == NvEraseVirtualPage(gSecondVirtualPage_c))
             break;
+        #endif
     }
 
     /* active page after format = first virtual page */
@@ -4375,6 +7100,10 @@ static bool_t NvSaveRamTable
     if(NULL == pNVM_DataTable)
         return FALSE;
 
+    #if gNvUseRing_c
+    mNvRingBlankPages &= ~(1UL << pageId);
+    #endif
+
     /* write table qualifier start */
     addr = mNvVirtualPageProperty[pageId].NvRawSectorStartAddress;
 
@@ -4451,7 +7180,7 @@ static NVM_Status_t UpgradeLegacyTable()
     uint32_t value;
     NVM_EntryInfo_t tableEntry;
 #endif
-    NVM_VirtualPageID_t dstPageId = (NVM_VirtualPageID_t)((mNvActivePageId+1)%2);
+    NVM_VirtualPageID_t dstPageId = (NVM_VirtualPageID_t)((mNvActivePageId+1)%gNvVirtualPagesCount_c);
 
     /* Check if the destination page is blank. If not, erase it. */
     if(gNVM_PageIsNotBlank_c == NvVirtualPageBlankCheck(dstPageId))
@@ -4604,9 +7333,7 @@ static NVM_Status_t UpgradeLegacyTable()
     }
 
     /* erase old page */
-    mNvErasePgCmdStatus.NvPageToErase = mNvActivePageId;
-    mNvErasePgCmdStatus.NvSectorAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress;
-    mNvErasePgCmdStatus.NvErasePending = TRUE;
+    NvSchedulePageErase(mNvActivePageId);
     /* set new active page */
     mNvActivePageId = dstPageId;
     return gNVM_OK_c;
@@ -4691,6 +7418,10 @@ static NVM_Status_t NvWriteRecord
     uint32_t pageFreeSpace;
     bool_t doWrite;
     uint32_t srcAddress;
+    #if gNvUseDeltaRecords_c
+    bool_t isDelta = FALSE;
+    uint16_t deltaSize;
+    #endif
 #else /* FlexNVM */
     uint32_t lastFlexMetaInfoAddress;
     NVM_FlexMetaInfo_t lastFlexMetaInfo;
@@ -4817,6 +7548,20 @@ static NVM_Status_t NvWriteRecord
     }
     #endif
 
+    #if gNvUseDeltaRecords_c
+    /* write only the bytes changed since the previous save */
+    if(tblIndexes->saveRestoreAll && NvDeltaPrepare(tableEntryIdx, &deltaSize))
+    {
+        if(0 == deltaSize)
+        {
+            /* the data set in storage is up to date */
+            return gNVM_OK_c;
+        }
+        isDelta = TRUE;
+        realRecordSize = recordSize = deltaSize;
+    }
+    #endif
+
     /* get active page free space */
     NvGetPageFreeSpace(&pageFreeSpace);
 
@@ -4898,6 +7643,16 @@ static NVM_Status_t NvWriteRecord
             metaInfoAddress += sizeof(NVM_RecordMetaInfo_t);
             }
 
+        #if gNvUseDeltaRecords_c
+        if(isDelta)
+        {
+            /* the element index field holds the delta record size */
+            metaInfo.fields.NvValidationStartByte = gValidationByteDeltaRecord_c;
+            metaInfo.fields.NvValidationEndByte = gValidationByteDeltaRecord_c;
+            metaInfo.fields.NvmElementIndex = deltaSize;
+        }
+        #endif
+
         /* check if the space needed by the record is really free (erased).
         * this check is necessary because it may happens that a record to be successfully written,
         * but the system fails (e.g. POR) before the associated meta information has been written.
@@ -4964,6 +7719,13 @@ static NVM_Status_t NvWriteRecord
         }
         else
         #endif
+        #if gNvUseDeltaRecords_c
+        if(isDelta)
+        {
+            srcAddress = (uint32_t)maNvDeltaRecord;
+        }
+        else
+        #endif
         if(tblIndexes->saveRestoreAll)
         {
             srcAddress = (uint32_t)((uint8_t*)(((uint8_t*)(pNVM_DataTable[tableEntryIdx]).pData)));
@@ -4989,6 +7751,9 @@ static NVM_Status_t NvWriteRecord
             {
                 /* update the last record meta information */
                 mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress = metaInfoAddress;
+                #if gNvUseMetaIndex_c
+                NvMetaIndexAdd(metaInfoAddress, &metaInfo);
+                #endif
                 /* update the last unerased meta info address */
                 #if gUnmirroredFeatureSet_d
                 if(0 != metaInfo.fields.NvmRecordOffset)
@@ -5049,6 +7814,16 @@ static NVM_Status_t NvRestoreData
     #if gNvFragmentation_Enabled_d
     uint16_t cnt;
     #endif
+    #if gNvUseMetaIndex_c
+    NVM_MetaIndexEntry_t* pIndexEntry;
+    #if gNvFragmentation_Enabled_d
+    uint16_t singleMetaOffset;
+    #endif
+    #endif
+    #if gNvUseDeltaRecords_c
+    uint32_t fullMetaAddress;
+    uint32_t lastMetaAddress;
+    #endif
 #else
     NVM_FlexMetaInfo_t flexMetaInfo;
     uint32_t EERamAddress;
@@ -5131,10 +7906,75 @@ static NVM_Status_t NvRestoreData
     */
     status = gNVM_MetaNotFound_c;
 
+    #if gNvUseMetaIndex_c
+    pIndexEntry = NvMetaIndexGetEntry(tableEntryIdx);
+    #endif
+
+    #if gNvUseDeltaRecords_c
+    if(NvDeltaIsUsed(tableEntryIdx))
+    {
+        /* the latest full record, with the newer delta and single records applied */
+        (void)NvDeltaGetChain(tableEntryIdx, &fullMetaAddress, &lastMetaAddress);
+        if(0 != fullMetaAddress)
+        {
+            if(tblIdx->saveRestoreAll)
+            {
+                NvDeltaReadImage(tableEntryIdx, fullMetaAddress, lastMetaAddress, 0,
+                                 (uint32_t)pNVM_DataTable[tableEntryIdx].ElementsCount * pNVM_DataTable[tableEntryIdx].ElementSize,
+                                 (uint8_t*)pNVM_DataTable[tableEntryIdx].pData);
+            }
+            else
+            {
+                NvDeltaReadImage(tableEntryIdx, fullMetaAddress, lastMetaAddress,
+                                 (uint32_t)tblIdx->elementIndex * pNVM_DataTable[tableEntryIdx].ElementSize,
+                                 pNVM_DataTable[tableEntryIdx].ElementSize,
+                                 (uint8_t*)pNVM_DataTable[tableEntryIdx].pData + (tblIdx->elementIndex * pNVM_DataTable[tableEntryIdx].ElementSize));
+            }
+            return gNVM_OK_c;
+        }
+    }
+    #endif
+
     /*** restore all ***/
     if(tblIdx->saveRestoreAll)
     {
         #if gNvFragmentation_Enabled_d
+        #if gNvUseMetaIndex_c
+        if(NULL != pIndexEntry)
+        {
+            /* restore the single saves newer than the latest full save, then fill the rest from it */
+            for (cnt=0; cnt<pIndexEntry->elementsCount; cnt++)
+            {
+                singleMetaOffset = maNvMetaIndexSlots[pIndexEntry->firstElementSlot + cnt];
+                if(singleMetaOffset <= pIndexEntry->fullMetaOffset)
+                {
+                    continue;
+                }
+                NvGetMetaInfo(mNvActivePageId, mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + singleMetaOffset, &metaInfo);
+                NV_FlashRead(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + metaInfo.fields.NvmRecordOffset,
+                             (uint8_t*)pNVM_DataTable[tableEntryIdx].pData + cnt * pNVM_DataTable[tableEntryIdx].ElementSize,
+                             pNVM_DataTable[tableEntryIdx].ElementSize);
+                status = gNVM_OK_c;
+            }
+
+            if(0 != pIndexEntry->fullMetaOffset)
+            {
+                NvGetMetaInfo(mNvActivePageId, mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + pIndexEntry->fullMetaOffset, &metaInfo);
+                for (cnt=0; cnt<pIndexEntry->elementsCount; cnt++)
+                {
+                    /* skip already restored elements */
+                    if (maNvMetaIndexSlots[pIndexEntry->firstElementSlot + cnt] > pIndexEntry->fullMetaOffset)
+                        continue;
+                    NV_FlashRead(mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + metaInfo.fields.NvmRecordOffset + cnt * pNVM_DataTable[tableEntryIdx].ElementSize,
+                                 (uint8_t*)pNVM_DataTable[tableEntryIdx].pData + cnt * pNVM_DataTable[tableEntryIdx].ElementSize,
+                                 pNVM_DataTable[tableEntryIdx].ElementSize);
+                }
+                return gNVM_OK_c;
+            }
+            return status;
+        }
+        #endif /* gNvUseMetaIndex_c */
+
         /* clear the buffer */
         FLib_MemSet(maNvRecordsCpyOffsets, 0, sizeof(uint16_t)*pNVM_DataTable[tableEntryIdx].ElementsCount);
 
@@ -5183,6 +8023,17 @@ static NVM_Status_t NvRestoreData
         }
         return status;
         #else
+        #if gNvUseMetaIndex_c
+        if(NULL != pIndexEntry)
+        {
+            /* start from the latest save of the entry; the search below stops there */
+            if(0 == pIndexEntry->lastMetaOffset)
+            {
+                return status;
+            }
+            metaInfoAddress = mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + pIndexEntry->lastMetaOffset;
+        }
+        #endif
         /* parse meta info backwards until the full save is found */
         while(metaInfoAddress >= (mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c))
         {
@@ -5218,6 +8069,18 @@ static NVM_Status_t NvRestoreData
 
     /*** restore single ***/
 
+    #if gNvUseMetaIndex_c
+    if((NULL != pIndexEntry) && (tblIdx->elementIndex < pIndexEntry->elementsCount))
+    {
+        /* start from the latest save holding the element; the search below stops there */
+        metaInfoAddress = NvMetaIndexGetLatest(pIndexEntry, tblIdx->elementIndex);
+        if(0 == metaInfoAddress)
+        {
+            return status;
+        }
+    }
+    #endif
+
     /* parse meta info backwards until the element is found */
     while(metaInfoAddress >= (mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress + gNvFirstMetaOffset_c))
     {
@@ -5401,6 +8264,13 @@ static NVM_Status_t NvAddSaveRequestToQueue
     uint8_t lastInvalidIdx;
     uint8_t remaining_count;
 
+    #if gNvUseCommitEngine_c
+    if(NvCommitMarkDirty(ptrTblIdx))
+    {
+        return gNVM_OK_c;
+    }
+    #endif
+
     if(mNvPendingSavesQueue.EntriesCount == 0)
     {
         /* add request to queue */
@@ -5532,6 +8402,10 @@ static uint8_t GetRandomRange
 static void __NvShutdown( void )
 {
     uint16_t idx = 0;
+    #if gNvUseCommitEngine_c
+    /* do not wait for the commit deadline */
+    mNvCommitTicksLeft = 0;
+    #endif
     /* wait for all operations to complete */
     while(TRUE)
     {
@@ -5539,6 +8413,12 @@ static void __NvShutdown( void )
         {
             continue;
         }
+        #if gNvUseCommitEngine_c
+        if (mNvCommitDirtyCount)
+        {
+            continue;
+        }
+        #endif
         while (gNvEndOfTableId_c != pNVM_DataTable[idx].DataEntryID)
         {
             if (maDatasetInfo[idx].saveNextInterval)
@@ -6070,6 +8950,85 @@ bool_t NvIsDataSetDirty
 #endif
 }
 
+/******************************************************************************
+ * Name: NvSetDeltaRecords
+ * Description: Selects the record format of the full saves of a data set
+ *              mirrored in RAM, see gNvDeltaRecords_Enabled_d. The selection
+ *              is kept in RAM only; the delta records already in storage are
+ *              restored either way.
+ * Parameters: [IN] ptrData - pointer to the data set
+ *             [IN] enable - TRUE to write delta records, FALSE to write full
+ *                           records
+ * Return: gNVM_OK_c - if the operation completes successfully
+ *         gNVM_NullPointer_c - if a NULL pointer is provided
+ *         gNVM_PointerOutOfRange_c - if the pointer is not in the RAM table
+ *         gNVM_InvalidTableEntry_c - if the data set is not mirrored in RAM
+ *         gNVM_Error_c - if gNvDeltaEntriesCount_c data sets are already
+ *                        selected or the delta records are disabled
+ ******************************************************************************/
+NVM_Status_t NvSetDeltaRecords
+(
+    void* ptrData,
+    bool_t enable
+)
+{
+#if gNvStorageIncluded_d && gNvUseDeltaRecords_c
+    NVM_TableEntryInfo_t tblIdx;
+    NVM_Status_t status;
+    uint16_t idx;
+
+    if(NULL == ptrData)
+    {
+        return gNVM_NullPointer_c;
+    }
+
+    (void)OSA_MutexLock(mNVMMutexId, osaWaitForever_c);
+
+    status = NvGetEntryFromDataPtr(ptrData, &tblIdx);
+
+    if(gNVM_OK_c == status)
+    {
+        if(gNVM_MirroredInRam_c != pNVM_DataTable[NvGetTableEntryIndexFromId(tblIdx.entryId)].DataEntryType)
+        {
+            status = gNVM_InvalidTableEntry_c;
+        }
+        else
+        {
+            for(idx = 0; idx < mNvDeltaEntriesCount; idx++)
+            {
+                if(maNvDeltaEntryIds[idx] == tblIdx.entryId)
+                {
+                    break;
+                }
+            }
+
+            if(enable && (idx == mNvDeltaEntriesCount))
+            {
+                if(mNvDeltaEntriesCount < (uint16_t)gNvDeltaEntriesCount_c)
+                {
+                    maNvDeltaEntryIds[mNvDeltaEntriesCount++] = tblIdx.entryId;
+                }
+                else
+                {
+                    status = gNVM_Error_c;
+                }
+            }
+            else if(!enable && (idx < mNvDeltaEntriesCount))
+            {
+                maNvDeltaEntryIds[idx] = maNvDeltaEntryIds[--mNvDeltaEntriesCount];
+            }
+        }
+    }
+
+    (void)OSA_MutexUnlock(mNVMMutexId);
+    return status;
+#else
+    ptrData=ptrData;
+    enable=enable;
+    return gNVM_Error_c;
+#endif
+}
+
 /******************************************************************************
  * Name: NvGetStatistics
  * Description:
@@ -6095,6 +9054,11 @@ void NvGetPagesStatistics
         return;
     }
 
+    #if gNvUseRing_c
+    /* the first two pages of the ring, see NvGetSectorEraseCycles() */
+    ptrStat->FirstPageEraseCyclesCount = maNvPageEraseCycles[gFirstVirtualPage_c];
+    ptrStat->SecondPageEraseCyclesCount = maNvPageEraseCycles[gSecondVirtualPage_c];
+    #else
     if(mNvPageCounter%2)
     {
         ptrStat->FirstPageEraseCyclesCount = ptrStat->SecondPageEraseCyclesCount = (mNvPageCounter-1)/2;
@@ -6104,6 +9068,7 @@ void NvGetPagesStatistics
         ptrStat->FirstPageEraseCyclesCount = mNvPageCounter/2;
         ptrStat->SecondPageEraseCyclesCount = (mNvPageCounter-2)/2;
     }
+    #endif
 
     #else /* FlexNVM */
     ptrStat->FirstPageEraseCyclesCount = 0;
@@ -6116,6 +9081,39 @@ void NvGetPagesStatistics
 #endif
 }
 
+/******************************************************************************
+ * Name: NvGetSectorEraseCycles
+ * Description: Returns the erase cycles count of a NV storage sector. The
+ *              count is estimated on boot from the page counter and tracked
+ *              afterwards.
+ * Parameter(s): [IN] sectorIndex - the index of the sector, counted from the
+ *                                  start of the NV storage
+ * Return: the erase cycles count, 0 if the sector is not used by the NVM
+ *****************************************************************************/
+uint32_t NvGetSectorEraseCycles
+(
+    uint32_t sectorIndex
+)
+{
+#if gNvStorageIncluded_d
+    #if (gNvUseFlexNVM_d == FALSE) || ((gNvUseFlexNVM_d == TRUE) && (DEBLOCK_SIZE == 0)) /* no FlexNVM */
+    uint32_t sectorsPerPage = mNvVirtualPageProperty[gFirstVirtualPage_c].NvRawSectorsCount;
+
+    if(!mNvModuleInitialized || (sectorIndex >= sectorsPerPage * gNvVirtualPagesCount_c))
+    {
+        return 0;
+    }
+    return maNvPageEraseCycles[sectorIndex / sectorsPerPage];
+    #else /* FlexNVM */
+    sectorIndex=sectorIndex;
+    return 0;
+    #endif
+#else
+    sectorIndex=sectorIndex;
+    return 0;
+#endif
+}
+
 /******************************************************************************
  * Name: NvFormat
  * Description: Format the NV storage system. The function erases both virtual
@@ -71,6 +71,33 @@
  */
 #define gValidationByteAllRecords_c    0x55
 
+/*
+ * Name: gValidationByteDeltaRecord_c
+ * Description: the value of validation byte used in meta tag to mark a delta record type;
+ *              the element index field of the meta tag holds the record size
+ */
+#define gValidationByteDeltaRecord_c   0x3C
+
+/*
+ * Name: gNvDeltaZeroRun_c
+ * Description: delta record token flag of a run of bytes cleared to zero. A token
+ *              is a count of unchanged bytes followed by the run size, with the
+ *              run bytes after it unless the flag is set
+ */
+#define gNvDeltaZeroRun_c              0x80
+
+/*
+ * Name: gNvDeltaRunSizeMax_c
+ * Description: the maximum size of a delta record token run
+ */
+#define gNvDeltaRunSizeMax_c           0x7F
+
+/*
+ * Name: gNvDeltaSkipMax_c
+ * Description: the maximum count of unchanged bytes before a delta record token run
+ */
+#define gNvDeltaSkipMax_c              0xFF
+
 /*
  * Name: gPageCounterMaxValue_c
  * Description: self explanatory
@@ -175,13 +202,15 @@ typedef union NVM_EntryInfo_tag
 
 /*
  * Name: NVM_VirtualPageID_t
- * Description: virtual page ID type definition
+ * Description: virtual page ID type definition; with a ring of more than two
+ *              pages, the IDs run from gFirstVirtualPage_c up to
+ *              gVirtualPageNone_c - 1
  */
 typedef enum NVM_VirtualPageID_tag
 {
     gFirstVirtualPage_c = 0,
     gSecondVirtualPage_c,
-    gVirtualPageNone_c
+    gVirtualPageNone_c = gNvRingPagesCount_d
 } NVM_VirtualPageID_t;
 
 /*
@@ -207,6 +236,22 @@ typedef struct NVM_ErasePageCmdStatus_tag
     uint32_t NvSectorAddress;
 } NVM_ErasePageCmdStatus_t;
 
+/*
+ * Name: NVM_CopyPageState_t
+ * Description: progress of a page copy to the page following the active one;
+ *              the active page is left unchanged until the copy is committed
+ */
+typedef struct NVM_CopyPageState_tag
+{
+    uint32_t srcMetaAddress;        /* the next source meta to be copied */
+    uint32_t dstMetaAddress;        /* the next free destination meta */
+    uint32_t dstRecordAddress;      /* the lowest destination record */
+    NvTableEntryId_t skipEntryId;   /* the entry ID skipped by the copy */
+    bool_t inProgress;              /* the destination page holds a partial copy */
+    bool_t resumed;                 /* the copy was found on boot, the source
+                                       meta and the copied records are not set */
+} NVM_CopyPageState_t;
+
 /*
  * Name: NVM_TableEntryInfo_t
  * Description: table entry indexes type definition
@@ -218,6 +263,49 @@ typedef struct NVM_TableEntryInfo_tag
     bool_t saveRestoreAll;
 } NVM_TableEntryInfo_t;
 
+/*
+ * Name: NVM_MetaIndexEntry_t
+ * Description: meta information index entry type definition; the meta
+ *              addresses are stored as offsets from the start of the active
+ *              virtual page, 0 meaning that no such meta exists
+ */
+typedef struct NVM_MetaIndexEntry_tag
+{
+    NvTableEntryId_t entryId;       /* the ID of the indexed table entry */
+    uint16_t elementsCount;         /* the elements count at the time of indexing */
+    uint16_t firstElementSlot;      /* the first element slot owned by the entry */
+    uint16_t fullMetaOffset;        /* the latest full record meta */
+    uint16_t lastMetaOffset;        /* the latest meta, full or single */
+    uint16_t deltaMetaOffset;       /* the latest delta record meta */
+    bool_t fullCopied;              /* a full record was written during page copy */
+} NVM_MetaIndexEntry_t;
+
+/*
+ * Name: NVM_CommitEntry_t
+ * Description: commit engine state of a table entry; the dirty elements are
+ *              kept in the dirty bitmap, starting with the entry's
+ *              firstElementSlot
+ */
+typedef struct NVM_CommitEntry_tag
+{
+    NvTableEntryId_t entryId;       /* the ID of the tracked table entry */
+    uint16_t elementsCount;         /* the elements count at the time of tracking */
+    uint16_t firstElementSlot;      /* the first element slot owned by the entry */
+    bool_t dirty;                   /* a save of the entry is pending */
+    bool_t saveAll;                 /* a full save of the entry is pending */
+} NVM_CommitEntry_t;
+
+/*
+ * Name: NVM_CommitRecord_t
+ * Description: a record of a commit engine write
+ */
+typedef struct NVM_CommitRecord_tag
+{
+    uint32_t srcAddress;            /* the RAM data, 0 for an erased unmirrored element */
+    uint16_t size;                  /* the record size, without padding */
+    uint16_t tableEntryIdx;         /* the table entry index */
+} NVM_CommitRecord_t;
+
 /*
  * Name: NVM_SaveQueue_t
  * Description: Circular queue used for pending saves data type definition
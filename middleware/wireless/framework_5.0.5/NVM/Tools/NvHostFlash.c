@@ -0,0 +1,489 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file NvHostFlash.c
+* RAM backed stand-in for Flash_Adapter.c, plus the few framework services used
+* by NV_Flash.c (OS abstraction, RNG, Memory Manager), for host builds of the NVM.
+*
+* The flash keeps the NOR semantics the NVM relies on: erase sets a whole sector
+* to 0xFF, programming can only clear bits and works on PGM_SIZE_BYTE write units.
+* Programming a write unit that is not erased is counted in overProgramCount.
+*
+* A power cut during programming leaves the bytes before the cut offset written and
+* the rest of the operation undone. A power cut during a sector erase leaves the
+* first half of the sector erased and the second half untouched.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "NvHostFlash.h"
+#include "fsl_os_abstraction.h"
+#include "RNG_Interface.h"
+#include "MemManager.h"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mNvHostFlashAddress_c   ((uint32_t)(uintptr_t)NV_STORAGE_END_ADDRESS)
+#define mNvHostSectorSize_c     ((uint32_t)(uintptr_t)NV_STORAGE_SECTOR_SIZE)
+#define mNvHostSectorsCount_c   ((uint32_t)(uintptr_t)NV_STORAGE_MAX_SECTORS)
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE     MAP_FIXED
+#endif
+
+/* RAM buffers handed to NV_Flash.c (unmirrored data sets) */
+#ifndef gNvHostMemBlockSize_c
+#define gNvHostMemBlockSize_c   256
+#endif
+#ifndef gNvHostMemBlocksCount_c
+#define gNvHostMemBlocksCount_c 512
+#endif
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public memory declarations
+*************************************************************************************
+********************************************************************************** */
+nvHostFlashStats_t gNvHostFlashStats;
+
+/* typical figures of the Kinetis FTFL: longword program and 2 KB sector erase */
+nvHostFlashTiming_t gNvHostFlashTiming =
+{
+    .programUs = 65,
+    .eraseUs = 20000,
+    .readNsPerByte = 10
+};
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+/* linker symbols of the NVM storage, see NV_Flash.c */
+extern uint32_t NV_STORAGE_END_ADDRESS[];
+extern uint32_t NV_STORAGE_SECTOR_SIZE[];
+extern uint32_t NV_STORAGE_MAX_SECTORS[];
+
+static uint8_t* mNvHostFlash = NULL;
+static uint32_t mNvHostRandom = 0x2545F491;
+
+static uint32_t mNvHostPowerCutOffset = gNvHostNoPowerCut_c;
+static nvHostPowerCutCallback_t mpfNvHostPowerCut = NULL;
+
+/* the blocks are static so that their addresses fit in uint32_t */
+static uint8_t maNvHostMemBlocks[gNvHostMemBlocksCount_c][gNvHostMemBlockSize_c];
+static bool_t maNvHostMemBlockUsed[gNvHostMemBlocksCount_c];
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint8_t* NV_HostFlashPtr(uint32_t address, uint32_t size)
+{
+    if((address < mNvHostFlashAddress_c) ||
+       (address + size > mNvHostFlashAddress_c + NV_HostFlashSize()))
+    {
+        return NULL;
+    }
+    return mNvHostFlash + (address - mNvHostFlashAddress_c);
+}
+
+/* returns the number of offsets that may be consumed before the power cut */
+static uint32_t NV_HostFlashOffsetsLeft(void)
+{
+    if(mNvHostPowerCutOffset <= gNvHostFlashStats.offset)
+    {
+        return 0;
+    }
+    return mNvHostPowerCutOffset - gNvHostFlashStats.offset;
+}
+
+static void NV_HostFlashPowerCut(void)
+{
+    nvHostPowerCutCallback_t pfCallback = mpfNvHostPowerCut;
+
+    mNvHostPowerCutOffset = gNvHostNoPowerCut_c;
+    mpfNvHostPowerCut = NULL;
+    if(NULL != pfCallback)
+    {
+        pfCallback();
+    }
+    fprintf(stderr, "power cut at offset %u with no callback\n", (unsigned)gNvHostFlashStats.offset);
+    exit(1);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+
+/*! *********************************************************************************
+ * \brief  Maps the simulated flash (first call), erases it and clears the counters
+********************************************************************************** */
+void NV_HostFlashInit(void)
+{
+    if(NULL == mNvHostFlash)
+    {
+        void* p;
+
+        if(mNvHostSectorsCount_c > gNvHostSectorsCountMax_c)
+        {
+            fprintf(stderr, "NV_STORAGE_MAX_SECTORS above gNvHostSectorsCountMax_c\n");
+            exit(1);
+        }
+        p = mmap((void*)(uintptr_t)mNvHostFlashAddress_c, NV_HostFlashSize(),
+                 PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+        if((MAP_FAILED == p) || ((uintptr_t)p != mNvHostFlashAddress_c))
+        {
+            fprintf(stderr, "cannot map the simulated flash at 0x%08x\n", (unsigned)mNvHostFlashAddress_c);
+            exit(1);
+        }
+        mNvHostFlash = (uint8_t*)p;
+    }
+    memset(mNvHostFlash, 0xFF, NV_HostFlashSize());
+    memset(&gNvHostFlashStats, 0, sizeof(gNvHostFlashStats));
+    mNvHostPowerCutOffset = gNvHostNoPowerCut_c;
+    mpfNvHostPowerCut = NULL;
+}
+
+uint8_t* NV_HostFlashBase(void)
+{
+    return mNvHostFlash;
+}
+
+uint32_t NV_HostFlashSize(void)
+{
+    return mNvHostSectorSize_c * mNvHostSectorsCount_c;
+}
+
+uint32_t NV_HostFlashSectorsCount(void)
+{
+    return mNvHostSectorsCount_c;
+}
+
+/*! *********************************************************************************
+ * \brief  Arms a power cut: the flash operation that reaches the given offset
+ *         (gNvHostFlashStats.offset numbering) is left unfinished and pfCallback
+ *         is called. gNvHostNoPowerCut_c disarms it.
+********************************************************************************** */
+void NV_HostFlashSetPowerCut(uint32_t offset, nvHostPowerCutCallback_t pfCallback)
+{
+    mNvHostPowerCutOffset = offset;
+    mpfNvHostPowerCut = pfCallback;
+}
+
+void NV_HostFlashRead(uint32_t src, uint8_t* pDest, uint32_t size)
+{
+    gNvHostFlashStats.readCalls++;
+    gNvHostFlashStats.readBytes += size;
+    gNvHostFlashStats.busyUs += ((uint64_t)size * gNvHostFlashTiming.readNsPerByte) / 1000;
+    memcpy(pDest, (void*)(uintptr_t)src, size);
+}
+
+void NV_Init(void)
+{
+    if(NULL == mNvHostFlash)
+    {
+        NV_HostFlashInit();
+    }
+}
+
+void NV_Flash_SetCriticalSection(void)
+{
+}
+
+void NV_Flash_ClearCriticalSection(void)
+{
+}
+
+/*! *********************************************************************************
+ * \brief  Write aligned data to the simulated flash
+********************************************************************************** */
+uint32_t NV_FlashProgram(uint32_t dest, uint32_t size, uint8_t* pData)
+{
+    uint8_t* pFlash = NV_HostFlashPtr(dest, size);
+    uint32_t count = size;
+    uint32_t i;
+
+    if((dest | size) & (PGM_SIZE_BYTE - 1))
+    {
+        return kStatus_FLASH_AlignmentError;
+    }
+    if(NULL == pFlash)
+    {
+        return kStatus_FLASH_AddressError;
+    }
+
+    if(NV_HostFlashOffsetsLeft() < size)
+    {
+        count = NV_HostFlashOffsetsLeft();
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        if(((i % PGM_SIZE_BYTE) == 0) && (0 != memcmp(&pFlash[i], "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", PGM_SIZE_BYTE)))
+        {
+            gNvHostFlashStats.overProgramCount++;
+        }
+        pFlash[i] &= pData[i];
+    }
+    gNvHostFlashStats.offset += count;
+    gNvHostFlashStats.programOps++;
+    gNvHostFlashStats.programCalls += (count + PGM_SIZE_BYTE - 1) / PGM_SIZE_BYTE;
+    gNvHostFlashStats.programBytes += count;
+    gNvHostFlashStats.busyUs += (uint64_t)gNvHostFlashTiming.programUs * ((count + PGM_SIZE_BYTE - 1) / PGM_SIZE_BYTE);
+
+    if(count < size)
+    {
+        NV_HostFlashPowerCut();
+    }
+    return kStatus_FLASH_Success;
+}
+
+/*! *********************************************************************************
+ * \brief  Write data to the simulated flash; same split as Flash_Adapter.c
+********************************************************************************** */
+uint32_t NV_FlashProgramUnaligned(uint32_t dest, uint32_t size, uint8_t* pData)
+{
+    uint8_t  buffer[PGM_SIZE_BYTE];
+    uint16_t bytes = dest & (PGM_SIZE_BYTE-1);
+    uint32_t status;
+
+    if( bytes )
+    {
+        uint16_t unalignedBytes = PGM_SIZE_BYTE - bytes;
+
+        if( unalignedBytes > size )
+        {
+            unalignedBytes = size;
+        }
+
+        memset(buffer, 0xFF, PGM_SIZE_BYTE);
+        memcpy(&buffer[bytes], pData, unalignedBytes);
+        /* the bytes already in flash are kept by the AND semantics */
+        status = NV_FlashProgram(dest - bytes, PGM_SIZE_BYTE, buffer);
+        if( status != kStatus_FLASH_Success )
+        {
+            return status;
+        }
+
+        dest += PGM_SIZE_BYTE - bytes;
+        pData += unalignedBytes;
+        size -= unalignedBytes;
+    }
+
+    bytes = size & ~(PGM_SIZE_BYTE - 1U);
+
+    if( bytes )
+    {
+        status = NV_FlashProgram(dest, bytes, pData);
+        if( status != kStatus_FLASH_Success )
+        {
+            return status;
+        }
+
+        dest  += bytes;
+        pData += bytes;
+        size  -= bytes;
+    }
+
+    if( size )
+    {
+        memset(buffer, 0xFF, PGM_SIZE_BYTE);
+        memcpy(buffer, pData, size);
+        status = NV_FlashProgram(dest, PGM_SIZE_BYTE, buffer);
+        if( status != kStatus_FLASH_Success )
+        {
+            return status;
+        }
+    }
+
+    return kStatus_FLASH_Success;
+}
+
+uint32_t NV_FlashEraseSector(uint32_t dest, uint32_t size)
+{
+    uint8_t* pFlash = NV_HostFlashPtr(dest, size);
+    uint32_t sector;
+
+    if(((dest - mNvHostFlashAddress_c) | size) & (mNvHostSectorSize_c - 1))
+    {
+        return kStatus_FLASH_AlignmentError;
+    }
+    if(NULL == pFlash)
+    {
+        return kStatus_FLASH_AddressError;
+    }
+
+    for(sector = 0; sector < size / mNvHostSectorSize_c; sector++)
+    {
+        gNvHostFlashStats.eraseCalls++;
+        gNvHostFlashStats.sectorErases[(dest - mNvHostFlashAddress_c) / mNvHostSectorSize_c + sector]++;
+        gNvHostFlashStats.busyUs += gNvHostFlashTiming.eraseUs;
+
+        if(0 == NV_HostFlashOffsetsLeft())
+        {
+            memset(pFlash, 0xFF, mNvHostSectorSize_c / 2);
+            NV_HostFlashPowerCut();
+        }
+        memset(pFlash, 0xFF, mNvHostSectorSize_c);
+        gNvHostFlashStats.offset++;
+        pFlash += mNvHostSectorSize_c;
+    }
+    return kStatus_FLASH_Success;
+}
+
+uint32_t NV_FlashVerifyErase(uint32_t start, uint32_t lengthInBytes, flash_margin_value_t margin)
+{
+    uint8_t* pFlash = NV_HostFlashPtr(start, lengthInBytes);
+    uint32_t i;
+
+    (void)margin;
+    if(NULL == pFlash)
+    {
+        return kStatus_FLASH_AddressError;
+    }
+    for(i = 0; i < lengthInBytes; i++)
+    {
+        if(0xFF != pFlash[i])
+        {
+            return kStatus_FLASH_AddressError;
+        }
+    }
+    return kStatus_FLASH_Success;
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Framework services used by NV_Flash.c
+*************************************************************************************
+********************************************************************************** */
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+osaMutexId_t OSA_MutexCreate(void)
+{
+    static uint8_t mutex;
+    return &mutex;
+}
+
+osaStatus_t OSA_MutexLock(osaMutexId_t mutexId, uint32_t millisec)
+{
+    (void)mutexId;
+    (void)millisec;
+    return osaStatus_Success;
+}
+
+osaStatus_t OSA_MutexUnlock(osaMutexId_t mutexId)
+{
+    (void)mutexId;
+    return osaStatus_Success;
+}
+
+osaTaskId_t OSA_TaskGetId(void)
+{
+    return (osaTaskId_t)1;
+}
+
+void RNG_GetRandomNo(uint32_t* pRandomNo)
+{
+    /* xorshift32 */
+    mNvHostRandom ^= mNvHostRandom << 13;
+    mNvHostRandom ^= mNvHostRandom >> 17;
+    mNvHostRandom ^= mNvHostRandom << 5;
+    *pRandomNo = mNvHostRandom;
+}
+
+void* MEM_BufferAllocWithId(uint32_t numBytes, uint8_t poolId, void* pCaller)
+{
+    uint32_t i;
+
+    (void)poolId;
+    (void)pCaller;
+    if(numBytes > gNvHostMemBlockSize_c)
+    {
+        return NULL;
+    }
+    for(i = 0; i < gNvHostMemBlocksCount_c; i++)
+    {
+        if(!maNvHostMemBlockUsed[i])
+        {
+            maNvHostMemBlockUsed[i] = TRUE;
+            return maNvHostMemBlocks[i];
+        }
+    }
+    return NULL;
+}
+
+memStatus_t MEM_BufferFree(void* buffer)
+{
+    uint32_t i = ((uint8_t*)buffer - &maNvHostMemBlocks[0][0]) / gNvHostMemBlockSize_c;
+
+    if(((uint8_t*)buffer < &maNvHostMemBlocks[0][0]) || (i >= gNvHostMemBlocksCount_c) || !maNvHostMemBlockUsed[i])
+    {
+        fprintf(stderr, "MEM_BufferFree(%p): not an allocated block\n", buffer);
+        exit(1);
+    }
+    maNvHostMemBlockUsed[i] = FALSE;
+    return MEM_SUCCESS_c;
+}
+
+/*! *********************************************************************************
+ * \brief  Frees all the RAM buffers, as a reset does
+********************************************************************************** */
+void NV_HostMemReset(void)
+{
+    memset(maNvHostMemBlockUsed, 0, sizeof(maNvHostMemBlockUsed));
+}
@@ -0,0 +1,171 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file NvHostFlash.h
+* RAM backed stand-in for Flash_Adapter.h, used to build NV_Flash.c on a host.
+*
+* The header defines the Flash_Adapter.h include guard, so NV_Flash.c picks up
+* these declarations instead of the MCU flash driver ones.
+*
+* The geometry comes from the same linker symbols NV_Flash.c uses, given to the
+* host linker with --defsym: the simulated flash is NV_STORAGE_MAX_SECTORS sectors
+* of NV_STORAGE_SECTOR_SIZE bytes, mapped at NV_STORAGE_END_ADDRESS. The address
+* must be below 4 GB because NV_Flash.c keeps flash addresses in uint32_t; for the
+* same reason the NVM data sets must be statically allocated and the host program
+* linked with -no-pie.
+*
+* Besides the NOR semantics, the simulator provides:
+*  - a timing model: every operation adds its duration to gNvHostFlashStats.busyUs,
+*    using the figures in gNvHostFlashTiming;
+*  - per sector erase counters;
+*  - power-cut injection: the flash operations are numbered in bytes (one per
+*    programmed byte, one per erased sector) and the operation that reaches the
+*    armed offset is left unfinished before the power-cut callback is called.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __NV_HOST_FLASH_H__
+#define __NV_HOST_FLASH_H__
+
+/* take the place of the MCU flash adapter */
+#define __FLASH_ADAPTER_H__
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include "EmbeddedTypes.h"
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public macros
+*************************************************************************************
+********************************************************************************** */
+/* KW2xD program flash geometry */
+#ifndef PGM_SIZE_BYTE
+#define PGM_SIZE_BYTE               4
+#endif
+#define FTFx_PHRASE_SIZE            8
+
+/* the largest NV_STORAGE_MAX_SECTORS the erase counters are kept for */
+#ifndef gNvHostSectorsCountMax_c
+#define gNvHostSectorsCountMax_c    64
+#endif
+
+/* power-cut offset that never triggers */
+#define gNvHostNoPowerCut_c         0xFFFFFFFFUL
+
+#define NV_FlashRead(pSrc, pDest, size) NV_HostFlashRead((uint32_t)(pSrc), (uint8_t*)(pDest), size);
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+********************************************************************************** */
+enum
+{
+    kStatus_FLASH_Success = 0,
+    kStatus_FLASH_AlignmentError = 101,
+    kStatus_FLASH_AddressError = 102
+};
+
+typedef enum _flash_margin_value
+{
+    kFLASH_MarginValueNormal,
+    kFLASH_MarginValueUser,
+    kFLASH_MarginValueFactory,
+    kFLASH_MarginValueInvalid
+} flash_margin_value_t;
+
+/* operation counters, cleared by NV_HostFlashInit() */
+typedef struct nvHostFlashStats_tag
+{
+    uint32_t readCalls;         /* NV_FlashRead() calls */
+    uint32_t readBytes;
+    uint32_t programCalls;      /* program operations, in write units */
+    uint32_t programOps;        /* NV_FlashProgram() calls */
+    uint32_t programBytes;
+    uint32_t eraseCalls;        /* erased sectors */
+    uint32_t overProgramCount;  /* write units programmed without being erased */
+    uint32_t offset;            /* flash operations done, in power-cut offsets */
+    uint64_t busyUs;            /* modelled time spent in flash operations */
+    uint32_t sectorErases[gNvHostSectorsCountMax_c];
+} nvHostFlashStats_t;
+
+/* duration of the flash operations */
+typedef struct nvHostFlashTiming_tag
+{
+    uint32_t programUs;         /* per write unit */
+    uint32_t eraseUs;           /* per sector */
+    uint32_t readNsPerByte;
+} nvHostFlashTiming_t;
+
+/* called when the power cut happens; it must not return (longjmp() away) */
+typedef void (*nvHostPowerCutCallback_t)(void);
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public memory declarations
+*************************************************************************************
+********************************************************************************** */
+extern nvHostFlashStats_t gNvHostFlashStats;
+extern nvHostFlashTiming_t gNvHostFlashTiming;
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+********************************************************************************** */
+void NV_Init(void);
+
+uint32_t NV_FlashProgram(         uint32_t dest,
+                                  uint32_t size,
+                                  uint8_t* pData);
+
+uint32_t NV_FlashProgramUnaligned(uint32_t dest,
+                                  uint32_t size,
+                                  uint8_t* pData);
+
+uint32_t NV_FlashEraseSector(     uint32_t dest,
+                                  uint32_t size);
+uint32_t NV_FlashVerifyErase ( uint32_t start, uint32_t lengthInBytes, flash_margin_value_t margin);
+
+void NV_Flash_SetCriticalSection(void);
+void NV_Flash_ClearCriticalSection(void);
+
+/* host only */
+void NV_HostFlashInit(void);
+void NV_HostFlashRead(uint32_t src, uint8_t* pDest, uint32_t size);
+uint8_t* NV_HostFlashBase(void);
+uint32_t NV_HostFlashSize(void);
+uint32_t NV_HostFlashSectorsCount(void);
+void NV_HostFlashSetPowerCut(uint32_t offset, nvHostPowerCutCallback_t pfCallback);
+void NV_HostMemReset(void);
+
+#endif /* __NV_HOST_FLASH_H__ */
@@ -0,0 +1,367 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file NvMetaIndexBench.c
+* Host benchmark of the NVM meta information index (gNvMetaIndex_Enabled_d).
+*
+* NV_Flash.c is built against the RAM flash of NvHostFlash.c. For each page fill
+* level (25%, 50% and 90% of a virtual page) the active page is filled with a mix
+* of single element and full table entry saves, then:
+*  - boot: the module is re-initialized and every table entry is restored, as the
+*    application does at power up (NvModuleInit() + NvRestoreDataSet());
+*  - copy: the active page is copied to the other virtual page (NvCopyPage()).
+* After each step the restored data is checked against the data that was saved.
+* Results are the average time and the average count of NV_FlashRead() calls.
+*
+* Build the tool twice to compare, with -DgNvMetaIndex_Enabled_d=0 and =1:
+*   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast -I. -I../Interface
+*       -I../Source -I../../Flash/Internal -I../../Common -I../../FunctionLib
+*       -I../../TimersManager/Interface
+*       -I../../RNG/Interface -I../../OSAbstraction/Interface -I../../Messaging/Interface
+*       -I../../MemManager/Interface -I../../Lists
+*       -Wl,--defsym,NV_STORAGE_END_ADDRESS=0x30000000
+*       -Wl,--defsym,NV_STORAGE_SECTOR_SIZE=0x800 -Wl,--defsym,NV_STORAGE_MAX_SECTORS=16
+*       -o NvMetaIndexBench NvMetaIndexBench.c NvHostFlash.c ../../FunctionLib/FunctionLib.c
+* Usage: NvMetaIndexBench [rounds]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdbool.h>
+
+#ifndef gNvStorageIncluded_d
+#define gNvStorageIncluded_d            1
+#endif
+#ifndef gNvFragmentation_Enabled_d
+#define gNvFragmentation_Enabled_d      1
+#endif
+#ifndef gTMR_Enabled_d
+#define gTMR_Enabled_d                  0
+#endif
+#ifndef gFsciIncluded_c
+#define gFsciIncluded_c                 0
+#endif
+
+#include "NvHostFlash.h"
+#include "../Source/NV_Flash.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultRounds_c   (20)
+#define mBenchBootRepeat_c      (50)
+#define mBenchFullSavePct_c     (15)
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef struct benchResult_tag
+{
+    double   ns;
+    double   reads;
+} benchResult_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+/* data sets shaped like the Thread stack ones: a few large tables, some small entries */
+static uint8_t mDataSet0[16 * 16];
+static uint8_t mDataSet1[32 * 8];
+static uint8_t mDataSet2[4 * 64];
+static uint8_t mDataSet3[24 * 12];
+static uint8_t mDataSet4[1 * 128];
+static uint8_t mDataSet5[16 * 4];
+static uint8_t mDataSet6[20 * 16];
+static uint8_t mDataSet7[8 * 32];
+
+static NVM_DataEntry_t mBenchDataTable[] =
+{
+    {mDataSet0, 16, 16,  0x10, gNVM_MirroredInRam_c},
+    {mDataSet1, 32,  8,  0x11, gNVM_MirroredInRam_c},
+    {mDataSet2,  4, 64,  0x12, gNVM_MirroredInRam_c},
+    {mDataSet3, 24, 12,  0x13, gNVM_MirroredInRam_c},
+    {mDataSet4,  1, 128, 0x14, gNVM_MirroredInRam_c},
+    {mDataSet5, 16,  4,  0x15, gNVM_MirroredInRam_c},
+    {mDataSet6, 20, 16,  0x16, gNVM_MirroredInRam_c},
+    {mDataSet7,  8, 32,  0x17, gNVM_MirroredInRam_c},
+    {NULL, 0, 0, gNvEndOfTableId_c, 0}
+};
+
+#define mBenchEntries_c  (sizeof(mBenchDataTable) / sizeof(mBenchDataTable[0]) - 1)
+
+NVM_DataEntry_t* pNVM_DataTable = mBenchDataTable;
+
+static uint8_t* maGolden[mBenchEntries_c];
+static uint32_t mSeed = 1;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    mSeed = mSeed * 1103515245u + 12345u;
+    return mSeed >> 8;
+}
+
+static double BenchNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void BenchDie(const char* what, int status)
+{
+    fprintf(stderr, "%s failed, status %d\n", what, status);
+    exit(1);
+}
+
+/* power cycle: forget the RAM state of the module */
+static void BenchReboot(void)
+{
+    mNvModuleInitialized = FALSE;
+    mNvFlashConfigInitialised = FALSE;
+    mNvCopyOperationIsPending = FALSE;
+    mNvCriticalSectionFlag = 0;
+}
+
+static void BenchSnapshot(void)
+{
+    uint32_t i;
+    for(i = 0; i < mBenchEntries_c; i++)
+    {
+        memcpy(maGolden[i], mBenchDataTable[i].pData, mBenchDataTable[i].ElementsCount * mBenchDataTable[i].ElementSize);
+    }
+}
+
+static void BenchCheck(const char* step)
+{
+    uint32_t i;
+    for(i = 0; i < mBenchEntries_c; i++)
+    {
+        if(memcmp(maGolden[i], mBenchDataTable[i].pData, mBenchDataTable[i].ElementsCount * mBenchDataTable[i].ElementSize))
+        {
+            fprintf(stderr, "%s: entry 0x%02x restored wrong data\n", step, mBenchDataTable[i].DataEntryID);
+            exit(1);
+        }
+    }
+}
+
+static void BenchBoot(void)
+{
+    NVM_Status_t status;
+    uint32_t i;
+
+    BenchReboot();
+    for(i = 0; i < mBenchEntries_c; i++)
+    {
+        memset(mBenchDataTable[i].pData, 0, mBenchDataTable[i].ElementsCount * mBenchDataTable[i].ElementSize);
+    }
+    if(gNVM_OK_c != (status = NvModuleInit()))
+    {
+        BenchDie("NvModuleInit", status);
+    }
+    for(i = 0; i < mBenchEntries_c; i++)
+    {
+        if(gNVM_OK_c != (status = NvRestoreDataSet(mBenchDataTable[i].pData, TRUE)))
+        {
+            BenchDie("NvRestoreDataSet", status);
+        }
+    }
+}
+
+static uint32_t BenchUsedPct(void)
+{
+    uint32_t freeSpace = 0;
+    uint32_t pageSize = mNvVirtualPageProperty[mNvActivePageId].NvTotalPageSize;
+
+    (void)NvGetPageFreeSpace(&freeSpace);
+    return 100 - (freeSpace * 100) / pageSize;
+}
+
+/* fresh storage filled to fillPct of the active page */
+static void BenchFill(uint32_t fillPct)
+{
+    NVM_Status_t status;
+    uint32_t i, e, el;
+    uint8_t* p;
+
+    NV_HostFlashInit();
+    BenchReboot();
+    if(gNVM_OK_c != (status = NvModuleInit()))
+    {
+        BenchDie("NvModuleInit", status);
+    }
+
+    /* every entry starts with a full save */
+    for(e = 0; e < mBenchEntries_c; e++)
+    {
+        p = mBenchDataTable[e].pData;
+        for(i = 0; i < mBenchDataTable[e].ElementsCount * mBenchDataTable[e].ElementSize; i++)
+        {
+            p[i] = (uint8_t)BenchRand();
+        }
+        if(gNVM_OK_c != (status = NvSyncSave(p, TRUE)))
+        {
+            BenchDie("NvSyncSave", status);
+        }
+    }
+
+    while(BenchUsedPct() < fillPct)
+    {
+        e = BenchRand() % mBenchEntries_c;
+        el = BenchRand() % mBenchDataTable[e].ElementsCount;
+        p = (uint8_t*)mBenchDataTable[e].pData + el * mBenchDataTable[e].ElementSize;
+        for(i = 0; i < mBenchDataTable[e].ElementSize; i++)
+        {
+            p[i] = (uint8_t)BenchRand();
+        }
+        status = NvSyncSave(p, (BenchRand() % 100) < mBenchFullSavePct_c);
+        if(gNVM_OK_c != status)
+        {
+            BenchDie("NvSyncSave", status);
+        }
+    }
+    BenchSnapshot();
+}
+
+static void BenchRun(uint32_t fillPct, uint32_t rounds, benchResult_t* pBoot, benchResult_t* pCopy, uint32_t* pMetas)
+{
+    NVM_Status_t status;
+    uint32_t r, k;
+    double t;
+
+    memset(pBoot, 0, sizeof(*pBoot));
+    memset(pCopy, 0, sizeof(*pCopy));
+    *pMetas = 0;
+
+    for(r = 0; r < rounds; r++)
+    {
+        mSeed = 1 + r * 7919 + fillPct;
+        BenchFill(fillPct);
+        *pMetas += (mNvVirtualPageProperty[mNvActivePageId].NvLastMetaInfoAddress -
+                    mNvVirtualPageProperty[mNvActivePageId].NvRawSectorStartAddress - gNvFirstMetaOffset_c) /
+                   sizeof(NVM_RecordMetaInfo_t) + 1;
+
+        for(k = 0; k < mBenchBootRepeat_c; k++)
+        {
+            gNvHostFlashStats.readCalls = 0;
+            t = BenchNs();
+            BenchBoot();
+            pBoot->ns += BenchNs() - t;
+            pBoot->reads += gNvHostFlashStats.readCalls;
+            BenchCheck("boot");
+        }
+
+        gNvHostFlashStats.readCalls = 0;
+        t = BenchNs();
+        status = NvCopyPage(gNvCopyAll_c);
+        pCopy->ns += BenchNs() - t;
+        pCopy->reads += gNvHostFlashStats.readCalls;
+        if(gNVM_OK_c != status)
+        {
+            BenchDie("NvCopyPage", status);
+        }
+        if(gNVM_OK_c != (status = NvEraseVirtualPage(mNvErasePgCmdStatus.NvPageToErase)))
+        {
+            BenchDie("NvEraseVirtualPage", status);
+        }
+        mNvErasePgCmdStatus.NvErasePending = FALSE;
+
+        BenchBoot();
+        BenchCheck("copy");
+    }
+
+    pBoot->ns /= rounds * mBenchBootRepeat_c;
+    pBoot->reads /= rounds * mBenchBootRepeat_c;
+    pCopy->ns /= rounds;
+    pCopy->reads /= rounds;
+    *pMetas /= rounds;
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char* argv[])
+{
+    static const uint32_t fillLevels[] = {25, 50, 90};
+    benchResult_t boot, copy;
+    uint32_t rounds = mBenchDefaultRounds_c;
+    uint32_t metas;
+    uint32_t i;
+
+    if(argc > 1)
+    {
+        rounds = (uint32_t)strtoul(argv[1], NULL, 0);
+        if(0 == rounds)
+        {
+            rounds = 1;
+        }
+    }
+
+    for(i = 0; i < mBenchEntries_c; i++)
+    {
+        maGolden[i] = malloc(mBenchDataTable[i].ElementsCount * mBenchDataTable[i].ElementSize);
+    }
+
+    printf("meta index %s, page %u bytes, %u rounds\n", gNvMetaIndex_Enabled_d ? "on" : "off",
+           (unsigned)(NV_HostFlashSize() / 2), (unsigned)rounds);
+    printf("fill  metas  boot us  boot reads  copy us  copy reads\n");
+
+    for(i = 0; i < sizeof(fillLevels) / sizeof(fillLevels[0]); i++)
+    {
+        BenchRun(fillLevels[i], rounds, &boot, &copy, &metas);
+        printf("%3u%%  %5u  %7.1f  %10.0f  %7.1f  %10.0f\n", (unsigned)fillLevels[i], (unsigned)metas,
+               boot.ns / 1000, boot.reads, copy.ns / 1000, copy.reads);
+    }
+    return 0;
+}
@@ -0,0 +1,981 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file NvStressBench.c
+* Host endurance, latency and power-cut benchmark of the NVM module.
+*
+* NV_Flash.c is built with the Thread end device configuration (fragmentation,
+* extended and unmirrored feature sets) against the simulated flash of
+* NvHostFlash.c. The data table has the shape of the nwk_ip NVM_DataTable
+* (base/utils/nv_data.c) for the end device example: same IDs, element counts and
+* mirroring types; the element sizes are those of the stack structures, rounded.
+* Every simulated second the workload updates the data sets at the rates of the
+* table below, using the same NVM calls as the stack (NvSaveOnInterval() for the
+* frame counters, NvSaveOnIdle() through NVNG_Save(), NvSyncSave() through
+* NVNG_SyncSave(), an occasional NvAtomicSave()), fires the save-on-interval
+* timer and runs NvIdle(). Now and then the device attaches again and all the
+* idle and interval saved data sets are refreshed in the same second.
+* The router workload is frame counter heavy: the neighbor table is larger and
+* holds the incoming frame counters, saved on interval as a whole; only the
+* counter of the updated neighbor changes, and the table is written with delta
+* records (see gNvDeltaRecords_Enabled_d).
+*
+* endurance: measures one attach burst, then runs the workload for the given
+*   number of hours and reports the latency of the NVM calls (flash busy time
+*   from the NvHostFlash timing model), the program operations, the bytes
+*   programmed per save request, the page copies per hour and per day and the
+*   erase count of every sector, next to the one estimated by
+*   NvGetSectorEraseCycles() (the format erase is not counted). The "copy"
+*   latency is the one of the NvIdle() calls running a page copy slice, see
+*   gNvCopySliceRecordsCount_c. The device is power cycled after every
+*   NvAtomicSave() and at the end, and the restored data is checked.
+* power cut: replays the workload from a blank flash up to the end of the first
+*   page copy and cuts the power at every stride-th flash offset of it. After each
+*   cut the device boots, the restored data is checked, the workload continues for
+*   a minute and the data is checked again after a clean power cycle. The cuts
+*   during a page copy must find the copy again on boot and resume it.
+*
+* Data check: every element carries its version. After a boot, each element must
+* hold a version that is at least the last one known to be stored (NvSyncSave()
+* returned OK, the idle/interval save was processed, NvAtomicSave() returned OK)
+* and at most the last one written in RAM.
+*
+* Build (the NV_STORAGE_* symbols set the simulated flash geometry):
+*   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast -I. -I../Interface
+*       -I../Source -I../../Flash/Internal -I../../Common -I../../FunctionLib
+*       -I../../TimersManager/Interface
+*       -I../../RNG/Interface -I../../OSAbstraction/Interface -I../../Messaging/Interface
+*       -I../../MemManager/Interface -I../../Lists
+*       -Wl,--defsym,NV_STORAGE_END_ADDRESS=0x30000000
+*       -Wl,--defsym,NV_STORAGE_SECTOR_SIZE=0x800 -Wl,--defsym,NV_STORAGE_MAX_SECTORS=16
+*       -o NvStressBench NvStressBench.c NvHostFlash.c ../../FunctionLib/FunctionLib.c
+*   add -DgNvCommitEngine_Enabled_d=0 or -DgNvCommitDeadlineTicks_c=<ticks> to
+*   compare the NVM commit engine settings, -DgNvRingPagesCount_d=<pages> to
+*   compare the two virtual pages with a ring of smaller pages,
+*   -DgNvCopySliceRecordsCount_c=0 to copy the whole page in one NvIdle() call,
+*   -DgNvDeltaRecords_Enabled_d=0 to write full records only
+* Usage: NvStressBench [hours [cut stride [seed [workload]]]]
+*   a cut stride of 0 skips the power-cut sweep; the workload is "enddevice"
+*   (default) or "router"
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <setjmp.h>
+
+/* app_framework_config.h of the nwk_ip examples */
+#ifndef gNvStorageIncluded_d
+#define gNvStorageIncluded_d            1
+#endif
+#ifndef gNvFragmentation_Enabled_d
+#define gNvFragmentation_Enabled_d      1
+#endif
+#ifndef gNvUseExtendedFeatureSet_d
+#define gNvUseExtendedFeatureSet_d      1
+#endif
+#ifndef gUnmirroredFeatureSet_d
+#define gUnmirroredFeatureSet_d         1
+#endif
+#ifndef gNvTableEntriesCountMax_c
+#define gNvTableEntriesCountMax_c       38
+#endif
+#ifndef gNvMinimumTicksBetweenSaves_c
+#define gNvMinimumTicksBetweenSaves_c   2
+#endif
+#ifndef gTMR_Enabled_d
+#define gTMR_Enabled_d                  0
+#endif
+#ifndef gFsciIncluded_c
+#define gFsciIncluded_c                 0
+#endif
+
+#include "NvHostFlash.h"
+#include "../Source/NV_Flash.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultHours_c        (24)
+#define mBenchDefaultCutStride_c    (1)
+#define mBenchResumeSeconds_c       (60)
+#define mBenchMaxElements_c         (128)
+#define mBenchMirroredBytes_c       (1024)
+#define mBenchAtomicPerHour_c       (0.1)
+#define mBenchAttachPerHour_c       (0.5)
+
+#define mBenchTableSize(table)      (sizeof(table) / sizeof(table[0]))
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef enum benchSaveApi_tag
+{
+    mBenchSync_c,           /* NvSyncSave() */
+    mBenchIdle_c,           /* NvSaveOnIdle() */
+    mBenchInterval_c        /* NvSaveOnInterval() */
+} benchSaveApi_t;
+
+typedef enum benchLatency_tag
+{
+    mBenchLatSync_c,
+    mBenchLatIdle_c,
+    mBenchLatAtomic_c,
+    mBenchLatCopy_c,        /* the NvIdle() calls running a page copy slice */
+    mBenchLatCount_c
+} benchLatency_t;
+
+typedef struct benchEntry_tag
+{
+    uint16_t id;
+    uint16_t elementsCount;
+    uint16_t elementSize;
+    uint16_t type;
+    benchSaveApi_t api;
+    bool_t saveAll;
+    double ratePerHour;     /* element updates */
+    bool_t counter;         /* an update only changes the version, as for a frame counter */
+    bool_t delta;           /* written with delta records, see NvSetDeltaRecords() */
+} benchEntry_t;
+
+typedef struct benchSamples_tag
+{
+    uint32_t* pUs;
+    uint32_t count;
+    uint32_t size;
+} benchSamples_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+/* nwk_ip end device: nv_data.c NVM_DataTable with examples/end_device/config/config.h */
+static const benchEntry_t maBenchEndDevice[] =
+{
+    /* ID    count size  type                                 api               all    rate    ctr    delta */
+    {0x0001, 16,   24,   gNVM_NotMirroredInRam_c,             mBenchSync_c,     FALSE, 2,      FALSE, FALSE}, /* 6LoWPAN contexts */
+    {0x0002,  1,   32,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 1,      FALSE, FALSE}, /* DHCPv6 client */
+    {0x0006,  7,   28,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 2,      FALSE, FALSE}, /* IPv6 addresses */
+    {0x000F,  5,   24,   gNVM_NotMirroredInRam_c,             mBenchIdle_c,     FALSE, 4,      FALSE, FALSE}, /* IPv6 multicast */
+    {0x000A,  6,   40,   gNVM_NotMirroredInRam_c,             mBenchIdle_c,     FALSE, 30,     FALSE, FALSE}, /* IPv6 routes */
+    {0x0007,  1,   28,   gNVM_NotMirroredInRam_c,             mBenchIdle_c,     FALSE, 10,     FALSE, FALSE}, /* MPL instances */
+    {0x0008,  1,    1,   gNVM_MirroredInRam_c,                mBenchInterval_c, TRUE,  60,     FALSE, FALSE}, /* MPL sequence */
+    {0x000B,  1,   12,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 0.2,    FALSE, FALSE}, /* MAC filtering */
+    {0x0013,  1,    1,   gNVM_MirroredInRam_c,                mBenchSync_c,     TRUE,  0.1,    FALSE, FALSE}, /* MAC filtering policy */
+    {0x000C,  1,   20,   gNVM_NotMirroredInRam_c,             mBenchSync_c,     FALSE, 0.5,    FALSE, FALSE}, /* ND configuration */
+    {0x000D,  4,   32,   gNVM_NotMirroredInRam_c,             mBenchSync_c,     FALSE, 1,      FALSE, FALSE}, /* ND prefixes */
+    {0x0010,  1,  200,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 4,      FALSE, FALSE}, /* Thread attributes */
+    {0x0018,  1,   96,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 0.2,    FALSE, FALSE}, /* Thread string attributes */
+    {0x001E,  1,  120,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 0.5,    FALSE, FALSE}, /* active dataset */
+    {0x001F,  1,  128,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 0.5,    FALSE, FALSE}, /* pending dataset */
+    {0x0012,  1,    4,   gNVM_MirroredInRam_c,                mBenchInterval_c, TRUE,  120,    TRUE,  FALSE}, /* MLE frame counter */
+    {0x0014,  1,    4,   gNVM_MirroredInRam_c,                mBenchInterval_c, TRUE,  3600,   TRUE,  FALSE}, /* MAC frame counter */
+    {0x0004,  5,   40,   gNVM_MirroredInRam_c,                mBenchIdle_c,     FALSE, 60,     FALSE, FALSE}, /* neighbors */
+    {0x001D,  6,   16,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 1,      FALSE, FALSE}, /* SLAAC addresses */
+};
+
+/* frame counter heavy: a router keeps the incoming frame counter of every
+   neighbor, saved on interval with the whole neighbor table */
+static const benchEntry_t maBenchRouter[] =
+{
+    /* ID    count size  type                                 api               all    rate    ctr    delta */
+    {0x0001, 16,   24,   gNVM_NotMirroredInRam_c,             mBenchSync_c,     FALSE, 2,      FALSE, FALSE}, /* 6LoWPAN contexts */
+    {0x0002,  1,   32,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 1,      FALSE, FALSE}, /* DHCPv6 client */
+    {0x0006,  7,   28,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 2,      FALSE, FALSE}, /* IPv6 addresses */
+    {0x000F,  5,   24,   gNVM_NotMirroredInRam_c,             mBenchIdle_c,     FALSE, 4,      FALSE, FALSE}, /* IPv6 multicast */
+    {0x000A,  6,   40,   gNVM_NotMirroredInRam_c,             mBenchIdle_c,     FALSE, 30,     FALSE, FALSE}, /* IPv6 routes */
+    {0x0007,  1,   28,   gNVM_NotMirroredInRam_c,             mBenchIdle_c,     FALSE, 10,     FALSE, FALSE}, /* MPL instances */
+    {0x0008,  1,    1,   gNVM_MirroredInRam_c,                mBenchInterval_c, TRUE,  60,     FALSE, FALSE}, /* MPL sequence */
+    {0x000B,  1,   12,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 0.2,    FALSE, FALSE}, /* MAC filtering */
+    {0x0013,  1,    1,   gNVM_MirroredInRam_c,                mBenchSync_c,     TRUE,  0.1,    FALSE, FALSE}, /* MAC filtering policy */
+    {0x000C,  1,   20,   gNVM_NotMirroredInRam_c,             mBenchSync_c,     FALSE, 0.5,    FALSE, FALSE}, /* ND configuration */
+    {0x000D,  4,   32,   gNVM_NotMirroredInRam_c,             mBenchSync_c,     FALSE, 1,      FALSE, FALSE}, /* ND prefixes */
+    {0x0010,  1,  200,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 4,      FALSE, FALSE}, /* Thread attributes */
+    {0x0018,  1,   96,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 0.2,    FALSE, FALSE}, /* Thread string attributes */
+    {0x001E,  1,  120,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 0.5,    FALSE, FALSE}, /* active dataset */
+    {0x001F,  1,  128,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 0.5,    FALSE, FALSE}, /* pending dataset */
+    {0x0012,  1,    4,   gNVM_MirroredInRam_c,                mBenchInterval_c, TRUE,  120,    TRUE,  FALSE}, /* MLE frame counter */
+    {0x0014,  1,    4,   gNVM_MirroredInRam_c,                mBenchInterval_c, TRUE,  3600,   TRUE,  FALSE}, /* MAC frame counter */
+    {0x0004, 16,   40,   gNVM_MirroredInRam_c,                mBenchInterval_c, TRUE,  1800,   TRUE,  TRUE }, /* neighbors, incoming frame counters */
+    {0x001D,  6,   16,   gNVM_NotMirroredInRamAutoRestore_c,  mBenchSync_c,     FALSE, 1,      FALSE, FALSE}, /* SLAAC addresses */
+};
+
+static NVM_DataEntry_t maBenchDataTable[gNvTableEntriesCountMax_c];
+NVM_DataEntry_t* pNVM_DataTable = maBenchDataTable;
+
+/* the data sets; static so that their addresses fit in uint32_t */
+static uint8_t maBenchMirrored[mBenchMirroredBytes_c];
+static void* maBenchUnmirrored[mBenchMaxElements_c];
+
+/* element versions, see BenchCheck() */
+static uint16_t maBenchFirstElement[gNvTableEntriesCountMax_c];
+static uint32_t maWritten[mBenchMaxElements_c];
+static uint32_t maDurable[mBenchMaxElements_c];
+static uint32_t maRequested[mBenchMaxElements_c];
+static bool_t maPending[gNvTableEntriesCountMax_c];
+
+static const benchEntry_t* mpBenchEntries = maBenchEndDevice;
+static uint32_t mBenchEntriesCount = mBenchTableSize(maBenchEndDevice);
+
+static uint64_t mSeed;
+static jmp_buf mPowerCutJmp;
+
+static benchSamples_t maLatency[mBenchLatCount_c];
+static uint32_t mPageCopies;
+static uint32_t mSaveRequests;
+static NVM_VirtualPageID_t mLastActivePage;
+static uint32_t mInconsistencies;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    mSeed = mSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(mSeed >> 33);
+}
+
+static double BenchRandUnit(void)
+{
+    return BenchRand() / 2147483648.0;
+}
+
+static void BenchPowerCutCallback(void)
+{
+    longjmp(mPowerCutJmp, 1);
+}
+
+static bool_t BenchIsMirrored(uint32_t e)
+{
+    return gNVM_MirroredInRam_c == mpBenchEntries[e].type;
+}
+
+/* element content: the version, then bytes derived from it (from the element
+   only for a counter) */
+static uint8_t BenchPatternByte(uint32_t e, uint32_t el, uint32_t v, uint32_t i)
+{
+    uint32_t x;
+
+    if(mpBenchEntries[e].counter)
+    {
+        v = 1;
+    }
+    x = (v * 2654435761u) ^ (mpBenchEntries[e].id << 16) ^ (el << 8) ^ i;
+    x ^= x >> 15;
+    x *= 0x2C1B3C6Du;
+    return (uint8_t)(x >> 24);
+}
+
+static void BenchEncode(uint32_t e, uint32_t el, uint32_t v, uint8_t* p)
+{
+    uint32_t i;
+
+    for(i = 0; i < mpBenchEntries[e].elementSize; i++)
+    {
+        p[i] = (i < sizeof(uint32_t)) ? (uint8_t)(v >> (8 * i)) : BenchPatternByte(e, el, v, i);
+    }
+}
+
+/* returns FALSE if the content is not a version in [durable, written] */
+static bool_t BenchDecode(uint32_t e, uint32_t el, const uint8_t* p, uint32_t* pVersion)
+{
+    uint32_t g = maBenchFirstElement[e] + el;
+    uint32_t size = mpBenchEntries[e].elementSize;
+    uint32_t v = 0;
+    uint32_t i;
+
+    if(NULL == p)
+    {
+        *pVersion = 0;
+        return (0 == maDurable[g]);
+    }
+
+    for(i = 0; (i < size) && (i < sizeof(uint32_t)); i++)
+    {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+
+    if(size < sizeof(uint32_t))
+    {
+        /* only the low bits are stored, take the matching version of the range */
+        uint32_t mask = (1u << (8 * size)) - 1;
+        uint32_t c;
+
+        for(c = maDurable[g]; c <= maWritten[g]; c++)
+        {
+            if((c & mask) == v)
+            {
+                *pVersion = c;
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+
+    for(i = sizeof(uint32_t); i < size; i++)
+    {
+        if(p[i] != ((0 == v) ? 0 : BenchPatternByte(e, el, v, i)))
+        {
+            return FALSE;
+        }
+    }
+    *pVersion = v;
+    return (v >= maDurable[g]) && (v <= maWritten[g]);
+}
+
+static uint8_t* BenchElement(uint32_t e, uint32_t el)
+{
+    if(BenchIsMirrored(e))
+    {
+        return (uint8_t*)maBenchDataTable[e].pData + el * mpBenchEntries[e].elementSize;
+    }
+    return ((uint8_t**)maBenchDataTable[e].pData)[el];
+}
+
+static void BenchSample(benchLatency_t kind, uint64_t us)
+{
+    benchSamples_t* pS = &maLatency[kind];
+
+    if(pS->count == pS->size)
+    {
+        pS->size = pS->size ? 2 * pS->size : 4096;
+        pS->pUs = realloc(pS->pUs, pS->size * sizeof(uint32_t));
+    }
+    pS->pUs[pS->count++] = (uint32_t)us;
+}
+
+static void BenchTrackPage(void)
+{
+    if(mNvActivePageId != mLastActivePage)
+    {
+        mPageCopies++;
+        mLastActivePage = mNvActivePageId;
+    }
+}
+
+static bool_t BenchIsQueued(uint16_t id)
+{
+    uint32_t i, idx = mNvPendingSavesQueue.Head;
+
+#if gNvUseCommitEngine_c
+    if(NvCommitIsDirty(NvGetTableEntryIndexFromId(id)))
+    {
+        return TRUE;
+    }
+#endif
+    for(i = 0; i < mNvPendingSavesQueue.EntriesCount; i++)
+    {
+        if(mNvPendingSavesQueue.QData[idx].entryId == id)
+        {
+            return TRUE;
+        }
+        if(++idx >= gNvPendingSavesQueueSize_c)
+        {
+            idx = 0;
+        }
+    }
+    return FALSE;
+}
+
+static void BenchMarkDurable(uint32_t e, const uint32_t* pVersions)
+{
+    uint32_t el, g;
+
+    for(el = 0; el < mpBenchEntries[e].elementsCount; el++)
+    {
+        g = maBenchFirstElement[e] + el;
+        if(pVersions[g] > maDurable[g])
+        {
+            maDurable[g] = pVersions[g];
+        }
+    }
+}
+
+/* idle and interval saves are stored once the NVM no longer holds them */
+static void BenchSettle(void)
+{
+    uint32_t e;
+
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        if(maPending[e] && !maDatasetInfo[e].saveNextInterval && !BenchIsQueued(mpBenchEntries[e].id))
+        {
+            BenchMarkDurable(e, maRequested);
+            maPending[e] = FALSE;
+        }
+    }
+}
+
+static bool_t BenchIsPending(void)
+{
+    uint32_t e;
+
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        if(maPending[e])
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void BenchFatal(const char* what, int status)
+{
+    fprintf(stderr, "%s failed, status %d\n", what, status);
+    exit(1);
+}
+
+/* builds the NVM table; the RAM data is cleared as by a reset */
+static void BenchBuildTable(void)
+{
+    uint32_t e, elements = 0, bytes = 0;
+
+    memset(maBenchMirrored, 0, sizeof(maBenchMirrored));
+    memset(maBenchUnmirrored, 0, sizeof(maBenchUnmirrored));
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        maBenchFirstElement[e] = elements;
+        maBenchDataTable[e].ElementsCount = mpBenchEntries[e].elementsCount;
+        maBenchDataTable[e].ElementSize = mpBenchEntries[e].elementSize;
+        maBenchDataTable[e].DataEntryID = mpBenchEntries[e].id;
+        maBenchDataTable[e].DataEntryType = mpBenchEntries[e].type;
+        if(BenchIsMirrored(e))
+        {
+            maBenchDataTable[e].pData = &maBenchMirrored[bytes];
+            bytes += mpBenchEntries[e].elementsCount * mpBenchEntries[e].elementSize;
+        }
+        else
+        {
+            maBenchDataTable[e].pData = &maBenchUnmirrored[elements];
+        }
+        elements += mpBenchEntries[e].elementsCount;
+    }
+    maBenchDataTable[e].pData = NULL;
+    maBenchDataTable[e].DataEntryID = gNvEndOfTableId_c;
+#if gNvUseDeltaRecords_c
+    mNvDeltaEntriesCount = 0;
+#endif
+
+    if((elements > mBenchMaxElements_c) || (bytes > mBenchMirroredBytes_c))
+    {
+        BenchFatal("BenchBuildTable", 0);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief  Reset: the NVM RAM state and the data sets are lost, the module boots
+ *         and the data is restored as the stack does. Returns the count of
+ *         elements that do not hold an acceptable version.
+********************************************************************************** */
+static uint32_t BenchBoot(void)
+{
+    NVM_Status_t status;
+    uint32_t e, el, g, v;
+    uint32_t bad = 0;
+
+    NV_HostFlashSetPowerCut(gNvHostNoPowerCut_c, NULL);
+    mNvModuleInitialized = FALSE;
+    mNvFlashConfigInitialised = FALSE;
+    mNvCopyOperationIsPending = FALSE;
+    mNvCriticalSectionFlag = 0;
+    mNvTableUpdated = FALSE;
+    memset(&mNvErasePgCmdStatus, 0, sizeof(mNvErasePgCmdStatus));
+    NV_HostMemReset();
+    BenchBuildTable();
+
+    if(gNVM_OK_c != (status = NvModuleInit()))
+    {
+        BenchFatal("NvModuleInit", status);
+    }
+    /* the save-on-interval timer, driven by the workload */
+    mNvSaveOnIntervalTimerID = 0;
+    mLastActivePage = mNvActivePageId;
+
+#if gNvUseDeltaRecords_c
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        if(mpBenchEntries[e].delta && (gNVM_OK_c != (status = NvSetDeltaRecords(maBenchDataTable[e].pData, TRUE))))
+        {
+            BenchFatal("NvSetDeltaRecords", status);
+        }
+    }
+#endif
+
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        if(BenchIsMirrored(e))
+        {
+            status = NvRestoreDataSet(maBenchDataTable[e].pData, TRUE);
+        }
+        else if(gNVM_NotMirroredInRam_c == mpBenchEntries[e].type)
+        {
+            for(el = 0; el < mpBenchEntries[e].elementsCount; el++)
+            {
+                status = NvRestoreDataSet(&((void**)maBenchDataTable[e].pData)[el], FALSE);
+                if((gNVM_OK_c != status) && (gNVM_MetaNotFound_c != status))
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            status = gNVM_OK_c;
+        }
+        if((gNVM_OK_c != status) && (gNVM_MetaNotFound_c != status) && (gNVM_PageIsEmpty_c != status))
+        {
+            BenchFatal("NvRestoreDataSet", status);
+        }
+
+        for(el = 0; el < mpBenchEntries[e].elementsCount; el++)
+        {
+            g = maBenchFirstElement[e] + el;
+            if(!BenchDecode(e, el, BenchElement(e, el), &v))
+            {
+                bad++;
+                v = maDurable[g];
+            }
+            maWritten[g] = maDurable[g] = maRequested[g] = v;
+        }
+        maPending[e] = FALSE;
+    }
+    return bad;
+}
+
+/* the stack changes one element and asks the NVM to save it */
+static void BenchUpdate(uint32_t e, uint32_t el)
+{
+    NVM_Status_t status = gNVM_OK_c;
+    uint32_t g = maBenchFirstElement[e] + el;
+    uint64_t busy = gNvHostFlashStats.busyUs;
+    void* pSave;
+    uint32_t i;
+
+    if(BenchIsMirrored(e))
+    {
+        pSave = BenchElement(e, el);
+    }
+    else
+    {
+        /* NVNG_MoveToRam() */
+        pSave = &((void**)maBenchDataTable[e].pData)[el];
+        if(gNVM_OK_c != (status = NvMoveToRam((void**)pSave)))
+        {
+            BenchFatal("NvMoveToRam", status);
+        }
+    }
+
+    maWritten[g]++;
+    BenchEncode(e, el, maWritten[g], BenchElement(e, el));
+    mSaveRequests++;
+
+    switch(mpBenchEntries[e].api)
+    {
+    case mBenchSync_c:
+        status = NvSyncSave(pSave, mpBenchEntries[e].saveAll);
+        BenchSample(mBenchLatSync_c, gNvHostFlashStats.busyUs - busy);
+        if(gNVM_OK_c == status)
+        {
+            if(mpBenchEntries[e].saveAll)
+            {
+                BenchMarkDurable(e, maWritten);
+            }
+            else if(maWritten[g] > maDurable[g])
+            {
+                maDurable[g] = maWritten[g];
+            }
+        }
+        break;
+    case mBenchIdle_c:
+        status = NvSaveOnIdle(pSave, mpBenchEntries[e].saveAll);
+        /* a full queue makes the NVM process its head right away */
+        BenchSample(mBenchLatIdle_c, gNvHostFlashStats.busyUs - busy);
+        break;
+    case mBenchInterval_c:
+        status = NvSaveOnInterval(pSave);
+        break;
+    }
+    if(gNVM_OK_c != status)
+    {
+        BenchFatal("save", status);
+    }
+
+    if(mBenchSync_c != mpBenchEntries[e].api)
+    {
+        for(i = 0; i < mpBenchEntries[e].elementsCount; i++)
+        {
+            if(mpBenchEntries[e].saveAll || (i == el))
+            {
+                maRequested[maBenchFirstElement[e] + i] = maWritten[maBenchFirstElement[e] + i];
+            }
+        }
+        maPending[e] = TRUE;
+    }
+    BenchTrackPage();
+}
+
+static void BenchAtomicSave(void)
+{
+    NVM_Status_t status;
+    uint64_t busy = gNvHostFlashStats.busyUs;
+    uint32_t e;
+
+    if(gNVM_OK_c != (status = NvAtomicSave()))
+    {
+        BenchFatal("NvAtomicSave", status);
+    }
+    BenchSample(mBenchLatAtomic_c, gNvHostFlashStats.busyUs - busy);
+    mSaveRequests++;
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        BenchMarkDurable(e, maWritten);
+    }
+    BenchTrackPage();
+}
+
+/* the device attaches again: every element saved by NvSaveOnIdle() or
+   NvSaveOnInterval() is refreshed in the same second */
+static void BenchAttach(void)
+{
+    uint32_t e, el;
+
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        if(mBenchSync_c != mpBenchEntries[e].api)
+        {
+            for(el = 0; el < mpBenchEntries[e].elementsCount; el++)
+            {
+                BenchUpdate(e, el);
+            }
+        }
+    }
+}
+
+/* one second of the device life */
+static void BenchSecond(bool_t allowAtomic)
+{
+    uint64_t busy;
+    bool_t copying;
+    uint32_t e;
+
+    if(BenchRandUnit() * 3600 < mBenchAttachPerHour_c)
+    {
+        BenchAttach();
+    }
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        if(BenchRandUnit() * 3600 < mpBenchEntries[e].ratePerHour)
+        {
+            BenchUpdate(e, BenchRand() % mpBenchEntries[e].elementsCount);
+        }
+    }
+
+    /* save-on-interval timer and idle task */
+    NvIntervalTimerCallback(NULL);
+    busy = gNvHostFlashStats.busyUs;
+    copying = mNvCopyOperationIsPending;
+    NvIdle();
+    if(gNvHostFlashStats.busyUs != busy)
+    {
+        BenchSample(mBenchLatIdle_c, gNvHostFlashStats.busyUs - busy);
+    }
+    if(copying)
+    {
+        BenchSample(mBenchLatCopy_c, gNvHostFlashStats.busyUs - busy);
+    }
+    BenchTrackPage();
+    BenchSettle();
+
+    if(allowAtomic && (BenchRandUnit() * 3600 < mBenchAtomicPerHour_c))
+    {
+        BenchAtomicSave();
+        mInconsistencies += BenchBoot();
+    }
+}
+
+/* blank device, first boot and commissioning: everything is written once */
+static void BenchCommission(void)
+{
+    NVM_Status_t status;
+    uint32_t e, el, g;
+
+    NV_HostFlashInit();
+    memset(maDurable, 0, sizeof(maDurable));
+    memset(maWritten, 0, sizeof(maWritten));
+    (void)BenchBoot();
+
+    for(e = 0; e < mBenchEntriesCount; e++)
+    {
+        for(el = 0; el < mpBenchEntries[e].elementsCount; el++)
+        {
+            g = maBenchFirstElement[e] + el;
+            if(!BenchIsMirrored(e))
+            {
+                if(gNVM_OK_c != (status = NvMoveToRam(&((void**)maBenchDataTable[e].pData)[el])))
+                {
+                    BenchFatal("NvMoveToRam", status);
+                }
+            }
+            maWritten[g]++;
+            BenchEncode(e, el, maWritten[g], BenchElement(e, el));
+            if(!BenchIsMirrored(e))
+            {
+                if(gNVM_OK_c != (status = NvSyncSave(&((void**)maBenchDataTable[e].pData)[el], FALSE)))
+                {
+                    BenchFatal("NvSyncSave", status);
+                }
+                maDurable[g] = maWritten[g];
+            }
+        }
+        if(BenchIsMirrored(e))
+        {
+            if(gNVM_OK_c != (status = NvSyncSave(maBenchDataTable[e].pData, TRUE)))
+            {
+                BenchFatal("NvSyncSave", status);
+            }
+            BenchMarkDurable(e, maWritten);
+        }
+    }
+    BenchTrackPage();
+}
+
+static int BenchCompareU32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void BenchPrintLatency(const char* name, benchSamples_t* pS)
+{
+    if(0 == pS->count)
+    {
+        printf("  %-8s      0 calls\n", name);
+        return;
+    }
+    qsort(pS->pUs, pS->count, sizeof(uint32_t), BenchCompareU32);
+    printf("  %-8s %6u calls  p50 %7u  p90 %7u  p99 %7u  p99.9 %7u  max %7u us\n", name, (unsigned)pS->count,
+           (unsigned)pS->pUs[pS->count / 2], (unsigned)pS->pUs[(uint64_t)pS->count * 90 / 100],
+           (unsigned)pS->pUs[(uint64_t)pS->count * 99 / 100], (unsigned)pS->pUs[(uint64_t)pS->count * 999 / 1000],
+           (unsigned)pS->pUs[pS->count - 1]);
+}
+
+static void BenchEndurance(uint32_t hours, uint64_t seed)
+{
+    uint32_t s, i, minErases = 0xFFFFFFFF, maxErases = 0;
+    uint32_t programOps, programBytes;
+    uint64_t totalErases = 0;
+
+    mSeed = seed;
+    mPageCopies = 0;
+    mInconsistencies = 0;
+    BenchCommission();
+
+    /* one attach burst, until the save-on-interval data sets are written too */
+    programOps = gNvHostFlashStats.programOps;
+    programBytes = gNvHostFlashStats.programBytes;
+    BenchAttach();
+    for(s = 0; (s < mBenchResumeSeconds_c) && BenchIsPending(); s++)
+    {
+        NvIntervalTimerCallback(NULL);
+        NvIdle();
+        BenchSettle();
+    }
+    printf("attach burst: %u program operations, %u bytes programmed\n",
+           (unsigned)(gNvHostFlashStats.programOps - programOps), (unsigned)(gNvHostFlashStats.programBytes - programBytes));
+
+    mPageCopies = 0;
+    mSaveRequests = 0;
+    programOps = gNvHostFlashStats.programOps;
+    programBytes = gNvHostFlashStats.programBytes;
+    for(i = 0; i < mBenchLatCount_c; i++)
+    {
+        maLatency[i].count = 0;
+    }
+
+    for(s = 0; s < hours * 3600; s++)
+    {
+        BenchSecond(TRUE);
+    }
+    mInconsistencies += BenchBoot();
+
+    printf("endurance: %u h, flash timing: program %u us/unit, erase %u us/sector\n", (unsigned)hours,
+           (unsigned)gNvHostFlashTiming.programUs, (unsigned)gNvHostFlashTiming.eraseUs);
+    printf("save latency (flash busy time):\n");
+    BenchPrintLatency("sync", &maLatency[mBenchLatSync_c]);
+    BenchPrintLatency("idle", &maLatency[mBenchLatIdle_c]);
+    BenchPrintLatency("atomic", &maLatency[mBenchLatAtomic_c]);
+    BenchPrintLatency("copy", &maLatency[mBenchLatCopy_c]);
+    printf("page copies: %u (%.2f per hour, %.1f per day)\n", (unsigned)mPageCopies, (double)mPageCopies / hours,
+           (double)mPageCopies * 24 / hours);
+    printf("after commissioning: %u program operations, %u bytes programmed (%.0f per hour)\n",
+           (unsigned)(gNvHostFlashStats.programOps - programOps), (unsigned)(gNvHostFlashStats.programBytes - programBytes),
+           (double)(gNvHostFlashStats.programBytes - programBytes) / hours);
+    printf("save requests: %u, %.1f bytes programmed per request (page copies included)\n", (unsigned)mSaveRequests,
+           mSaveRequests ? (double)(gNvHostFlashStats.programBytes - programBytes) / mSaveRequests : 0.0);
+    printf("erases per sector:");
+    for(i = 0; i < NV_HostFlashSectorsCount(); i++)
+    {
+        uint32_t n = gNvHostFlashStats.sectorErases[i];
+
+        printf("%s%5u", (i % 8) ? " " : "\n  ", (unsigned)n);
+        totalErases += n;
+        minErases = (n < minErases) ? n : minErases;
+        maxErases = (n > maxErases) ? n : maxErases;
+    }
+    printf("\n  min %u, max %u, mean %.1f, max per hour %.2f\n", (unsigned)minErases, (unsigned)maxErases,
+           (double)totalErases / NV_HostFlashSectorsCount(), (double)maxErases / hours);
+    printf("erase cycles estimated by the NVM after the last boot:");
+    for(i = 0; i < NV_HostFlashSectorsCount(); i++)
+    {
+        printf("%s%5u", (i % 8) ? " " : "\n  ", (unsigned)NvGetSectorEraseCycles(i));
+    }
+    printf("\n");
+    printf("data check: %u inconsistent elements\n", (unsigned)mInconsistencies);
+}
+
+static void BenchPowerCutSweep(uint32_t stride, uint64_t seed)
+{
+    uint32_t windowSeconds, windowStart, windowEnd, cut, s;
+    uint32_t runs = 0, badRuns = 0, resumed = 0, bad;
+
+    /* dry run: the window starts after the commissioning and ends when the
+       first page copy is done and the old page erased */
+    mSeed = seed;
+    BenchCommission();
+    windowStart = gNvHostFlashStats.offset;
+    mPageCopies = 0;
+    for(windowSeconds = 0; (0 == mPageCopies) || mNvErasePgCmdStatus.NvErasePending; windowSeconds++)
+    {
+        BenchSecond(FALSE);
+    }
+    windowEnd = gNvHostFlashStats.offset;
+
+    for(cut = windowStart; cut < windowEnd; cut += stride)
+    {
+        mSeed = seed;
+        BenchCommission();
+        if(0 == setjmp(mPowerCutJmp))
+        {
+            NV_HostFlashSetPowerCut(cut, BenchPowerCutCallback);
+            for(s = 0; s < windowSeconds; s++)
+            {
+                BenchSecond(FALSE);
+            }
+            /* not reached, the workload is not deterministic */
+            BenchFatal("power cut replay", (int)cut);
+        }
+
+        runs++;
+        bad = BenchBoot();
+        if(mNvCopyState.inProgress)
+        {
+            resumed++;
+        }
+        for(s = 0; s < mBenchResumeSeconds_c; s++)
+        {
+            BenchSecond(FALSE);
+        }
+        bad += BenchBoot();
+        if(bad)
+        {
+            badRuns++;
+            if(badRuns <= 10)
+            {
+                printf("  cut at offset %u: %u inconsistent elements\n", (unsigned)cut, (unsigned)bad);
+            }
+        }
+    }
+    printf("power cut: %u offsets over %u s of workload, stride %u: %u cuts, %u inconsistent recoveries, "
+           "%u page copies resumed\n", (unsigned)(windowEnd - windowStart), (unsigned)windowSeconds, (unsigned)stride,
+           (unsigned)runs, (unsigned)badRuns, (unsigned)resumed);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char* argv[])
+{
+    uint32_t hours = mBenchDefaultHours_c;
+    uint32_t stride = mBenchDefaultCutStride_c;
+    uint64_t seed = 1;
+
+    if(argc > 1)
+    {
+        hours = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if(argc > 2)
+    {
+        stride = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    if(argc > 3)
+    {
+        seed = strtoull(argv[3], NULL, 0);
+    }
+    if((argc > 4) && (0 == strcmp(argv[4], "router")))
+    {
+        mpBenchEntries = maBenchRouter;
+        mBenchEntriesCount = mBenchTableSize(maBenchRouter);
+    }
+
+    printf("flash: %u sectors of %u bytes, %s workload, %u table entries, delta records %s\n",
+           (unsigned)NV_HostFlashSectorsCount(), (unsigned)(uint32_t)NV_STORAGE_SECTOR_SIZE,
+           (mpBenchEntries == maBenchRouter) ? "router" : "end device", (unsigned)mBenchEntriesCount,
+           gNvUseDeltaRecords_c ? "on" : "off");
+    if(hours)
+    {
+        BenchEndurance(hours, seed);
+    }
+    if(stride)
+    {
+        BenchPowerCutSweep(stride, seed);
+    }
+    return 0;
+}
@@ -96,7 +96,7 @@ uint8_t RNG_HwGetRandomNo(uint32_t* pRandomNo);
 
 
 /*! *********************************************************************************
-* \brief  Initialize seed for the PRNG algorithm.
+* \brief  Initialize seed for the PRNG algorithm (instantiates the CTR_DRBG).
 *
 * \param[in]  pSeed - Pointer to the seed (20 bytes). 
 *                     Can be set using the RNG_GetRandomNo() function
@@ -106,13 +106,16 @@ void RNG_SetPseudoRandomNoSeed(uint8_t* pSeed);
 
 
 /*! *********************************************************************************
-* \brief  Generates a NIST FIPS Publication 186-2-compliant 160 bit pseudo-random number
+* \brief  Generates a pseudo-random number using the NIST SP 800-90A AES-128 CTR_DRBG.
+*         The DRBG is reseeded from RNG_HwGetRandomNo() every gRngMaxRequests_d requests.
 *
-* \param[out]     pOut - pointer to the output buffer (20 bytes)
-* \param[in]      outBytes - the number of bytes to be copyed (1-20)
-* \param[in]      pXSEED - optional user SEED (20 bytes). Should be NULL if not used.
+* \param[out]     pOut - pointer to the output buffer (outBytes bytes)
+* \param[in]      outBytes - the number of bytes to be generated (0-255)
+* \param[in]      pXSEED - optional user SEED (20 bytes), used as additional input.
+*                          Should be NULL if not used.
 *
-* \return         The number of bytes copied or -1 if reseed is needed
+* \return         The number of bytes generated or -1 if reseed is needed and no
+*                 entropy is available
 *
 ********************************************************************************** */
 int16_t RNG_GetPseudoRandomNo(uint8_t* pOut, uint8_t outBytes, uint8_t* pXSEED);
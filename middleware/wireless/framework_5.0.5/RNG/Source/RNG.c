@@ -59,9 +59,15 @@
 #define gRNG_UsePhyRngForInitialSeed_d 0
 #endif
 
-#define mPRNG_NoOfBits_c      (160)
-#define mPRNG_NoOfBytes_c     (mPRNG_NoOfBits_c/8)
-#define mPRNG_NoOfLongWords_c (mPRNG_NoOfBits_c/32)
+/* The PRNG is an AES-128 CTR_DRBG without derivation function (NIST SP 800-90A) */
+#define mPRNG_NoOfBytes_c     (20) /* size of the seed and of the XSEED */
+#define mPRNG_SeedLen_c       (2*AES_BLOCK_SIZE) /* seedlen = keylen + outlen */
+#define mPRNG_NoOfBlocks_c    (4)  /* blocks ciphered by one AES_128_CtxECB_Encrypt() call */
+
+/* Number of requests served before a reseed from the HW entropy source */
+#ifndef mPRNG_ReseedInterval_c
+#define mPRNG_ReseedInterval_c (gRngMaxRequests_d)
+#endif
 
 #if (cPWR_UsePowerDownMode)
 #define RNG_DisallowDeviceToSleep() PWR_DisallowDeviceToSleep()
@@ -76,8 +82,11 @@
 * Private memory declarations
 *************************************************************************************
 ********************************************************************************** */
-static uint32_t XKEY[mPRNG_NoOfLongWords_c];
-static uint32_t mPRNG_Requests = gRngMaxRequests_d;
+/* CTR_DRBG working state: the Key (kept expanded between requests), V and the
+   reseed counter. The counter is 0 until the DRBG is instantiated. */
+static aesKeyCtx_t mPRNG_Key;
+static uint8_t  mPRNG_V[AES_BLOCK_SIZE];
+static uint32_t mPRNG_Requests = 0;
 
 #if FSL_FEATURE_SOC_TRNG_COUNT
 uint8_t mRngDisallowMcuSleep = 0;
@@ -103,6 +112,12 @@ extern void PhyGetRandomNo(uint32_t *pRandomNo);
 #if FSL_FEATURE_SOC_TRNG_COUNT
 static void TRNG_ISR(void);
 #endif
+static uint8_t RNG_DrbgGetEntropy(uint32_t* pEntropy);
+static void RNG_DrbgCounterBlocks(uint8_t* pBlocks, uint32_t numBlocks);
+static void RNG_DrbgUpdate(const uint8_t* pProvidedData);
+static void RNG_DrbgInstantiate(const uint8_t* pEntropy, const uint8_t* pPersonalization);
+static void RNG_DrbgReseed(const uint8_t* pEntropy, const uint8_t* pAdditionalInput);
+static void RNG_DrbgGenerate(uint8_t* pOut, uint32_t outBytes, const uint8_t* pAdditionalInput);
 
 
 /*! *********************************************************************************
@@ -264,6 +279,7 @@ void RNG_GetRandomNo(uint32_t* pRandomNo)
 
 /*! *********************************************************************************
 * \brief  Initialize seed for the PRNG algorithm.
+*         The CTR_DRBG is instantiated with the seed as entropy input.
 *
 * \param[in]  pSeed - pointer to a buffer containing 20 bytes (160 bits).
 *             Can be set using the RNG_GetRandomNo() function.
@@ -271,94 +287,92 @@ void RNG_GetRandomNo(uint32_t* pRandomNo)
 ********************************************************************************** */
 void RNG_SetPseudoRandomNoSeed(uint8_t* pSeed)
 {
-    mPRNG_Requests = 1;
-    FLib_MemCpy( XKEY, pSeed, mPRNG_NoOfBytes_c );
+    uint8_t entropy[mPRNG_SeedLen_c];
+
+    FLib_MemCpy(entropy, pSeed, mPRNG_NoOfBytes_c);
+    FLib_MemSet(&entropy[mPRNG_NoOfBytes_c], 0, mPRNG_SeedLen_c - mPRNG_NoOfBytes_c);
+    RNG_DrbgInstantiate(entropy, NULL);
+    FLib_MemSet(entropy, 0, sizeof(entropy));
 }
 
 
 /*! *********************************************************************************
-* \brief  Pseudo Random Number Generator (PRNG) implementation
-*         according to NIST FIPS Publication 186-2, APPENDIX 3
-*
-*         Let x be the signer's private key.  
-*         The following may be used to generate m values of x:
-*           Step 1. Choose a new, secret value for the seed-key, XKEY.
-*           Step 2. In hexadecimal notation let
-*             t = 67452301 EFCDAB89 98BADCFE 10325476 C3D2E1F0.
-*             This is the initial value for H0 || H1 || H2 || H3 || H4 in the SHS.
-*           Step 3. For j = 0 to m - 1 do
-*             a. XSEEDj = optional user input.
-*             b. XVAL = (XKEY + XSEEDj) mod 2^b
-*             c. xj = G(t,XVAL) mod q
-*             d. XKEY = (1 + XKEY + xj) mod 2^b
+* \brief  Pseudo Random Number Generator (PRNG) implementation: AES-128 CTR_DRBG
+*         without derivation function, according to NIST SP 800-90A
+*
+*         The DRBG is instantiated on the first request (unless seeded with
+*         RNG_SetPseudoRandomNoSeed()) and reseeded every mPRNG_ReseedInterval_c
+*         requests, with entropy read by RNG_HwGetRandomNo(). If no entropy is
+*         available, the XSEED is used as seed instead.
 *
 * \param[out]    pOut - pointer to the output buffer
-* \param[in]     outBytes - the number of bytes to be copyed (1-20)
-* \param[in]     pXSEED - optional user SEED. Should be NULL if not used.
+* \param[in]     outBytes - the number of bytes to be generated (0-255)
+* \param[in]     pXSEED - optional user SEED (20 bytes), used as additional input.
+*                         Should be NULL if not used.
 *
-* \return  The number of bytes copied or -1 if reseed is needed
+* \return  The number of bytes generated or -1 if reseed is needed
 *
 ********************************************************************************** */
 int16_t RNG_GetPseudoRandomNo(uint8_t* pOut, uint8_t outBytes, uint8_t* pXSEED)
 {
-    uint32_t i;
-    sha1Context_t ctx;
+    uint32_t entropy[mPRNG_SeedLen_c/sizeof(uint32_t)];
+    uint8_t  additionalInput[mPRNG_SeedLen_c];
+    uint8_t* pAdditionalInput = NULL;
+    uint8_t* pEntropy = NULL;
+    int16_t  result = outBytes;
 
-    if(pXSEED)
+    if( pXSEED )
     {
-        mPRNG_Requests = 1;
+        FLib_MemCpy(additionalInput, pXSEED, mPRNG_NoOfBytes_c);
+        FLib_MemSet(&additionalInput[mPRNG_NoOfBytes_c], 0, mPRNG_SeedLen_c - mPRNG_NoOfBytes_c);
+        pAdditionalInput = additionalInput;
     }
 
-    if (mPRNG_Requests == gRngMaxRequests_d)
-    {
-        outBytes = -1;
-    }
-    else
+    if( (0 == mPRNG_Requests) || (mPRNG_Requests > mPRNG_ReseedInterval_c) )
     {
-        mPRNG_Requests++;
-        
-        /* a. XSEEDj = optional user input. */
-        if (pXSEED)
+        if( gRngSuccess_d == RNG_DrbgGetEntropy(entropy) )
         {
-            /* b. XVAL = (XKEY + XSEEDj) mod 2^b */
-            for (i=0; i<mPRNG_NoOfBytes_c; i++)
-            {
-                ctx.buffer[i] = ((uint8_t*)XKEY)[i] + pXSEED[i];
-            }
+            pEntropy = (uint8_t*)entropy;
         }
-        else
+        else if( pAdditionalInput )
         {
-            for (i=0; i<mPRNG_NoOfBytes_c; i++)
-            {
-                ctx.buffer[i] = ((uint8_t*)XKEY)[i];
-            }
+            /* No entropy source: the XSEED restarts the generator */
+            pEntropy = pAdditionalInput;
+            pAdditionalInput = NULL;
         }
-        
-        /* c. xj = G(t,XVAL) mod q
-        ***************************/
-        SHA1_Hash(&ctx, ctx.buffer, mPRNG_NoOfBytes_c);
-        
-        /* d. XKEY = (1 + XKEY + xj) mod 2^b */
-        XKEY[0] += 1;
-        for (i=0; i<mPRNG_NoOfLongWords_c; i++)
-        {
-            XKEY[i] += ctx.hash[i];
-        }
-        
-        /* Check if the length provided exceeds the output data size */
-        if (outBytes > mPRNG_NoOfBytes_c)
+
+        if( NULL == pEntropy )
         {
-            outBytes = mPRNG_NoOfBytes_c;
+            result = -1;
         }
-        
-        /* Copy the generated number */
-        for (i=0; i < outBytes; i++)
+        else
         {
-            pOut[i] = ((uint8_t*)ctx.hash)[i];
+            if( 0 == mPRNG_Requests )
+            {
+                RNG_DrbgInstantiate(pEntropy, pAdditionalInput);
+            }
+            else
+            {
+                RNG_DrbgReseed(pEntropy, pAdditionalInput);
+            }
+
+            /* The additional input was used by the reseed */
+            pAdditionalInput = NULL;
+            FLib_MemSet(entropy, 0, sizeof(entropy));
         }
     }
 
-    return outBytes;
+    if( result > 0 )
+    {
+        RNG_DrbgGenerate(pOut, outBytes, pAdditionalInput);
+    }
+
+    if( pXSEED )
+    {
+        FLib_MemSet(additionalInput, 0, sizeof(additionalInput));
+    }
+
+    return result;
 }
 
 
@@ -383,4 +397,173 @@ static void TRNG_ISR(void)
 }
 #endif
 
+/*! *********************************************************************************
+* \brief  Reads seedlen bits of entropy from the HW RNG (or from the PHY)
+*
+* \param[out]    pEntropy - pointer to the entropy buffer (32 bytes)
+*
+* \return  status of the RNG module
+*
+********************************************************************************** */
+static uint8_t RNG_DrbgGetEntropy(uint32_t* pEntropy)
+{
+    uint8_t status = gRngSuccess_d;
+    uint32_t i;
+
+    for( i = 0; (i < mPRNG_SeedLen_c/sizeof(uint32_t)) && (gRngSuccess_d == status); i++ )
+    {
+        status = RNG_HwGetRandomNo(&pEntropy[i]);
+    }
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  Increments V (big endian, modulo 2^128) and stores the successive values
+*         as counter blocks
+*
+* \param[out]    pBlocks - pointer to the counter blocks
+* \param[in]     numBlocks - the number of counter blocks
+*
+********************************************************************************** */
+static void RNG_DrbgCounterBlocks(uint8_t* pBlocks, uint32_t numBlocks)
+{
+    uint32_t i;
+
+    while( numBlocks-- )
+    {
+        i = AES_BLOCK_SIZE;
+        do
+        {
+            i--;
+        } while( (0 == ++mPRNG_V[i]) && (i > 0) );
+
+        FLib_MemCpy(pBlocks, mPRNG_V, AES_BLOCK_SIZE);
+        pBlocks += AES_BLOCK_SIZE;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  CTR_DRBG_Update: derives a new Key and V from the current state and the
+*         provided data. The new Key is expanded here, once for all the blocks
+*         generated until the next update.
+*
+* \param[in]     pProvidedData - pointer to the provided data (32 bytes).
+*                                NULL for a string of zeros.
+*
+********************************************************************************** */
+static void RNG_DrbgUpdate(const uint8_t* pProvidedData)
+{
+    uint32_t counter[mPRNG_SeedLen_c/sizeof(uint32_t)];
+    uint8_t  temp[mPRNG_SeedLen_c];
+    uint32_t i;
+
+    RNG_DrbgCounterBlocks((uint8_t*)counter, mPRNG_SeedLen_c/AES_BLOCK_SIZE);
+    AES_128_CtxECB_Encrypt(&mPRNG_Key, (uint8_t*)counter, mPRNG_SeedLen_c/AES_BLOCK_SIZE, temp);
+
+    if( pProvidedData )
+    {
+        for( i = 0; i < mPRNG_SeedLen_c; i++ )
+        {
+            temp[i] ^= pProvidedData[i];
+        }
+    }
+
+    AES_128_CtxInit(&mPRNG_Key, temp);
+    FLib_MemCpy(mPRNG_V, &temp[AES_BLOCK_SIZE], AES_BLOCK_SIZE);
+    FLib_MemSet(temp, 0, sizeof(temp));
+}
+
+/*! *********************************************************************************
+* \brief  CTR_DRBG_Instantiate_algorithm
+*
+* \param[in]     pEntropy - pointer to the entropy input (32 bytes)
+* \param[in]     pPersonalization - pointer to the personalization string (32 bytes).
+*                                   Should be NULL if not used.
+*
+********************************************************************************** */
+static void RNG_DrbgInstantiate(const uint8_t* pEntropy, const uint8_t* pPersonalization)
+{
+    uint8_t key[AES_BLOCK_SIZE];
+
+    FLib_MemSet(key, 0, sizeof(key));
+    FLib_MemSet(mPRNG_V, 0, sizeof(mPRNG_V));
+    AES_128_CtxInit(&mPRNG_Key, key);
+    RNG_DrbgReseed(pEntropy, pPersonalization);
+}
+
+/*! *********************************************************************************
+* \brief  CTR_DRBG_Reseed_algorithm
+*
+* \param[in]     pEntropy - pointer to the entropy input (32 bytes)
+* \param[in]     pAdditionalInput - pointer to the additional input (32 bytes).
+*                                   Should be NULL if not used.
+*
+********************************************************************************** */
+static void RNG_DrbgReseed(const uint8_t* pEntropy, const uint8_t* pAdditionalInput)
+{
+    uint8_t  seedMaterial[mPRNG_SeedLen_c];
+    uint32_t i;
+
+    for( i = 0; i < mPRNG_SeedLen_c; i++ )
+    {
+        seedMaterial[i] = pEntropy[i];
+
+        if( pAdditionalInput )
+        {
+            seedMaterial[i] ^= pAdditionalInput[i];
+        }
+    }
+
+    RNG_DrbgUpdate(seedMaterial);
+    FLib_MemSet(seedMaterial, 0, sizeof(seedMaterial));
+    mPRNG_Requests = 1;
+}
+
+/*! *********************************************************************************
+* \brief  CTR_DRBG_Generate_algorithm. The output is ciphered mPRNG_NoOfBlocks_c
+*         counter blocks at a time, any length is generated by one request.
+*
+* \param[out]    pOut - pointer to the output buffer
+* \param[in]     outBytes - the number of bytes to be generated
+* \param[in]     pAdditionalInput - pointer to the additional input (32 bytes).
+*                                   Should be NULL if not used.
+*
+********************************************************************************** */
+static void RNG_DrbgGenerate(uint8_t* pOut, uint32_t outBytes, const uint8_t* pAdditionalInput)
+{
+    uint32_t counter[mPRNG_NoOfBlocks_c*AES_BLOCK_SIZE/sizeof(uint32_t)];
+    uint8_t  keyStream[mPRNG_NoOfBlocks_c*AES_BLOCK_SIZE];
+    uint32_t numBlocks;
+    uint32_t numBytes;
+
+    if( pAdditionalInput )
+    {
+        RNG_DrbgUpdate(pAdditionalInput);
+    }
+
+    while( outBytes )
+    {
+        numBlocks = (outBytes + AES_BLOCK_SIZE - 1)/AES_BLOCK_SIZE;
+
+        if( numBlocks > mPRNG_NoOfBlocks_c )
+        {
+            numBlocks = mPRNG_NoOfBlocks_c;
+        }
+
+        numBytes = (outBytes < sizeof(keyStream)) ? outBytes : sizeof(keyStream);
+
+        RNG_DrbgCounterBlocks((uint8_t*)counter, numBlocks);
+        AES_128_CtxECB_Encrypt(&mPRNG_Key, (uint8_t*)counter, numBlocks, keyStream);
+        FLib_MemCpy(pOut, keyStream, numBytes);
+
+        pOut += numBytes;
+        outBytes -= numBytes;
+    }
+
+    FLib_MemSet(keyStream, 0, sizeof(keyStream));
+    RNG_DrbgUpdate(pAdditionalInput);
+    mPRNG_Requests++;
+}
+
 /********************************** EOF ***************************************/
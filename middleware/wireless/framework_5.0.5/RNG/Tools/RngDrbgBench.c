@@ -0,0 +1,982 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file RngDrbgBench.c
+* Host known answer tests and benchmark of the RNG pseudo-random number generator.
+*
+* RNG.c is built for an RNGA device, with SecLib.c (MMCAU enabled, or the software
+* AES and SHA1 when FSL_FEATURE_SOC_MMCAU_COUNT is 0), the RTOS mutex and the low
+* power votes enabled. The RNGA is played by a stub which serves the entropy words
+* set by the tool, or fails. The MMCAU and sw_Aes128() are played by a reference
+* AES-128 which counts the key expansions and the blocks, and the SHA1 hardware by a
+* reference SHA1 compression function which counts its calls. The tool reseeds the
+* DRBG every mBenchReseedInterval_c requests instead of gRngMaxRequests_d.
+*
+* check: the AES-128 CTR_DRBG (no derivation function) of RNG.c is run on CAVP
+*   vectors in the layout of the CAVP .rsp files (instantiate, optional reseed, two
+*   generates of 512 bits, the second output is checked). The first two vectors are
+*   COUNT 0 of the no reseed and of the reseed AES-128 no df files, the others were
+*   computed by an independent implementation, with personalization strings and
+*   additional inputs. The same vector is then run through RNG_GetPseudoRandomNo()
+*   with the entropy served by the RNGA, then a 255-byte request with an XSEED, the
+*   automatic reseed when the reseed interval is reached, and the -1 result when no
+*   entropy is available.
+* bench: requests of 16 to 255 bytes are served by RNG_GetPseudoRandomNo() and by the
+*   FIPS 186-2 SHA1 PRNG that it replaces (at most 20 bytes per call, so the request
+*   is served by several calls). The calls, SHA1 compressions, AES blocks, AES key
+*   expansions and lock acquisitions are printed per request. When the cycles of an
+*   AES block, an AES key expansion and a SHA1 compression measured on the target are
+*   given, the cycles per request and the bytes per cycle are printed as well.
+*
+* Build (the device and low power directories are only needed for the include paths,
+* the tool defines the include guards of their headers):
+*   gcc -O2 -std=c99 -Wno-pointer-to-int-cast -I../Interface -I../../SecLib
+*       -I../../Common -I../../FunctionLib -I../../MemManager/Interface
+*       -I../../OSAbstraction/Interface -I../../Panic/Interface -I../../Lists
+*       -I../../LowPower/Interface/KW2xD -I../../../../mmcau_2.0.0
+*       -I../../../../../devices/MKW24D5 -I../../../../../devices/MKW24D5/drivers
+*       -o RngDrbgBench RngDrbgBench.c ../../FunctionLib/FunctionLib.c
+*   add -DFSL_FEATURE_SOC_MMCAU_COUNT=0 to build the software AES and SHA1 path
+* Usage: RngDrbgBench [check|bench [requests [aesBlockCycles aesKeyCycles sha1Cycles]]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifndef FSL_FEATURE_SOC_MMCAU_COUNT
+#define FSL_FEATURE_SOC_MMCAU_COUNT     1
+#endif
+#define FSL_FEATURE_SOC_LTC_COUNT       0
+#define FSL_FEATURE_SOC_RNG_COUNT       1
+#define FSL_FEATURE_SOC_TRNG_COUNT      0
+#define FSL_RTOS_FREE_RTOS
+#define gSecLibUseMutex_c               1
+#define cPWR_UsePowerDownMode           1
+#define mDbgRevertKeys_d                0
+
+#define mBenchReseedInterval_c          (16)
+#define mPRNG_ReseedInterval_c          mBenchReseedInterval_c
+
+/* Skip the device, driver and low power headers */
+#define __FSL_DEVICE_REGISTERS_H__
+#define _FSL_COMMON_H_
+#define _FSL_RNGA_H_
+#define _PWR_INTERFACE_H_
+
+typedef int32_t status_t;
+#define kStatus_Success                 (0)
+#define kStatus_Fail                    (1)
+
+typedef struct
+{
+    uint32_t SR;
+} RNG_Type;
+
+extern RNG_Type mBenchRnga;
+#define RNG                             (&mBenchRnga)
+
+void RNGA_Init(RNG_Type *base);
+status_t RNGA_GetRandomData(RNG_Type *base, void *data, size_t data_size);
+void PWR_AllowDeviceToSleep(void);
+void PWR_DisallowDeviceToSleep(void);
+
+static void* BenchAlloc(uint32_t numBytes);
+#define MEM_BufferAlloc(numBytes)       BenchAlloc(numBytes)
+
+#include "../../SecLib/SecLib.c"
+#include "../Source/RNG.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultRequests_c     (1000)
+#define mBenchReturnedBytes_c       (64)
+
+#define mBenchRotl_m(x, n)          (((x) << (n)) | ((x) >> (32 - (n))))
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef struct benchCounters_tag
+{
+    uint32_t calls;
+    uint32_t compressions;
+    uint32_t expansions;
+    uint32_t blocks;
+    uint32_t locks;
+} benchCounters_t;
+
+/* CAVP CTR_DRBG vector, AES-128 no df, PredictionResistance = False */
+typedef struct benchDrbgVector_tag
+{
+    const char *pEntropyInput;
+    const char *pPersonalizationString;     /* NULL if not used */
+    const char *pEntropyInputReseed;        /* NULL: no reseed */
+    const char *pAdditionalInputReseed;     /* NULL if not used */
+    const char *pAdditionalInput[2];        /* NULL if not used */
+    const char *pReturnedBits;              /* mBenchReturnedBytes_c bytes */
+} benchDrbgVector_t;
+
+typedef int16_t (*benchPrng_t)(uint8_t *pOut, uint8_t outBytes);
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static const uint8_t mSbox[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+static const uint32_t mSha1Iv[5] =
+{
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+};
+
+static const benchDrbgVector_t mDrbgVectors[] =
+{
+    /* CTR_DRBG no reseed, AES-128 no df, COUNT = 0 */
+    {"ce50f33da5d4c1d3d4004eb35244b7f2cd7f2e5076fbf6780a7ff634b249a5fc",
+     NULL,
+     NULL,
+     NULL,
+     {NULL,
+      NULL},
+     "6545c0529d372443b392ceb3ae3a99a30f963eaf313280f1d1a1e87f9db373d3"
+     "61e75d18018266499cccd64d9bbb8de0185f213383080faddec46bae1f784e5a"},
+    /* CTR_DRBG with reseed, AES-128 no df, COUNT = 0 */
+    {"ed1e7f21ef66ea5d8e2a85b9337245445b71d6393a4eecb0e63c193d0f72f9a9",
+     NULL,
+     "303fb519f0a4e17d6df0b6426aa0ecb2a36079bd48be47ad2a8dbfe48da3efad",
+     NULL,
+     {NULL,
+      NULL},
+     "f80111d08e874672f32f42997133a5210f7a9375e22cea70587f9cfafebe0f6a"
+     "6aa2eb68e7dd9164536d53fa020fcab20f54caddfab7d6d91e5ffec1dfd8deaa"},
+    {"875016678c8ed5032b194df0efe415d581438ac39d52ed67f78962407f956a0e",
+     "9b3f8befcac13f0564ae4d6e196288fe2b8018ff63d3e7d490d0043d4c8bace8",
+     NULL,
+     NULL,
+     {"53d77210708e51e6c7a86a923c7d003d4b7f5459cecc433e3004b32f709fb3d7",
+      "a8fb21ce1330d972cfdd4f3ab257db7417b681d190b992927262bb5316926cce"},
+     "569c19f70f91a113302fd06c31e0cbc53159f3444be71f9b6cee1641f6b5dfef"
+     "0a076b50718de77c8d8ef045b1e4fa665029c0c401e78072f638cfd3300f6227"},
+    {"ff88e597fb7ee03ca4de3d044a505c2004bdcf2ffcb74cec2dde5eed1bd7b205",
+     "001528858ad2e8e556bbd40df46a6132608fab74e66b0123497ab9f0d5ec5326",
+     NULL,
+     NULL,
+     {"77a7f953cee0e44047b8623e3893a753caabe23fac0e61ee8cc91ea406133891",
+      "354c4e6282eccc27d07156328a8c3e04bf7f59e7a1dfb276daed70b14cae484b"},
+     "6b1d92e3d99740f86f418f93c4a8984d05bd35f816b76f8b943e6dd565c02076"
+     "27aac3382d1db883a30158ac91181348b1db855bc6270426705a19fd49bb8bb9"},
+    {"60b1f8c79232ae47e77892f37ef2bd7fa8457fdebbb9980ffeb1e2633979e0d1",
+     NULL,
+     "3b15717ac41d48124a22fb7d6094ac666233d9b3075ba6065a03c14b250f363a",
+     NULL,
+     {NULL,
+      NULL},
+     "19cc1cf2576dd87d41965338d901dc1d6674a206bd832acba0e9c2fc5b1839a4"
+     "2732c09b25854193a56b3bdb3cb76bf0535669a67c52beef7e43ae1cd90ca6c5"},
+    {"2a4a70d8cf93e8e579e579867562697c78b50aeea1430f81a4e1d7b6b0aea905",
+     NULL,
+     "624cd7663928c7b32ced987629f2c339e2b54f9b956954f9c185d895daaa9577",
+     NULL,
+     {NULL,
+      NULL},
+     "4a64129ade134b4f1ee0c4fcab4d55fb8d146a457a2f3593809fc617eec54653"
+     "87db3bbf768a83df0d8878d8f9a510b84f1d480752301730bd12093e5f8ae90e"},
+    {"60f9681f31022c87ac8948459d469c1856439b2d577ba43ecd33e0d38472963a",
+     "8ddd19eb3c9831d97c50b17b3360389f27fbaf3f2eb2679428c9af82c6cecdf1",
+     "df60d33a410ad76b66f4182e99b012e76ef3091e744bb584190c1b7c9a3e9d14",
+     "5860634cf81a1baa34b24b06661adbd07b8e1ea226f62c97036745167fbd96b4",
+     {"508aa5f1e999bb311c9a485241174db1281b7e6976ceece1689a087a41f4b5a5",
+      "ae8a7dcb7ab9a20c56843dd79319428ab897e8268d2759abe69bbaad226fcda3"},
+     "da9ebcd9093a48c988983c4010ae76a1d76284090b38707512c9cae76d86753a"
+     "15a43842fb5524a5605660569a7a4faeef5df596f249fb275094538e120f058b"},
+    {"3fd17c8c255e91396697c7ae1965d3a43849038122ba0c7a5b3440d4b80d3b89",
+     "f1a920da0399322c8785bddac17e69615b4099e6fc90c30c92e854cd4c7600e8",
+     "2901fa6122a40c27d219a4d47076214a18cfe15409427ee7572c10b2b49a7f69",
+     "b5a903f8de57c45330b94ffe7e5cba9afc5ad81554d91b1059e6b6c1d7b755c8",
+     {"8b6b924cc3a7959ea214011ff9fad7c07ea4550ed0b6fc2f2ed3e872a475ef06",
+      "fd9b5ce28689fcfae7dd680e2f04533d028669101ee605c9a71a7109f9e4338a"},
+     "d42c5f60fa05705d3cdf645ee671d3e713050a4cf5b837abd2b533ecb26e723f"
+     "5fc51db5e03a6b6dd09cf60c7cc07e5f98dc9385924f51b36329b1751eb7474e"},
+};
+
+/* RNG_SetPseudoRandomNoSeed(00..13), then 255 bytes with the XSEED a0..b3 and 20 bytes */
+static const char mApiOutput[] =
+    "b5d609841eadaf96fc4e9f2b897e999365d5c681e5b4322d01c598089661ff46"
+    "08d5ef841e72cb779946b60c2fe140f29daafa9155271a99378147b967df4a10"
+    "a5d38c7232940f74a68666fe39c3d305091ff4ac8327751bd17b029c40dc43f2"
+    "132b1df085efb1b4fa0444463b79d4c97dabbd41cb5e3a8721f450fa39c618f4"
+    "49a156305627342a5c7c07526f614cd8e9c3e526734cd7fcf41fd503183a3b03"
+    "ab4be48650895edb4a1ef250c20bef6df8e4ade5a58ca5e6509b309284e27818"
+    "12efc83da669c8714e14ffd95ef0b29b4778dc85f113652475bb99c7f63d525d"
+    "aa089c213ae42e38d200f9ed637773224b05d90af903ce6829e537cfd76516"
+    "e88ab51e80f8ae33d32a05b970a0633408d78461";
+
+static const uint8_t mBenchSizes[] = {16, 20, 32, 64, 128, 255};
+
+static benchCounters_t mCnt;
+static uint32_t mLockHeld;
+static uint32_t mSleepVotes;
+static uint32_t mBuffers;
+static uint32_t mFailures;
+static uint32_t mRandState = 0x2545F491;
+
+/* RNGA stub: entropy words served in order, then random words; or failures */
+static uint8_t  mEntropy[32];
+static uint32_t mEntropyUsed = sizeof(mEntropy);
+static uint32_t mEntropyReads;
+static bool_t   mEntropyFail;
+
+/* FIPS 186-2 PRNG state, as in RNG.c before the CTR_DRBG */
+static uint32_t mBenchXKEY[5];
+static uint32_t mBenchRequests;
+
+RNG_Type mBenchRnga;
+
+const uint32_t gEcP256_MultiplicationBufferSize_c = 1;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    /* xorshift32 */
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 17;
+    mRandState ^= mRandState << 5;
+    return mRandState;
+}
+
+static void BenchFail(const char *pWhat, uint32_t value)
+{
+    if( mFailures < 20 )
+    {
+        printf("FAIL: %s (%u)\n", pWhat, value);
+    }
+    mFailures++;
+}
+
+void RNGA_Init(RNG_Type *base)
+{
+    (void)base;
+}
+
+status_t RNGA_GetRandomData(RNG_Type *base, void *data, size_t data_size)
+{
+    uint32_t n;
+
+    if( (base != &mBenchRnga) || (data_size != sizeof(uint32_t)) )
+    {
+        BenchFail("RNGA_GetRandomData() parameters", (uint32_t)data_size);
+    }
+    if( mEntropyFail )
+    {
+        return kStatus_Fail;
+    }
+
+    mEntropyReads++;
+    if( mEntropyUsed < sizeof(mEntropy) )
+    {
+        memcpy(data, &mEntropy[mEntropyUsed], sizeof(uint32_t));
+        mEntropyUsed += sizeof(uint32_t);
+    }
+    else
+    {
+        n = BenchRand();
+        memcpy(data, &n, sizeof(uint32_t));
+    }
+    return kStatus_Success;
+}
+
+uint32_t SecLib_set_rng_seed(uint32_t seed)
+{
+    return seed;
+}
+
+uint32_t SecLib_get_random(void)
+{
+    return BenchRand();
+}
+
+/*! *********************************************************************************
+* \brief  Reference AES-128 encryption, used as the MMCAU and as the software AES.
+********************************************************************************** */
+static uint8_t BenchXtime(uint8_t a)
+{
+    return (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1B : 0));
+}
+
+static void BenchAesExpand(const uint8_t *pKey, uint8_t *w)
+{
+    uint8_t rcon = 1;
+    uint32_t i;
+
+    mCnt.expansions++;
+    memcpy(w, pKey, 16);
+    for( i = 16; i < 176; i += 4 )
+    {
+        uint8_t t[4] = {w[i-4], w[i-3], w[i-2], w[i-1]};
+
+        if( (i % 16) == 0 )
+        {
+            uint8_t t0 = t[0];
+
+            t[0] = mSbox[t[1]] ^ rcon;
+            t[1] = mSbox[t[2]];
+            t[2] = mSbox[t[3]];
+            t[3] = mSbox[t0];
+            rcon = BenchXtime(rcon);
+        }
+        w[i]   = w[i-16] ^ t[0];
+        w[i+1] = w[i-15] ^ t[1];
+        w[i+2] = w[i-14] ^ t[2];
+        w[i+3] = w[i-13] ^ t[3];
+    }
+}
+
+static void BenchAesEncrypt(const uint8_t *pIn, const uint8_t *w, uint8_t *pOut)
+{
+    uint8_t s[16];
+    uint8_t t[16];
+    int round;
+    int i;
+    int c;
+
+    mCnt.blocks++;
+    for( i = 0; i < 16; i++ )
+    {
+        s[i] = pIn[i] ^ w[i];
+    }
+
+    for( round = 1; round <= 10; round++ )
+    {
+        /* SubBytes and ShiftRows */
+        for( i = 0; i < 16; i++ )
+        {
+            t[i] = mSbox[s[(i + 4 * (i % 4)) % 16]];
+        }
+        /* MixColumns */
+        for( c = 0; c < 4 && round < 10; c++ )
+        {
+            uint8_t *col = &t[4 * c];
+            uint8_t a = col[0] ^ col[1] ^ col[2] ^ col[3];
+            uint8_t a0 = col[0];
+
+            col[0] ^= a ^ BenchXtime(col[0] ^ col[1]);
+            col[1] ^= a ^ BenchXtime(col[1] ^ col[2]);
+            col[2] ^= a ^ BenchXtime(col[2] ^ col[3]);
+            col[3] ^= a ^ BenchXtime(col[3] ^ a0);
+        }
+        for( i = 0; i < 16; i++ )
+        {
+            s[i] = t[i] ^ w[16 * round + i];
+        }
+    }
+    memcpy(pOut, s, 16);
+}
+
+void mmcau_aes_set_key(const unsigned char *key, const int key_size, unsigned char *key_sch)
+{
+    if( (key_size != AES128) || (((uintptr_t)key | (uintptr_t)key_sch) & 3) )
+    {
+        BenchFail("mmcau_aes_set_key() parameters", (uint32_t)key_size);
+    }
+    BenchAesExpand(key, key_sch);
+}
+
+void mmcau_aes_encrypt(const unsigned char *in, const unsigned char *key_sch, const int nr, unsigned char *out)
+{
+    if( (nr != AES128_ROUNDS) || (((uintptr_t)in | (uintptr_t)key_sch | (uintptr_t)out) & 3) )
+    {
+        BenchFail("mmcau_aes_encrypt() parameters", (uint32_t)nr);
+    }
+    BenchAesEncrypt(in, key_sch, out);
+}
+
+void sw_Aes128(const uint8_t *pData, const uint8_t *pKey, uint8_t enc, uint8_t *pReturnData)
+{
+    uint8_t w[176];
+
+    if( !enc )
+    {
+        BenchFail("sw_Aes128() decryption", 0);
+    }
+    BenchAesExpand(pKey, w);
+    BenchAesEncrypt(pData, w, pReturnData);
+}
+
+/*! *********************************************************************************
+* \brief  Reference SHA1 compression function, used as the MMCAU and as the
+*         software SHA1. The state is kept in native words, as by the MMCAU.
+********************************************************************************** */
+static void BenchSha1Compress(const uint8_t *pBlock, uint32_t *pState)
+{
+    uint32_t w[80];
+    uint32_t s[5];
+    uint32_t f;
+    uint32_t t;
+    uint32_t i;
+
+    for( i = 0; i < 16; i++ )
+    {
+        w[i] = ((uint32_t)pBlock[4*i] << 24) | ((uint32_t)pBlock[4*i + 1] << 16) |
+               ((uint32_t)pBlock[4*i + 2] << 8) | pBlock[4*i + 3];
+    }
+    for( i = 16; i < 80; i++ )
+    {
+        w[i] = mBenchRotl_m(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    memcpy(s, pState, sizeof(s));
+    for( i = 0; i < 80; i++ )
+    {
+        if( i < 20 )
+        {
+            f = ((s[1] & s[2]) | (~s[1] & s[3])) + 0x5a827999;
+        }
+        else if( i < 40 )
+        {
+            f = (s[1] ^ s[2] ^ s[3]) + 0x6ed9eba1;
+        }
+        else if( i < 60 )
+        {
+            f = ((s[1] & s[2]) | (s[1] & s[3]) | (s[2] & s[3])) + 0x8f1bbcdc;
+        }
+        else
+        {
+            f = (s[1] ^ s[2] ^ s[3]) + 0xca62c1d6;
+        }
+        t = mBenchRotl_m(s[0], 5) + f + s[4] + w[i];
+        s[4] = s[3];
+        s[3] = s[2];
+        s[2] = mBenchRotl_m(s[1], 30);
+        s[1] = s[0];
+        s[0] = t;
+    }
+    for( i = 0; i < 5; i++ )
+    {
+        pState[i] += s[i];
+    }
+    mCnt.compressions++;
+}
+
+void mmcau_sha1_initialize_output(const unsigned int *sha1_state)
+{
+    memcpy((void*)sha1_state, mSha1Iv, sizeof(mSha1Iv));
+}
+
+void mmcau_sha1_hash_n(const unsigned char *msg_data, const int num_blks, unsigned int *sha1_state)
+{
+    int i;
+
+    for( i = 0; i < num_blks; i++ )
+    {
+        BenchSha1Compress(msg_data + 64 * i, (uint32_t*)sha1_state);
+    }
+}
+
+void sw_sha1_initialize_output(uint32_t *sha1_state)
+{
+    memcpy(sha1_state, mSha1Iv, sizeof(mSha1Iv));
+}
+
+void sw_sha1_hash_n(uint8_t *msg_data, int32_t num_blks, uint32_t *sha1_state)
+{
+    mmcau_sha1_hash_n(msg_data, num_blks, (unsigned int*)sha1_state);
+}
+
+/*! *********************************************************************************
+* \brief  The AES decryption, SHA256 and ECDH functions are not used by the tool.
+********************************************************************************** */
+void mmcau_aes_decrypt(const unsigned char *in, const unsigned char *key_sch, const int nr, unsigned char *out) { (void)in; (void)key_sch; (void)nr; memset(out, 0, 16); }
+uint8_t sw_AES128_CCM(uint8_t* pInput, uint16_t inputLen, uint8_t* pAuthData, uint16_t authDataLen,
+                      uint8_t* pNonce, uint8_t nonceSize, uint8_t* pKey, uint8_t* pOutput,
+                      uint8_t* pCbcMac, uint8_t macSize, uint32_t flags)
+{
+    (void)pInput; (void)inputLen; (void)pAuthData; (void)authDataLen; (void)pNonce; (void)nonceSize;
+    (void)pKey; (void)pOutput; (void)pCbcMac; (void)macSize; (void)flags;
+    return 1;
+}
+int mmcau_sha256_initialize_output(const unsigned int *output) { (void)output; return 0; }
+void mmcau_sha256_hash_n(const unsigned char *input, const int num_blks, unsigned int *output) { (void)input; (void)num_blks; (void)output; }
+void sw_sha256_initialize_output(uint32_t *sha256_state) { (void)sha256_state; }
+void sw_sha256_hash_n(uint8_t *msg_data, int32_t num_blks, uint32_t *sha256_state) { (void)msg_data; (void)num_blks; (void)sha256_state; }
+
+ecdhStatus_t Ecdh_GenerateNewKeys(ecdhPublicKey_t* pOutPublicKey, ecdhPrivateKey_t* pOutPrivateKey, void* pMultiplicationBuffer)
+{
+    (void)pOutPublicKey; (void)pOutPrivateKey; (void)pMultiplicationBuffer;
+    return gEcdhBadParameters_c;
+}
+
+ecdhStatus_t Ecdh_ComputeDhKey(ecdhPrivateKey_t* pPrivateKey, ecdhPublicKey_t* pPeerPublicKey, ecdhDhKey_t* pOutDhKey, void* pMultiplicationBuffer)
+{
+    (void)pPrivateKey; (void)pPeerPublicKey; (void)pOutDhKey; (void)pMultiplicationBuffer;
+    return gEcdhBadParameters_c;
+}
+
+/*! *********************************************************************************
+* \brief  The mutex counts the lock acquisitions; a lock taken twice would dead lock
+*         the non recursive RTOS mutex.
+********************************************************************************** */
+osaMutexId_t OSA_MutexCreate(void)
+{
+    return (osaMutexId_t)&mLockHeld;
+}
+
+osaStatus_t OSA_MutexLock(osaMutexId_t mutexId, uint32_t millisec)
+{
+    (void)millisec;
+    if( (mutexId != (osaMutexId_t)&mLockHeld) || mLockHeld )
+    {
+        BenchFail("mutex locked twice", mCnt.locks);
+    }
+    mLockHeld = 1;
+    mCnt.locks++;
+    return osaStatus_Success;
+}
+
+osaStatus_t OSA_MutexUnlock(osaMutexId_t mutexId)
+{
+    if( (mutexId != (osaMutexId_t)&mLockHeld) || !mLockHeld )
+    {
+        BenchFail("mutex not locked", mCnt.locks);
+    }
+    mLockHeld = 0;
+    return osaStatus_Success;
+}
+
+void PWR_DisallowDeviceToSleep(void)
+{
+    mSleepVotes++;
+}
+
+void PWR_AllowDeviceToSleep(void)
+{
+    if( 0 == mSleepVotes )
+    {
+        BenchFail("low power vote released twice", 0);
+    }
+    else
+    {
+        mSleepVotes--;
+    }
+}
+
+static void* BenchAlloc(uint32_t numBytes)
+{
+    mBuffers++;
+    return malloc(numBytes ? numBytes : 1);
+}
+
+memStatus_t MEM_BufferFree(void* buffer)
+{
+    mBuffers--;
+    free(buffer);
+    return MEM_SUCCESS_c;
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    (void)id; (void)location; (void)extra1; (void)extra2;
+    printf("FAIL: panic\n");
+    exit(1);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static void BenchExpect(const char *pWhat, const uint8_t *pGot, const uint8_t *pExpected, uint32_t len)
+{
+    if( memcmp(pGot, pExpected, len) )
+    {
+        BenchFail(pWhat, len);
+    }
+}
+
+static uint32_t BenchHex(const char *pHex, uint8_t *pOut)
+{
+    uint32_t len = 0;
+    unsigned int byte;
+
+    while( pHex && pHex[0] && pHex[1] && (1 == sscanf(pHex, "%2x", &byte)) )
+    {
+        pOut[len++] = (uint8_t)byte;
+        pHex += 2;
+    }
+    return len;
+}
+
+/* A CAVP field of seedlen bits, or NULL if the field is empty */
+static const uint8_t* BenchSeedField(const char *pHex, uint8_t *pBuffer)
+{
+    if( NULL == pHex )
+    {
+        return NULL;
+    }
+    if( mPRNG_SeedLen_c != BenchHex(pHex, pBuffer) )
+    {
+        BenchFail("vector field length", 0);
+    }
+    return pBuffer;
+}
+
+/*! *********************************************************************************
+* \brief  The CTR_DRBG on the CAVP vectors: instantiate, optional reseed, two
+*         generates, the second output is the ReturnedBits.
+********************************************************************************** */
+static void BenchKatDrbg(void)
+{
+    uint8_t entropy[mPRNG_SeedLen_c];
+    uint8_t input[mPRNG_SeedLen_c];
+    uint8_t expected[mBenchReturnedBytes_c];
+    uint8_t out[mBenchReturnedBytes_c];
+    uint32_t v;
+    uint32_t i;
+
+    for( v = 0; v < sizeof(mDrbgVectors)/sizeof(mDrbgVectors[0]); v++ )
+    {
+        const benchDrbgVector_t *pVector = &mDrbgVectors[v];
+
+        RNG_DrbgInstantiate(BenchSeedField(pVector->pEntropyInput, entropy),
+                            BenchSeedField(pVector->pPersonalizationString, input));
+        if( pVector->pEntropyInputReseed )
+        {
+            RNG_DrbgReseed(BenchSeedField(pVector->pEntropyInputReseed, entropy),
+                           BenchSeedField(pVector->pAdditionalInputReseed, input));
+        }
+        for( i = 0; i < 2; i++ )
+        {
+            RNG_DrbgGenerate(out, sizeof(out), BenchSeedField(pVector->pAdditionalInput[i], input));
+        }
+        if( sizeof(expected) != BenchHex(pVector->pReturnedBits, expected) )
+        {
+            BenchFail("ReturnedBits length", v);
+        }
+        BenchExpect("CTR_DRBG ReturnedBits", out, expected, sizeof(expected));
+        if( 3 != mPRNG_Requests )
+        {
+            BenchFail("CTR_DRBG reseed counter", mPRNG_Requests);
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  RNG_SetPseudoRandomNoSeed() and RNG_GetPseudoRandomNo(): instantiation from
+*         the RNGA, any request length, the reseed interval and the missing entropy.
+********************************************************************************** */
+static void BenchKatApi(void)
+{
+    uint8_t seed[20];
+    uint8_t xseed[20];
+    uint8_t expected[255 + 20];
+    uint8_t out[256];
+    uint32_t i;
+
+    /* The first request instantiates the DRBG with 256 bits from the RNGA */
+    mPRNG_Requests = 0;
+    (void)BenchHex(mDrbgVectors[0].pEntropyInput, mEntropy);
+    mEntropyUsed = 0;
+    mEntropyReads = 0;
+    if( (64 != RNG_GetPseudoRandomNo(out, 64, NULL)) ||
+        (64 != RNG_GetPseudoRandomNo(out, 64, NULL)) )
+    {
+        BenchFail("RNG_GetPseudoRandomNo() result", 64);
+    }
+    (void)BenchHex(mDrbgVectors[0].pReturnedBits, expected);
+    BenchExpect("instantiation from the RNGA", out, expected, 64);
+    if( 8 != mEntropyReads )
+    {
+        BenchFail("RNGA reads at instantiation", mEntropyReads);
+    }
+
+    /* A whole 255-byte request, with the XSEED as additional input */
+    for( i = 0; i < sizeof(seed); i++ )
+    {
+        seed[i] = (uint8_t)i;
+        xseed[i] = (uint8_t)(0xa0 + i);
+    }
+    RNG_SetPseudoRandomNoSeed(seed);
+    (void)BenchHex(mApiOutput, expected);
+    memset(&mCnt, 0, sizeof(mCnt));
+    out[255] = 0x5A;
+    if( 255 != RNG_GetPseudoRandomNo(out, 255, xseed) )
+    {
+        BenchFail("RNG_GetPseudoRandomNo() result", 255);
+    }
+    BenchExpect("255-byte request", out, expected, 255);
+    if( out[255] != 0x5A )
+    {
+        BenchFail("RNG_GetPseudoRandomNo() overflow", 255);
+    }
+    /* The software AES expands its key on each block */
+    if( (2 + 16 + 2 != mCnt.blocks) || (FSL_FEATURE_SOC_MMCAU_COUNT && (2 != mCnt.expansions)) )
+    {
+        BenchFail("AES blocks of a 255-byte request", mCnt.blocks);
+    }
+    if( 20 != RNG_GetPseudoRandomNo(out, 20, NULL) )
+    {
+        BenchFail("RNG_GetPseudoRandomNo() result", 20);
+    }
+    BenchExpect("request after the XSEED", out, &expected[255], 20);
+    if( 0 != RNG_GetPseudoRandomNo(out, 0, NULL) )
+    {
+        BenchFail("RNG_GetPseudoRandomNo() result", 0);
+    }
+
+    /* Reseed from the RNGA once the reseed interval is reached */
+    RNG_SetPseudoRandomNoSeed(seed);
+    mEntropyReads = 0;
+    for( i = 0; i < mBenchReseedInterval_c; i++ )
+    {
+        (void)RNG_GetPseudoRandomNo(out, 16, NULL);
+    }
+    if( (0 != mEntropyReads) || (mBenchReseedInterval_c + 1 != mPRNG_Requests) )
+    {
+        BenchFail("reseed before the interval", mEntropyReads);
+    }
+    if( 16 != RNG_GetPseudoRandomNo(out, 16, NULL) )
+    {
+        BenchFail("RNG_GetPseudoRandomNo() result at reseed", 16);
+    }
+    if( (8 != mEntropyReads) || (2 != mPRNG_Requests) )
+    {
+        BenchFail("reseed at the interval", mEntropyReads);
+    }
+
+    /* No entropy: -1 without XSEED, the XSEED reseeds the DRBG otherwise */
+    mEntropyFail = TRUE;
+    mPRNG_Requests = mBenchReseedInterval_c + 1;
+    if( -1 != RNG_GetPseudoRandomNo(out, 16, NULL) )
+    {
+        BenchFail("no entropy and no XSEED", 0);
+    }
+    if( (16 != RNG_GetPseudoRandomNo(out, 16, xseed)) || (2 != mPRNG_Requests) )
+    {
+        BenchFail("no entropy and an XSEED", mPRNG_Requests);
+    }
+    mPRNG_Requests = 0;
+    if( -1 != RNG_GetPseudoRandomNo(out, 16, NULL) )
+    {
+        BenchFail("not instantiated and no entropy", 0);
+    }
+    mEntropyFail = FALSE;
+}
+
+/*! *********************************************************************************
+* \brief  The FIPS 186-2 PRNG of RNG.c before the CTR_DRBG: one SHA1_Hash() and at
+*         most 20 bytes per call.
+********************************************************************************** */
+static int16_t BenchFips186Prng(uint8_t *pOut, uint8_t outBytes)
+{
+    sha1Context_t ctx;
+    uint32_t i;
+
+    if( mBenchRequests == gRngMaxRequests_d )
+    {
+        return -1;
+    }
+    mBenchRequests++;
+
+    for( i = 0; i < 20; i++ )
+    {
+        ctx.buffer[i] = ((uint8_t*)mBenchXKEY)[i];
+    }
+    SHA1_Hash(&ctx, ctx.buffer, 20);
+    mBenchXKEY[0] += 1;
+    for( i = 0; i < 5; i++ )
+    {
+        mBenchXKEY[i] += ctx.hash[i];
+    }
+    if( outBytes > 20 )
+    {
+        outBytes = 20;
+    }
+    memcpy(pOut, ctx.hash, outBytes);
+    return outBytes;
+}
+
+static int16_t BenchDrbgPrng(uint8_t *pOut, uint8_t outBytes)
+{
+    return RNG_GetPseudoRandomNo(pOut, outBytes, NULL);
+}
+
+static void BenchRun(benchPrng_t prng, uint8_t size, uint32_t requests, benchCounters_t *pCnt)
+{
+    uint8_t out[255];
+    uint32_t done;
+    uint32_t r;
+    int16_t n;
+
+    memset(&mCnt, 0, sizeof(mCnt));
+    for( r = 0; r < requests; r++ )
+    {
+        for( done = 0; done < size; done += (uint32_t)n )
+        {
+            n = prng(&out[done], (uint8_t)(size - done));
+            mCnt.calls++;
+            if( n <= 0 )
+            {
+                BenchFail("PRNG result", size);
+                return;
+            }
+        }
+    }
+    *pCnt = mCnt;
+}
+
+static void BenchPrint(const char *pName, uint8_t size, uint32_t requests, const benchCounters_t *pCnt,
+                       const double *pCycles)
+{
+    double cycles = pCnt->blocks * pCycles[0] + pCnt->expansions * pCycles[1] + pCnt->compressions * pCycles[2];
+
+    printf("%4u %-7s %7.2f %7.2f %7.2f %7.2f %7.2f", size, pName, (double)pCnt->calls / requests,
+           (double)pCnt->compressions / requests, (double)pCnt->blocks / requests,
+           (double)pCnt->expansions / requests, (double)pCnt->locks / requests);
+    if( cycles > 0 )
+    {
+        printf("  %9.0f %8.4f", cycles / requests, (double)size * requests / cycles);
+    }
+    printf("\n");
+}
+
+static void BenchPerf(uint32_t requests, const double *pCycles)
+{
+    benchCounters_t cnt[2];
+    uint8_t seed[20];
+    uint32_t i;
+
+    for( i = 0; i < sizeof(seed); i++ )
+    {
+        seed[i] = (uint8_t)BenchRand();
+        ((uint8_t*)mBenchXKEY)[i] = seed[i];
+    }
+    RNG_SetPseudoRandomNoSeed(seed);
+
+    printf("%u requests, %s AES and SHA1, reseed every %u requests\n", requests,
+           FSL_FEATURE_SOC_MMCAU_COUNT ? "MMCAU" : "software", mBenchReseedInterval_c);
+    printf("size PRNG      calls/r  sha1/r blocks/r expand/r  locks/r%s\n",
+           (pCycles[0] + pCycles[1] + pCycles[2] > 0) ? "   cycles/r  bytes/c" : "");
+    for( i = 0; i < sizeof(mBenchSizes); i++ )
+    {
+        memset(cnt, 0, sizeof(cnt));
+        mBenchRequests = 1;
+        BenchRun(BenchFips186Prng, mBenchSizes[i], requests, &cnt[0]);
+        BenchRun(BenchDrbgPrng, mBenchSizes[i], requests, &cnt[1]);
+        BenchPrint("FIPS186", mBenchSizes[i], requests, &cnt[0], pCycles);
+        BenchPrint("CTRDRBG", mBenchSizes[i], requests, &cnt[1], pCycles);
+    }
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char *argv[])
+{
+    const char *pMode = (argc > 1) ? argv[1] : "check";
+    uint32_t requests = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : mBenchDefaultRequests_c;
+    double cycles[3] = {0, 0, 0};
+    uint32_t i;
+
+    for( i = 0; (i < 3) && (argc > 3 + (int)i); i++ )
+    {
+        cycles[i] = strtod(argv[3 + i], NULL);
+    }
+    if( (0 == requests) || (argc > 6) )
+    {
+        printf("Usage: %s [check|bench [requests [aesBlockCycles aesKeyCycles sha1Cycles]]]\n", argv[0]);
+        return 2;
+    }
+
+    SecLib_Init();
+    if( gRngSuccess_d != RNG_Init() )
+    {
+        BenchFail("RNG_Init()", 0);
+    }
+
+    if( 0 == strcmp(pMode, "bench") )
+    {
+        BenchPerf(requests, cycles);
+    }
+    else
+    {
+        BenchKatDrbg();
+        BenchKatApi();
+    }
+
+    if( mLockHeld || mSleepVotes || mBuffers )
+    {
+        BenchFail("lock, low power vote or buffer left", mLockHeld + mSleepVotes + mBuffers);
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
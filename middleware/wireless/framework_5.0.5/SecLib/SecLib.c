@@ -102,6 +102,14 @@
     #define SECLIB_MUTEX_UNLOCK()
 #endif /* USE_RTOS */
 
+/* Key context of the operations taking a raw key. The hardware paths share one context
+   under the SecLib lock; the software AES, which has no lock, keeps it on the stack. */
+#if FSL_FEATURE_SOC_LTC_COUNT || FSL_FEATURE_SOC_MMCAU_COUNT
+    #define SECLIB_AES_CTX_DECLARE(pCtx) aesKeyCtx_t* const pCtx = &mSecLibAesCtx
+#else
+    #define SECLIB_AES_CTX_DECLARE(pCtx) aesKeyCtx_t pCtx##Buf; aesKeyCtx_t* const pCtx = &pCtx##Buf
+#endif
+
 
 /*! *********************************************************************************
 *************************************************************************************
@@ -114,17 +122,6 @@ typedef union _uuint128_tag
     uint64_t u64[2];
 } uuint128_t;
 
-#if FSL_FEATURE_SOC_MMCAU_COUNT
-typedef struct mmcauAesContext_tag{
-    uint8_t keyExpansion[44*4];
-    uint8_t alignedIn[AES_BLOCK_SIZE];
-    uint8_t alignedOut[AES_BLOCK_SIZE];
-}mmcauAesContext_t;
-
-/*! MMCAU AES Context Buffer for both AES Encrypt and Decrypt operations.*/
-mmcauAesContext_t mmcauAesCtx;
-#endif /* FSL_FEATURE_SOC_MMCAU_COUNT */
-
 #if USE_RTOS && (FSL_FEATURE_SOC_LTC_COUNT || FSL_FEATURE_SOC_MMCAU_COUNT)
 /*! Mutex used to protect the AES Context when an RTOS is used. */
 osaMutexId_t mSecLibMutexId;
@@ -137,6 +134,11 @@ osaMutexId_t mSecLibMutexId;
 *************************************************************************************
 ************************************************************************************/
 
+#if FSL_FEATURE_SOC_LTC_COUNT || FSL_FEATURE_SOC_MMCAU_COUNT
+/*! AES key context of the operations taking a raw key, protected by the SecLib lock. */
+static aesKeyCtx_t mSecLibAesCtx;
+#endif
+
 /*! *********************************************************************************
 *************************************************************************************
 * Public prototypes
@@ -186,15 +188,37 @@ ecdhStatus_t Ecdh_ComputeDhKey
 ********************************************************************************** */
 static void SHA1_hash_n(uint8_t* pData, uint32_t nBlk, uint32_t* pHash);
 static void SHA256_hash_n(uint8_t* pData, uint32_t nBlk, uint32_t* pHash);
-static void AES_128_CMAC_Generate_Subkey(uint8_t *key, uint8_t *K1, uint8_t *K2);
+static void SHA256_Resume(sha256Context_t* context, const uint32_t* pHash);
+static void AES_128_CMAC_Generate_Subkey(aesKeyCtx_t *pCtx, uint8_t *K1, uint8_t *K2);
+static void SecLib_AesKeyExpand(aesKeyCtx_t* pCtx, const uint8_t* pKey);
+static void SecLib_AesBlock(aesKeyCtx_t* pCtx, const uint8_t* pInput, uint8_t* pOutput, bool_t encrypt);
+static void SecLib_AesEcb(aesKeyCtx_t* pCtx, const uint8_t* pInput, uint32_t numBlocks, uint8_t* pOutput, bool_t encrypt);
+static void SecLib_AesCbcEncrypt(aesKeyCtx_t* pCtx, const uint8_t* pInput, uint32_t inputLen, uint8_t* pInitVector, uint8_t* pOutput);
+static void SecLib_AesCbcDecrypt(aesKeyCtx_t* pCtx, const uint8_t* pInput, uint32_t inputLen, uint8_t* pInitVector, uint8_t* pOutput);
+static void SecLib_AesCtr(aesKeyCtx_t* pCtx, const uint8_t* pInput, uint32_t inputLen, uint8_t* pCounter, uint8_t* pOutput);
+static void SecLib_AesOfb(aesKeyCtx_t* pCtx, const uint8_t* pInput, uint32_t inputLen, uint8_t* pInitVector, uint8_t* pOutput);
+static void SecLib_AesCmac(aesKeyCtx_t* pCtx, const uint8_t* pInput, uint32_t inputLen, bool_t lsbFirst, uint8_t* pOutput);
+static secResultType_t SecLib_AesEax(aesKeyCtx_t* pCtx, uint8_t* pInput, uint32_t inputLen,
+                                     uint8_t* pNonce, uint32_t nonceLen, uint8_t* pHeader, uint8_t headerLen,
+                                     uint8_t* pOutput, uint8_t* pTag, bool_t encrypt);
+static void SecLib_OmacStart(aesOmacState_t* pMac, uint8_t t);
+static void SecLib_OmacUpdate(aesKeyCtx_t* pKeyCtx, aesOmacState_t* pMac, const uint8_t* pData, uint32_t dataLen);
+static void SecLib_OmacFinish(aesKeyCtx_t* pKeyCtx, aesOmacState_t* pMac, uint8_t* K1, uint8_t* K2, uint8_t* pOutput);
+static void SecLib_EaxStart(aesEaxCtx_t* pCtx, aesKeyCtx_t* pKeyCtx, const uint8_t* pNonce, uint32_t nonceLen, bool_t encrypt);
+static void SecLib_EaxCrypt(aesEaxCtx_t* pCtx, const uint8_t* pInput, uint32_t inputLen, uint8_t* pOutput);
+static secResultType_t SecLib_EaxFinish(aesEaxCtx_t* pCtx, uint8_t* pTag);
+static secResultType_t SecLib_AesCcm(aesKeyCtx_t* pCtx, const uint8_t* pInput, uint32_t inputLen,
+                                     const uint8_t* pAuthData, uint32_t authDataLen, const uint8_t* pNonce, uint8_t nonceSize,
+                                     uint8_t* pOutput, uint8_t* pCbcMac, uint8_t macSize, bool_t encrypt);
+#if !(FSL_FEATURE_SOC_LTC_COUNT)
+static void SecLib_CcmMacUpdate(aesKeyCtx_t* pCtx, uint8_t* pMac, uint8_t* pBlock, uint8_t* pPos, const uint8_t* pData, uint32_t dataLen);
+static void SecLib_CcmMacPad(aesKeyCtx_t* pCtx, uint8_t* pMac, uint8_t* pBlock, uint8_t* pPos);
+#endif
 static void SecLib_LeftShiftOneBit(uint8_t *input, uint8_t *output);
 static void SecLib_Padding(uint8_t *lastb, uint8_t *pad, uint32_t length);
 static void SecLib_Xor128(uint8_t *a, uint8_t *b, uint8_t *out);
 
-#if FSL_FEATURE_SOC_LTC_COUNT 
-#else
 static void AES_128_IncrementCounter(uint8_t* ctr);
-#endif
 
 
 /*! *********************************************************************************
@@ -240,66 +264,13 @@ void AES_128_Encrypt(const uint8_t* pInput,
                      const uint8_t* pKey,
                      uint8_t* pOutput)
 {
-#if FSL_FEATURE_SOC_MMCAU_COUNT
-    mmcauAesContext_t *pCtx = &mmcauAesCtx;
-    uint8_t* pIn;
-    uint8_t* pOut;
-#endif
-    
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
     SecLib_DisallowToSleep();
     SECLIB_MUTEX_LOCK();
-    
-#if FSL_FEATURE_SOC_MMCAU_COUNT
-    /* Check if pKey is 4 bytes aligned */
-    if ((uint32_t)pKey & 0x00000003)
-    {
-        FLib_MemCpy(pCtx->alignedIn, (uint8_t*)pKey, AES_BLOCK_SIZE);
-        pIn = pCtx->alignedIn;
-    }
-    else
-    {
-        pIn = (uint8_t*)pKey;
-    }
-
-    /* Expand Key */
-    mmcau_aes_set_key(pIn, AES128, pCtx->keyExpansion);
-
-    /* Check if pData is 4 bytes aligned */
-    if ((uint32_t)pInput & 0x00000003)
-    {
-        FLib_MemCpy(pCtx->alignedIn, (uint8_t*)pInput, AES_BLOCK_SIZE);
-        pIn = pCtx->alignedIn;
-    }
-    else
-    {
-        pIn = (uint8_t*)pInput;
-    }
-
-    /* Check if pReturnData is 4 bytes aligned */
-    if ((uint32_t)pOutput & 0x00000003)
-    {
-        pOut = pCtx->alignedOut;
-    }
-    else
-    {
-        pOut = pOutput;
-    }
-
-    /* Encrypt data */
-    mmcau_aes_encrypt(pIn, pCtx->keyExpansion, AES128_ROUNDS, pOut);
-
-    if (pOut == pCtx->alignedOut)
-    {
-        FLib_MemCpy(pOutput, pCtx->alignedOut, AES_BLOCK_SIZE);
-    }
 
-#elif FSL_FEATURE_SOC_LTC_COUNT
-    LTC_AES_EncryptEcb(LTC0, pInput, pOutput, AES_BLOCK_SIZE, pKey, AES_BLOCK_SIZE);
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesBlock(pAesCtx, pInput, pOutput, TRUE);
 
-#else
-    sw_Aes128(pInput, pKey, 1, pOutput);
-#endif
-    
     SECLIB_MUTEX_UNLOCK();
     SecLib_AllowToSleep();
 }
@@ -320,64 +291,12 @@ void AES_128_Decrypt(const uint8_t* pInput,
                      const uint8_t* pKey,
                      uint8_t* pOutput)
 {
-#if FSL_FEATURE_SOC_MMCAU_COUNT
-    mmcauAesContext_t *pCtx = &mmcauAesCtx;
-    uint8_t* pIn;
-    uint8_t* pOut;
-#endif
-    
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
     SecLib_DisallowToSleep();
     SECLIB_MUTEX_LOCK();
 
-#if FSL_FEATURE_SOC_MMCAU_COUNT
-    /* Check if pKey is 4 bytes aligned */
-    if ((uint32_t)pKey & 0x00000003) 
-    {
-        FLib_MemCpy( pCtx->alignedIn, (uint8_t*)pKey, AES_BLOCK_SIZE);
-        pIn = pCtx->alignedIn;
-    }
-    else
-    {
-        pIn = (uint8_t*)pKey;
-    }
-
-    /* Expand Key */  
-    mmcau_aes_set_key(pIn, AES128, pCtx->keyExpansion);
-
-    /* Check if pData is 4 bytes aligned */
-    if ((uint32_t)pInput & 0x00000003) 
-    {
-        FLib_MemCpy( pCtx->alignedIn, (uint8_t*)pInput, AES_BLOCK_SIZE);
-        pIn = pCtx->alignedIn;
-    }
-    else
-    {
-        pIn = (uint8_t*)pInput;
-    }
-
-    /* Check if pReturnData is 4 bytes aligned */
-    if ((uint32_t)pOutput & 0x00000003)
-    {
-        pOut = pCtx->alignedOut;
-    }
-    else
-    {
-        pOut = pOutput;
-    }
-
-    /* Decrypt data */
-    mmcau_aes_decrypt(pIn, pCtx->keyExpansion, AES128_ROUNDS, pOut);
-
-    if (pOut == pCtx->alignedOut)
-    {
-        FLib_MemCpy( pOutput, pCtx->alignedOut, AES_BLOCK_SIZE);
-    }
-
-#elif FSL_FEATURE_SOC_LTC_COUNT
-    LTC_AES_DecryptEcb(LTC0, pInput, pOutput, AES_BLOCK_SIZE, pKey, AES_BLOCK_SIZE, kLTC_EncryptKey);
-#else 
-    sw_Aes128(pInput, pKey, 0, pOutput);
-#endif
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesBlock(pAesCtx, pInput, pOutput, FALSE);
 
     SECLIB_MUTEX_UNLOCK();
     SecLib_AllowToSleep();
@@ -402,22 +321,33 @@ void AES_128_ECB_Encrypt(uint8_t* pInput,
                          uint8_t* pKey,
                          uint8_t* pOutput)
 {
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
     uint8_t tempBuffIn[AES_BLOCK_SIZE] = {0};
     uint8_t tempBuffOut[AES_BLOCK_SIZE] = {0};
+    uint32_t numBlocks = 0;
 
-    /* If remaining data bigger than one AES block size */
-    while( inputLen > AES_BLOCK_SIZE )
+    /* All blocks but the last one are processed in place */
+    if( inputLen > AES_BLOCK_SIZE )
     {
-        AES_128_Encrypt(pInput, pKey, pOutput);
-        pInput += AES_BLOCK_SIZE;
-        pOutput += AES_BLOCK_SIZE;
-        inputLen -= AES_BLOCK_SIZE;
+        numBlocks = (inputLen - 1) / AES_BLOCK_SIZE;
     }
 
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesEcb(pAesCtx, pInput, numBlocks, pOutput, TRUE);
+    pInput += numBlocks * AES_BLOCK_SIZE;
+    pOutput += numBlocks * AES_BLOCK_SIZE;
+    inputLen -= numBlocks * AES_BLOCK_SIZE;
+
     /* If remaining data is smaller then one AES block size */
     FLib_MemCpy(tempBuffIn, pInput, inputLen);
-    AES_128_Encrypt(tempBuffIn, pKey, tempBuffOut);
+    SecLib_AesBlock(pAesCtx, tempBuffIn, tempBuffOut, TRUE);
     FLib_MemCpy(pOutput, tempBuffOut, inputLen);
+
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
 }
 
 /*! *********************************************************************************
@@ -439,13 +369,15 @@ void AES_128_ECB_Block_Encrypt(uint8_t* pInput,
                                const uint8_t* pKey,
                                uint8_t* pOutput)
 {
-    while( numBlocks )
-    {
-        AES_128_Encrypt(pInput, pKey, pOutput);
-        numBlocks--;
-        pInput += AES_BLOCK_SIZE;
-        pOutput += AES_BLOCK_SIZE;
-    }
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesEcb(pAesCtx, pInput, numBlocks, pOutput, TRUE);
+
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
 }
 
 /*! *********************************************************************************
@@ -468,39 +400,23 @@ void AES_128_CBC_Encrypt(uint8_t* pInput,
                          uint8_t* pKey,
                          uint8_t* pOutput)
 {
-#if FSL_FEATURE_SOC_LTC_COUNT
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
+    /* Chaining value kept between calls made without an initialization vector */
+    static uint8_t tempBuffIn[AES_BLOCK_SIZE] = {0};
+
     SecLib_DisallowToSleep();
     SECLIB_MUTEX_LOCK();
-    LTC_AES_EncryptCbc(LTC0, pInput, pOutput, inputLen, pInitVector, pKey, AES_BLOCK_SIZE);
-    SECLIB_MUTEX_UNLOCK();
-    SecLib_AllowToSleep();
-
-#else
-    static uint8_t tempBuffIn[AES_BLOCK_SIZE] = {0};
-    uint8_t tempBuffOut[AES_BLOCK_SIZE] = {0};
 
     if( pInitVector != NULL )
     {
         FLib_MemCpy(tempBuffIn, pInitVector, AES_BLOCK_SIZE);
     }
 
-    /* If remaining data is bigger than one AES block size */
-    while( inputLen > AES_BLOCK_SIZE )
-    {
-        SecLib_XorN(tempBuffIn, pInput, AES_BLOCK_SIZE);
-        AES_128_Encrypt(tempBuffIn, pKey, pOutput);
-        FLib_MemCpy(tempBuffIn, pOutput, AES_BLOCK_SIZE);
-        pInput += AES_BLOCK_SIZE;
-        pOutput += AES_BLOCK_SIZE;
-        inputLen -= AES_BLOCK_SIZE;
-    }
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesCbcEncrypt(pAesCtx, pInput, inputLen, tempBuffIn, pOutput);
 
-    /* If remaining data is smaller then one AES block size  */
-    SecLib_XorN(tempBuffIn, pInput, inputLen);
-    AES_128_Encrypt(tempBuffIn, pKey, tempBuffOut);
-    FLib_MemCpy(tempBuffIn, tempBuffOut, AES_BLOCK_SIZE);
-    FLib_MemCpy(pOutput, tempBuffOut, inputLen);
-#endif
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
 }
 
 /*! *********************************************************************************
@@ -529,6 +445,9 @@ uint32_t AES_128_CBC_Encrypt_And_Pad(uint8_t* pInput,
                          uint8_t* pKey, 
                          uint8_t* pOutput)
 {
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
+    /* Chaining value kept between calls made without an initialization vector */
+    static uint8_t tempBuffIn[AES_BLOCK_SIZE] = {0};
     uint32_t newLen = 0;
     uint8_t idx;
     /*compute new length*/
@@ -541,30 +460,20 @@ uint32_t AES_128_CBC_Encrypt_And_Pad(uint8_t* pInput,
     pInput[inputLen] = 0x80;
 
     /* CBC-Encrypt */
-#if FSL_FEATURE_SOC_LTC_COUNT
     SecLib_DisallowToSleep();
     SECLIB_MUTEX_LOCK();
-    LTC_AES_EncryptCbc(LTC0, pInput, pOutput, newLen, pInitVector, pKey, AES_BLOCK_SIZE);
-    SECLIB_MUTEX_UNLOCK();
-    SecLib_AllowToSleep();
-#else
-    static uint8_t tempBuffIn[AES_BLOCK_SIZE] = {0};
-    
+
     if( pInitVector != NULL )
     {
         FLib_MemCpy(tempBuffIn, pInitVector, AES_BLOCK_SIZE);
     }
-    inputLen = newLen;
-    while( inputLen > 0 )
-    {
-        SecLib_XorN(tempBuffIn, pInput, AES_BLOCK_SIZE);
-        AES_128_Encrypt(tempBuffIn, pKey, pOutput);
-        FLib_MemCpy(tempBuffIn, pOutput, AES_BLOCK_SIZE);
-        pInput += AES_BLOCK_SIZE;
-        pOutput += AES_BLOCK_SIZE;
-        inputLen -= AES_BLOCK_SIZE;
-    }
-#endif
+
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesCbcEncrypt(pAesCtx, pInput, newLen, tempBuffIn, pOutput);
+
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+
     return newLen;
 }
 /*! *********************************************************************************
@@ -589,48 +498,30 @@ uint32_t AES_128_CBC_Decrypt_And_Depad(uint8_t* pInput,
                                        uint8_t* pKey, 
                                        uint8_t* pOutput)
 {
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
+    /* Chaining value kept between calls made without an initialization vector */
+    static uint8_t temp[AES_BLOCK_SIZE] = {0};
     uint32_t newLen = inputLen;
-#if FSL_FEATURE_SOC_LTC_COUNT
-    SecLib_DisallowToSleep();
-    SECLIB_MUTEX_LOCK();
-    LTC_AES_DecryptCbc(LTC0, pInput, pOutput, inputLen, pInitVector, pKey, AES_BLOCK_SIZE, kLTC_DecryptKey);
-    SECLIB_MUTEX_UNLOCK();
-    SecLib_AllowToSleep();
 
-#else
-    static uint8_t temp[2*AES_BLOCK_SIZE] = {0};
-
-    if((inputLen & (AES_BLOCK_SIZE - 1)) != 0)
+    if((inputLen == 0) || ((inputLen & (AES_BLOCK_SIZE - 1)) != 0))
     {
         return 0;
     }
 
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+
     if(pInitVector != NULL)
     {
         FLib_MemCpy(temp, pInitVector, AES_BLOCK_SIZE);
     }
 
-    FLib_MemCpy(temp + AES_BLOCK_SIZE, pInput, AES_BLOCK_SIZE);
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesCbcDecrypt(pAesCtx, pInput, inputLen, temp, pOutput);
 
-    while( inputLen > 0 )
-    {
-        AES_128_Decrypt(pInput, pKey, pOutput);
-        
-        SecLib_XorN(pOutput, temp, AES_BLOCK_SIZE);
-        
-        pInput += AES_BLOCK_SIZE;
-        pOutput += AES_BLOCK_SIZE;
-        inputLen -= AES_BLOCK_SIZE;
-        
-        FLib_MemCpy(temp, temp + AES_BLOCK_SIZE, AES_BLOCK_SIZE);
-        if(inputLen > 0)
-        {
-            FLib_MemCpy(temp + AES_BLOCK_SIZE, pInput, AES_BLOCK_SIZE);
-        }
-    }
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
 
-    pOutput -= newLen;
-#endif
     while( (pOutput[--newLen] != 0x80) && (newLen !=0) ) {}
     return newLen;
 }
@@ -654,37 +545,15 @@ void AES_128_CTR(uint8_t* pInput,
                  uint8_t* pKey,
                  uint8_t* pOutput)
 {
-#if FSL_FEATURE_SOC_LTC_COUNT
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
     SecLib_DisallowToSleep();
     SECLIB_MUTEX_LOCK();
-    LTC_AES_EncryptCtr(LTC0, pInput, pOutput, inputLen, pCounter, pKey, AES_BLOCK_SIZE, NULL, NULL);
-    SECLIB_MUTEX_UNLOCK();
-    SecLib_AllowToSleep();
-
-#else
-    uint8_t tempBuffIn[AES_BLOCK_SIZE] = {0};
-    uint8_t encrCtr[AES_BLOCK_SIZE] = {0};
 
-    /* If remaining data bigger than one AES block size */
-    while( inputLen > AES_BLOCK_SIZE )
-    {
-        FLib_MemCpy(tempBuffIn, pInput, AES_BLOCK_SIZE);
-        AES_128_Encrypt(pCounter, pKey, encrCtr);
-        SecLib_XorN(tempBuffIn, encrCtr, AES_BLOCK_SIZE);
-        FLib_MemCpy(pOutput, tempBuffIn, AES_BLOCK_SIZE);
-        pInput += AES_BLOCK_SIZE;
-        pOutput += AES_BLOCK_SIZE;
-        inputLen -= AES_BLOCK_SIZE;
-        AES_128_IncrementCounter(pCounter);
-    }
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesCtr(pAesCtx, pInput, inputLen, pCounter, pOutput);
 
-    /* If remaining data is smaller then one AES block size  */
-    FLib_MemCpy(tempBuffIn, pInput, inputLen);
-    AES_128_Encrypt(pCounter, pKey, encrCtr);
-    SecLib_XorN(tempBuffIn, encrCtr, AES_BLOCK_SIZE);
-    FLib_MemCpy(pOutput, tempBuffIn, inputLen);
-    AES_128_IncrementCounter(pCounter);
-#endif
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
 }
 
 /*! *********************************************************************************
@@ -707,31 +576,22 @@ void AES_128_OFB(uint8_t* pInput,
                  uint8_t* pKey,
                  uint8_t* pOutput)
 {
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
     uint8_t tempBuffIn[AES_BLOCK_SIZE] = {0};
-    uint8_t tempBuffOut[AES_BLOCK_SIZE] = {0};
 
     if( pInitVector != NULL )
     {
         FLib_MemCpy(tempBuffIn, pInitVector, AES_BLOCK_SIZE);
     }
 
-    /* If remaining data is bigger than one AES block size */
-    while( inputLen > AES_BLOCK_SIZE )
-    {
-        AES_128_Encrypt(tempBuffIn, pKey, tempBuffOut);
-        FLib_MemCpy(tempBuffIn, tempBuffOut, AES_BLOCK_SIZE);
-        SecLib_XorN(tempBuffOut, pInput, AES_BLOCK_SIZE);
-        FLib_MemCpy(pOutput, tempBuffOut, AES_BLOCK_SIZE);
-        pInput += AES_BLOCK_SIZE;
-        pOutput += AES_BLOCK_SIZE;
-        inputLen -= AES_BLOCK_SIZE;
-    }
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
 
-    /* If remaining data is smaller then one AES block size  */
-    AES_128_Encrypt(tempBuffIn, pKey, tempBuffOut);
-    FLib_MemCpy(tempBuffIn, tempBuffOut, AES_BLOCK_SIZE);
-    SecLib_XorN(tempBuffOut, pInput, inputLen);
-    FLib_MemCpy(pOutput, tempBuffOut, inputLen);
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesOfb(pAesCtx, pInput, inputLen, tempBuffIn, pOutput);
+
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
 }
 
 /*! *********************************************************************************
@@ -753,68 +613,15 @@ void AES_128_CMAC(uint8_t* pInput,
                   uint8_t* pKey,
                   uint8_t* pOutput)
 {
-    uint8_t X[16];
-    uint8_t Y[16];
-    uint8_t M_last[16] = {0};
-    uint8_t padded[16] = {0};
-
-    uint8_t K1[16] = {0};
-    uint8_t K2[16] = {0};
-
-    uint8_t n;
-    uint32_t i;
-    uint8_t flag;
-
-    AES_128_CMAC_Generate_Subkey(pKey, K1, K2);
-
-    n = (uint8_t) ((inputLen + 15) / 16); /* n is number of rounds */
-
-    if (n == 0) 
-    {
-        n = 1;
-        flag = 0;
-    } 
-    else 
-    {
-        if ((inputLen % 16) == 0) 
-        { /* last block is a complete block */
-            flag = 1;
-        } 
-        else 
-        { /* last block is not complete block */
-            flag = 0;
-        }
-    }
-
-    /* Process the last block  - the last part the MSB first input data */
-    if (flag) 
-    { /* last block is complete block */
-        SecLib_Xor128(&pInput[16 * (n - 1)], K1, M_last);
-    } 
-    else 
-    {
-        SecLib_Padding(&pInput[16 * (n - 1)], padded, inputLen % 16);
-        SecLib_Xor128(padded, K2, M_last);
-    }
-
-    for (i = 0; i < 16; i++)
-    {
-        X[i] = 0;
-    }
-
-    for (i = 0; i < n - 1; i++) 
-    {
-        SecLib_Xor128(X, &pInput[16 * i], Y); /* Y := Mi (+) X  */
-        AES_128_Encrypt(Y, pKey, X); /* X := AES-128(KEY, Y) */
-    }
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
 
-    SecLib_Xor128(X, M_last, Y);
-    AES_128_Encrypt(Y, pKey, X);
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesCmac(pAesCtx, pInput, inputLen, FALSE, pOutput);
 
-    for (i = 0; i < 16; i++) 
-    {
-        pOutput[i] = X[i];
-    }
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
 }
 
 
@@ -836,72 +643,16 @@ void AES_128_CMAC_LsbFirstInput (uint8_t* pInput,
                                  uint8_t* pKey,
                                  uint8_t* pOutput)
 {
-    uint8_t X[16];
-    uint8_t Y[16];
-    uint8_t M_last[16] = {0};
-    uint8_t padded[16] = {0};
-    uint8_t reversedBlock[16] = {0};
-
-    uint8_t K1[16] = {0};
-    uint8_t K2[16] = {0};
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
 
-    uint8_t n;
-    uint32_t i;
-    uint8_t flag;
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    SecLib_AesCmac(pAesCtx, pInput, inputLen, TRUE, pOutput);
 
-    AES_128_CMAC_Generate_Subkey(pKey, K1, K2);
-
-    n = (uint8_t) ((inputLen + 15) / 16); /* n is number of rounds */
-
-    if (n == 0)
-    {
-        n = 1;
-        flag = 0;
-    } 
-    else
-    {
-        if ((inputLen % 16) == 0) /* last block is a complete block */
-        {
-            flag = 1;
-        }
-        else /* last block is not complete block */
-        { 
-            flag = 0;
-        }
-    }
-    
-    /* Process the last block  - the first part the LSB first input data */
-    if (flag)  /* last block is complete block */
-    {
-        FLib_MemCpyReverseOrder (reversedBlock, &pInput[0], 16);
-        SecLib_Xor128 (reversedBlock, K1, M_last);
-    } 
-    else 
-    {
-        FLib_MemCpyReverseOrder (reversedBlock, &pInput[0], inputLen % 16);
-        SecLib_Padding(reversedBlock, padded, inputLen % 16);
-        SecLib_Xor128(padded, K2, M_last);
-    }
-
-    for (i = 0; i < 16; i++)
-    {
-        X[i] = 0;
-    }
-    
-    for (i = 0; i < n - 1; i++)
-    {
-        FLib_MemCpyReverseOrder (reversedBlock, &pInput[inputLen - 16 * (i + 1)], 16);
-        SecLib_Xor128(X, reversedBlock, Y); /* Y := Mi (+) X  */
-        AES_128_Encrypt(Y, pKey, X); /* X := AES-128(KEY, Y) */
-    }
-
-    SecLib_Xor128(X, M_last, Y);
-    AES_128_Encrypt(Y, pKey, X);
-
-    for (i = 0; i < 16; i++) {
-        pOutput[i] = X[i];
-    }
-}
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
 
 
 /*! *********************************************************************************
@@ -982,298 +733,1366 @@ secResultType_t AES_128_EAX_Encrypt(uint8_t* pInput,
                                     uint8_t* pOutput,
                                     uint8_t* pTag)
 {
-    uint8_t *buf;
-    uint32_t buf_len;
-    uint8_t nonce_mac[AES_BLOCK_SIZE] = {0};
-    uint8_t hdr_mac[AES_BLOCK_SIZE] = {0};
-    uint8_t data_mac[AES_BLOCK_SIZE] = {0};
-    uint8_t tempBuff[AES_BLOCK_SIZE] = {0};
-    secResultType_t status = gSecSuccess_c;
-    uint32_t i;
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
+    secResultType_t status;
+
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    status = SecLib_AesEax(pAesCtx, pInput, inputLen, pNonce, nonceLen,
+                           pHeader, headerLen, pOutput, pTag, TRUE);
+
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-EAX decryption on a message block.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Length of the input message in bytes.
+*
+* \param[in]  pNonce Pointer to the location of the nonce.
+*
+* \param[in]  nonceLen Nonce length in bytes.
+*
+* \param[in]  pHeader Pointer to the location of header.
+*
+* \param[in]  headerLen Header length in bytes.
+*
+* \param[in]  pKey Pointer to the location of the 128-bit key.
+*
+* \param[out]  pOutput Pointer to the location to store the 16-byte authentication code.
+*
+* \param[out]  pTag Pointer to the location to store the 128-bit tag.
+*
+********************************************************************************** */
+secResultType_t AES_128_EAX_Decrypt(uint8_t* pInput,
+                                    uint32_t inputLen,
+                                    uint8_t* pNonce,
+                                    uint32_t nonceLen,
+                                    uint8_t* pHeader,
+                                    uint8_t headerLen,
+                                    uint8_t* pKey,
+                                    uint8_t* pOutput,
+                                    uint8_t* pTag)
+{
+    SECLIB_AES_CTX_DECLARE(pAesCtx);
+    secResultType_t status;
+
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+
+    SecLib_AesKeyExpand(pAesCtx, pKey);
+    status = SecLib_AesEax(pAesCtx, pInput, inputLen, pNonce, nonceLen,
+                           pHeader, headerLen, pOutput, pTag, FALSE);
+
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CCM on a message block.
+*
+* \param[in]  pInput       Pointer to the location of the input message (plaintext or cyphertext).
+*
+* \param[in]  inputLen     Length of the input plaintext in bytes when encrypting.
+*                          Length of the input cypertext without the MAC length when decrypting.
+* 
+* \param[in]  pAuthData    Pointer to the additional authentication data.
+*
+* \param[in]  authDataLen  Length of additional authentication data.
+*
+* \param[in]  pNonce       Pointer to the Nonce.
+*
+* \param[in]  nonceSize    The size of the nonce (7-13).
+*
+* \param[in]  pKey         Pointer to the location of the 128-bit key.
+*
+* \param[out]  pOutput     Pointer to the location to store the plaintext data when decrypting.
+*                          Pointer to the location to store the cyphertext data when encrypting.
+*
+* \param[out]  pCbcMac     Pointer to the location to store the Message Authentication Code (MAC) when encrypting.
+*                          Pointer to the location where the received MAC can be found when decrypting.
+*
+* \param[out]  macSize     The size of the MAC.
+*
+* \param[out]  flags       Select encrypt/decrypt operations (gSecLib_CCM_Encrypt_c, gSecLib_CCM_Decrypt_c)
+*
+* \return 0 if encryption/decryption was successfull; otherwise, error code for failed encryption/decryption
+*
+* \remarks At decryption, MIC fail is also signaled by returning a non-zero value.
+*
+********************************************************************************** */
+uint8_t AES_128_CCM(uint8_t* pInput,
+                    uint16_t inputLen,
+                    uint8_t* pAuthData,
+                    uint16_t authDataLen,
+                    uint8_t* pNonce,
+                    uint8_t  nonceSize,
+                    uint8_t* pKey,
+                    uint8_t* pOutput,
+                    uint8_t* pCbcMac,
+                    uint8_t  macSize,
+                    uint32_t flags)
+{
+    uint8_t status;
 
-    if( nonceLen > inputLen )
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+
+#if FSL_FEATURE_SOC_LTC_COUNT
+    if( flags & gSecLib_CCM_Decrypt_c )
     {
-        buf_len = nonceLen;
+        status = LTC_AES_DecryptTagCcm(LTC0, pInput, pOutput, inputLen, pNonce, nonceSize, pAuthData, authDataLen, pKey, AES_BLOCK_SIZE, pCbcMac, macSize);
     }
     else
     {
-        buf_len = inputLen;
+        status = LTC_AES_EncryptTagCcm(LTC0, pInput, pOutput, inputLen, pNonce, nonceSize, pAuthData, authDataLen, pKey, AES_BLOCK_SIZE, pCbcMac, macSize);
     }
 
-    if( headerLen > buf_len )
-    {
-        buf_len = headerLen;
-    }
+#elif FSL_FEATURE_SOC_MMCAU_COUNT
+    SecLib_AesKeyExpand(&mSecLibAesCtx, pKey);
+    status = (uint8_t)SecLib_AesCcm(&mSecLibAesCtx, pInput, inputLen, pAuthData, authDataLen, pNonce, nonceSize,
+                                    pOutput, pCbcMac, macSize, !(flags & gSecLib_CCM_Decrypt_c));
+#else
+        status = sw_AES128_CCM(pInput, inputLen, pAuthData, authDataLen, pNonce, nonceSize, pKey, pOutput, pCbcMac, macSize, flags);
+#endif
+
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  This function initializes an AES-128 key context: the key is expanded once,
+*         for all the AES_128_Ctx operations using the context.
+*
+* \param[out] pCtx Pointer to the key context.
+*
+* \param[in]  pKey Pointer to the location of the 128-bit key.
+*
+********************************************************************************** */
+void AES_128_CtxInit(aesKeyCtx_t* pCtx,
+                     const uint8_t* pKey)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_AesKeyExpand(pCtx, pKey);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-ECB encryption on 16-byte blocks, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input blocks.
+*
+* \param[in]  numBlocks Number of 16-byte blocks.
+*
+* \param[out]  pOutput Pointer to the location to store the ciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxECB_Encrypt(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t numBlocks,
+                            uint8_t* pOutput)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_AesEcb(pCtx, pInput, numBlocks, pOutput, TRUE);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-ECB decryption on 16-byte blocks, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input blocks.
+*
+* \param[in]  numBlocks Number of 16-byte blocks.
+*
+* \param[out]  pOutput Pointer to the location to store the deciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxECB_Decrypt(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t numBlocks,
+                            uint8_t* pOutput)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_AesEcb(pCtx, pInput, numBlocks, pOutput, FALSE);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CBC encryption on a message block, with a key
+*         context. A last block shorter than 16 bytes is zero padded, and only
+*         inputLen bytes are output.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Input message length in bytes.
+*
+* \param[in, out]  pInitVector Pointer to the location of the 128-bit initialization
+*                  vector. It is set to the last ciphered block, to chain the next call.
+*
+* \param[out]  pOutput Pointer to the location to store the ciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxCBC_Encrypt(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t inputLen,
+                            uint8_t* pInitVector,
+                            uint8_t* pOutput)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_AesCbcEncrypt(pCtx, pInput, inputLen, pInitVector, pOutput);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CBC decryption on a message block, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Input message length in bytes, a multiple of 16.
+*
+* \param[in, out]  pInitVector Pointer to the location of the 128-bit initialization
+*                  vector. It is set to the last input block, to chain the next call.
+*
+* \param[out]  pOutput Pointer to the location to store the deciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxCBC_Decrypt(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t inputLen,
+                            uint8_t* pInitVector,
+                            uint8_t* pOutput)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_AesCbcDecrypt(pCtx, pInput, inputLen & ~(uint32_t)(AES_BLOCK_SIZE - 1), pInitVector, pOutput);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CTR encryption on a message block, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Input message length in bytes.
+*
+* \param[in, out]  pCounter Pointer to the location of the 128-bit counter. It is
+*                  incremented once for each block, the last one included.
+*
+* \param[out]  pOutput Pointer to the location to store the ciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxCTR(aesKeyCtx_t* pCtx,
+                    const uint8_t* pInput,
+                    uint32_t inputLen,
+                    uint8_t* pCounter,
+                    uint8_t* pOutput)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_AesCtr(pCtx, pInput, inputLen, pCounter, pOutput);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-OFB encryption on a message block, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Input message length in bytes.
+*
+* \param[in, out]  pInitVector Pointer to the location of the 128-bit initialization
+*                  vector. It is set to the last key stream block.
+*
+* \param[out]  pOutput Pointer to the location to store the ciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxOFB(aesKeyCtx_t* pCtx,
+                    const uint8_t* pInput,
+                    uint32_t inputLen,
+                    uint8_t* pInitVector,
+                    uint8_t* pOutput)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_AesOfb(pCtx, pInput, inputLen, pInitVector, pOutput);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
 
-    buf_len += 16U;
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CMAC on a message block, with a key context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message, MSB first.
+*
+* \param[in]  inputLen Length of the input message in bytes.
+*
+* \param[out]  pOutput Pointer to the location to store the 16-byte authentication code.
+*
+********************************************************************************** */
+void AES_128_CtxCMAC(aesKeyCtx_t* pCtx,
+                     const uint8_t* pInput,
+                     uint32_t inputLen,
+                     uint8_t* pOutput)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_AesCmac(pCtx, pInput, inputLen, FALSE, pOutput);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-EAX encryption on a message block, with a key
+*         context. The parameters are the ones of AES_128_EAX_Encrypt().
+*
+********************************************************************************** */
+secResultType_t AES_128_CtxEAX_Encrypt(aesKeyCtx_t* pCtx,
+                                       uint8_t* pInput,
+                                       uint32_t inputLen,
+                                       uint8_t* pNonce,
+                                       uint32_t nonceLen,
+                                       uint8_t* pHeader,
+                                       uint8_t headerLen,
+                                       uint8_t* pOutput,
+                                       uint8_t* pTag)
+{
+    secResultType_t status;
+
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    status = SecLib_AesEax(pCtx, pInput, inputLen, pNonce, nonceLen,
+                           pHeader, headerLen, pOutput, pTag, TRUE);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-EAX decryption on a message block, with a key
+*         context. The parameters are the ones of AES_128_EAX_Decrypt().
+*
+********************************************************************************** */
+secResultType_t AES_128_CtxEAX_Decrypt(aesKeyCtx_t* pCtx,
+                                       uint8_t* pInput,
+                                       uint32_t inputLen,
+                                       uint8_t* pNonce,
+                                       uint32_t nonceLen,
+                                       uint8_t* pHeader,
+                                       uint8_t headerLen,
+                                       uint8_t* pOutput,
+                                       uint8_t* pTag)
+{
+    secResultType_t status;
+
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    status = SecLib_AesEax(pCtx, pInput, inputLen, pNonce, nonceLen,
+                           pHeader, headerLen, pOutput, pTag, FALSE);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  This function starts an AES-128-EAX encryption or decryption of a message
+*         processed in pieces. No memory is allocated: the whole state is kept in
+*         the EAX context.
+*
+* \param[out] pCtx Pointer to the EAX context.
+*
+* \param[in]  pKeyCtx Pointer to the key context, initialized by AES_128_CtxInit().
+*             It must be kept until AES_128_EaxFinish().
+*
+* \param[in]  pNonce Pointer to the location of the nonce.
+*
+* \param[in]  nonceLen Nonce length in bytes.
+*
+* \param[in]  encrypt TRUE to encrypt, FALSE to decrypt.
+*
+********************************************************************************** */
+void AES_128_EaxInit(aesEaxCtx_t* pCtx,
+                     aesKeyCtx_t* pKeyCtx,
+                     const uint8_t* pNonce,
+                     uint32_t nonceLen,
+                     bool_t encrypt)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_EaxStart(pCtx, pKeyCtx, pNonce, nonceLen, encrypt);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function adds a piece of the header (the authenticated data) to an
+*         AES-128-EAX operation. The header and message pieces may be interleaved.
+*
+* \param[in]  pCtx Pointer to the EAX context.
+*
+* \param[in]  pHeader Pointer to the location of the header piece.
+*
+* \param[in]  headerLen Header piece length in bytes.
+*
+********************************************************************************** */
+void AES_128_EaxUpdateAAD(aesEaxCtx_t* pCtx,
+                          const uint8_t* pHeader,
+                          uint32_t headerLen)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_OmacUpdate(pCtx->pKeyCtx, &pCtx->headerMac, pHeader, headerLen);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function encrypts or decrypts a piece of the message of an AES-128-EAX
+*         operation. The input and output may be the same buffer.
+*
+* \param[in]  pCtx Pointer to the EAX context.
+*
+* \param[in]  pInput Pointer to the location of the input piece.
+*
+* \param[in]  inputLen Input piece length in bytes.
+*
+* \param[out]  pOutput Pointer to the location to store the output piece.
+*
+* \remarks When decrypting, the output must not be used before AES_128_EaxFinish()
+*          has checked the tag.
+*
+********************************************************************************** */
+void AES_128_EaxUpdate(aesEaxCtx_t* pCtx,
+                       const uint8_t* pInput,
+                       uint32_t inputLen,
+                       uint8_t* pOutput)
+{
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    SecLib_EaxCrypt(pCtx, pInput, inputLen, pOutput);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+}
+
+/*! *********************************************************************************
+* \brief  This function ends an AES-128-EAX operation and clears the EAX context.
+*
+* \param[in]  pCtx Pointer to the EAX context.
+*
+* \param[in, out]  pTag Pointer to the location of the 128-bit tag: written when
+*                  encrypting, checked when decrypting.
+*
+* \return gSecSuccess_c, or gSecError_c if the tag of a decrypted message is wrong.
+*
+********************************************************************************** */
+secResultType_t AES_128_EaxFinish(aesEaxCtx_t* pCtx,
+                                  uint8_t* pTag)
+{
+    secResultType_t status;
+
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    status = SecLib_EaxFinish(pCtx, pTag);
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CCM or CCM* on a message block, with a key
+*         context. The parameters are the ones of AES_128_CCM(); the MIC length may
+*         also be 0 (encryption only). The input and output may be the same buffer.
+*
+* \return gSecSuccess_c, or gSecError_c if a parameter is invalid or if the MIC of a
+*         decrypted message is wrong. The output is then cleared.
+*
+********************************************************************************** */
+secResultType_t AES_128_CtxCCM(aesKeyCtx_t* pCtx,
+                               uint8_t* pInput,
+                               uint32_t inputLen,
+                               uint8_t* pAuthData,
+                               uint32_t authDataLen,
+                               uint8_t* pNonce,
+                               uint8_t  nonceSize,
+                               uint8_t* pOutput,
+                               uint8_t* pCbcMac,
+                               uint8_t  macSize,
+                               uint32_t flags)
+{
+    secResultType_t status;
+
+    SecLib_DisallowToSleep();
+    SECLIB_MUTEX_LOCK();
+    status = SecLib_AesCcm(pCtx, pInput, inputLen, pAuthData, authDataLen, pNonce, nonceSize,
+                           pOutput, pCbcMac, macSize, !(flags & gSecLib_CCM_Decrypt_c));
+    SECLIB_MUTEX_UNLOCK();
+    SecLib_AllowToSleep();
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  This function calculates XOR of individual byte pairs in two uint8_t arrays.
+*         pDst[i] := pDst[i] ^ pSrc[i] for i=0 to n-1
+*
+* \param[in, out]  pDst First byte array operand for XOR and destination byte array
+*
+* \param[in]  pSrc Second byte array operand for XOR
+*
+* \param[in]  n  Length of the byte arrays which will be XORed
+*
+********************************************************************************** */
+void SecLib_XorN(uint8_t* pDst,
+                 uint8_t* pSrc,
+                 uint8_t n)
+{
+    while( n )
+    {
+        *pDst = *pDst ^ *pSrc;
+        pDst = pDst + 1;
+        pSrc = pSrc + 1;
+        n--;
+    }
+}
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+
+/*! *********************************************************************************
+* \brief  Increments the value of a given counter vector.
+*
+* \param [in/out]     ctr         Counter.
+*
+* \remarks
+*
+********************************************************************************** */
+static void AES_128_IncrementCounter(uint8_t* ctr)
+{
+    uint32_t i;
+    uint64_t tempLow;
+    uuint128_t tempCtr;
+
+    for(i=0;i<AES_BLOCK_SIZE;i++)
+    {
+        tempCtr.u8[AES_BLOCK_SIZE-i-1] = ctr[i];
+    }
+
+    tempLow = tempCtr.u64[0];
+    tempCtr.u64[0]++;
+
+    if(tempLow > tempCtr.u64[0])
+    {
+        tempCtr.u64[1]++;
+    }
+
+    for(i=0;i<AES_BLOCK_SIZE;i++)
+    {
+        ctr[i] = tempCtr.u8[AES_BLOCK_SIZE-i-1];
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Loads a 128-bit key into an AES key context and expands its key schedule.
+*
+* \param [out]   pCtx       Key context.
+*
+* \param [in]    pKey       AES Key.
+*
+* \remarks  The SecLib lock must be held when using the SecLib key context.
+*
+********************************************************************************** */
+static void SecLib_AesKeyExpand(aesKeyCtx_t* pCtx,
+                                const uint8_t* pKey)
+{
+    FLib_MemCpy(pCtx->key, (uint8_t*)pKey, AES_BLOCK_SIZE);
+#if FSL_FEATURE_SOC_MMCAU_COUNT
+    mmcau_aes_set_key((const unsigned char*)pCtx->key, AES128, (unsigned char*)pCtx->keySchedule);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief  Encrypts or decrypts a 16-byte block with the key of an AES key context.
+*
+* \param [in]    pCtx       Key context.
+*
+* \param [in]    pInput     Input block.
+*
+* \param [out]   pOutput    Output block.
+*
+* \param [in]    encrypt    TRUE to encrypt, FALSE to decrypt.
+*
+* \remarks  The sw_Aes128() fallback takes the raw key, and expands it on each block.
+*
+********************************************************************************** */
+static void SecLib_AesBlock(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint8_t* pOutput,
+                            bool_t encrypt)
+{
+#if FSL_FEATURE_SOC_MMCAU_COUNT
+    uint32_t alignedIn[AES_BLOCK_SIZE/sizeof(uint32_t)];
+    uint32_t alignedOut[AES_BLOCK_SIZE/sizeof(uint32_t)];
+    const uint8_t* pIn = pInput;
+    uint8_t* pOut = pOutput;
+
+    /* Check if pInput is 4 bytes aligned */
+    if ((uint32_t)pInput & 0x00000003)
+    {
+        FLib_MemCpy(alignedIn, (uint8_t*)pInput, AES_BLOCK_SIZE);
+        pIn = (uint8_t*)alignedIn;
+    }
+
+    /* Check if pOutput is 4 bytes aligned */
+    if ((uint32_t)pOutput & 0x00000003)
+    {
+        pOut = (uint8_t*)alignedOut;
+    }
+
+    if (encrypt)
+    {
+        mmcau_aes_encrypt(pIn, (const unsigned char*)pCtx->keySchedule, AES128_ROUNDS, pOut);
+    }
+    else
+    {
+        mmcau_aes_decrypt(pIn, (const unsigned char*)pCtx->keySchedule, AES128_ROUNDS, pOut);
+    }
+
+    if (pOut != pOutput)
+    {
+        FLib_MemCpy(pOutput, alignedOut, AES_BLOCK_SIZE);
+    }
+
+#elif FSL_FEATURE_SOC_LTC_COUNT
+    if (encrypt)
+    {
+        LTC_AES_EncryptEcb(LTC0, pInput, pOutput, AES_BLOCK_SIZE, (uint8_t*)pCtx->key, AES_BLOCK_SIZE);
+    }
+    else
+    {
+        LTC_AES_DecryptEcb(LTC0, pInput, pOutput, AES_BLOCK_SIZE, (uint8_t*)pCtx->key, AES_BLOCK_SIZE, kLTC_EncryptKey);
+    }
+
+#else
+    sw_Aes128(pInput, (uint8_t*)pCtx->key, encrypt ? 1 : 0, pOutput);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief  AES-128-ECB on 16-byte blocks, with the key of an AES key context.
+*
+********************************************************************************** */
+static void SecLib_AesEcb(aesKeyCtx_t* pCtx,
+                          const uint8_t* pInput,
+                          uint32_t numBlocks,
+                          uint8_t* pOutput,
+                          bool_t encrypt)
+{
+    while( numBlocks )
+    {
+        SecLib_AesBlock(pCtx, pInput, pOutput, encrypt);
+        numBlocks--;
+        pInput += AES_BLOCK_SIZE;
+        pOutput += AES_BLOCK_SIZE;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  AES-128-CBC encryption, with the key of an AES key context. The chaining
+*         value pInitVector is updated to the last ciphered block.
+*
+********************************************************************************** */
+static void SecLib_AesCbcEncrypt(aesKeyCtx_t* pCtx,
+                                 const uint8_t* pInput,
+                                 uint32_t inputLen,
+                                 uint8_t* pInitVector,
+                                 uint8_t* pOutput)
+{
+#if FSL_FEATURE_SOC_LTC_COUNT
+    LTC_AES_EncryptCbc(LTC0, pInput, pOutput, inputLen, pInitVector, (uint8_t*)pCtx->key, AES_BLOCK_SIZE);
+    if( inputLen >= AES_BLOCK_SIZE )
+    {
+        FLib_MemCpy(pInitVector, pOutput + inputLen - AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+    }
+
+#else
+    uint8_t tempBuffOut[AES_BLOCK_SIZE];
+
+    /* If remaining data is bigger than one AES block size */
+    while( inputLen > AES_BLOCK_SIZE )
+    {
+        SecLib_XorN(pInitVector, (uint8_t*)pInput, AES_BLOCK_SIZE);
+        SecLib_AesBlock(pCtx, pInitVector, pOutput, TRUE);
+        FLib_MemCpy(pInitVector, pOutput, AES_BLOCK_SIZE);
+        pInput += AES_BLOCK_SIZE;
+        pOutput += AES_BLOCK_SIZE;
+        inputLen -= AES_BLOCK_SIZE;
+    }
+
+    /* If remaining data is smaller then one AES block size  */
+    SecLib_XorN(pInitVector, (uint8_t*)pInput, inputLen);
+    SecLib_AesBlock(pCtx, pInitVector, tempBuffOut, TRUE);
+    FLib_MemCpy(pInitVector, tempBuffOut, AES_BLOCK_SIZE);
+    FLib_MemCpy(pOutput, tempBuffOut, inputLen);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief  AES-128-CBC decryption of whole blocks, with the key of an AES key context.
+*         The chaining value pInitVector is updated to the last input block. The
+*         input and output may overlap.
+*
+********************************************************************************** */
+static void SecLib_AesCbcDecrypt(aesKeyCtx_t* pCtx,
+                                 const uint8_t* pInput,
+                                 uint32_t inputLen,
+                                 uint8_t* pInitVector,
+                                 uint8_t* pOutput)
+{
+    uint8_t nextIv[AES_BLOCK_SIZE];
+
+#if FSL_FEATURE_SOC_LTC_COUNT
+    if( inputLen >= AES_BLOCK_SIZE )
+    {
+        FLib_MemCpy(nextIv, (uint8_t*)pInput + inputLen - AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+        LTC_AES_DecryptCbc(LTC0, pInput, pOutput, inputLen, pInitVector, (uint8_t*)pCtx->key, AES_BLOCK_SIZE, kLTC_DecryptKey);
+        FLib_MemCpy(pInitVector, nextIv, AES_BLOCK_SIZE);
+    }
+
+#else
+    while( inputLen >= AES_BLOCK_SIZE )
+    {
+        FLib_MemCpy(nextIv, (uint8_t*)pInput, AES_BLOCK_SIZE);
+        SecLib_AesBlock(pCtx, pInput, pOutput, FALSE);
+        SecLib_XorN(pOutput, pInitVector, AES_BLOCK_SIZE);
+        FLib_MemCpy(pInitVector, nextIv, AES_BLOCK_SIZE);
+        pInput += AES_BLOCK_SIZE;
+        pOutput += AES_BLOCK_SIZE;
+        inputLen -= AES_BLOCK_SIZE;
+    }
+#endif
+}
+
+/*! *********************************************************************************
+* \brief  AES-128-CTR, with the key of an AES key context. The counter is incremented
+*         once for each block, the last one included.
+*
+********************************************************************************** */
+static void SecLib_AesCtr(aesKeyCtx_t* pCtx,
+                          const uint8_t* pInput,
+                          uint32_t inputLen,
+                          uint8_t* pCounter,
+                          uint8_t* pOutput)
+{
+#if FSL_FEATURE_SOC_LTC_COUNT
+    LTC_AES_EncryptCtr(LTC0, pInput, pOutput, inputLen, pCounter, (uint8_t*)pCtx->key, AES_BLOCK_SIZE, NULL, NULL);
+
+#else
+    uint8_t tempBuffIn[AES_BLOCK_SIZE] = {0};
+    uint8_t encrCtr[AES_BLOCK_SIZE];
+
+    /* If remaining data bigger than one AES block size */
+    while( inputLen > AES_BLOCK_SIZE )
+    {
+        FLib_MemCpy(tempBuffIn, (uint8_t*)pInput, AES_BLOCK_SIZE);
+        SecLib_AesBlock(pCtx, pCounter, encrCtr, TRUE);
+        SecLib_XorN(tempBuffIn, encrCtr, AES_BLOCK_SIZE);
+        FLib_MemCpy(pOutput, tempBuffIn, AES_BLOCK_SIZE);
+        pInput += AES_BLOCK_SIZE;
+        pOutput += AES_BLOCK_SIZE;
+        inputLen -= AES_BLOCK_SIZE;
+        AES_128_IncrementCounter(pCounter);
+    }
+
+    /* If remaining data is smaller then one AES block size  */
+    FLib_MemCpy(tempBuffIn, (uint8_t*)pInput, inputLen);
+    SecLib_AesBlock(pCtx, pCounter, encrCtr, TRUE);
+    SecLib_XorN(tempBuffIn, encrCtr, AES_BLOCK_SIZE);
+    FLib_MemCpy(pOutput, tempBuffIn, inputLen);
+    AES_128_IncrementCounter(pCounter);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief  AES-128-OFB, with the key of an AES key context. The initialization vector
+*         is updated to the last key stream block.
+*
+********************************************************************************** */
+static void SecLib_AesOfb(aesKeyCtx_t* pCtx,
+                          const uint8_t* pInput,
+                          uint32_t inputLen,
+                          uint8_t* pInitVector,
+                          uint8_t* pOutput)
+{
+    uint8_t tempBuffOut[AES_BLOCK_SIZE];
+
+    /* If remaining data is bigger than one AES block size */
+    while( inputLen > AES_BLOCK_SIZE )
+    {
+        SecLib_AesBlock(pCtx, pInitVector, tempBuffOut, TRUE);
+        FLib_MemCpy(pInitVector, tempBuffOut, AES_BLOCK_SIZE);
+        SecLib_XorN(tempBuffOut, (uint8_t*)pInput, AES_BLOCK_SIZE);
+        FLib_MemCpy(pOutput, tempBuffOut, AES_BLOCK_SIZE);
+        pInput += AES_BLOCK_SIZE;
+        pOutput += AES_BLOCK_SIZE;
+        inputLen -= AES_BLOCK_SIZE;
+    }
+
+    /* If remaining data is smaller then one AES block size  */
+    SecLib_AesBlock(pCtx, pInitVector, tempBuffOut, TRUE);
+    FLib_MemCpy(pInitVector, tempBuffOut, AES_BLOCK_SIZE);
+    SecLib_XorN(tempBuffOut, (uint8_t*)pInput, inputLen);
+    FLib_MemCpy(pOutput, tempBuffOut, inputLen);
+}
+
+/*! *********************************************************************************
+* \brief  AES-128-CMAC, with the key of an AES key context.
+*
+* \param [in]    lsbFirst   TRUE if the input is LSB first: the authentication code
+*                           is then computed starting from the end of the data.
+*
+* \remarks   This is public open source code! Terms of use must be checked before use!
+*
+********************************************************************************** */
+static void SecLib_AesCmac(aesKeyCtx_t* pCtx,
+                           const uint8_t* pInput,
+                           uint32_t inputLen,
+                           bool_t lsbFirst,
+                           uint8_t* pOutput)
+{
+    uint8_t X[16] = {0};
+    uint8_t Y[16];
+    uint8_t M_last[16] = {0};
+    uint8_t padded[16] = {0};
+    uint8_t block[16] = {0};
+
+    uint8_t K1[16] = {0};
+    uint8_t K2[16] = {0};
+
+    uint32_t n;
+    uint32_t i;
+    uint32_t lastLen;
+
+    AES_128_CMAC_Generate_Subkey(pCtx, K1, K2);
+
+    n = (inputLen + 15) / 16; /* n is number of rounds */
+    lastLen = inputLen - 16 * (n - 1);
+
+    if (n == 0)
+    {
+        n = 1;
+        lastLen = 0;
+    }
+
+    /* Process the last block */
+    if (lsbFirst)
+    {
+        FLib_MemCpyReverseOrder(block, (uint8_t*)&pInput[0], lastLen);
+    }
+    else
+    {
+        FLib_MemCpy(block, (uint8_t*)&pInput[16 * (n - 1)], lastLen);
+    }
+
+    if (lastLen == 16)
+    { /* last block is complete block */
+        SecLib_Xor128(block, K1, M_last);
+    }
+    else
+    {
+        SecLib_Padding(block, padded, lastLen);
+        SecLib_Xor128(padded, K2, M_last);
+    }
+
+    for (i = 0; i < n - 1; i++)
+    {
+        if (lsbFirst)
+        {
+            FLib_MemCpyReverseOrder(block, (uint8_t*)&pInput[inputLen - 16 * (i + 1)], 16);
+        }
+        else
+        {
+            FLib_MemCpy(block, (uint8_t*)&pInput[16 * i], 16);
+        }
+        SecLib_Xor128(X, block, Y); /* Y := Mi (+) X  */
+        SecLib_AesBlock(pCtx, Y, X, TRUE); /* X := AES-128(KEY, Y) */
+    }
+
+    SecLib_Xor128(X, M_last, Y);
+    SecLib_AesBlock(pCtx, Y, pOutput, TRUE);
+}
+
+/*! *********************************************************************************
+* \brief  AES-128-EAX encryption or decryption, with the key of an AES key context.
+*         When decrypting, the message is only decrypted once its tag is checked.
+*
+* \param [in]    encrypt    TRUE to encrypt and generate pTag, FALSE to check pTag
+*                           and decrypt.
+*
+********************************************************************************** */
+static secResultType_t SecLib_AesEax(aesKeyCtx_t* pCtx,
+                                     uint8_t* pInput,
+                                     uint32_t inputLen,
+                                     uint8_t* pNonce,
+                                     uint32_t nonceLen,
+                                     uint8_t* pHeader,
+                                     uint8_t headerLen,
+                                     uint8_t* pOutput,
+                                     uint8_t* pTag,
+                                     bool_t encrypt)
+{
+    aesEaxCtx_t eaxCtx;
+    uint8_t counter[AES_BLOCK_SIZE];
+    secResultType_t status;
+
+    SecLib_EaxStart(&eaxCtx, pCtx, pNonce, nonceLen, encrypt);
+    SecLib_OmacUpdate(pCtx, &eaxCtx.headerMac, pHeader, headerLen);
+
+    if( encrypt )
+    {
+        SecLib_EaxCrypt(&eaxCtx, pInput, inputLen, pOutput);
+        status = SecLib_EaxFinish(&eaxCtx, pTag);
+    }
+    else
+    {
+        SecLib_OmacUpdate(pCtx, &eaxCtx.dataMac, pInput, inputLen);
+        FLib_MemCpy(counter, eaxCtx.nonceMac, AES_BLOCK_SIZE);
+        status = SecLib_EaxFinish(&eaxCtx, pTag);
+
+        if( gSecSuccess_c == status )
+        {
+            SecLib_AesCtr(pCtx, pInput, inputLen, counter, pOutput);
+        }
+    }
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief  Starts the OMAC^t of EAX, the AES-128-CMAC of a message processed in pieces
+*         and prefixed by the 16-byte block [0..0 t].
+*
+********************************************************************************** */
+static void SecLib_OmacStart(aesOmacState_t* pMac,
+                             uint8_t t)
+{
+    FLib_MemSet(pMac, 0, sizeof(aesOmacState_t));
+    pMac->block[AES_BLOCK_SIZE - 1] = t;
+    pMac->blockLen = AES_BLOCK_SIZE;
+}
+
+/*! *********************************************************************************
+* \brief  Adds a piece of message to an AES-128-CMAC. The last block is kept until
+*         more data follows, as it is processed with a subkey.
+*
+********************************************************************************** */
+static void SecLib_OmacUpdate(aesKeyCtx_t* pKeyCtx,
+                              aesOmacState_t* pMac,
+                              const uint8_t* pData,
+                              uint32_t dataLen)
+{
+    uint8_t Y[AES_BLOCK_SIZE];
+    uint32_t n;
+
+    while( dataLen )
+    {
+        if( pMac->blockLen == AES_BLOCK_SIZE )
+        {
+            SecLib_Xor128(pMac->X, pMac->block, Y); /* Y := Mi (+) X  */
+            SecLib_AesBlock(pKeyCtx, Y, pMac->X, TRUE); /* X := AES-128(KEY, Y) */
+            pMac->blockLen = 0;
+        }
+
+        n = AES_BLOCK_SIZE - pMac->blockLen;
+        if( n > dataLen )
+        {
+            n = dataLen;
+        }
+
+        FLib_MemCpy(&pMac->block[pMac->blockLen], (uint8_t*)pData, n);
+        pMac->blockLen += n;
+        pData += n;
+        dataLen -= n;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Ends an AES-128-CMAC, with the subkeys K1 and K2 of the key.
+*
+********************************************************************************** */
+static void SecLib_OmacFinish(aesKeyCtx_t* pKeyCtx,
+                              aesOmacState_t* pMac,
+                              uint8_t* K1,
+                              uint8_t* K2,
+                              uint8_t* pOutput)
+{
+    uint8_t M_last[AES_BLOCK_SIZE];
+    uint8_t Y[AES_BLOCK_SIZE];
+
+    if( pMac->blockLen == AES_BLOCK_SIZE )
+    { /* last block is complete block */
+        SecLib_Xor128(pMac->block, K1, M_last);
+    }
+    else
+    {
+        SecLib_Padding(pMac->block, Y, pMac->blockLen);
+        SecLib_Xor128(Y, K2, M_last);
+    }
+
+    SecLib_Xor128(pMac->X, M_last, Y);
+    SecLib_AesBlock(pKeyCtx, Y, pOutput, TRUE);
+}
+
+/*! *********************************************************************************
+* \brief  Starts an AES-128-EAX operation: computes the nonce OMAC, which is also the
+*         initial CTR counter, and starts the header and message OMACs.
+*
+********************************************************************************** */
+static void SecLib_EaxStart(aesEaxCtx_t* pCtx,
+                            aesKeyCtx_t* pKeyCtx,
+                            const uint8_t* pNonce,
+                            uint32_t nonceLen,
+                            bool_t encrypt)
+{
+    aesOmacState_t nonceMac;
+
+    pCtx->pKeyCtx = pKeyCtx;
+    pCtx->encrypt = encrypt;
+    AES_128_CMAC_Generate_Subkey(pKeyCtx, pCtx->K1, pCtx->K2);
+
+    SecLib_OmacStart(&nonceMac, 0);
+    SecLib_OmacUpdate(pKeyCtx, &nonceMac, pNonce, nonceLen);
+    SecLib_OmacFinish(pKeyCtx, &nonceMac, pCtx->K1, pCtx->K2, pCtx->nonceMac);
+    FLib_MemCpy(pCtx->counter, pCtx->nonceMac, AES_BLOCK_SIZE);
+
+    SecLib_OmacStart(&pCtx->headerMac, 1);
+    SecLib_OmacStart(&pCtx->dataMac, 2);
+    pCtx->keyStreamUsed = AES_BLOCK_SIZE;
+}
+
+/*! *********************************************************************************
+* \brief  Encrypts or decrypts a piece of an AES-128-EAX message, in one pass with the
+*         OMAC of the ciphertext. The input and output may be the same buffer.
+*
+********************************************************************************** */
+static void SecLib_EaxCrypt(aesEaxCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t inputLen,
+                            uint8_t* pOutput)
+{
+    uint32_t n;
+    uint32_t i;
+
+    while( inputLen )
+    {
+        if( pCtx->keyStreamUsed == AES_BLOCK_SIZE )
+        {
+            SecLib_AesBlock(pCtx->pKeyCtx, pCtx->counter, pCtx->keyStream, TRUE);
+            AES_128_IncrementCounter(pCtx->counter);
+            pCtx->keyStreamUsed = 0;
+        }
+
+        n = AES_BLOCK_SIZE - pCtx->keyStreamUsed;
+        if( n > inputLen )
+        {
+            n = inputLen;
+        }
+
+        if( !pCtx->encrypt )
+        {
+            SecLib_OmacUpdate(pCtx->pKeyCtx, &pCtx->dataMac, pInput, n);
+        }
+
+        for( i = 0; i < n; i++ )
+        {
+            pOutput[i] = pInput[i] ^ pCtx->keyStream[pCtx->keyStreamUsed + i];
+        }
+
+        if( pCtx->encrypt )
+        {
+            SecLib_OmacUpdate(pCtx->pKeyCtx, &pCtx->dataMac, pOutput, n);
+        }
+
+        pCtx->keyStreamUsed += n;
+        pInput += n;
+        pOutput += n;
+        inputLen -= n;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Ends an AES-128-EAX operation: the tag is written when encrypting and
+*         checked when decrypting. The EAX context is cleared.
+*
+********************************************************************************** */
+static secResultType_t SecLib_EaxFinish(aesEaxCtx_t* pCtx,
+                                        uint8_t* pTag)
+{
+    uint8_t tag[AES_BLOCK_SIZE];
+    uint8_t mac[AES_BLOCK_SIZE];
+    uint8_t diff = 0;
+    uint32_t i;
 
-    buf = MEM_BufferAlloc(buf_len);
+    SecLib_OmacFinish(pCtx->pKeyCtx, &pCtx->headerMac, pCtx->K1, pCtx->K2, tag);
+    SecLib_OmacFinish(pCtx->pKeyCtx, &pCtx->dataMac, pCtx->K1, pCtx->K2, mac);
+    SecLib_XorN(tag, mac, AES_BLOCK_SIZE);
+    SecLib_XorN(tag, pCtx->nonceMac, AES_BLOCK_SIZE);
 
-    if( buf == NULL )
+    if( pCtx->encrypt )
     {
-        status = gSecAllocError_c;
+        FLib_MemCpy(pTag, tag, AES_BLOCK_SIZE);
     }
     else
     {
-        FLib_MemSet(buf, 0, 15);
-        
-        buf[15] = 0;
-        FLib_MemCpy((buf + 16), pNonce, nonceLen);
-        AES_128_CMAC(buf, 16 + nonceLen, pKey, nonce_mac);
-        
-        buf[15] = 1;
-        FLib_MemCpy((buf + 16), pHeader, headerLen);
-        AES_128_CMAC(buf, 16 + headerLen, pKey, hdr_mac);
-        
-        /* keep the original value of nonce_mac, because AES_128_CTR will increment it */
-        FLib_MemCpy(tempBuff, nonce_mac, nonceLen);
-        
-        AES_128_CTR(pInput, inputLen, tempBuff, pKey, pOutput);
-        
-        buf[15] = 2;
-        FLib_MemCpy((buf + 16), pOutput, inputLen);
-        AES_128_CMAC(buf, 16 + inputLen, pKey, data_mac);
-        
-        for (i = 0; i < AES_BLOCK_SIZE; i++)
+        for( i = 0; i < AES_BLOCK_SIZE; i++ )
         {
-            pTag[i] = nonce_mac[i] ^ data_mac[i] ^ hdr_mac[i];
+            diff |= tag[i] ^ pTag[i];
         }
-        
-        MEM_BufferFree(buf);
     }
 
-    return status;
+    FLib_MemSet(pCtx, 0, sizeof(aesEaxCtx_t));
+
+    return diff ? gSecError_c : gSecSuccess_c;
 }
 
 /*! *********************************************************************************
-* \brief  This function performs AES-128-EAX decryption on a message block.
-*
-* \param[in]  pInput Pointer to the location of the input message.
-*
-* \param[in]  inputLen Length of the input message in bytes.
-*
-* \param[in]  pNonce Pointer to the location of the nonce.
+* \brief  AES-128-CCM and CCM* (RFC 3610, IEEE 802.15.4), with the key of an AES key
+*         context. The CBC-MAC and the CTR blocks are interleaved in one pass over the
+*         message. The MAC state, the counter and the key stream are word aligned, so
+*         the MMCAU never needs a copy of the unaligned input or output.
 *
-* \param[in]  nonceLen Nonce length in bytes.
-*
-* \param[in]  pHeader Pointer to the location of header.
-*
-* \param[in]  headerLen Header length in bytes.
-*
-* \param[in]  pKey Pointer to the location of the 128-bit key.
-*
-* \param[out]  pOutput Pointer to the location to store the 16-byte authentication code.
-*
-* \param[out]  pTag Pointer to the location to store the 128-bit tag.
+* \param [in]    macSize    0 (CCM*, no authentication), 4, 6, 8, 10, 12, 14 or 16.
+* \param [in]    encrypt    TRUE to encrypt and generate pCbcMac, FALSE to decrypt
+*                           and check pCbcMac.
 *
 ********************************************************************************** */
-secResultType_t AES_128_EAX_Decrypt(uint8_t* pInput,
-                                    uint32_t inputLen,
-                                    uint8_t* pNonce,
-                                    uint32_t nonceLen,
-                                    uint8_t* pHeader,
-                                    uint8_t headerLen,
-                                    uint8_t* pKey,
-                                    uint8_t* pOutput,
-                                    uint8_t* pTag)
+static secResultType_t SecLib_AesCcm(aesKeyCtx_t* pCtx,
+                                     const uint8_t* pInput,
+                                     uint32_t inputLen,
+                                     const uint8_t* pAuthData,
+                                     uint32_t authDataLen,
+                                     const uint8_t* pNonce,
+                                     uint8_t nonceSize,
+                                     uint8_t* pOutput,
+                                     uint8_t* pCbcMac,
+                                     uint8_t macSize,
+                                     bool_t encrypt)
 {
-    uint8_t *buf;
-    uint32_t buf_len;
-    uint8_t nonce_mac[AES_BLOCK_SIZE] = {0};
-    uint8_t hdr_mac[AES_BLOCK_SIZE] = {0};
-    uint8_t data_mac[AES_BLOCK_SIZE] = {0};
-    secResultType_t status = gSecSuccess_c;
-    uint32_t i;
+#if FSL_FEATURE_SOC_LTC_COUNT
+    status_t ltcStatus;
 
-    if( nonceLen > inputLen )
+    if( encrypt )
     {
-        buf_len = nonceLen;
+        ltcStatus = LTC_AES_EncryptTagCcm(LTC0, pInput, pOutput, inputLen, pNonce, nonceSize, pAuthData, authDataLen, (uint8_t*)pCtx->key, AES_BLOCK_SIZE, pCbcMac, macSize);
     }
     else
     {
-        buf_len = inputLen;
+        ltcStatus = LTC_AES_DecryptTagCcm(LTC0, pInput, pOutput, inputLen, pNonce, nonceSize, pAuthData, authDataLen, (uint8_t*)pCtx->key, AES_BLOCK_SIZE, pCbcMac, macSize);
     }
 
-    if( headerLen > buf_len )
-    {
-        buf_len = headerLen;
-    }
+    return (kStatus_Success == ltcStatus) ? gSecSuccess_c : gSecError_c;
 
-    buf_len += 16U;
+#else
+    uint32_t mac[AES_BLOCK_SIZE/sizeof(uint32_t)];
+    uint32_t block[AES_BLOCK_SIZE/sizeof(uint32_t)];
+    uint32_t counter[AES_BLOCK_SIZE/sizeof(uint32_t)];
+    uint32_t keyStream[AES_BLOCK_SIZE/sizeof(uint32_t)];
+    uint8_t* pMac = (uint8_t*)mac;
+    uint8_t* pBlock = (uint8_t*)block;
+    uint8_t* pCounter = (uint8_t*)counter;
+    uint8_t* pKeyStream = (uint8_t*)keyStream;
+    uint8_t* pOutputStart = pOutput;
+    uint32_t outputLen = inputLen;
+    uint8_t lenSize = 15 - nonceSize;       /* L */
+    uint8_t lenField[6];
+    uint8_t pos = 0;
+    uint8_t diff = 0;
+    uint32_t n;
+    uint32_t i;
 
-    buf = MEM_BufferAlloc(buf_len);
+    if( (nonceSize < 7) || (nonceSize > 13) || (macSize > 16) || (macSize & 1) || (macSize == 2) ||
+        ((lenSize < 4) && (inputLen >> (8 * lenSize))) )
+    {
+        return gSecError_c;
+    }
 
-    if( buf == NULL )
+    /* X1 := E(K, B0), B0 := flags | nonce | l(m) */
+    pBlock[0] = ((authDataLen ? 1 : 0) << 6) | ((macSize ? (macSize - 2) / 2 : 0) << 3) | (lenSize - 1);
+    FLib_MemCpy(&pBlock[1], (uint8_t*)pNonce, nonceSize);
+    for( i = 0; i < lenSize; i++ )
     {
-        status = gSecAllocError_c;
+        pBlock[AES_BLOCK_SIZE - 1 - i] = (i < sizeof(uint32_t)) ? (uint8_t)(inputLen >> (8 * i)) : 0;
     }
-    else
+    SecLib_AesBlock(pCtx, pBlock, pMac, TRUE);
+
+    /* Authentication data, prefixed by its length and padded with zeros */
+    if( authDataLen )
     {
-        FLib_MemSet(buf, 0, 15);
-        
-        buf[15] = 0;
-        FLib_MemCpy((buf + 16), pNonce, nonceLen);
-        AES_128_CMAC(buf, 16 + nonceLen, pKey, nonce_mac);
-        
-        buf[15] = 1;
-        FLib_MemCpy((buf + 16), pHeader, headerLen);
-        AES_128_CMAC(buf, 16 + headerLen, pKey, hdr_mac);
-        
-        buf[15] = 2;
-        FLib_MemCpy((buf + 16), pInput, inputLen);
-        AES_128_CMAC(buf, 16 + inputLen, pKey, data_mac);
-        
-        MEM_BufferFree(buf);
-        
-        for (i = 0; i < AES_BLOCK_SIZE; i++)
+        if( authDataLen < 0xFF00 )
         {
-            if (pTag[i] != (nonce_mac[i] ^ data_mac[i] ^ hdr_mac[i]))
-            {
-                status = gSecError_c;
-                break;
-            }
+            lenField[0] = (uint8_t)(authDataLen >> 8);
+            lenField[1] = (uint8_t)authDataLen;
+            n = 2;
         }
-        
-        if( gSecSuccess_c == status )
+        else
         {
-            AES_128_CTR(pInput, inputLen, nonce_mac, pKey, pOutput);
+            lenField[0] = 0xFF;
+            lenField[1] = 0xFE;
+            lenField[2] = (uint8_t)(authDataLen >> 24);
+            lenField[3] = (uint8_t)(authDataLen >> 16);
+            lenField[4] = (uint8_t)(authDataLen >> 8);
+            lenField[5] = (uint8_t)authDataLen;
+            n = 6;
         }
+        SecLib_CcmMacUpdate(pCtx, pMac, pBlock, &pos, lenField, n);
+        SecLib_CcmMacUpdate(pCtx, pMac, pBlock, &pos, pAuthData, authDataLen);
+        SecLib_CcmMacPad(pCtx, pMac, pBlock, &pos);
     }
 
-    return status;
-}
+    /* A1 := flags | nonce | 1 */
+    pCounter[0] = lenSize - 1;
+    FLib_MemCpy(&pCounter[1], (uint8_t*)pNonce, nonceSize);
+    FLib_MemSet(&pCounter[1 + nonceSize], 0, lenSize - 1);
+    pCounter[AES_BLOCK_SIZE - 1] = 1;
 
-/*! *********************************************************************************
-* \brief  This function performs AES-128-CCM on a message block.
-*
-* \param[in]  pInput       Pointer to the location of the input message (plaintext or cyphertext).
-*
-* \param[in]  inputLen     Length of the input plaintext in bytes when encrypting.
-*                          Length of the input cypertext without the MAC length when decrypting.
-* 
-* \param[in]  pAuthData    Pointer to the additional authentication data.
-*
-* \param[in]  authDataLen  Length of additional authentication data.
-*
-* \param[in]  pNonce       Pointer to the Nonce.
-*
-* \param[in]  nonceSize    The size of the nonce (7-13).
-*
-* \param[in]  pKey         Pointer to the location of the 128-bit key.
-*
-* \param[out]  pOutput     Pointer to the location to store the plaintext data when decrypting.
-*                          Pointer to the location to store the cyphertext data when encrypting.
-*
-* \param[out]  pCbcMac     Pointer to the location to store the Message Authentication Code (MAC) when encrypting.
-*                          Pointer to the location where the received MAC can be found when decrypting.
-*
-* \param[out]  macSize     The size of the MAC.
-*
-* \param[out]  flags       Select encrypt/decrypt operations (gSecLib_CCM_Encrypt_c, gSecLib_CCM_Decrypt_c)
-*
-* \return 0 if encryption/decryption was successfull; otherwise, error code for failed encryption/decryption
-*
-* \remarks At decryption, MIC fail is also signaled by returning a non-zero value.
-*
-********************************************************************************** */
-uint8_t AES_128_CCM(uint8_t* pInput,
-                    uint16_t inputLen,
-                    uint8_t* pAuthData,
-                    uint16_t authDataLen,
-                    uint8_t* pNonce,
-                    uint8_t  nonceSize,
-                    uint8_t* pKey,
-                    uint8_t* pOutput,
-                    uint8_t* pCbcMac,
-                    uint8_t  macSize,
-                    uint32_t flags)
-{
-    uint8_t status;
+    /* Message: Ci := Pi ^ E(K, Ai), interleaved with the CBC-MAC of Pi */
+    while( inputLen )
+    {
+        n = (inputLen < AES_BLOCK_SIZE) ? inputLen : AES_BLOCK_SIZE;
+        SecLib_AesBlock(pCtx, pCounter, pKeyStream, TRUE);
+        AES_128_IncrementCounter(pCounter);
 
-    SecLib_DisallowToSleep();
-    SECLIB_MUTEX_LOCK();
+        if( encrypt )
+        {
+            SecLib_CcmMacUpdate(pCtx, pMac, pBlock, &pos, pInput, n);
+        }
+        for( i = 0; i < n; i++ )
+        {
+            pOutput[i] = pInput[i] ^ pKeyStream[i];
+        }
+        if( !encrypt )
+        {
+            SecLib_CcmMacUpdate(pCtx, pMac, pBlock, &pos, pOutput, n);
+        }
+        SecLib_CcmMacPad(pCtx, pMac, pBlock, &pos);
 
-#if FSL_FEATURE_SOC_LTC_COUNT
-    if( flags & gSecLib_CCM_Decrypt_c )
-    {
-        status = LTC_AES_DecryptTagCcm(LTC0, pInput, pOutput, inputLen, pNonce, nonceSize, pAuthData, authDataLen, pKey, AES_BLOCK_SIZE, pCbcMac, macSize);
+        pInput += n;
+        pOutput += n;
+        inputLen -= n;
     }
-    else
+
+    /* The MIC is T ^ E(K, A0), A0 := flags | nonce | 0 */
+    FLib_MemSet(&pCounter[1 + nonceSize], 0, lenSize);
+    SecLib_AesBlock(pCtx, pCounter, pKeyStream, TRUE);
+
+    for( i = 0; i < macSize; i++ )
     {
-        status = LTC_AES_EncryptTagCcm(LTC0, pInput, pOutput, inputLen, pNonce, nonceSize, pAuthData, authDataLen, pKey, AES_BLOCK_SIZE, pCbcMac, macSize);
+        if( encrypt )
+        {
+            pCbcMac[i] = pMac[i] ^ pKeyStream[i];
+        }
+        else
+        {
+            diff |= pCbcMac[i] ^ pMac[i] ^ pKeyStream[i];
+        }
     }
 
-#else
-        status = sw_AES128_CCM(pInput, inputLen, pAuthData, authDataLen, pNonce, nonceSize, pKey, pOutput, pCbcMac, macSize, flags);
-#endif
-
-    SECLIB_MUTEX_UNLOCK();
-    SecLib_AllowToSleep();
+    if( diff )
+    {
+        FLib_MemSet(pOutputStart, 0, outputLen);
+    }
+    FLib_MemSet(mac, 0, sizeof(mac));
+    FLib_MemSet(block, 0, sizeof(block));
+    FLib_MemSet(keyStream, 0, sizeof(keyStream));
 
-    return status;
+    return diff ? gSecError_c : gSecSuccess_c;
+#endif /* FSL_FEATURE_SOC_LTC_COUNT */
 }
 
+#if !(FSL_FEATURE_SOC_LTC_COUNT)
 /*! *********************************************************************************
-* \brief  This function calculates XOR of individual byte pairs in two uint8_t arrays.
-*         pDst[i] := pDst[i] ^ pSrc[i] for i=0 to n-1
-*
-* \param[in, out]  pDst First byte array operand for XOR and destination byte array
+* \brief  Adds data to the CCM CBC-MAC. The bytes are XORed with the MAC state X into
+*         the next block, which is encrypted into X each time it is complete.
 *
-* \param[in]  pSrc Second byte array operand for XOR
-*
-* \param[in]  n  Length of the byte arrays which will be XORed
+* \param [in, out] pPos    Number of bytes already in the next block.
 *
 ********************************************************************************** */
-void SecLib_XorN(uint8_t* pDst,
-                 uint8_t* pSrc,
-                 uint8_t n)
+static void SecLib_CcmMacUpdate(aesKeyCtx_t* pCtx,
+                                uint8_t* pMac,
+                                uint8_t* pBlock,
+                                uint8_t* pPos,
+                                const uint8_t* pData,
+                                uint32_t dataLen)
 {
-    while( n )
+    while( dataLen-- )
     {
-        *pDst = *pDst ^ *pSrc;
-        pDst = pDst + 1;
-        pSrc = pSrc + 1;
-        n--;
+        pBlock[*pPos] = pMac[*pPos] ^ *pData++;
+        if( ++(*pPos) == AES_BLOCK_SIZE )
+        {
+            SecLib_AesBlock(pCtx, pBlock, pMac, TRUE);
+            *pPos = 0;
+        }
     }
 }
 
 /*! *********************************************************************************
-*************************************************************************************
-* Private functions
-*************************************************************************************
-********************************************************************************** */
-
-#if !(FSL_FEATURE_SOC_LTC_COUNT)
-/*! *********************************************************************************
-* \brief  Increments the value of a given counter vector.
-*
-* \param [in/out]     ctr         Counter.
-*
-* \remarks
+* \brief  Pads the next block of the CCM CBC-MAC with zeros, and encrypts it into X.
 *
 ********************************************************************************** */
-static void AES_128_IncrementCounter(uint8_t* ctr)
+static void SecLib_CcmMacPad(aesKeyCtx_t* pCtx,
+                             uint8_t* pMac,
+                             uint8_t* pBlock,
+                             uint8_t* pPos)
 {
-    uint32_t i;
-    uint64_t tempLow;
-    uuint128_t tempCtr;
-
-    for(i=0;i<AES_BLOCK_SIZE;i++)
-    {
-        tempCtr.u8[AES_BLOCK_SIZE-i-1] = ctr[i];
-    }
-
-    tempLow = tempCtr.u64[0];
-    tempCtr.u64[0]++;
-
-    if(tempLow > tempCtr.u64[0])
-    {
-        tempCtr.u64[1]++;
-    }
-
-    for(i=0;i<AES_BLOCK_SIZE;i++)
+    if( *pPos )
     {
-        ctr[i] = tempCtr.u8[AES_BLOCK_SIZE-i-1];
+        FLib_MemCpy(&pBlock[*pPos], &pMac[*pPos], AES_BLOCK_SIZE - *pPos);
+        SecLib_AesBlock(pCtx, pBlock, pMac, TRUE);
+        *pPos = 0;
     }
 }
 #endif /* !(FSL_FEATURE_SOC_LTC_COUNT) */
@@ -1281,7 +2100,7 @@ static void AES_128_IncrementCounter(uint8_t* ctr)
 /*! *********************************************************************************
 * \brief  Generates the two subkeys that correspond two an AES key
 *
-* \param [in]    key        AES Key.
+* \param [in]    pCtx       AES key context.
 *
 * \param [out]   K1         First subkey.
 *
@@ -1290,7 +2109,7 @@ static void AES_128_IncrementCounter(uint8_t* ctr)
 * \remarks   This is public open source code! Terms of use must be checked before use!
 *
 ********************************************************************************** */
-static void AES_128_CMAC_Generate_Subkey(uint8_t *key,
+static void AES_128_CMAC_Generate_Subkey(aesKeyCtx_t *pCtx,
                                          uint8_t *K1,
                                          uint8_t *K2)
 {
@@ -1308,7 +2127,7 @@ static void AES_128_CMAC_Generate_Subkey(uint8_t *key,
         Z[i] = 0;
     }
 
-    AES_128_Encrypt(Z,key,L);
+    SecLib_AesBlock(pCtx, Z, L, TRUE);
 
     if ( (L[0] & 0x80) == 0 )
     {
@@ -1668,34 +2487,10 @@ void SHA256_Hash(sha256Context_t* context, uint8_t* pData, uint32_t numBytes)
 ********************************************************************************** */
 void HMAC_SHA256_Init(HMAC_SHA256_context_t* context, uint8_t* pKey, uint32_t keyLen) 
 {
-    uint8_t i;
-
-    if( keyLen > SHA256_BLOCK_SIZE )    
-    {
-        SHA256_Hash(&context->shaCtx, pKey, keyLen);
-        pKey = (uint8_t*)context->shaCtx.hash;
-        keyLen = SHA256_HASH_SIZE;
-    }
-
-    /* Create i_pad */
-    for(i=0; i<keyLen; i++)
-    {
-        context->pad[i] = pKey[i] ^ gHmacIpad_c;
-    }
-
-    for(i=keyLen; i<SHA256_BLOCK_SIZE; i++)
-    {
-        context->pad[i] = gHmacIpad_c;
-    }
-    /* start hashing of the i_key_pad */
-    SHA256_Init(&context->shaCtx);
-    SHA256_HashUpdate(&context->shaCtx, context->pad, SHA256_BLOCK_SIZE);
+    hmacSha256KeyCtx_t keyCtx;
 
-    /* create o_pad by xor-ing pad[i] with 0x36 ^ 0x5C: */
-    for(i=0; i<SHA256_BLOCK_SIZE; i++)
-    {
-        context->pad[i] ^= (gHmacIpad_c^gHmacOpad_c);
-    }
+    HMAC_SHA256_KeyInit(&keyCtx, pKey, keyLen);
+    HMAC_SHA256_CtxInit(context, &keyCtx);
 }
 
 /*! *********************************************************************************
@@ -1726,9 +2521,8 @@ void HMAC_SHA256_Finish(HMAC_SHA256_context_t* context)
     /* finalize the hash of the i_key_pad and message */
     SHA256_HashFinish(&context->shaCtx, NULL, 0);
     FLib_MemCpy(hash1, context->shaCtx.hash, SHA256_HASH_SIZE);
-    /* perform hash of the o_key_pas and hash1 */
-    SHA256_Init(&context->shaCtx);
-    SHA256_HashUpdate(&context->shaCtx, context->pad, SHA256_BLOCK_SIZE);
+    /* perform hash of the o_key_pad, already hashed, and hash1 */
+    SHA256_Resume(&context->shaCtx, context->outerHash);
     SHA256_HashFinish(&context->shaCtx, hash1, SHA256_HASH_SIZE);
 }
 
@@ -1751,6 +2545,96 @@ void HMAC_SHA256(HMAC_SHA256_context_t* context, uint8_t* pKey, uint32_t keyLen,
     HMAC_SHA256_Finish(context);
 }
 
+/*! *********************************************************************************
+* \brief  This function loads an HMAC-SHA256 key into a key context: the i_key_pad and
+*         o_key_pad blocks are hashed once, and their SHA256 states are kept.
+*
+* \param [out]   pKeyCtx    Pointer to the HMAC key context
+* \param [in]    pKey       Pointer to the key
+* \param [in]    keyLen     Length of the key
+*
+********************************************************************************** */
+void HMAC_SHA256_KeyInit(hmacSha256KeyCtx_t* pKeyCtx, uint8_t* pKey, uint32_t keyLen)
+{
+    sha256Context_t shaCtx;
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    uint8_t i;
+
+    if( keyLen > SHA256_BLOCK_SIZE )
+    {
+        SHA256_Hash(&shaCtx, pKey, keyLen);
+        pKey = (uint8_t*)shaCtx.hash;
+        keyLen = SHA256_HASH_SIZE;
+    }
+
+    /* Create i_pad */
+    for(i=0; i<keyLen; i++)
+    {
+        pad[i] = pKey[i] ^ gHmacIpad_c;
+    }
+
+    for(i=keyLen; i<SHA256_BLOCK_SIZE; i++)
+    {
+        pad[i] = gHmacIpad_c;
+    }
+    /* hash the i_key_pad */
+    SHA256_Init(&shaCtx);
+    SHA256_hash_n(pad, 1, shaCtx.hash);
+    FLib_MemCpy(pKeyCtx->innerHash, shaCtx.hash, SHA256_HASH_SIZE);
+
+    /* create o_pad by xor-ing pad[i] with 0x36 ^ 0x5C, and hash it */
+    for(i=0; i<SHA256_BLOCK_SIZE; i++)
+    {
+        pad[i] ^= (gHmacIpad_c^gHmacOpad_c);
+    }
+    SHA256_Init(&shaCtx);
+    SHA256_hash_n(pad, 1, shaCtx.hash);
+    FLib_MemCpy(pKeyCtx->outerHash, shaCtx.hash, SHA256_HASH_SIZE);
+
+    /* do not leave the key on the stack */
+    FLib_MemSet(pad, 0, SHA256_BLOCK_SIZE);
+    FLib_MemSet(&shaCtx, 0, sizeof(shaCtx));
+}
+
+/*! *********************************************************************************
+* \brief  This function starts an HMAC with the key of a key context.
+*
+* \param [out]   context    Pointer to the HMAC context data
+* \param [in]    pKeyCtx    Pointer to the HMAC key context
+*
+********************************************************************************** */
+void HMAC_SHA256_CtxInit(HMAC_SHA256_context_t* context, const hmacSha256KeyCtx_t* pKeyCtx)
+{
+    SHA256_Resume(&context->shaCtx, pKeyCtx->innerHash);
+    FLib_MemCpy(context->outerHash, (void*)pKeyCtx->outerHash, SHA256_HASH_SIZE);
+}
+
+/*! *********************************************************************************
+* \brief  This function computes the HMAC of the concatenation of several messages,
+*         with the key of a key context.
+*
+* \param [in]    pKeyCtx    Pointer to the HMAC key context
+* \param [in]    ppMsg      Array of pointers to the messages
+* \param [in]    pMsgLen    Array of the message lengths
+* \param [in]    msgCount   Number of messages
+* \param [out]   pOutput    Pointer to the location to store the 32-byte MAC
+*
+********************************************************************************** */
+void HMAC_SHA256_CtxMac(const hmacSha256KeyCtx_t* pKeyCtx, uint8_t** ppMsg, const uint32_t* pMsgLen,
+                        uint32_t msgCount, uint8_t* pOutput)
+{
+    HMAC_SHA256_context_t context;
+    uint32_t i;
+
+    HMAC_SHA256_CtxInit(&context, pKeyCtx);
+    for( i = 0; i < msgCount; i++ )
+    {
+        HMAC_SHA256_Update(&context, ppMsg[i], pMsgLen[i]);
+    }
+    HMAC_SHA256_Finish(&context);
+    FLib_MemCpy(pOutput, context.shaCtx.hash, SHA256_HASH_SIZE);
+}
+
 #if mDbgRevertKeys_d
 static ecdhPublicKey_t mReversedPublicKey;
 static ecdhPrivateKey_t mReversedPrivateKey;
@@ -1932,3 +2816,17 @@ static void SHA256_hash_n(uint8_t* pData, uint32_t nBlk, uint32_t* pHash)
         SecLib_AllowToSleep();
     }
 }
+
+/*! *********************************************************************************
+* \brief  This function resumes a SHA256 from the state saved after its first block
+*
+* \param [out]   context    Pointer to the SHA256 context data
+* \param [in]    pHash      Pointer to the SHA256 state after one block
+*
+********************************************************************************** */
+static void SHA256_Resume(sha256Context_t* context, const uint32_t* pHash)
+{
+    FLib_MemCpy(context->hash, (void*)pHash, SHA256_HASH_SIZE);
+    context->totalBytes = SHA256_BLOCK_SIZE;
+    context->bytes = 0;
+}
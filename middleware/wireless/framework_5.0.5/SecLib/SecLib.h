@@ -81,6 +81,35 @@ typedef enum
     gSecError_c
 } secResultType_t;
 
+/* AES-128 key context: the key and its schedule, expanded once by AES_128_CtxInit() and
+   used by all the AES_128_Ctx operations */
+typedef struct aesKeyCtx_tag{
+    uint32_t keySchedule[44];
+    uint32_t key[AES_BLOCK_SIZE/sizeof(uint32_t)];
+}aesKeyCtx_t;
+
+/* AES-128-CMAC (OMAC1) state of a message processed in pieces */
+typedef struct aesOmacState_tag{
+    uint8_t X[AES_BLOCK_SIZE];      /* chaining value */
+    uint8_t block[AES_BLOCK_SIZE];  /* last block, processed when the message continues */
+    uint8_t blockLen;
+}aesOmacState_t;
+
+/* AES-128-EAX context of a message encrypted or decrypted in pieces by
+   AES_128_EaxUpdateAAD() and AES_128_EaxUpdate() */
+typedef struct aesEaxCtx_tag{
+    aesKeyCtx_t*   pKeyCtx;
+    aesOmacState_t headerMac;
+    aesOmacState_t dataMac;
+    uint8_t        K1[AES_BLOCK_SIZE];
+    uint8_t        K2[AES_BLOCK_SIZE];
+    uint8_t        nonceMac[AES_BLOCK_SIZE];
+    uint8_t        counter[AES_BLOCK_SIZE];
+    uint8_t        keyStream[AES_BLOCK_SIZE];
+    uint8_t        keyStreamUsed;
+    bool_t         encrypt;
+}aesEaxCtx_t;
+
 typedef struct sha1Context_tag{
     uint32_t hash[SHA1_HASH_SIZE/sizeof(uint32_t)];
     uint8_t  buffer[SHA1_BLOCK_SIZE];
@@ -95,9 +124,15 @@ typedef struct sha256Context_tag{
     uint8_t  bytes;
 }sha256Context_t;
 
+/* HMAC-SHA256 key, kept as the SHA256 states after the i_key_pad and o_key_pad blocks */
+typedef struct hmacSha256KeyCtx_tag{
+    uint32_t innerHash[SHA256_HASH_SIZE/sizeof(uint32_t)];
+    uint32_t outerHash[SHA256_HASH_SIZE/sizeof(uint32_t)];
+}hmacSha256KeyCtx_t;
+
 typedef struct HMAC_SHA256_context_tag{
     sha256Context_t shaCtx;
-    uint8_t pad[SHA256_BLOCK_SIZE];
+    uint32_t outerHash[SHA256_HASH_SIZE/sizeof(uint32_t)];
 }HMAC_SHA256_context_t;
 
 typedef enum ecdhStatus_tag {
@@ -494,6 +529,284 @@ uint8_t AES_128_CCM(uint8_t* pInput,
                     uint8_t  macSize,
                     uint32_t flags);
 
+/*! *********************************************************************************
+* \brief  This function initializes an AES-128 key context: the key is expanded once,
+*         for all the AES_128_Ctx operations using the context.
+*
+* \param[out] pCtx Pointer to the key context.
+*
+* \param[in]  pKey Pointer to the location of the 128-bit key.
+*
+********************************************************************************** */
+void AES_128_CtxInit(aesKeyCtx_t* pCtx,
+                     const uint8_t* pKey);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-ECB encryption on 16-byte blocks, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input blocks.
+*
+* \param[in]  numBlocks Number of 16-byte blocks.
+*
+* \param[out]  pOutput Pointer to the location to store the ciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxECB_Encrypt(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t numBlocks,
+                            uint8_t* pOutput);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-ECB decryption on 16-byte blocks, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input blocks.
+*
+* \param[in]  numBlocks Number of 16-byte blocks.
+*
+* \param[out]  pOutput Pointer to the location to store the deciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxECB_Decrypt(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t numBlocks,
+                            uint8_t* pOutput);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CBC encryption on a message block, with a key
+*         context. A last block shorter than 16 bytes is zero padded, and only
+*         inputLen bytes are output.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Input message length in bytes.
+*
+* \param[in, out]  pInitVector Pointer to the location of the 128-bit initialization
+*                  vector. It is set to the last ciphered block, to chain the next call.
+*
+* \param[out]  pOutput Pointer to the location to store the ciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxCBC_Encrypt(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t inputLen,
+                            uint8_t* pInitVector,
+                            uint8_t* pOutput);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CBC decryption on a message block, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Input message length in bytes, a multiple of 16.
+*
+* \param[in, out]  pInitVector Pointer to the location of the 128-bit initialization
+*                  vector. It is set to the last input block, to chain the next call.
+*
+* \param[out]  pOutput Pointer to the location to store the deciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxCBC_Decrypt(aesKeyCtx_t* pCtx,
+                            const uint8_t* pInput,
+                            uint32_t inputLen,
+                            uint8_t* pInitVector,
+                            uint8_t* pOutput);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CTR encryption on a message block, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Input message length in bytes.
+*
+* \param[in, out]  pCounter Pointer to the location of the 128-bit counter. It is
+*                  incremented once for each block, the last one included.
+*
+* \param[out]  pOutput Pointer to the location to store the ciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxCTR(aesKeyCtx_t* pCtx,
+                    const uint8_t* pInput,
+                    uint32_t inputLen,
+                    uint8_t* pCounter,
+                    uint8_t* pOutput);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-OFB encryption on a message block, with a key
+*         context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message.
+*
+* \param[in]  inputLen Input message length in bytes.
+*
+* \param[in, out]  pInitVector Pointer to the location of the 128-bit initialization
+*                  vector. It is set to the last key stream block.
+*
+* \param[out]  pOutput Pointer to the location to store the ciphered output.
+*
+********************************************************************************** */
+void AES_128_CtxOFB(aesKeyCtx_t* pCtx,
+                    const uint8_t* pInput,
+                    uint32_t inputLen,
+                    uint8_t* pInitVector,
+                    uint8_t* pOutput);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CMAC on a message block, with a key context.
+*
+* \param[in]  pCtx Pointer to the key context.
+*
+* \param[in]  pInput Pointer to the location of the input message, MSB first.
+*
+* \param[in]  inputLen Length of the input message in bytes.
+*
+* \param[out]  pOutput Pointer to the location to store the 16-byte authentication code.
+*
+********************************************************************************** */
+void AES_128_CtxCMAC(aesKeyCtx_t* pCtx,
+                     const uint8_t* pInput,
+                     uint32_t inputLen,
+                     uint8_t* pOutput);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-EAX encryption on a message block, with a key
+*         context. The parameters are the ones of AES_128_EAX_Encrypt().
+*
+********************************************************************************** */
+secResultType_t AES_128_CtxEAX_Encrypt(aesKeyCtx_t* pCtx,
+                                       uint8_t* pInput,
+                                       uint32_t inputLen,
+                                       uint8_t* pNonce,
+                                       uint32_t nonceLen,
+                                       uint8_t* pHeader,
+                                       uint8_t headerLen,
+                                       uint8_t* pOutput,
+                                       uint8_t* pTag);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-EAX decryption on a message block, with a key
+*         context. The parameters are the ones of AES_128_EAX_Decrypt().
+*
+********************************************************************************** */
+secResultType_t AES_128_CtxEAX_Decrypt(aesKeyCtx_t* pCtx,
+                                       uint8_t* pInput,
+                                       uint32_t inputLen,
+                                       uint8_t* pNonce,
+                                       uint32_t nonceLen,
+                                       uint8_t* pHeader,
+                                       uint8_t headerLen,
+                                       uint8_t* pOutput,
+                                       uint8_t* pTag);
+
+/*! *********************************************************************************
+* \brief  This function starts an AES-128-EAX encryption or decryption of a message
+*         processed in pieces. No memory is allocated: the whole state is kept in
+*         the EAX context.
+*
+* \param[out] pCtx Pointer to the EAX context.
+*
+* \param[in]  pKeyCtx Pointer to the key context, initialized by AES_128_CtxInit().
+*             It must be kept until AES_128_EaxFinish().
+*
+* \param[in]  pNonce Pointer to the location of the nonce.
+*
+* \param[in]  nonceLen Nonce length in bytes.
+*
+* \param[in]  encrypt TRUE to encrypt, FALSE to decrypt.
+*
+********************************************************************************** */
+void AES_128_EaxInit(aesEaxCtx_t* pCtx,
+                     aesKeyCtx_t* pKeyCtx,
+                     const uint8_t* pNonce,
+                     uint32_t nonceLen,
+                     bool_t encrypt);
+
+/*! *********************************************************************************
+* \brief  This function adds a piece of the header (the authenticated data) to an
+*         AES-128-EAX operation. The header and message pieces may be interleaved.
+*
+* \param[in]  pCtx Pointer to the EAX context.
+*
+* \param[in]  pHeader Pointer to the location of the header piece.
+*
+* \param[in]  headerLen Header piece length in bytes.
+*
+********************************************************************************** */
+void AES_128_EaxUpdateAAD(aesEaxCtx_t* pCtx,
+                          const uint8_t* pHeader,
+                          uint32_t headerLen);
+
+/*! *********************************************************************************
+* \brief  This function encrypts or decrypts a piece of the message of an AES-128-EAX
+*         operation. The input and output may be the same buffer.
+*
+* \param[in]  pCtx Pointer to the EAX context.
+*
+* \param[in]  pInput Pointer to the location of the input piece.
+*
+* \param[in]  inputLen Input piece length in bytes.
+*
+* \param[out]  pOutput Pointer to the location to store the output piece.
+*
+* \remarks When decrypting, the output must not be used before AES_128_EaxFinish()
+*          has checked the tag.
+*
+********************************************************************************** */
+void AES_128_EaxUpdate(aesEaxCtx_t* pCtx,
+                       const uint8_t* pInput,
+                       uint32_t inputLen,
+                       uint8_t* pOutput);
+
+/*! *********************************************************************************
+* \brief  This function ends an AES-128-EAX operation and clears the EAX context.
+*
+* \param[in]  pCtx Pointer to the EAX context.
+*
+* \param[in, out]  pTag Pointer to the location of the 128-bit tag: written when
+*                  encrypting, checked when decrypting.
+*
+* \return gSecSuccess_c, or gSecError_c if the tag of a decrypted message is wrong.
+*
+********************************************************************************** */
+secResultType_t AES_128_EaxFinish(aesEaxCtx_t* pCtx,
+                                  uint8_t* pTag);
+
+/*! *********************************************************************************
+* \brief  This function performs AES-128-CCM or CCM* on a message block, with a key
+*         context. The parameters are the ones of AES_128_CCM(); the MIC length may
+*         also be 0 (encryption only). The input and output may be the same buffer.
+*
+* \return gSecSuccess_c, or gSecError_c if a parameter is invalid or if the MIC of a
+*         decrypted message is wrong. The output is then cleared.
+*
+********************************************************************************** */
+secResultType_t AES_128_CtxCCM(aesKeyCtx_t* pCtx,
+                               uint8_t* pInput,
+                               uint32_t inputLen,
+                               uint8_t* pAuthData,
+                               uint32_t authDataLen,
+                               uint8_t* pNonce,
+                               uint8_t  nonceSize,
+                               uint8_t* pOutput,
+                               uint8_t* pCbcMac,
+                               uint8_t  macSize,
+                               uint32_t flags);
+
 /*! *********************************************************************************
 * \brief  This function initializes the SHA1 context data
 *
@@ -641,6 +954,48 @@ void HMAC_SHA256(HMAC_SHA256_context_t* context,
                  uint8_t* pMsg, 
                  uint32_t msgLen);
 
+/*! *********************************************************************************
+* \brief  This function loads an HMAC-SHA256 key into a key context: the i_key_pad and
+*         o_key_pad blocks are hashed once, and their SHA256 states are kept.
+*         The key context can then be used for any number of MACs.
+*
+* \param [out]   pKeyCtx    Pointer to the HMAC key context
+* \param [in]    pKey       Pointer to the key
+* \param [in]    keyLen     Length of the key
+*
+********************************************************************************** */
+void HMAC_SHA256_KeyInit(hmacSha256KeyCtx_t* pKeyCtx,
+                         uint8_t* pKey,
+                         uint32_t keyLen);
+
+/*! *********************************************************************************
+* \brief  This function starts an HMAC with the key of a key context. No block is
+*         hashed: the HMAC continues with HMAC_SHA256_Update() and HMAC_SHA256_Finish().
+*
+* \param [out]   context    Pointer to the HMAC context data
+* \param [in]    pKeyCtx    Pointer to the HMAC key context
+*
+********************************************************************************** */
+void HMAC_SHA256_CtxInit(HMAC_SHA256_context_t* context,
+                         const hmacSha256KeyCtx_t* pKeyCtx);
+
+/*! *********************************************************************************
+* \brief  This function computes the HMAC of the concatenation of several messages,
+*         with the key of a key context.
+*
+* \param [in]    pKeyCtx    Pointer to the HMAC key context
+* \param [in]    ppMsg      Array of pointers to the messages
+* \param [in]    pMsgLen    Array of the message lengths
+* \param [in]    msgCount   Number of messages
+* \param [out]   pOutput    Pointer to the location to store the 32-byte MAC
+*
+********************************************************************************** */
+void HMAC_SHA256_CtxMac(const hmacSha256KeyCtx_t* pKeyCtx,
+                        uint8_t** ppMsg,
+                        const uint32_t* pMsgLen,
+                        uint32_t msgCount,
+                        uint8_t* pOutput);
+
 /************************************************************************************
 * Calculate XOR of individual byte pairs in two uint8_t arrays. I.e.
 * pDst[i] := pDst[i] ^ pSrc[i] for i=0 to n-1
@@ -0,0 +1,1427 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file SecLibAesBench.c
+* Host known answer tests and benchmark of the SecLib AES-128 modes.
+*
+* SecLib.c is built with the MMCAU enabled (or with the software AES when
+* FSL_FEATURE_SOC_MMCAU_COUNT is 0), the RTOS mutex and the low power votes enabled.
+* The MMCAU and sw_Aes128() are played by a reference AES-128 which counts the key
+* expansions and the blocks processed; the mutex and the low power stubs count the
+* lock acquisitions and check that the lock is never taken twice.
+*
+* check: the known answer tests of FIPS-197, SP800-38A (ECB, CBC, CTR, OFB),
+*   RFC 4493 (CMAC) and the ten vectors of the EAX paper, run through both the
+*   AES_128_xxx() and the AES_128_Ctx API, and for EAX also through the streaming
+*   API with the header and the message cut in random pieces. A wrong EAX tag must
+*   be rejected without the output being written. CCM and CCM* are checked with
+*   RFC 3610 packet vectors 1 to 3 and IEEE 802.15.4-2006 Annex C.2, and a wrong MIC
+*   must clear the output. Random messages of 0 to 300 bytes are then processed by
+*   all the APIs, which must give the same output, and decrypted back; CCM is
+*   compared with a reference CCM of the tool, which also plays sw_AES128_CCM().
+* bench: frames of 127 bytes are processed with each mode, by the AES_128_xxx()
+*   functions and with a key context initialized once; "EAXs" is the streaming EAX
+*   fed with the frame in two segments, and the CCM frame is not word aligned, with
+*   an 8-byte header and MIC. The key expansions, blocks, lock acquisitions, buffer
+*   allocations and FLib_MemCpy() bytes are printed per frame, then the key
+*   expansions and locks per byte. The software AES expands its key on each block:
+*   its key expansions are the blocks, except for the CCM reference.
+*
+* Build (the device and low power directories are only needed for the include paths,
+* the tool defines the include guards of their headers):
+*   gcc -O2 -std=c99 -Wno-pointer-to-int-cast -I.. -I../../Common -I../../FunctionLib
+*       -I../../MemManager/Interface -I../../OSAbstraction/Interface
+*       -I../../Panic/Interface -I../../Lists -I../../LowPower/Interface/KW2xD
+*       -I../../../../mmcau_2.0.0 -I../../../../../devices/MKW24D5
+*       -o SecLibAesBench SecLibAesBench.c ../../FunctionLib/FunctionLib.c
+*   add -DFSL_FEATURE_SOC_MMCAU_COUNT=0 to build the software AES path
+* Usage: SecLibAesBench [check|bench [frames [seed]]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifndef FSL_FEATURE_SOC_MMCAU_COUNT
+#define FSL_FEATURE_SOC_MMCAU_COUNT     1
+#endif
+#define FSL_FEATURE_SOC_LTC_COUNT       0
+#define FSL_RTOS_FREE_RTOS
+#define gSecLibUseMutex_c               1
+#define cPWR_UsePowerDownMode           1
+#define mDbgRevertKeys_d                0
+
+/* Skip the device and low power headers */
+#define __FSL_DEVICE_REGISTERS_H__
+#define _PWR_INTERFACE_H_
+
+void PWR_AllowDeviceToSleep(void);
+void PWR_DisallowDeviceToSleep(void);
+
+static void* BenchAlloc(uint32_t numBytes);
+static void BenchMemCpy(void *pDst, void *pSrc, uint32_t cBytes);
+#define MEM_BufferAlloc(numBytes)       BenchAlloc(numBytes)
+#define FLib_MemCpy(pDst, pSrc, cBytes) BenchMemCpy(pDst, pSrc, cBytes)
+
+#include "../SecLib.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultFrames_c       (1000)
+#define mBenchFrameSize_c           (127)
+#define mBenchMaxMsg_c              (300)
+#define mBenchRandomRuns_c          (2000)
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef struct benchCounters_tag
+{
+    uint32_t expansions;
+    uint32_t blocks;
+    uint32_t locks;
+    uint32_t allocs;
+    uint32_t copyBytes;
+} benchCounters_t;
+
+typedef struct benchEaxVector_tag
+{
+    const char *pKey;
+    const char *pNonce;
+    const char *pHeader;
+    const char *pMsg;
+    const char *pCipher;    /* ciphertext followed by the tag */
+} benchEaxVector_t;
+
+typedef struct benchCcmVector_tag
+{
+    const char *pNonce;
+    const char *pAuthData;
+    const char *pMsg;
+    const char *pCipher;    /* ciphertext followed by the MIC */
+    uint8_t     macSize;
+} benchCcmVector_t;
+
+typedef void (*benchFrame_t)(uint8_t *pIn, uint8_t *pOut);
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static const uint8_t mSbox[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+static uint8_t mInvSbox[256];
+
+static benchCounters_t mCnt;
+static uint32_t mLockHeld;
+static uint32_t mSleepVotes;
+static uint32_t mBuffers;
+static uint32_t mFailures;
+static uint32_t mRandState = 0x2545F491;
+
+const uint32_t gEcP256_MultiplicationBufferSize_c = 1;
+
+/* FIPS-197 C.1 and SP800-38A F.1 to F.5 */
+static const uint8_t mFipsKey[16] = {0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f};
+static const uint8_t mFipsPt[16]  = {0x00,0x11,0x22,0x33,0x44,0x55,0x66,0x77,0x88,0x99,0xaa,0xbb,0xcc,0xdd,0xee,0xff};
+static const uint8_t mFipsCt[16]  = {0x69,0xc4,0xe0,0xd8,0x6a,0x7b,0x04,0x30,0xd8,0xcd,0xb7,0x80,0x70,0xb4,0xc5,0x5a};
+
+static const uint8_t mSpKey[16] = {0x2b,0x7e,0x15,0x16,0x28,0xae,0xd2,0xa6,0xab,0xf7,0x15,0x88,0x09,0xcf,0x4f,0x3c};
+static const uint8_t mSpPt[64] =
+{
+    0x6b,0xc1,0xbe,0xe2,0x2e,0x40,0x9f,0x96,0xe9,0x3d,0x7e,0x11,0x73,0x93,0x17,0x2a,
+    0xae,0x2d,0x8a,0x57,0x1e,0x03,0xac,0x9c,0x9e,0xb7,0x6f,0xac,0x45,0xaf,0x8e,0x51,
+    0x30,0xc8,0x1c,0x46,0xa3,0x5c,0xe4,0x11,0xe5,0xfb,0xc1,0x19,0x1a,0x0a,0x52,0xef,
+    0xf6,0x9f,0x24,0x45,0xdf,0x4f,0x9b,0x17,0xad,0x2b,0x41,0x7b,0xe6,0x6c,0x37,0x10
+};
+static const uint8_t mSpIv[16]  = {0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f};
+static const uint8_t mSpCtr[16] = {0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,0xf9,0xfa,0xfb,0xfc,0xfd,0xfe,0xff};
+static const uint8_t mSpEcb[64] =
+{
+    0x3a,0xd7,0x7b,0xb4,0x0d,0x7a,0x36,0x60,0xa8,0x9e,0xca,0xf3,0x24,0x66,0xef,0x97,
+    0xf5,0xd3,0xd5,0x85,0x03,0xb9,0x69,0x9d,0xe7,0x85,0x89,0x5a,0x96,0xfd,0xba,0xaf,
+    0x43,0xb1,0xcd,0x7f,0x59,0x8e,0xce,0x23,0x88,0x1b,0x00,0xe3,0xed,0x03,0x06,0x88,
+    0x7b,0x0c,0x78,0x5e,0x27,0xe8,0xad,0x3f,0x82,0x23,0x20,0x71,0x04,0x72,0x5d,0xd4
+};
+static const uint8_t mSpCbc[64] =
+{
+    0x76,0x49,0xab,0xac,0x81,0x19,0xb2,0x46,0xce,0xe9,0x8e,0x9b,0x12,0xe9,0x19,0x7d,
+    0x50,0x86,0xcb,0x9b,0x50,0x72,0x19,0xee,0x95,0xdb,0x11,0x3a,0x91,0x76,0x78,0xb2,
+    0x73,0xbe,0xd6,0xb8,0xe3,0xc1,0x74,0x3b,0x71,0x16,0xe6,0x9e,0x22,0x22,0x95,0x16,
+    0x3f,0xf1,0xca,0xa1,0x68,0x1f,0xac,0x09,0x12,0x0e,0xca,0x30,0x75,0x86,0xe1,0xa7
+};
+static const uint8_t mSpOfb[64] =
+{
+    0x3b,0x3f,0xd9,0x2e,0xb7,0x2d,0xad,0x20,0x33,0x34,0x49,0xf8,0xe8,0x3c,0xfb,0x4a,
+    0x77,0x89,0x50,0x8d,0x16,0x91,0x8f,0x03,0xf5,0x3c,0x52,0xda,0xc5,0x4e,0xd8,0x25,
+    0x97,0x40,0x05,0x1e,0x9c,0x5f,0xec,0xf6,0x43,0x44,0xf7,0xa8,0x22,0x60,0xed,0xcc,
+    0x30,0x4c,0x65,0x28,0xf6,0x59,0xc7,0x78,0x66,0xa5,0x10,0xd9,0xc1,0xd6,0xae,0x5e
+};
+static const uint8_t mSpCtrCt[64] =
+{
+    0x87,0x4d,0x61,0x91,0xb6,0x20,0xe3,0x26,0x1b,0xef,0x68,0x64,0x99,0x0d,0xb6,0xce,
+    0x98,0x06,0xf6,0x6b,0x79,0x70,0xfd,0xff,0x86,0x17,0x18,0x7b,0xb9,0xff,0xfd,0xff,
+    0x5a,0xe4,0xdf,0x3e,0xdb,0xd5,0xd3,0x5e,0x5b,0x4f,0x09,0x02,0x0d,0xb0,0x3e,0xab,
+    0x1e,0x03,0x1d,0xda,0x2f,0xbe,0x03,0xd1,0x79,0x21,0x70,0xa0,0xf3,0x00,0x9c,0xee
+};
+
+/* RFC 4493 4, the key and message are the SP800-38A ones */
+static const uint32_t mCmacLen[4] = {0, 16, 40, 64};
+static const uint8_t mCmacTag[4][16] =
+{
+    {0xbb,0x1d,0x69,0x29,0xe9,0x59,0x37,0x28,0x7f,0xa3,0x7d,0x12,0x9b,0x75,0x67,0x46},
+    {0x07,0x0a,0x16,0xb4,0x6b,0x4d,0x41,0x44,0xf7,0x9b,0xdd,0x9d,0xd0,0x4a,0x28,0x7c},
+    {0xdf,0xa6,0x67,0x47,0xde,0x9a,0xe6,0x30,0x30,0xca,0x32,0x61,0x14,0x97,0xc8,0x27},
+    {0x51,0xf0,0xbe,0xbf,0x7e,0x3b,0x9d,0x92,0xfc,0x49,0x74,0x17,0x79,0x36,0x3c,0xfe}
+};
+
+/* Bellare, Rogaway, Wagner: the EAX mode of operation, appendix test vectors */
+static const benchEaxVector_t mEaxVectors[] =
+{
+    {"233952DEE4D5ED5F9B9C6D6FF80FF478", "62EC67F9C3A4A407FCB2A8C49031A8B3", "6BFB914FD07EAE6B",
+     "",
+     "E037830E8389F27B025A2D6527E79D01"},
+    {"91945D3F4DCBEE0BF45EF52255F095A4", "BECAF043B0A23D843194BA972C66DEBD", "FA3BFD4806EB53FA",
+     "F7FB",
+     "19DD5C4C9331049D0BDAB0277408F67967E5"},
+    {"01F74AD64077F2E704C0F60ADA3DD523", "70C3DB4F0D26368400A10ED05D2BFF5E", "234A3463C1264AC6",
+     "1A47CB4933",
+     "D851D5BAE03A59F238A23E39199DC9266626C40F80"},
+    {"D07CF6CBB7F313BDDE66B727AFD3C5E8", "8408DFFF3C1A2B1292DC199E46B7D617", "33CCE2EABFF5A79D",
+     "481C9E39B1",
+     "632A9D131AD4C168A4225D8E1FF755939974A7BEDE"},
+    {"35B6D0580005BBC12B0587124557D2C2", "FDB6B06676EEDC5C61D74276E1F8E816", "AEB96EAEBE2970E9",
+     "40D0C07DA5E4",
+     "071DFE16C675CB0677E536F73AFE6A14B74EE49844DD"},
+    {"BD8E6E11475E60B268784C38C62FEB22", "6EAC5C93072D8E8513F750935E46DA1B", "D4482D1CA78DCE0F",
+     "4DE3B35C3FC039245BD1FB7D",
+     "835BB4F15D743E350E728414ABB8644FD6CCB86947C5E10590210A4F"},
+    {"7C77D6E813BED5AC98BAA417477A2E7D", "1A8C98DCD73D38393B2BF1569DEEFC19", "65D2017990D62528",
+     "8B0A79306C9CE7ED99DAE4F87F8DD61636",
+     "02083E3979DA014812F59F11D52630DA30137327D10649B0AA6E1C181DB617D7F2"},
+    {"5FFF20CAFAB119CA2FC73549E20F5B0D", "DDE59B97D722156D4D9AFF2BC7559826", "54B9F04E6A09189A",
+     "1BDA122BCE8A8DBAF1877D962B8592DD2D56",
+     "2EC47B2C4954A489AFC7BA4897EDCDAE8CC33B60450599BD02C96382902AEF7F832A"},
+    {"A4A4782BCFFD3EC5E7EF6D8C34A56123", "B781FCF2F75FA5A8DE97A9CA48E522EC", "899A175897561D7E",
+     "6CF36720872B8513F6EAB1A8A44438D5EF11",
+     "0DE18FD0FDD91E7AF19F1D8EE8733938B1E8E7F6D2231618102FDB7FE55FF1991700"},
+    {"8395FCF1E95BEBD697BD010BC766AAC3", "22E7ADD93CFC6393C57EC0B3C17D6B44", "126735FCC320D25A",
+     "CA40D7446E545FFAED3BD12A740A659FFBBB3CEAB7",
+     "CB8920F87A6C75CFF39627B56E3ED197C552D295A7CFC46AFC253B4652B1AF3795B124AB6E"}
+};
+
+/* RFC 3610 and IEEE 802.15.4-2006 Annex C, all with the key C0 C1 .. CF */
+static const benchCcmVector_t mCcmVectors[] =
+{
+    /* RFC 3610 packet vector #1 */
+    {"00000003020100A0A1A2A3A4A5",
+     "0001020304050607",
+     "08090A0B0C0D0E0F101112131415161718191A1B1C1D1E",
+     "588C979A61C663D2F066D0C2C0F989806D5F6B61DAC38417E8D12CFDF926E0", 8},
+    /* RFC 3610 packet vector #2 */
+    {"00000004030201A0A1A2A3A4A5",
+     "0001020304050607",
+     "08090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F",
+     "72C91A36E135F8CF291CA894085C87E3CC15C439C9E43A3BA091D56E10400916", 8},
+    /* RFC 3610 packet vector #3 */
+    {"00000005040302A0A1A2A3A4A5",
+     "0001020304050607",
+     "08090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F20",
+     "51B1E5F44A197D1DA46B0F8E2D282AE871E838BB64DA8596574ADAA76FBD9FB0C5", 8},
+    /* IEEE 802.15.4-2006 C.2.1, MIC-64 beacon */
+    {"ACDE4800000000010000000502",
+     "08D0842143010000000048DEAC020500000055CF000051525354",
+     "",
+     "223BC1EC841AB553", 8},
+    /* IEEE 802.15.4-2006 C.2.2, ENC data frame */
+    {"ACDE4800000000010000000504",
+     "69DC842143020000000048DEAC010000000048DEAC0405000000",
+     "61626364",
+     "D43E022B", 0},
+    /* IEEE 802.15.4-2006 C.2.3, ENC-MIC-64 command frame */
+    {"ACDE4800000000010000000506",
+     "2BDC842143020000000048DEACFFFF010000000048DEAC060500000001",
+     "CE",
+     "D84FDE529061F9C6F1", 8}
+};
+
+/* Bench state */
+static uint8_t mBenchKey[16];
+static uint8_t mBenchIv[16];
+static uint8_t mBenchNonce[16];
+static uint8_t mBenchHeader[8];
+static uint8_t mBenchCcmNonce[13];
+static aesKeyCtx_t mBenchCtx;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    /* xorshift32 */
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 17;
+    mRandState ^= mRandState << 5;
+    return mRandState;
+}
+
+static void BenchFail(const char *pWhat, uint32_t value)
+{
+    if( mFailures < 20 )
+    {
+        printf("FAIL: %s (%u)\n", pWhat, value);
+    }
+    mFailures++;
+}
+
+/*! *********************************************************************************
+* \brief  Reference AES-128, used as the MMCAU and as the software AES.
+********************************************************************************** */
+static uint8_t BenchMul(uint8_t a, uint8_t b)
+{
+    uint8_t r = 0;
+
+    while( b )
+    {
+        if( b & 1 )
+        {
+            r ^= a;
+        }
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1B : 0));
+        b >>= 1;
+    }
+    return r;
+}
+
+static void BenchAesExpand(const uint8_t *pKey, uint8_t *w)
+{
+    uint8_t rcon = 1;
+    uint32_t i;
+
+    mCnt.expansions++;
+    memcpy(w, pKey, 16);
+    for( i = 16; i < 176; i += 4 )
+    {
+        uint8_t t[4] = {w[i-4], w[i-3], w[i-2], w[i-1]};
+
+        if( (i % 16) == 0 )
+        {
+            uint8_t t0 = t[0];
+
+            t[0] = mSbox[t[1]] ^ rcon;
+            t[1] = mSbox[t[2]];
+            t[2] = mSbox[t[3]];
+            t[3] = mSbox[t0];
+            rcon = BenchMul(rcon, 2);
+        }
+        w[i]   = w[i-16] ^ t[0];
+        w[i+1] = w[i-15] ^ t[1];
+        w[i+2] = w[i-14] ^ t[2];
+        w[i+3] = w[i-13] ^ t[3];
+    }
+}
+
+static void BenchAesCipher(const uint8_t *pIn, const uint8_t *w, int encrypt, uint8_t *pOut)
+{
+    uint8_t s[16];
+    uint8_t t[16];
+    int round;
+    int i;
+    int c;
+
+    mCnt.blocks++;
+    for( i = 0; i < 16; i++ )
+    {
+        s[i] = pIn[i] ^ w[(encrypt ? 0 : 160) + i];
+    }
+
+    for( round = 1; round <= 10; round++ )
+    {
+        const uint8_t *rk = &w[16 * (encrypt ? round : 10 - round)];
+
+        if( encrypt )
+        {
+            /* SubBytes and ShiftRows */
+            for( i = 0; i < 16; i++ )
+            {
+                t[i] = mSbox[s[(i + 4 * (i % 4)) % 16]];
+            }
+            /* MixColumns */
+            for( c = 0; c < 4 && round < 10; c++ )
+            {
+                uint8_t *col = &t[4 * c];
+                uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+
+                col[0] = BenchMul(a0, 2) ^ BenchMul(a1, 3) ^ a2 ^ a3;
+                col[1] = a0 ^ BenchMul(a1, 2) ^ BenchMul(a2, 3) ^ a3;
+                col[2] = a0 ^ a1 ^ BenchMul(a2, 2) ^ BenchMul(a3, 3);
+                col[3] = BenchMul(a0, 3) ^ a1 ^ a2 ^ BenchMul(a3, 2);
+            }
+            for( i = 0; i < 16; i++ )
+            {
+                s[i] = t[i] ^ rk[i];
+            }
+        }
+        else
+        {
+            /* InvShiftRows and InvSubBytes */
+            for( i = 0; i < 16; i++ )
+            {
+                t[(i + 4 * (i % 4)) % 16] = mInvSbox[s[i]];
+            }
+            for( i = 0; i < 16; i++ )
+            {
+                t[i] ^= rk[i];
+            }
+            /* InvMixColumns */
+            for( c = 0; c < 4 && round < 10; c++ )
+            {
+                uint8_t *col = &t[4 * c];
+                uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+
+                col[0] = BenchMul(a0, 14) ^ BenchMul(a1, 11) ^ BenchMul(a2, 13) ^ BenchMul(a3, 9);
+                col[1] = BenchMul(a0, 9) ^ BenchMul(a1, 14) ^ BenchMul(a2, 11) ^ BenchMul(a3, 13);
+                col[2] = BenchMul(a0, 13) ^ BenchMul(a1, 9) ^ BenchMul(a2, 14) ^ BenchMul(a3, 11);
+                col[3] = BenchMul(a0, 11) ^ BenchMul(a1, 13) ^ BenchMul(a2, 9) ^ BenchMul(a3, 14);
+            }
+            memcpy(s, t, 16);
+        }
+    }
+    memcpy(pOut, s, 16);
+}
+
+void mmcau_aes_set_key(const unsigned char *key, const int key_size, unsigned char *key_sch)
+{
+    if( (key_size != AES128) || (((uintptr_t)key | (uintptr_t)key_sch) & 3) )
+    {
+        BenchFail("mmcau_aes_set_key() parameters", (uint32_t)key_size);
+    }
+    BenchAesExpand(key, key_sch);
+}
+
+void mmcau_aes_encrypt(const unsigned char *in, const unsigned char *key_sch, const int nr, unsigned char *out)
+{
+    if( (nr != AES128_ROUNDS) || (((uintptr_t)in | (uintptr_t)key_sch | (uintptr_t)out) & 3) )
+    {
+        BenchFail("mmcau_aes_encrypt() parameters", (uint32_t)nr);
+    }
+    BenchAesCipher(in, key_sch, 1, out);
+}
+
+void mmcau_aes_decrypt(const unsigned char *in, const unsigned char *key_sch, const int nr, unsigned char *out)
+{
+    if( (nr != AES128_ROUNDS) || (((uintptr_t)in | (uintptr_t)key_sch | (uintptr_t)out) & 3) )
+    {
+        BenchFail("mmcau_aes_decrypt() parameters", (uint32_t)nr);
+    }
+    BenchAesCipher(in, key_sch, 0, out);
+}
+
+void sw_Aes128(const uint8_t *pData, const uint8_t *pKey, uint8_t enc, uint8_t *pReturnData)
+{
+    uint8_t w[176];
+
+    BenchAesExpand(pKey, w);
+    BenchAesCipher(pData, w, enc, pReturnData);
+}
+
+/*! *********************************************************************************
+* \brief  Reference AES-128-CCM, written after RFC 3610: the CBC-MAC runs over one
+*         buffer holding B0, the formatted authentication data and the message. It
+*         also plays sw_AES128_CCM(), with one key expansion per message.
+********************************************************************************** */
+static uint8_t BenchCcmRef(const uint8_t *pInput, uint32_t inputLen, const uint8_t *pAuthData, uint32_t authDataLen,
+                           const uint8_t *pNonce, uint8_t nonceSize, const uint8_t *pKey, uint8_t *pOutput,
+                           uint8_t *pCbcMac, uint8_t macSize, int encrypt)
+{
+    uint32_t L = 15 - nonceSize;
+    uint32_t bufLen = 16 + 6 + authDataLen + 16 + inputLen + 16;
+    uint8_t *pBuf = calloc(1, bufLen);
+    uint8_t *pPlain = malloc(inputLen + 1);
+    uint8_t w[176];
+    uint8_t a[16];
+    uint8_t s[16];
+    uint8_t x[16] = {0};
+    uint8_t status = 0;
+    uint32_t len = 16;
+    uint32_t i;
+    uint32_t j;
+
+    BenchAesExpand(pKey, w);
+
+    /* Counter blocks Ai, plaintext */
+    a[0] = (uint8_t)(L - 1);
+    memcpy(&a[1], pNonce, nonceSize);
+    for( i = 0; i < inputLen; i += 16 )
+    {
+        for( j = 0; j < L; j++ )
+        {
+            a[15 - j] = (j < 4) ? (uint8_t)((i / 16 + 1) >> (8 * j)) : 0;
+        }
+        BenchAesCipher(a, w, 1, s);
+        for( j = i; (j < inputLen) && (j < i + 16); j++ )
+        {
+            pPlain[j] = encrypt ? pInput[j] : (uint8_t)(pInput[j] ^ s[j - i]);
+            pOutput[j] = pInput[j] ^ s[j - i];
+        }
+    }
+
+    /* B0 | l(a) | a | padding | m | padding */
+    pBuf[0] = (uint8_t)((authDataLen ? 0x40 : 0) | ((macSize ? (macSize - 2) / 2 : 0) << 3) | (L - 1));
+    memcpy(&pBuf[1], pNonce, nonceSize);
+    for( j = 0; j < L; j++ )
+    {
+        pBuf[15 - j] = (j < 4) ? (uint8_t)(inputLen >> (8 * j)) : 0;
+    }
+    if( authDataLen )
+    {
+        if( authDataLen < 0xFF00 )
+        {
+            pBuf[len++] = (uint8_t)(authDataLen >> 8);
+            pBuf[len++] = (uint8_t)authDataLen;
+        }
+        else
+        {
+            pBuf[len++] = 0xFF;
+            pBuf[len++] = 0xFE;
+            for( j = 0; j < 4; j++ )
+            {
+                pBuf[len++] = (uint8_t)(authDataLen >> (24 - 8 * j));
+            }
+        }
+        memcpy(&pBuf[len], pAuthData, authDataLen);
+        len = (len + authDataLen + 15) & ~15u;
+    }
+    memcpy(&pBuf[len], pPlain, inputLen);
+    len = (len + inputLen + 15) & ~15u;
+
+    for( i = 0; i < len; i += 16 )
+    {
+        for( j = 0; j < 16; j++ )
+        {
+            x[j] ^= pBuf[i + j];
+        }
+        BenchAesCipher(x, w, 1, x);
+    }
+
+    for( j = 0; j < L; j++ )
+    {
+        a[15 - j] = 0;
+    }
+    BenchAesCipher(a, w, 1, s);
+    for( j = 0; j < macSize; j++ )
+    {
+        if( encrypt )
+        {
+            pCbcMac[j] = x[j] ^ s[j];
+        }
+        else if( pCbcMac[j] != (x[j] ^ s[j]) )
+        {
+            status = 1;
+        }
+    }
+    if( status )
+    {
+        memset(pOutput, 0, inputLen);
+    }
+
+    free(pBuf);
+    free(pPlain);
+    return status;
+}
+
+uint8_t sw_AES128_CCM(uint8_t* pInput, uint16_t inputLen, uint8_t* pAuthData, uint16_t authDataLen,
+                      uint8_t* pNonce, uint8_t nonceSize, uint8_t* pKey, uint8_t* pOutput,
+                      uint8_t* pCbcMac, uint8_t macSize, uint32_t flags)
+{
+    return BenchCcmRef(pInput, inputLen, pAuthData, authDataLen, pNonce, nonceSize, pKey, pOutput,
+                       pCbcMac, macSize, !(flags & gSecLib_CCM_Decrypt_c));
+}
+
+/*! *********************************************************************************
+* \brief  The hash and ECDH functions are not used by the tool.
+********************************************************************************** */
+void mmcau_sha1_initialize_output(const unsigned int *sha1_state) { (void)sha1_state; }
+void mmcau_sha1_hash_n(const unsigned char *msg_data, const int num_blks, unsigned int *sha1_state) { (void)msg_data; (void)num_blks; (void)sha1_state; }
+int mmcau_sha256_initialize_output(const unsigned int *output) { (void)output; return 0; }
+void mmcau_sha256_hash_n(const unsigned char *input, const int num_blks, unsigned int *output) { (void)input; (void)num_blks; (void)output; }
+void sw_sha1_initialize_output(uint32_t *sha1_state) { (void)sha1_state; }
+void sw_sha1_hash_n(uint8_t *msg_data, int32_t num_blks, uint32_t *sha1_state) { (void)msg_data; (void)num_blks; (void)sha1_state; }
+void sw_sha256_initialize_output(uint32_t *sha256_state) { (void)sha256_state; }
+void sw_sha256_hash_n(uint8_t *msg_data, int32_t num_blks, uint32_t *sha256_state) { (void)msg_data; (void)num_blks; (void)sha256_state; }
+
+ecdhStatus_t Ecdh_GenerateNewKeys(ecdhPublicKey_t* pOutPublicKey, ecdhPrivateKey_t* pOutPrivateKey, void* pMultiplicationBuffer)
+{
+    (void)pOutPublicKey; (void)pOutPrivateKey; (void)pMultiplicationBuffer;
+    return gEcdhBadParameters_c;
+}
+
+ecdhStatus_t Ecdh_ComputeDhKey(ecdhPrivateKey_t* pPrivateKey, ecdhPublicKey_t* pPeerPublicKey, ecdhDhKey_t* pOutDhKey, void* pMultiplicationBuffer)
+{
+    (void)pPrivateKey; (void)pPeerPublicKey; (void)pOutDhKey; (void)pMultiplicationBuffer;
+    return gEcdhBadParameters_c;
+}
+
+/*! *********************************************************************************
+* \brief  The mutex counts the lock acquisitions; a lock taken twice would dead lock
+*         the non recursive RTOS mutex.
+********************************************************************************** */
+osaMutexId_t OSA_MutexCreate(void)
+{
+    return (osaMutexId_t)&mLockHeld;
+}
+
+osaStatus_t OSA_MutexLock(osaMutexId_t mutexId, uint32_t millisec)
+{
+    (void)millisec;
+    if( (mutexId != (osaMutexId_t)&mLockHeld) || mLockHeld )
+    {
+        BenchFail("mutex locked twice", mCnt.locks);
+    }
+    mLockHeld = 1;
+    mCnt.locks++;
+    return osaStatus_Success;
+}
+
+osaStatus_t OSA_MutexUnlock(osaMutexId_t mutexId)
+{
+    if( (mutexId != (osaMutexId_t)&mLockHeld) || !mLockHeld )
+    {
+        BenchFail("mutex not locked", mCnt.locks);
+    }
+    mLockHeld = 0;
+    return osaStatus_Success;
+}
+
+void PWR_DisallowDeviceToSleep(void)
+{
+    mSleepVotes++;
+}
+
+void PWR_AllowDeviceToSleep(void)
+{
+    if( 0 == mSleepVotes )
+    {
+        BenchFail("low power vote released twice", 0);
+    }
+    else
+    {
+        mSleepVotes--;
+    }
+}
+
+static void* BenchAlloc(uint32_t numBytes)
+{
+    mBuffers++;
+    mCnt.allocs++;
+    return malloc(numBytes ? numBytes : 1);
+}
+
+memStatus_t MEM_BufferFree(void* buffer)
+{
+    mBuffers--;
+    free(buffer);
+    return MEM_SUCCESS_c;
+}
+
+static void BenchMemCpy(void *pDst, void *pSrc, uint32_t cBytes)
+{
+    if( cBytes )
+    {
+        memcpy(pDst, pSrc, cBytes);
+    }
+    mCnt.copyBytes += cBytes;
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    (void)id; (void)location; (void)extra1; (void)extra2;
+    printf("FAIL: panic\n");
+    exit(1);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static void BenchExpect(const char *pWhat, const uint8_t *pGot, const uint8_t *pExpected, uint32_t len)
+{
+    if( memcmp(pGot, pExpected, len) )
+    {
+        BenchFail(pWhat, len);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Known answer tests. The buffers are word aligned and the messages are
+*         copied at an odd offset once, to go through the MMCAU alignment copies.
+********************************************************************************** */
+static void BenchKat(void)
+{
+    uint32_t buf[4][80/sizeof(uint32_t)];
+    uint8_t *pIn = (uint8_t*)buf[0];
+    uint8_t *pOut = (uint8_t*)buf[1];
+    uint8_t *pIv = (uint8_t*)buf[2];
+    uint8_t *pTag = (uint8_t*)buf[3];
+    aesKeyCtx_t ctx;
+    uint32_t i;
+    uint32_t ofs;
+
+    for( ofs = 0; ofs < 2; ofs++ )
+    {
+        /* FIPS-197 */
+        memcpy(pIn + ofs, mFipsPt, 16);
+        AES_128_Encrypt(pIn + ofs, mFipsKey, pOut + ofs);
+        BenchExpect("AES_128_Encrypt() FIPS-197", pOut + ofs, mFipsCt, 16);
+        AES_128_Decrypt(pOut + ofs, mFipsKey, pIn + ofs);
+        BenchExpect("AES_128_Decrypt() FIPS-197", pIn + ofs, mFipsPt, 16);
+        AES_128_CtxInit(&ctx, mFipsKey);
+        AES_128_CtxECB_Encrypt(&ctx, mFipsPt, 1, pOut + ofs);
+        BenchExpect("AES_128_CtxECB_Encrypt() FIPS-197", pOut + ofs, mFipsCt, 16);
+        AES_128_CtxECB_Decrypt(&ctx, pOut + ofs, 1, pIn + ofs);
+        BenchExpect("AES_128_CtxECB_Decrypt() FIPS-197", pIn + ofs, mFipsPt, 16);
+
+        /* SP800-38A */
+        AES_128_CtxInit(&ctx, mSpKey);
+        memcpy(pIn + ofs, mSpPt, 64);
+        AES_128_ECB_Encrypt(pIn + ofs, 64, (uint8_t*)mSpKey, pOut + ofs);
+        BenchExpect("AES_128_ECB_Encrypt() SP800-38A", pOut + ofs, mSpEcb, 64);
+        AES_128_ECB_Block_Encrypt(pIn + ofs, 4, mSpKey, pOut + ofs);
+        BenchExpect("AES_128_ECB_Block_Encrypt() SP800-38A", pOut + ofs, mSpEcb, 64);
+        AES_128_CtxECB_Encrypt(&ctx, pIn + ofs, 4, pOut + ofs);
+        BenchExpect("AES_128_CtxECB_Encrypt() SP800-38A", pOut + ofs, mSpEcb, 64);
+        AES_128_CtxECB_Decrypt(&ctx, mSpEcb, 4, pOut + ofs);
+        BenchExpect("AES_128_CtxECB_Decrypt() SP800-38A", pOut + ofs, mSpPt, 64);
+
+        AES_128_CBC_Encrypt(pIn + ofs, 64, (uint8_t*)mSpIv, (uint8_t*)mSpKey, pOut + ofs);
+        BenchExpect("AES_128_CBC_Encrypt() SP800-38A", pOut + ofs, mSpCbc, 64);
+        memcpy(pIv + ofs, mSpIv, 16);
+        AES_128_CtxCBC_Encrypt(&ctx, pIn + ofs, 32, pIv + ofs, pOut + ofs);
+        AES_128_CtxCBC_Encrypt(&ctx, pIn + ofs + 32, 32, pIv + ofs, pOut + ofs + 32);
+        BenchExpect("AES_128_CtxCBC_Encrypt() SP800-38A", pOut + ofs, mSpCbc, 64);
+        BenchExpect("AES_128_CtxCBC_Encrypt() chaining", pIv + ofs, &mSpCbc[48], 16);
+        memcpy(pIv + ofs, mSpIv, 16);
+        memcpy(pOut + ofs, mSpCbc, 64);
+        AES_128_CtxCBC_Decrypt(&ctx, pOut + ofs, 16, pIv + ofs, pOut + ofs);
+        AES_128_CtxCBC_Decrypt(&ctx, pOut + ofs + 16, 48, pIv + ofs, pOut + ofs + 16);
+        BenchExpect("AES_128_CtxCBC_Decrypt() SP800-38A in place", pOut + ofs, mSpPt, 64);
+
+        memcpy(pIv + ofs, mSpCtr, 16);
+        AES_128_CTR(pIn + ofs, 64, pIv + ofs, (uint8_t*)mSpKey, pOut + ofs);
+        BenchExpect("AES_128_CTR() SP800-38A", pOut + ofs, mSpCtrCt, 64);
+        memcpy(pIv + ofs, mSpCtr, 16);
+        AES_128_CtxCTR(&ctx, pIn + ofs, 32, pIv + ofs, pOut + ofs);
+        AES_128_CtxCTR(&ctx, pIn + ofs + 32, 32, pIv + ofs, pOut + ofs + 32);
+        BenchExpect("AES_128_CtxCTR() SP800-38A", pOut + ofs, mSpCtrCt, 64);
+
+        AES_128_OFB(pIn + ofs, 64, (uint8_t*)mSpIv, (uint8_t*)mSpKey, pOut + ofs);
+        BenchExpect("AES_128_OFB() SP800-38A", pOut + ofs, mSpOfb, 64);
+        memcpy(pIv + ofs, mSpIv, 16);
+        AES_128_CtxOFB(&ctx, pIn + ofs, 16, pIv + ofs, pOut + ofs);
+        AES_128_CtxOFB(&ctx, pIn + ofs + 16, 48, pIv + ofs, pOut + ofs + 16);
+        BenchExpect("AES_128_CtxOFB() SP800-38A", pOut + ofs, mSpOfb, 64);
+
+        /* RFC 4493 */
+        for( i = 0; i < 4; i++ )
+        {
+            uint8_t reversed[64];
+            uint32_t j;
+
+            AES_128_CMAC(pIn + ofs, mCmacLen[i], (uint8_t*)mSpKey, pTag + ofs);
+            BenchExpect("AES_128_CMAC() RFC 4493", pTag + ofs, mCmacTag[i], 16);
+            AES_128_CtxCMAC(&ctx, pIn + ofs, mCmacLen[i], pTag + ofs);
+            BenchExpect("AES_128_CtxCMAC() RFC 4493", pTag + ofs, mCmacTag[i], 16);
+            for( j = 0; j < mCmacLen[i]; j++ )
+            {
+                reversed[j] = mSpPt[mCmacLen[i] - 1 - j];
+            }
+            AES_128_CMAC_LsbFirstInput(reversed, mCmacLen[i], (uint8_t*)mSpKey, pTag + ofs);
+            BenchExpect("AES_128_CMAC_LsbFirstInput() RFC 4493", pTag + ofs, mCmacTag[i], 16);
+        }
+    }
+}
+
+static uint32_t BenchHex(const char *pHex, uint8_t *pOut)
+{
+    uint32_t len = 0;
+    unsigned int byte;
+
+    while( pHex[0] && pHex[1] && (1 == sscanf(pHex, "%2x", &byte)) )
+    {
+        pOut[len++] = (uint8_t)byte;
+        pHex += 2;
+    }
+    return len;
+}
+
+/*! *********************************************************************************
+* \brief  AES-128-EAX through the AES_128_Eax streaming API: the header and the
+*         message are cut in random pieces of 0 to 20 bytes, randomly interleaved.
+********************************************************************************** */
+static secResultType_t BenchEaxStream(aesKeyCtx_t *pKeyCtx, uint8_t *pNonce, uint32_t nonceLen,
+                                      uint8_t *pHeader, uint32_t headerLen, uint8_t *pIn, uint32_t len,
+                                      uint8_t *pOut, uint8_t *pTag, bool_t encrypt)
+{
+    aesEaxCtx_t eaxCtx;
+    uint32_t headerPos = 0;
+    uint32_t pos = 0;
+    uint32_t n;
+
+    AES_128_EaxInit(&eaxCtx, pKeyCtx, pNonce, nonceLen, encrypt);
+    while( (headerPos < headerLen) || (pos < len) )
+    {
+        n = BenchRand() % 21;
+        if( (pos == len) || ((headerPos < headerLen) && (BenchRand() & 1)) )
+        {
+            n = (n > headerLen - headerPos) ? headerLen - headerPos : n;
+            AES_128_EaxUpdateAAD(&eaxCtx, pHeader + headerPos, n);
+            headerPos += n;
+        }
+        else
+        {
+            n = (n > len - pos) ? len - pos : n;
+            AES_128_EaxUpdate(&eaxCtx, pIn + pos, n, pOut + pos);
+            pos += n;
+        }
+    }
+    return AES_128_EaxFinish(&eaxCtx, pTag);
+}
+
+/*! *********************************************************************************
+* \brief  EAX known answer tests, through the AES_128_EAX_xxx(), AES_128_CtxEAX_xxx()
+*         and streaming functions. A decryption with a wrong tag must fail, and the
+*         one shot functions must leave the output unchanged.
+********************************************************************************** */
+static void BenchKatEax(void)
+{
+    uint8_t key[16];
+    uint8_t nonce[16];
+    uint8_t header[16];
+    uint8_t msg[32];
+    uint8_t cipher[48];
+    uint8_t out[32];
+    uint8_t tag[16];
+    uint8_t unchanged[32];
+    aesKeyCtx_t ctx;
+    uint32_t nonceLen;
+    uint32_t headerLen;
+    uint32_t len;
+    uint32_t i;
+    uint32_t api;
+
+    memset(unchanged, 0xA5, sizeof(unchanged));
+    for( i = 0; i < sizeof(mEaxVectors)/sizeof(mEaxVectors[0]); i++ )
+    {
+        (void)BenchHex(mEaxVectors[i].pKey, key);
+        nonceLen = BenchHex(mEaxVectors[i].pNonce, nonce);
+        headerLen = BenchHex(mEaxVectors[i].pHeader, header);
+        len = BenchHex(mEaxVectors[i].pMsg, msg);
+        (void)BenchHex(mEaxVectors[i].pCipher, cipher);
+        AES_128_CtxInit(&ctx, key);
+
+        for( api = 0; api < 3; api++ )
+        {
+            secResultType_t status;
+
+            memset(out, 0, sizeof(out));
+            memset(tag, 0, sizeof(tag));
+            if( api == 0 )
+            {
+                status = AES_128_EAX_Encrypt(msg, len, nonce, nonceLen, header, (uint8_t)headerLen, key, out, tag);
+            }
+            else if( api == 1 )
+            {
+                status = AES_128_CtxEAX_Encrypt(&ctx, msg, len, nonce, nonceLen, header, (uint8_t)headerLen, out, tag);
+            }
+            else
+            {
+                status = BenchEaxStream(&ctx, nonce, nonceLen, header, headerLen, msg, len, out, tag, TRUE);
+            }
+            if( gSecSuccess_c != status )
+            {
+                BenchFail("EAX encrypt status", i);
+            }
+            BenchExpect("EAX ciphertext", out, cipher, len);
+            BenchExpect("EAX tag", tag, cipher + len, 16);
+
+            /* Decrypt in place */
+            memcpy(out, cipher, len);
+            if( api == 0 )
+            {
+                status = AES_128_EAX_Decrypt(out, len, nonce, nonceLen, header, (uint8_t)headerLen, key, out, tag);
+            }
+            else if( api == 1 )
+            {
+                status = AES_128_CtxEAX_Decrypt(&ctx, out, len, nonce, nonceLen, header, (uint8_t)headerLen, out, tag);
+            }
+            else
+            {
+                status = BenchEaxStream(&ctx, nonce, nonceLen, header, headerLen, out, len, out, tag, FALSE);
+            }
+            if( gSecSuccess_c != status )
+            {
+                BenchFail("EAX decrypt status", i);
+            }
+            BenchExpect("EAX plaintext", out, msg, len);
+
+            /* Wrong tag */
+            tag[i] ^= 0x80;
+            memset(out, 0xA5, sizeof(out));
+            if( api == 0 )
+            {
+                status = AES_128_EAX_Decrypt(cipher, len, nonce, nonceLen, header, (uint8_t)headerLen, key, out, tag);
+            }
+            else if( api == 1 )
+            {
+                status = AES_128_CtxEAX_Decrypt(&ctx, cipher, len, nonce, nonceLen, header, (uint8_t)headerLen, out, tag);
+            }
+            else
+            {
+                status = BenchEaxStream(&ctx, nonce, nonceLen, header, headerLen, cipher, len, out, tag, FALSE);
+            }
+            if( gSecError_c != status )
+            {
+                BenchFail("EAX decrypt accepted a wrong tag", i);
+            }
+            if( api < 2 )
+            {
+                BenchExpect("EAX output written with a wrong tag", out, unchanged, sizeof(out));
+            }
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  CCM and CCM* known answer tests, through AES_128_CCM() and AES_128_CtxCCM(),
+*         with the ciphertext at an odd address for the key context. A wrong MIC must
+*         be rejected and the output cleared.
+********************************************************************************** */
+static void BenchKatCcm(void)
+{
+    static uint8_t bigAuthData[0xFF00];
+    uint32_t buffer[(32 + 16) / sizeof(uint32_t) + 1];
+    uint8_t key[16];
+    uint8_t nonce[13];
+    uint8_t authData[32];
+    uint8_t msg[32];
+    uint8_t cipher[48];
+    uint8_t mac[16];
+    uint8_t mac2[16];
+    uint8_t zero[32] = {0};
+    uint8_t *pOut;
+    aesKeyCtx_t ctx;
+    uint32_t nonceSize;
+    uint32_t authDataLen;
+    uint32_t len;
+    uint32_t i;
+    uint32_t api;
+
+    for( i = 0; i < 16; i++ )
+    {
+        key[i] = (uint8_t)(0xC0 + i);
+    }
+    AES_128_CtxInit(&ctx, key);
+
+    for( i = 0; i < sizeof(mCcmVectors)/sizeof(mCcmVectors[0]); i++ )
+    {
+        uint8_t macSize = mCcmVectors[i].macSize;
+
+        nonceSize = BenchHex(mCcmVectors[i].pNonce, nonce);
+        authDataLen = BenchHex(mCcmVectors[i].pAuthData, authData);
+        len = BenchHex(mCcmVectors[i].pMsg, msg);
+        (void)BenchHex(mCcmVectors[i].pCipher, cipher);
+
+        for( api = 0; api < 2; api++ )
+        {
+            uint32_t status;
+
+            pOut = (uint8_t*)buffer + api;
+            memset(mac, 0, sizeof(mac));
+            if( api == 0 )
+            {
+                status = AES_128_CCM(msg, (uint16_t)len, authData, (uint16_t)authDataLen, nonce, (uint8_t)nonceSize,
+                                     key, pOut, mac, macSize, gSecLib_CCM_Encrypt_c);
+            }
+            else
+            {
+                status = AES_128_CtxCCM(&ctx, msg, len, authData, authDataLen, nonce, (uint8_t)nonceSize,
+                                        pOut, mac, macSize, gSecLib_CCM_Encrypt_c);
+            }
+            if( status )
+            {
+                BenchFail("CCM encrypt status", i);
+            }
+            BenchExpect("CCM ciphertext", pOut, cipher, len);
+            BenchExpect("CCM MIC", mac, cipher + len, macSize);
+
+            /* Decrypt in place */
+            if( api == 0 )
+            {
+                status = AES_128_CCM(pOut, (uint16_t)len, authData, (uint16_t)authDataLen, nonce, (uint8_t)nonceSize,
+                                     key, pOut, mac, macSize, gSecLib_CCM_Decrypt_c);
+            }
+            else
+            {
+                status = AES_128_CtxCCM(&ctx, pOut, len, authData, authDataLen, nonce, (uint8_t)nonceSize,
+                                        pOut, mac, macSize, gSecLib_CCM_Decrypt_c);
+            }
+            if( status )
+            {
+                BenchFail("CCM decrypt status", i);
+            }
+            BenchExpect("CCM plaintext", pOut, msg, len);
+
+            if( macSize )
+            {
+                mac[macSize - 1] ^= 0x01;
+                memcpy(pOut, cipher, len);
+                status = (api == 0) ?
+                    AES_128_CCM(pOut, (uint16_t)len, authData, (uint16_t)authDataLen, nonce, (uint8_t)nonceSize,
+                                key, pOut, mac, macSize, gSecLib_CCM_Decrypt_c) :
+                    AES_128_CtxCCM(&ctx, pOut, len, authData, authDataLen, nonce, (uint8_t)nonceSize,
+                                   pOut, mac, macSize, gSecLib_CCM_Decrypt_c);
+                if( 0 == status )
+                {
+                    BenchFail("CCM decrypt accepted a wrong MIC", i);
+                }
+                BenchExpect("CCM output left with a wrong MIC", pOut, zero, len);
+            }
+        }
+    }
+
+    /* Authentication data long enough for the 6-byte length field */
+    for( i = 0; i < sizeof(bigAuthData); i++ )
+    {
+        bigAuthData[i] = (uint8_t)BenchRand();
+    }
+    (void)BenchCcmRef(msg, 16, bigAuthData, sizeof(bigAuthData), nonce, 13, key, cipher, mac, 16, 1);
+    if( AES_128_CtxCCM(&ctx, msg, 16, bigAuthData, sizeof(bigAuthData), nonce, 13, (uint8_t*)buffer, mac2, 16, gSecLib_CCM_Encrypt_c) )
+    {
+        BenchFail("CCM long authentication data status", 0);
+    }
+    BenchExpect("CCM long authentication data", (uint8_t*)buffer, cipher, 16);
+    BenchExpect("CCM long authentication data MIC", mac2, mac, 16);
+
+    /* Invalid nonce and MIC sizes, message too long for a 2-byte length field */
+    if( (gSecError_c != AES_128_CtxCCM(&ctx, msg, 16, NULL, 0, nonce, 6, (uint8_t*)buffer, mac, 8, gSecLib_CCM_Encrypt_c)) ||
+        (gSecError_c != AES_128_CtxCCM(&ctx, msg, 16, NULL, 0, nonce, 13, (uint8_t*)buffer, mac, 2, gSecLib_CCM_Encrypt_c)) ||
+        (gSecError_c != AES_128_CtxCCM(&ctx, msg, 16, NULL, 0, nonce, 13, (uint8_t*)buffer, mac, 5, gSecLib_CCM_Encrypt_c)) ||
+        (gSecError_c != AES_128_CtxCCM(&ctx, msg, 0x10000, NULL, 0, nonce, 13, (uint8_t*)buffer, mac, 8, gSecLib_CCM_Encrypt_c)) )
+    {
+        BenchFail("CCM invalid parameters accepted", 0);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Random messages through both APIs: same output, decrypted back.
+********************************************************************************** */
+static void BenchRandom(uint32_t runs)
+{
+    uint8_t key[16];
+    uint8_t iv[16];
+    uint8_t iv2[16];
+    uint8_t nonce[20];
+    uint8_t header[32];
+    uint8_t msg[mBenchMaxMsg_c + 16];
+    uint8_t out1[mBenchMaxMsg_c + 16];
+    uint8_t out2[mBenchMaxMsg_c + 16];
+    uint8_t tag1[16];
+    uint8_t tag2[16];
+    aesKeyCtx_t ctx;
+    uint32_t run;
+    uint32_t i;
+
+    for( run = 0; run < runs; run++ )
+    {
+        uint32_t len = BenchRand() % (mBenchMaxMsg_c + 1);
+        uint32_t nonceLen = BenchRand() % (sizeof(nonce) + 1);
+        uint8_t headerLen = (uint8_t)(BenchRand() % (sizeof(header) + 1));
+
+        for( i = 0; i < 16; i++ )
+        {
+            key[i] = (uint8_t)BenchRand();
+            iv[i] = (uint8_t)BenchRand();
+        }
+        for( i = 0; i < sizeof(msg); i++ )
+        {
+            msg[i] = (uint8_t)BenchRand();
+        }
+        for( i = 0; i < sizeof(nonce); i++ )
+        {
+            nonce[i] = (uint8_t)BenchRand();
+        }
+        for( i = 0; i < sizeof(header); i++ )
+        {
+            header[i] = (uint8_t)BenchRand();
+        }
+        AES_128_CtxInit(&ctx, key);
+
+        /* CTR, both counters are incremented for each block */
+        memcpy(iv2, iv, 16);
+        AES_128_CTR(msg, len, iv, key, out1);
+        AES_128_CtxCTR(&ctx, msg, len, iv2, out2);
+        BenchExpect("CTR output", out2, out1, len);
+        BenchExpect("CTR counter", iv2, iv, 16);
+
+        /* OFB */
+        AES_128_OFB(msg, len, iv, key, out1);
+        memcpy(iv2, iv, 16);
+        AES_128_CtxOFB(&ctx, msg, len, iv2, out2);
+        BenchExpect("OFB output", out2, out1, len);
+        memcpy(iv2, iv, 16);
+        AES_128_CtxOFB(&ctx, out2, len, iv2, out2);
+        BenchExpect("OFB round trip", out2, msg, len);
+
+        /* CBC, a multiple of 16 bytes */
+        len &= ~0x0FU;
+        AES_128_CBC_Encrypt(msg, len, iv, key, out1);
+        memcpy(iv2, iv, 16);
+        AES_128_CtxCBC_Encrypt(&ctx, msg, len, iv2, out2);
+        BenchExpect("CBC output", out2, out1, len);
+        memcpy(iv2, iv, 16);
+        AES_128_CtxCBC_Decrypt(&ctx, out2, len, iv2, out2);
+        BenchExpect("CBC round trip", out2, msg, len);
+
+        /* CBC with padding */
+        len = BenchRand() % mBenchMaxMsg_c;
+        memcpy(out2, msg, len);
+        i = AES_128_CBC_Encrypt_And_Pad(out2, len, iv, key, out1);
+        if( (i & 0x0FU) || (i <= len) || (i > len + 16) )
+        {
+            BenchFail("AES_128_CBC_Encrypt_And_Pad() length", i);
+        }
+        if( len != AES_128_CBC_Decrypt_And_Depad(out1, i, iv, key, out2) )
+        {
+            BenchFail("AES_128_CBC_Decrypt_And_Depad() length", len);
+        }
+        BenchExpect("CBC pad round trip", out2, msg, len);
+
+        /* CMAC */
+        AES_128_CMAC(msg, len, key, tag1);
+        AES_128_CtxCMAC(&ctx, msg, len, tag2);
+        BenchExpect("CMAC", tag2, tag1, 16);
+
+        /* EAX, any nonce length */
+        if( (gSecSuccess_c != AES_128_EAX_Encrypt(msg, len, nonce, nonceLen, header, headerLen, key, out1, tag1)) ||
+            (gSecSuccess_c != AES_128_CtxEAX_Encrypt(&ctx, msg, len, nonce, nonceLen, header, headerLen, out2, tag2)) )
+        {
+            BenchFail("EAX encrypt status", len);
+        }
+        BenchExpect("EAX output", out2, out1, len);
+        BenchExpect("EAX tag", tag2, tag1, 16);
+        if( gSecSuccess_c != AES_128_EAX_Decrypt(out1, len, nonce, nonceLen, header, headerLen, key, out2, tag1) )
+        {
+            BenchFail("EAX decrypt status", len);
+        }
+        BenchExpect("EAX round trip", out2, msg, len);
+        if( gSecSuccess_c != BenchEaxStream(&ctx, nonce, nonceLen, header, headerLen, msg, len, out2, tag2, TRUE) )
+        {
+            BenchFail("EAX stream encrypt status", len);
+        }
+        BenchExpect("EAX stream output", out2, out1, len);
+        BenchExpect("EAX stream tag", tag2, tag1, 16);
+        if( gSecSuccess_c != BenchEaxStream(&ctx, nonce, nonceLen, header, headerLen, out2, len, out2, tag1, FALSE) )
+        {
+            BenchFail("EAX stream decrypt status", len);
+        }
+        BenchExpect("EAX stream round trip", out2, msg, len);
+
+        /* CCM and CCM*, any nonce and MIC size, unaligned, checked against the reference */
+        {
+            static const uint8_t macSizes[] = {0, 4, 6, 8, 10, 12, 14, 16};
+            uint8_t ccmNonceSize = (uint8_t)(7 + BenchRand() % 7);
+            uint8_t macSize = macSizes[BenchRand() % sizeof(macSizes)];
+            uint32_t ccmLen = len;
+            uint8_t *pOut = out2 + (BenchRand() & 3);
+
+            (void)BenchCcmRef(msg, ccmLen, header, headerLen, nonce, ccmNonceSize, key, out1, tag1, macSize, 1);
+            if( AES_128_CtxCCM(&ctx, msg, ccmLen, header, headerLen, nonce, ccmNonceSize, pOut, tag2, macSize, gSecLib_CCM_Encrypt_c) )
+            {
+                BenchFail("CCM encrypt status", ccmLen);
+            }
+            BenchExpect("CCM output", pOut, out1, ccmLen);
+            BenchExpect("CCM MIC", tag2, tag1, macSize);
+            if( AES_128_CtxCCM(&ctx, pOut, ccmLen, header, headerLen, nonce, ccmNonceSize, pOut, tag2, macSize, gSecLib_CCM_Decrypt_c) )
+            {
+                BenchFail("CCM decrypt status", ccmLen);
+            }
+            BenchExpect("CCM round trip", pOut, msg, ccmLen);
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Bench frames: the AES_128_xxx() functions and the key context ones.
+********************************************************************************** */
+static void BenchCtrLegacy(uint8_t *pIn, uint8_t *pOut)
+{
+    AES_128_CTR(pIn, mBenchFrameSize_c, mBenchIv, mBenchKey, pOut);
+}
+
+static void BenchCtrCtx(uint8_t *pIn, uint8_t *pOut)
+{
+    AES_128_CtxCTR(&mBenchCtx, pIn, mBenchFrameSize_c, mBenchIv, pOut);
+}
+
+static void BenchCbcLegacy(uint8_t *pIn, uint8_t *pOut)
+{
+    AES_128_CBC_Encrypt(pIn, mBenchFrameSize_c, mBenchIv, mBenchKey, pOut);
+}
+
+static void BenchCbcCtx(uint8_t *pIn, uint8_t *pOut)
+{
+    AES_128_CtxCBC_Encrypt(&mBenchCtx, pIn, mBenchFrameSize_c, mBenchIv, pOut);
+}
+
+static void BenchOfbLegacy(uint8_t *pIn, uint8_t *pOut)
+{
+    AES_128_OFB(pIn, mBenchFrameSize_c, mBenchIv, mBenchKey, pOut);
+}
+
+static void BenchOfbCtx(uint8_t *pIn, uint8_t *pOut)
+{
+    AES_128_CtxOFB(&mBenchCtx, pIn, mBenchFrameSize_c, mBenchIv, pOut);
+}
+
+static void BenchCmacLegacy(uint8_t *pIn, uint8_t *pOut)
+{
+    AES_128_CMAC(pIn, mBenchFrameSize_c, mBenchKey, pOut);
+}
+
+static void BenchCmacCtx(uint8_t *pIn, uint8_t *pOut)
+{
+    AES_128_CtxCMAC(&mBenchCtx, pIn, mBenchFrameSize_c, pOut);
+}
+
+static void BenchEaxLegacy(uint8_t *pIn, uint8_t *pOut)
+{
+    uint8_t tag[16];
+
+    (void)AES_128_EAX_Encrypt(pIn, mBenchFrameSize_c, mBenchNonce, sizeof(mBenchNonce),
+                              mBenchHeader, sizeof(mBenchHeader), mBenchKey, pOut, tag);
+}
+
+static void BenchEaxCtx(uint8_t *pIn, uint8_t *pOut)
+{
+    uint8_t tag[16];
+
+    (void)AES_128_CtxEAX_Encrypt(&mBenchCtx, pIn, mBenchFrameSize_c, mBenchNonce, sizeof(mBenchNonce),
+                                 mBenchHeader, sizeof(mBenchHeader), pOut, tag);
+}
+
+static void BenchEaxStreamCtx(uint8_t *pIn, uint8_t *pOut)
+{
+    aesEaxCtx_t eaxCtx;
+    uint8_t tag[16];
+
+    /* The frame arrives in two segments, as from the FSCI or the radio driver */
+    AES_128_EaxInit(&eaxCtx, &mBenchCtx, mBenchNonce, sizeof(mBenchNonce), TRUE);
+    AES_128_EaxUpdateAAD(&eaxCtx, mBenchHeader, sizeof(mBenchHeader));
+    AES_128_EaxUpdate(&eaxCtx, pIn, mBenchFrameSize_c / 2, pOut);
+    AES_128_EaxUpdate(&eaxCtx, pIn + mBenchFrameSize_c / 2, mBenchFrameSize_c - mBenchFrameSize_c / 2,
+                      pOut + mBenchFrameSize_c / 2);
+    (void)AES_128_EaxFinish(&eaxCtx, tag);
+}
+
+static void BenchCcmLegacy(uint8_t *pIn, uint8_t *pOut)
+{
+    uint8_t mic[8];
+
+    /* An 802.15.4 payload is not word aligned */
+    (void)AES_128_CCM(pIn + 1, mBenchFrameSize_c, mBenchHeader, sizeof(mBenchHeader), mBenchCcmNonce,
+                      sizeof(mBenchCcmNonce), mBenchKey, pOut + 1, mic, sizeof(mic), gSecLib_CCM_Encrypt_c);
+}
+
+static void BenchCcmCtx(uint8_t *pIn, uint8_t *pOut)
+{
+    uint8_t mic[8];
+
+    (void)AES_128_CtxCCM(&mBenchCtx, pIn + 1, mBenchFrameSize_c, mBenchHeader, sizeof(mBenchHeader), mBenchCcmNonce,
+                         sizeof(mBenchCcmNonce), pOut + 1, mic, sizeof(mic), gSecLib_CCM_Encrypt_c);
+}
+
+static void BenchRun(const char *pName, benchFrame_t legacy, benchFrame_t ctx, uint32_t frames)
+{
+    uint32_t in[mBenchFrameSize_c/sizeof(uint32_t) + 1];
+    uint32_t out[mBenchFrameSize_c/sizeof(uint32_t) + 1];
+    benchCounters_t cnt[2];
+    uint32_t i;
+    uint32_t f;
+
+    for( i = 0; i < mBenchFrameSize_c; i++ )
+    {
+        ((uint8_t*)in)[i] = (uint8_t)BenchRand();
+    }
+
+    memset(cnt, 0, sizeof(cnt));
+    for( i = 0; i < 2; i++ )
+    {
+        if( (i == 0) && (NULL == legacy) )
+        {
+            continue;
+        }
+        memset(&mCnt, 0, sizeof(mCnt));
+        if( i )
+        {
+            AES_128_CtxInit(&mBenchCtx, mBenchKey);
+        }
+        for( f = 0; f < frames; f++ )
+        {
+            (i ? ctx : legacy)((uint8_t*)in, (uint8_t*)out);
+        }
+        cnt[i] = mCnt;
+    }
+
+    for( i = (NULL == legacy) ? 1 : 0; i < 2; i++ )
+    {
+        printf("%-5s %-7s %8.2f %8.2f %8.2f %8.2f %8.2f   %6.3f %6.3f\n", pName, i ? "ctx" : "legacy",
+               (double)cnt[i].expansions / frames, (double)cnt[i].blocks / frames, (double)cnt[i].locks / frames,
+               (double)cnt[i].allocs / frames, (double)cnt[i].copyBytes / frames,
+               (double)cnt[i].expansions / (frames * mBenchFrameSize_c),
+               (double)cnt[i].locks / (frames * mBenchFrameSize_c));
+    }
+}
+
+static void BenchPerf(uint32_t frames)
+{
+    uint32_t i;
+
+    for( i = 0; i < 16; i++ )
+    {
+        mBenchKey[i] = (uint8_t)BenchRand();
+        mBenchIv[i] = (uint8_t)BenchRand();
+        mBenchNonce[i] = (uint8_t)BenchRand();
+    }
+    for( i = 0; i < sizeof(mBenchCcmNonce); i++ )
+    {
+        mBenchCcmNonce[i] = (uint8_t)BenchRand();
+    }
+    for( i = 0; i < sizeof(mBenchHeader); i++ )
+    {
+        mBenchHeader[i] = (uint8_t)BenchRand();
+    }
+
+    printf("%u frames of %u bytes, %s AES\n", frames, mBenchFrameSize_c,
+           FSL_FEATURE_SOC_MMCAU_COUNT ? "MMCAU" : "software");
+    printf("mode  API     expand/f blocks/f  locks/f  alloc/f  copyB/f   expand/B locks/B\n");
+    BenchRun("CTR", BenchCtrLegacy, BenchCtrCtx, frames);
+    BenchRun("CBC", BenchCbcLegacy, BenchCbcCtx, frames);
+    BenchRun("OFB", BenchOfbLegacy, BenchOfbCtx, frames);
+    BenchRun("CMAC", BenchCmacLegacy, BenchCmacCtx, frames);
+    BenchRun("EAX", BenchEaxLegacy, BenchEaxCtx, frames);
+    BenchRun("EAXs", NULL, BenchEaxStreamCtx, frames);
+    BenchRun("CCM", BenchCcmLegacy, BenchCcmCtx, frames);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char *argv[])
+{
+    const char *pMode = (argc > 1) ? argv[1] : "check";
+    uint32_t frames = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : mBenchDefaultFrames_c;
+    uint32_t i;
+
+    if( argc > 3 )
+    {
+        mRandState = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+    if( (0 == mRandState) || (0 == frames) )
+    {
+        printf("Usage: %s [check|bench [frames [seed]]]\n", argv[0]);
+        return 2;
+    }
+
+    for( i = 0; i < 256; i++ )
+    {
+        mInvSbox[mSbox[i]] = (uint8_t)i;
+    }
+    SecLib_Init();
+
+    if( 0 == strcmp(pMode, "bench") )
+    {
+        BenchPerf(frames);
+    }
+    else
+    {
+        BenchKat();
+        BenchKatEax();
+        BenchKatCcm();
+        BenchRandom(mBenchRandomRuns_c);
+    }
+
+    if( mLockHeld || mSleepVotes || mBuffers )
+    {
+        BenchFail("lock, low power vote or buffer left", mLockHeld + mSleepVotes + mBuffers);
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
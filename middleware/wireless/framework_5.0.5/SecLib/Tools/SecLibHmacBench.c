@@ -0,0 +1,593 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file SecLibHmacBench.c
+* Host known answer tests and benchmark of the SecLib HMAC-SHA256.
+*
+* SecLib.c is built with the MMCAU enabled (or with the software SHA256 when
+* FSL_FEATURE_SOC_MMCAU_COUNT is 0). The MMCAU and the software SHA256 are played
+* by a reference SHA256 compression function which counts its calls.
+*
+* check: the RFC 4231 test cases, run through HMAC_SHA256(), through a key context
+*   with HMAC_SHA256_CtxMac() on the message cut in random pieces, and with
+*   HMAC_SHA256_CtxInit(), HMAC_SHA256_Update() and HMAC_SHA256_Finish(). Random
+*   keys of 0 to 150 bytes and messages of 0 to 300 bytes are then MACed by both
+*   APIs, which must give the same MAC.
+* bench: messages of 32, 64 and 127 bytes are MACed by HMAC_SHA256() and with a key
+*   context loaded once; the SHA256 compressions are printed per MAC and per byte.
+*
+* Build (the device and low power directories are only needed for the include paths,
+* the tool defines the include guards of their headers):
+*   gcc -O2 -std=c99 -Wno-pointer-to-int-cast -I.. -I../../Common -I../../FunctionLib
+*       -I../../MemManager/Interface -I../../OSAbstraction/Interface
+*       -I../../Panic/Interface -I../../Lists -I../../LowPower/Interface/KW2xD
+*       -I../../../../mmcau_2.0.0 -I../../../../../devices/MKW24D5
+*       -o SecLibHmacBench SecLibHmacBench.c ../../FunctionLib/FunctionLib.c
+*   add -DFSL_FEATURE_SOC_MMCAU_COUNT=0 to build the software SHA256 path
+* Usage: SecLibHmacBench [check|bench [macs [seed]]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifndef FSL_FEATURE_SOC_MMCAU_COUNT
+#define FSL_FEATURE_SOC_MMCAU_COUNT     1
+#endif
+#define FSL_FEATURE_SOC_LTC_COUNT       0
+#define FSL_RTOS_FREE_RTOS
+#define gSecLibUseMutex_c               1
+#define cPWR_UsePowerDownMode           1
+#define mDbgRevertKeys_d                0
+
+/* Skip the device and low power headers */
+#define __FSL_DEVICE_REGISTERS_H__
+#define _PWR_INTERFACE_H_
+
+void PWR_AllowDeviceToSleep(void);
+void PWR_DisallowDeviceToSleep(void);
+
+static void* BenchAlloc(uint32_t numBytes);
+#define MEM_BufferAlloc(numBytes)       BenchAlloc(numBytes)
+
+#include "../SecLib.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultMacs_c         (1000)
+#define mBenchMaxKey_c              (150)
+#define mBenchMaxMsg_c              (300)
+#define mBenchRandomRuns_c          (2000)
+
+#define mBenchRotr_m(x, n)          (((x) >> (n)) | ((x) << (32 - (n))))
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef struct benchHmacVector_tag
+{
+    const char *pKey;       /* hex, or NULL for keyLen bytes of keyFill */
+    uint8_t     keyFill;
+    uint8_t     keyLen;
+    const char *pData;      /* text, or NULL for dataLen bytes of dataFill */
+    uint8_t     dataFill;
+    uint8_t     dataLen;
+    uint8_t     macLen;
+    const char *pMac;
+} benchHmacVector_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static const uint32_t mSha256K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t mSha256Iv[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/* RFC 4231, test cases 1 to 7 */
+static const benchHmacVector_t mHmacVectors[] =
+{
+    {NULL, 0x0b, 20, "Hi There", 0, 0, 32,
+     "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"},
+    {"4a656665", 0, 4, "what do ya want for nothing?", 0, 0, 32,
+     "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"},
+    {NULL, 0xaa, 20, NULL, 0xdd, 50, 32,
+     "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe"},
+    {"0102030405060708090a0b0c0d0e0f10111213141516171819", 0, 25, NULL, 0xcd, 50, 32,
+     "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b"},
+    {NULL, 0x0c, 20, "Test With Truncation", 0, 0, 16,
+     "a3b6167473100ee06e0c796c2955552b"},
+    {NULL, 0xaa, 131, "Test Using Larger Than Block-Size Key - Hash Key First", 0, 0, 32,
+     "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"},
+    {NULL, 0xaa, 131, "This is a test using a larger than block-size key and a larger than block-size "
+                      "data. The key needs to be hashed before being used by the HMAC algorithm.", 0, 0, 32,
+     "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2"}
+};
+
+static uint32_t mCompressions;
+static uint32_t mLockHeld;
+static uint32_t mSleepVotes;
+static uint32_t mBuffers;
+static uint32_t mFailures;
+static uint32_t mRandState = 0x2545F491;
+
+const uint32_t gEcP256_MultiplicationBufferSize_c = 1;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    /* xorshift32 */
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 17;
+    mRandState ^= mRandState << 5;
+    return mRandState;
+}
+
+static void BenchFail(const char *pWhat, uint32_t value)
+{
+    if( mFailures < 20 )
+    {
+        printf("FAIL: %s (%u)\n", pWhat, value);
+    }
+    mFailures++;
+}
+
+/*! *********************************************************************************
+* \brief  Reference SHA256 compression function, used as the MMCAU and as the
+*         software SHA256. The state is kept in native words, as by the MMCAU.
+********************************************************************************** */
+static void BenchSha256Compress(const uint8_t *pBlock, uint32_t *pState)
+{
+    uint32_t w[64];
+    uint32_t s[8];
+    uint32_t t1;
+    uint32_t t2;
+    uint32_t i;
+
+    for( i = 0; i < 16; i++ )
+    {
+        w[i] = ((uint32_t)pBlock[4*i] << 24) | ((uint32_t)pBlock[4*i + 1] << 16) |
+               ((uint32_t)pBlock[4*i + 2] << 8) | pBlock[4*i + 3];
+    }
+    for( i = 16; i < 64; i++ )
+    {
+        w[i] = w[i - 16] + w[i - 7] +
+               (mBenchRotr_m(w[i - 15], 7) ^ mBenchRotr_m(w[i - 15], 18) ^ (w[i - 15] >> 3)) +
+               (mBenchRotr_m(w[i - 2], 17) ^ mBenchRotr_m(w[i - 2], 19) ^ (w[i - 2] >> 10));
+    }
+
+    memcpy(s, pState, sizeof(s));
+    for( i = 0; i < 64; i++ )
+    {
+        t1 = s[7] + (mBenchRotr_m(s[4], 6) ^ mBenchRotr_m(s[4], 11) ^ mBenchRotr_m(s[4], 25)) +
+             ((s[4] & s[5]) ^ (~s[4] & s[6])) + mSha256K[i] + w[i];
+        t2 = (mBenchRotr_m(s[0], 2) ^ mBenchRotr_m(s[0], 13) ^ mBenchRotr_m(s[0], 22)) +
+             ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+        memmove(&s[1], &s[0], 7 * sizeof(uint32_t));
+        s[4] += t1;
+        s[0] = t1 + t2;
+    }
+    for( i = 0; i < 8; i++ )
+    {
+        pState[i] += s[i];
+    }
+    mCompressions++;
+}
+
+int mmcau_sha256_initialize_output(const unsigned int *output)
+{
+    memcpy((void*)output, mSha256Iv, sizeof(mSha256Iv));
+    return 0;
+}
+
+void mmcau_sha256_hash_n(const unsigned char *input, const int num_blks, unsigned int *output)
+{
+    int i;
+
+    for( i = 0; i < num_blks; i++ )
+    {
+        BenchSha256Compress(input + 64 * i, (uint32_t*)output);
+    }
+}
+
+void sw_sha256_initialize_output(uint32_t *sha256_state)
+{
+    memcpy(sha256_state, mSha256Iv, sizeof(mSha256Iv));
+}
+
+void sw_sha256_hash_n(uint8_t *msg_data, int32_t num_blks, uint32_t *sha256_state)
+{
+    mmcau_sha256_hash_n(msg_data, num_blks, sha256_state);
+}
+
+/*! *********************************************************************************
+* \brief  The AES, SHA1 and ECDH functions are not used by the tool.
+********************************************************************************** */
+void mmcau_aes_set_key(const unsigned char *key, const int key_size, unsigned char *key_sch) { (void)key; (void)key_size; memset(key_sch, 0, 176); }
+void mmcau_aes_encrypt(const unsigned char *in, const unsigned char *key_sch, const int nr, unsigned char *out) { (void)in; (void)key_sch; (void)nr; memset(out, 0, 16); }
+void mmcau_aes_decrypt(const unsigned char *in, const unsigned char *key_sch, const int nr, unsigned char *out) { (void)in; (void)key_sch; (void)nr; memset(out, 0, 16); }
+void sw_Aes128(const uint8_t *pData, const uint8_t *pKey, uint8_t enc, uint8_t *pReturnData) { (void)pData; (void)pKey; (void)enc; memset(pReturnData, 0, 16); }
+uint8_t sw_AES128_CCM(uint8_t* pInput, uint16_t inputLen, uint8_t* pAuthData, uint16_t authDataLen,
+                      uint8_t* pNonce, uint8_t nonceSize, uint8_t* pKey, uint8_t* pOutput,
+                      uint8_t* pCbcMac, uint8_t macSize, uint32_t flags)
+{
+    (void)pInput; (void)inputLen; (void)pAuthData; (void)authDataLen; (void)pNonce; (void)nonceSize;
+    (void)pKey; (void)pOutput; (void)pCbcMac; (void)macSize; (void)flags;
+    return 1;
+}
+void mmcau_sha1_initialize_output(const unsigned int *sha1_state) { (void)sha1_state; }
+void mmcau_sha1_hash_n(const unsigned char *msg_data, const int num_blks, unsigned int *sha1_state) { (void)msg_data; (void)num_blks; (void)sha1_state; }
+void sw_sha1_initialize_output(uint32_t *sha1_state) { (void)sha1_state; }
+void sw_sha1_hash_n(uint8_t *msg_data, int32_t num_blks, uint32_t *sha1_state) { (void)msg_data; (void)num_blks; (void)sha1_state; }
+
+ecdhStatus_t Ecdh_GenerateNewKeys(ecdhPublicKey_t* pOutPublicKey, ecdhPrivateKey_t* pOutPrivateKey, void* pMultiplicationBuffer)
+{
+    (void)pOutPublicKey; (void)pOutPrivateKey; (void)pMultiplicationBuffer;
+    return gEcdhBadParameters_c;
+}
+
+ecdhStatus_t Ecdh_ComputeDhKey(ecdhPrivateKey_t* pPrivateKey, ecdhPublicKey_t* pPeerPublicKey, ecdhDhKey_t* pOutDhKey, void* pMultiplicationBuffer)
+{
+    (void)pPrivateKey; (void)pPeerPublicKey; (void)pOutDhKey; (void)pMultiplicationBuffer;
+    return gEcdhBadParameters_c;
+}
+
+osaMutexId_t OSA_MutexCreate(void)
+{
+    return (osaMutexId_t)&mLockHeld;
+}
+
+osaStatus_t OSA_MutexLock(osaMutexId_t mutexId, uint32_t millisec)
+{
+    (void)millisec;
+    if( (mutexId != (osaMutexId_t)&mLockHeld) || mLockHeld )
+    {
+        BenchFail("mutex locked twice", 0);
+    }
+    mLockHeld = 1;
+    return osaStatus_Success;
+}
+
+osaStatus_t OSA_MutexUnlock(osaMutexId_t mutexId)
+{
+    if( (mutexId != (osaMutexId_t)&mLockHeld) || !mLockHeld )
+    {
+        BenchFail("mutex not locked", 0);
+    }
+    mLockHeld = 0;
+    return osaStatus_Success;
+}
+
+void PWR_DisallowDeviceToSleep(void)
+{
+    mSleepVotes++;
+}
+
+void PWR_AllowDeviceToSleep(void)
+{
+    if( 0 == mSleepVotes )
+    {
+        BenchFail("low power vote released twice", 0);
+    }
+    else
+    {
+        mSleepVotes--;
+    }
+}
+
+static void* BenchAlloc(uint32_t numBytes)
+{
+    mBuffers++;
+    return malloc(numBytes ? numBytes : 1);
+}
+
+memStatus_t MEM_BufferFree(void* buffer)
+{
+    mBuffers--;
+    free(buffer);
+    return MEM_SUCCESS_c;
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    (void)id; (void)location; (void)extra1; (void)extra2;
+    printf("FAIL: panic\n");
+    exit(1);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static void BenchExpect(const char *pWhat, const uint8_t *pGot, const uint8_t *pExpected, uint32_t len)
+{
+    if( memcmp(pGot, pExpected, len) )
+    {
+        BenchFail(pWhat, len);
+    }
+}
+
+static uint32_t BenchHex(const char *pHex, uint8_t *pOut)
+{
+    uint32_t len = 0;
+    unsigned int byte;
+
+    while( pHex[0] && pHex[1] && (1 == sscanf(pHex, "%2x", &byte)) )
+    {
+        pOut[len++] = (uint8_t)byte;
+        pHex += 2;
+    }
+    return len;
+}
+
+/*! *********************************************************************************
+* \brief  HMAC_SHA256_CtxMac() on a message cut in up to 8 random pieces, some of
+*         them empty.
+********************************************************************************** */
+static void BenchCtxMacPieces(const hmacSha256KeyCtx_t *pKeyCtx, uint8_t *pMsg, uint32_t msgLen, uint8_t *pMac)
+{
+    uint8_t *apMsg[8];
+    uint32_t aMsgLen[8];
+    uint32_t count = 1 + BenchRand() % 8;
+    uint32_t pos = 0;
+    uint32_t i;
+
+    for( i = 0; i < count; i++ )
+    {
+        aMsgLen[i] = (i == count - 1) ? msgLen - pos : BenchRand() % (msgLen - pos + 1);
+        apMsg[i] = pMsg + pos;
+        pos += aMsgLen[i];
+    }
+    HMAC_SHA256_CtxMac(pKeyCtx, apMsg, aMsgLen, count, pMac);
+}
+
+/*! *********************************************************************************
+* \brief  RFC 4231 test cases, through the three APIs.
+********************************************************************************** */
+static void BenchKat(void)
+{
+    uint8_t key[mBenchMaxKey_c];
+    uint8_t data[mBenchMaxMsg_c];
+    uint8_t mac[SHA256_HASH_SIZE];
+    uint8_t expected[SHA256_HASH_SIZE];
+    uint32_t dataLen;
+    HMAC_SHA256_context_t ctx;
+    hmacSha256KeyCtx_t keyCtx;
+    uint32_t i;
+
+    for( i = 0; i < sizeof(mHmacVectors)/sizeof(mHmacVectors[0]); i++ )
+    {
+        const benchHmacVector_t *pV = &mHmacVectors[i];
+
+        if( pV->pKey )
+        {
+            (void)BenchHex(pV->pKey, key);
+        }
+        else
+        {
+            memset(key, pV->keyFill, pV->keyLen);
+        }
+        if( pV->pData )
+        {
+            dataLen = (uint32_t)strlen(pV->pData);
+            memcpy(data, pV->pData, dataLen);
+        }
+        else
+        {
+            dataLen = pV->dataLen;
+            memset(data, pV->dataFill, dataLen);
+        }
+        (void)BenchHex(pV->pMac, expected);
+
+        HMAC_SHA256(&ctx, key, pV->keyLen, data, dataLen);
+        BenchExpect("HMAC_SHA256()", (uint8_t*)ctx.shaCtx.hash, expected, pV->macLen);
+
+        HMAC_SHA256_KeyInit(&keyCtx, key, pV->keyLen);
+        BenchCtxMacPieces(&keyCtx, data, dataLen, mac);
+        BenchExpect("HMAC_SHA256_CtxMac()", mac, expected, pV->macLen);
+
+        HMAC_SHA256_CtxInit(&ctx, &keyCtx);
+        HMAC_SHA256_Update(&ctx, data, dataLen / 2);
+        HMAC_SHA256_Update(&ctx, data + dataLen / 2, dataLen - dataLen / 2);
+        HMAC_SHA256_Finish(&ctx);
+        BenchExpect("HMAC_SHA256_CtxInit()", (uint8_t*)ctx.shaCtx.hash, expected, pV->macLen);
+
+        /* A key context is reused for any number of MACs */
+        BenchCtxMacPieces(&keyCtx, data, dataLen, mac);
+        BenchExpect("HMAC_SHA256_CtxMac() reused", mac, expected, pV->macLen);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Random keys and messages through both APIs: same MAC.
+********************************************************************************** */
+static void BenchRandom(uint32_t runs)
+{
+    uint8_t key[mBenchMaxKey_c];
+    uint8_t msg[mBenchMaxMsg_c];
+    uint8_t mac[SHA256_HASH_SIZE];
+    HMAC_SHA256_context_t ctx;
+    hmacSha256KeyCtx_t keyCtx;
+    uint32_t run;
+    uint32_t i;
+
+    for( run = 0; run < runs; run++ )
+    {
+        uint32_t keyLen = BenchRand() % (mBenchMaxKey_c + 1);
+        uint32_t len = BenchRand() % (mBenchMaxMsg_c + 1);
+
+        for( i = 0; i < keyLen; i++ )
+        {
+            key[i] = (uint8_t)BenchRand();
+        }
+        for( i = 0; i < len; i++ )
+        {
+            msg[i] = (uint8_t)BenchRand();
+        }
+
+        HMAC_SHA256(&ctx, key, keyLen, msg, len);
+        HMAC_SHA256_KeyInit(&keyCtx, key, keyLen);
+        BenchCtxMacPieces(&keyCtx, msg, len, mac);
+        BenchExpect("HMAC_SHA256_CtxMac() random", mac, (uint8_t*)ctx.shaCtx.hash, SHA256_HASH_SIZE);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  SHA256 compressions per MAC, with HMAC_SHA256() and with a key context.
+********************************************************************************** */
+static void BenchRun(uint32_t msgLen, uint32_t macs)
+{
+    uint8_t key[32];
+    uint8_t msg[mBenchMaxMsg_c];
+    uint8_t mac[SHA256_HASH_SIZE];
+    uint8_t *pMsg = msg;
+    HMAC_SHA256_context_t ctx;
+    hmacSha256KeyCtx_t keyCtx;
+    uint32_t legacy;
+    uint32_t keyed;
+    uint32_t setup;
+    uint32_t i;
+
+    for( i = 0; i < sizeof(key); i++ )
+    {
+        key[i] = (uint8_t)BenchRand();
+    }
+    for( i = 0; i < msgLen; i++ )
+    {
+        msg[i] = (uint8_t)BenchRand();
+    }
+
+    mCompressions = 0;
+    for( i = 0; i < macs; i++ )
+    {
+        HMAC_SHA256(&ctx, key, sizeof(key), msg, msgLen);
+    }
+    legacy = mCompressions;
+
+    mCompressions = 0;
+    HMAC_SHA256_KeyInit(&keyCtx, key, sizeof(key));
+    setup = mCompressions;
+    for( i = 0; i < macs; i++ )
+    {
+        HMAC_SHA256_CtxMac(&keyCtx, &pMsg, &msgLen, 1, mac);
+    }
+    keyed = mCompressions - setup;
+
+    printf("%5u   %-7s %8.2f %8.3f\n", msgLen, "legacy", (double)legacy / macs, (double)legacy / (macs * msgLen));
+    printf("%5u   %-7s %8.2f %8.3f   + %u once\n", msgLen, "ctx", (double)keyed / macs,
+           (double)keyed / (macs * msgLen), setup);
+}
+
+static void BenchPerf(uint32_t macs)
+{
+    printf("%u MACs per length, 32-byte key, %s SHA256\n", macs,
+           FSL_FEATURE_SOC_MMCAU_COUNT ? "MMCAU" : "software");
+    printf("bytes   API     compr/MAC compr/B\n");
+    BenchRun(32, macs);
+    BenchRun(64, macs);
+    BenchRun(127, macs);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char *argv[])
+{
+    const char *pMode = (argc > 1) ? argv[1] : "check";
+    uint32_t macs = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : mBenchDefaultMacs_c;
+
+    if( argc > 3 )
+    {
+        mRandState = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+    if( (0 == mRandState) || (0 == macs) )
+    {
+        printf("Usage: %s [check|bench [macs [seed]]]\n", argv[0]);
+        return 2;
+    }
+
+    SecLib_Init();
+
+    if( 0 == strcmp(pMode, "bench") )
+    {
+        BenchPerf(macs);
+    }
+    else
+    {
+        BenchKat();
+        BenchRandom(mBenchRandomRuns_c);
+    }
+
+    if( mLockHeld || mSleepVotes || mBuffers )
+    {
+        BenchFail("lock, low power vote or buffer left", mLockHeld + mSleepVotes + mBuffers);
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
@@ -195,6 +195,12 @@ BigEndian=1/LittleEndian=0, newline, commas or spaces (between bytes) */
 /* Serial Manager callback type */
 typedef void (*pSerialCallBack_t)(void* param);
 
+/* A data segment of a scatter-gather transmission */
+typedef struct serialSegment_tag{
+    uint8_t  *pData;
+    uint16_t  dataSize;
+}serialSegment_t;
+
 /* Supported baudrates for UART */
 typedef enum{
     gUARTBaudRate1200_c   =   1200UL,
@@ -269,12 +275,18 @@ serialStatus_t Serial_InitInterface (uint8_t *pInterfaceId,
 serialStatus_t Serial_SetBaudRate (uint8_t InterfaceId, uint32_t baudRate);
 
 serialStatus_t Serial_RxBufferByteCount (uint8_t InterfaceId, uint16_t *bytesCount);
+serialStatus_t Serial_RxDroppedCount (uint8_t InterfaceId, uint32_t *pCount);
 serialStatus_t Serial_SetRxCallBack (uint8_t InterfaceId, pSerialCallBack_t cb, void *pRxParam);
 serialStatus_t Serial_Read (uint8_t InterfaceId, uint8_t *pData, uint16_t dataSize, uint16_t *bytesRead);
+serialStatus_t Serial_RxPeek (uint8_t InterfaceId, uint8_t **ppData, uint16_t *pBytes);
+serialStatus_t Serial_RxConsume (uint8_t InterfaceId, uint16_t bytes);
 
 serialStatus_t Serial_SyncWrite (uint8_t InterfaceId, uint8_t *pBuf, uint16_t bufLen);
 serialStatus_t Serial_AsyncWrite (uint8_t InterfaceId, uint8_t *pBuf, uint16_t bufLen,
                                   pSerialCallBack_t cb, void *pTxParam);
+serialStatus_t Serial_SyncWriteV (uint8_t InterfaceId, const serialSegment_t *pSegments, uint8_t segmentsCount);
+serialStatus_t Serial_AsyncWriteV (uint8_t InterfaceId, const serialSegment_t *pSegments, uint8_t segmentsCount,
+                                   pSerialCallBack_t cb, void *pTxParam);
 
 serialStatus_t Serial_Print (uint8_t InterfaceId, char * pString, serialBlock_t allowToBlock);
 serialStatus_t Serial_PrintHex (uint8_t InterfaceId, uint8_t *hex, uint8_t len, uint8_t flags);
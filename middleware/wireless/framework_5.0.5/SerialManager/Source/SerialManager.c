@@ -100,6 +100,11 @@
 
 #define gSMRxBufSize_c (gSerialMgrRxBufSize_c + 1)
 
+/* The Rx buffer is a single producer / single consumer ring: the producer (the
+   driver ISR or callback) only writes rxIn and the consumer only writes rxOut.
+   The barrier orders the Rx buffer accesses with the index updates. */
+#define mSerial_RxBarrier_d() __DMB()
+
 #define mSMGR_DapIsrPrio_c    (0x80)
 
 #if gSerialMgrUseFSCIHdr_c
@@ -123,13 +128,17 @@ typedef uint16_t bufIndex_t;
 
 /*
  * Defines events recognized by the SerialManager's Task
- * Message used to enque async tx data
+ * Message used to enque async tx data. pData and dataSize describe the segment
+ * being transmitted; the segments of a scatter-gather message that follow it
+ * are sent one after the other, without being copied.
  */
 typedef struct SerialManagetMsg_tag{
     pSerialCallBack_t txCallback;
     void             *pTxParam;
     uint8_t          *pData;
     uint16_t          dataSize;
+    uint8_t           segmentsLeft;
+    const serialSegment_t *pSegments;
 }SerialMsg_t;
 
 /*
@@ -141,6 +150,13 @@ typedef struct serial_tag{
     /* Rx parameters */
     volatile bufIndex_t    rxIn;
     volatile bufIndex_t    rxOut;
+    /* Bytes dropped on a full Rx buffer, counted by the producer, or by the consumer
+       for the eDMA which overwrites them */
+    uint32_t               rxDropped;
+#if gSerialMgrUseUart_c && gUartRxDma_d
+    volatile uint32_t      rxDmaCount;   /* bytes written by the eDMA */
+    uint32_t               rxReadCount;  /* bytes released by the consumer */
+#endif
     pSerialCallBack_t      rxCallback;
     void                  *pRxParam;
     uint8_t                rxBuffer[gSMRxBufSize_c];
@@ -210,6 +226,20 @@ static void  Serial_SyncTxCallback(void *pSer);
 #endif
 static void  Serial_TxQueueMaintenance(serial_t *pSer);
 static serialStatus_t Serial_WriteInternal (uint8_t InterfaceId);
+static serialStatus_t Serial_TxEnqueue (uint8_t InterfaceId, uint8_t *pBuf, uint16_t bufLen,
+                                        const serialSegment_t *pSegments, uint8_t segmentsLeft,
+                                        pSerialCallBack_t cb, void *pTxParam);
+static void Serial_SyncTxWait(uint8_t InterfaceId, pSerialCallBack_t cb);
+static bool_t Serial_TxNextSegment(SerialMsg_t *pMsg);
+static uint16_t Serial_RxContiguousCount(serial_t *pSer);
+static void Serial_RxAdvance(serial_t *pSer, uint16_t bytes);
+static void Serial_RxReadNotify(uint8_t InterfaceId);
+#if gSerialMgrUseUart_c && gUartRxDma_d
+static void Serial_RxDmaResync(serial_t *pSer);
+#endif
+#if (gSerialMgrUseUSB_c) || (gSerialMgrUseUSB_VNIC_c) || (gSerialMgrUseCustomInterface_c)
+static uint16_t Serial_RxWrite(serial_t *pSer, const uint8_t *pData, uint32_t size);
+#endif
 #if (gSerialMgrUseSPI_c) || (gSerialMgrUseIIC_c)
 static uint32_t Serial_GetInterfaceIdFromType(serialInterfaceType_t type);
 #endif
@@ -224,6 +254,9 @@ static void Serial_SpiSendDummyByte(uint32_t i);
 #if (gSerialMgrUseUart_c)
 static void Serial_UartRxCb(uartState_t* state);
 static void Serial_UartTxCb(uartState_t* state);
+#if gUartRxDma_d
+static void Serial_UartDmaRxNotify(uint32_t i, uint8_t *pRxEnd, uint32_t count);
+#endif
 #endif
 
 /*
@@ -514,8 +547,12 @@ serialStatus_t Serial_InitInterface( uint8_t *pInterfaceId,
             case gSerialMgrUart_c:
 #if gSerialMgrUseUart_c && FSL_FEATURE_SOC_UART_COUNT
                 UART_Initialize(instance, &mDrvData[i].uartState);
-                mDrvData[i].uartState.pRxData = pSer->rxBuffer;
                 UART_InstallRxCalback(instance, Serial_UartRxCb, i);
+#if gUartRxDma_d
+                UART_ReceiveDataCircular(instance, pSer->rxBuffer, gSMRxBufSize_c);
+#else
+                mDrvData[i].uartState.pRxData = pSer->rxBuffer;
+#endif
                 UART_InstallTxCalback(instance, Serial_UartTxCb, i);
 #endif
                 break;
@@ -671,84 +708,83 @@ serialStatus_t Serial_AsyncWrite( uint8_t InterfaceId,
 {
     serialStatus_t status = gSerial_Success_c;
 #if gSerialManagerMaxInterfaces_c
-    SerialMsg_t *pMsg = NULL;
-    serial_t *pSer = &mSerials[InterfaceId];
-
 #if gSerialMgr_ParamValidation_d
     if( (NULL == pBuf) || (0 == bufLen) || (InterfaceId >= gSerialManagerMaxInterfaces_c) ||
-        (pSer->serialType == gSerialMgrNone_c) )
+        (mSerials[InterfaceId].serialType == gSerialMgrNone_c) )
     {
         status = gSerial_InvalidParameter_c;
     }
     else
 #endif
     {
+        status = Serial_TxEnqueue(InterfaceId, pBuf, bufLen, NULL, 0, cb, pTxParam);
+    }
+#else
+    (void)InterfaceId;
+    (void)pBuf;
+    (void)bufLen;
+    (void)cb;
+    (void)pTxParam;
+#endif /* gSerialManagerMaxInterfaces_c */
+    return status;
+}
 
-#if (gSerialMgr_BlockSenderOnQueueFull_c == 0) || ((gSerialMgr_BlockSenderOnQueueFull_c) && (gSMGR_UseOsSemForSynchronization_c))
-        osaTaskId_t taskHandler = OSA_TaskGetId();
-#endif
+/*! *********************************************************************************
+* \brief   Transmit a list of data segments asynchronously, as a single message.
+*          The segments are sent one after the other, in order, without being
+*          copied or coalesced; empty segments are skipped.
+*
+* \param[in] InterfaceId the interface number
+* \param[in] pSegments pointer to the segments. The segments list and the data it
+*            points to must be kept unchanged until the callback is run
+* \param[in] segmentsCount the number of segments
+* \param[in] cb pointer to a function that will be called when all the segments
+*            were sent
+* \param[in] pTxParam the parameter of the callback
+*
+* \return The status of the operation
+*
+********************************************************************************** */
+serialStatus_t Serial_AsyncWriteV( uint8_t InterfaceId,
+                                   const serialSegment_t *pSegments,
+                                   uint8_t segmentsCount,
+                                   pSerialCallBack_t cb,
+                                   void *pTxParam )
+{
+    serialStatus_t status = gSerial_InvalidParameter_c;
+#if gSerialManagerMaxInterfaces_c
+    uint32_t i;
 
-#if (gSerialMgr_BlockSenderOnQueueFull_c == 0)
-        if( taskHandler == gSerialManagerTaskId )
+#if gSerialMgr_ParamValidation_d
+    if( (NULL == pSegments) || (InterfaceId >= gSerialManagerMaxInterfaces_c) ||
+        (mSerials[InterfaceId].serialType == gSerialMgrNone_c) )
+    {
+        segmentsCount = 0;
+    }
+
+    for( i = 0; i < segmentsCount; i++ )
+    {
+        if( pSegments[i].dataSize && (NULL == pSegments[i].pData) )
         {
-            Serial_TxQueueMaintenance(pSer);
+            segmentsCount = 0;
         }
+    }
 #endif
 
-        /* Check if slot is free */
-        do {
-            OSA_InterruptDisable();
-
-            if( (0 == pSer->txQueue[pSer->txIn].dataSize) && (NULL == pSer->txQueue[pSer->txIn].txCallback) && (pSer->txNo < gSerialMgrTxQueueSize_c) )
-            {
-                pMsg = &pSer->txQueue[pSer->txIn];
-                pMsg->dataSize   = bufLen;
-                pMsg->pData      = (void*)pBuf;
-                pMsg->txCallback = cb;
-                pMsg->pTxParam   = pTxParam;
-                mSerial_IncIdx_d(pSer->txIn, gSerialMgrTxQueueSize_c)
-                pSer->txNo++;
-            }
-#if (gSerialMgr_BlockSenderOnQueueFull_c) && (gSMGR_UseOsSemForSynchronization_c)
-            else
-            {
-                if(taskHandler != gSerialManagerTaskId)
-                {
-                    pSer->txBlockedTasks++;
-                }
-            }
-#endif
-            OSA_InterruptEnable();
-
-            if( pMsg )
-            {
-                status = Serial_WriteInternal( InterfaceId );
-                break;
-            }
-            else
-            {
-                status = gSerial_OutOfMemory_c;
-#if gSerialMgr_BlockSenderOnQueueFull_c
-#if gSMGR_UseOsSemForSynchronization_c
-                if(taskHandler != gSerialManagerTaskId)
-                {
-                    (void)OSA_SemaphoreWait(pSer->txQueueSemId, osaWaitForever_c);
-                }
-                else
-#endif
-                {
-                    Serial_TxQueueMaintenance(pSer);
-                }
-#else
-                break;
-#endif
-            }
-        } while( status != gSerial_Success_c );
+    /* The first segment is queued by value, the rest of them by reference */
+    for( i = 0; i < segmentsCount; i++ )
+    {
+        if( pSegments[i].dataSize )
+        {
+            status = Serial_TxEnqueue(InterfaceId, pSegments[i].pData, pSegments[i].dataSize,
+                                      &pSegments[i + 1], segmentsCount - i - 1, cb, pTxParam);
+            break;
+        }
     }
 #else
     (void)InterfaceId;
-    (void)pBuf;
-    (void)bufLen;
+    (void)pSegments;
+    (void)segmentsCount;
     (void)cb;
     (void)pTxParam;
 #endif /* gSerialManagerMaxInterfaces_c */
@@ -785,39 +821,7 @@ serialStatus_t Serial_SyncWrite( uint8_t InterfaceId,
 
     if( gSerial_Success_c == status )
     {
-        /* Wait until Tx finishes. The sem will be released by the SMGR task */
-#if gSMGR_UseOsSemForSynchronization_c
-        if( cb )
-        {
-            (void)OSA_SemaphoreWait(pSer->txSyncSemId, osaWaitForever_c);
-        }
-        else
-#endif
-        {
-            while(pSer->state) {}
-        }
-#if (gSerialMgrUseUart_c)
-        switch (pSer->serialType)
-        {
-#if FSL_FEATURE_SOC_UART_COUNT
-        case gSerialMgrUart_c:
-            while(UART_IsTxActive(pSer->serialChannel)) {}
-            break;
-#endif
-#if FSL_FEATURE_SOC_LPUART_COUNT
-        case gSerialMgrLpuart_c:
-            while(LPUART_IsTxActive(pSer->serialChannel)) {}
-            break;
-#endif
-#if FSL_FEATURE_SOC_LPSCI_COUNT
-        case gSerialMgrLpsci_c:
-            while(LPSCI_IsTxActive(pSer->serialChannel)) {}
-            break;
-#endif
-        default:
-            break;
-        }
-#endif
+        Serial_SyncTxWait(InterfaceId, cb);
     }
 #else
     (void)pBuf;
@@ -827,6 +831,46 @@ serialStatus_t Serial_SyncWrite( uint8_t InterfaceId,
     return status;
 }
 
+/*! *********************************************************************************
+* \brief Transmit a list of data segments synchronously, as a single message.
+*        The task will block until the Tx is done
+*
+* \param[in] InterfaceId the interface number
+* \param[in] pSegments pointer to the segments
+* \param[in] segmentsCount the number of segments
+*
+* \return The status of the operation
+*
+********************************************************************************** */
+serialStatus_t Serial_SyncWriteV( uint8_t InterfaceId,
+                                  const serialSegment_t *pSegments,
+                                  uint8_t segmentsCount )
+{
+    serialStatus_t status = gSerial_Success_c;
+#if gSerialManagerMaxInterfaces_c
+    pSerialCallBack_t cb = NULL;
+    serial_t *pSer = &mSerials[InterfaceId];
+
+#if gSMGR_UseOsSemForSynchronization_c
+    /* If the calling task is SMGR do not block on semaphore */
+    if( OSA_TaskGetId() != gSerialManagerTaskId )
+         cb = Serial_SyncTxCallback;
+#endif
+
+    status  = Serial_AsyncWriteV(InterfaceId, pSegments, segmentsCount, cb, pSer);
+
+    if( gSerial_Success_c == status )
+    {
+        Serial_SyncTxWait(InterfaceId, cb);
+    }
+#else
+    (void)pSegments;
+    (void)segmentsCount;
+    (void)InterfaceId;
+#endif /* gSerialManagerMaxInterfaces_c */
+    return status;
+}
+
 /*! *********************************************************************************
 * \brief   Returns a specified number of characters from the Rx buffer
 *
@@ -843,7 +887,7 @@ serialStatus_t Serial_Read( uint8_t InterfaceId, uint8_t *pData, uint16_t dataSi
     serialStatus_t status = gSerial_Success_c;
 #if (gSerialManagerMaxInterfaces_c)
     serial_t *pSer = &mSerials[InterfaceId];
-    uint16_t i, bytes;
+    uint16_t span, bytes = 0;
 
 #if gSerialMgr_ParamValidation_d
     if ( (InterfaceId >= gSerialManagerMaxInterfaces_c) || (NULL == pData) || (0 == dataSize) )
@@ -853,50 +897,26 @@ serialStatus_t Serial_Read( uint8_t InterfaceId, uint8_t *pData, uint16_t dataSi
     else
 #endif
     {
-        /* Copy bytes from the SMGR Rx buffer */
-        Serial_RxBufferByteCount(InterfaceId, &bytes);
-
-        if( bytes > 0 )
+        /* Copy the bytes up to the end of the Rx buffer, then from its start */
+        do
         {
-            if( bytes > dataSize )
+            span = Serial_RxContiguousCount(pSer);
+
+            if( span > dataSize - bytes )
             {
-                bytes = dataSize;
+                span = dataSize - bytes;
             }
 
-            /* Copy data */
-            for( i=0; i<bytes; i++ )
+            if( span )
             {
-                OSA_InterruptDisable();
-                *pData++ = pSer->rxBuffer[pSer->rxOut++];
-                if ( pSer->rxOut >= gSMRxBufSize_c )
-                {
-                    pSer->rxOut = 0;
-                }
-                OSA_InterruptEnable();
+                FLib_MemCpy(&pData[bytes], &pSer->rxBuffer[pSer->rxOut], span);
+                Serial_RxAdvance(pSer, span);
+                bytes += span;
             }
-
-            dataSize -= bytes;
-        }
+        } while( span && (bytes < dataSize) && (0 == pSer->rxOut) );
 
         /* Aditional processing depending on interface */
-        switch ( pSer->serialType )
-        {
-#if gSerialMgrUseUSB_c
-        case gSerialMgrUSB_c:
-            VirtualCom_SMReadNotify( mDrvData[InterfaceId].pDrvData );
-            break;
-#endif
-
-#if gSerialMgrUseUSB_VNIC_c
-        case gSerialMgrUSB_VNIC_c:
-            VirtualNic_SMReadNotify( mDrvData[InterfaceId].pDrvData );
-            break;
-#endif
-
-
-        default:
-            break;
-        }
+        Serial_RxReadNotify(InterfaceId);
 
         if( bytesRead )
         {
@@ -913,6 +933,79 @@ serialStatus_t Serial_Read( uint8_t InterfaceId, uint8_t *pData, uint16_t dataSi
     return status;
 }
 
+/*! *********************************************************************************
+* \brief   Returns the received bytes which are stored contiguously in the Rx buffer,
+*          without removing them from the buffer
+*
+* \param[in] InterfaceId the interface number
+* \param[out] ppData pointer to the first byte in the Rx buffer
+* \param[out] pBytes the number of contiguous bytes starting with *ppData
+*
+* \return The status of the operation
+*
+* \remarks The bytes remain valid until released with Serial_RxConsume(). When the
+*          received data wraps around the end of the Rx buffer, the rest of the data
+*          is returned by the next call.
+*
+********************************************************************************** */
+serialStatus_t Serial_RxPeek( uint8_t InterfaceId, uint8_t **ppData, uint16_t *pBytes )
+{
+    serialStatus_t status = gSerial_Success_c;
+#if (gSerialManagerMaxInterfaces_c)
+#if gSerialMgr_ParamValidation_d
+    if ( (InterfaceId >= gSerialManagerMaxInterfaces_c) || (NULL == ppData) || (NULL == pBytes) )
+    {
+        status = gSerial_InvalidParameter_c;
+    }
+    else
+#endif
+    {
+        *pBytes = Serial_RxContiguousCount(&mSerials[InterfaceId]);
+        *ppData = &mSerials[InterfaceId].rxBuffer[mSerials[InterfaceId].rxOut];
+    }
+#else
+    (void)InterfaceId;
+    (void)ppData;
+    (void)pBytes;
+#endif
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief   Removes bytes returned by Serial_RxPeek() from the Rx buffer
+*
+* \param[in] InterfaceId the interface number
+* \param[in] bytes the number of bytes to be removed
+*
+* \return The status of the operation
+*
+********************************************************************************** */
+serialStatus_t Serial_RxConsume( uint8_t InterfaceId, uint16_t bytes )
+{
+    serialStatus_t status = gSerial_Success_c;
+#if (gSerialManagerMaxInterfaces_c)
+#if gSerialMgr_ParamValidation_d
+    uint16_t count;
+
+    if ( (InterfaceId >= gSerialManagerMaxInterfaces_c) ||
+         (gSerial_Success_c != Serial_RxBufferByteCount(InterfaceId, &count)) ||
+         (bytes > count) )
+    {
+        status = gSerial_InvalidParameter_c;
+    }
+    else
+#endif
+    {
+        Serial_RxAdvance(&mSerials[InterfaceId], bytes);
+        Serial_RxReadNotify(InterfaceId);
+    }
+#else
+    (void)InterfaceId;
+    (void)bytes;
+#endif
+    return status;
+}
+
 /*! *********************************************************************************
 * \brief   Returns a the number of bytes available in the RX buffer
 *
@@ -926,6 +1019,8 @@ serialStatus_t Serial_RxBufferByteCount( uint8_t InterfaceId, uint16_t *bytesCou
 {
     serialStatus_t status = gSerial_Success_c;
 #if (gSerialManagerMaxInterfaces_c)
+    bufIndex_t rxIn, rxOut;
+
 #if gSerialMgr_ParamValidation_d
     if ( (InterfaceId >= gSerialManagerMaxInterfaces_c) || (NULL == bytesCount) )
     {
@@ -934,18 +1029,21 @@ serialStatus_t Serial_RxBufferByteCount( uint8_t InterfaceId, uint16_t *bytesCou
     else
 #endif
     {
-        OSA_InterruptDisable();
+#if gSerialMgrUseUart_c && gUartRxDma_d
+        Serial_RxDmaResync(&mSerials[InterfaceId]);
+#endif
+        /* Each index is written by a single context, no lock is needed to read them */
+        rxIn = mSerials[InterfaceId].rxIn;
+        rxOut = mSerials[InterfaceId].rxOut;
 
-        if( mSerials[InterfaceId].rxIn >= mSerials[InterfaceId].rxOut )
+        if( rxIn >= rxOut )
         {
-            *bytesCount = mSerials[InterfaceId].rxIn - mSerials[InterfaceId].rxOut;
+            *bytesCount = rxIn - rxOut;
         }
         else
         {
-            *bytesCount = gSMRxBufSize_c - mSerials[InterfaceId].rxOut + mSerials[InterfaceId].rxIn;
+            *bytesCount = gSMRxBufSize_c - rxOut + rxIn;
         }
-
-        OSA_InterruptEnable();
     }
 #else
     (void)bytesCount;
@@ -954,6 +1052,39 @@ serialStatus_t Serial_RxBufferByteCount( uint8_t InterfaceId, uint16_t *bytesCou
     return status;
 }
 
+/*! *********************************************************************************
+* \brief   Returns the number of received bytes dropped because the Rx buffer was full
+*
+* \param[in] InterfaceId the interface number
+* \param[out] pCount the number of bytes dropped since the interface was initialized
+*
+* \return The status of the operation
+*
+* \remarks The bytes overwritten by the UART eDMA are counted when the interface is
+*          read next.
+*
+********************************************************************************** */
+serialStatus_t Serial_RxDroppedCount( uint8_t InterfaceId, uint32_t *pCount )
+{
+    serialStatus_t status = gSerial_Success_c;
+#if (gSerialManagerMaxInterfaces_c)
+#if gSerialMgr_ParamValidation_d
+    if ( (InterfaceId >= gSerialManagerMaxInterfaces_c) || (NULL == pCount) )
+    {
+        status = gSerial_InvalidParameter_c;
+    }
+    else
+#endif
+    {
+        *pCount = mSerials[InterfaceId].rxDropped;
+    }
+#else
+    (void)InterfaceId;
+    (void)pCount;
+#endif
+    return status;
+}
+
 /*! *********************************************************************************
 * \brief   Sets a pointer to a function that will be called when data is received
 *
@@ -1382,6 +1513,187 @@ bool_t Serial_IsWakeUpSource( serialInterfaceType_t interfaceType)
 *************************************************************************************
 ********************************************************************************* */
 #if (gSerialManagerMaxInterfaces_c)
+/*! *********************************************************************************
+* \brief Add a message to the Tx queue of an interface and start the transmission.
+*        If the queue is full, the caller is blocked or an error is returned,
+*        depending on gSerialMgr_BlockSenderOnQueueFull_c.
+*
+* \param[in] InterfaceId the interface number
+* \param[in] pBuf pointer to the first segment
+* \param[in] bufLen the size of the first segment
+* \param[in] pSegments pointer to the segments following the first one
+* \param[in] segmentsLeft the number of segments following the first one
+* \param[in] cb pointer to a function that will be called when the Tx is done
+* \param[in] pTxParam the parameter of the callback
+*
+* \return The status of the operation
+*
+********************************************************************************** */
+static serialStatus_t Serial_TxEnqueue( uint8_t InterfaceId,
+                                        uint8_t *pBuf,
+                                        uint16_t bufLen,
+                                        const serialSegment_t *pSegments,
+                                        uint8_t segmentsLeft,
+                                        pSerialCallBack_t cb,
+                                        void *pTxParam )
+{
+    serialStatus_t status = gSerial_Success_c;
+    SerialMsg_t *pMsg = NULL;
+    serial_t *pSer = &mSerials[InterfaceId];
+
+#if (gSerialMgr_BlockSenderOnQueueFull_c == 0) || ((gSerialMgr_BlockSenderOnQueueFull_c) && (gSMGR_UseOsSemForSynchronization_c))
+    osaTaskId_t taskHandler = OSA_TaskGetId();
+#endif
+
+#if (gSerialMgr_BlockSenderOnQueueFull_c == 0)
+    if( taskHandler == gSerialManagerTaskId )
+    {
+        Serial_TxQueueMaintenance(pSer);
+    }
+#endif
+
+    /* Check if slot is free */
+    do {
+        OSA_InterruptDisable();
+
+        if( (0 == pSer->txQueue[pSer->txIn].dataSize) && (NULL == pSer->txQueue[pSer->txIn].txCallback) && (pSer->txNo < gSerialMgrTxQueueSize_c) )
+        {
+            pMsg = &pSer->txQueue[pSer->txIn];
+            pMsg->pSegments    = pSegments;
+            pMsg->segmentsLeft = segmentsLeft;
+            pMsg->dataSize     = bufLen;
+            pMsg->pData        = (void*)pBuf;
+            pMsg->txCallback   = cb;
+            pMsg->pTxParam     = pTxParam;
+            mSerial_IncIdx_d(pSer->txIn, gSerialMgrTxQueueSize_c)
+            pSer->txNo++;
+        }
+#if (gSerialMgr_BlockSenderOnQueueFull_c) && (gSMGR_UseOsSemForSynchronization_c)
+        else
+        {
+            if(taskHandler != gSerialManagerTaskId)
+            {
+                pSer->txBlockedTasks++;
+            }
+        }
+#endif
+        OSA_InterruptEnable();
+
+        if( pMsg )
+        {
+            status = Serial_WriteInternal( InterfaceId );
+            break;
+        }
+        else
+        {
+            status = gSerial_OutOfMemory_c;
+#if gSerialMgr_BlockSenderOnQueueFull_c
+#if gSMGR_UseOsSemForSynchronization_c
+            if(taskHandler != gSerialManagerTaskId)
+            {
+                (void)OSA_SemaphoreWait(pSer->txQueueSemId, osaWaitForever_c);
+            }
+            else
+#endif
+            {
+                Serial_TxQueueMaintenance(pSer);
+            }
+#else
+            break;
+#endif
+        }
+    } while( status != gSerial_Success_c );
+
+    return status;
+}
+
+/*! *********************************************************************************
+* \brief Wait until a message added by Serial_SyncWrite() or Serial_SyncWriteV()
+*        is transmitted.
+*
+* \param[in] InterfaceId the interface number
+* \param[in] cb the callback of the message: Serial_SyncTxCallback() or NULL,
+*            when called from the SMGR task
+*
+********************************************************************************** */
+static void Serial_SyncTxWait(uint8_t InterfaceId, pSerialCallBack_t cb)
+{
+    serial_t *pSer = &mSerials[InterfaceId];
+
+    /* Wait until Tx finishes. The sem will be released by the SMGR task */
+#if gSMGR_UseOsSemForSynchronization_c
+    if( cb )
+    {
+        (void)OSA_SemaphoreWait(pSer->txSyncSemId, osaWaitForever_c);
+    }
+    else
+#else
+    (void)cb;
+#endif
+    {
+        /* The SMGR task is blocked here: start the next segments of the
+           interfaces which are not restarted from the Tx ISR (I2C) */
+        while( pSer->state || pSer->txQueue[pSer->txCurrent].dataSize )
+        {
+            if( (0 == pSer->state) && (gSerial_Success_c != Serial_WriteInternal(InterfaceId)) )
+            {
+                break;
+            }
+        }
+    }
+#if (gSerialMgrUseUart_c)
+    switch (pSer->serialType)
+    {
+#if FSL_FEATURE_SOC_UART_COUNT
+    case gSerialMgrUart_c:
+        while(UART_IsTxActive(pSer->serialChannel)) {}
+        break;
+#endif
+#if FSL_FEATURE_SOC_LPUART_COUNT
+    case gSerialMgrLpuart_c:
+        while(LPUART_IsTxActive(pSer->serialChannel)) {}
+        break;
+#endif
+#if FSL_FEATURE_SOC_LPSCI_COUNT
+    case gSerialMgrLpsci_c:
+        while(LPSCI_IsTxActive(pSer->serialChannel)) {}
+        break;
+#endif
+    default:
+        break;
+    }
+#endif
+}
+
+/*! *********************************************************************************
+* \brief Move a scatter-gather message to its next non empty segment.
+*
+* \param[in] pMsg pointer to the message
+*
+* \return TRUE if a segment is left to be transmitted, FALSE otherwise
+*
+* \remarks Called from ISR, with interrupts disabled
+*
+********************************************************************************** */
+static bool_t Serial_TxNextSegment(SerialMsg_t *pMsg)
+{
+    bool_t segmentLeft = FALSE;
+
+    while( pMsg->segmentsLeft && !segmentLeft )
+    {
+        pMsg->segmentsLeft--;
+        if( pMsg->pSegments->dataSize )
+        {
+            pMsg->pData    = pMsg->pSegments->pData;
+            pMsg->dataSize = pMsg->pSegments->dataSize;
+            segmentLeft    = TRUE;
+        }
+        pMsg->pSegments++;
+    }
+
+    return segmentLeft;
+}
+
 /*! *********************************************************************************
 * \brief Transmit a data buffer to the specified interface.
 *
@@ -1581,19 +1893,8 @@ static serialStatus_t Serial_WriteInternal( uint8_t InterfaceId )
 #if gSerialMgrUseUSB_c
 void SerialManager_VirtualComRxNotify(uint8_t* pData, uint16_t dataSize, uint8_t interface)
 {
-
-  while(dataSize)
-  {
-    OSA_InterruptDisable();
-    mSerials[interface].rxBuffer[mSerials[interface].rxIn] = *pData++;
-    mSerial_IncIdx_d(mSerials[interface].rxIn, gSMRxBufSize_c);
-    if(mSerials[interface].rxIn == mSerials[interface].rxOut)
-    {
-      mSerial_IncIdx_d(mSerials[interface].rxOut, gSMRxBufSize_c);
-    }
-    OSA_InterruptEnable();
-    dataSize--;
-  }
+   /* The bytes which do not fit in the Rx buffer are dropped */
+   mSerials[interface].rxDropped += dataSize - Serial_RxWrite(&mSerials[interface], pData, dataSize);
 
    mSerials[interface].events |= gSMGR_Rx_c;
    (void)OSA_EventSet(mSMTaskEventId, gSMGR_Rx_c);
@@ -1614,20 +1915,8 @@ void SerialManager_VirtualComRxNotify(uint8_t* pData, uint16_t dataSize, uint8_t
 #if gSerialMgrUseUSB_VNIC_c
 uint16_t SerialManager_VirtualNicRxNotify(uint8_t* pData, uint16_t dataSize, uint8_t interface)
 {
-  bufIndex_t inIndex;
-  uint16_t charReceived = 0;
-  inIndex = mSerials[interface].rxIn;
-  mSerial_IncIdx_d(inIndex, gSMRxBufSize_c);
-  while(dataSize && (inIndex != mSerials[interface].rxOut))
-  {
-    //OSA_InterruptDisable();
-    mSerials[interface].rxBuffer[mSerials[interface].rxIn] = *pData++;
-    mSerials[interface].rxIn = inIndex;
-    charReceived++;
-    mSerial_IncIdx_d(inIndex, gSMRxBufSize_c);
-    //OSA_InterruptEnable();
-    dataSize--;
-  }
+  uint16_t charReceived = Serial_RxWrite(&mSerials[interface], pData, dataSize);
+
   if(charReceived)
   {
     mSerials[interface].events |= gSMGR_Rx_c;
@@ -1650,15 +1939,23 @@ uint16_t SerialManager_VirtualNicRxNotify(uint8_t* pData, uint16_t dataSize, uin
 void SerialManager_RxNotify( uint32_t i )
 {
     serial_t *pSer = &mSerials[i];
+    bufIndex_t rxIn = pSer->rxIn;
 #if gSerialMgrUseFSCIHdr_c
     uint8_t rxByte = pSer->rxBuffer[pSer->rxIn];
     uint8_t slaveDapRxEnd = 0;
 #endif
 
-    mSerial_IncIdx_d(pSer->rxIn, gSMRxBufSize_c)
-    if(pSer->rxIn == pSer->rxOut)
+    mSerial_IncIdx_d(rxIn, gSMRxBufSize_c)
+    /* If the Rx buffer is full the byte is dropped: rxOut belongs to the consumer,
+       and the driver receives the next byte in the same location */
+    if( rxIn != pSer->rxOut )
     {
-        mSerial_IncIdx_d(pSer->rxOut, gSMRxBufSize_c)
+        mSerial_RxBarrier_d();
+        pSer->rxIn = rxIn;
+    }
+    else
+    {
+        pSer->rxDropped++;
     }
 
     switch( pSer->serialType )
@@ -1768,6 +2065,174 @@ void SerialManager_RxNotify( uint32_t i )
     }
 }
 
+/*! *********************************************************************************
+* \brief Returns the number of bytes which can be read contiguously from rxOut
+*
+* \param[in] pSer pointer to the serial interface
+*
+* \return the number of bytes
+*
+* \remarks Called by the Rx buffer consumer
+*
+********************************************************************************** */
+static uint16_t Serial_RxContiguousCount(serial_t *pSer)
+{
+    bufIndex_t rxIn, rxOut;
+
+#if gSerialMgrUseUart_c && gUartRxDma_d
+    Serial_RxDmaResync(pSer);
+#endif
+    rxIn = pSer->rxIn;
+    rxOut = pSer->rxOut;
+
+    /* The bytes published by the producer are read after rxIn */
+    mSerial_RxBarrier_d();
+
+    return (rxIn >= rxOut) ? (rxIn - rxOut) : (gSMRxBufSize_c - rxOut);
+}
+
+/*! *********************************************************************************
+* \brief Releases bytes of the Rx buffer to the producer
+*
+* \param[in] pSer pointer to the serial interface
+* \param[in] bytes the number of bytes read
+*
+* \remarks Called by the Rx buffer consumer
+*
+********************************************************************************** */
+static void Serial_RxAdvance(serial_t *pSer, uint16_t bytes)
+{
+    uint32_t rxOut = pSer->rxOut + bytes;
+
+    if( rxOut >= gSMRxBufSize_c )
+    {
+        rxOut -= gSMRxBufSize_c;
+    }
+
+    /* The bytes are read before their locations are released */
+    mSerial_RxBarrier_d();
+    pSer->rxOut = (bufIndex_t)rxOut;
+#if gSerialMgrUseUart_c && gUartRxDma_d
+    pSer->rxReadCount += bytes;
+#endif
+}
+
+#if gSerialMgrUseUart_c && gUartRxDma_d
+/*! *********************************************************************************
+* \brief Drops the oldest unread bytes once the eDMA has written more bytes than the
+*        Rx buffer holds. The newest gSMRxBufSize_c - 1 bytes, which start after rxIn,
+*        are kept.
+*
+* \param[in] pSer pointer to the serial interface
+*
+* \remarks Called by the Rx buffer consumer
+*
+********************************************************************************** */
+static void Serial_RxDmaResync(serial_t *pSer)
+{
+    uint32_t dropped;
+    bufIndex_t rxOut;
+
+    if( (gSerialMgrUart_c != pSer->serialType) ||
+        (pSer->rxDmaCount - pSer->rxReadCount <= gSMRxBufSize_c - 1) )
+    {
+        return;
+    }
+
+    /* rxIn and rxDmaCount are updated together by the ISR */
+    OSA_InterruptDisable();
+    dropped = pSer->rxDmaCount - pSer->rxReadCount - (gSMRxBufSize_c - 1);
+    rxOut = pSer->rxIn;
+    mSerial_IncIdx_d(rxOut, gSMRxBufSize_c)
+    pSer->rxOut = rxOut;
+    pSer->rxReadCount += dropped;
+    pSer->rxDropped += dropped;
+    OSA_InterruptEnable();
+}
+#endif
+
+/*! *********************************************************************************
+* \brief Informs the interface driver that bytes were read from the Rx buffer
+*
+* \param[in] InterfaceId the interface number
+*
+********************************************************************************** */
+static void Serial_RxReadNotify(uint8_t InterfaceId)
+{
+    switch ( mSerials[InterfaceId].serialType )
+    {
+#if gSerialMgrUseUSB_c
+    case gSerialMgrUSB_c:
+        VirtualCom_SMReadNotify( mDrvData[InterfaceId].pDrvData );
+        break;
+#endif
+
+#if gSerialMgrUseUSB_VNIC_c
+    case gSerialMgrUSB_VNIC_c:
+        VirtualNic_SMReadNotify( mDrvData[InterfaceId].pDrvData );
+        break;
+#endif
+
+    default:
+        break;
+    }
+}
+
+#if (gSerialMgrUseUSB_c) || (gSerialMgrUseUSB_VNIC_c) || (gSerialMgrUseCustomInterface_c)
+/*! *********************************************************************************
+* \brief Stores a block of received bytes in the Rx buffer
+*
+* \param[in] pSer pointer to the serial interface
+* \param[in] pData pointer to the received bytes
+* \param[in] size the number of received bytes
+*
+* \return the number of bytes stored. The bytes which do not fit are not stored.
+*
+* \remarks Called by the Rx buffer producer
+*
+********************************************************************************** */
+static uint16_t Serial_RxWrite(serial_t *pSer, const uint8_t *pData, uint32_t size)
+{
+    uint32_t rxIn = pSer->rxIn;
+    bufIndex_t rxOut = pSer->rxOut;
+    uint32_t space, span;
+    uint16_t written = 0;
+
+    /* One location is kept free to tell a full buffer from an empty one */
+    space = (rxOut > rxIn) ? (rxOut - rxIn - 1) : (gSMRxBufSize_c - rxIn + rxOut - 1);
+
+    if( size > space )
+    {
+        size = space;
+    }
+
+    while( written < size )
+    {
+        span = gSMRxBufSize_c - rxIn;
+
+        if( span > size - written )
+        {
+            span = size - written;
+        }
+
+        FLib_MemCpy(&pSer->rxBuffer[rxIn], (void*)&pData[written], span);
+        written += span;
+        rxIn += span;
+
+        if( rxIn >= gSMRxBufSize_c )
+        {
+            rxIn = 0;
+        }
+    }
+
+    /* Publish all the bytes at once */
+    mSerial_RxBarrier_d();
+    pSer->rxIn = (bufIndex_t)rxIn;
+
+    return written;
+}
+#endif
+
 /*! *********************************************************************************
 * \brief Inform the Serial Manager task that a transmission has finished
 *
@@ -1787,8 +2252,12 @@ void SerialManager_TxNotify( uint32_t i )
     if( 2 != pSer->state )
 #endif
     {
-    pSer->txQueue[pSer->txCurrent].dataSize = 0; /* Mark as transmitted */
-    mSerial_IncIdx_d(pSer->txCurrent, gSerialMgrTxQueueSize_c)
+        /* Continue with the next segment of the message, if any */
+        if( !Serial_TxNextSegment(&pSer->txQueue[pSer->txCurrent]) )
+        {
+            pSer->txQueue[pSer->txCurrent].dataSize = 0; /* Mark as transmitted */
+            mSerial_IncIdx_d(pSer->txCurrent, gSerialMgrTxQueueSize_c)
+        }
     }
 #if gSerialMgr_DisallowMcuSleep_d
     PWR_AllowDeviceToSleep();
@@ -1796,6 +2265,15 @@ void SerialManager_TxNotify( uint32_t i )
     pSer->state = 0;
     OSA_InterruptEnable();
 
+#if (gSerialMgrUseSPI_c) && gNvStorageIncluded_d
+    /* Each SPI Slave transfer enters the NVM critical section, the next block
+       or segment enters it again */
+    if( pSer->serialType == gSerialMgrSPISlave_c )
+    {
+        NvClearCriticalSection();
+    }
+#endif
+
     /* Transmit next block if available */
       if( pSer->txQueue[pSer->txCurrent].dataSize)
     {
@@ -1836,10 +2314,6 @@ void SerialManager_TxNotify( uint32_t i )
 #else
             GpioSetPinOutput(&mSpiSlaveDapCfg);
 #endif
-
-#if gNvStorageIncluded_d
-            NvClearCriticalSection();
-#endif
             break;
 #endif
         default:
@@ -2154,9 +2628,18 @@ static void Serial_UartRxCb(uartState_t* state)
 {
     uint32_t i = state->rxCbParam;
 
-    SerialManager_RxNotify(i);
-    /* Update rxBuff because rxIn was incremented by the RxNotify function */
-    state->pRxData = &mSerials[i].rxBuffer[mSerials[i].rxIn];
+#if gUartRxDma_d
+    if( gSerialMgrUart_c == mSerials[i].serialType )
+    {
+        Serial_UartDmaRxNotify(i, state->pRxData, state->rxSize);
+    }
+    else
+#endif
+    {
+        SerialManager_RxNotify(i);
+        /* Update rxBuff because rxIn was incremented by the RxNotify function */
+        state->pRxData = &mSerials[i].rxBuffer[mSerials[i].rxIn];
+    }
 }
 
 /*! *********************************************************************************
@@ -2169,6 +2652,40 @@ static void Serial_UartTxCb(uartState_t* state)
 {
     SerialManager_TxNotify(state->txCbParam);
 }
+
+#if gUartRxDma_d
+/*! *********************************************************************************
+* \brief   Publishes the bytes written by the eDMA in the Rx buffer all at once.
+*
+* \param[in] i       the interface number
+* \param[in] pRxEnd  pointer to the next location to be written by the eDMA
+* \param[in] count   the number of bytes written since the previous call
+*
+* \remarks Called from ISR. When more bytes than the free space were written, the
+*          eDMA has overwritten unread bytes, and rxIn may even equal rxOut on a full
+*          buffer. The consumer sees it from rxDmaCount, see Serial_RxDmaResync().
+*
+********************************************************************************** */
+static void Serial_UartDmaRxNotify(uint32_t i, uint8_t *pRxEnd, uint32_t count)
+{
+    serial_t *pSer = &mSerials[i];
+    uint32_t rxIn = pRxEnd - pSer->rxBuffer;
+
+    if( rxIn >= gSMRxBufSize_c )
+    {
+        rxIn = 0;
+    }
+
+    if( count )
+    {
+        mSerial_RxBarrier_d();
+        pSer->rxDmaCount += count;
+        pSer->rxIn = (bufIndex_t)rxIn;
+        pSer->events |= gSMGR_Rx_c;
+        (void)OSA_EventSet(mSMTaskEventId, gSMGR_Rx_c);
+    }
+}
+#endif
 #endif /* #if (gSerialMgrUseUart_c) */
 
 #if gSerialMgrUseCustomInterface_c
@@ -2199,21 +2716,7 @@ uint32_t Serial_CustomReceiveData(uint8_t InterfaceId, uint8_t *pRxData, uint32_
 {
     serial_t *pSer = &mSerials[InterfaceId];
 
-    while(size--)
-    {
-        OSA_InterruptDisable();
-        pSer->rxBuffer[pSer->rxIn] = *pRxData++;
-        mSerial_IncIdx_d(pSer->rxIn, gSMRxBufSize_c);
-        /* Check for overflow */
-        if(pSer->rxIn == pSer->rxOut)
-        {
-            mSerial_DecIdx_d(pSer->rxIn, gSMRxBufSize_c);
-            OSA_InterruptEnable();
-            size++;
-            break;
-        }
-        OSA_InterruptEnable();
-    }
+    size -= Serial_RxWrite(pSer, pRxData, size);
 
     /* Signal SMGR task if not allready done */
     pSer->events |= gSMGR_Rx_c;
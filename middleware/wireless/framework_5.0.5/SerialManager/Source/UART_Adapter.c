@@ -41,6 +41,10 @@
 
 #if FSL_FEATURE_SOC_UART_COUNT
 #include "fsl_uart.h"
+#if gUartRxDma_d
+#include "fsl_edma.h"
+#include "fsl_dmamux.h"
+#endif
 #endif
 
 #if FSL_FEATURE_SOC_LPUART_COUNT
@@ -69,6 +73,21 @@ static UART_Type * mUartBase[] = UART_BASE_PTRS;
 static IRQn_Type mUartIrqs[] = UART_RX_TX_IRQS;
 static uartState_t * pUartStates[FSL_FEATURE_SOC_UART_COUNT];
 static void UART_ISR(void);
+#if gUartRxDma_d
+static const dma_request_source_t mUartRxDmaRequests[] = {
+    kDmaRequestMux0UART0Rx,
+#if FSL_FEATURE_SOC_UART_COUNT > 1
+    kDmaRequestMux0UART1Rx,
+#endif
+#if FSL_FEATURE_SOC_UART_COUNT > 2
+    kDmaRequestMux0UART2Rx,
+#endif
+};
+static IRQn_Type mDmaIrqs[] = DMA_CHN_IRQS;
+static uint32_t mUartRxDmaSize[FSL_FEATURE_SOC_UART_COUNT];
+static void UART_RxDmaUpdate(uint32_t instance, bool_t dmaIrq);
+static void UART_RxDmaISR(void);
+#endif
 #endif
 
 #if FSL_FEATURE_SOC_LPSCI_COUNT
@@ -431,6 +450,70 @@ uint32_t UART_ReceiveData(uint32_t instance, uint8_t* pData, uint32_t size)
     return status;
 }
 
+/************************************************************************************/
+/* The eDMA copies the received bytes in pBuffer and wraps around at its end without */
+/* being restarted. On half buffer, buffer end and idle line, pRxData is set to the  */
+/* next byte to be written by the eDMA, rxSize to the number of bytes written since  */
+/* the previous callback, and the Rx callback is called. The eDMA does not know the  */
+/* read position: the callback must compare rxSize with the free space of pBuffer to */
+/* detect the unread bytes that were overwritten.                                    */
+/************************************************************************************/
+uint32_t UART_ReceiveDataCircular(uint32_t instance, uint8_t* pBuffer, uint32_t size)
+{
+    uint32_t status = gUartSuccess_c;
+#if FSL_FEATURE_SOC_UART_COUNT && gUartRxDma_d
+    UART_Type * base;
+    uint32_t channel;
+    edma_config_t dmaConfig;
+    edma_transfer_config_t transferConfig;
+
+    if( (instance >= FSL_FEATURE_SOC_UART_COUNT) || !size || !pBuffer ||
+        (size > DMA_CITER_ELINKNO_CITER_MASK) )
+    {
+        status = gUartInvalidParameter_c;
+    }
+    else
+    {
+        base = mUartBase[instance];
+        channel = gUartRxDmaFirstChannel_c + instance;
+
+        OSA_InterruptDisable();
+        pUartStates[instance]->pRxData = pBuffer;
+        pUartStates[instance]->rxSize = 0;
+        mUartRxDmaSize[instance] = size;
+        OSA_InterruptEnable();
+
+        EDMA_GetDefaultConfig(&dmaConfig);
+        EDMA_Init(DMA0, &dmaConfig);
+        EDMA_ResetChannel(DMA0, channel);
+        DMAMUX_Init(DMAMUX0);
+        DMAMUX_SetSource(DMAMUX0, channel, mUartRxDmaRequests[instance]);
+        DMAMUX_EnableChannel(DMAMUX0, channel);
+
+        EDMA_PrepareTransfer(&transferConfig, (void*)UART_GetDataRegisterAddress(base), sizeof(uint8_t),
+                             pBuffer, sizeof(uint8_t), sizeof(uint8_t), size, kEDMA_PeripheralToMemory);
+        EDMA_SetTransferConfig(DMA0, channel, &transferConfig, NULL);
+        /* Rewind the destination at the end of the major loop and keep the requests enabled */
+        DMA0->TCD[channel].DLAST_SGA = (uint32_t)(-(int32_t)size);
+        EDMA_EnableAutoStopRequest(DMA0, channel, false);
+        EDMA_EnableChannelInterrupts(DMA0, channel, kEDMA_HalfInterruptEnable | kEDMA_MajorInterruptEnable);
+        OSA_InstallIntHandler(mDmaIrqs[channel], UART_RxDmaISR);
+        NVIC_SetPriority(mDmaIrqs[channel], gUartIsrPrio_c >> (8 - __NVIC_PRIO_BITS));
+        NVIC_EnableIRQ(mDmaIrqs[channel]);
+        EDMA_EnableChannelRequest(DMA0, channel);
+
+        /* The Rx data register full flag triggers the eDMA instead of the UART interrupt */
+        UART_EnableRxDMA(base, true);
+        UART_EnableInterrupts(base, kUART_IdleLineInterruptEnable);
+    }
+#else
+    (void)instance;
+    (void)pBuffer;
+    (void)size;
+#endif
+    return status;
+}
+
 /************************************************************************************/
 uint32_t UART_InstallRxCalback(uint32_t instance, uartCallback_t cb, uint32_t cbParam)
 {
@@ -854,6 +937,19 @@ static void UART_ISR(void)
         {
             base = mUartBase[instance];
             pState = pUartStates[instance];
+#if gUartRxDma_d
+            if( mUartRxDmaSize[instance] )
+            {
+                /* Flush the bytes of a partial burst once the Rx line goes idle */
+                if( (kUART_IdleLineFlag & UART_GetStatusFlags(base)) &&
+                    !(kUART_RxDataRegFullFlag & UART_GetStatusFlags(base)) )
+                {
+                    UART_ClearStatusFlags(base, kUART_IdleLineFlag);
+                    UART_RxDmaUpdate(instance, FALSE);
+                }
+            }
+            else
+#endif
             /* Check if data was received */
             if( (kUART_RxDataRegFullFlag) & UART_GetStatusFlags(base) )
             {
@@ -905,6 +1001,70 @@ static void UART_ISR(void)
         }
     } /* for(...) */
 }
+
+#if gUartRxDma_d
+/************************************************************************************/
+/* Reports the bytes written by the eDMA since the previous report. A half buffer or */
+/* buffer end interrupt that finds the eDMA where it was reported last means that a  */
+/* whole buffer was written. More than one buffer between two reports is not seen:   */
+/* the half buffer interrupts must not be delayed by half a buffer.                  */
+/************************************************************************************/
+static void UART_RxDmaUpdate(uint32_t instance, bool_t dmaIrq)
+{
+    uartState_t * pState = pUartStates[instance];
+    uint32_t channel = gUartRxDmaFirstChannel_c + instance;
+    uint8_t *pRxEnd = (uint8_t*)DMA0->TCD[channel].DADDR;
+
+    /* The position was read before a half buffer or buffer end interrupt was raised:
+       it is reported by the eDMA ISR, which could not tell a whole buffer otherwise */
+    if( !dmaIrq && (kEDMA_InterruptFlag & EDMA_GetChannelStatusFlags(DMA0, channel)) )
+    {
+        return;
+    }
+
+    if( pRxEnd >= pState->pRxData )
+    {
+        pState->rxSize = pRxEnd - pState->pRxData;
+    }
+    else
+    {
+        pState->rxSize = mUartRxDmaSize[instance] - (pState->pRxData - pRxEnd);
+    }
+
+    if( dmaIrq && (0 == pState->rxSize) )
+    {
+        pState->rxSize = mUartRxDmaSize[instance];
+    }
+
+    pState->pRxData = pRxEnd;
+
+    if( NULL != pState->rxCb )
+    {
+        pState->rxCb(pState);
+    }
+}
+
+/************************************************************************************/
+static void UART_RxDmaISR(void)
+{
+    uint32_t irq = __get_IPSR() - 16;
+    uint32_t instance;
+    uint32_t channel;
+
+    for( instance=0; instance<FSL_FEATURE_SOC_UART_COUNT; instance++ )
+    {
+        channel = gUartRxDmaFirstChannel_c + instance;
+
+        if( irq == mDmaIrqs[channel] )
+        {
+            UART_RxDmaUpdate(instance, TRUE);
+            /* A later interrupt finds the eDMA past the position just reported */
+            EDMA_ClearChannelStatusFlags(DMA0, channel, kEDMA_InterruptFlag);
+            break;
+        }
+    }
+}
+#endif /* gUartRxDma_d */
 #endif
 
 /************************************************************************************/
@@ -42,6 +42,16 @@
 #define gUartIsrPrio_c (0x40)
 #endif
 
+/* Enables the UART circular Rx using the eDMA (see UART_ReceiveDataCircular) */
+#ifndef gUartRxDma_d
+#define gUartRxDma_d (0)
+#endif
+
+/* The eDMA channel used by UART instance 0. Instance n uses channel gUartRxDmaFirstChannel_c + n */
+#ifndef gUartRxDmaFirstChannel_c
+#define gUartRxDmaFirstChannel_c (12)
+#endif
+
 
 /*! *********************************************************************************
 *************************************************************************************
@@ -78,6 +88,7 @@ uint32_t UART_Initialize(uint32_t instance, uartState_t *pState);
 uint32_t UART_SetBaudrate(uint32_t instance, uint32_t baudrate);
 uint32_t UART_SendData(uint32_t instance, uint8_t* pData, uint32_t size);
 uint32_t UART_ReceiveData(uint32_t instance, uint8_t* pData, uint32_t size);
+uint32_t UART_ReceiveDataCircular(uint32_t instance, uint8_t* pBuffer, uint32_t size);
 uint32_t UART_InstallRxCalback(uint32_t instance, uartCallback_t cb, uint32_t cbParam);
 uint32_t UART_InstallTxCalback(uint32_t instance, uartCallback_t cb, uint32_t cbParam);
 uint32_t UART_IsTxActive(uint32_t instance);
@@ -0,0 +1,963 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file SerialRingBench.c
+* Host stress test and benchmark of the Serial Manager Rx buffer.
+*
+* SerialManager.c is built for one interface, with the UART eDMA Rx and the custom
+* interface enabled and the drivers stubbed. A producer thread plays the driver
+* ISR and a consumer thread plays the task reading the interface. The "interrupt
+* disabled" state is a lock: the ISR cannot run while a critical section is held,
+* and OSA_InterruptDisable() taken by the consumer are counted.
+*
+* Producers:
+*   byte ISR   - the UART Rx ISR: one byte written at rxIn, SerialManager_RxNotify()
+*   burst      - Serial_CustomReceiveData() with 1 to 64 bytes
+*   eDMA       - bytes written circularly in the Rx buffer, Serial_UartRxCb() called
+*                with the eDMA position on random burst ends (half buffer, buffer
+*                end and idle line interrupts)
+* Consumers:
+*   read       - Serial_Read() of 1 to 64 bytes
+*   peek       - Serial_RxPeek() and Serial_RxConsume() of 1 to 64 bytes
+*   5.0.5 read - the 5.0.5 Serial_Read(): the byte count and every byte copied
+*                in a critical section
+* The consumer cost alone is then measured without a producer, reading a full Rx
+* buffer.
+*
+* lossless: the producer waits for room in the Rx buffer, the consumer must read
+*   the byte stream unchanged.
+* overflow: the producer does not wait and the consumer is slowed down. The bytes
+*   dropped by the byte ISR on a full Rx buffer are recorded by the producer and the
+*   consumer must read the stream without them. The eDMA overwrites unread bytes,
+*   the ones being read included: only the bytes read and the bytes reported by
+*   Serial_RxDroppedCount() must add up to the stream length.
+* eDMA overrun: single threaded, the eDMA overwrites the unread bytes, the reserved
+*   free location and whole buffers; the Rx buffer must hold the newest bytes and
+*   Serial_RxDroppedCount() must report the others.
+*
+* For every run the tool prints the throughput, the bytes read per consumer
+* critical section, the bytes handled per ISR, and the ISR delay (the time the
+* ISR waits for a critical section to end) and duration, maximum and mean. The
+* host scheduler may preempt the threads anywhere, the ISR included: the maximum
+* figures include these delays and only the figures of runs made on the same
+* host compare.
+*
+* Build (the device and board directories are only needed for the include paths,
+* the tool defines the include guards of their headers):
+*   gcc -O2 -pthread -I../Interface -I../Source -I../../Common -I../../FunctionLib
+*       -I../../GPIO -I../../OSAbstraction/Interface -I../../MemManager/Interface
+*       -I../../Panic/Interface -I../../Messaging/Interface -I../../Lists
+*       -I../../TimersManager/Interface -I../../../../../devices/MKW24D5
+*       -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../boards/frdmkw24/wireless_examples/thread/end_device/freertos
+*       -o SerialRingBench SerialRingBench.c ../../FunctionLib/FunctionLib.c
+*   add -DgSerialMgrRxBufSize_c=<bytes> to change the Rx buffer size (128 bytes by
+*   default)
+* Usage: SerialRingBench [bytes per run [seed]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+
+#define gSerialManagerMaxInterfaces_c   1
+#define gSerialMgrUseUart_c             1
+#define gUartRxDma_d                    1
+#define gSerialMgrUseCustomInterface_c  1
+#ifndef gSerialMgrRxBufSize_c
+#define gSerialMgrRxBufSize_c           128
+#endif
+#define USE_RTOS                        0
+#define FSL_FEATURE_SOC_UART_COUNT      1
+#define FSL_FEATURE_SOC_LPUART_COUNT    0
+#define FSL_FEATURE_SOC_LPSCI_COUNT     0
+
+/* Skip the device and board headers */
+#define __FSL_DEVICE_REGISTERS_H__
+#define _FSL_COMMON_H_
+#define _PIN_MUX_H_
+#define __FSL_GPIO_PINS_H__
+#define __GPIO_IRQ_ADAPTER_H__
+
+#define __DMB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#include "../Source/SerialManager.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultBytes_c        (4 * 1024 * 1024)
+#define mBenchReadMax_c             (64)
+/* A burst must fit in the Rx buffer */
+#if gSerialMgrRxBufSize_c < 64
+#define mBenchBurstMax_c            (gSerialMgrRxBufSize_c)
+#else
+#define mBenchBurstMax_c            (64)
+#endif
+#define mBenchInterface_c           (0)
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef enum
+{
+    mBenchIsrByte_c,
+    mBenchIsrByteRef_c,
+    mBenchBurst_c,
+    mBenchDma_c
+} benchProducer_t;
+
+typedef enum
+{
+    mBenchRead_c,
+    mBenchPeek_c,
+    mBenchReadRef_c
+} benchConsumer_t;
+
+typedef struct benchRun_tag
+{
+    const char      *name;
+    benchProducer_t  producer;
+    benchConsumer_t  consumer;
+    bool_t           overflow;
+} benchRun_t;
+
+/* ISR timing, in ns */
+typedef struct benchIsrStats_tag
+{
+    uint64_t calls;
+    uint64_t delaySum;
+    uint64_t delayMax;
+    uint64_t timeSum;
+    uint64_t timeMax;
+} benchIsrStats_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static uint32_t mBytes = mBenchDefaultBytes_c;
+static uint32_t mSeed;
+static const benchRun_t *mRun;
+
+/* The interrupt mask: held by the critical sections and by the ISR */
+static volatile int mIrqLock;
+static __thread int mIrqDepth;
+static __thread uint64_t mCriticalSections;
+
+/* Producer state */
+static volatile uint8_t *mDropped;
+static volatile int mProducerDone;
+static benchIsrStats_t mIsrStats;
+static uint64_t mDroppedCount;
+static uartState_t mUartState;
+static uint32_t mDmaPos;
+
+/* Consumer state */
+static uint64_t mReceived;
+static uint64_t mConsumerCalls;
+static uint64_t mConsumerCriticalSections;
+static uint32_t mFailures;
+
+static const benchRun_t mRuns[] = {
+    {"5.0.5 read, byte ISR",    mBenchIsrByteRef_c, mBenchReadRef_c, FALSE},
+    {"read, byte ISR",          mBenchIsrByte_c,    mBenchRead_c,    FALSE},
+    {"peek, byte ISR",          mBenchIsrByte_c,    mBenchPeek_c,    FALSE},
+    {"read, burst",             mBenchBurst_c,      mBenchRead_c,    FALSE},
+    {"peek, eDMA",              mBenchDma_c,        mBenchPeek_c,    FALSE},
+    {"read, byte ISR overflow", mBenchIsrByte_c,    mBenchRead_c,    TRUE},
+    {"peek, byte ISR overflow", mBenchIsrByte_c,    mBenchPeek_c,    TRUE},
+    {"read, eDMA overflow",     mBenchDma_c,        mBenchRead_c,    TRUE},
+    {"peek, eDMA overflow",     mBenchDma_c,        mBenchPeek_c,    TRUE},
+};
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+const uint8_t gUseRtos_c = 0;
+
+void OSA_InterruptDisable(void)
+{
+    if( 0 == mIrqDepth++ )
+    {
+        while( __atomic_exchange_n(&mIrqLock, 1, __ATOMIC_ACQUIRE) )
+        {
+            sched_yield();
+        }
+        mCriticalSections++;
+    }
+}
+
+void OSA_InterruptEnable(void)
+{
+    if( 0 == --mIrqDepth )
+    {
+        __atomic_store_n(&mIrqLock, 0, __ATOMIC_RELEASE);
+    }
+}
+
+osaEventId_t OSA_EventCreate(bool_t autoClear)
+{
+    (void)autoClear;
+    return (osaEventId_t)1;
+}
+
+osaStatus_t OSA_EventSet(osaEventId_t eventId, osaEventFlags_t flagsToSet)
+{
+    (void)eventId;
+    (void)flagsToSet;
+    return osaStatus_Success;
+}
+
+osaStatus_t OSA_EventWait(osaEventId_t eventId, osaEventFlags_t flagsToWait, bool_t waitAll,
+                          uint32_t millisec, osaEventFlags_t *pSetFlags)
+{
+    (void)eventId; (void)flagsToWait; (void)waitAll; (void)millisec;
+    *pSetFlags = 0;
+    return osaStatus_Timeout;
+}
+
+osaTaskId_t OSA_TaskCreate(osaThreadDef_t *thread_def, osaTaskParam_t task_param)
+{
+    (void)thread_def; (void)task_param;
+    return NULL;
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    printf("panic %u at 0x%x\n", (unsigned)id, (unsigned)location);
+    (void)extra1; (void)extra2;
+    exit(1);
+}
+
+uint32_t Serial_CustomSendData(uint8_t *pData, uint32_t size) { (void)pData; (void)size; return 0; }
+
+uint32_t UART_Initialize(uint32_t instance, uartState_t *pState) { (void)instance; (void)pState; return 0; }
+uint32_t UART_SetBaudrate(uint32_t instance, uint32_t baudrate) { (void)instance; (void)baudrate; return 0; }
+uint32_t UART_SendData(uint32_t instance, uint8_t* pData, uint32_t size) { (void)instance; (void)pData; (void)size; return 0; }
+uint32_t UART_ReceiveDataCircular(uint32_t instance, uint8_t* pBuffer, uint32_t size) { (void)instance; (void)pBuffer; (void)size; return 0; }
+uint32_t UART_InstallRxCalback(uint32_t instance, uartCallback_t cb, uint32_t cbParam) { (void)instance; (void)cb; (void)cbParam; return 0; }
+uint32_t UART_InstallTxCalback(uint32_t instance, uartCallback_t cb, uint32_t cbParam) { (void)instance; (void)cb; (void)cbParam; return 0; }
+uint32_t UART_IsTxActive(uint32_t instance) { (void)instance; return 0; }
+uint32_t UART_EnableLowPowerWakeup(uint32_t instance) { (void)instance; return 0; }
+uint32_t UART_DisableLowPowerWakeup(uint32_t instance) { (void)instance; return 0; }
+uint32_t UART_IsWakeupSource(uint32_t instance) { (void)instance; return 0; }
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+
+/*! *********************************************************************************
+* \brief  Returns a pseudo random number (xorshift32) of the calling thread.
+********************************************************************************** */
+static __thread uint32_t mRandState = 1;
+static uint32_t BenchRand(void)
+{
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 17;
+    mRandState ^= mRandState << 5;
+    return mRandState;
+}
+
+/*! *********************************************************************************
+* \brief  Returns the byte of the stream at the given position.
+********************************************************************************** */
+static uint8_t BenchStreamByte(uint32_t pos)
+{
+    return (uint8_t)((pos * 131u) ^ (pos >> 7));
+}
+
+static uint64_t BenchClock(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#define BenchNow()      BenchClock(CLOCK_MONOTONIC)
+
+/*! *********************************************************************************
+* \brief  Returns the number of bytes in the Rx buffer, the eDMA bytes which are not
+*         published yet included.
+********************************************************************************** */
+static uint32_t BenchRxCount(void)
+{
+    serial_t *pSer = &mSerials[mBenchInterface_c];
+    uint32_t rxIn = (mBenchDma_c == mRun->producer) ? mDmaPos : pSer->rxIn;
+    uint32_t rxOut = pSer->rxOut;
+
+    return (rxIn >= rxOut) ? (rxIn - rxOut) : (gSMRxBufSize_c - rxOut + rxIn);
+}
+
+/*! *********************************************************************************
+* \brief  The 5.0.5 SerialManager_RxNotify(): a full Rx buffer drops its oldest byte.
+********************************************************************************** */
+static void BenchRefRxNotify(void)
+{
+    serial_t *pSer = &mSerials[mBenchInterface_c];
+
+    mSerial_IncIdx_d(pSer->rxIn, gSMRxBufSize_c)
+    if(pSer->rxIn == pSer->rxOut)
+    {
+        mSerial_IncIdx_d(pSer->rxOut, gSMRxBufSize_c)
+    }
+    pSer->events |= gSMGR_Rx_c;
+    (void)OSA_EventSet(mSMTaskEventId, gSMGR_Rx_c);
+}
+
+/*! *********************************************************************************
+* \brief  The 5.0.5 Serial_Read().
+********************************************************************************** */
+static uint16_t BenchRefRead(uint8_t *pData, uint16_t dataSize)
+{
+    serial_t *pSer = &mSerials[mBenchInterface_c];
+    uint16_t i, bytes;
+
+    OSA_InterruptDisable();
+    if( pSer->rxIn >= pSer->rxOut )
+    {
+        bytes = pSer->rxIn - pSer->rxOut;
+    }
+    else
+    {
+        bytes = gSMRxBufSize_c - pSer->rxOut + pSer->rxIn;
+    }
+    OSA_InterruptEnable();
+
+    if( bytes > dataSize )
+    {
+        bytes = dataSize;
+    }
+
+    for( i=0; i<bytes; i++ )
+    {
+        OSA_InterruptDisable();
+        *pData++ = pSer->rxBuffer[pSer->rxOut++];
+        if ( pSer->rxOut >= gSMRxBufSize_c )
+        {
+            pSer->rxOut = 0;
+        }
+        OSA_InterruptEnable();
+    }
+
+    return bytes;
+}
+
+/*! *********************************************************************************
+* \brief  Enters the ISR: waits for the current critical section to end.
+********************************************************************************** */
+static uint64_t BenchIsrEnter(void)
+{
+    uint64_t t0 = BenchNow();
+    uint64_t t1;
+
+    while( __atomic_exchange_n(&mIrqLock, 1, __ATOMIC_ACQUIRE) )
+    {
+        sched_yield();
+    }
+    mIrqDepth++;
+    t1 = BenchNow();
+
+    mIsrStats.delaySum += t1 - t0;
+    if( t1 - t0 > mIsrStats.delayMax )
+    {
+        mIsrStats.delayMax = t1 - t0;
+    }
+
+    return t1;
+}
+
+static void BenchIsrExit(uint64_t t1)
+{
+    uint64_t t2;
+
+    t2 = BenchNow();
+    mIrqDepth--;
+    __atomic_store_n(&mIrqLock, 0, __ATOMIC_RELEASE);
+
+    mIsrStats.calls++;
+    mIsrStats.timeSum += t2 - t1;
+    if( t2 - t1 > mIsrStats.timeMax )
+    {
+        mIsrStats.timeMax = t2 - t1;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  The eDMA writes the bytes of the stream circularly in the Rx buffer.
+********************************************************************************** */
+static void BenchDmaWrite(uint32_t pos, uint32_t len)
+{
+    serial_t *pSer = &mSerials[mBenchInterface_c];
+    uint32_t i;
+
+    for( i=0; i<len; i++ )
+    {
+        pSer->rxBuffer[mDmaPos] = BenchStreamByte(pos + i);
+        __atomic_store_n(&mDmaPos, (mDmaPos + 1 == gSMRxBufSize_c) ? 0 : mDmaPos + 1, __ATOMIC_RELEASE);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  The eDMA interrupt, as UART_RxDmaUpdate() reports it: the eDMA position and
+*         the bytes written since the previous interrupt.
+********************************************************************************** */
+static void BenchDmaIsr(uint32_t len)
+{
+    mUartState.pRxData = &mSerials[mBenchInterface_c].rxBuffer[mDmaPos];
+    mUartState.rxSize = len;
+    mUartState.rxCb(&mUartState);
+}
+
+/*! *********************************************************************************
+* \brief  Waits until the Rx buffer has room for the given number of bytes.
+********************************************************************************** */
+static void BenchWaitRoom(uint32_t bytes)
+{
+    while( BenchRxCount() + bytes > gSMRxBufSize_c - 1 )
+    {
+        sched_yield();
+    }
+}
+
+static void* BenchProducer(void *param)
+{
+    serial_t *pSer = &mSerials[mBenchInterface_c];
+    uint8_t burst[gSMRxBufSize_c];
+    uint32_t pos = 0;
+    uint32_t len, i;
+    bufIndex_t rxIn;
+    uint64_t t;
+
+    (void)param;
+    mRandState = mSeed ^ 0x2545F491;
+
+    while( pos < mBytes )
+    {
+        switch( mRun->producer )
+        {
+        case mBenchIsrByte_c:
+        case mBenchIsrByteRef_c:
+            if( !mRun->overflow )
+            {
+                BenchWaitRoom(1);
+            }
+            t = BenchIsrEnter();
+            /* The UART ISR writes the byte at rxIn before calling the Rx callback */
+            rxIn = pSer->rxIn;
+            pSer->rxBuffer[rxIn] = BenchStreamByte(pos);
+            if( mBenchIsrByte_c == mRun->producer )
+            {
+                SerialManager_RxNotify(mBenchInterface_c);
+            }
+            else
+            {
+                BenchRefRxNotify();
+            }
+            if( rxIn == pSer->rxIn )
+            {
+                mDropped[pos] = 1;
+                mDroppedCount++;
+            }
+            BenchIsrExit(t);
+            pos++;
+            break;
+
+        case mBenchBurst_c:
+            len = 1 + BenchRand() % mBenchBurstMax_c;
+            if( len > mBytes - pos )
+            {
+                len = mBytes - pos;
+            }
+            for( i=0; i<len; i++ )
+            {
+                burst[i] = BenchStreamByte(pos + i);
+            }
+            BenchWaitRoom(len);
+            t = BenchIsrEnter();
+            if( 0 != Serial_CustomReceiveData(mBenchInterface_c, burst, len) )
+            {
+                printf("FAIL: Serial_CustomReceiveData() dropped bytes of a burst that fits\n");
+                mFailures++;
+            }
+            BenchIsrExit(t);
+            pos += len;
+            break;
+
+        case mBenchDma_c:
+            len = 1 + BenchRand() % (gSMRxBufSize_c / 2);
+            if( len > mBytes - pos )
+            {
+                len = mBytes - pos;
+            }
+            if( !mRun->overflow )
+            {
+                BenchWaitRoom(len);
+            }
+            BenchDmaWrite(pos, len);
+            t = BenchIsrEnter();
+            BenchDmaIsr(len);
+            BenchIsrExit(t);
+            pos += len;
+            break;
+        }
+    }
+
+    mProducerDone = 1;
+    return NULL;
+}
+
+/*! *********************************************************************************
+* \brief  Checks the bytes read against the stream, the dropped bytes skipped.
+********************************************************************************** */
+static void BenchCheck(const uint8_t *pData, uint32_t len)
+{
+    static uint32_t pos;
+    uint32_t i;
+
+    if( 0 == mReceived )
+    {
+        pos = 0;
+    }
+
+    /* The eDMA may overwrite the bytes being read */
+    if( (mBenchDma_c == mRun->producer) && mRun->overflow )
+    {
+        mReceived += len;
+        return;
+    }
+
+    for( i=0; i<len; i++ )
+    {
+        while( (pos < mBytes) && mDropped[pos] )
+        {
+            pos++;
+        }
+        if( (pos >= mBytes) || (pData[i] != BenchStreamByte(pos)) )
+        {
+            if( mFailures++ < 8 )
+            {
+                printf("FAIL: byte %u of the stream: read 0x%02X, expected 0x%02X\n", (unsigned)pos,
+                       pData[i], (pos < mBytes) ? BenchStreamByte(pos) : 0);
+            }
+        }
+        pos++;
+    }
+    mReceived += len;
+}
+
+static void* BenchConsumer(void *param)
+{
+    uint8_t buf[mBenchReadMax_c];
+    uint8_t *pData;
+    uint16_t bytes, len;
+    volatile uint32_t spin;
+    serialStatus_t status;
+    int done;
+
+    (void)param;
+    mRandState = mSeed ^ 0x6C078965;
+    mCriticalSections = 0;
+
+    for(;;)
+    {
+        len = 1 + BenchRand() % mBenchReadMax_c;
+        bytes = 0;
+        /* Taken before the read: all the bytes were published if the read finds none */
+        done = mProducerDone;
+
+        switch( mRun->consumer )
+        {
+        case mBenchRead_c:
+            status = Serial_Read(mBenchInterface_c, buf, len, &bytes);
+            pData = buf;
+            break;
+
+        case mBenchPeek_c:
+            status = Serial_RxPeek(mBenchInterface_c, &pData, &bytes);
+            if( bytes > len )
+            {
+                bytes = len;
+            }
+            break;
+
+        default:
+            status = gSerial_Success_c;
+            bytes = BenchRefRead(buf, len);
+            pData = buf;
+            break;
+        }
+
+        mConsumerCalls++;
+
+        if( gSerial_Success_c != status )
+        {
+            printf("FAIL: consumer status %d\n", status);
+            mFailures++;
+            break;
+        }
+
+        if( bytes )
+        {
+            BenchCheck(pData, bytes);
+            if( mBenchPeek_c == mRun->consumer )
+            {
+                if( gSerial_Success_c != Serial_RxConsume(mBenchInterface_c, bytes) )
+                {
+                    printf("FAIL: Serial_RxConsume() of peeked bytes\n");
+                    mFailures++;
+                    break;
+                }
+            }
+        }
+        else if( done && (0 == BenchRxCount()) )
+        {
+            break;
+        }
+        else
+        {
+            sched_yield();
+        }
+
+        if( mRun->overflow )
+        {
+            for( spin = BenchRand() % 2048; spin; spin-- ) {}
+        }
+    }
+
+    mConsumerCriticalSections = mCriticalSections;
+    return NULL;
+}
+
+static void BenchExecute(const benchRun_t *pRun)
+{
+    serial_t *pSer = &mSerials[mBenchInterface_c];
+    pthread_t producer, consumer;
+    uint64_t t0, t1;
+    double seconds;
+    uint16_t count;
+    uint32_t dropped;
+    uint8_t *pData;
+
+    mRun = pRun;
+    memset((void*)mDropped, 0, mBytes);
+    memset(&mIsrStats, 0, sizeof(mIsrStats));
+    memset(pSer, 0, sizeof(*pSer));
+    pSer->serialType = (mBenchDma_c == pRun->producer) ? gSerialMgrUart_c : gSerialMgrCustom_c;
+    mUartState.rxCb = Serial_UartRxCb;
+    mUartState.rxCbParam = mBenchInterface_c;
+    mDmaPos = 0;
+    mProducerDone = 0;
+    mDroppedCount = 0;
+    mReceived = 0;
+    mConsumerCalls = 0;
+
+    t0 = BenchNow();
+    pthread_create(&consumer, NULL, BenchConsumer, NULL);
+    pthread_create(&producer, NULL, BenchProducer, NULL);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    t1 = BenchNow();
+    seconds = (double)(t1 - t0) / 1e9;
+
+    Serial_RxDroppedCount(mBenchInterface_c, &dropped);
+    if( mBenchDma_c == pRun->producer )
+    {
+        mDroppedCount = dropped;
+    }
+    else if( dropped != mDroppedCount )
+    {
+        printf("FAIL: %s: %u bytes reported dropped, %llu dropped\n", pRun->name,
+               (unsigned)dropped, (unsigned long long)mDroppedCount);
+        mFailures++;
+    }
+
+    if( mReceived + mDroppedCount != mBytes )
+    {
+        printf("FAIL: %s: %llu bytes read and %llu dropped out of %u\n", pRun->name,
+               (unsigned long long)mReceived, (unsigned long long)mDroppedCount, (unsigned)mBytes);
+        mFailures++;
+    }
+    if( pRun->overflow && (0 == mDroppedCount) )
+    {
+        printf("note: %s: the Rx buffer did not overflow\n", pRun->name);
+    }
+
+    /* The API must report an empty Rx buffer */
+    Serial_RxBufferByteCount(mBenchInterface_c, &count);
+    Serial_RxPeek(mBenchInterface_c, &pData, &count);
+    if( count || (gSerial_Success_c == Serial_RxConsume(mBenchInterface_c, 1)) )
+    {
+        printf("FAIL: %s: the Rx buffer is not empty at the end\n", pRun->name);
+        mFailures++;
+    }
+
+    printf("%-24s %6.1f MB/s %5.1f B/read ", pRun->name, (double)mReceived / seconds / 1e6,
+           (double)mReceived / (double)mConsumerCalls);
+    if( mConsumerCriticalSections )
+    {
+        printf("%5.2f B/crit ", (double)mReceived / (double)mConsumerCriticalSections);
+    }
+    else
+    {
+        printf("%5s B/crit ", "inf");
+    }
+    printf("%5.1f B/ISR ", (double)(mBytes - mDroppedCount) / (double)mIsrStats.calls);
+    printf("ISR delay max %6.1f us mean %3.0f ns, time max %6.1f us mean %3.0f ns",
+           mIsrStats.delayMax / 1e3, (double)mIsrStats.delaySum / (double)mIsrStats.calls,
+           mIsrStats.timeMax / 1e3, (double)mIsrStats.timeSum / (double)mIsrStats.calls);
+    if( pRun->overflow )
+    {
+        printf("  %.1f%% dropped", 100.0 * (double)mDroppedCount / (double)mBytes);
+    }
+    printf("\n");
+}
+
+/*! *********************************************************************************
+* \brief  Writes len bytes with the eDMA, reported by interrupts of at most irqLen
+*         bytes, then checks that the Rx buffer holds the newest bytes and that the
+*         others are reported dropped.
+********************************************************************************** */
+static void BenchDmaOverrunCase(const char *name, uint32_t start, uint32_t len, uint32_t irqLen)
+{
+    serial_t *pSer = &mSerials[mBenchInterface_c];
+    uint8_t buf[gSMRxBufSize_c];
+    uint32_t expected, dropped, written, i;
+    uint16_t count, bytes;
+
+    memset(pSer, 0, sizeof(*pSer));
+    pSer->serialType = gSerialMgrUart_c;
+    pSer->rxIn = pSer->rxOut = start;
+    mDmaPos = start;
+
+    for( written = 0; written < len; written += irqLen )
+    {
+        if( irqLen > len - written )
+        {
+            irqLen = len - written;
+        }
+        BenchDmaWrite(written, irqLen);
+        BenchDmaIsr(irqLen);
+    }
+
+    expected = (len < gSMRxBufSize_c - 1) ? len : gSMRxBufSize_c - 1;
+    Serial_RxBufferByteCount(mBenchInterface_c, &count);
+    Serial_RxDroppedCount(mBenchInterface_c, &dropped);
+    Serial_Read(mBenchInterface_c, buf, sizeof(buf), &bytes);
+
+    if( (count != expected) || (bytes != expected) || (dropped != len - expected) )
+    {
+        printf("FAIL: eDMA overrun, %s: %u bytes counted, %u read, %u dropped, expected %u and %u dropped\n",
+               name, count, bytes, (unsigned)dropped, (unsigned)expected, (unsigned)(len - expected));
+        mFailures++;
+        return;
+    }
+
+    for( i=0; i<bytes; i++ )
+    {
+        if( buf[i] != BenchStreamByte(len - expected + i) )
+        {
+            printf("FAIL: eDMA overrun, %s: byte %u of the stream is not read\n", name,
+                   (unsigned)(len - expected + i));
+            mFailures++;
+            return;
+        }
+    }
+}
+
+static void BenchDmaOverrun(void)
+{
+    uint8_t buf[gSMRxBufSize_c];
+    uint32_t dropped, i;
+    uint16_t bytes;
+
+    mRun = &mRuns[0];
+    mUartState.rxCb = Serial_UartRxCb;
+    mUartState.rxCbParam = mBenchInterface_c;
+
+    BenchDmaOverrunCase("full buffer", 5, gSMRxBufSize_c - 1, gSMRxBufSize_c / 2);
+    BenchDmaOverrunCase("reserved location", 5, gSMRxBufSize_c, gSMRxBufSize_c / 2);
+    BenchDmaOverrunCase("unread bytes", 0, gSMRxBufSize_c + 7, gSMRxBufSize_c / 2);
+    BenchDmaOverrunCase("whole buffer interrupt", 9, gSMRxBufSize_c, gSMRxBufSize_c);
+    BenchDmaOverrunCase("three buffers", 3, 3 * gSMRxBufSize_c + 1, gSMRxBufSize_c / 2);
+
+    /* The bytes written after an overrun are read in order */
+    BenchDmaWrite(3 * gSMRxBufSize_c + 1, gSMRxBufSize_c / 2);
+    BenchDmaIsr(gSMRxBufSize_c / 2);
+    Serial_RxDroppedCount(mBenchInterface_c, &dropped);
+    Serial_Read(mBenchInterface_c, buf, sizeof(buf), &bytes);
+    for( i=0; (bytes == gSMRxBufSize_c / 2) && (i < bytes); i++ )
+    {
+        if( buf[i] != BenchStreamByte(3 * gSMRxBufSize_c + 1 + i) )
+        {
+            break;
+        }
+    }
+    if( (i != gSMRxBufSize_c / 2) || (dropped != 2 * gSMRxBufSize_c + 2) )
+    {
+        printf("FAIL: eDMA overrun: the bytes written after an overrun are not read\n");
+        mFailures++;
+    }
+    printf("eDMA overrun: %s\n", mFailures ? "failed" : "ok");
+}
+
+/*! *********************************************************************************
+* \brief  Measures the consumer cost alone: the full Rx buffer is read with reads of
+*         the given size, without a producer running.
+********************************************************************************** */
+static void BenchConsumerCost(benchConsumer_t consumer, const char *name, uint16_t readSize)
+{
+    serial_t *pSer = &mSerials[mBenchInterface_c];
+    static uint8_t data[gSMRxBufSize_c];
+    uint8_t buf[gSMRxBufSize_c];
+    uint8_t *pData;
+    uint64_t t0, elapsed = 0, bytes = 0;
+    uint16_t count;
+    uint32_t iter, start;
+
+    memset(pSer, 0, sizeof(*pSer));
+    pSer->serialType = gSerialMgrCustom_c;
+    mCriticalSections = 0;
+
+    for( iter=0; iter<20000; iter++ )
+    {
+        /* Start anywhere in the Rx buffer, the wrap around included */
+        start = iter % gSMRxBufSize_c;
+        pSer->rxIn = pSer->rxOut = start;
+        (void)Serial_CustomReceiveData(mBenchInterface_c, data, gSMRxBufSize_c - 1);
+
+        t0 = BenchNow();
+        do
+        {
+            count = 0;
+            if( mBenchPeek_c == consumer )
+            {
+                Serial_RxPeek(mBenchInterface_c, &pData, &count);
+                if( count > readSize )
+                {
+                    count = readSize;
+                }
+                if( count )
+                {
+                    FLib_MemCpy(buf, pData, count);
+                    Serial_RxConsume(mBenchInterface_c, count);
+                }
+            }
+            else if( mBenchRead_c == consumer )
+            {
+                Serial_Read(mBenchInterface_c, buf, readSize, &count);
+            }
+            else
+            {
+                count = BenchRefRead(buf, readSize);
+            }
+            bytes += count;
+        } while( count );
+        elapsed += BenchNow() - t0;
+    }
+
+    printf("%-10s %3u B reads  %6.2f ns/B  ", name, (unsigned)readSize, (double)elapsed / (double)bytes);
+    if( mCriticalSections )
+    {
+        printf("%5.2f B/crit\n", (double)bytes / (double)mCriticalSections);
+    }
+    else
+    {
+        printf("%5s B/crit\n", "inf");
+    }
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    uint32_t i;
+
+    if( argc > 1 )
+    {
+        mBytes = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    mSeed = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : (uint32_t)time(NULL);
+
+    mDropped = malloc(mBytes);
+    if( (0 == mBytes) || (NULL == mDropped) )
+    {
+        printf("usage: SerialRingBench [bytes per run [seed]]\n");
+        return 1;
+    }
+
+    printf("Rx buffer %u bytes, %u bytes per run, seed %u\n", (unsigned)gSerialMgrRxBufSize_c,
+           (unsigned)mBytes, (unsigned)mSeed);
+
+    for( i=0; i<sizeof(mRuns)/sizeof(mRuns[0]); i++ )
+    {
+        BenchExecute(&mRuns[i]);
+    }
+
+    BenchDmaOverrun();
+
+    printf("\nconsumer cost, full Rx buffer:\n");
+    BenchConsumerCost(mBenchReadRef_c, "5.0.5 read", 1);
+    BenchConsumerCost(mBenchRead_c, "read", 1);
+    BenchConsumerCost(mBenchReadRef_c, "5.0.5 read", mBenchReadMax_c);
+    BenchConsumerCost(mBenchRead_c, "read", mBenchReadMax_c);
+    BenchConsumerCost(mBenchPeek_c, "peek", mBenchReadMax_c);
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
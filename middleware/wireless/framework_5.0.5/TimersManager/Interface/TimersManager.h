@@ -381,6 +381,31 @@ tmrErrCode_t TMR_StartTimer
     void *param
 );
 
+/*! -------------------------------------------------------------------------
+ * \brief     Start a specified timer which may expire late by up to slackInMilliseconds
+ *
+ * \param[in] timerId - the ID of the timer
+ * \param[in] timerType - the type of the timer
+ * \param[in] timeInMilliseconds - time expressed in millisecond units
+ * \param[in] slackInMilliseconds - maximum delay of the expiration, in milliseconds
+ * \param[in] pfTmrCallBack - callback function
+ * \param[in] param - parameter to callback function
+ *
+ * \return    the error code
+ * \details   Same as TMR_StartTimer(). The timer expires between timeInMilliseconds
+ *            and timeInMilliseconds + slackInMilliseconds, so that it can be handled
+ *            on the same MCU wakeup as the other timers expiring in that window.
+ *---------------------------------------------------------------------------*/
+tmrErrCode_t TMR_StartTimerWithSlack
+(
+    tmrTimerID_t timerID,
+    tmrTimerType_t timerType,
+    tmrTimeInMilliseconds_t timeInMilliseconds,
+    tmrTimeInMilliseconds_t slackInMilliseconds,
+    pfTmrCallBack_t callback,
+    void *param
+);
+
 /*! -------------------------------------------------------------------------
  * \brief   Start a low power timer. When the timer goes off, call the
  *              callback function in non-interrupt context.
@@ -585,6 +610,23 @@ void TMR_MakeTMRThreadReady
  void   
 );
 
+/*! -------------------------------------------------------------------------
+ * \brief   Returns the number of timer thread runs that handled expired timers
+ *---------------------------------------------------------------------------*/
+uint32_t TMR_GetWakeupCount
+(
+    void
+);
+
+/*! -------------------------------------------------------------------------
+ * \brief   Returns the number of timer expirations. The difference to
+ *          TMR_GetWakeupCount() is the number of wakeups saved by coalescing.
+ *---------------------------------------------------------------------------*/
+uint32_t TMR_GetExpirationCount
+(
+    void
+);
+
 /*! -------------------------------------------------------------------------
  * \brief     Convert milliseconds to ticks
  * \param[in] milliseconds
@@ -656,6 +698,7 @@ uint64_t TMR_GetTimestamp(void);
 #define TMR_FreeTimer(timerID)      0
 #define TMR_IsTimerActive(timerID)  0
 #define TMR_StartTimer(timerID,timerType,timeInMilliseconds, pfTimerCallBack, param) 0
+#define TMR_StartTimerWithSlack(timerID,timerType,timeInMilliseconds,slackInMilliseconds,pfTimerCallBack,param) 0
 #define TMR_StartLowPowerTimer(timerId,timerType,timeIn,pfTmrCallBack,param) 0
 #if gTMR_EnableMinutesSecondsTimers_d
 #define TMR_StartMinuteTimer(timerId,timeInMinutes,pfTmrCallBack,param) 0
@@ -675,6 +718,8 @@ uint64_t TMR_GetTimestamp(void);
 #define TMR_GetTimerFreq()                          0
 #define TMR_GetRemainingTime(tmrID)                 0
 #define TMR_GetFirstExpireTime                      0xFFFFFFFF
+#define TMR_GetWakeupCount()                        0
+#define TMR_GetExpirationCount()                    0
 #define TMR_AllocateMinuteTimer()     TMR_AllocateTimer()
 #define TMR_AllocateSecondTimer()     TMR_AllocateTimer()
 #define TMR_FreeMinuteTimer(timerID)  TMR_FreeTimer(timerID)
@@ -50,6 +50,10 @@
 *****************************************************************************/
 #define mTmrDummyEvent_c (1<<16)
 
+/* Size of the stack used to walk the timer heap. Must be larger than the
+   depth of a heap of gTmrTotalTimers_c (at most 255) entries. */
+#define mTmrHeapWalkStackSize_c  16
+
 /*****************************************************************************
 ******************************************************************************
 * Public memory declarations
@@ -111,6 +115,64 @@ static void TMR_SetTimerType
     tmrTimerType_t type
 );
 
+/*! -------------------------------------------------------------------------
+ * \brief     Returns the current time. Must be called with interrupts disabled.
+ * \return    absolute time in ticks
+ *---------------------------------------------------------------------------*/
+static tmrTimerTicks64_t TMR_GetCurrentTicks
+(
+    void
+);
+
+/*! -------------------------------------------------------------------------
+ * \brief     Adds a timer to the expiry heap
+ * \param[in] timerID - the timer ID
+ *---------------------------------------------------------------------------*/
+static void TMR_HeapInsert
+(
+    tmrTimerID_t timerID
+);
+
+/*! -------------------------------------------------------------------------
+ * \brief     Removes a timer from the expiry heap
+ * \param[in] timerID - the timer ID
+ *---------------------------------------------------------------------------*/
+static void TMR_HeapRemove
+(
+    tmrTimerID_t timerID
+);
+
+/*! -------------------------------------------------------------------------
+ * \brief     Moves a heap entry towards the root until the heap is ordered
+ * \param[in] pos - position in the heap
+ *---------------------------------------------------------------------------*/
+static void TMR_HeapSiftUp
+(
+    uint32_t pos
+);
+
+/*! -------------------------------------------------------------------------
+ * \brief     Moves a heap entry towards the leaves until the heap is ordered
+ * \param[in] pos - position in the heap
+ *---------------------------------------------------------------------------*/
+static void TMR_HeapSiftDown
+(
+    uint32_t pos
+);
+
+/*! -------------------------------------------------------------------------
+ * \brief     Returns the latest time at which the timers of the specified types
+ *            can be handled together. Must be called with interrupts disabled.
+ * \param[in] timerType - mask of timer types
+ * \param[in] activeOnly - ignore the timers not yet started by the timer thread
+ * \return    absolute time in ticks, 0xFFFFFFFFFFFFFFFF if there is no such timer
+ *---------------------------------------------------------------------------*/
+static tmrTimerTicks64_t TMR_GetWakeupTicks
+(
+    tmrTimerType_t timerType,
+    bool_t activeOnly
+);
+
 
 
 /*! -------------------------------------------------------------------------
@@ -196,6 +258,47 @@ static tmrTimerTableEntry_t maTmrTimerTable[gTmrTotalTimers_c];
  */
 static tmrStatus_t maTmrTimerStatusTable[gTmrTotalTimers_c];
 
+/*
+ * \brief Absolute time in ticks when previousTimeInTicks was read.
+ *              The current time is this value plus the ticks counted since then.
+ * VALUES: see definition
+ */
+static tmrTimerTicks64_t mTmrCurrentTicks;
+
+/*
+ * \brief Min-heap of the active timers, ordered by expireTicks.
+ *              The root is the next timer to expire.
+ * VALUES: timer IDs
+ */
+static tmrTimerID_t maTmrHeap[gTmrTotalTimers_c];
+
+/*
+ * \brief Number of timers in maTmrHeap
+ * VALUES: 0..gTmrTotalTimers_c
+ */
+static uint8_t mTmrHeapSize = 0;
+
+/*
+ * \brief Position + 1 of each timer in maTmrHeap. 0 if the timer is not active.
+ * VALUES: 0..gTmrTotalTimers_c
+ */
+static uint8_t maTmrHeapPos[gTmrTotalTimers_c];
+
+/*
+ * \brief Bitmap of the timers started with TMR_StartTimer() that were not yet
+ *              started by the timer thread (mTmrStatusReady_c).
+ * VALUES: see definition
+ */
+static uint32_t maTmrReadyTimers[(gTmrTotalTimers_c + 31) / 32];
+
+/*
+ * \brief Number of timer thread runs that handled expired timers
+ *              and number of timer expirations.
+ * VALUES: uint32_t range
+ */
+static uint32_t mTmrWakeupCount = 0;
+static uint32_t mTmrExpirationCount = 0;
+
 /*
  * \brief Number of Active timers (without low power capability)
  *              the MCU can not enter low power if numberOfActiveTimers!=0
@@ -343,6 +446,188 @@ static void TMR_SetTimerType
     maTmrTimerStatusTable[timerID] = (tmrStatus_t)(maTmrTimerStatusTable[timerID] & (tmrStatus_t)(~mTimerType_c)) | type;
 }
 
+/*! -------------------------------------------------------------------------
+* \brief     Returns the current time. Must be called with interrupts disabled.
+* \return    absolute time in ticks
+*---------------------------------------------------------------------------*/
+static tmrTimerTicks64_t TMR_GetCurrentTicks
+(
+    void
+)
+{
+    return mTmrCurrentTicks + (tmrTimerTicks16_t)(StackTimer_GetCounterValue() - previousTimeInTicks);
+}
+
+/*! -------------------------------------------------------------------------
+* \brief     Adds a timer to the expiry heap. Must be called with interrupts disabled.
+* \param[in] timerID - the timer ID
+*---------------------------------------------------------------------------*/
+static void TMR_HeapInsert
+(
+    tmrTimerID_t timerID
+)
+{
+    if( TMR_IsTimerInHeap(timerID) )
+    {
+        TMR_HeapRemove(timerID);
+    }
+
+    maTmrHeap[mTmrHeapSize] = timerID;
+    TMR_HeapSiftUp(mTmrHeapSize++);
+}
+
+/*! -------------------------------------------------------------------------
+* \brief     Removes a timer from the expiry heap. Must be called with interrupts disabled.
+* \param[in] timerID - the timer ID
+*---------------------------------------------------------------------------*/
+static void TMR_HeapRemove
+(
+    tmrTimerID_t timerID
+)
+{
+    uint32_t pos;
+
+    if( TMR_IsTimerInHeap(timerID) )
+    {
+        pos = maTmrHeapPos[timerID] - 1;
+        maTmrHeapPos[timerID] = 0;
+
+        /* Move the last entry in the freed position */
+        if( pos < --mTmrHeapSize )
+        {
+            maTmrHeap[pos] = maTmrHeap[mTmrHeapSize];
+            TMR_HeapSiftUp(pos);
+            TMR_HeapSiftDown(maTmrHeapPos[maTmrHeap[pos]] - 1);
+        }
+    }
+}
+
+/*! -------------------------------------------------------------------------
+* \brief     Moves a heap entry towards the root until the heap is ordered
+* \param[in] pos - position in the heap
+*---------------------------------------------------------------------------*/
+static void TMR_HeapSiftUp
+(
+    uint32_t pos
+)
+{
+    tmrTimerID_t timerID = maTmrHeap[pos];
+    uint32_t parent;
+
+    while( pos > 0 )
+    {
+        parent = (pos - 1) / 2;
+
+        if( maTmrTimerTable[maTmrHeap[parent]].expireTicks <= maTmrTimerTable[timerID].expireTicks )
+        {
+            break;
+        }
+
+        maTmrHeap[pos] = maTmrHeap[parent];
+        maTmrHeapPos[maTmrHeap[pos]] = pos + 1;
+        pos = parent;
+    }
+
+    maTmrHeap[pos] = timerID;
+    maTmrHeapPos[timerID] = pos + 1;
+}
+
+/*! -------------------------------------------------------------------------
+* \brief     Moves a heap entry towards the leaves until the heap is ordered
+* \param[in] pos - position in the heap
+*---------------------------------------------------------------------------*/
+static void TMR_HeapSiftDown
+(
+    uint32_t pos
+)
+{
+    tmrTimerID_t timerID = maTmrHeap[pos];
+    uint32_t child;
+
+    while( (child = 2 * pos + 1) < mTmrHeapSize )
+    {
+        if( (child + 1 < mTmrHeapSize) &&
+            (maTmrTimerTable[maTmrHeap[child + 1]].expireTicks < maTmrTimerTable[maTmrHeap[child]].expireTicks) )
+        {
+            child++;
+        }
+
+        if( maTmrTimerTable[timerID].expireTicks <= maTmrTimerTable[maTmrHeap[child]].expireTicks )
+        {
+            break;
+        }
+
+        maTmrHeap[pos] = maTmrHeap[child];
+        maTmrHeapPos[maTmrHeap[pos]] = pos + 1;
+        pos = child;
+    }
+
+    maTmrHeap[pos] = timerID;
+    maTmrHeapPos[timerID] = pos + 1;
+}
+
+/*! -------------------------------------------------------------------------
+* \brief     Returns the latest time at which the timers of the specified types
+*            can be handled together: the earliest expireTicks + slackInTicks.
+*            Must be called with interrupts disabled.
+* \param[in] timerType - mask of timer types
+* \param[in] activeOnly - ignore the timers not yet started by the timer thread
+* \return    absolute time in ticks, 0xFFFFFFFFFFFFFFFF if there is no such timer
+*---------------------------------------------------------------------------*/
+static tmrTimerTicks64_t TMR_GetWakeupTicks
+(
+    tmrTimerType_t timerType,
+    bool_t activeOnly
+)
+{
+    tmrTimerTicks64_t wakeupTicks = (tmrTimerTicks64_t)-1;
+    tmrTimerTicks64_t deadline;
+    uint8_t stack[mTmrHeapWalkStackSize_c];
+    uint32_t top = 0, pos;
+    tmrTimerID_t timerID;
+
+    if( mTmrHeapSize )
+    {
+        stack[top++] = 0;
+    }
+
+    while( top )
+    {
+        pos = stack[--top];
+        timerID = maTmrHeap[pos];
+
+        /* The timers below this entry expire later, so they can not
+           bring the wakeup earlier. */
+        if( maTmrTimerTable[timerID].expireTicks >= wakeupTicks )
+        {
+            continue;
+        }
+
+        if( ((timerType == gTmrAllTypes_c) || (timerType & TMR_GetTimerType(timerID))) &&
+            ((!activeOnly) || (TMR_GetTimerStatus(timerID) == mTmrStatusActive_c)) )
+        {
+            deadline = maTmrTimerTable[timerID].expireTicks + maTmrTimerTable[timerID].slackInTicks;
+
+            if( deadline < wakeupTicks )
+            {
+                wakeupTicks = deadline;
+            }
+        }
+
+        if( 2 * pos + 2 < mTmrHeapSize )
+        {
+            stack[top++] = 2 * pos + 2;
+        }
+
+        if( 2 * pos + 1 < mTmrHeapSize )
+        {
+            stack[top++] = 2 * pos + 1;
+        }
+    }
+
+    return wakeupTicks;
+}
+
 #endif /*gTMR_Enabled_d*/
 
 
@@ -567,11 +852,11 @@ uint32_t TMR_GetRemainingTime
     tmrTimerID_t tmrID
 )
 {
-    tmrTimerTicks16_t currentTime, elapsedRemainingTicks;
+    tmrTimerTicks64_t currentTicks;
     uint32_t remainingTime, freq = mCounterFreqHz;
     
     if( (tmrID >= gTmrTotalTimers_c) || (!TMR_IsTimerAllocated(tmrID)) ||
-        (maTmrTimerTable[tmrID].remainingTicks == 0) )
+        (!TMR_IsTimerInHeap(tmrID)) )
     {
         remainingTime = 0;
     }
@@ -579,22 +864,15 @@ uint32_t TMR_GetRemainingTime
     {
         TmrIntDisableAll();
         
-        currentTime = StackTimer_GetCounterValue();
-        
-        if(currentTime < maTmrTimerTable[tmrID].timestamp)
-        {
-            currentTime += 0xFFFF;
-        }
-        
-        elapsedRemainingTicks = currentTime - maTmrTimerTable[tmrID].timestamp;
+        currentTicks = TMR_GetCurrentTicks();
         
-        if(elapsedRemainingTicks > maTmrTimerTable[tmrID].remainingTicks)
+        if(currentTicks >= maTmrTimerTable[tmrID].expireTicks)
         {
             remainingTime = 1;
         }
         else
         {
-            remainingTime = ((uint64_t)(maTmrTimerTable[tmrID].remainingTicks - elapsedRemainingTicks) * 1000 + freq - 1) / freq;
+            remainingTime = ((maTmrTimerTable[tmrID].expireTicks - currentTicks) * 1000 + freq - 1) / freq;
         }
         
         TmrIntRestoreAll();
@@ -605,30 +883,38 @@ uint32_t TMR_GetRemainingTime
 
 /*! -------------------------------------------------------------------------
  * \brief     Returns the remaining time until first timeout, for the
- *            specified timer types
+ *            specified timer types. Timers started with a slack are
+ *            considered expired at the latest time when all the timers
+ *            expiring until then can be handled together.
  * \param[in] timerType mask of timer types 
  * \return    remaining time in milliseconds until first timer timeouts.
  *---------------------------------------------------------------------------*/
 uint32_t TMR_GetFirstExpireTime(tmrTimerType_t timerType)
 {
-    uint32_t min = 0xFFFFFFFF;
-    uint32_t remainingTime;
-    uint32_t timerID;
+    tmrTimerTicks64_t wakeupTicks, currentTicks;
+    uint32_t remainingTime, freq = mCounterFreqHz;
+    
+    TmrIntDisableAll();
+    
+    wakeupTicks = TMR_GetWakeupTicks(timerType, TRUE);
+    currentTicks = TMR_GetCurrentTicks();
     
-    for( timerID = 0; timerID < NumberOfElements(maTmrTimerTable); ++timerID )
+    TmrIntRestoreAll();
+    
+    if( wakeupTicks == (tmrTimerTicks64_t)-1 )
     {
-        if( TMR_IsTimerActive(timerID) && ((timerType & TMR_GetTimerType(timerID)) > 0) )
-        {
-            remainingTime = TMR_GetRemainingTime(timerID);
-
-            if( remainingTime < min )
-            {
-                min = remainingTime;
-            }
-        }
+        remainingTime = 0xFFFFFFFF;
+    }
+    else if( currentTicks >= wakeupTicks )
+    {
+        remainingTime = 1;
+    }
+    else
+    {
+        remainingTime = ((wakeupTicks - currentTicks) * 1000 + freq - 1) / freq;
     }
     
-    return min;
+    return remainingTime;
 }
 
 /*! -------------------------------------------------------------------------
@@ -651,8 +937,35 @@ tmrErrCode_t TMR_StartTimer
     pfTmrCallBack_t callback,
     void *param
 )
+{
+    return TMR_StartTimerWithSlack(timerID, timerType, timeInMilliseconds, 0, callback, param);
+}
+
+/*! -------------------------------------------------------------------------
+ * \brief Start a specified timer which may expire late by up to slackInMilliseconds
+ * \param[in] timerId - the ID of the timer
+ * \param[in] timerType - the type of the timer
+ * \param[in] timeInMilliseconds - time expressed in millisecond units
+ * \param[in] slackInMilliseconds - maximum delay of the expiration, in milliseconds
+ * \param[in] pfTmrCallBack - callback function
+ * \param[in] param - parameter to callback function
+ *
+ * \details The timer thread wakes up at the latest time allowed by the slack of
+ *        the pending timers, and handles all the timers expired until then,
+ *        so that timers with overlapping windows share one wakeup.
+ *---------------------------------------------------------------------------*/
+tmrErrCode_t TMR_StartTimerWithSlack
+(
+    tmrTimerID_t timerID,
+    tmrTimerType_t timerType,
+    tmrTimeInMilliseconds_t timeInMilliseconds,
+    tmrTimeInMilliseconds_t slackInMilliseconds,
+    pfTmrCallBack_t callback,
+    void *param
+)
 {
     tmrErrCode_t status;
+    tmrTimerTicks64_t slackInTicks;
     tmrTimerTicks64_t intervalInTicks;
 
     /* Stopping an already stopped timer is harmless. */
@@ -661,7 +974,6 @@ tmrErrCode_t TMR_StartTimer
     if( status == gTmrSuccess_c )
     {
         intervalInTicks = TmrTicksFromMilliseconds(timeInMilliseconds);
-        maTmrTimerTable[timerID].timestamp = StackTimer_GetCounterValue();
         
         if( !intervalInTicks )
         {
@@ -670,10 +982,15 @@ tmrErrCode_t TMR_StartTimer
         
         TMR_SetTimerType(timerID, timerType);
         maTmrTimerTable[timerID].intervalInTicks = intervalInTicks;
-        maTmrTimerTable[timerID].remainingTicks = intervalInTicks;
+        slackInTicks = TmrTicksFromMilliseconds(slackInMilliseconds);
+        maTmrTimerTable[timerID].slackInTicks = (slackInTicks > 0xFFFFFFFF) ? 0xFFFFFFFF : (tmrTimerTicks32_t)slackInTicks;
         maTmrTimerTable[timerID].pfCallBack = callback;
         maTmrTimerTable[timerID].param = param;
         
+        TmrIntDisableAll();
+        maTmrTimerTable[timerID].expireTicks = TMR_GetCurrentTicks() + intervalInTicks;
+        TmrIntRestoreAll();
+        
         /* Enable timer, the timer thread will do the rest of the work. */
         TMR_EnableTimer(timerID);
     }
@@ -880,6 +1197,8 @@ tmrErrCode_t TMR_StopTimer
         if ( (status == mTmrStatusActive_c) || (status == mTmrStatusReady_c) )
         {
             TMR_SetTimerStatus(timerID, mTmrStatusInactive_c);
+            TMR_ClearReadyFlag(timerID);
+            TMR_HeapRemove(timerID);
             DecrementActiveTimerNumber(TMR_GetTimerType(timerID));
             /* if no sw active timers are enabled, */
             /* call the TMR_Task() to countdown the ticks and stop the hw timer*/
@@ -915,9 +1234,11 @@ void TMR_Task
     tmrTimerTicks16_t nextInterruptTime;
     tmrTimerTicks16_t currentTimeInTicks;
     tmrTimerTicks16_t ticksSinceLastHere, ticksdiff;
+    tmrTimerTicks64_t currentTicks, wakeupTicks;
     pfTmrCallBack_t   pfCallBack;
+    void             *pCallBackParam;
     tmrTimerType_t    timerType;
-    tmrTimerStatus_t  status;
+    uint32_t i;
     uint8_t timerID;
 
     param=param;
@@ -935,92 +1256,95 @@ void TMR_Task
 
         currentTimeInTicks = StackTimer_GetCounterValue();
 
-        TmrIntRestoreAll();
-
         /* calculate difference between current and previous.  */
         ticksSinceLastHere = (currentTimeInTicks - previousTimeInTicks);
         /* remember for next time */
         previousTimeInTicks = currentTimeInTicks;
-        /* Find the shortest active timer. */
-        nextInterruptTime = mMaxToCountDown_c;
+        mTmrCurrentTicks += ticksSinceLastHere;
+        currentTicks = mTmrCurrentTicks;
 
-        for (timerID = 0; timerID < NumberOfElements(maTmrTimerTable); ++timerID)
+        /* If TMR_StartTimer() has been called for a timer, start it's count */
+        /* down as of now. */
+        for (i = 0; i < NumberOfElements(maTmrReadyTimers); ++i)
         {
-            timerType = TMR_GetTimerType(timerID);
+            for (timerID = i * 32; maTmrReadyTimers[i]; ++timerID)
+            {
+                if (maTmrReadyTimers[i] & (1UL << (timerID & 0x1F)))
+                {
+                    TMR_ClearReadyFlag(timerID);
+                    TMR_SetTimerStatus(timerID, mTmrStatusActive_c);
+                }
+            }
+        }
 
+        /* Count the runs handling expired timers, to measure the effect of coalescing. */
+        if ( (mTmrHeapSize) && (maTmrTimerTable[maTmrHeap[0]].expireTicks <= currentTicks) )
+        {
+            mTmrWakeupCount++;
+        }
+
+        TmrIntRestoreAll();
+
+        /* Handle the expired timers, the first to expire first. */
+        while (1)
+        {
             TmrIntDisableAll();
-            status = TMR_GetTimerStatus(timerID);
-            /* If TMR_StartTimer() has been called for this timer, start it's count */
-            /* down as of now. */
-            if( status == mTmrStatusReady_c )
+
+            if ( (!mTmrHeapSize) || (maTmrTimerTable[maTmrHeap[0]].expireTicks > currentTicks) )
             {
-                TMR_SetTimerStatus(timerID, mTmrStatusActive_c);
                 TmrIntRestoreAll();
-
-                if (nextInterruptTime > maTmrTimerTable[timerID].remainingTicks)
-                {
-                    nextInterruptTime = maTmrTimerTable[timerID].remainingTicks;
-                }                
+                break;
             }
-            else if (status == mTmrStatusActive_c)
+
+            mTmrExpirationCount++;
+
+            timerID = maTmrHeap[0];
+            timerType = TMR_GetTimerType(timerID);
+
+            /* If this is an interval timer, restart it. Otherwise, mark it as inactive. */
+            if ( (timerType & gTmrSingleShotTimer_c) ||
+                 (timerType & gTmrSetMinuteTimer_c)  ||
+                 (timerType & gTmrSetSecondTimer_c)  )
             {
-                TmrIntRestoreAll();
-                /* This timer is active. Decrement it's countdown.. */
-                if (maTmrTimerTable[timerID].remainingTicks > ticksSinceLastHere)
-                {
-                    TmrIntDisableAll();
-                    maTmrTimerTable[timerID].remainingTicks -= ticksSinceLastHere;
-                    maTmrTimerTable[timerID].timestamp = StackTimer_GetCounterValue();
-                    TmrIntRestoreAll();
-                    
-                    if (nextInterruptTime > maTmrTimerTable[timerID].remainingTicks)
-                    {
-                        nextInterruptTime = maTmrTimerTable[timerID].remainingTicks;
-                    }
-                }
-                else
-                {
-                    /* If this is an interval timer, restart it. Otherwise, mark it as inactive. */
-                    if ( (timerType & gTmrSingleShotTimer_c) ||
-                         (timerType & gTmrSetMinuteTimer_c)  ||
-                         (timerType & gTmrSetSecondTimer_c)  )
-                    {
-                        maTmrTimerTable[timerID].remainingTicks = 0;
-                        (void)TMR_StopTimer(timerID);
-                    }
-                    else
-                    {
-                        TmrIntDisableAll();
-                        
-                        maTmrTimerTable[timerID].remainingTicks = maTmrTimerTable[timerID].intervalInTicks;
-                        maTmrTimerTable[timerID].timestamp = StackTimer_GetCounterValue();
-                        if (nextInterruptTime > maTmrTimerTable[timerID].remainingTicks)
-                        {
-                            nextInterruptTime = maTmrTimerTable[timerID].remainingTicks;
-                        }
-                        
-                        TmrIntRestoreAll();
-                    }
-                    /* This timer has expired. */
-                    pfCallBack = maTmrTimerTable[timerID].pfCallBack;
-                    /*Call callback if it is not NULL
-                    This is done after the timer got updated,
-                    in case the timer gets stopped or restarted in the callback*/
-                    if (pfCallBack)
-                    {
-                        pfCallBack(maTmrTimerTable[timerID].param);
-                    }
-                }
+                (void)TMR_StopTimer(timerID);
             }
             else
             {
-                TmrIntRestoreAll();
-                /* Ignore any timer that is not active. */
+                maTmrTimerTable[timerID].expireTicks = currentTicks + maTmrTimerTable[timerID].intervalInTicks;
+                TMR_HeapSiftDown(0);
             }
-        }  /* for (timerID = 0; timerID < ... */
+
+            /* This timer has expired. */
+            pfCallBack = maTmrTimerTable[timerID].pfCallBack;
+            pCallBackParam = maTmrTimerTable[timerID].param;
+
+            TmrIntRestoreAll();
+
+            /*Call callback if it is not NULL
+            This is done after the timer got updated,
+            in case the timer gets stopped or restarted in the callback*/
+            if (pfCallBack)
+            {
+                pfCallBack(pCallBackParam);
+            }
+        }
 
         TmrIntDisableAll();
 
+        /* The next interrupt is programmed for the latest time when all the
+           timers expiring until then can be handled together. */
+        nextInterruptTime = mMaxToCountDown_c;
+        wakeupTicks = TMR_GetWakeupTicks(gTmrAllTypes_c, FALSE);
+
+        if (wakeupTicks <= currentTicks)
+        {
+            nextInterruptTime = 0;
+        }
+        else if (wakeupTicks - currentTicks < mMaxToCountDown_c)
+        {
+            nextInterruptTime = (tmrTimerTicks16_t)(wakeupTicks - currentTicks);
+        }
+
         /* Check to be sure that the timer was not programmed in the past for different source clocks.
          * The interrupts are now disabled.
          */
@@ -1077,6 +1401,29 @@ void TMR_Task
     }
 }
 
+/*! -------------------------------------------------------------------------
+ * \brief   Returns the number of timer thread runs that handled expired timers
+ *---------------------------------------------------------------------------*/
+uint32_t TMR_GetWakeupCount
+(
+    void
+)
+{
+    return mTmrWakeupCount;
+}
+
+/*! -------------------------------------------------------------------------
+ * \brief   Returns the number of timer expirations. The difference to
+ *          TMR_GetWakeupCount() is the number of wakeups saved by coalescing.
+ *---------------------------------------------------------------------------*/
+uint32_t TMR_GetExpirationCount
+(
+    void
+)
+{
+    return mTmrExpirationCount;
+}
+
 /*! -------------------------------------------------------------------------
  * \brief     Enable the specified timer
  * \param[in] tmrID - the timer ID
@@ -1092,6 +1439,8 @@ void TMR_EnableTimer
     {
         IncrementActiveTimerNumber(TMR_GetTimerType(tmrID));
         TMR_SetTimerStatus(tmrID, mTmrStatusReady_c);
+        TMR_SetReadyFlag(tmrID);
+        TMR_HeapInsert(tmrID);
         (void)OSA_EventSet(mTimerThreadEventId, mTmrDummyEvent_c);
     }
 
@@ -1139,36 +1488,13 @@ void TMR_SyncLpmTimers
 )
 {
 #if (gTMR_EnableLowPowerTimers_d)
-    uint32_t  timerID;
-    tmrTimerType_t timerType;
-
     /* Check if there are low power active timer */
     if (numberOfLowPowerActiveTimers)
     {
-        /* For each timer, detect the timer type and count down the spent duration in sleep */
-        for (timerID = 0; timerID < NumberOfElements(maTmrTimerTable); ++timerID)
-        {
-            /* Detect the timer type and count down the spent duration in sleep */
-            timerType = TMR_GetTimerType(timerID);
-            
-            /* Sync. only the low power timers that are active */
-            if ( (TMR_GetTimerStatus(timerID) == mTmrStatusActive_c)
-                && (IsLowPowerTimer(timerType)) )
-            {
-                /* Timer expired when MCU was in sleep mode??? */
-                if( maTmrTimerTable[timerID].remainingTicks > sleepDurationTmrTicks)
-                {
-                    maTmrTimerTable[timerID].remainingTicks -= sleepDurationTmrTicks;
-                    
-                }
-                else
-                {
-                    maTmrTimerTable[timerID].remainingTicks = 0;
-                }
-                
-            }
-            
-        }/* end for (timerID = 0;.... */
+        /* Count the time spent in sleep. The expiry times are absolute, so the
+           timers that expired while the MCU was in sleep mode are handled by
+           the next TMR_Task() run. */
+        mTmrCurrentTicks += sleepDurationTmrTicks;
         
         StackTimer_Enable();
         previousTimeInTicks = StackTimer_GetCounterValue();
@@ -94,6 +94,21 @@
     | gTmrIntervalTimer_c \
     | gTmrLowPowerTimer_c )
 
+/*
+ * \brief marks the specified timer as waiting to be started by the timer thread
+ */
+#define TMR_SetReadyFlag(timerID)       maTmrReadyTimers[(timerID) >> 5] |= (1UL << ((timerID) & 0x1F))
+
+/*
+ * \brief clears the ready flag of the specified timer
+ */
+#define TMR_ClearReadyFlag(timerID)     maTmrReadyTimers[(timerID) >> 5] &= ~(1UL << ((timerID) & 0x1F))
+
+/*
+ * \brief checks if the specified timer is in the expiry heap
+ */
+#define TMR_IsTimerInHeap(timerID)      (maTmrHeapPos[(timerID)])
+
 /*
  * \brief Disable interrupts
  */
@@ -135,18 +150,20 @@ typedef uint8_t tmrStatus_t;
  * Members: intervalInTicks - The timer's original duration, in ticks.
  *                            Used to reset intervnal timers.
  *
- *          countDown - When a timer is started, this is set to the duration.
- *                      The timer thread decrements this value. When it reaches
- *                      zero, the timer has expired.
+ *          expireTicks - When a timer is started, this is set to the absolute
+ *                        time, in ticks, when the timer expires. Active timers
+ *                        are kept in a min-heap ordered by this value.
+ *          slackInTicks - The timer may expire up to this many ticks after
+ *                         expireTicks, together with other timers.
  *          pfCallBack - Pointer to the callback function
  *          param - Parameter to the callback function
  */
 typedef struct tmrTimerTableEntry_tag {
   tmrTimerTicks64_t intervalInTicks;
-  tmrTimerTicks64_t remainingTicks;
+  tmrTimerTicks64_t expireTicks;
+  tmrTimerTicks32_t slackInTicks;
   pfTmrCallBack_t pfCallBack;
   void *param;
-  tmrTimerTicks16_t timestamp; /* all HW counters are 16-bit wide */
 } tmrTimerTableEntry_t;
 
 #endif /* #ifndef __TIMER_H__ */
@@ -0,0 +1,459 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file TmrTaskBench.c
+* Host benchmark of the timer thread: the cost of a TMR_Task() run as a function of
+* the number of active timers.
+*
+* TimersManager.c is built for bare metal (one TMR_Task() run per call) with 240
+* timers, on a simulated 16-bit stack timer counting at 163840 Hz (the FTM of the
+* KW24 with the 128 prescaler). For each number of active timers, interval timers
+* with random periods of 50 ms to 5 s are started, then the simulated time jumps
+* to each compare value programmed by TMR_Task() and TMR_Task() is run, as on a
+* timer interrupt.
+*
+* The same runs are repeated with the timers started by TMR_StartTimerWithSlack(),
+* each with a random slack of 5 ms to half its period, so that the slack windows
+* of the timers overlap and their expirations can share a wakeup.
+*
+* check: every timer expires at its period, never early. Without slack, late by
+*   at most the 4 ms minimum interval between two runs; with slack, never after
+*   its period + slack (a slack of 5 ms or more is never cut by the 4 ms minimum).
+*   With slack and more than one timer, TMR_GetWakeupCount() grows less than the
+*   number of expirations.
+* bench: the ns per TMR_Task() run at a compare match and per run right after a
+*   match (few or no timer expired, as for the events posted by TMR_StartTimer()),
+*   and the number of expirations per match. With long periods, some matches
+*   only restart the 16-bit countdown.
+*
+* For the before/after comparison, build this file against the table scan
+* TimersManager.c and TimersManagerInternal.h of an earlier revision, copied to a
+* Source directory next to a copy of this file.
+*
+* Build (from this directory):
+*   gcc -O2 -DCPU_MKW24D512VHA5 -DUSE_RTOS=0
+*       -I../../../../../devices/MKW24D5 -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../CMSIS/Include
+*       -I../../../../../boards/frdmkw24/wireless_examples/thread/end_device/freertos
+*       -I../../Common -I../Interface -I../../OSAbstraction/Interface
+*       -I../../Panic/Interface
+*       -o TmrTaskBench TmrTaskBench.c
+* Usage: TmrTaskBench [runs per timer count [seed]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#define gTimestamp_Enabled_d            0
+#define gTMR_PIT_Timestamp_Enabled_d    0
+#define gTmrApplicationTimers_c         40
+#define gTmrStackTimers_c               200
+
+#include "../Source/TimersManager.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultRuns_c         (200000)
+#define mBenchFreqHz_c              (163840)
+#define mBenchMinPeriod_c           (50)        /* ms */
+#define mBenchMaxPeriod_c           (5000)      /* ms */
+#define mBenchMinSlack_c            (5)         /* ms */
+#define mBenchIdleRuns_c            (16)        /* runs timed right after every 16th match */
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* Expirations of a timer */
+typedef struct benchTimer_tag
+{
+    tmrTimerID_t id;
+    uint64_t     periodTicks;
+    uint64_t     slackTicks;
+    uint64_t     lastTicks;
+    uint32_t     count;
+    uint32_t     early;
+    uint32_t     late;
+} benchTimer_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+const uint8_t gUseRtos_c = 0;
+
+static uint32_t mSeed = 0x2545F491;
+static uint32_t mFailures;
+
+/* Simulated stack timer */
+static uint16_t mCounter;
+static uint16_t mCompare;
+static bool_t   mCompareSet;
+static uint64_t mNow;
+
+static benchTimer_t mTimers[gTmrTotalTimers_c];
+static uint32_t mExpirations;
+
+static const uint32_t mTimerCounts[] = {1, 4, 16, 64, 128, 240};
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+osaEventId_t OSA_EventCreate(bool_t autoClear)
+{
+    static uint32_t event;
+
+    (void)autoClear;
+    return &event;
+}
+
+osaStatus_t OSA_EventSet(osaEventId_t eventId, osaEventFlags_t flagsToSet)
+{
+    (void)eventId;
+    (void)flagsToSet;
+    return osaStatus_Success;
+}
+
+osaStatus_t OSA_EventWait(osaEventId_t eventId, osaEventFlags_t flagsToWait, bool_t waitAll, uint32_t millisec,
+                          osaEventFlags_t *pSetFlags)
+{
+    (void)eventId;
+    (void)flagsToWait;
+    (void)waitAll;
+    (void)millisec;
+    *pSetFlags = mTmrDummyEvent_c;
+    return osaStatus_Success;
+}
+
+osaTaskId_t OSA_TaskCreate(osaThreadDef_t *thread_def, osaTaskParam_t task_param)
+{
+    (void)thread_def;
+    (void)task_param;
+    return (osaTaskId_t)1;
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    printf("panic at 0x%08x\n", (unsigned)location);
+    exit(1);
+}
+
+void StackTimer_Init(void (*cb)(void))
+{
+    (void)cb;
+}
+
+void StackTimer_Enable(void)
+{
+}
+
+void StackTimer_Disable(void)
+{
+    mCompareSet = FALSE;
+}
+
+void StackTimer_ClearIntFlag(void)
+{
+}
+
+uint32_t StackTimer_GetInputFrequency(void)
+{
+    return mBenchFreqHz_c;
+}
+
+uint32_t StackTimer_GetCounterValue(void)
+{
+    return mCounter;
+}
+
+void StackTimer_SetOffsetTicks(uint32_t offset)
+{
+    mCompare = (uint16_t)offset;
+    mCompareSet = TRUE;
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    mSeed ^= mSeed << 13;
+    mSeed ^= mSeed >> 17;
+    mSeed ^= mSeed << 5;
+    return mSeed;
+}
+
+static uint64_t BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void BenchExpect(bool_t condition, const char *pWhat)
+{
+    if( !condition )
+    {
+        printf("FAIL: %s\n", pWhat);
+        mFailures++;
+    }
+}
+
+/* Moves the simulated time forward */
+static void BenchAdvance(uint16_t ticks)
+{
+    mCounter += ticks;
+    mNow += ticks;
+}
+
+/* How late a timer may expire */
+static uint64_t BenchMaxDelay(benchTimer_t *pTimer)
+{
+    return pTimer->slackTicks ? pTimer->slackTicks : mTicksFor4ms + 1;
+}
+
+static void BenchCallback(void *param)
+{
+    benchTimer_t *pTimer = (benchTimer_t *)param;
+    uint64_t elapsed = mNow - pTimer->lastTicks;
+
+    if( elapsed < pTimer->periodTicks )
+    {
+        pTimer->early++;
+    }
+    else if( elapsed > pTimer->periodTicks + BenchMaxDelay(pTimer) )
+    {
+        pTimer->late++;
+    }
+
+    pTimer->lastTicks = mNow;
+    pTimer->count++;
+    mExpirations++;
+}
+
+/* Starts the given number of interval timers, with or without slack, and runs
+   the timer thread at each compare match */
+static void BenchRun(uint32_t timers, uint32_t runs, bool_t slack)
+{
+    uint64_t matchTime = 0;
+    uint64_t idleTime = 0;
+    uint64_t start;
+    uint64_t simStart;
+    uint32_t expirations;
+    uint32_t matchExpirations = 0;
+    uint32_t wakeups;
+    uint32_t tmrExpirations;
+    uint32_t idleRuns = 0;
+    uint32_t early = 0;
+    uint32_t late = 0;
+    uint32_t run;
+    uint32_t i;
+    char what[80];
+
+    for( i = 0; i < gTmrTotalTimers_c; i++ )
+    {
+        (void)TMR_StopTimer(mTimers[i].id);
+    }
+
+    for( i = 0; i < timers; i++ )
+    {
+        uint32_t period = mBenchMinPeriod_c + BenchRand() % (mBenchMaxPeriod_c - mBenchMinPeriod_c + 1);
+
+        uint32_t slackMs = 0;
+
+        if( slack )
+        {
+            slackMs = mBenchMinSlack_c + BenchRand() % (period / 2 - mBenchMinSlack_c + 1);
+        }
+
+        mTimers[i].periodTicks = TmrTicksFromMilliseconds(period);
+        mTimers[i].slackTicks = TmrTicksFromMilliseconds(slackMs);
+        mTimers[i].lastTicks = mNow;
+        mTimers[i].count = 0;
+        mTimers[i].early = 0;
+        mTimers[i].late = 0;
+        (void)TMR_StartTimerWithSlack(mTimers[i].id, gTmrIntervalTimer_c, period, slackMs,
+                                      BenchCallback, &mTimers[i]);
+    }
+
+    /* The run for the start events */
+    TMR_Task(NULL);
+
+    simStart = mNow;
+    mExpirations = 0;
+    wakeups = TMR_GetWakeupCount();
+    tmrExpirations = TMR_GetExpirationCount();
+
+    for( run = 0; run < runs; run++ )
+    {
+        if( !mCompareSet )
+        {
+            printf("FAIL: no compare programmed\n");
+            mFailures++;
+            break;
+        }
+
+        /* The compare match */
+        BenchAdvance((uint16_t)(mCompare - mCounter));
+        expirations = mExpirations;
+        start = BenchNow();
+        TMR_Task(NULL);
+        matchTime += BenchNow() - start;
+
+        matchExpirations += mExpirations - expirations;
+
+        /* Runs right after the match, 1 tick apart */
+        if( 0 == (run % mBenchIdleRuns_c) )
+        {
+            start = BenchNow();
+            for( i = 0; i < mBenchIdleRuns_c; i++ )
+            {
+                BenchAdvance(1);
+                TMR_Task(NULL);
+            }
+            idleTime += BenchNow() - start;
+            idleRuns += mBenchIdleRuns_c;
+        }
+    }
+
+    wakeups = TMR_GetWakeupCount() - wakeups;
+    tmrExpirations = TMR_GetExpirationCount() - tmrExpirations;
+
+    for( i = 0; i < timers; i++ )
+    {
+        early += mTimers[i].early;
+        late += mTimers[i].late;
+
+        /* Not expired yet, not overdue either */
+        if( mNow - mTimers[i].lastTicks > mTimers[i].periodTicks + BenchMaxDelay(&mTimers[i]) )
+        {
+            late++;
+        }
+    }
+
+    snprintf(what, sizeof(what), "%u timers%s: no timer expired early", (unsigned)timers, slack ? " with slack" : "");
+    BenchExpect(0 == early, what);
+    snprintf(what, sizeof(what), "%u timers%s: no timer expired late", (unsigned)timers, slack ? " with slack" : "");
+    BenchExpect(0 == late, what);
+    snprintf(what, sizeof(what), "%u timers%s: expirations counted", (unsigned)timers, slack ? " with slack" : "");
+    BenchExpect(tmrExpirations == mExpirations, what);
+
+    if( slack && (timers > 1) )
+    {
+        snprintf(what, sizeof(what), "%u timers with slack: fewer wakeups than expirations", (unsigned)timers);
+        BenchExpect(wakeups < tmrExpirations, what);
+    }
+
+    printf("%3u timers%s: %7.1f ns per run at a compare match, %7.1f ns per run in between, "
+           "%.2f expirations per match, %.2f wakeups per expiration, %.0f s simulated\n",
+           (unsigned)timers, slack ? " with slack" : "", (double)matchTime / runs,
+           (double)idleTime / idleRuns, (double)matchExpirations / runs,
+           tmrExpirations ? (double)wakeups / tmrExpirations : 0.0,
+           (double)(mNow - simStart) / mBenchFreqHz_c);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    uint32_t runs = mBenchDefaultRuns_c;
+    uint32_t i;
+
+    if( argc > 1 )
+    {
+        runs = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if( argc > 2 )
+    {
+        mSeed = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+
+    if( (0 == runs) || (0 == mSeed) )
+    {
+        printf("Usage: %s [runs per timer count [seed, not 0]]\n", argv[0]);
+        return 1;
+    }
+
+    TMR_Init();
+
+    for( i = 0; i < gTmrTotalTimers_c; i++ )
+    {
+        mTimers[i].id = TMR_AllocateTimer();
+        BenchExpect(gTmrInvalidTimerID_c != mTimers[i].id, "timer allocated");
+    }
+
+    for( i = 0; i < NumberOfElements(mTimerCounts); i++ )
+    {
+        BenchRun(mTimerCounts[i], runs, FALSE);
+    }
+
+    for( i = 0; i < NumberOfElements(mTimerCounts); i++ )
+    {
+        BenchRun(mTimerCounts[i], runs, TRUE);
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
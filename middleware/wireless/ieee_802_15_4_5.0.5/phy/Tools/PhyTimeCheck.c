@@ -0,0 +1,832 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file PhyTimeCheck.c
+* Host test of the PHY time events (PhyTime.c) against a simulated MCR20A event
+* timer: the 24-bit symbol counter, the T1CMP comparator and the TMR1 interrupt.
+*
+* PhyTime.c is built for bare metal with PhyTime_TimerInit(NULL), as the PHY does,
+* so the expired events run from the simulated PHY ISR. The ISR acknowledges the
+* TMR1 IRQ and masks it (reduced SPI access) or disables the comparator, as
+* PhyISR.c does, then calls PhyTime_ISR(). It runs as soon as the TMR1 IRQ is
+* pending and neither OSA_InterruptDisable() nor ProtectFromMCR20Interrupt() hold
+* it off. Every SPI transfer may take one symbol, so the counter also moves, and
+* wraps, inside the critical sections.
+*
+* The traffic is random: events scheduled from now to 2^20 symbols ahead, some too
+* close to be programmed and some next to a counter wrap, cancelled by id or by
+* parameter, and time moved to the next compare match or further. The expired
+* events schedule and cancel events too.
+*
+* check: every event expires once, in timestamp order, at most
+*   gPhyTimeMinSetupTime_c symbols early (too close to be programmed) and at most
+*   mCheckMaxLate_c symbols late. Between two operations: PhyTime_GetTimestamp()
+*   is the simulated 64-bit time, the TMR1 compare is armed to match no later than
+*   the earliest event, the slots match the scheduled events, the transceiver may
+*   sleep only with no event scheduled and, for the indexed heap, the heap, the
+*   free slots, the parameter index and the armed T1CMP value are consistent.
+* SPI: the TMR1 (IRQSTS3, PHY_CTRL3, T1CMP) transfers and the clock reads per
+*   operation.
+*
+* Run it for both SPI access modes (-DgPhyUseReducedSpiAccess_d=0 or 1) and with
+* more event slots (-DgMaxPhyTimers_c=16).
+*
+* Build (from this directory):
+*   gcc -O2 -DCPU_MKW24D512VHA5 -DUSE_RTOS=0
+*       -I../../../../../devices/MKW24D5 -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../CMSIS/Include
+*       -I../../../../../boards/frdmkw24/wireless_examples/thread/end_device/freertos
+*       -I../interface -I../source/MCR20A -I../source/MCR20A/MCR20Drv
+*       -I../../../framework_5.0.5/Common -I../../../framework_5.0.5/FunctionLib
+*       -I../../../framework_5.0.5/GPIO -I../../../framework_5.0.5/Lists
+*       -I../../../framework_5.0.5/MemManager/Interface
+*       -I../../../framework_5.0.5/Messaging/Interface
+*       -I../../../framework_5.0.5/OSAbstraction/Interface
+*       -o PhyTimeCheck PhyTimeCheck.c
+* Usage: PhyTimeCheck [operations [seed]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../source/MCR20A/PhyTime.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mCheckDefaultOps_c          (200000)
+#define mCheckWrap_c                ((uint64_t)1 << gPhyTimeShift_c)
+#define mCheckMask_c                ((uint32_t)(mCheckWrap_c - 1))
+#define mCheckMaxLate_c             (32)        /* symbols */
+#define mCheckMaxDepth_c            (2)         /* nested callbacks that schedule or cancel */
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* A scheduled event, by timer id */
+typedef struct checkEvent_tag
+{
+    uint64_t timestamp;
+    uint32_t parameter;
+    bool_t   pending;
+} checkEvent_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+uint8_t mStatusAndControlRegs[9];
+
+static uint32_t mSeed = 0x2545F491;
+static uint32_t mJitterSeed = 0x9E3779B9;
+static uint32_t mFailures;
+
+/* Simulated transceiver */
+static uint64_t mNow;
+static uint32_t mT1Cmp;
+static uint8_t  mIrqSts3 = cIRQSTS3_TMR4MSK | cIRQSTS3_TMR3MSK | cIRQSTS3_TMR2MSK | cIRQSTS3_TMR1MSK;
+static uint8_t  mPhyCtrl3 = cPHY_CTRL3_TMR1CMP_EN;
+static uint8_t  mRegs[0x40];
+static bool_t   mJitter = TRUE;
+static uint32_t mOsaDisableCnt;
+static uint32_t mXcvrIrqDisableCnt;
+static bool_t   mInIsr;
+static bool_t   mSleepAllowed = TRUE;
+
+/* Scheduled events, and the one in PhyTime_ScheduleEvent() */
+static checkEvent_t  mEvents[gMaxPhyTimers_c];
+static checkEvent_t *mpScheduling;
+static uint32_t      mDepth;
+
+/* Statistics */
+static uint32_t mScheduled;
+static uint32_t mCancelled;
+static uint32_t mExpired;
+static uint32_t mTooClose;
+static uint32_t mIsrs;
+static uint32_t mSpiTmr1;
+static uint32_t mSpiClock;
+static uint64_t mMaxLate;
+static uint64_t mMaxEarly;
+
+/* Parameters sharing hash buckets */
+static const uint32_t mParams[] = {0x00000000, 0x00000001, 0x00000100, 0x01000000,
+                                   0x00000002, 0x00000003, 0xA5A5A5A5};
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+********************************************************************************** */
+static void CheckSpiTransfer(void);
+static void CheckPoll(void);
+static void CheckEventCB(uint32_t param);
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+void OSA_InterruptDisable(void)
+{
+    mOsaDisableCnt++;
+}
+
+void OSA_InterruptEnable(void)
+{
+    if( mOsaDisableCnt )
+    {
+        mOsaDisableCnt--;
+    }
+    CheckPoll();
+}
+
+void MCR20Drv_IRQ_Disable(void)
+{
+    mXcvrIrqDisableCnt++;
+}
+
+void MCR20Drv_IRQ_Enable(void)
+{
+    if( mXcvrIrqDisableCnt )
+    {
+        mXcvrIrqDisableCnt--;
+    }
+    CheckPoll();
+}
+
+void PWR_AllowXcvrToSleep(void)
+{
+    mSleepAllowed = TRUE;
+}
+
+void PWR_DisallowXcvrToSleep(void)
+{
+    mSleepAllowed = FALSE;
+}
+
+void FLib_MemSet(void* pData, uint8_t value, uint32_t cBytes)
+{
+    memset(pData, value, cBytes);
+}
+
+/* MCR20A direct register access, after the simulated transceiver */
+void MCR20Drv_DirectAccessSPIWrite(uint8_t address, uint8_t value)
+{
+    CheckSpiTransfer();
+    mSpiTmr1++;
+
+    if( IRQSTS3 == address )
+    {
+        /* IRQ flags are cleared by writing 1 */
+        mIrqSts3 = (uint8_t)((value & 0xF0) | (mIrqSts3 & 0x0F & ~(value & 0x0F)));
+    }
+    else if( PHY_CTRL3 == address )
+    {
+        mPhyCtrl3 = value;
+    }
+    else
+    {
+        mRegs[address & 0x3F] = value;
+    }
+}
+
+void MCR20Drv_DirectAccessSPIMultiByteWrite(uint8_t startAddress, uint8_t *byteArray, uint8_t numOfBytes)
+{
+    CheckSpiTransfer();
+    mSpiTmr1++;
+
+    if( (T1CMP_LSB == startAddress) && (3 == numOfBytes) )
+    {
+        mT1Cmp = (uint32_t)byteArray[0] | ((uint32_t)byteArray[1] << 8) | ((uint32_t)byteArray[2] << 16);
+    }
+}
+
+uint8_t MCR20Drv_DirectAccessSPIRead(uint8_t address)
+{
+    uint8_t value;
+
+    CheckSpiTransfer();
+    mSpiTmr1++;
+
+    if( IRQSTS3 == address )
+    {
+        value = mIrqSts3;
+    }
+    else if( PHY_CTRL3 == address )
+    {
+        value = mPhyCtrl3;
+    }
+    else
+    {
+        value = mRegs[address & 0x3F];
+    }
+
+    return value;
+}
+
+uint8_t MCR20Drv_DirectAccessSPIMultiByteRead(uint8_t startAddress, uint8_t *byteArray, uint8_t numOfBytes)
+{
+    uint32_t counter;
+    uint8_t i;
+
+    CheckSpiTransfer();
+
+    if( EVENT_TMR_LSB == startAddress )
+    {
+        mSpiClock++;
+        counter = (uint32_t)mNow & mCheckMask_c;
+
+        for( i = 0; i < numOfBytes; i++ )
+        {
+            byteArray[i] = (uint8_t)(counter >> (8 * i));
+        }
+    }
+    else
+    {
+        mSpiTmr1++;
+        memset(byteArray, 0, numOfBytes);
+    }
+
+    return 0;
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t CheckRand(void)
+{
+    mSeed ^= mSeed << 13;
+    mSeed ^= mSeed >> 17;
+    mSeed ^= mSeed << 5;
+    return mSeed;
+}
+
+static void CheckExpect(bool_t condition, const char *pWhat)
+{
+    if( !condition )
+    {
+        /* Report the first ones only, a broken heap fails on every operation */
+        if( mFailures < 20 )
+        {
+            printf("FAIL at %llu: %s\n", (unsigned long long)mNow, pWhat);
+        }
+        mFailures++;
+    }
+}
+
+/* Symbols until the counter matches T1CMP */
+static uint64_t CheckToMatch(void)
+{
+    uint64_t ticks = (mT1Cmp - (uint32_t)mNow) & mCheckMask_c;
+
+    return ticks ? ticks : mCheckWrap_c;
+}
+
+/* Moves the simulated time forward. A match sets the TMR1 IRQ flag */
+static void CheckAdvance(uint64_t ticks)
+{
+    uint64_t toMatch;
+
+    while( ticks )
+    {
+        toMatch = CheckToMatch();
+
+        if( toMatch <= ticks )
+        {
+            mNow += toMatch;
+            ticks -= toMatch;
+
+            if( mPhyCtrl3 & cPHY_CTRL3_TMR1CMP_EN )
+            {
+                mIrqSts3 |= cIRQSTS3_TMR1IRQ;
+            }
+        }
+        else
+        {
+            mNow += ticks;
+            ticks = 0;
+        }
+    }
+}
+
+/* An SPI transfer may take a symbol */
+static void CheckSpiTransfer(void)
+{
+    if( mJitter )
+    {
+        mJitterSeed ^= mJitterSeed << 13;
+        mJitterSeed ^= mJitterSeed >> 17;
+        mJitterSeed ^= mJitterSeed << 5;
+
+        if( 0 == (mJitterSeed & 3) )
+        {
+            CheckAdvance(1);
+        }
+    }
+}
+
+/* Runs the PHY ISR while the TMR1 IRQ is pending and not held off */
+static void CheckPoll(void)
+{
+    while( !mInIsr && !mOsaDisableCnt && !mXcvrIrqDisableCnt &&
+           (mIrqSts3 & cIRQSTS3_TMR1IRQ) && !(mIrqSts3 & cIRQSTS3_TMR1MSK) )
+    {
+        mInIsr = TRUE;
+        mIsrs++;
+
+        mIrqSts3 &= (uint8_t)~cIRQSTS3_TMR1IRQ;
+#if gPhyUseReducedSpiAccess_d
+        mIrqSts3 |= cIRQSTS3_TMR1MSK;
+#else
+        mPhyCtrl3 &= (uint8_t)~cPHY_CTRL3_TMR1CMP_EN;
+#endif
+        PhyTime_ISR();
+
+        mInIsr = FALSE;
+    }
+}
+
+/* Moves the simulated time to the target, running the PHY ISR at every match */
+static void CheckRunUntil(uint64_t target)
+{
+    uint64_t toMatch;
+
+    while( mNow < target )
+    {
+        toMatch = CheckToMatch();
+
+        if( mNow + toMatch <= target )
+        {
+            CheckAdvance(toMatch);
+            CheckPoll();
+        }
+        else
+        {
+            CheckAdvance(target - mNow);
+        }
+    }
+}
+
+static uint32_t CheckPendingCount(void)
+{
+    uint32_t count = 0;
+    uint32_t i;
+
+    for( i = 1; i < gMaxPhyTimers_c; i++ )
+    {
+        count += mEvents[i].pending ? 1 : 0;
+    }
+
+    return count;
+}
+
+/* Earliest scheduled event */
+static uint64_t CheckEarliest(void)
+{
+    uint64_t earliest = UINT64_MAX;
+    uint32_t i;
+
+    for( i = 1; i < gMaxPhyTimers_c; i++ )
+    {
+        if( mEvents[i].pending && (mEvents[i].timestamp < earliest) )
+        {
+            earliest = mEvents[i].timestamp;
+        }
+    }
+
+    return earliest;
+}
+
+static void CheckSchedule(void)
+{
+    phyTimeEvent_t event;
+    checkEvent_t scheduling;
+    phyTimeTimerId_t id;
+    uint32_t used = CheckPendingCount();
+    uint32_t r = CheckRand() % 100;
+    uint64_t delay;
+
+    if( r < 20 )
+    {
+        /* Maybe too close to be programmed */
+        delay = CheckRand() % (2 * gPhyTimeMinSetupTime_c + 8);
+    }
+    else if( r < 70 )
+    {
+        delay = CheckRand() % 4000;
+    }
+    else if( r < 90 )
+    {
+        delay = CheckRand() % (1 << 20);
+    }
+    else
+    {
+        /* Next to a counter wrap */
+        delay = ((mNow | mCheckMask_c) + 1 - mNow) + (CheckRand() % 64);
+        delay = (delay > 32) ? delay - 32 : 0;
+    }
+
+    event.timestamp = mNow + delay;
+    event.parameter = mParams[CheckRand() % NumberOfElements(mParams)];
+    event.callback = CheckEventCB;
+
+    scheduling.timestamp = event.timestamp;
+    scheduling.parameter = event.parameter;
+    scheduling.pending = TRUE;
+
+    mpScheduling = &scheduling;
+    id = PhyTime_ScheduleEvent(&event);
+    mpScheduling = NULL;
+
+    if( used == gMaxPhyTimers_c - 1 )
+    {
+        CheckExpect(gInvalidTimerId_c == id, "no free slot");
+    }
+    else if( (id == 0) || (id >= gMaxPhyTimers_c) || mEvents[id].pending )
+    {
+        CheckExpect(FALSE, "event scheduled in a free slot");
+    }
+    else
+    {
+        mScheduled++;
+
+        if( scheduling.pending )
+        {
+            mEvents[id] = scheduling;
+        }
+    }
+}
+
+static void CheckCancel(void)
+{
+    phyTimeTimerId_t id = (phyTimeTimerId_t)(CheckRand() % (gMaxPhyTimers_c + 1));
+    phyTimeStatus_t status;
+
+    if( (id < gMaxPhyTimers_c) && mEvents[id].pending )
+    {
+        mEvents[id].pending = FALSE;
+        mCancelled++;
+        status = PhyTime_CancelEvent(id);
+        CheckExpect(gPhyTimeOk_c == status, "scheduled event cancelled");
+    }
+    else if( 0 == mDepth )
+    {
+        /* The slot 0, a free slot or out of range */
+        status = PhyTime_CancelEvent(id);
+        CheckExpect(gPhyTimeNotFound_c == status, "unscheduled event not found");
+    }
+}
+
+static void CheckCancelWithParam(void)
+{
+    uint32_t param = mParams[CheckRand() % NumberOfElements(mParams)];
+    phyTimeStatus_t status;
+    bool_t found = FALSE;
+    uint32_t i;
+
+    for( i = 1; i < gMaxPhyTimers_c; i++ )
+    {
+        if( mEvents[i].pending && (mEvents[i].parameter == param) )
+        {
+            mEvents[i].pending = FALSE;
+            mCancelled++;
+            found = TRUE;
+        }
+    }
+
+    status = PhyTime_CancelEventsWithParam(param);
+    CheckExpect((found ? gPhyTimeOk_c : gPhyTimeNotFound_c) == status, "events cancelled by parameter");
+}
+
+/* The expired event is the one whose slot was released, or the one being scheduled */
+static void CheckEventCB(uint32_t param)
+{
+    checkEvent_t *pEv = NULL;
+    bool_t single = TRUE;
+    uint32_t i;
+    uint32_t r;
+
+    for( i = 1; i < gMaxPhyTimers_c; i++ )
+    {
+        if( mEvents[i].pending && (NULL == mPhyTimers[i].callback) )
+        {
+            single = single && (NULL == pEv);
+            pEv = &mEvents[i];
+        }
+    }
+
+    if( (NULL == pEv) && (NULL != mpScheduling) && mpScheduling->pending )
+    {
+        pEv = mpScheduling;
+    }
+
+    CheckExpect(single, "one event expired per callback");
+
+    if( NULL == pEv )
+    {
+        CheckExpect(FALSE, "the expired event is scheduled");
+        return;
+    }
+
+    pEv->pending = FALSE;
+    mExpired++;
+
+    CheckExpect(param == pEv->parameter, "event parameter");
+
+    if( pEv->timestamp > mNow )
+    {
+        mTooClose++;
+        if( pEv->timestamp - mNow > mMaxEarly )
+        {
+            mMaxEarly = pEv->timestamp - mNow;
+        }
+        CheckExpect(pEv->timestamp - mNow <= gPhyTimeMinSetupTime_c, "event not expired early");
+    }
+    else
+    {
+        if( mNow - pEv->timestamp > mMaxLate )
+        {
+            mMaxLate = mNow - pEv->timestamp;
+        }
+        CheckExpect(mNow - pEv->timestamp <= mCheckMaxLate_c, "event not expired late");
+    }
+
+    for( i = 1; i < gMaxPhyTimers_c; i++ )
+    {
+        if( mEvents[i].pending && (mEvents[i].timestamp < pEv->timestamp) )
+        {
+            CheckExpect(FALSE, "events expired in timestamp order");
+        }
+    }
+
+    /* The MAC schedules and cancels events from its callbacks. Not while an event is
+       being scheduled, its slot is not known yet */
+    if( (NULL == mpScheduling) && (mDepth < mCheckMaxDepth_c) )
+    {
+        mDepth++;
+        r = CheckRand() % 10;
+
+        if( r < 3 )
+        {
+            CheckSchedule();
+        }
+        else if( r < 4 )
+        {
+            CheckCancel();
+        }
+        else if( r < 5 )
+        {
+            CheckCancelWithParam();
+        }
+        mDepth--;
+    }
+}
+
+#ifdef mPhyTimeOverflowSlot_c
+/* The indexed heap, free slots and parameter index of PhyTime.c */
+static void CheckHeap(uint32_t pending)
+{
+    uint8_t seen[gMaxPhyTimers_c];
+    uint32_t linked = 0;
+    uint32_t pos;
+    uint8_t slot;
+    uint8_t prev;
+    uint32_t b;
+
+    CheckExpect(mPhyTimeHeapSize == pending + 1, "heap size");
+    CheckExpect(mPhyTimeFreeCount == gMaxPhyTimers_c - 1 - pending, "free slot count");
+
+    memset(seen, 0, sizeof(seen));
+    for( pos = 0; pos < mPhyTimeHeapSize; pos++ )
+    {
+        slot = mPhyTimeHeap[pos];
+        CheckExpect(mPhyTimeHeapPos[slot] == pos + 1, "heap position");
+        CheckExpect(NULL != mPhyTimers[slot].callback, "heap slot in use");
+        seen[slot]++;
+
+        if( pos )
+        {
+            CheckExpect(mPhyTimers[mPhyTimeHeap[(pos - 1) >> 1]].timestamp <= mPhyTimers[slot].timestamp,
+                        "heap order");
+        }
+    }
+
+    for( pos = 0; pos < mPhyTimeFreeCount; pos++ )
+    {
+        slot = mPhyTimeFreeSlots[pos];
+        CheckExpect((slot != mPhyTimeOverflowSlot_c) && (0 == mPhyTimeHeapPos[slot]), "free slot not in the heap");
+        seen[slot]++;
+    }
+
+    for( pos = 0; pos < gMaxPhyTimers_c; pos++ )
+    {
+        CheckExpect(1 == seen[pos], "slot in the heap or free");
+    }
+
+    for( b = 0; b < gPhyTimeParamBuckets_c; b++ )
+    {
+        prev = mPhyTimeNoSlot_c;
+        for( slot = mPhyTimeParamHead[b]; (slot != mPhyTimeNoSlot_c) && (linked <= gMaxPhyTimers_c);
+             slot = mPhyTimeParamNext[slot] )
+        {
+            CheckExpect(mPhyTimeHeapPos[slot] != 0, "indexed slot in the heap");
+            CheckExpect(PhyTime_ParamHash(mPhyTimers[slot].parameter) == b, "parameter bucket");
+            CheckExpect(mPhyTimeParamPrev[slot] == prev, "parameter index link");
+            prev = slot;
+            linked++;
+        }
+    }
+    CheckExpect(linked == pending, "every event in the parameter index");
+
+    if( mPhyTimeArmed )
+    {
+        CheckExpect((mPhyTimeArmedTimestamp & mCheckMask_c) == mT1Cmp, "armed timestamp in T1CMP");
+        CheckExpect(mPhyTimeArmedTimestamp > mNow, "armed timestamp ahead");
+    }
+}
+#endif
+
+/* Checks between two operations, with no ISR pending */
+static void CheckIdle(void)
+{
+    uint32_t pending = CheckPendingCount();
+    phyTime_t timestamp;
+    uint64_t earliest;
+    uint32_t i;
+
+    CheckExpect((0 == mOsaDisableCnt) && (0 == mXcvrIrqDisableCnt), "interrupts enabled");
+
+    mJitter = FALSE;
+    timestamp = PhyTime_GetTimestamp();
+    mJitter = TRUE;
+    CheckExpect(timestamp == mNow, "64-bit timestamp");
+
+    for( i = 1; i < gMaxPhyTimers_c; i++ )
+    {
+        CheckExpect(mEvents[i].pending == (NULL != mPhyTimers[i].callback), "slot in use");
+        if( mEvents[i].pending )
+        {
+            CheckExpect(mEvents[i].timestamp == mPhyTimers[i].timestamp, "slot timestamp");
+        }
+    }
+
+    earliest = CheckEarliest();
+    CheckExpect(earliest > mNow, "no event overdue");
+    CheckExpect((mPhyCtrl3 & cPHY_CTRL3_TMR1CMP_EN) && !(mIrqSts3 & cIRQSTS3_TMR1MSK), "TMR1 armed");
+    CheckExpect(mNow + CheckToMatch() <= earliest, "T1CMP matches before the earliest event");
+    CheckExpect(mSleepAllowed == (0 == pending), "sleep allowed with no event");
+
+#ifdef mPhyTimeOverflowSlot_c
+    CheckHeap(pending);
+#endif
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    uint32_t ops = mCheckDefaultOps_c;
+    uint32_t tmr1Start;
+    uint32_t clockStart;
+    uint64_t last = 0;
+    uint32_t op;
+    uint32_t r;
+    uint32_t i;
+
+    if( argc > 1 )
+    {
+        ops = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if( argc > 2 )
+    {
+        mSeed = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+
+    if( (0 == ops) || (0 == mSeed) )
+    {
+        printf("Usage: %s [operations [seed, not 0]]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%s SPI access, %u event slots\n", gPhyUseReducedSpiAccess_d ? "reduced" : "full",
+           (unsigned)gMaxPhyTimers_c);
+
+    /* The event timer is not 0 at init */
+    mNow = CheckRand() & mCheckMask_c;
+    CheckExpect(gPhyTimeOk_c == PhyTime_TimerInit(NULL), "timer init");
+    tmr1Start = mSpiTmr1;
+    clockStart = mSpiClock;
+
+    for( op = 0; op < ops; op++ )
+    {
+        r = CheckRand() % 100;
+
+        if( r < 35 )
+        {
+            CheckSchedule();
+        }
+        else if( r < 45 )
+        {
+            CheckCancel();
+        }
+        else if( r < 50 )
+        {
+            CheckCancelWithParam();
+        }
+        else if( r < 70 )
+        {
+            CheckRunUntil(mNow + CheckRand() % 64);
+        }
+        else if( r < 95 )
+        {
+            CheckRunUntil(mNow + CheckToMatch());
+        }
+        else
+        {
+            CheckRunUntil(mNow + CheckRand() % (1 << 20));
+        }
+
+        CheckPoll();
+        CheckIdle();
+        CheckExpect(mNow >= last, "time moves forward");
+        last = mNow;
+    }
+
+    /* Every event expires, the callbacks schedule no more */
+    mDepth = mCheckMaxDepth_c;
+    for( i = 1; i < gMaxPhyTimers_c; i++ )
+    {
+        if( mEvents[i].pending && (mEvents[i].timestamp > last) )
+        {
+            last = mEvents[i].timestamp;
+        }
+    }
+    CheckRunUntil(last + 1);
+    CheckIdle();
+    CheckExpect(0 == CheckPendingCount(), "no event left");
+
+    printf("%u operations, %llu counter wraps: %u events scheduled, %u cancelled, %u expired "
+           "(%u too close, up to %llu symbols early), up to %llu symbols late, %u TMR1 IRQs\n",
+           (unsigned)ops, (unsigned long long)(mNow >> gPhyTimeShift_c), (unsigned)mScheduled,
+           (unsigned)mCancelled, (unsigned)mExpired, (unsigned)mTooClose,
+           (unsigned long long)mMaxEarly, (unsigned long long)mMaxLate, (unsigned)mIsrs);
+    printf("SPI: %u TMR1 transfers and %u clock reads, %.3f and %.3f per schedule, cancel or expiry\n",
+           (unsigned)(mSpiTmr1 - tmr1Start), (unsigned)(mSpiClock - clockStart),
+           (double)(mSpiTmr1 - tmr1Start) / (mScheduled + mCancelled + mExpired),
+           (double)(mSpiClock - clockStart) / (mScheduled + mCancelled + mExpired));
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
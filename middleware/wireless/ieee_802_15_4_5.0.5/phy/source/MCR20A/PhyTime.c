@@ -52,6 +52,21 @@
 ********************************************************************************** */
 #define gPhyTimeMinSetupTime_c (10) /* [symbols] */
 
+/* Number of hash buckets used to index the events by parameter. Must be a power of 2 */
+#ifndef gPhyTimeParamBuckets_c
+#define gPhyTimeParamBuckets_c (4)
+#endif
+
+/* Slot 0 is reserved for the Overflow callback */
+#define mPhyTimeOverflowSlot_c (0)
+#define mPhyTimeNoSlot_c       (0)
+
+/* The Overflow callback runs every half wrap of the event timer */
+#define mPhyTimeOverflowPeriod_c ((uint64_t)1 << (gPhyTimeShift_c - 1))
+
+#define PhyTime_ParamHash(param) \
+    ((uint8_t)((param) ^ ((param) >> 8) ^ ((param) >> 16) ^ ((param) >> 24)) & (gPhyTimeParamBuckets_c - 1))
+
 
 /*! *********************************************************************************
 *************************************************************************************
@@ -70,7 +85,30 @@ static phyTimeEvent_t  mPhyTimers[gMaxPhyTimers_c];
 static phyTimeEvent_t *pNextEvent;
 volatile phyTime_t     mPhySeqTimeout;
 volatile uint64_t      gPhyTimerOverflow;
-static uint8_t         mPhyActiveTimers;
+
+/* Last timestamp read. The Overflow event reads the event timer twice per wrap,
+   so a lower counter value means one wrap */
+static phyTime_t       mPhyTimeLast;
+
+/* Min-heap of the scheduled slots, ordered by timestamp. mPhyTimeHeapPos[] holds
+   the heap position + 1 of each slot, or 0 if the slot is not scheduled */
+static uint8_t         mPhyTimeHeap[gMaxPhyTimers_c];
+static uint8_t         mPhyTimeHeapPos[gMaxPhyTimers_c];
+static uint8_t         mPhyTimeHeapSize;
+
+/* Stack of the free event slots (slot 0 is never free) */
+static uint8_t         mPhyTimeFreeSlots[gMaxPhyTimers_c];
+static uint8_t         mPhyTimeFreeCount;
+
+/* Events indexed by parameter: doubly linked list of slots per hash bucket */
+static uint8_t         mPhyTimeParamHead[gPhyTimeParamBuckets_c];
+static uint8_t         mPhyTimeParamNext[gMaxPhyTimers_c];
+static uint8_t         mPhyTimeParamPrev[gMaxPhyTimers_c];
+
+/* Timestamp currently programmed into T1CMP, valid while mPhyTimeArmed is TRUE.
+   When FALSE, the TMR1 compare is known to be disabled/masked */
+static phyTime_t       mPhyTimeArmedTimestamp;
+static bool_t          mPhyTimeArmed;
 #if gPhyUseReducedSpiAccess_d
 /* Mirror XCVR control registers */
 extern uint8_t mStatusAndControlRegs[9];
@@ -84,6 +122,12 @@ extern uint8_t mStatusAndControlRegs[9];
 ********************************************************************************** */
 static void PhyTime_OverflowCB( uint32_t param );
 static phyTimeEvent_t* PhyTime_GetNextEvent( void );
+static void PhyTime_HeapSwap( uint8_t i, uint8_t j );
+static void PhyTime_HeapSiftUp( uint8_t pos );
+static void PhyTime_HeapSiftDown( uint8_t pos );
+static void PhyTime_HeapInsert( uint8_t slot );
+static void PhyTime_HeapRemove( uint8_t slot );
+static void PhyTime_ReleaseEvent( uint8_t slot );
 
 
 /*! *********************************************************************************
@@ -557,11 +601,9 @@ void
 ********************************************************************************** */
 void PhyTime_ISR(void)
 {
-    if( pNextEvent->callback == PhyTime_OverflowCB )
-    {
-        gPhyTimerOverflow += (uint64_t)(1 << gPhyTimeShift_c);
-    }
-    
+    /* The TMR1 compare was disabled by the PHY ISR */
+    mPhyTimeArmed = FALSE;
+
     if( gpfPhyTimeNotify )
     {
         gpfPhyTimeNotify();
@@ -582,6 +624,8 @@ void PhyTime_ISR(void)
 phyTimeStatus_t PhyTime_TimerInit( void (*cb)(void) )
 {
     phyTimeStatus_t status = gPhyTimeOk_c;
+    uint8_t i;
+
     if( gpfPhyTimeNotify )
     {
         status = gPhyTimeError_c;
@@ -590,14 +634,27 @@ phyTimeStatus_t PhyTime_TimerInit( void (*cb)(void) )
     {
         gpfPhyTimeNotify = cb;
         gPhyTimerOverflow = 0;
+        mPhyTimeLast = 0;
         FLib_MemSet( mPhyTimers, 0, sizeof(mPhyTimers) );
+        FLib_MemSet( mPhyTimeHeapPos, 0, sizeof(mPhyTimeHeapPos) );
+        FLib_MemSet( mPhyTimeParamHead, mPhyTimeNoSlot_c, sizeof(mPhyTimeParamHead) );
+        mPhyTimeHeapSize = 0;
+
+        /* Lowest slots are allocated first */
+        mPhyTimeFreeCount = 0;
+        for( i = gMaxPhyTimers_c - 1; i > mPhyTimeOverflowSlot_c; i-- )
+        {
+            mPhyTimeFreeSlots[mPhyTimeFreeCount++] = i;
+        }
         
         /* Schedule Overflow Calback */
-        pNextEvent = &mPhyTimers[0];
+        pNextEvent = &mPhyTimers[mPhyTimeOverflowSlot_c];
         pNextEvent->callback = PhyTime_OverflowCB;
-        pNextEvent->timestamp = (uint64_t)(1 << gPhyTimeShift_c);
+        pNextEvent->timestamp = PhyTime_GetTimestamp() + mPhyTimeOverflowPeriod_c;
+        PhyTime_HeapInsert( mPhyTimeOverflowSlot_c );
         PhyTimeSetWaitTimeout( &pNextEvent->timestamp );
-        mPhyActiveTimers = 1;
+        mPhyTimeArmedTimestamp = pNextEvent->timestamp;
+        mPhyTimeArmed = TRUE;
     }
 
     return status;
@@ -615,17 +672,10 @@ phyTime_t PhyTime_GetTimestamp(void)
 
     OSA_InterruptDisable();
     PhyTimeReadClock( &t );
-    t |= gPhyTimerOverflow;
-#if 0
-    /* Check for overflow */
-    if( pNextEvent->callback == PhyTime_OverflowCB )
-    {
-        if( MCR20Drv_DirectAccessSPIRead(IRQSTS3) & cIRQSTS3_TMR1IRQ )
-        {
-            t += (1 << gPhyTimeShift_c);
-        }
-    }
-#endif
+    /* Also right after a wrap, before the Overflow event has run */
+    t = mPhyTimeLast + ((t - mPhyTimeLast) & gPhyTimeMask_c);
+    mPhyTimeLast = t;
+    gPhyTimerOverflow = t & ~((phyTime_t)gPhyTimeMask_c);
     OSA_InterruptEnable();
 
     return t;
@@ -642,6 +692,8 @@ phyTime_t PhyTime_GetTimestamp(void)
 phyTimeTimerId_t PhyTime_ScheduleEvent( phyTimeEvent_t *pEvent )
 {
     phyTimeTimerId_t tmr;
+    uint8_t bucket;
+    bool_t isHead = FALSE;
 
     /* Parameter validation */
     if( NULL == pEvent->callback )
@@ -650,36 +702,42 @@ phyTimeTimerId_t PhyTime_ScheduleEvent( phyTimeEvent_t *pEvent )
     }
     else
     {
-        /* Search for a free slot (slot 0 is reserved for the Overflow calback) */
+        /* Get a free slot (slot 0 is reserved for the Overflow calback) */
         OSA_InterruptDisable();
-        for( tmr=1; tmr<gMaxPhyTimers_c; tmr++ )
+        if( 0 == mPhyTimeFreeCount )
         {
-            if( mPhyTimers[tmr].callback == NULL )
+            tmr = gInvalidTimerId_c;
+        }
+        else
+        {
+            tmr = mPhyTimeFreeSlots[--mPhyTimeFreeCount];
+
+            if( mPhyTimeFreeCount == (gMaxPhyTimers_c - 2) )
             {
-                if( mPhyActiveTimers == 1 )
-                {
-                    PWR_DisallowXcvrToSleep();
-                }
+                PWR_DisallowXcvrToSleep();
+            }
+
+            mPhyTimers[tmr] = *pEvent;
+            PhyTime_HeapInsert( tmr );
 
-                mPhyActiveTimers++;
-                mPhyTimers[tmr] = *pEvent;
-                break;
+            /* Link the event into the parameter index */
+            bucket = PhyTime_ParamHash( pEvent->parameter );
+            mPhyTimeParamPrev[tmr] = mPhyTimeNoSlot_c;
+            mPhyTimeParamNext[tmr] = mPhyTimeParamHead[bucket];
+            if( mPhyTimeParamHead[bucket] != mPhyTimeNoSlot_c )
+            {
+                mPhyTimeParamPrev[mPhyTimeParamHead[bucket]] = tmr;
             }
+            mPhyTimeParamHead[bucket] = tmr;
+
+            isHead = (mPhyTimeHeap[0] == tmr) || (NULL == pNextEvent);
         }
         OSA_InterruptEnable();
         
-        if( tmr >= gMaxPhyTimers_c )
+        /* Program the next event */
+        if( isHead )
         {
-            tmr = gInvalidTimerId_c;
-        }
-        else
-        {
-            /* Program the next event */
-            if((NULL == pNextEvent) ||
-               ((NULL != pNextEvent)  && (mPhyTimers[tmr].timestamp < pNextEvent->timestamp)))
-            {
-                PhyTime_Maintenance();
-            }
+            PhyTime_Maintenance();
         }
     }
     return tmr;
@@ -697,7 +755,7 @@ phyTimeStatus_t PhyTime_CancelEvent( phyTimeTimerId_t timerId )
 {
     phyTimeStatus_t status = gPhyTimeOk_c;
 
-    if( (timerId == 0) || (timerId >= gMaxPhyTimers_c) || (NULL == mPhyTimers[timerId].callback) )
+    if( (timerId == mPhyTimeOverflowSlot_c) || (timerId >= gMaxPhyTimers_c) || (NULL == mPhyTimers[timerId].callback) )
     {
         status = gPhyTimeNotFound_c;
     }
@@ -709,14 +767,7 @@ phyTimeStatus_t PhyTime_CancelEvent( phyTimeTimerId_t timerId )
             pNextEvent = NULL;
         }
         
-        mPhyTimers[timerId].callback = NULL;
-        mPhyActiveTimers--;
-
-        if( mPhyActiveTimers == 1 )
-        {
-            PWR_AllowXcvrToSleep();
-        }
-
+        PhyTime_ReleaseEvent( timerId );
         OSA_InterruptEnable();
     }
 
@@ -733,28 +784,29 @@ phyTimeStatus_t PhyTime_CancelEvent( phyTimeTimerId_t timerId )
 ********************************************************************************** */
 phyTimeStatus_t PhyTime_CancelEventsWithParam ( uint32_t param )
 {
-    uint32_t i;
+    uint8_t slot, next;
     phyTimeStatus_t status = gPhyTimeNotFound_c;
 
     OSA_InterruptDisable();
-    for( i=1; i<gMaxPhyTimers_c; i++ )
+    slot = mPhyTimeParamHead[PhyTime_ParamHash(param)];
+
+    while( slot != mPhyTimeNoSlot_c )
     {
-        if( (NULL != mPhyTimers[i].callback) && (param == mPhyTimers[i].parameter) )
+        next = mPhyTimeParamNext[slot];
+
+        if( param == mPhyTimers[slot].parameter )
         {
             status = gPhyTimeOk_c;
-            mPhyTimers[i].callback = NULL;
-            mPhyActiveTimers--;
 
-            if( pNextEvent == &mPhyTimers[i] )
+            if( pNextEvent == &mPhyTimers[slot] )
             {
                 pNextEvent = NULL;
             }
+
+            PhyTime_ReleaseEvent( slot );
         }
-    }
 
-    if( mPhyActiveTimers == 1 )
-    {
-        PWR_AllowXcvrToSleep();
+        slot = next;
     }
     OSA_InterruptEnable();
 
@@ -776,14 +828,8 @@ void PhyTime_RunCallback( void )
 
         param = pNextEvent->parameter;
         cb = pNextEvent->callback;
-        pNextEvent->callback = NULL;
+        PhyTime_ReleaseEvent( (uint8_t)(pNextEvent - mPhyTimers) );
         pNextEvent = NULL;
-        mPhyActiveTimers--;
-
-        if( mPhyActiveTimers == 1 )
-        {
-            PWR_AllowXcvrToSleep();
-        }
 
         OSA_InterruptEnable();
 
@@ -795,30 +841,19 @@ void PhyTime_RunCallback( void )
 * \brief  Expire events too close to be scheduled.
 *         Program the next event
 *
+* \remarks The TMR1 comparator is left untouched if it is already programmed
+*          for the earliest event.
+*
 ********************************************************************************** */
 void PhyTime_Maintenance( void )
 {
     phyTime_t currentTime;
     phyTimeEvent_t *pEv;
-    uint8_t irqSts3Reg;
-#if !gPhyUseReducedSpiAccess_d
-	uint8_t phyCtrl3Reg;
-#endif
-
-    ProtectFromMCR20Interrupt();
-
-    /* Mask TMR1 IRQ */
-    irqSts3Reg = MCR20Drv_DirectAccessSPIRead(IRQSTS3);
-    irqSts3Reg &= 0xF0;                     /* do not change IRQ status */
-    irqSts3Reg |= cIRQSTS3_TMR1MSK;
-    MCR20Drv_DirectAccessSPIWrite( (uint8_t) IRQSTS3, irqSts3Reg);
+    uint8_t irqSts3Reg = 0;
 #if !gPhyUseReducedSpiAccess_d
-    /* Disable TMR1 comparator */
-    phyCtrl3Reg = MCR20Drv_DirectAccessSPIRead(PHY_CTRL3);
-    phyCtrl3Reg &= ~(cPHY_CTRL3_TMR1CMP_EN);
-    MCR20Drv_DirectAccessSPIWrite( (uint8_t) PHY_CTRL3, phyCtrl3Reg);
+    uint8_t phyCtrl3Reg = 0;
 #endif
-    UnprotectFromMCR20Interrupt();
+    bool_t regsRead = FALSE;
 
     while(1)
     {
@@ -826,35 +861,71 @@ void PhyTime_Maintenance( void )
 
         pEv = PhyTime_GetNextEvent();
 
-        /* Program next event if exists */
-        if( pEv )
+        if( (NULL != pEv) && mPhyTimeArmed && (pEv->timestamp == mPhyTimeArmedTimestamp) )
         {
+            /* T1CMP already holds the timestamp of the next event */
             pNextEvent = pEv;
+            pEv = NULL;
+        }
+        else
+        {
+            if( !regsRead )
+            {
+                regsRead = TRUE;
 
-            /* write compare value */
-            MCR20Drv_DirectAccessSPIMultiByteWrite( (uint8_t) T1CMP_LSB, (uint8_t *) &pEv->timestamp, 3);
+                irqSts3Reg = MCR20Drv_DirectAccessSPIRead(IRQSTS3);
+                irqSts3Reg &= 0xF0;                     /* do not change IRQ status */
+                irqSts3Reg |= cIRQSTS3_TMR1MSK;
 #if !gPhyUseReducedSpiAccess_d
-            /* Enable TMR1 comparator */
-            phyCtrl3Reg |= cPHY_CTRL3_TMR1CMP_EN;   /* enable TMR1 compare */
+                phyCtrl3Reg = MCR20Drv_DirectAccessSPIRead(PHY_CTRL3);
+                phyCtrl3Reg &= ~(cPHY_CTRL3_TMR1CMP_EN);
 #endif
-            /* Enable TMR1 IRQ and clear status */                
-            irqSts3Reg &= ~(cIRQSTS3_TMR1MSK);      /* unmask TMR1 interrupt */
-            irqSts3Reg |= (cIRQSTS3_TMR1IRQ);       /* aknowledge TMR1 IRQ */
+                /* Nothing to disable if the PHY ISR already did it */
+                if( mPhyTimeArmed )
+                {
+                    mPhyTimeArmed = FALSE;
 
-            OSA_InterruptDisable();
-            
-            currentTime = PhyTime_GetTimestamp();
+                    /* Mask TMR1 IRQ */
+                    MCR20Drv_DirectAccessSPIWrite( (uint8_t) IRQSTS3, irqSts3Reg);
+#if !gPhyUseReducedSpiAccess_d
+                    /* Disable TMR1 comparator */
+                    MCR20Drv_DirectAccessSPIWrite( (uint8_t) PHY_CTRL3, phyCtrl3Reg);
+#endif
+                }
+            }
 
-            if( pEv->timestamp > (currentTime + gPhyTimeMinSetupTime_c) )
+            /* Program next event if exists */
+            if( pEv )
             {
+                pNextEvent = pEv;
+
+                /* write compare value */
+                MCR20Drv_DirectAccessSPIMultiByteWrite( (uint8_t) T1CMP_LSB, (uint8_t *) &pEv->timestamp, 3);
 #if !gPhyUseReducedSpiAccess_d
-                MCR20Drv_DirectAccessSPIWrite( PHY_CTRL3, phyCtrl3Reg);
+                /* Enable TMR1 comparator */
+                phyCtrl3Reg |= cPHY_CTRL3_TMR1CMP_EN;   /* enable TMR1 compare */
 #endif
-                MCR20Drv_DirectAccessSPIWrite( IRQSTS3, irqSts3Reg );
-                pEv = NULL;
-            }
+                /* Enable TMR1 IRQ and clear status */                
+                irqSts3Reg &= ~(cIRQSTS3_TMR1MSK);      /* unmask TMR1 interrupt */
+                irqSts3Reg |= (cIRQSTS3_TMR1IRQ);       /* aknowledge TMR1 IRQ */
+
+                OSA_InterruptDisable();
+                
+                currentTime = PhyTime_GetTimestamp();
 
-            OSA_InterruptEnable();
+                if( pEv->timestamp > (currentTime + gPhyTimeMinSetupTime_c) )
+                {
+#if !gPhyUseReducedSpiAccess_d
+                    MCR20Drv_DirectAccessSPIWrite( PHY_CTRL3, phyCtrl3Reg);
+#endif
+                    MCR20Drv_DirectAccessSPIWrite( IRQSTS3, irqSts3Reg );
+                    mPhyTimeArmedTimestamp = pEv->timestamp;
+                    mPhyTimeArmed = TRUE;
+                    pEv = NULL;
+                }
+
+                OSA_InterruptEnable();
+            }
         }
 
         UnprotectFromMCR20Interrupt();
@@ -879,16 +950,17 @@ static void PhyTime_OverflowCB( uint32_t param )
 {
     param = param;
 
-    /* Reprogram the next overflow callback */
+    /* Reprogram the next overflow callback. The event may have expired a few
+       symbols early, when too close to be programmed */
     OSA_InterruptDisable();
-    mPhyActiveTimers++;
-    mPhyTimers[0].callback = PhyTime_OverflowCB;
-    mPhyTimers[0].timestamp = gPhyTimerOverflow + (1 << gPhyTimeShift_c);
+    mPhyTimers[mPhyTimeOverflowSlot_c].callback = PhyTime_OverflowCB;
+    mPhyTimers[mPhyTimeOverflowSlot_c].timestamp += mPhyTimeOverflowPeriod_c;
+    PhyTime_HeapInsert( mPhyTimeOverflowSlot_c );
     OSA_InterruptEnable();
 }
 
 /*! *********************************************************************************
-* \brief  Search for the next event to be scheduled
+* \brief  Return the next event to be scheduled
 *
 * \return phyTimeEvent_t pointer to the next event to be scheduled
 *
@@ -896,27 +968,164 @@ static void PhyTime_OverflowCB( uint32_t param )
 static phyTimeEvent_t* PhyTime_GetNextEvent( void )
 {
     phyTimeEvent_t *pEv = NULL;
-    uint32_t i;
 
-    /* Search for the next event to be serviced */
-    for( i=0; i<gMaxPhyTimers_c; i++ )
+    if( mPhyTimeHeapSize )
+    {
+        pEv = &mPhyTimers[mPhyTimeHeap[0]];
+    }
+
+    return pEv;
+}
+
+/*! *********************************************************************************
+* \brief  Exchange two entries of the event heap
+*
+* \param[in]  i  heap position
+* \param[in]  j  heap position
+*
+********************************************************************************** */
+static void PhyTime_HeapSwap( uint8_t i, uint8_t j )
+{
+    uint8_t slot = mPhyTimeHeap[i];
+
+    mPhyTimeHeap[i] = mPhyTimeHeap[j];
+    mPhyTimeHeap[j] = slot;
+    mPhyTimeHeapPos[mPhyTimeHeap[i]] = i + 1;
+    mPhyTimeHeapPos[mPhyTimeHeap[j]] = j + 1;
+}
+
+/*! *********************************************************************************
+* \brief  Move an entry towards the root of the event heap
+*
+* \param[in]  pos  heap position
+*
+********************************************************************************** */
+static void PhyTime_HeapSiftUp( uint8_t pos )
+{
+    uint8_t parent;
+
+    while( pos > 0 )
     {
-        if( NULL != mPhyTimers[i].callback )
+        parent = (pos - 1) >> 1;
+
+        if( mPhyTimers[mPhyTimeHeap[pos]].timestamp >= mPhyTimers[mPhyTimeHeap[parent]].timestamp )
         {
-            if( NULL == pEv )
-            {
-                pEv = &mPhyTimers[i];
-            }
-            /* Check which event expires first */
-            else
-            {
-                if( mPhyTimers[i].timestamp < pEv->timestamp )
-                {
-                    pEv = &mPhyTimers[i];
-                }
-            }
+            break;
         }
+
+        PhyTime_HeapSwap( pos, parent );
+        pos = parent;
     }
+}
 
-    return pEv;
+/*! *********************************************************************************
+* \brief  Move an entry towards the leaves of the event heap
+*
+* \param[in]  pos  heap position
+*
+********************************************************************************** */
+static void PhyTime_HeapSiftDown( uint8_t pos )
+{
+    uint8_t child;
+
+    while( (child = (pos << 1) + 1) < mPhyTimeHeapSize )
+    {
+        if( (child + 1 < mPhyTimeHeapSize) &&
+            (mPhyTimers[mPhyTimeHeap[child + 1]].timestamp < mPhyTimers[mPhyTimeHeap[child]].timestamp) )
+        {
+            child++;
+        }
+
+        if( mPhyTimers[mPhyTimeHeap[child]].timestamp >= mPhyTimers[mPhyTimeHeap[pos]].timestamp )
+        {
+            break;
+        }
+
+        PhyTime_HeapSwap( pos, child );
+        pos = child;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Add an event slot to the heap. Interrupts must be disabled.
+*
+* \param[in]  slot  event slot
+*
+********************************************************************************** */
+static void PhyTime_HeapInsert( uint8_t slot )
+{
+    uint8_t pos = mPhyTimeHeapSize++;
+
+    mPhyTimeHeap[pos] = slot;
+    mPhyTimeHeapPos[slot] = pos + 1;
+    PhyTime_HeapSiftUp( pos );
+}
+
+/*! *********************************************************************************
+* \brief  Remove an event slot from the heap. Interrupts must be disabled.
+*
+* \param[in]  slot  event slot
+*
+********************************************************************************** */
+static void PhyTime_HeapRemove( uint8_t slot )
+{
+    uint8_t pos, last;
+
+    if( mPhyTimeHeapPos[slot] )
+    {
+        pos = mPhyTimeHeapPos[slot] - 1;
+        last = --mPhyTimeHeapSize;
+        mPhyTimeHeapPos[slot] = 0;
+
+        if( pos != last )
+        {
+            mPhyTimeHeap[pos] = mPhyTimeHeap[last];
+            mPhyTimeHeapPos[mPhyTimeHeap[pos]] = pos + 1;
+            PhyTime_HeapSiftDown( pos );
+            PhyTime_HeapSiftUp( pos );
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Unschedule an event and free its slot. Interrupts must be disabled.
+*
+* \param[in]  slot  event slot
+*
+********************************************************************************** */
+static void PhyTime_ReleaseEvent( uint8_t slot )
+{
+    uint8_t prev, next;
+
+    PhyTime_HeapRemove( slot );
+    mPhyTimers[slot].callback = NULL;
+
+    if( slot != mPhyTimeOverflowSlot_c )
+    {
+        /* Unlink the event from the parameter index */
+        prev = mPhyTimeParamPrev[slot];
+        next = mPhyTimeParamNext[slot];
+
+        if( prev != mPhyTimeNoSlot_c )
+        {
+            mPhyTimeParamNext[prev] = next;
+        }
+        else
+        {
+            mPhyTimeParamHead[PhyTime_ParamHash(mPhyTimers[slot].parameter)] = next;
+        }
+
+        if( next != mPhyTimeNoSlot_c )
+        {
+            mPhyTimeParamPrev[next] = prev;
+        }
+
+        mPhyTimeFreeSlots[mPhyTimeFreeCount++] = slot;
+
+        /* Only the Overflow callback remains */
+        if( mPhyTimeFreeCount == (gMaxPhyTimers_c - 1) )
+        {
+            PWR_AllowXcvrToSleep();
+        }
+    }
 }
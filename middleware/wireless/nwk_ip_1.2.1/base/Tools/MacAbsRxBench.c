@@ -0,0 +1,678 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file MacAbsRxBench.c
+* Host test and benchmark of the MAC abstraction MCPS data indication path
+* (MCPS_NWK_SapHandlerCB() to SLWP_McpsDataIndCB()) and of the Memory Manager
+* shared blocks it relies on.
+*
+* mac_abs_802154.c and MemManager.c are built with the Thread pool layout of
+* app_framework_config.h. The MAC is stubbed: every received frame is a message
+* allocated from the MAC pool (gMacPoolId_d of app_mac_config.h, ThrPoolId_d)
+* holding the mcpsToNwkMessage_t, the MHR and the MSDU, with pMsdu pointing after
+* the MHR. The stand-in 6LoWPAN checks every indication, holds up to a given number
+* of them (the frames waiting in the IP task queue or in a reassembly) and frees
+* the indication and the MSDU as the 6LoWPAN library does, with two
+* MEM_BufferFree() calls in alternating order.
+*
+* check: double frees of the indication and of the MSDU sub-buffer are rejected
+*   in either order, and the block returns to its pool only when both are freed.
+*   Every run must end with no buffer allocated and no shared block in use.
+* bench: for 0, 1, 4 and 8 held frames, the frames per second, the frames
+*   dropped for lack of memory, and the pool blocks in use, peak and mean.
+*
+* Compare a build with the default gMemSharedBlocks_c (the MSDU handed over in
+* place) to a -DgMemSharedBlocks_c=0 build (a separate indication buffer and the
+* MSDU moved to the start of the MAC block). The in place path needs
+* sizeof(macAbsMcpsDataInd_t) + MEM_SubBufferOverhead_c bytes in front of the
+* MSDU. With the host structure sizes a 27 byte MHR (extended addresses and an
+* auxiliary security header with key ID mode 1) is not enough: by default the MHR
+* is the smallest one giving this headroom, and at least 27 bytes. The tool
+* prints the sizes used.
+*
+* Build (from this directory; -no-pie keeps the static memory below 4 GB for the
+* 32-bit pointer casts of MemManager.c):
+*   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*       -DCPU_MKW24D512VHA5 -DUSE_RTOS=0 -DTHREAD_ED_CONFIG=1
+*       -I../../../../../boards/frdmkw24/wireless_examples/thread/end_device/freertos
+*       -I../../../../../devices/MKW24D5 -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../CMSIS/Include -I../interface -I../../core/interface
+*       -I../../core/interface/modules -I../../core/interface/thread
+*       -I../../examples/common -I../../../framework_5.0.5/Common
+*       -I../../../framework_5.0.5/FunctionLib -I../../../framework_5.0.5/LED/Interface
+*       -I../../../framework_5.0.5/Lists -I../../../framework_5.0.5/MemManager/Interface
+*       -I../../../framework_5.0.5/Messaging/Interface
+*       -I../../../framework_5.0.5/NVM/Interface
+*       -I../../../framework_5.0.5/OSAbstraction/Interface
+*       -I../../../framework_5.0.5/Panic/Interface
+*       -I../../../framework_5.0.5/TimersManager/Interface
+*       -I../../../ieee_802_15_4_5.0.5/mac/interface
+*       -I../../../ieee_802_15_4_5.0.5/phy/interface
+*       -I../../../ieee_802_15_4_5.0.5/phy/source/MCR20A
+*       -o MacAbsRxBench MacAbsRxBench.c ../../../framework_5.0.5/FunctionLib/FunctionLib.c
+*       ../../../framework_5.0.5/Lists/GenericList.c
+*   add -DgMemSharedBlocks_c=0 for the allocate and move path
+* Usage: MacAbsRxBench [frames per run [MHR bytes [seed]]]
+*   an MHR of 0 bytes selects the default
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/* The pools of app_framework_config.h */
+#define AppPoolId_d                     0
+#define ThrPoolId_d                     1
+#define PoolsDetails_c \
+         _block_size_  16      _number_of_blocks_  4   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  68      _number_of_blocks_  4   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  160     _number_of_blocks_  2   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  260     _number_of_blocks_  2   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  16      _number_of_blocks_  34  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  68      _number_of_blocks_  16  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  160     _number_of_blocks_  16  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  260     _number_of_blocks_  8   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  540     _number_of_blocks_  5   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  800     _number_of_blocks_  2   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  1300    _number_of_blocks_  2   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  0       _number_of_blocks_  0   _pool_id_(0xFF)         _eol_
+
+#include "../../../framework_5.0.5/MemManager/Source/MemManager.c"
+#include "../utils/mac_abs_802154.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultFrames_c       (1000000)
+/* Frame control, sequence number, destination PAN ID, extended addresses and the
+   auxiliary security header with key ID mode 1 */
+#define mBenchThreadMhr_c           (27)
+#define mBenchMaxHold_c             (16)
+#define mBenchMinMsdu_c             (10)
+#define mBenchMaxPsdu_c             (127)
+#define mBenchFcs_c                 (2)
+#define mBenchMacPoolId_c           (ThrPoolId_d)   /* gMacPoolId_d of app_mac_config.h */
+#define mBenchMacInstance_c         (0)
+#define mBenchSrcAddr_c             (0x1234)
+#define mBenchDstAddr_c             (0x5678)
+#define mBenchPanId_c               (0xFACE)
+
+#define mBenchPoolCount_c           (NumberOfElements(memPools))
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* A frame handed to the stand-in 6LoWPAN */
+typedef struct benchHeld_tag
+{
+    macAbsMcpsDataInd_t *pInd;
+    uint8_t             *pMsdu;
+} benchHeld_t;
+
+/* Statistics of a run */
+typedef struct benchRun_tag
+{
+    uint32_t frames;
+    uint32_t macDrops;      /* no block for the MAC message */
+    uint32_t indDrops;      /* no indication buffer, SLWP_McpsDataIndCB(NULL) */
+    uint32_t inPlace;       /* MSDU handed over as a sub-buffer */
+    uint64_t blocksSum;     /* blocks in use, summed over the delivered frames */
+    uint64_t bytesSum;      /* block bytes in use, summed over the delivered frames */
+    uint16_t peakBlocks[NumberOfElements(memPools)];
+} benchRun_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+const uint8_t gNwkPoolId = ThrPoolId_d;
+
+static uint32_t mSeed = 0x2545F491;
+static uint32_t mMhrLen;
+static uint32_t mFailures;
+
+static MCPS_NWK_SapHandler_t mMcpsSapHandler;
+static instanceId_t mMacInstanceId;
+
+/* The frame being delivered */
+static uint8_t mExpectDsn;
+static uint8_t mExpectLen;
+static uint32_t mExpectSeed;
+static uint8_t *mExpectMsg;
+static bool_t mDelivered;
+
+/* Stand-in 6LoWPAN queue */
+static benchHeld_t mHeld[mBenchMaxHold_c + 1];
+static uint32_t mHeldHead;
+static uint32_t mHeldCount;
+static uint32_t mHold;
+static uint32_t mFreeOrder;
+static benchRun_t *mRun;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+********************************************************************************** */
+static void BenchRelease(void);
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    printf("panic at 0x%08x\n", (unsigned)location);
+    exit(1);
+}
+
+instanceId_t BindToMAC(instanceId_t nwkId)
+{
+    return mBenchMacInstance_c;
+}
+
+void Mac_RegisterSapHandlers(MCPS_NWK_SapHandler_t pMCPS_NWK_SapHandler,
+                             MLME_NWK_SapHandler_t pMLME_NWK_SapHandler,
+                             instanceId_t macInstanceId)
+{
+    mMcpsSapHandler = pMCPS_NWK_SapHandler;
+}
+
+resultType_t NWK_MCPS_SapHandler(nwkToMcpsMessage_t* pMsg, instanceId_t macInstanceId)
+{
+    MEM_BufferFree(pMsg);
+    return gSuccess_c;
+}
+
+resultType_t NWK_MLME_SapHandler(mlmeMessage_t* pMsg, instanceId_t macInstanceId)
+{
+    return gSuccess_c;
+}
+
+uint16_t Mac_GetMaxMsduLength(mcpsDataReq_t* pParams)
+{
+    return mBenchMaxPsdu_c - mBenchFcs_c - mBenchThreadMhr_c;
+}
+
+uint16_t mlmeGetSizeOfPIB(pibId_t pib)
+{
+    return sizeof(uint64_t);
+}
+
+bool_t MacFiltering_KeepPacket(macAbsAddrModeType_t addressMode, uint64_t address, uint8_t *pLinkIndicator)
+{
+    return TRUE;
+}
+
+void EVM_EventNotify(uint32_t code, void *pEventData, uint16_t dataSize, instanceId_t instanceId)
+{
+}
+
+void Led_MacTxOn(void)
+{
+}
+
+void Led_MacTxOff(void)
+{
+}
+
+void NvSetCriticalSection(void)
+{
+}
+
+void NvClearCriticalSection(void)
+{
+}
+
+uint8_t PhyAddToNeighborTable(uint8_t *pAddr, uint8_t addrMode, uint16_t PanId)
+{
+    return 0;
+}
+
+uint8_t PhyRemoveFromNeighborTable(uint8_t *pAddr, uint8_t addrMode, uint16_t PanId)
+{
+    return 0;
+}
+
+int8_t PhyConvertLQIToRSSI(uint8_t LQI)
+{
+    return -100;
+}
+
+void SLWP_McpsDataCnfCB(macAbsMcpsDataCnf_t * pMcpsDataCnf)
+{
+}
+
+void SLWP_MlmePollIndCB(macAbsMlmePollNotifyInd_t *pMlmePollInd, instanceId_t instanceId)
+{
+}
+
+/* The 6LoWPAN: checks the indication and queues it */
+void SLWP_McpsDataIndCB(macAbsMcpsDataInd_t * pMcpsDataInd, macAbsAddrModeType_t srcAddrMode,
+                        uint64_t *pSrcAddr)
+{
+    uint32_t seed = mExpectSeed;
+    uint32_t i;
+
+    mDelivered = TRUE;
+
+    if(NULL == pMcpsDataInd)
+    {
+        mRun->indDrops++;
+        return;
+    }
+
+    if((pMcpsDataInd->dsn != mExpectDsn) || (pMcpsDataInd->msduLength != mExpectLen) ||
+       (pMcpsDataInd->srcAddr != mBenchSrcAddr_c) || (pMcpsDataInd->dstAddr != mBenchDstAddr_c) ||
+       (pMcpsDataInd->srcAddrMode != gMacAbsAddrModeShortAddress_c) ||
+       (pMcpsDataInd->instanceId != mMacInstanceId) || (pSrcAddr != &pMcpsDataInd->srcAddr) ||
+       (MEM_BufferGetSize(pMcpsDataInd->pMsdu) < pMcpsDataInd->msduLength))
+    {
+        printf("FAIL: indication of frame %u does not match the MAC message\n", (unsigned)mExpectDsn);
+        mFailures++;
+    }
+
+    for(i = 0; i < mExpectLen; i++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        if(pMcpsDataInd->pMsdu[i] != (uint8_t)(seed >> 16))
+        {
+            printf("FAIL: MSDU byte %u of frame %u\n", (unsigned)i, (unsigned)mExpectDsn);
+            mFailures++;
+            break;
+        }
+    }
+
+    if((uint8_t*)pMcpsDataInd == mExpectMsg)
+    {
+        mRun->inPlace++;
+    }
+
+    mHeld[(mHeldHead + mHeldCount) % NumberOfElements(mHeld)].pInd = pMcpsDataInd;
+    mHeld[(mHeldHead + mHeldCount) % NumberOfElements(mHeld)].pMsdu = pMcpsDataInd->pMsdu;
+    mHeldCount++;
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    mSeed ^= mSeed << 13;
+    mSeed ^= mSeed >> 17;
+    mSeed ^= mSeed << 5;
+    return mSeed;
+}
+
+static uint64_t BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void BenchExpect(bool_t condition, const char *pWhat)
+{
+    if(!condition)
+    {
+        printf("FAIL: %s\n", pWhat);
+        mFailures++;
+    }
+}
+
+static uint32_t BenchBlocksInUse(void)
+{
+    uint32_t i;
+    uint32_t count = 0;
+
+    for(i = 0; i < mBenchPoolCount_c; i++)
+    {
+        count += memPools[i].allocatedBlocks;
+    }
+
+    return count;
+}
+
+/* Frees the oldest frame held by the 6LoWPAN */
+static void BenchRelease(void)
+{
+    benchHeld_t *pHeld = &mHeld[mHeldHead];
+    memStatus_t status1;
+    memStatus_t status2;
+
+    if(mFreeOrder++ & 1U)
+    {
+        status1 = MEM_BufferFree(pHeld->pMsdu);
+        status2 = MEM_BufferFree(pHeld->pInd);
+    }
+    else
+    {
+        status1 = MEM_BufferFree(pHeld->pInd);
+        status2 = MEM_BufferFree(pHeld->pMsdu);
+    }
+
+    if((MEM_SUCCESS_c != status1) || (MEM_SUCCESS_c != status2))
+    {
+        printf("FAIL: free of a held frame\n");
+        mFailures++;
+    }
+
+    mHeldHead = (mHeldHead + 1) % NumberOfElements(mHeld);
+    mHeldCount--;
+}
+
+/* The MAC receives a frame and passes it to the NWK SAP. Returns FALSE if the MAC
+   had no block for it. */
+static bool_t BenchReceive(uint8_t dsn)
+{
+    mcpsToNwkMessage_t *pMsg;
+    uint32_t maxMsdu = mBenchMaxPsdu_c - mBenchFcs_c - mMhrLen;
+    uint32_t len = mBenchMinMsdu_c + BenchRand() % (maxMsdu - mBenchMinMsdu_c + 1);
+    uint32_t seed = BenchRand();
+    uint32_t i;
+
+    pMsg = MEM_BufferAllocWithId(sizeof(mcpsToNwkMessage_t) + mMhrLen + len, mBenchMacPoolId_c, NULL);
+
+    if(NULL == pMsg)
+    {
+        return FALSE;
+    }
+
+    pMsg->msgType = gMcpsDataInd_c;
+    pMsg->msgData.dataInd.dstAddr = mBenchDstAddr_c;
+    pMsg->msgData.dataInd.dstPanId = mBenchPanId_c;
+    pMsg->msgData.dataInd.dstAddrMode = gAddrModeShortAddress_c;
+    pMsg->msgData.dataInd.srcAddr = 0xFFFFFFFF00000000ULL | mBenchSrcAddr_c;
+    pMsg->msgData.dataInd.srcPanId = mBenchPanId_c;
+    pMsg->msgData.dataInd.srcAddrMode = gAddrModeShortAddress_c;
+    pMsg->msgData.dataInd.msduLength = (uint8_t)len;
+    pMsg->msgData.dataInd.mpduLinkQuality = 0xC0;
+    pMsg->msgData.dataInd.dsn = dsn;
+    pMsg->msgData.dataInd.timestamp = dsn;
+    pMsg->msgData.dataInd.securityLevel = gMacSecurityNone_c;
+    pMsg->msgData.dataInd.keyIdMode = gKeyIdMode0_c;
+    pMsg->msgData.dataInd.keySource = 0;
+    pMsg->msgData.dataInd.keyIndex = 0;
+    pMsg->msgData.dataInd.pMsdu = (uint8_t*)pMsg + sizeof(mcpsToNwkMessage_t) + mMhrLen;
+
+    mExpectDsn = dsn;
+    mExpectLen = (uint8_t)len;
+    mExpectSeed = seed;
+    mExpectMsg = (uint8_t*)pMsg;
+
+    for(i = 0; i < len; i++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        pMsg->msgData.dataInd.pMsdu[i] = (uint8_t)(seed >> 16);
+    }
+
+    mDelivered = FALSE;
+    mMcpsSapHandler(pMsg, mMacInstanceId);
+
+    if(!mDelivered)
+    {
+        printf("FAIL: frame %u was not indicated\n", (unsigned)dsn);
+        mFailures++;
+    }
+
+    return TRUE;
+}
+
+/* Checks that no buffer is left allocated */
+static void BenchCheckEmpty(const char *pWhen)
+{
+    char what[96];
+
+    snprintf(what, sizeof(what), "no buffer allocated %s", pWhen);
+    BenchExpect(0 == BenchBlocksInUse(), what);
+#if gMemSharedBlocks_c
+    snprintf(what, sizeof(what), "no shared block %s", pWhen);
+    BenchExpect(0 == mMemSharedBlocksCount, what);
+#endif
+}
+
+static void BenchRun(uint32_t hold, uint32_t frames)
+{
+    benchRun_t run;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t f;
+    uint32_t i;
+    uint32_t blocks;
+
+    memset(&run, 0, sizeof(run));
+    mRun = &run;
+    mHold = hold;
+    mHeldHead = 0;
+    mHeldCount = 0;
+
+    start = BenchNow();
+
+    for(f = 0; f < frames; f++)
+    {
+        if(BenchReceive((uint8_t)f))
+        {
+            run.frames++;
+        }
+        else
+        {
+            run.macDrops++;
+        }
+
+        /* Pool usage with the new frame held */
+        blocks = BenchBlocksInUse();
+        run.blocksSum += blocks;
+        for(i = 0; i < mBenchPoolCount_c; i++)
+        {
+            run.bytesSum += (uint32_t)memPools[i].allocatedBlocks * memPools[i].blockSize;
+            if(memPools[i].allocatedBlocks > run.peakBlocks[i])
+            {
+                run.peakBlocks[i] = memPools[i].allocatedBlocks;
+            }
+        }
+
+        while(mHeldCount > mHold)
+        {
+            BenchRelease();
+        }
+    }
+
+    while(mHeldCount)
+    {
+        BenchRelease();
+    }
+
+    elapsed = BenchNow() - start;
+
+    BenchCheckEmpty("after a run");
+
+    printf("%2u held: %10.0f frames/s  %6.1f ns/frame  dropped %u (MAC) %u (indication)  in place %5.1f%%\n",
+           (unsigned)hold, (double)frames * 1e9 / (double)elapsed, (double)elapsed / frames,
+           (unsigned)run.macDrops, (unsigned)run.indDrops, 100.0 * run.inPlace / frames);
+    printf("          blocks in use: mean %.2f (%.0f bytes), peak", (double)run.blocksSum / frames,
+           (double)run.bytesSum / frames);
+    for(i = 0; i < mBenchPoolCount_c; i++)
+    {
+        if(run.peakBlocks[i])
+        {
+            printf(" %u:%ux%u/%u", (unsigned)memPools[i].poolId, (unsigned)run.peakBlocks[i],
+                   (unsigned)memPools[i].blockSize, (unsigned)memPools[i].numBlocks);
+        }
+    }
+    printf("\n");
+
+    mRun = NULL;
+}
+
+#if gMemSharedBlocks_c
+/* Frees the indication and the MSDU of one frame in the given order, twice each */
+static void BenchDoubleFree(bool_t msduFirst)
+{
+    benchRun_t run;
+    pools_t *pPool;
+    benchHeld_t held;
+    uint8_t allocated;
+    void *pFirst;
+    void *pSecond;
+
+    memset(&run, 0, sizeof(run));
+    mRun = &run;
+    mHeldHead = 0;
+    mHeldCount = 0;
+
+    (void)BenchReceive(0);
+    held = mHeld[0];
+    mHeldCount = 0;
+
+    if((1 != run.inPlace) || (held.pMsdu == (uint8_t*)held.pInd))
+    {
+        printf("FAIL: the MSDU was not handed over in place\n");
+        mFailures++;
+        mRun = NULL;
+        return;
+    }
+
+    pPool = (pools_t *)((listHeader_t *)held.pInd - 1)->pParentPool;
+    allocated = pPool->allocatedBlocks;
+    pFirst = msduFirst ? (void*)held.pMsdu : (void*)held.pInd;
+    pSecond = msduFirst ? (void*)held.pInd : (void*)held.pMsdu;
+
+    BenchExpect(MEM_SUCCESS_c == MEM_BufferFree(pFirst), "first free of the first part");
+    BenchExpect(allocated == pPool->allocatedBlocks, "the block is kept while a part is in use");
+    BenchExpect(MEM_FREE_ERROR_c == MEM_BufferFree(pFirst), "second free of the first part rejected");
+    BenchExpect(allocated == pPool->allocatedBlocks, "the block is kept after a rejected free");
+    BenchExpect(MEM_SUCCESS_c == MEM_BufferFree(pSecond), "free of the second part");
+    BenchExpect(allocated - 1 == pPool->allocatedBlocks, "the block returns to its pool");
+    BenchExpect(MEM_FREE_ERROR_c == MEM_BufferFree(pSecond), "second free of the second part rejected");
+    BenchExpect(MEM_FREE_ERROR_c == MEM_BufferFree(pFirst), "third free of the first part rejected");
+    BenchCheckEmpty("after the double frees");
+
+    mRun = NULL;
+}
+#endif
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    static const uint32_t holds[] = {0, 1, 4, 8};
+    uint32_t frames = mBenchDefaultFrames_c;
+    uint32_t inPlaceMhr;
+    absInstanceId_t macInstanceId;
+    uint32_t i;
+
+    if(argc > 1)
+    {
+        frames = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if(argc > 2)
+    {
+        mMhrLen = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    if(argc > 3)
+    {
+        mSeed = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+
+    inPlaceMhr = sizeof(macAbsMcpsDataInd_t) + MEM_SubBufferOverhead_c - sizeof(mcpsToNwkMessage_t);
+    if(0 == mMhrLen)
+    {
+        mMhrLen = (inPlaceMhr > mBenchThreadMhr_c) ? inPlaceMhr : mBenchThreadMhr_c;
+    }
+
+    if((0 == frames) || (mMhrLen + mBenchFcs_c + mBenchMinMsdu_c > mBenchMaxPsdu_c) || (0 == mSeed))
+    {
+        printf("Usage: %s [frames per run [MHR bytes [seed]]]\n", argv[0]);
+        return 1;
+    }
+
+    (void)MEM_Init();
+    if(NULL == MAC_RegisterAbsCb_802154(0, &macInstanceId) || (NULL == mMcpsSapHandler))
+    {
+        printf("FAIL: MAC abstraction registration\n");
+        return 1;
+    }
+    mMacInstanceId = macInstanceId;
+
+    printf("gMemSharedBlocks_c %u, %u frames per run, MHR %u bytes, MSDU at offset %u, in place needs %u (host sizes)\n",
+           (unsigned)gMemSharedBlocks_c, (unsigned)frames, (unsigned)mMhrLen,
+           (unsigned)(sizeof(mcpsToNwkMessage_t) + mMhrLen),
+           (unsigned)(sizeof(macAbsMcpsDataInd_t) + MEM_SubBufferOverhead_c));
+
+#if gMemSharedBlocks_c
+    if(mMhrLen >= inPlaceMhr)
+    {
+        BenchDoubleFree(FALSE);
+        BenchDoubleFree(TRUE);
+    }
+#endif
+
+    for(i = 0; i < NumberOfElements(holds); i++)
+    {
+        BenchRun(holds[i], frames);
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
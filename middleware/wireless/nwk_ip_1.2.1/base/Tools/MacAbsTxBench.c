@@ -0,0 +1,758 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file MacAbsTxBench.c
+* Host test and benchmark of the MAC abstraction MCPS data request paths:
+* MCPS_DataReq (the MSDU copied in a new MAC message) and MCPS_DataReqZeroCopy
+* (the MSDU built GetMcpsDataReqHeadroom() bytes into the caller's buffer, which
+* is handed to the MAC).
+*
+* mac_abs_802154.c and MemManager.c are built with the Thread pool layout of
+* app_framework_config.h. The stand-in MAC (NWK_MCPS_SapHandler) checks every
+* request and either accepts it, keeping the message until it is transmitted, or
+* rejects it with a given status without freeing it, as the MAC does. A transmitted
+* message is freed and confirmed with a new MAC message (MCPS_NWK_SapHandlerCB()).
+* The stand-in 6LoWPAN (SLWP_McpsDataCnfCB) checks every confirm and frees it.
+*
+* check: the ownership of the zero-copy buffer on success, on a request rejected
+*   by the MAC (the buffer is the confirm of SLWP_McpsDataCnfCB) and with no MSDU.
+*   An MSDU that is not GetMcpsDataReqHeadroom() bytes into an allocated buffer
+*   holding it is rejected with gMacAbsInvalidParameter_c, with no confirm, and
+*   the buffer is left to the caller untouched. Every check ends with no buffer
+*   allocated.
+* bench: for several MSDU lengths, the requests per second of both paths and the
+*   pool blocks in use, peak and mean, with a given number of frames queued in the
+*   MAC. Every request is confirmed before the next one when the queue is 0.
+*
+* Build (from this directory; -no-pie keeps the static memory below 4 GB for the
+* 32-bit pointer casts of MemManager.c):
+*   gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*       -DCPU_MKW24D512VHA5 -DUSE_RTOS=0 -DTHREAD_ED_CONFIG=1
+*       -I../../../../../boards/frdmkw24/wireless_examples/thread/end_device/freertos
+*       -I../../../../../devices/MKW24D5 -I../../../../../devices/MKW24D5/drivers
+*       -I../../../../../CMSIS/Include -I../interface -I../../core/interface
+*       -I../../core/interface/modules -I../../core/interface/thread
+*       -I../../examples/common -I../../../framework_5.0.5/Common
+*       -I../../../framework_5.0.5/FunctionLib -I../../../framework_5.0.5/LED/Interface
+*       -I../../../framework_5.0.5/Lists -I../../../framework_5.0.5/MemManager/Interface
+*       -I../../../framework_5.0.5/Messaging/Interface
+*       -I../../../framework_5.0.5/NVM/Interface
+*       -I../../../framework_5.0.5/OSAbstraction/Interface
+*       -I../../../framework_5.0.5/Panic/Interface
+*       -I../../../framework_5.0.5/TimersManager/Interface
+*       -I../../../ieee_802_15_4_5.0.5/mac/interface
+*       -I../../../ieee_802_15_4_5.0.5/phy/interface
+*       -I../../../ieee_802_15_4_5.0.5/phy/source/MCR20A
+*       -o MacAbsTxBench MacAbsTxBench.c ../../../framework_5.0.5/FunctionLib/FunctionLib.c
+*       ../../../framework_5.0.5/Lists/GenericList.c
+* Usage: MacAbsTxBench [requests per run [frames queued in the MAC [seed]]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/* The pools of app_framework_config.h */
+#define AppPoolId_d                     0
+#define ThrPoolId_d                     1
+#define PoolsDetails_c \
+         _block_size_  16      _number_of_blocks_  4   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  68      _number_of_blocks_  4   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  160     _number_of_blocks_  2   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  260     _number_of_blocks_  2   _pool_id_(AppPoolId_d)  _eol_  \
+         _block_size_  16      _number_of_blocks_  34  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  68      _number_of_blocks_  16  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  160     _number_of_blocks_  16  _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  260     _number_of_blocks_  8   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  540     _number_of_blocks_  5   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  800     _number_of_blocks_  2   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  1300    _number_of_blocks_  2   _pool_id_(ThrPoolId_d)  _eol_  \
+         _block_size_  0       _number_of_blocks_  0   _pool_id_(0xFF)         _eol_
+
+#include "../../../framework_5.0.5/MemManager/Source/MemManager.c"
+#include "../utils/mac_abs_802154.c"
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultRequests_c     (1000000)
+#define mBenchMaxQueue_c            (8)
+#define mBenchMaxMsdu_c             (102)
+#define mBenchMacPoolId_c           (ThrPoolId_d)   /* gMacPoolId_d of app_mac_config.h */
+#define mBenchMacInstance_c         (0)
+#define mBenchUpperInstance_c       (0x5A)
+#define mBenchDstAddr_c             (0x5678)
+#define mBenchPanId_c               (0xFACE)
+#define mBenchHeadroomFill_c        (0xA5)
+
+#define mBenchPoolCount_c           (NumberOfElements(memPools))
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+/* Statistics of a run */
+typedef struct benchRun_tag
+{
+    uint64_t blocksSum;     /* blocks in use, summed over the requests */
+    uint64_t bytesSum;      /* block bytes in use, summed over the requests */
+    uint32_t peakBlocks;
+    uint32_t peakBytes;
+} benchRun_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+const uint8_t gNwkPoolId = ThrPoolId_d;
+
+static uint32_t mSeed = 0x2545F491;
+static uint32_t mFailures;
+
+static instanceId_t mMacInstanceId;
+static MCPS_NWK_SapHandler_t mMcpsSapHandler;
+static macAbsRequests_t *mpMacAbs;
+
+/* Stand-in MAC */
+static resultType_t mMacResult = gSuccess_c;
+static nwkToMcpsMessage_t *mMacQueue[mBenchMaxQueue_c + 1];
+static uint32_t mMacQueueHead;
+static uint32_t mMacQueueCount;
+static uint32_t mMacRequests;
+
+/* The request being sent */
+static uint8_t mExpectHandle;
+static uint16_t mExpectLen;
+static uint32_t mExpectSeed;
+static bool_t mCheckMsdu = TRUE;
+
+/* Stand-in 6LoWPAN */
+static uint32_t mConfirms;
+static uint32_t mNullConfirms;
+static void *mLastConfirm;
+static macAbsResultType_t mLastStatus;
+static uint8_t mLastHandle;
+static instanceId_t mLastInstance;
+static bool_t mConfirmAllocated;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Stubs
+*************************************************************************************
+********************************************************************************** */
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+
+void panic(panicId_t id, uint32_t location, uint32_t extra1, uint32_t extra2)
+{
+    printf("panic at 0x%08x\n", (unsigned)location);
+    exit(1);
+}
+
+instanceId_t BindToMAC(instanceId_t nwkId)
+{
+    return mBenchMacInstance_c;
+}
+
+void Mac_RegisterSapHandlers(MCPS_NWK_SapHandler_t pMCPS_NWK_SapHandler,
+                             MLME_NWK_SapHandler_t pMLME_NWK_SapHandler,
+                             instanceId_t macInstanceId)
+{
+    mMcpsSapHandler = pMCPS_NWK_SapHandler;
+}
+
+/* The MAC: checks the request and queues it, or rejects it without freeing it */
+resultType_t NWK_MCPS_SapHandler(nwkToMcpsMessage_t* pMsg, instanceId_t macInstanceId)
+{
+    mcpsDataReq_t *pReq = &pMsg->msgData.dataReq;
+    uint32_t seed = mExpectSeed;
+    uint32_t i;
+
+    mMacRequests++;
+
+    if((gMcpsDataReq_c != pMsg->msgType) || (macInstanceId != mBenchMacInstance_c) ||
+       (pReq->pMsdu != (uint8_t*)pMsg + sizeof(nwkToMcpsMessage_t)) ||
+       (pReq->msduLength != mExpectLen) || (pReq->msduHandle != mExpectHandle) ||
+       (pReq->dstAddr != mBenchDstAddr_c) || (pReq->dstPanId != mBenchPanId_c) ||
+       (pReq->dstAddrMode != gAddrModeShortAddress_c) ||
+       (MEM_BufferGetSize(pMsg) < sizeof(nwkToMcpsMessage_t) + pReq->msduLength))
+    {
+        printf("FAIL: request %u does not match its parameters\n", (unsigned)mExpectHandle);
+        mFailures++;
+    }
+
+    for(i = 0; mCheckMsdu && (i < mExpectLen); i++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        if(pReq->pMsdu[i] != (uint8_t)(seed >> 16))
+        {
+            printf("FAIL: MSDU byte %u of request %u\n", (unsigned)i, (unsigned)mExpectHandle);
+            mFailures++;
+            break;
+        }
+    }
+
+    if(gSuccess_c == mMacResult)
+    {
+        mMacQueue[(mMacQueueHead + mMacQueueCount) % NumberOfElements(mMacQueue)] = pMsg;
+        mMacQueueCount++;
+    }
+
+    return mMacResult;
+}
+
+resultType_t NWK_MLME_SapHandler(mlmeMessage_t* pMsg, instanceId_t macInstanceId)
+{
+    return gSuccess_c;
+}
+
+uint16_t Mac_GetMaxMsduLength(mcpsDataReq_t* pParams)
+{
+    return mBenchMaxMsdu_c;
+}
+
+uint16_t mlmeGetSizeOfPIB(pibId_t pib)
+{
+    return sizeof(uint64_t);
+}
+
+bool_t MacFiltering_KeepPacket(macAbsAddrModeType_t addressMode, uint64_t address, uint8_t *pLinkIndicator)
+{
+    return TRUE;
+}
+
+void EVM_EventNotify(uint32_t code, void *pEventData, uint16_t dataSize, instanceId_t instanceId)
+{
+}
+
+void Led_MacTxOn(void)
+{
+}
+
+void Led_MacTxOff(void)
+{
+}
+
+void NvSetCriticalSection(void)
+{
+}
+
+void NvClearCriticalSection(void)
+{
+}
+
+uint8_t PhyAddToNeighborTable(uint8_t *pAddr, uint8_t addrMode, uint16_t PanId)
+{
+    return 0;
+}
+
+uint8_t PhyRemoveFromNeighborTable(uint8_t *pAddr, uint8_t addrMode, uint16_t PanId)
+{
+    return 0;
+}
+
+int8_t PhyConvertLQIToRSSI(uint8_t LQI)
+{
+    return -100;
+}
+
+void SLWP_McpsDataIndCB(macAbsMcpsDataInd_t * pMcpsDataInd, macAbsAddrModeType_t srcAddrMode,
+                        uint64_t *pSrcAddr)
+{
+    MEM_BufferFree(pMcpsDataInd);
+}
+
+void SLWP_MlmePollIndCB(macAbsMlmePollNotifyInd_t *pMlmePollInd, instanceId_t instanceId)
+{
+}
+
+/* The 6LoWPAN: records the confirm and frees it */
+void SLWP_McpsDataCnfCB(macAbsMcpsDataCnf_t * pMcpsDataCnf)
+{
+    mConfirms++;
+    mLastConfirm = pMcpsDataCnf;
+
+    if(NULL == pMcpsDataCnf)
+    {
+        mNullConfirms++;
+        return;
+    }
+
+    mLastStatus = pMcpsDataCnf->status;
+    mLastHandle = pMcpsDataCnf->msduHandle;
+    mLastInstance = pMcpsDataCnf->instanceId;
+    mConfirmAllocated = MEM_BufferIsAllocated(pMcpsDataCnf);
+
+    if(MEM_SUCCESS_c != MEM_BufferFree(pMcpsDataCnf))
+    {
+        printf("FAIL: free of the confirm of request %u\n", (unsigned)mLastHandle);
+        mFailures++;
+    }
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    mSeed ^= mSeed << 13;
+    mSeed ^= mSeed >> 17;
+    mSeed ^= mSeed << 5;
+    return mSeed;
+}
+
+static uint64_t BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void BenchExpect(bool_t condition, const char *pWhat)
+{
+    if(!condition)
+    {
+        printf("FAIL: %s\n", pWhat);
+        mFailures++;
+    }
+}
+
+static void BenchPoolUsage(uint32_t *pBlocks, uint32_t *pBytes)
+{
+    uint32_t i;
+
+    *pBlocks = 0;
+    *pBytes = 0;
+
+    for(i = 0; i < mBenchPoolCount_c; i++)
+    {
+        *pBlocks += memPools[i].allocatedBlocks;
+        *pBytes += (uint32_t)memPools[i].allocatedBlocks * memPools[i].blockSize;
+    }
+}
+
+static void BenchCheckEmpty(const char *pWhen)
+{
+    uint32_t blocks;
+    uint32_t bytes;
+    char what[96];
+
+    BenchPoolUsage(&blocks, &bytes);
+    snprintf(what, sizeof(what), "no buffer allocated %s", pWhen);
+    BenchExpect(0 == blocks, what);
+}
+
+/* Writes a pseudo-random MSDU and records it as the one the MAC must receive. The
+   bench runs write a constant MSDU, not checked by the MAC. */
+static void BenchFillMsdu(uint8_t *pMsdu, uint16_t len, uint8_t handle)
+{
+    uint32_t seed = BenchRand();
+    uint32_t i;
+
+    mExpectHandle = handle;
+    mExpectLen = len;
+    mExpectSeed = seed;
+
+    if(!mCheckMsdu)
+    {
+        FLib_MemSet(pMsdu, handle, len);
+        return;
+    }
+
+    for(i = 0; i < len; i++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        pMsdu[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+static void BenchFillReq(macAbsMcpsDataReq_t *pReq, uint8_t *pMsdu, uint16_t len, uint8_t handle)
+{
+    memset(pReq, 0, sizeof(macAbsMcpsDataReq_t));
+    pReq->srcAddrMode = gMacAbsAddrModeShortAddress_c;
+    pReq->dstAddrMode = gMacAbsAddrModeShortAddress_c;
+    pReq->dstPANId = mBenchPanId_c;
+    pReq->dstAddr = mBenchDstAddr_c;
+    pReq->msduHandle = handle;
+    pReq->securityLevel = gMacAbsMacSecurityDisabled_c;
+    pReq->keyIdMode = gMacAbsKeyIdMode1_c;
+    pReq->pMsdu = pMsdu;
+    pReq->msduLength = len;
+    pReq->txOptions = gMacAbsMacTxOptionsAck_c;
+}
+
+/* The MAC transmits the oldest queued frame: frees its message and confirms it */
+static void BenchTransmit(void)
+{
+    nwkToMcpsMessage_t *pMsg = mMacQueue[mMacQueueHead];
+    mcpsToNwkMessage_t *pCnf;
+    uint8_t handle = pMsg->msgData.dataReq.msduHandle;
+
+    mMacQueueHead = (mMacQueueHead + 1) % NumberOfElements(mMacQueue);
+    mMacQueueCount--;
+
+    BenchExpect(MEM_SUCCESS_c == MEM_BufferFree(pMsg), "the MAC frees a transmitted frame");
+
+    pCnf = MEM_BufferAllocWithId(sizeof(mcpsToNwkMessage_t), mBenchMacPoolId_c, NULL);
+    if(NULL == pCnf)
+    {
+        printf("FAIL: no block for the confirm of request %u\n", (unsigned)handle);
+        mFailures++;
+        return;
+    }
+
+    pCnf->msgType = gMcpsDataCnf_c;
+    pCnf->msgData.dataCnf.msduHandle = handle;
+    pCnf->msgData.dataCnf.status = gSuccess_c;
+    pCnf->msgData.dataCnf.timestamp = handle;
+    mMcpsSapHandler(pCnf, mMacInstanceId);
+}
+
+/* Allocates a zero-copy buffer as 6LoWPAN would, with the MSDU after the headroom */
+static uint8_t* BenchAllocZeroCopy(uint16_t len, uint8_t handle)
+{
+    uint32_t headroom = mpMacAbs->GetMcpsDataReqHeadroom();
+    uint8_t *pBuffer = MEM_BufferAllocWithId(headroom + len, gNwkPoolId, NULL);
+
+    if(pBuffer)
+    {
+        FLib_MemSet(pBuffer, mBenchHeadroomFill_c, headroom);
+        BenchFillMsdu(pBuffer + headroom, len, handle);
+    }
+
+    return pBuffer;
+}
+
+/* Checks that a rejected zero-copy request left the buffer to the caller untouched */
+static void BenchCheckRejected(uint8_t *pBuffer, macAbsMcpsDataReq_t *pReq, const char *pWhat)
+{
+    uint32_t requests = mMacRequests;
+    uint32_t confirms = mConfirms;
+    uint32_t headroom = mpMacAbs->GetMcpsDataReqHeadroom();
+    uint32_t i;
+    char what[128];
+
+    snprintf(what, sizeof(what), "%s: rejected as an invalid parameter", pWhat);
+    BenchExpect(gMacAbsInvalidParameter_c == mpMacAbs->MCPS_DataReqZeroCopy(pReq, mMacInstanceId,
+                                                                            mBenchUpperInstance_c), what);
+    snprintf(what, sizeof(what), "%s: not sent and not confirmed", pWhat);
+    BenchExpect((requests == mMacRequests) && (confirms == mConfirms), what);
+
+    if(pBuffer)
+    {
+        snprintf(what, sizeof(what), "%s: the buffer is kept by the caller", pWhat);
+        BenchExpect(MEM_BufferIsAllocated(pBuffer), what);
+
+        for(i = 0; i < headroom; i++)
+        {
+            if(pBuffer[i] != mBenchHeadroomFill_c)
+            {
+                printf("FAIL: %s: the headroom was written\n", pWhat);
+                mFailures++;
+                break;
+            }
+        }
+
+        BenchExpect(MEM_SUCCESS_c == MEM_BufferFree(pBuffer), "free of a rejected buffer");
+    }
+}
+
+static void BenchCheck(void)
+{
+    macAbsMcpsDataReq_t req;
+    uint32_t headroom = mpMacAbs->GetMcpsDataReqHeadroom();
+    uint32_t blocks;
+    uint32_t bytes;
+    uint8_t stackBuffer[sizeof(nwkToMcpsMessage_t) + mBenchMaxMsdu_c];
+    uint8_t *pBuffer;
+    uint8_t *pCopy;
+
+    BenchExpect(sizeof(nwkToMcpsMessage_t) == headroom, "the headroom is the MCPS message header");
+
+    /* Accepted: the buffer is the MAC message and is freed by the MAC */
+    pBuffer = BenchAllocZeroCopy(mBenchMaxMsdu_c, 1);
+    BenchFillReq(&req, pBuffer + headroom, mBenchMaxMsdu_c, 1);
+    mMacResult = gSuccess_c;
+    BenchExpect(gMacAbsSuccess_c == mpMacAbs->MCPS_DataReqZeroCopy(&req, mMacInstanceId, mBenchUpperInstance_c),
+                "zero-copy request accepted");
+    BenchExpect((1 == mMacQueueCount) && ((uint8_t*)mMacQueue[mMacQueueHead] == pBuffer),
+                "the zero-copy buffer is the MAC message");
+    BenchPoolUsage(&blocks, &bytes);
+    BenchExpect(1 == blocks, "no block allocated by a zero-copy request");
+    BenchExpect(0 == mConfirms, "no confirm before the transmission");
+    BenchTransmit();
+    BenchExpect((1 == mConfirms) && (gMacAbsSuccess_c == mLastStatus) && (1 == mLastHandle),
+                "confirm of the transmitted frame");
+    BenchCheckEmpty("after a transmitted zero-copy frame");
+
+    /* Rejected by the MAC: the buffer is the confirm and is freed by 6LoWPAN */
+    mConfirms = 0;
+    pBuffer = BenchAllocZeroCopy(20, 2);
+    BenchFillReq(&req, pBuffer + headroom, 20, 2);
+    mMacResult = gTransactionOverflow_c;
+    BenchExpect(gMacAbsTransactionOverflow_c == mpMacAbs->MCPS_DataReqZeroCopy(&req, mMacInstanceId,
+                                                                               mBenchUpperInstance_c),
+                "zero-copy request rejected by the MAC");
+    BenchExpect((1 == mConfirms) && (mLastConfirm == pBuffer), "the rejected buffer is the confirm");
+    BenchExpect(mConfirmAllocated, "the rejected buffer is not freed before the confirm");
+    BenchExpect((gMacAbsTransactionOverflow_c == mLastStatus) && (2 == mLastHandle) &&
+                (mBenchUpperInstance_c == mLastInstance), "confirm of the rejected request");
+    BenchExpect(0 == mMacQueueCount, "the rejected frame is not queued");
+    BenchCheckEmpty("after a rejected zero-copy frame");
+    mMacResult = gSuccess_c;
+
+    /* No MSDU: confirmed with no buffer, as a failed allocation of MCPS_DataReq */
+    mConfirms = 0;
+    BenchFillReq(&req, NULL, 20, 3);
+    (void)mpMacAbs->MCPS_DataReqZeroCopy(&req, mMacInstanceId, mBenchUpperInstance_c);
+    BenchExpect((1 == mConfirms) && (NULL == mLastConfirm), "a request with no MSDU is confirmed with NULL");
+    BenchCheckEmpty("after a request with no MSDU");
+
+    /* Not at the headroom offset of an allocated buffer */
+    pBuffer = BenchAllocZeroCopy(20, 4);
+    BenchFillReq(&req, pBuffer + headroom + 1, 19, 4);
+    BenchCheckRejected(pBuffer, &req, "MSDU after the headroom");
+
+    pBuffer = BenchAllocZeroCopy(20, 5);
+    BenchFillReq(&req, pBuffer + headroom - 4, 20, 5);
+    BenchCheckRejected(pBuffer, &req, "MSDU inside the headroom");
+
+    pBuffer = BenchAllocZeroCopy(20, 6);
+    BenchFillReq(&req, pBuffer + headroom, (uint16_t)(MEM_BufferGetSize(pBuffer) - headroom + 1), 6);
+    BenchCheckRejected(pBuffer, &req, "MSDU longer than the buffer");
+
+    BenchFillReq(&req, stackBuffer + sizeof(nwkToMcpsMessage_t), 20, 7);
+    BenchCheckRejected(NULL, &req, "MSDU outside the memory manager");
+
+    pBuffer = BenchAllocZeroCopy(20, 8);
+    (void)MEM_BufferFree(pBuffer);
+    BenchFillReq(&req, pBuffer + headroom, 20, 8);
+    BenchCheckRejected(NULL, &req, "MSDU in a freed buffer");
+    BenchCheckEmpty("after the rejected requests");
+
+#if gMemSharedBlocks_c
+    pBuffer = BenchAllocZeroCopy(200, 9);
+    pCopy = MEM_BufferCreateSubBuffer(pBuffer, 64);
+    BenchExpect(NULL != pCopy, "sub-buffer created");
+    BenchFillReq(&req, pCopy + headroom, 20, 9);
+    BenchCheckRejected(NULL, &req, "MSDU in a sub-buffer");
+    BenchExpect(MEM_SUCCESS_c == MEM_BufferFree(pCopy), "free of the sub-buffer");
+    BenchExpect(MEM_SUCCESS_c == MEM_BufferFree(pBuffer), "free of the parent of the sub-buffer");
+    BenchCheckEmpty("after the sub-buffer request");
+#endif
+
+    /* The copying path for comparison: the caller keeps its MSDU */
+    mConfirms = 0;
+    pCopy = MEM_BufferAllocWithId(20, gNwkPoolId, NULL);
+    BenchFillMsdu(pCopy, 20, 10);
+    BenchFillReq(&req, pCopy, 20, 10);
+    BenchExpect(gMacAbsSuccess_c == mpMacAbs->MCPS_DataReq(&req, mMacInstanceId, mBenchUpperInstance_c),
+                "copying request accepted");
+    BenchExpect((1 == mMacQueueCount) && ((uint8_t*)mMacQueue[mMacQueueHead] != pCopy),
+                "the copying request allocates the MAC message");
+    BenchExpect(MEM_SUCCESS_c == MEM_BufferFree(pCopy), "the caller frees its MSDU");
+    BenchTransmit();
+    BenchExpect((1 == mConfirms) && (10 == mLastHandle), "confirm of the copied frame");
+    BenchCheckEmpty("after a copied frame");
+
+    mConfirms = 0;
+    mNullConfirms = 0;
+}
+
+/* Sends requests of the given MSDU length with one path; returns the ns per request */
+static double BenchRun(bool_t zeroCopy, uint16_t len, uint32_t queue, uint32_t requests, benchRun_t *pRun)
+{
+    macAbsMcpsDataReq_t req;
+    uint32_t headroom = mpMacAbs->GetMcpsDataReqHeadroom();
+    uint64_t start;
+    uint32_t blocks;
+    uint32_t bytes;
+    uint32_t r;
+    uint8_t *pBuffer;
+    macAbsResultType_t result;
+
+    memset(pRun, 0, sizeof(benchRun_t));
+    mCheckMsdu = FALSE;
+    mMacResult = gSuccess_c;
+    mConfirms = 0;
+
+    start = BenchNow();
+
+    for(r = 0; r < requests; r++)
+    {
+        if(zeroCopy)
+        {
+            pBuffer = BenchAllocZeroCopy(len, (uint8_t)r);
+            BenchFillReq(&req, pBuffer ? pBuffer + headroom : NULL, len, (uint8_t)r);
+            result = mpMacAbs->MCPS_DataReqZeroCopy(&req, mMacInstanceId, mBenchUpperInstance_c);
+        }
+        else
+        {
+            pBuffer = MEM_BufferAllocWithId(len, gNwkPoolId, NULL);
+            if(pBuffer)
+            {
+                BenchFillMsdu(pBuffer, len, (uint8_t)r);
+            }
+            BenchFillReq(&req, pBuffer, len, (uint8_t)r);
+            result = pBuffer ? mpMacAbs->MCPS_DataReq(&req, mMacInstanceId, mBenchUpperInstance_c)
+                             : gMacAbsTransactionOverflow_c;
+        }
+
+        if(gMacAbsSuccess_c != result)
+        {
+            printf("FAIL: request %u of %u bytes not accepted\n", (unsigned)r, (unsigned)len);
+            mFailures++;
+            break;
+        }
+
+        BenchPoolUsage(&blocks, &bytes);
+        pRun->blocksSum += blocks;
+        pRun->bytesSum += bytes;
+        if(blocks > pRun->peakBlocks)
+        {
+            pRun->peakBlocks = blocks;
+            pRun->peakBytes = bytes;
+        }
+
+        if(!zeroCopy)
+        {
+            (void)MEM_BufferFree(pBuffer);
+        }
+
+        while(mMacQueueCount > queue)
+        {
+            BenchTransmit();
+        }
+    }
+
+    while(mMacQueueCount)
+    {
+        BenchTransmit();
+    }
+
+    mCheckMsdu = TRUE;
+    BenchExpect(mConfirms == r, "every request is confirmed");
+    BenchCheckEmpty("after a run");
+
+    return (double)(BenchNow() - start) / (r ? r : 1);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    static const uint16_t lengths[] = {20, 60, mBenchMaxMsdu_c};
+    uint32_t requests = mBenchDefaultRequests_c;
+    uint32_t queue = 0;
+    absInstanceId_t macInstanceId;
+    benchRun_t copyRun;
+    benchRun_t zeroRun;
+    double copyNs;
+    double zeroNs;
+    uint32_t i;
+
+    if(argc > 1)
+    {
+        requests = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if(argc > 2)
+    {
+        queue = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    if(argc > 3)
+    {
+        mSeed = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+
+    if((0 == requests) || (queue > mBenchMaxQueue_c) || (0 == mSeed))
+    {
+        printf("Usage: %s [requests per run [frames queued in the MAC (0-%u) [seed]]]\n", argv[0],
+               (unsigned)mBenchMaxQueue_c);
+        return 1;
+    }
+
+    (void)MEM_Init();
+    mpMacAbs = MAC_RegisterAbsCb_802154(0, &macInstanceId);
+    if((NULL == mpMacAbs) || (NULL == mMcpsSapHandler))
+    {
+        printf("FAIL: MAC abstraction registration\n");
+        return 1;
+    }
+    mMacInstanceId = macInstanceId;
+
+    printf("%u requests per run, %u frames queued in the MAC, headroom %u bytes (host sizes)\n",
+           (unsigned)requests, (unsigned)queue, (unsigned)mpMacAbs->GetMcpsDataReqHeadroom());
+
+    BenchCheck();
+
+    for(i = 0; i < NumberOfElements(lengths); i++)
+    {
+        copyNs = BenchRun(FALSE, lengths[i], queue, requests, &copyRun);
+        zeroNs = BenchRun(TRUE, lengths[i], queue, requests, &zeroRun);
+
+        printf("MSDU %3u: copy %7.1f ns/request, blocks mean %.2f (%.0f bytes) peak %u (%u bytes)\n",
+               (unsigned)lengths[i], copyNs, (double)copyRun.blocksSum / requests,
+               (double)copyRun.bytesSum / requests, (unsigned)copyRun.peakBlocks, (unsigned)copyRun.peakBytes);
+        printf("          zero-copy %7.1f ns/request, blocks mean %.2f (%.0f bytes) peak %u (%u bytes)\n",
+               zeroNs, (double)zeroRun.blocksSum / requests, (double)zeroRun.bytesSum / requests,
+               (unsigned)zeroRun.peakBlocks, (unsigned)zeroRun.peakBytes);
+    }
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
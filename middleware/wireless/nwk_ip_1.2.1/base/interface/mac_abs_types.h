@@ -625,6 +625,14 @@ typedef struct macAbsRequests_tag
     bool_t      (* PhyRemoveFromNeighborTable)(uint8_t *pAddr, uint8_t addrMode, uint16_t PanId);
     int8_t      (* PhyConvertLQIToRSSI)(uint8_t LQI);
     void        (* AllowBroadcast)   (instanceId_t instanceId, bool_t allowBroadcast);
+
+    /* Zero-copy MCPS Request Functions. The MSDU is built GetMcpsDataReqHeadroom() bytes after the
+       start of a buffer allocated with NWKU_MEM_BufferAlloc() and pParam->pMsdu points to it.
+       MCPS_DataReqZeroCopy takes ownership of that buffer, unless the request is rejected with
+       gMacAbsInvalidParameter_c because pMsdu is not at that offset in an allocated buffer.
+       The prebuilt 6LoWPAN library calls MCPS_DataReq. */
+    macAbsResultType_t (* MCPS_DataReqZeroCopy)(macAbsMcpsDataReq_t * pParam, instanceId_t instanceId, uint32_t upperLayerInstanceId);
+    uint32_t    (* GetMcpsDataReqHeadroom)(void);
 } macAbsRequests_t;
 
 typedef struct macAbsStats_tag
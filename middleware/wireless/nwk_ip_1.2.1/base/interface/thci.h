@@ -75,6 +75,9 @@ typedef enum nwkOpCode_tag
     gTHCI_IpStackIfconfigAll_c                  = 0x0DU,
     gTHCI_IpStackPing_c                         = 0x0EU,
 
+    /* Several requests in one frame, see thciBatchReqHdr_t */
+    gTHCI_Batch_c                               = 0x0FU,
+
     /* Thread Network Parameters */
     gTHCI_ThrGetNeighborInfo_c                  = 0x10U,
 
@@ -241,6 +244,32 @@ typedef struct statusCoapConfirm_tag
     uint8_t msgId[2];
 }statusCoapConfirm_t;
 
+/* A gTHCI_Batch_c request holds the count of requests, followed by a thciBatchReqHdr_t and the
+   payload of each of them. They are processed in order and replied in one gTHCI_Batch_c confirm:
+   the count of requests processed, followed by a thciBatchRspHdr_t and the reply of each of them.
+   The host resends the requests that were not processed, once there is no room left in the
+   confirm. */
+typedef struct thciBatchReqHdr_tag
+{
+    uint8_t opCode;                 /* THCI opcode of the request */
+    uint8_t len;                    /* Request payload length */
+}thciBatchReqHdr_t;
+
+typedef struct thciBatchRspHdr_tag
+{
+    uint8_t opCode;                 /* THCI opcode of the request */
+    uint8_t status;                 /* thciBatchStatus_t */
+    uint8_t len;                    /* Reply length */
+}thciBatchRspHdr_t;
+
+typedef enum thciBatchStatus_tag
+{
+    gThciBatchOk_c                  = 0x00U,    /* The reply follows */
+    gThciBatchDeferred_c            = 0x01U,    /* The reply is sent later, in its own confirm */
+    gThciBatchNoSpace_c             = 0x02U,    /* Processed, the reply did not fit in the confirm */
+    gThciBatchInvalid_c             = 0x03U     /* Not processed: nested batch or truncated request */
+}thciBatchStatus_t;
+
 typedef struct thciEventData_tag
 {
     uint8_t instanceId;             /* InstanceId */
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2017 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _THCI_BATCH_H
+#define _THCI_BATCH_H
+/*!=================================================================================================
+\file       thci_batch.h
+\brief      This is a header file for the THCI request batching (gTHCI_Batch_c): the parsing of the
+            batch envelope and the aggregation of the replies in one confirm.
+==================================================================================================*/
+
+/*==================================================================================================
+Include Files
+==================================================================================================*/
+#include "EmbeddedTypes.h"
+#include "FsciInterface.h"
+#include "thci.h"
+
+/*==================================================================================================
+Public type definitions
+==================================================================================================*/
+typedef struct thciBatchRsp_tag
+{
+    uint8_t *pRsp;          /*!< aggregated confirm: count, then the replies */
+    uint16_t rspLen;        /*!< bytes of the confirm used so far */
+    uint16_t rspSize;       /*!< size of the confirm buffer */
+}thciBatchRsp_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================================================================================================
+Public function prototypes
+==================================================================================================*/
+/*!*************************************************************************************************
+\fn     void THCI_BatchProcess(uint8_t *pClientPacket, uint16_t len, uint32_t interfaceId,
+                               thciBatchRsp_t *pBatchRsp)
+\brief  This function processes the requests of a batch, in order, with THCI_ProcessReq(), and
+        builds their confirm. The processing stops when the confirm has no room left for the next
+        reply header; the count of the confirm tells the host which requests were processed.
+
+\param  [in]    pClientPacket   pointer to the aligned batch payload, not empty. The requests are
+                                moved to its start to be processed.
+\param  [in]    len             length of the batch payload
+\param  [in]    interfaceId     id of the FSCI interface
+\param  [in]    pBatchRsp       pointer to the batch confirm; pRsp and rspSize must be set, rspSize
+                                at least 1
+
+\return         void
+***************************************************************************************************/
+void THCI_BatchProcess(uint8_t *pClientPacket, uint16_t len, uint32_t interfaceId,
+    thciBatchRsp_t *pBatchRsp);
+
+/*!*************************************************************************************************
+\fn     void THCI_BatchRspAppend(thciBatchRsp_t *pBatchRsp, opCode_t opCode, uint8_t status,
+                                 uint8_t *pReply, uint16_t replySize)
+\brief  This function adds the reply of a request to a batch confirm. A reply that does not fit is
+        dropped and its status set to gThciBatchNoSpace_c; THCI_BatchProcess() keeps room for the
+        header.
+
+\param  [in]    pBatchRsp   pointer to the batch confirm
+\param  [in]    opCode      THCI opcode of the request
+\param  [in]    status      status of the request, thciBatchStatus_t
+\param  [in]    pReply      pointer to the reply
+\param  [in]    replySize   size of the reply
+
+\return         void
+***************************************************************************************************/
+void THCI_BatchRspAppend(thciBatchRsp_t *pBatchRsp, opCode_t opCode, uint8_t status,
+    uint8_t *pReply, uint16_t replySize);
+
+/*!*************************************************************************************************
+\fn     void THCI_ProcessReq(opCode_t opCode, uint8_t *pClientPacket, uint32_t interfaceId,
+                            thciBatchRsp_t *pBatchRsp)
+\brief  This function processes a THCI request and sends its reply. Implemented in thci.c.
+
+\param  [in]    opCode          THCI opcode of the request
+\param  [in]    pClientPacket   pointer to the aligned request payload
+\param  [in]    interfaceId     id of the FSCI interface
+\param  [in]    pBatchRsp       pointer to the batch confirm the reply is added to, NULL to send
+                                the reply in its own confirm
+
+\return         void
+***************************************************************************************************/
+void THCI_ProcessReq(opCode_t opCode, uint8_t *pClientPacket, uint32_t interfaceId,
+    thciBatchRsp_t *pBatchRsp);
+
+#ifdef __cplusplus
+}
+#endif
+/*================================================================================================*/
+#endif  /* _THCI_BATCH_H */
@@ -241,6 +241,10 @@ static void float_division(char *intPart, char *fractPart, uint32_t sent, uint32
 #endif
 static int8_t SHELL_MulticastGroups(uint8_t argc, char *argv[]);
 
+#ifdef MEM_PROFILING
+static int8_t SHELL_Mem(uint8_t argc, char *argv[]);
+#endif
+
 #if SOCK_DEMO
 static int8_t SHELL_Socket(uint8_t argc, char *argv[]);
 #endif
@@ -575,6 +579,22 @@ const cmd_tbl_t aShellCommands[] =
         ,NULL
 #endif /* SHELL_USE_AUTO_COMPLETE */
     },
+#ifdef MEM_PROFILING
+    {
+        "mem", SHELL_CMD_MAX_ARGS, 0, SHELL_Mem
+#if SHELL_USE_HELP
+        ,"Memory Manager allocation profiler",
+        "Memory Manager allocation profiler\r\n"
+        "   mem - pools usage and allocations grouped by caller\r\n"
+        "   mem sizes - allocations grouped by requested size\r\n"
+        "   mem waste - fragmentation waste histogram of each pool\r\n"
+        "   mem reset - clear the cumulative counters\r\n"
+#endif /* SHELL_USE_HELP */
+#if SHELL_USE_AUTO_COMPLETE
+        ,NULL
+#endif /* SHELL_USE_AUTO_COMPLETE */
+    },
+#endif /* MEM_PROFILING */
     #if GETIPv6ADDRESSES_APP
     {
         "getnodesip", 5, 0, SHELL_GetNeighborsIpAddr
@@ -4231,6 +4251,89 @@ static int8_t SHELL_MulticastGroups
     return ret;
 }
 
+#ifdef MEM_PROFILING
+/*!*************************************************************************************************
+\private
+\fn     static int8_t SHELL_Mem(uint8_t argc, char *argv[])
+\brief  This function is used to print the Memory Manager allocation profiler.
+
+\param  [in]    argc      Number of arguments the command was called with
+\param  [in]    argv      Pointer to a list of pointers to the arguments
+
+\return         int8_t    Status of the command
+***************************************************************************************************/
+static int8_t SHELL_Mem
+(
+    uint8_t argc,
+    char *argv[]
+)
+{
+    extern pools_t memPools[];
+    const memProfCallSite_t *pSite;
+    const memProfPool_t *pPool;
+    uint32_t i, j;
+
+    if(argc < 2)
+    {
+        for(i = 0; i < MEM_ProfilerGetCount(memProfPools_c); i++)
+        {
+            pPool = MEM_ProfilerGetEntry(memProfPools_c, i);
+            shell_printf("\r\nPool %d (id %d, %d bytes): %d/%d blocks used", i, pPool->poolId,
+                         pPool->blockSize, memPools[i].allocatedBlocks, memPools[i].numBlocks);
+        }
+
+        shell_write("\r\nCaller      Allocs  Fails  Live  Peak  Waste");
+        for(i = 0; i < MEM_ProfilerGetCount(memProfCallSites_c); i++)
+        {
+            pSite = MEM_ProfilerGetEntry(memProfCallSites_c, i);
+            if(pSite->allocCount || pSite->allocFailures || pSite->liveBlocks)
+            {
+                shell_printf("\r\n0x%08X  %6d  %5d  %4d  %4d  %5d", pSite->pCaller, pSite->allocCount,
+                             pSite->allocFailures, pSite->liveBlocks, pSite->liveBlocksPeak, pSite->liveWaste);
+            }
+        }
+    }
+    else if(!strcmp(argv[1], "sizes"))
+    {
+        for(i = 0; i < MEM_ProfilerGetCount(memProfSizeHistogram_c); i++)
+        {
+            if(i < MEM_ProfilerGetCount(memProfSizeHistogram_c) - 1)
+            {
+                shell_printf("\r\n<= %4d bytes: ", 16U << i);
+            }
+            else
+            {
+                shell_printf("\r\n >  %4d bytes: ", 16U << (i - 1));
+            }
+            shell_printf("%d", *(const uint32_t*)MEM_ProfilerGetEntry(memProfSizeHistogram_c, i));
+        }
+    }
+    else if(!strcmp(argv[1], "waste"))
+    {
+        shell_write("\r\nWaste in eighths of the block size");
+        for(i = 0; i < MEM_ProfilerGetCount(memProfPools_c); i++)
+        {
+            pPool = MEM_ProfilerGetEntry(memProfPools_c, i);
+            shell_printf("\r\nPool %d (%d bytes):", i, pPool->blockSize);
+            for(j = 0; j < MEM_PROFILING_WASTE_BUCKETS; j++)
+            {
+                shell_printf(" %d", pPool->wasteHistogram[j]);
+            }
+        }
+    }
+    else if(!strcmp(argv[1], "reset"))
+    {
+        MEM_ProfilerReset();
+    }
+    else
+    {
+        return CMD_RET_USAGE;
+    }
+
+    return CMD_RET_SUCCESS;
+}
+#endif /* MEM_PROFILING */
+
 #if SOCK_DEMO
 /*!*************************************************************************************************
 \private
@@ -0,0 +1,717 @@
+/*!
+* Copyright 2017 NXP
+* All rights reserved.
+*
+* \file ThciBatchBench.c
+* Host loopback test and benchmark of the THCI request batching (gTHCI_Batch_c).
+*
+* A host reads a set of Thread attributes from a device over an FSCI link, with
+*   single - one gTHCI_GetAttrReq_c frame per attribute, one confirm frame each
+*   batch   - as many gTHCI_GetAttrReq_c requests as fit in one gTHCI_Batch_c frame,
+*             replied in one gTHCI_Batch_c confirm; the requests that were not
+*             processed, or whose reply did not fit, are sent in the next batch, and
+*             the next batches hold no more requests than the device processed
+* The frames are FSCI frames with a 2 byte length. With acknowledgements, every
+* frame is acknowledged by an FSCI ACK frame (gFsciTxAck_c on the device, and
+* gFsciRxAck_c on the device for the confirms).
+*
+* The device side is thci_batch.c, the batch envelope parsing and the reply
+* aggregation of THCI_BatchReq(), with THCI_ProcessReq() stubbed: THCI_GetAttrReq()
+* on an attribute table, and a deferred reply for the other requests.
+*
+* check: every attribute value read by the host matches the device table; random
+*   batches (random reply sizes, counts and payload limits) must be replied item by
+*   item, and nested and truncated requests must be reported as gThciBatchInvalid_c.
+*   THCI_BatchRspAppend() must drop the replies that do not fit, and THCI_BatchProcess()
+*   must stop on the request count and when no reply header fits.
+* bench: for the 50 attribute read, the round trips (request frames), frames and
+*   bytes on the wire in each direction, and the link time at 115200 bit/s.
+*
+* Build:
+*   gcc -O2 -std=c99 -DIP_IP6_ENABLE=1 -DTHREAD_USE_THCI=1 -I../../interface
+*       -I../../../core/interface -I../../../core/interface/modules -I../../../core/interface/thread
+*       -I../../../../framework_5.0.5/Common -I../../../../framework_5.0.5/FunctionLib
+*       -I../../../../framework_5.0.5/FSCI/Interface -I../../../../framework_5.0.5/Lists
+*       -I../../../../framework_5.0.5/MemManager/Interface
+*       -I../../../../framework_5.0.5/Messaging/Interface
+*       -I../../../../framework_5.0.5/OSAbstraction/Interface
+*       -I../../../../framework_5.0.5/SerialManager/Interface
+*       -I../../../../framework_5.0.5/TimersManager/Interface
+*       -o ThciBatchBench ThciBatchBench.c ../thci_batch.c
+*       ../../../../framework_5.0.5/FunctionLib/FunctionLib.c
+*   add -DgFsciMaxPayloadLen_c=<bytes> for another FSCI payload size
+* Usage: ThciBatchBench [check iterations [seed]]
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* o Redistributions of source code must retain the above copyright notice, this list
+*   of conditions and the following disclaimer.
+*
+* o Redistributions in binary form must reproduce the above copyright notice, this
+*   list of conditions and the following disclaimer in the documentation and/or
+*   other materials provided with the distribution.
+*
+* o Neither the name of the copyright holder nor the names of its
+*   contributors may be used to endorse or promote products derived from this
+*   software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+********************************************************************************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "thci.h"
+#include "thci_batch.h"
+
+#ifndef gFsciMaxPayloadLen_c
+#define gFsciMaxPayloadLen_c            245     /* app_framework_config.h */
+#endif
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+********************************************************************************** */
+#define mBenchDefaultIter_c         (20000)
+#define mBenchAttributes_c          (50)
+#define mBenchMaxAttrSize_c         (64)
+#define mBenchBaudRate_c            (115200)
+#define mBenchInterface_c           (0)
+
+#define mFsciStartMarker_c          (0x02)
+#define mFsciFrameOverhead_c        (6)     /* marker, OG, OC, 2 bytes length, checksum */
+#define mFsciAckSize_c              (7)     /* the overhead and the acknowledged checksum */
+
+/* THCI_GetAttrReq() request and reply, and mTHCI_Err_c, as in thci.c */
+#define mGetAttrReqSize_c           (3)     /* instance, attribute, index */
+#define mGetAttrRspHdrSize_c        (5)     /* instance, attribute, index, status, size */
+#define mThciErr_c                  (0xFF)
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+********************************************************************************** */
+typedef enum
+{
+    mBenchSingle_c,
+    mBenchBatch_c
+} benchMode_t;
+
+/* A frame on the wire, with the payload decoded */
+typedef struct benchFrame_tag
+{
+    uint8_t  og;
+    uint8_t  oc;
+    uint16_t len;
+    uint8_t  payload[gFsciMaxPayloadLen_c];
+} benchFrame_t;
+
+/* The traffic of a run */
+typedef struct benchLink_tag
+{
+    uint32_t roundTrips;
+    uint32_t hostFrames;
+    uint32_t hostBytes;
+    uint32_t devFrames;
+    uint32_t devBytes;
+} benchLink_t;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+********************************************************************************** */
+static const char *mModeNames[] = {"single", "batch"};
+
+static uint8_t  mAttrSize[256];
+static uint8_t  mAttrValue[256][mBenchMaxAttrSize_c];
+static uint16_t mMaxPayload = gFsciMaxPayloadLen_c;
+static uint8_t  mAcks;
+static benchLink_t mLink;
+static uint32_t mFailures;
+static uint32_t mRandState = 1;
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+********************************************************************************** */
+
+/*! *********************************************************************************
+* \brief  Returns a pseudo random number (xorshift32).
+********************************************************************************** */
+static uint32_t BenchRand(void)
+{
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 17;
+    mRandState ^= mRandState << 5;
+    return mRandState;
+}
+
+static void BenchFail(const char *pWhat, uint32_t value)
+{
+    if( mFailures++ < 10 )
+    {
+        printf("FAIL: %s (%u)\n", pWhat, (unsigned)value);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Encodes a frame into wire bytes, checks and decodes it again (the receiver)
+*         and counts it; the ACK frame is counted in the other direction.
+********************************************************************************** */
+static void BenchWire(const benchFrame_t *pFrame, benchFrame_t *pRx, bool_t fromHost)
+{
+    uint8_t  wire[mFsciFrameOverhead_c + gFsciMaxPayloadLen_c];
+    uint32_t size = 0;
+    uint8_t  checksum = 0;
+    uint32_t i;
+
+    wire[size++] = mFsciStartMarker_c;
+    wire[size++] = pFrame->og;
+    wire[size++] = pFrame->oc;
+    wire[size++] = (uint8_t)pFrame->len;
+    wire[size++] = (uint8_t)(pFrame->len >> 8);
+    memcpy(&wire[size], pFrame->payload, pFrame->len);
+    size += pFrame->len;
+    for( i = 1; i < size; i++ )
+    {
+        checksum ^= wire[i];
+    }
+    wire[size++] = checksum;
+
+    if( fromHost )
+    {
+        mLink.hostFrames++;
+        mLink.hostBytes += size;
+    }
+    else
+    {
+        mLink.devFrames++;
+        mLink.devBytes += size;
+    }
+
+    if( mAcks )
+    {
+        if( fromHost )
+        {
+            mLink.devFrames++;
+            mLink.devBytes += mFsciAckSize_c;
+        }
+        else
+        {
+            mLink.hostFrames++;
+            mLink.hostBytes += mFsciAckSize_c;
+        }
+    }
+
+    /* Receiver */
+    checksum = 0;
+    for( i = 1; i < size - 1; i++ )
+    {
+        checksum ^= wire[i];
+    }
+    if( (mFsciStartMarker_c != wire[0]) || (checksum != wire[size - 1]) )
+    {
+        BenchFail("frame checksum", size);
+    }
+    pRx->og = wire[1];
+    pRx->oc = wire[2];
+    pRx->len = (uint16_t)(wire[3] | (wire[4] << 8));
+    memcpy(pRx->payload, &wire[5], pRx->len);
+}
+
+/*! *********************************************************************************
+* \brief  Device: THCI_GetAttrReq(), the reply of a request.
+********************************************************************************** */
+static uint16_t BenchDevGetAttr(const uint8_t *pReq, uint16_t len, uint8_t *pRsp)
+{
+    uint8_t attrId = pReq[1];
+
+    if( len < mGetAttrReqSize_c )
+    {
+        pRsp[0] = mThciErr_c;
+        return sizeof(statusConfirm_t);
+    }
+
+    pRsp[0] = pReq[0];
+    pRsp[1] = attrId;
+    pRsp[2] = pReq[2];
+    pRsp[3] = 0;
+    pRsp[4] = mAttrSize[attrId];
+    memcpy(&pRsp[5], mAttrValue[attrId], mAttrSize[attrId]);
+    return mGetAttrRspHdrSize_c + mAttrSize[attrId];
+}
+
+/*! *********************************************************************************
+* \brief  Device: the stub of THCI_ProcessReq() in thci.c, for the requests of a
+*         batch. GetAttr is replied at once, the other requests later (e.g.
+*         gTHCI_IpStackPing_c).
+********************************************************************************** */
+void THCI_ProcessReq(opCode_t opCode, uint8_t *pClientPacket, uint32_t interfaceId,
+                     thciBatchRsp_t *pBatchRsp)
+{
+    uint8_t  reply[gFsciMaxPayloadLen_c];
+    uint16_t size;
+
+    if( (NULL == pBatchRsp) || (mBenchInterface_c != interfaceId) )
+    {
+        BenchFail("THCI_ProcessReq() parameters", interfaceId);
+        return;
+    }
+
+    if( gTHCI_GetAttrReq_c == opCode )
+    {
+        size = BenchDevGetAttr(pClientPacket, mGetAttrReqSize_c, reply);
+        THCI_BatchRspAppend(pBatchRsp, opCode, gThciBatchOk_c, reply, size);
+    }
+    else
+    {
+        THCI_BatchRspAppend(pBatchRsp, opCode, gThciBatchDeferred_c, NULL, 0);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Device: THCI_DataIndHandler(), the confirm of a request frame.
+********************************************************************************** */
+static void BenchDevice(benchFrame_t *pReq, benchFrame_t *pCnf)
+{
+    thciBatchRsp_t batchRsp;
+
+    pCnf->og = gFSCI_IpStackOpGCnf_c;
+    pCnf->oc = pReq->oc;
+
+    if( gTHCI_Batch_c != pReq->oc )
+    {
+        pCnf->len = BenchDevGetAttr(pReq->payload, pReq->len, pCnf->payload);
+    }
+    else if( 0 == pReq->len )
+    {
+        pCnf->payload[0] = mThciErr_c;
+        pCnf->len = sizeof(statusConfirm_t);
+    }
+    else
+    {
+        /* THCI_BatchReq(), with the confirm built in the frame */
+        batchRsp.pRsp = pCnf->payload;
+        batchRsp.rspSize = mMaxPayload;
+        THCI_BatchProcess(pReq->payload, pReq->len, mBenchInterface_c, &batchRsp);
+        pCnf->len = batchRsp.rspLen;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  One round trip: the host request, the device confirm.
+********************************************************************************** */
+static void BenchRoundTrip(const benchFrame_t *pReq, benchFrame_t *pCnf)
+{
+    benchFrame_t devReq;
+    benchFrame_t devCnf;
+
+    mLink.roundTrips++;
+    BenchWire(pReq, &devReq, TRUE);
+    BenchDevice(&devReq, &devCnf);
+    BenchWire(&devCnf, pCnf, FALSE);
+}
+
+/*! *********************************************************************************
+* \brief  Host: checks a GetAttr reply.
+********************************************************************************** */
+static void BenchHostCheckAttr(uint8_t attrId, const uint8_t *pRsp, uint16_t len)
+{
+    if( (len != mGetAttrRspHdrSize_c + mAttrSize[attrId]) ||
+        (pRsp[1] != attrId) || (pRsp[3] != 0) || (pRsp[4] != mAttrSize[attrId]) ||
+        memcmp(&pRsp[5], mAttrValue[attrId], mAttrSize[attrId]) )
+    {
+        BenchFail("attribute reply", attrId);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Host: reads count attributes, the way the mode does it.
+********************************************************************************** */
+static void BenchHostRead(benchMode_t mode, const uint8_t *pAttrIds, uint32_t count)
+{
+    benchFrame_t req;
+    benchFrame_t cnf;
+    uint8_t  pending[256];
+    uint32_t pendingCount = count;
+    uint32_t window = 0xFF;
+    uint32_t i;
+
+    req.og = gFSCI_IpStackOpGReq_c;
+
+    if( mBenchSingle_c == mode )
+    {
+        req.oc = gTHCI_GetAttrReq_c;
+        req.len = mGetAttrReqSize_c;
+        for( i = 0; i < count; i++ )
+        {
+            req.payload[0] = 0;
+            req.payload[1] = pAttrIds[i];
+            req.payload[2] = 0;
+            BenchRoundTrip(&req, &cnf);
+            if( (cnf.og != gFSCI_IpStackOpGCnf_c) || (cnf.oc != gTHCI_GetAttrReq_c) )
+            {
+                BenchFail("single confirm", cnf.oc);
+            }
+            BenchHostCheckAttr(pAttrIds[i], cnf.payload, cnf.len);
+        }
+        return;
+    }
+
+    memcpy(pending, pAttrIds, count);
+    req.oc = gTHCI_Batch_c;
+
+    while( pendingCount )
+    {
+        uint32_t sent = 0;
+        uint32_t left = 0;
+        uint32_t offset;
+        uint8_t  processed;
+
+        /* As many requests as fit in one frame */
+        req.len = sizeof(uint8_t);
+        while( (sent < pendingCount) && (sent < window) &&
+               (req.len + sizeof(thciBatchReqHdr_t) + mGetAttrReqSize_c <= mMaxPayload) )
+        {
+            req.payload[req.len++] = gTHCI_GetAttrReq_c;
+            req.payload[req.len++] = mGetAttrReqSize_c;
+            req.payload[req.len++] = 0;
+            req.payload[req.len++] = pending[sent];
+            req.payload[req.len++] = 0;
+            sent++;
+        }
+        req.payload[0] = (uint8_t)sent;
+
+        BenchRoundTrip(&req, &cnf);
+
+        processed = cnf.payload[0];
+        if( (cnf.oc != gTHCI_Batch_c) || (0 == cnf.len) || (processed > sent) )
+        {
+            BenchFail("batch confirm", cnf.len);
+            return;
+        }
+
+        offset = sizeof(uint8_t);
+        for( i = 0; i < processed; i++ )
+        {
+            thciBatchRspHdr_t rspHdr;
+
+            if( offset + sizeof(rspHdr) > cnf.len )
+            {
+                BenchFail("batch confirm length", offset);
+                return;
+            }
+            memcpy(&rspHdr, &cnf.payload[offset], sizeof(rspHdr));
+            offset += sizeof(rspHdr);
+            if( (rspHdr.opCode != gTHCI_GetAttrReq_c) || (offset + rspHdr.len > cnf.len) )
+            {
+                BenchFail("batch reply header", i);
+                return;
+            }
+
+            if( gThciBatchOk_c == rspHdr.status )
+            {
+                BenchHostCheckAttr(pending[i], &cnf.payload[offset], rspHdr.len);
+            }
+            else if( gThciBatchNoSpace_c == rspHdr.status )
+            {
+                pending[left++] = pending[i];
+            }
+            else
+            {
+                BenchFail("batch reply status", rspHdr.status);
+            }
+            offset += rspHdr.len;
+        }
+        if( offset != cnf.len )
+        {
+            BenchFail("batch confirm trailing bytes", cnf.len - offset);
+        }
+
+        /* Resend the requests not processed and the replies that did not fit */
+        for( i = processed; i < pendingCount; i++ )
+        {
+            pending[left++] = pending[i];
+        }
+        if( left == pendingCount )
+        {
+            BenchFail("batch makes no progress", pendingCount);
+            return;
+        }
+        pendingCount = left;
+
+        /* The requests the device did not process were sent for nothing: do not send
+           more than it processed */
+        if( processed < sent )
+        {
+            window = processed;
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Sets the attribute table: sizes drawn from a Thread like mix (flags,
+*         channels, PAN IDs, extended addresses and prefixes, keys, names, TLVs).
+********************************************************************************** */
+static void BenchAttrTable(uint8_t maxSize)
+{
+    static const uint8_t sizes[] = {1, 1, 1, 2, 2, 4, 4, 8, 8, 16, 16, 32};
+    uint32_t i, j;
+
+    for( i = 0; i < 256; i++ )
+    {
+        mAttrSize[i] = sizes[BenchRand() % sizeof(sizes)];
+        if( mAttrSize[i] > maxSize )
+        {
+            mAttrSize[i] = maxSize;
+        }
+        for( j = 0; j < mAttrSize[i]; j++ )
+        {
+            mAttrValue[i][j] = (uint8_t)BenchRand();
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  The envelope corner cases: nested batch, deferred and truncated requests.
+********************************************************************************** */
+static void BenchCheckEnvelope(void)
+{
+    benchFrame_t req;
+    benchFrame_t cnf;
+    static const uint8_t expected[] =
+    {
+        4,                                                  /* processed */
+        gTHCI_Batch_c, gThciBatchInvalid_c, 0,              /* nested */
+        gTHCI_IpStackPing_c, gThciBatchDeferred_c, 0,       /* replied later */
+        gTHCI_GetAttrReq_c, gThciBatchOk_c, 5, 0, 7, 0, 0, 0,
+        gTHCI_GetAttrReq_c, gThciBatchInvalid_c, 0          /* truncated */
+    };
+
+    mAttrSize[7] = 0;
+    req.og = gFSCI_IpStackOpGReq_c;
+    req.oc = gTHCI_Batch_c;
+    req.len = 0;
+    req.payload[req.len++] = 5;
+    req.payload[req.len++] = gTHCI_Batch_c;
+    req.payload[req.len++] = 1;
+    req.payload[req.len++] = 0;
+    req.payload[req.len++] = gTHCI_IpStackPing_c;
+    req.payload[req.len++] = 0;
+    req.payload[req.len++] = gTHCI_GetAttrReq_c;
+    req.payload[req.len++] = mGetAttrReqSize_c;
+    req.payload[req.len++] = 0;
+    req.payload[req.len++] = 7;
+    req.payload[req.len++] = 0;
+    req.payload[req.len++] = gTHCI_GetAttrReq_c;
+    req.payload[req.len++] = mGetAttrReqSize_c;
+    req.payload[req.len++] = 0;
+
+    BenchRoundTrip(&req, &cnf);
+    if( (cnf.len != sizeof(expected)) || memcmp(cnf.payload, expected, sizeof(expected)) )
+    {
+        BenchFail("batch envelope", cnf.len);
+    }
+
+    /* Empty batch */
+    req.len = 0;
+    BenchRoundTrip(&req, &cnf);
+    if( (cnf.len != sizeof(statusConfirm_t)) || (cnf.payload[0] != mThciErr_c) )
+    {
+        BenchFail("empty batch", cnf.len);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  THCI_BatchRspAppend() limits, and the THCI_BatchProcess() stop conditions:
+*         the request count and the room left for a reply header.
+********************************************************************************** */
+static void BenchCheckLimits(void)
+{
+    uint8_t  rsp[300];
+    uint8_t  reply[300];
+    uint8_t  req[32];
+    thciBatchRsp_t batchRsp;
+    uint32_t i;
+
+    memset(reply, 0x5A, sizeof(reply));
+    batchRsp.pRsp = rsp;
+    batchRsp.rspSize = 20;
+    batchRsp.rspLen = 1;
+
+    /* 1 + 3 + 16 bytes fit exactly, the next reply does not */
+    THCI_BatchRspAppend(&batchRsp, gTHCI_GetAttrReq_c, gThciBatchOk_c, reply, 16);
+    if( (20 != batchRsp.rspLen) || (gThciBatchOk_c != rsp[2]) || (16 != rsp[3]) )
+    {
+        BenchFail("reply that fits", batchRsp.rspLen);
+    }
+    batchRsp.rspSize = 24;
+    THCI_BatchRspAppend(&batchRsp, gTHCI_GetAttrReq_c, gThciBatchOk_c, reply, 2);
+    if( (23 != batchRsp.rspLen) || (gThciBatchNoSpace_c != rsp[21]) || (0 != rsp[22]) )
+    {
+        BenchFail("reply that does not fit", batchRsp.rspLen);
+    }
+
+    /* A reply longer than the 8-bit length field */
+    batchRsp.rspSize = sizeof(rsp);
+    batchRsp.rspLen = 1;
+    THCI_BatchRspAppend(&batchRsp, gTHCI_GetAttrReq_c, gThciBatchOk_c, reply, 256);
+    if( (4 != batchRsp.rspLen) || (gThciBatchNoSpace_c != rsp[2]) )
+    {
+        BenchFail("reply longer than 255 bytes", batchRsp.rspLen);
+    }
+
+    /* The status of a request with no reply is kept */
+    batchRsp.rspLen = 1;
+    THCI_BatchRspAppend(&batchRsp, gTHCI_IpStackPing_c, gThciBatchDeferred_c, NULL, 0);
+    if( (4 != batchRsp.rspLen) || (gThciBatchDeferred_c != rsp[2]) )
+    {
+        BenchFail("deferred reply", batchRsp.rspLen);
+    }
+
+    /* Four deferred requests, a count of two: two processed */
+    req[0] = 2;
+    for( i = 0; i < 4; i++ )
+    {
+        req[1 + 2 * i] = gTHCI_IpStackPing_c;
+        req[2 + 2 * i] = 0;
+    }
+    batchRsp.rspSize = sizeof(rsp);
+    THCI_BatchProcess(req, 9, mBenchInterface_c, &batchRsp);
+    if( (2 != rsp[0]) || (7 != batchRsp.rspLen) )
+    {
+        BenchFail("batch request count", rsp[0]);
+    }
+
+    /* Room for one reply header only: one processed */
+    req[0] = 4;
+    batchRsp.rspSize = 1 + sizeof(thciBatchRspHdr_t) + sizeof(thciBatchRspHdr_t) - 1;
+    THCI_BatchProcess(req, 9, mBenchInterface_c, &batchRsp);
+    if( (1 != rsp[0]) || (4 != batchRsp.rspLen) )
+    {
+        BenchFail("batch confirm room", rsp[0]);
+    }
+
+    /* No room for a reply header: none processed */
+    batchRsp.rspSize = sizeof(thciBatchRspHdr_t);
+    THCI_BatchProcess(req, 9, mBenchInterface_c, &batchRsp);
+    if( (0 != rsp[0]) || (1 != batchRsp.rspLen) )
+    {
+        BenchFail("batch confirm full", rsp[0]);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Random batches: attribute sizes, counts and payload limits.
+********************************************************************************** */
+static void BenchCheck(uint32_t iterations)
+{
+    uint8_t  attrIds[256];
+    uint32_t it, i, count, maxSize;
+
+    for( it = 0; it < iterations; it++ )
+    {
+        /* The largest reply must fit in an empty batch confirm */
+        mMaxPayload = (uint16_t)(24 + BenchRand() % (gFsciMaxPayloadLen_c - 24 + 1));
+        maxSize = mMaxPayload - sizeof(uint8_t) - sizeof(thciBatchRspHdr_t) - mGetAttrRspHdrSize_c;
+        BenchAttrTable((uint8_t)(maxSize < mBenchMaxAttrSize_c ? maxSize : mBenchMaxAttrSize_c));
+        count = 1 + BenchRand() % 255;
+        for( i = 0; i < count; i++ )
+        {
+            attrIds[i] = (uint8_t)BenchRand();
+        }
+        mAcks = (uint8_t)(BenchRand() & 1);
+        BenchHostRead(mBenchBatch_c, attrIds, count);
+    }
+
+    mMaxPayload = gFsciMaxPayloadLen_c;
+    BenchCheckEnvelope();
+    BenchCheckLimits();
+}
+
+static void BenchRun(benchMode_t mode, uint8_t acks, const uint8_t *pAttrIds)
+{
+    double ms;
+
+    memset(&mLink, 0, sizeof(mLink));
+    mAcks = acks;
+    BenchHostRead(mode, pAttrIds, mBenchAttributes_c);
+
+    ms = (mLink.hostBytes > mLink.devBytes ? mLink.hostBytes : mLink.devBytes) * 10 * 1000.0 /
+         mBenchBaudRate_c;
+    printf("  %-6s %-4s %5u %7u %7u %7u %7u %7u %8.1f\n", mModeNames[mode], acks ? "yes" : "no",
+           (unsigned)mLink.roundTrips, (unsigned)mLink.hostFrames, (unsigned)mLink.hostBytes,
+           (unsigned)mLink.devFrames, (unsigned)mLink.devBytes,
+           (unsigned)(mLink.hostBytes + mLink.devBytes), ms);
+}
+
+
+/*! *********************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+********************************************************************************** */
+int main(int argc, char **argv)
+{
+    uint32_t iterations = mBenchDefaultIter_c;
+    uint8_t  attrIds[mBenchAttributes_c];
+    uint32_t i;
+
+    if( argc > 1 )
+    {
+        iterations = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    mRandState = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : (uint32_t)time(NULL);
+    if( 0 == mRandState )
+    {
+        mRandState = 1;
+    }
+
+    printf("FSCI payload %u bytes, %u check iterations, seed %u\n",
+           (unsigned)gFsciMaxPayloadLen_c, (unsigned)iterations, (unsigned)mRandState);
+    BenchCheck(iterations);
+
+    BenchAttrTable(mBenchMaxAttrSize_c);
+    for( i = 0; i < mBenchAttributes_c; i++ )
+    {
+        attrIds[i] = (uint8_t)i;
+    }
+
+    printf("\n%u attribute read, link time at %u bit/s (the busier direction):\n",
+           (unsigned)mBenchAttributes_c, (unsigned)mBenchBaudRate_c);
+    printf("  mode   acks trips  host f  host B   dev f   dev B total B  link ms\n");
+    BenchRun(mBenchSingle_c, 0, attrIds);
+    BenchRun(mBenchBatch_c, 0, attrIds);
+    BenchRun(mBenchSingle_c, 1, attrIds);
+    BenchRun(mBenchBatch_c, 1, attrIds);
+
+    printf("%s\n", mFailures ? "FAILED" : "PASSED");
+    return mFailures ? 1 : 0;
+}
@@ -61,6 +61,7 @@ Include Files
 #include "icmp.h"
 #include "sixlowpan.h"
 #include "thci.h"
+#include "thci_batch.h"
 #include "event_manager.h"
 
 #include "dtls.h"
@@ -634,6 +635,7 @@ Private prototypes
 ==================================================================================================*/
 static void THCI_DataIndCb(void *pData, void* param, uint32_t interfaceId);
 static void THCI_DataIndHandler(void *param);
+static void THCI_BatchReq(uint8_t *pClientPacket, uint16_t len, uint32_t interfaceId);
 
 static void THCI_BSDSockReqSocket(uint8_t *pClientPacket, uint32_t interfaceId,
     uint8_t *pReplyData, uint16_t *pDataSize);
@@ -861,6 +863,7 @@ static void THCI_MulticastGroupShow(uint8_t *pClientPacket, uint32_t interfaceId
 static void THCI_MulticastGroupManage(uint8_t *pClientPacket, uint32_t interfaceId,
                             statusConfirm_t *pReplyData, uint16_t *pDataSize);
 static void THCI_transmitPayload(uint8_t OG, uint8_t OC, void * pMsg, uint16_t msgLen, uint32_t fsciInterface);
+static void THCI_transmitPayloadBuffer(uint8_t OG, uint8_t OC, void * pMsg, uint16_t msgLen, uint32_t fsciInterface);
 /*==================================================================================================
 Private global variables declarations
 ==================================================================================================*/
@@ -998,6 +1001,47 @@ static void THCI_DataIndHandler
     uint32_t interfaceId = ((thciGenericMsg_t*)param)->interfaceId;
     clientPacket_t *pRxClientPacket = (clientPacket_t*)pData;
     uint8_t *pClientPacket = (uint8_t *)pData;
+    opCode_t   opCode = pRxClientPacket->structured.header.opCode;
+    uint16_t len = pRxClientPacket->structured.header.len;
+
+    /* removed thci header to have an aligned pointer*/
+    FLib_MemInPlaceCpy(pClientPacket,pRxClientPacket->structured.payload,len);
+
+    if(gTHCI_Batch_c == opCode)
+    {
+        THCI_BatchReq(pClientPacket, len, interfaceId);
+    }
+    else
+    {
+        THCI_ProcessReq(opCode, pClientPacket, interfaceId, NULL);
+    }
+
+    /* Clear received packet */
+    MEM_BufferFree(pData);
+    MEM_BufferFree(param);
+}
+
+/*!*************************************************************************************************
+\fn     void THCI_ProcessReq(opCode_t opCode, uint8_t *pClientPacket, uint32_t interfaceId,
+                            thciBatchRsp_t *pBatchRsp)
+\brief  This function processes a THCI request and sends its reply.
+
+\param  [in]    opCode          THCI opcode of the request
+\param  [in]    pClientPacket   pointer to the aligned request payload
+\param  [in]    interfaceId     id of the FSCI interface
+\param  [in]    pBatchRsp       pointer to the batch confirm the reply is added to, NULL to send
+                                the reply in its own confirm
+
+\return         void
+***************************************************************************************************/
+void THCI_ProcessReq
+(
+    opCode_t opCode,
+    uint8_t *pClientPacket,
+    uint32_t interfaceId,
+    thciBatchRsp_t *pBatchRsp
+)
+{
     uint16_t replyDataSize = 0;
     uint8_t *pReplyData = NULL;
     bool_t sendReply = TRUE;
@@ -1005,10 +1049,6 @@ static void THCI_DataIndHandler
     statusConfirm_t basicConfirm;
     statusCoapConfirm_t coapConfirm;
     thciDtlsConnectConfirm_t dtlsConnectConfirm;
-    opCode_t   opCode = pRxClientPacket->structured.header.opCode;
-
-    /* removed thci header to have an aligned pointer*/
-    FLib_MemInPlaceCpy(pClientPacket,pRxClientPacket->structured.payload,pRxClientPacket->structured.header.len);
 
     switch(opCode)
     {
@@ -1697,16 +1737,27 @@ static void THCI_DataIndHandler
         }
 
         /* Send reply */
-        if (pReplyData)
+        if(pBatchRsp)
         {
-            THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, opCode,
-                pReplyData, replyDataSize, interfaceId);
-
-            if(freePacket)
+            THCI_BatchRspAppend(pBatchRsp, opCode, gThciBatchOk_c, pReplyData, replyDataSize);
+            if(freePacket && pReplyData)
             {
                 MEM_BufferFree(pReplyData);
             }
         }
+        else if (pReplyData)
+        {
+            if(freePacket)
+            {
+                THCI_transmitPayloadBuffer(gFSCI_IpStackOpGCnf_c, opCode,
+                    pReplyData, replyDataSize, interfaceId);
+            }
+            else
+            {
+                THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, opCode,
+                    pReplyData, replyDataSize, interfaceId);
+            }
+        }
     }
     /* Do not send the reply and keep some pointers */
     else
@@ -1716,11 +1767,52 @@ static void THCI_DataIndHandler
         pmQueuedReplyData = pReplyData;
         mQueuedDataSize = replyDataSize;
         mQueuedInterfaceId = interfaceId;
+
+        if(pBatchRsp)
+        {
+            THCI_BatchRspAppend(pBatchRsp, opCode, gThciBatchDeferred_c, NULL, 0);
+        }
     }
+}
 
-    /* Clear received packet */
-    MEM_BufferFree(pData);
-    MEM_BufferFree(param);
+/*!*************************************************************************************************
+\private
+\fn     void THCI_BatchReq(uint8_t *pClientPacket, uint16_t len, uint32_t interfaceId)
+\brief  This function processes the requests of a batch with THCI_BatchProcess() and sends their
+        replies in one confirm.
+
+\param  [in]    pClientPacket   pointer to the aligned batch payload
+\param  [in]    len             length of the batch payload
+\param  [in]    interfaceId     id of the FSCI interface
+
+\return         void
+***************************************************************************************************/
+static void THCI_BatchReq
+(
+    uint8_t *pClientPacket,
+    uint16_t len,
+    uint32_t interfaceId
+)
+{
+    thciBatchRsp_t batchRsp;
+
+    batchRsp.pRsp = MEM_BufferAlloc(gFsciMaxPayloadLen_c);
+    batchRsp.rspSize = gFsciMaxPayloadLen_c;
+
+    if((NULL == batchRsp.pRsp) || (0 == len))
+    {
+        statusConfirm_t basicConfirm;
+
+        MEM_BufferFree(batchRsp.pRsp);
+        basicConfirm.status = (0 == len) ? mTHCI_Err_c : mTHCI_NoSpace_c;
+        THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, gTHCI_Batch_c, &basicConfirm,
+            sizeof(statusConfirm_t), interfaceId);
+        return;
+    }
+
+    THCI_BatchProcess(pClientPacket, len, interfaceId, &batchRsp);
+    THCI_transmitPayloadBuffer(gFSCI_IpStackOpGCnf_c, gTHCI_Batch_c, batchRsp.pRsp,
+        batchRsp.rspLen, interfaceId);
 }
 
 /*!*************************************************************************************************
@@ -2922,10 +3014,8 @@ static void PING_EchoReplyReceive
             ((pingReply_t*)pmQueuedReplyData)->status = mTHCI_Err_c;
         }
 
-        THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, mQueuedOpCode, pmQueuedReplyData,
+        THCI_transmitPayloadBuffer(gFSCI_IpStackOpGCnf_c, mQueuedOpCode, pmQueuedReplyData,
             mQueuedDataSize, mQueuedInterfaceId);
-
-        MEM_BufferFree(pmQueuedReplyData);
         pmQueuedReplyData = NULL;
     }
 
@@ -2971,10 +3061,8 @@ static void PING_HandleTimerCallback(void *param)
     {
       /* Send reply */
       ((pingReply_t*)pmQueuedReplyData)->status = mTHCI_PingTimeout_c;
-      THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, mQueuedOpCode, pmQueuedReplyData,
+      THCI_transmitPayloadBuffer(gFSCI_IpStackOpGCnf_c, mQueuedOpCode, pmQueuedReplyData,
           mQueuedDataSize, mQueuedInterfaceId);
-
-      MEM_BufferFree(pmQueuedReplyData);
       pmQueuedReplyData = NULL;
     }
 }
@@ -5232,9 +5320,8 @@ static void THCI_HandleMeshcopDiagnostics
         }
         pDiagPacket->tlvsLen = tlvsLen;
         FLib_MemCpy(pDiagPacket + 1, pTlvs, tlvsLen);
-        THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, gTHCI_MeshCopDiagnostic_c, (void*)pDiagPacket,
+        THCI_transmitPayloadBuffer(gFSCI_IpStackOpGCnf_c, gTHCI_MeshCopDiagnostic_c, (void*)pDiagPacket,
             sizeof(thciMeshcopDiagHdr_t) + tlvsLen, mQueuedInterfaceId);
-        MEM_BufferFree(pDiagPacket);
     }
 }
 
@@ -5278,9 +5365,8 @@ static void THCI_CoapReceiveCb
         }
 
         /* send response */
-        THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, gTHCI_THRCoapRcvd_c, pCoapRcvd,
-                             (sizeof(thciCoapStruct_t) + dataLen), mQueuedInterfaceId);
-        MEM_BufferFree(pCoapRcvd);
+        THCI_transmitPayloadBuffer(gFSCI_IpStackOpGCnf_c, gTHCI_THRCoapRcvd_c, pCoapRcvd,
+                                   (sizeof(thciCoapStruct_t) + dataLen), mQueuedInterfaceId);
     }
 
 }
@@ -5356,10 +5442,8 @@ static void DTLS_Received
 
         pDataRes->peerIndex = NWKU_GetTblEntry((uint32_t)pPeer, (uint32_t*)maDtlsPeers,
             NumberOfElements(maDtlsPeers));
-        THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, gTHCI_DtlsReceive_c, (uint8_t*)pDataRes,
+        THCI_transmitPayloadBuffer(gFSCI_IpStackOpGCnf_c, gTHCI_DtlsReceive_c, (uint8_t*)pDataRes,
             sizeof(dtlsDataConfirm_t) + len, mQueuedInterfaceId);
-
-        MEM_BufferFree(pDataRes);
     }
 }
 
@@ -7245,9 +7329,8 @@ void THCI_MgmtDiagnosticAppCb(mgmtDiagnostic_RspData_t mgmtDiagRspData)
         pMgmtDiagnostic->dataLen[1] = (uint8_t)(mgmtDiagRspData.payloadLen >> 8);
         FLib_MemCpy(pMgmtDiagnostic->pData, mgmtDiagRspData.pPayload, mgmtDiagRspData.payloadLen);
         /* send response */
-        THCI_transmitPayload(gFSCI_IpStackOpGCnf_c, opCode, pMgmtDiagnostic,
-                             sizeof(thciMgmtDiagRsp_t) + mgmtDiagRspData.payloadLen, mQueuedInterfaceId);
-        MEM_BufferFree(pMgmtDiagnostic);
+        THCI_transmitPayloadBuffer(gFSCI_IpStackOpGCnf_c, opCode, pMgmtDiagnostic,
+                                   sizeof(thciMgmtDiagRsp_t) + mgmtDiagRspData.payloadLen, mQueuedInterfaceId);
     }
 #else
     (void)mgmtDiagRspData;
@@ -7308,6 +7391,30 @@ static void THCI_transmitPayload(uint8_t OG, uint8_t OC, void * pMsg, uint16_t m
     #endif
 }
 
+/*!*************************************************************************************************
+\fn     void THCI_transmitPayloadBuffer(uint8_t OG, uint8_t OC, void * pMsg, uint16_t msgLen,
+                                        uint32_t fsciInterface)
+\brief  Sends a payload allocated with MEM_BufferAlloc(). The buffer is freed once sent, the
+        caller must not use it anymore.
+
+\param[in] OG operation Group
+\param[in] OC operation Code
+\param[in] pMsg pointer to payload
+\param[in] msgLen length of the payload
+\param[in] fsciInterface the interface on which the packet should be sent
+
+\return         void
+***************************************************************************************************/
+static void THCI_transmitPayloadBuffer(uint8_t OG, uint8_t OC, void * pMsg, uint16_t msgLen, uint32_t fsciInterface)
+{
+    #if !THCI_USBENET_ENABLE || !(USBENET_ROUTER || USBENET_HOST)
+    FSCI_transmitPayloadBuffer( OG, OC, pMsg, msgLen, fsciInterface);
+    #else
+    THCI_transmitPayload( OG, OC, pMsg, msgLen, fsciInterface);
+    MEM_BufferFree(pMsg);
+    #endif
+}
+
 #endif /* THREAD_USE_THCI */
 
 
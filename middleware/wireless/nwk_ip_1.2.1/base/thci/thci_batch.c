@@ -0,0 +1,165 @@
+/*
+ * Copyright 2017 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!=================================================================================================
+\file       thci_batch.c
+\brief      This is a source file for the THCI request batching (gTHCI_Batch_c). It parses the batch
+            envelope, hands each request to THCI_ProcessReq() and aggregates the replies in one
+            confirm. It has no other dependency on the stack.
+==================================================================================================*/
+
+/*==================================================================================================
+Include Files
+==================================================================================================*/
+#include "EmbeddedTypes.h"
+#include "FunctionLib.h"
+#include "network_utils.h"
+#include "thci.h"
+#include "thci_batch.h"
+
+#if THREAD_USE_THCI
+
+/*==================================================================================================
+Public functions
+==================================================================================================*/
+/*!*************************************************************************************************
+\fn     void THCI_BatchProcess(uint8_t *pClientPacket, uint16_t len, uint32_t interfaceId,
+                               thciBatchRsp_t *pBatchRsp)
+\brief  This function processes the requests of a batch, in order, with THCI_ProcessReq(), and
+        builds their confirm. The processing stops when the confirm has no room left for the next
+        reply header; the count of the confirm tells the host which requests were processed.
+
+\param  [in]    pClientPacket   pointer to the aligned batch payload, not empty. The requests are
+                                moved to its start to be processed.
+\param  [in]    len             length of the batch payload
+\param  [in]    interfaceId     id of the FSCI interface
+\param  [in]    pBatchRsp       pointer to the batch confirm; pRsp and rspSize must be set, rspSize
+                                at least 1
+
+\return         void
+***************************************************************************************************/
+void THCI_BatchProcess
+(
+    uint8_t *pClientPacket,
+    uint16_t len,
+    uint32_t interfaceId,
+    thciBatchRsp_t *pBatchRsp
+)
+{
+    thciBatchReqHdr_t reqHdr;
+    uint16_t offset = sizeof(uint8_t);
+    uint8_t count = pClientPacket[0];
+    uint8_t processed = 0;
+
+    pBatchRsp->rspLen = sizeof(uint8_t);
+
+    while((processed < count) &&
+          (offset + sizeof(thciBatchReqHdr_t) <= len) &&
+          (pBatchRsp->rspLen + sizeof(thciBatchRspHdr_t) <= pBatchRsp->rspSize))
+    {
+        FLib_MemCpy(&reqHdr, &pClientPacket[offset], sizeof(thciBatchReqHdr_t));
+        offset += sizeof(thciBatchReqHdr_t);
+
+        if(offset + reqHdr.len > len)
+        {
+            /* Truncated request: nothing after it can be parsed */
+            THCI_BatchRspAppend(pBatchRsp, reqHdr.opCode, gThciBatchInvalid_c, NULL, 0);
+            processed++;
+            break;
+        }
+
+        if(gTHCI_Batch_c == reqHdr.opCode)
+        {
+            THCI_BatchRspAppend(pBatchRsp, reqHdr.opCode, gThciBatchInvalid_c, NULL, 0);
+        }
+        else
+        {
+            /* Move the request to the start of the packet to have an aligned pointer. Only the
+               requests already processed are overwritten. */
+            FLib_MemInPlaceCpy(pClientPacket, &pClientPacket[offset], reqHdr.len);
+            THCI_ProcessReq(reqHdr.opCode, pClientPacket, interfaceId, pBatchRsp);
+        }
+
+        offset += reqHdr.len;
+        processed++;
+    }
+
+    pBatchRsp->pRsp[0] = processed;
+}
+
+/*!*************************************************************************************************
+\fn     void THCI_BatchRspAppend(thciBatchRsp_t *pBatchRsp, opCode_t opCode, uint8_t status,
+                                 uint8_t *pReply, uint16_t replySize)
+\brief  This function adds the reply of a request to a batch confirm. A reply that does not fit is
+        dropped and its status set to gThciBatchNoSpace_c; THCI_BatchProcess() keeps room for the
+        header.
+
+\param  [in]    pBatchRsp   pointer to the batch confirm
+\param  [in]    opCode      THCI opcode of the request
+\param  [in]    status      status of the request, thciBatchStatus_t
+\param  [in]    pReply      pointer to the reply
+\param  [in]    replySize   size of the reply
+
+\return         void
+***************************************************************************************************/
+void THCI_BatchRspAppend
+(
+    thciBatchRsp_t *pBatchRsp,
+    opCode_t opCode,
+    uint8_t status,
+    uint8_t *pReply,
+    uint16_t replySize
+)
+{
+    thciBatchRspHdr_t rspHdr;
+
+    if((NULL == pReply) ||
+       (replySize > THR_ALL_FFs8) ||
+       (pBatchRsp->rspLen + sizeof(thciBatchRspHdr_t) + replySize > pBatchRsp->rspSize))
+    {
+        if((gThciBatchOk_c == status) && (NULL != pReply))
+        {
+            status = gThciBatchNoSpace_c;
+        }
+        replySize = 0;
+    }
+
+    rspHdr.opCode = opCode;
+    rspHdr.status = status;
+    rspHdr.len = (uint8_t)replySize;
+    FLib_MemCpy(&pBatchRsp->pRsp[pBatchRsp->rspLen], &rspHdr, sizeof(thciBatchRspHdr_t));
+    pBatchRsp->rspLen += sizeof(thciBatchRspHdr_t);
+    if(replySize)
+    {
+        FLib_MemCpy(&pBatchRsp->pRsp[pBatchRsp->rspLen], pReply, replySize);
+        pBatchRsp->rspLen += replySize;
+    }
+}
+
+#endif /* THREAD_USE_THCI */
+/*================================================================================================*/
@@ -112,6 +112,11 @@ static resultType_t MLME_NWK_SapHandlerCB(nwkMessage_t* pMsg, instanceId_t insta
 /* MCPS Services */
 static macAbsResultType_t MAC_McpsDataReq(macAbsMcpsDataReq_t * pParam, instanceId_t instanceId, 
                                                   uint32_t upperLayerInstanceId);
+static macAbsResultType_t MAC_McpsDataReqZeroCopy(macAbsMcpsDataReq_t * pParam, instanceId_t instanceId,
+                                                  uint32_t upperLayerInstanceId);
+static macAbsResultType_t MAC_McpsDataReqSend(nwkToMcpsMessage_t * pNwkToMcpsMsg, macAbsMcpsDataReq_t * pParam,
+                                              instanceId_t instanceId, uint32_t upperLayerInstanceId);
+static uint32_t MAC_GetMcpsDataReqHeadroom(void);
 static macAbsResultType_t MAC_McpsPurgeReq(uint8_t msduHandle, instanceId_t instanceId);
 
 /* MLME Services */
@@ -153,6 +158,7 @@ static void  MAC_SetMlmeCallbacks(macAbsCallbacks_t* mlmeCallbacks, instanceId_t
 
 /* MAC Callbacks */
 static void MAC_McpsDataIndCB(mcpsToNwkMessage_t* pMsg, instanceId_t instanceId);
+static macAbsMcpsDataInd_t* MAC_McpsDataIndBuild(mcpsToNwkMessage_t* pMsg, instanceId_t instanceId);
 static void MAC_McpsDataCnfCB(mcpsToNwkMessage_t* pMsg, instanceId_t instanceId);
 static void MAC_McpsPurgeCnfCB(mcpsToNwkMessage_t* pMsg, instanceId_t instanceId);
     
@@ -206,7 +212,9 @@ static const macAbsRequests_t macAbsReq =
     .PhyAddToNeighborTable = MAC_PhyAddToNeighborTable,
     .PhyRemoveFromNeighborTable = MAC_PhyRemoveFromNeighborTable,
     .PhyConvertLQIToRSSI = MAC_PhyConvertLQIToRSSI,
-    .AllowBroadcast = MAC_AllowBroadcast
+    .AllowBroadcast = MAC_AllowBroadcast,
+    .MCPS_DataReqZeroCopy = MAC_McpsDataReqZeroCopy,
+    .GetMcpsDataReqHeadroom = MAC_GetMcpsDataReqHeadroom
 };
 
 static macAbsCallbacks_t mMacCallbackFunctions = {NULL};
@@ -887,31 +895,11 @@ static void MAC_McpsDataIndCB
     if (TRUE == MacFiltering_KeepPacket((macAbsAddrModeType_t)pMsg->msgData.dataInd.srcAddrMode,
                                         pMsg->msgData.dataInd.srcAddr, &pMsg->msgData.dataInd.mpduLinkQuality))
     {
-        macAbsMcpsDataInd_t * pMcpsDataInd = NWKU_MEM_BufferAlloc(sizeof(macAbsMcpsDataInd_t));
+        macAbsMcpsDataInd_t * pMcpsDataInd = MAC_McpsDataIndBuild(pMsg, instanceId);
 
         /* Packet is dropped in case there are no more memory buffers */
         if (pMcpsDataInd)
         {
-                /* Populate the MAC abstraction structure */
-                pMcpsDataInd->instanceId        = instanceId;
-                pMcpsDataInd->srcAddrMode       = (macAbsAddrModeType_t)pMsg->msgData.dataInd.srcAddrMode;
-                pMcpsDataInd->dstAddrMode       = (macAbsAddrModeType_t)pMsg->msgData.dataInd.dstAddrMode;
-                pMcpsDataInd->dstPANId          = pMsg->msgData.dataInd.dstPanId;
-                pMcpsDataInd->dstAddr           = pMsg->msgData.dataInd.dstAddr;
-                pMcpsDataInd->srcAddr           = pMsg->msgData.dataInd.srcAddr;
-                pMcpsDataInd->srcPANId          = pMsg->msgData.dataInd.srcPanId;
-                pMcpsDataInd->msduLength        = pMsg->msgData.dataInd.msduLength;
-                pMcpsDataInd->timestamp         = pMsg->msgData.dataInd.timestamp;
-                pMcpsDataInd->mpduLinkQuality   = pMsg->msgData.dataInd.mpduLinkQuality;
-                pMcpsDataInd->dsn               = pMsg->msgData.dataInd.dsn;
-                pMcpsDataInd->securityLevel     = (macAbsSecurityLevel_t)pMsg->msgData.dataInd.securityLevel;
-                pMcpsDataInd->keyIdMode         = (macAbsKeyIdModeType_t)pMsg->msgData.dataInd.keyIdMode;
-                pMcpsDataInd->keySource         = pMsg->msgData.dataInd.keySource;
-                pMcpsDataInd->keyIndex          = pMsg->msgData.dataInd.keyIndex;
-                pMcpsDataInd->qualityOfService  = (macAbsQoS_t)0;
-                /* Reuse McpsDataInd buffer */
-                pMcpsDataInd->pMsdu             = (void *)pMsg;
-
                 /* Clean the short source and destination short addresses */
                 if(pMcpsDataInd->srcAddrMode == gMacAbsAddrModeShortAddress_c)
                 {
@@ -927,7 +915,6 @@ static void MAC_McpsDataIndCB
                     }
                 }
                 #endif
-                FLib_MemInPlaceCpy(pMcpsDataInd->pMsdu, pMsg->msgData.dataInd.pMsdu, pMcpsDataInd->msduLength);
 
                 if(mMacCallbackFunctions.mcpsKeyIdMode2DataInd &&
                    (pMcpsDataInd->keyIdMode == gMacAbsKeyIdMode2_c))
@@ -976,6 +963,83 @@ static void MAC_McpsDataIndCB
     }
 #endif
 }
+/*!*************************************************************************************************
+\fn     static macAbsMcpsDataInd_t* MAC_McpsDataIndBuild(mcpsToNwkMessage_t* pMsg, instanceId_t instanceId)
+\brief  Builds the MAC abstraction data indication of a MAC data indication message.
+
+        When the MSDU leaves enough room in front of it, the indication is written at the start of
+        the MAC message block and the MSDU is handed over in place, as a sub-buffer of the same
+        block. The indication and the MSDU are still freed separately; the block returns to its pool
+        when both are freed. Otherwise, a separate indication buffer is allocated and the MSDU is
+        moved to the start of the MAC message block.
+
+\param [in]   pMsg            pointer to mcps to nwk msg
+\param [in]   instanceId      mac instance id
+
+\return       macAbsMcpsDataInd_t*    pointer to the indication, NULL if no memory is available
+***************************************************************************************************/
+static macAbsMcpsDataInd_t* MAC_McpsDataIndBuild
+(
+    mcpsToNwkMessage_t* pMsg,
+    instanceId_t instanceId
+)
+{
+    macAbsMcpsDataInd_t mcpsDataInd;
+    macAbsMcpsDataInd_t *pMcpsDataInd = NULL;
+    uint8_t *pMsdu = pMsg->msgData.dataInd.pMsdu;
+
+    /* Populate the MAC abstraction structure. It may overlap the MAC message, so it is built
+       on the stack first */
+    mcpsDataInd.instanceId        = instanceId;
+    mcpsDataInd.srcAddrMode       = (macAbsAddrModeType_t)pMsg->msgData.dataInd.srcAddrMode;
+    mcpsDataInd.dstAddrMode       = (macAbsAddrModeType_t)pMsg->msgData.dataInd.dstAddrMode;
+    mcpsDataInd.dstPANId          = pMsg->msgData.dataInd.dstPanId;
+    mcpsDataInd.dstAddr           = pMsg->msgData.dataInd.dstAddr;
+    mcpsDataInd.srcAddr           = pMsg->msgData.dataInd.srcAddr;
+    mcpsDataInd.srcPANId          = pMsg->msgData.dataInd.srcPanId;
+    mcpsDataInd.msduLength        = pMsg->msgData.dataInd.msduLength;
+    mcpsDataInd.timestamp         = pMsg->msgData.dataInd.timestamp;
+    mcpsDataInd.mpduLinkQuality   = pMsg->msgData.dataInd.mpduLinkQuality;
+    mcpsDataInd.dsn               = pMsg->msgData.dataInd.dsn;
+    mcpsDataInd.securityLevel     = (macAbsSecurityLevel_t)pMsg->msgData.dataInd.securityLevel;
+    mcpsDataInd.keyIdMode         = (macAbsKeyIdModeType_t)pMsg->msgData.dataInd.keyIdMode;
+    mcpsDataInd.keySource         = pMsg->msgData.dataInd.keySource;
+    mcpsDataInd.keyIndex          = pMsg->msgData.dataInd.keyIndex;
+    mcpsDataInd.qualityOfService  = (macAbsQoS_t)0;
+    mcpsDataInd.pMsdu             = NULL;
+
+#if gMemSharedBlocks_c
+    /* The indication must end before the header of the MSDU sub-buffer */
+    if(pMsdu >= ((uint8_t*)pMsg + sizeof(macAbsMcpsDataInd_t) + MEM_SubBufferOverhead_c))
+    {
+        mcpsDataInd.pMsdu = MEM_BufferCreateSubBuffer(pMsg, (uint32_t)(pMsdu - (uint8_t*)pMsg));
+    }
+
+    if(mcpsDataInd.pMsdu)
+    {
+        pMcpsDataInd = (macAbsMcpsDataInd_t*)pMsg;
+    }
+    else
+#endif
+    {
+        pMcpsDataInd = NWKU_MEM_BufferAlloc(sizeof(macAbsMcpsDataInd_t));
+
+        if(pMcpsDataInd)
+        {
+            /* Reuse McpsDataInd buffer */
+            mcpsDataInd.pMsdu = (uint8_t*)pMsg;
+            FLib_MemInPlaceCpy(mcpsDataInd.pMsdu, pMsdu, mcpsDataInd.msduLength);
+        }
+    }
+
+    if(pMcpsDataInd)
+    {
+        FLib_MemCpy(pMcpsDataInd, &mcpsDataInd, sizeof(macAbsMcpsDataInd_t));
+    }
+
+    return pMcpsDataInd;
+}
+
 /*!*************************************************************************************************
 \fn     static void MAC_McpsDataCnfCB(mcpsToNwkMessage_t* pMsg, instanceId_t instanceId)
 \brief
@@ -1064,8 +1128,102 @@ static macAbsResultType_t MAC_McpsDataReq
     instanceId_t instanceId,
     uint32_t upperLayerInstanceId
 )
+{
+    nwkToMcpsMessage_t *pNwkToMcpsMsg;
+
+    pNwkToMcpsMsg = NWKU_MEM_BufferAlloc(sizeof(nwkToMcpsMessage_t) + pParam->msduLength);
+
+    if (pNwkToMcpsMsg)
+    {
+        FLib_MemCpy((uint8_t*)pNwkToMcpsMsg + sizeof(nwkToMcpsMessage_t), pParam->pMsdu, pParam->msduLength);
+    }
+
+    return MAC_McpsDataReqSend(pNwkToMcpsMsg, pParam, instanceId, upperLayerInstanceId);
+}
+
+/*!*************************************************************************************************
+\fn     static macAbsResultType_t MAC_McpsDataReqZeroCopy(macAbsMcpsDataReq_t * pParam,
+                                                          instanceId_t instanceId,
+                                                          uint32_t upperLayerInstanceId)
+\brief  Zero-copy MCPS data request. The MSDU was built by the caller MAC_GetMcpsDataReqHeadroom()
+        bytes after the start of a buffer allocated with NWKU_MEM_BufferAlloc(). The MCPS message
+        is built in the headroom and the buffer is sent to the MAC as is.
+
+\param [in] pParam                pointer to mac data request msg (must not be in the headroom)
+\param [in] instanceId            mac instance id
+\param [in] upperLayerInstanceId  upper layer instance id
+
+\return     macAbsResultType_t     gMacAbsInvalidParameter_c if pMsdu is not
+                                  MAC_GetMcpsDataReqHeadroom() bytes after the start of an
+                                  allocated buffer holding the MSDU
+
+\remarks    The MAC abstraction takes ownership of the buffer: it is freed by the MAC after the
+            transmission, or through SLWP_McpsDataCnfCB() if the request fails. A request
+            rejected with gMacAbsInvalidParameter_c is not confirmed and the caller keeps the
+            buffer.
+***************************************************************************************************/
+static macAbsResultType_t MAC_McpsDataReqZeroCopy
+(
+    macAbsMcpsDataReq_t * pParam,
+    instanceId_t instanceId,
+    uint32_t upperLayerInstanceId
+)
 {
     nwkToMcpsMessage_t *pNwkToMcpsMsg = NULL;
+
+    if (pParam->pMsdu)
+    {
+        pNwkToMcpsMsg = (nwkToMcpsMessage_t*)(pParam->pMsdu - sizeof(nwkToMcpsMessage_t));
+
+        if (!MEM_BufferIsAllocated(pNwkToMcpsMsg) ||
+            (sizeof(nwkToMcpsMessage_t) + pParam->msduLength > MEM_BufferGetSize(pNwkToMcpsMsg)))
+        {
+            /* Not a buffer of the memory manager: it cannot be sent nor freed */
+            return gMacAbsInvalidParameter_c;
+        }
+    }
+
+    return MAC_McpsDataReqSend(pNwkToMcpsMsg, pParam, instanceId, upperLayerInstanceId);
+}
+
+/*!*************************************************************************************************
+\fn     static uint32_t MAC_GetMcpsDataReqHeadroom(void)
+\brief  Returns the number of bytes to reserve in front of the MSDU for MAC_McpsDataReqZeroCopy()
+
+\return     uint32_t    headroom size in bytes
+***************************************************************************************************/
+static uint32_t MAC_GetMcpsDataReqHeadroom
+(
+    void
+)
+{
+    return sizeof(nwkToMcpsMessage_t);
+}
+
+/*!*************************************************************************************************
+\fn     static macAbsResultType_t MAC_McpsDataReqSend(nwkToMcpsMessage_t * pNwkToMcpsMsg,
+                                                      macAbsMcpsDataReq_t * pParam,
+                                                      instanceId_t instanceId,
+                                                      uint32_t upperLayerInstanceId)
+\brief  Fills in the MCPS data request message and sends it to the MAC. If the MAC rejects it,
+        the message is reused for the data confirm sent to 6LoWPAN.
+
+\param [in] pNwkToMcpsMsg         message holding the MSDU after its header, or NULL if it
+                                  could not be allocated
+\param [in] pParam                pointer to mac data request msg
+\param [in] instanceId            mac instance id
+\param [in] upperLayerInstanceId  upper layer instance id
+
+\return     macAbsResultType_t
+***************************************************************************************************/
+static macAbsResultType_t MAC_McpsDataReqSend
+(
+    nwkToMcpsMessage_t * pNwkToMcpsMsg,
+    macAbsMcpsDataReq_t * pParam,
+    instanceId_t instanceId,
+    uint32_t upperLayerInstanceId
+)
+{
     resultType_t result = gTransactionOverflow_c;
 #ifdef THR_ENABLE_MGMT_DIAGNOSTICS
     bool_t isBcastAddr = FALSE;
@@ -1082,12 +1240,9 @@ static macAbsResultType_t MAC_McpsDataReq
 
 #endif
 
-    pNwkToMcpsMsg = NWKU_MEM_BufferAlloc(sizeof(nwkToMcpsMessage_t) + pParam->msduLength);
-
     if (pNwkToMcpsMsg)
     {
         pNwkToMcpsMsg->msgData.dataReq.pMsdu = (uint8_t*)pNwkToMcpsMsg + sizeof(nwkToMcpsMessage_t);
-        FLib_MemCpy(pNwkToMcpsMsg->msgData.dataReq.pMsdu, pParam->pMsdu, pParam->msduLength);
 
         pNwkToMcpsMsg->msgType = gMcpsDataReq_c;
         pNwkToMcpsMsg->msgData.dataReq.srcPanId = MAC_GetPANId(instanceId);
@@ -370,7 +370,7 @@ void Stack_to_APP_Handler
             gEnable802154TxLed = FALSE; //Disable default TX activity LED
 
             mEquipo4GETTimerID = TMR_AllocateTimer();        /////////CAMBIOS
-            TMR_StartTimer(mEquipo4GETTimerID, gTmrSingleShotTimer_c, 1000, APP_TimmerEquipo4Cb, NULL);     /////////CAMBIOS
+            TMR_StartTimerWithSlack(mEquipo4GETTimerID, gTmrSingleShotTimer_c, 1000, 100, APP_TimmerEquipo4Cb, NULL);     /////////CAMBIOS
             break;
 
         case gThrEv_GeneralInd_ConnectingFailed_c:
@@ -1498,7 +1498,7 @@ static void APP_CoapEquipo4Cb(coapSessionStatus_t sessionStatus,void *pData,coap
 static void APP_TimmerEquipo4Cb(void *pParam){
     TMR_StopTimer(mEquipo4GETTimerID);
     NWKU_SendMsg(APP_ReportEquipo4, (void*)"ctr", mpAppThreadMsgQueue);
-    TMR_StartSingleShotTimer(mEquipo4GETTimerID, 1000, APP_TimmerEquipo4Cb, NULL);
+    TMR_StartTimerWithSlack(mEquipo4GETTimerID, gTmrSingleShotTimer_c, 1000, 100, APP_TimmerEquipo4Cb, NULL);
 
 
 }